@@ -0,0 +1,115 @@
+/*
+ *  private/output/AsyncWriter.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaOutputAsyncWriter_h
+#define AvidaOutputAsyncWriter_h
+
+#include "apto/core/Thread.h"
+#include "apto/platform.h"
+#include "avida/output/Types.h"
+
+#include <deque>
+#include <streambuf>
+#include <string>
+
+
+namespace Avida {
+  namespace Output {
+
+    // Output::AsyncWriter - Background thread that performs the disk writes of all asynchronous output files
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Blocks are written strictly in submission order.  Submit only waits when more than the configured number of
+    // bytes are already queued, so the simulation thread does not block on I/O unless the disk falls far behind.
+
+    class AsyncWriter : public Apto::Thread, public Apto::RefCountObject<Apto::ThreadSafe>
+    {
+    private:
+      struct Block
+      {
+        std::streambuf* target;
+        std::string data;
+      };
+
+      Apto::Mutex m_mutex;
+      Apto::ConditionVariable m_pending_cond;
+      Apto::ConditionVariable m_space_cond;
+
+      std::deque<Block*> m_queue;
+      int m_queued_bytes;
+      int m_max_bytes;
+      bool m_writing;
+      bool m_stopped;
+
+
+    public:
+      LIB_LOCAL AsyncWriter(int max_bytes);
+      LIB_LOCAL ~AsyncWriter();
+
+      LIB_LOCAL void Submit(std::streambuf* target, const char* data, int size);
+      LIB_LOCAL void WaitIdle();
+      LIB_LOCAL void Stop();
+
+    private:
+      LIB_LOCAL void Run();
+
+      AsyncWriter(); // @not_implemented
+      AsyncWriter(const AsyncWriter&); // @not_implemented
+      AsyncWriter& operator=(const AsyncWriter&); // @not_implemented
+    };
+
+
+    // Output::AsyncFileBuffer - Stream buffer that accumulates formatted output and hands it to the writer thread
+    // --------------------------------------------------------------------------------------------------------------
+
+    class AsyncFileBuffer : public std::streambuf
+    {
+    private:
+      static const int BLOCK_SIZE = 8192;
+
+      AsyncWriterPtr m_writer;
+      std::streambuf* m_target;
+      char m_block[BLOCK_SIZE];
+
+
+    public:
+      LIB_LOCAL AsyncFileBuffer(AsyncWriterPtr writer, std::streambuf* target);
+      LIB_LOCAL ~AsyncFileBuffer();
+
+      // Submit buffered data and wait for every queued block to reach the target
+      LIB_LOCAL void Drain();
+
+    protected:
+      LIB_LOCAL int_type overflow(int_type c);
+      LIB_LOCAL int sync();
+
+    private:
+      LIB_LOCAL void submit();
+
+      AsyncFileBuffer(); // @not_implemented
+      AsyncFileBuffer(const AsyncFileBuffer&); // @not_implemented
+      AsyncFileBuffer& operator=(const AsyncFileBuffer&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
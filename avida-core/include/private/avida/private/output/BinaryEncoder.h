@@ -0,0 +1,120 @@
+/*
+ *  private/output/BinaryEncoder.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaOutputBinaryEncoder_h
+#define AvidaOutputBinaryEncoder_h
+
+#include "apto/platform.h"
+#include "avida/output/Types.h"
+
+#include <ostream>
+#include <string>
+
+
+namespace Avida {
+  namespace Output {
+
+    // Output::BinaryEncoder - Encodes the rows of a data file into the binary columnar format
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // All multi-byte values are stored in the host byte order, identified by the endian marker in the header.
+    // Strings are a uint32 length followed by the characters.
+    //
+    // Header:  "AVIDABIN", uint32 version (2), uint32 endian marker (0x01020304),
+    //          string file type, string format, string comments (the text header, including column descriptions),
+    //          uint32 column count, then per column a uint8 ColumnType and a string descriptor
+    //
+    // Blocks:  repeated until end of file; uint32 row count, then per column a uint8 BlockEncoding,
+    //          a uint32 payload size in bytes and the payload holding that column's values for every row of the block
+    //
+    // Values:  COL_DOUBLE 8 byte IEEE double, COL_INT32 int32, COL_INT64 int64, COL_UINT32 uint32,
+    //          COL_STRING string, COL_INT_ARRAY uint32 count followed by that many int32,
+    //          COL_DOUBLE_ARRAY uint32 count followed by that many doubles (grid rows, one value per cell)
+    //
+    // ENCODE_DELTA (integer columns) stores each value as the zigzag varint of its difference from the previous row of
+    // the block (the first from zero).  ENCODE_XOR (double columns) XORs each value's bits with the previous row's and
+    // stores a uint8 count n of significant low-order bytes followed by those n bytes, least significant first.
+    // Array columns use the same encodings (DELTA for int arrays, XOR for double arrays) element by element: each row
+    // is a varint element count, then every element against the same element of the previous row (zero where the
+    // previous row was shorter), so grids that change little from one update to the next shrink to a byte or so a cell.
+
+    class BinaryEncoder
+    {
+    public:
+      enum ColumnType { COL_DOUBLE = 1, COL_INT32, COL_INT64, COL_UINT32, COL_STRING, COL_INT_ARRAY, COL_DOUBLE_ARRAY };
+      enum BlockEncoding { ENCODE_RAW = 0, ENCODE_DELTA, ENCODE_XOR };
+
+      static const int DEFAULT_BLOCK_ROWS = 256;
+
+    private:
+      struct Column
+      {
+        ColumnType type;
+        Apto::String descr;
+        std::string values;
+      };
+
+      Apto::Array<Column, Apto::ManagedPointer> m_columns;
+      bool m_compress;
+      int m_block_rows;
+
+      bool m_schema_done;
+      int m_cur_col;
+      int m_rows;
+
+
+    public:
+      LIB_LOCAL BinaryEncoder(bool compress, int block_rows = DEFAULT_BLOCK_ROWS);
+
+      LIB_LOCAL inline bool SchemaWritten() const { return m_schema_done; }
+
+      LIB_LOCAL void Write(double x, const char* descr);
+      LIB_LOCAL void Write(int i, const char* descr);
+      LIB_LOCAL void Write(long i, const char* descr);
+      LIB_LOCAL void Write(unsigned int i, const char* descr);
+      LIB_LOCAL void Write(const char* data_str, const char* descr);
+      LIB_LOCAL void Write(const Apto::Array<int>& list, const char* descr);
+      LIB_LOCAL void Write(const Apto::Array<double>& list, const char* descr);
+
+      // The first row fixes the column schema; its header is written ahead of the first block
+      LIB_LOCAL void WriteHeader(std::ostream& out, const Apto::String& filetype, const Apto::String& format,
+                                 const Apto::String& comments);
+      LIB_LOCAL void EndRow(std::ostream& out);
+      LIB_LOCAL void Flush(std::ostream& out);
+
+    private:
+      LIB_LOCAL Column* nextColumn(ColumnType type, const char* descr);
+      LIB_LOCAL void appendDefault(Column& col);
+      LIB_LOCAL void writeBlock(std::ostream& out);
+      LIB_LOCAL bool encodeDelta(const Column& col, std::string& payload) const;
+      LIB_LOCAL bool encodeXor(const Column& col, std::string& payload) const;
+      LIB_LOCAL void encodeArrayDelta(const Column& col, std::string& payload) const;
+      LIB_LOCAL void encodeArrayXor(const Column& col, std::string& payload) const;
+
+      BinaryEncoder(); // @not_implemented
+      BinaryEncoder(const BinaryEncoder&); // @not_implemented
+      BinaryEncoder& operator=(const BinaryEncoder&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
@@ -82,6 +82,8 @@ namespace Avida {
       int NumUnits() const;
       
       const PropertyMap& Properties() const;
+      int IntProperty(GroupProperty prop) const;
+      Apto::String StringProperty(GroupProperty prop) const;
       
       bool Serialize(ArchivePtr ar) const;
       bool LegacySave(void* df) const;
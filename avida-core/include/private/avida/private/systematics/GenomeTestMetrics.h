@@ -51,6 +51,7 @@ namespace Avida {
     
     class GenomeTestMetrics : public GroupData
     {
+      friend class GenomeTestQueue;
     public:
       static const Apto::String ObjectKey;
       
@@ -66,6 +67,9 @@ namespace Avida {
       
       
       LIB_EXPORT GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr bg);
+      LIB_LOCAL GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, const Genome& genome);
+      
+      LIB_LOCAL void evaluate(cWorld* world, cAvidaContext& ctx, const Genome& genome);
       
     public:
       LIB_EXPORT ~GenomeTestMetrics();
@@ -82,7 +86,10 @@ namespace Avida {
       LIB_EXPORT const Apto::Array<int>& GetTaskCounts() const { return m_task_counts; }
       
       
-      LIB_EXPORT static GenomeTestMetricsPtr GetMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr bg);
+      // Returns the metrics of bg, evaluating them if needed.  A genotype still being evaluated in the background (see
+      // BACKGROUND_GENOME_TESTS) is waited for, unless wait is false, in which case NULL is returned while it is pending.
+      LIB_EXPORT static GenomeTestMetricsPtr GetMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr bg, bool wait = true);
+      LIB_EXPORT static bool IsPending(cWorld* world, GroupPtr bg);
     };
     
   };
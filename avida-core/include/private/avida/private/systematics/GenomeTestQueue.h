@@ -0,0 +1,89 @@
+/*
+ *  private/systematics/GenomeTestQueue.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaSystematicsGenomeTestQueue_h
+#define AvidaSystematicsGenomeTestQueue_h
+
+#include "apto/core.h"
+#include "apto/platform.h"
+#include "avida/systematics/Arbiter.h"
+#include "avida/systematics/Listener.h"
+#include "avida/private/systematics/GenomeTestMetrics.h"
+
+class cAnalyzeJobQueue;
+class cWorld;
+
+
+namespace Avida {
+  namespace Systematics {
+    
+    // GenomeTestQueue - evaluates genotypes in the background as they cross the threshold
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Listens for EVENT_ADD_THRESHOLD on the genotype arbiter and hands each such genotype's genome to an analyze job
+    // queue, whose workers run the test CPU evaluation.  Results are attached to their groups as GenomeTestMetrics on
+    // the simulation thread only, either when collected by GenomeTestMetrics::GetMetrics or when the next genotype
+    // crosses the threshold.
+    
+    class GenomeTestQueue : public Listener
+    {
+    private:
+      class TestJob;
+      
+      struct PendingTest
+      {
+        GroupPtr group;
+        GenomeTestMetricsPtr metrics;   // set by the worker, guarded by m_mutex
+        bool done;
+      };
+      
+      cWorld* m_world;
+      ArbiterPtr m_arbiter;
+      cAnalyzeJobQueue* m_queue;     // created on the first evaluation
+      
+      Apto::Mutex m_mutex;
+      Apto::ConditionVariable m_cond;
+      Apto::Map<GroupID, PendingTest*> m_pending;  // simulation thread only
+      
+      
+    public:
+      LIB_LOCAL GenomeTestQueue(cWorld* world, ArbiterPtr arbiter);
+      LIB_LOCAL ~GenomeTestQueue();
+      
+      LIB_LOCAL void Notify(GroupPtr g, EventType t, UnitPtr u);
+      
+      LIB_LOCAL inline bool IsPending(GroupPtr g) const { return m_pending.Has(g->ID()); }
+      
+      // Attach and return the metrics of a queued group, waiting for its evaluation to finish if wait is set.  Returns
+      // NULL if the group was never queued or, without wait, is still being evaluated.
+      LIB_LOCAL GenomeTestMetricsPtr Collect(GroupPtr g, bool wait);
+      
+    private:
+      LIB_LOCAL void attachCompleted();
+      
+      GenomeTestQueue(); // @not_implemented
+      GenomeTestQueue(const GenomeTestQueue&); // @not_implemented
+      GenomeTestQueue& operator=(const GenomeTestQueue&); // @not_implemented
+    };
+    
+  };
+};
+
+#endif
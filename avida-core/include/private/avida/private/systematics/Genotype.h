@@ -57,12 +57,15 @@ namespace Avida {
     class Genotype : public Group
     {
       friend class GenotypeArbiter;
+      friend class PhylogenyLog;
     private:
       mutable GenotypeArbiterPtr m_mgr;
       Apto::List<GenotypePtr, Apto::SparseVector>::EntryHandle* m_handle;
+      Apto::List<GenotypePtr, Apto::SparseVector>::EntryHandle* m_threshold_handle;
       
       Source m_src;
       Genome m_genome;
+      unsigned long long m_hash;
       Apto::String m_name;
       
       bool m_threshold;
@@ -78,6 +81,7 @@ namespace Avida {
       int m_total_organisms;
       
       Apto::Array<GenotypePtr> m_parents;
+      Apto::Array<GroupID> m_parent_ids;
       Apto::String m_parent_str;
       
       cCountTracker m_births;
@@ -122,16 +126,23 @@ namespace Avida {
       int NumUnits() const;
       
       const PropertyMap& Properties() const;
+      int IntProperty(GroupProperty prop) const;
+      double DoubleProperty(GroupProperty prop) const;
+      Apto::String StringProperty(GroupProperty prop) const;
       
       bool Serialize(ArchivePtr ar) const;
       bool LegacySave(void* df) const;
 
       void RemoveActiveReference() const;
+      void RemovePassiveReference() const;
       
 
       // Genotype Specific Methods
       bool Matches(UnitPtr u);
       
+      // IDs of the parents at founding, kept even when the parents themselves are not (DISABLE_GENOTYPE_CLASSIFICATION)
+      inline const Apto::Array<GroupID>& ParentIDs() const { return m_parent_ids; }
+      
       
       // ???      
       inline void SetLastBirthCell(int birth_cell) { m_last_birth_cell = birth_cell; }
@@ -141,13 +152,16 @@ namespace Avida {
       
     private:
       // Methods called by GenotypeArbiter
-      Genotype(GenotypeArbiterPtr mgr, GroupID in_id, UnitPtr founder, Update update, ConstGroupMembershipPtr parents);
+      Genotype(GenotypeArbiterPtr mgr, GroupID in_id, UnitPtr founder, Update update, ConstGroupMembershipPtr parents,
+               bool link_parents = true);
       Genotype(GenotypeArbiterPtr mgr, GroupID in_id, void* props);
 
       void NotifyNewUnit(UnitPtr u);
+      void NotifyNewUnits(const Apto::Array<UnitPtr>& units, int begin, int end);
       void UpdateReset();
 
       inline const Genome& GroupGenome() const { return m_genome; }
+      inline unsigned long long GenomeHash() const { return m_hash; }
       inline const Apto::Array<GenotypePtr> Parents() const { return m_parents; }
       
       inline void SetName(const Apto::String& name) { m_name = name; }
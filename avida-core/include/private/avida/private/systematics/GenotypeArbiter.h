@@ -44,20 +44,44 @@ namespace Avida {
     public:
       enum {
         EVENT_ADD_THRESHOLD,
-        EVENT_REMOVE_THRESHOLD
+        EVENT_REMOVE_THRESHOLD,
+        EVENT_ADD_GENOTYPE,         // new genotype founded (not sent for reactivated or loaded genotypes)
+        EVENT_DEACTIVATE_GENOTYPE,  // last living unit of the genotype is gone
+        EVENT_REMOVE_GENOTYPE       // genotype dropped from the arbiter, no living descendants remain
       };
       
-      static const int HASH_SIZE = 3203;
+      static const int INITIAL_INDEX_SIZE = 4096; // must be a power of two
       
     private:
+      enum IndexSlotState {
+        INDEX_EMPTY = 0,
+        INDEX_USED,
+        INDEX_REMOVED
+      };
+      
+      struct IndexEntry
+      {
+        unsigned long long hash;
+        GenotypePtr genotype;
+        IndexSlotState state;
+        
+        IndexEntry() : hash(0), state(INDEX_EMPTY) { ; }
+      };
+      
+
       // Config Settings
       int m_threshold;
       bool m_disable_class;
       
       // Internal Data Structures
-      Apto::List<GenotypePtr, Apto::SparseVector> m_active_hash[HASH_SIZE];
+      Apto::Array<IndexEntry> m_active_index;     // open addressing (linear probe) on genome hash, active genotypes only
+      int m_active_index_count;                   // slots holding a genotype
+      int m_active_index_filled;                  // slots holding a genotype or a removal marker
+      Apto::Map<GroupID, GenotypePtr> m_id_index; // every genotype still tracked (active or historic), by ID
       Apto::Array<Apto::List<GenotypePtr, Apto::SparseVector>, Apto::ManagedPointer> m_active_sz;
       Apto::List<GenotypePtr, Apto::SparseVector> m_historic;
+      Apto::List<GenotypePtr, Apto::SparseVector> m_threshold_list; // genotypes currently flagged as threshold
+      Apto::Array<GenotypePtr> m_pending_removal;    // historic genotypes whose last reference went away this update
       GenotypePtr m_coalescent;
       int m_best;
       int m_next_id;
@@ -114,6 +138,8 @@ namespace Avida {
           : description(desc), GetData(func) { ; } 
       };
       Apto::Map<Data::DataID, ProvidedData> m_provided_data;
+      Apto::Array<Data::DataID> m_distribution_ids;  // values that require the full pass over the active genotypes
+      World* m_world;
       mutable Data::ConstDataSetPtr m_provides;
       
       
@@ -123,6 +149,7 @@ namespace Avida {
       
       // Arbiter Interface Methods
       GroupPtr ClassifyNewUnit(UnitPtr u, const ClassificationHints* hints);
+      void ClassifyNewUnits(const Apto::Array<UnitPtr>& units, const ClassificationHints* hints, Apto::Array<GroupPtr>& groups);
       GroupPtr Group(GroupID g_id);
       
       void PerformUpdate(Context& ctx, Update current_update);
@@ -145,6 +172,7 @@ namespace Avida {
       // Methods called by Genotype
       GenotypePtr ClassifyNewUnit(UnitPtr bu, ConstGroupMembershipPtr parents, const ClassificationHints* hints = NULL);
       void AdjustGenotype(GenotypePtr genotype, int old_size, int new_size);
+      inline void ScheduleRemoval(GenotypePtr genotype) { m_pending_removal.Push(genotype); }
       
       inline int NumEnvironmentActionTriggers() const { return m_env_action_count.GetSize(); }
       inline const Apto::Array<PropertyID>& EnvironmentActionTriggerAverageIDs() const { return m_env_action_average; }
@@ -157,9 +185,13 @@ namespace Avida {
       template <class T> Data::PackagePtr packageData(const T&) const;
       Data::ProviderPtr activateProvider(World*);
       
-      unsigned int hashGenome(const InstructionSequence& genome) const;
+      void indexInsert(GenotypePtr genotype);
+      void indexRemove(GenotypePtr genotype);
+      GenotypePtr indexFind(unsigned long long hash, UnitPtr u);
+      void rebuildIndex(int size);
       Apto::String nameGenotype(int size);
       
+      void setThreshold(GenotypePtr genotype);
       void removeGenotype(GenotypePtr genotype);
       void updateCoalescent();
       
@@ -0,0 +1,91 @@
+/*
+ *  private/systematics/PhylogenyLog.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaSystematicsPhylogenyLog_h
+#define AvidaSystematicsPhylogenyLog_h
+
+#include "apto/platform.h"
+#include "avida/systematics/Arbiter.h"
+#include "avida/systematics/Listener.h"
+
+#include <fstream>
+#include <string>
+
+
+namespace Avida {
+  namespace Systematics {
+
+    // PhylogenyLog - streams genotype events of a GenotypeArbiter to an append-only binary log
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Records are written as genotypes appear and die, so that a full phylogeny can be rebuilt offline without the
+    // arbiter keeping extinct ancestors in memory (see DISABLE_GENOTYPE_CLASSIFICATION).
+    //
+    // Header:  "AVIDAPHY", uint32 version (1), uint32 endian marker (0x01020304), all in host byte order
+    //
+    // Records: a uint8 record type followed by its fields, every integer an unsigned varint (7 bits per byte, low
+    //          order first, high bit set on all but the last byte); updates, which may be -1 before the first update,
+    //          are zigzag encoded first
+    //
+    //   INSTSET (1)  index, name length, name characters     (precedes the first birth that uses the instruction set)
+    //   BIRTH (2)    id, update born, parent count, parent ids, hardware type, instset index, length, instruction ops
+    //   EXTINCT (3)  id, update deactivated                  (repeated if a genotype is reactivated and dies again)
+    //   PRUNE (4)    id                                       (only when pruning is on; the genotype no longer has
+    //                                                          living descendants, so its branch can be dropped)
+
+    class PhylogenyLog : public Listener
+    {
+    public:
+      enum RecordType { RECORD_INSTSET = 1, RECORD_BIRTH, RECORD_EXTINCT, RECORD_PRUNE };
+
+      static const int FLUSH_BYTES = 64 * 1024;
+
+    private:
+      ArbiterPtr m_arbiter;
+      bool m_prune;
+      std::ofstream m_out;
+      std::string m_buf;
+      Apto::Array<Apto::String> m_instsets;
+
+
+    public:
+      // Opens (truncating) the log and attaches to arbiter, which must be a GenotypeArbiter
+      LIB_LOCAL PhylogenyLog(ArbiterPtr arbiter, const Apto::String& path, bool prune);
+      LIB_LOCAL ~PhylogenyLog();
+
+      LIB_LOCAL inline bool IsOpen() const { return m_out.is_open(); }
+
+      LIB_LOCAL void Notify(GroupPtr g, EventType t, UnitPtr u);
+      LIB_LOCAL void Flush();
+
+    private:
+      LIB_LOCAL int instSetIndex(const Apto::String& name);
+      LIB_LOCAL inline void appendVarint(unsigned long long value);
+      LIB_LOCAL inline void appendSigned(long long value);
+
+      PhylogenyLog(); // @not_implemented
+      PhylogenyLog(const PhylogenyLog&); // @not_implemented
+      PhylogenyLog& operator=(const PhylogenyLog&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
@@ -47,6 +47,10 @@ namespace Avida {
     
     // SexualAncestry
     // --------------------------------------------------------------------------------------------------------------
+    //
+    // Immutable ancestry node attached to a group.  Nodes point to the shared nodes of the group's (up to two) parents,
+    // forming a DAG, so a new group costs one node rather than a copy of its ancestors' ids.  Ancestor indices follow
+    // the original layout: 0-1 the parents, 2-3 the parents of parent 0, 4-5 the parents of parent 1.
     
     class SexualAncestry : public GroupData
     {
@@ -55,18 +59,33 @@ namespace Avida {
 
     private:
       int m_id;
-      int m_ancestor_ids[6];
+      SexualAncestryPtr m_parents[2];
       
     public:
       LIB_LOCAL SexualAncestry(GroupPtr g);
       
+      // Returns the ancestry attached to g, creating and attaching it when absent
+      LIB_LOCAL static SexualAncestryPtr Of(GroupPtr g);
+      
       LIB_LOCAL int GetID() const { return m_id; }
-      LIB_LOCAL int GetAncestorID(int idx) const { assert(idx < 6); return m_ancestor_ids[idx]; }
+      LIB_LOCAL inline int GetAncestorID(int idx) const;
       
       LIB_LOCAL int GetPhyloDistance(GroupPtr g) const;
       
       LIB_LOCAL bool Serialize(ArchivePtr ar) const;
+      
+    private:
+      LIB_LOCAL void getAncestorIDs(int ids[6]) const;
     };
+    
+    
+    inline int SexualAncestry::GetAncestorID(int idx) const
+    {
+      assert(idx >= 0 && idx < 6);
+      if (idx < 2) return (m_parents[idx]) ? m_parents[idx]->m_id : -1;
+      const SexualAncestryPtr& parent = m_parents[(idx - 2) / 2];
+      return (parent) ? parent->GetAncestorID((idx - 2) % 2) : -1;
+    }
 
   };
 };
@@ -0,0 +1,83 @@
+/*
+ *  private/util/MemoryStats.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaUtilMemoryStats_h
+#define AvidaUtilMemoryStats_h
+
+
+namespace Avida {
+  namespace Util {
+
+    // MemoryStats - allocator statistics and per subsystem object counts
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Object counts are process wide and only kept once enabled (TRACK_ALLOCATIONS), objects that already exist at
+    // that point are not counted.
+
+    class MemoryStats
+    {
+    public:
+      enum Subsystem {
+        ORGANISMS = 0,
+        GENOTYPES,
+        GENOMES,
+        PHENOTYPES,
+        DATA_PACKAGES,
+        NUM_SUBSYSTEMS
+      };
+
+    private:
+      static bool s_enabled;
+      static volatile int s_live[NUM_SUBSYSTEMS];
+      static volatile long long s_created[NUM_SUBSYSTEMS];
+
+    public:
+      static void Enable() { s_enabled = true; }
+      static bool IsEnabled() { return s_enabled; }
+
+      static inline void Created(Subsystem s);
+      static inline void Destroyed(Subsystem s);
+
+      static const char* SubsystemName(int s);
+      static int Live(int s) { return s_live[s]; }
+      static double TotalCreated(int s) { return (double)s_created[s]; }
+
+      // Numeric property of the bundled tcmalloc (e.g. "generic.current_allocated_bytes"), if the executable is linked
+      // against it.  Returns false, leaving value untouched, otherwise.
+      static bool AllocatorProperty(const char* name, double& value);
+    };
+
+
+    inline void MemoryStats::Created(Subsystem s)
+    {
+      if (!s_enabled) return;
+      __sync_add_and_fetch(&s_live[s], 1);
+      __sync_add_and_fetch(&s_created[s], 1);
+    }
+
+    inline void MemoryStats::Destroyed(Subsystem s)
+    {
+      if (s_enabled) __sync_sub_and_fetch(&s_live[s], 1);
+    }
+
+  };
+};
+
+#endif
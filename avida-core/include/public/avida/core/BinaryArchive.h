@@ -0,0 +1,98 @@
+/*
+ *  core/BinaryArchive.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaCoreBinaryArchive_h
+#define AvidaCoreBinaryArchive_h
+
+#include "apto/core/Array.h"
+#include "apto/core/Map.h"
+#include "avida/core/Archive.h"
+#include "avida/core/Properties.h"
+
+#include <string>
+
+
+namespace Avida {
+
+  // BinaryArchive - in memory archive tree that can be written to and read from a compressed binary file
+  // --------------------------------------------------------------------------------------------------------------
+  //
+  // File:    char[8] "AVIDACKP", uint32 format version, uint32 uncompressed size, then blocks until the size is reached
+  // Block:   uint32 raw size (at most 64KB), uint32 stored size, stored bytes; a block whose stored size equals its raw
+  //          size was not compressible and is kept as is, otherwise it is LZ77 compressed
+  //
+  // The uncompressed stream is the root object, each object being its id, type, version, properties (id, type and
+  // string value) and then its sub-objects in the order they were defined.  Values are stored in host byte order.
+
+  class BinaryArchive : public Archive
+  {
+  private:
+    ArchiveObjectID m_id;
+    ArchiveObjectType m_type;
+    int m_version;
+    HashPropertyMap m_props;
+    Apto::Array<ArchiveObjectID> m_sub_order;
+    Apto::Map<ArchiveObjectID, BinaryArchivePtr> m_subs;
+
+  public:
+    LIB_EXPORT explicit BinaryArchive(const ArchiveObjectID& obj_id = "");
+    LIB_EXPORT ~BinaryArchive();
+
+    LIB_EXPORT ArchiveObjectID ObjectID() const;
+    LIB_EXPORT ArchiveObjectType ObjectType() const;
+    LIB_EXPORT int Version() const;
+
+    LIB_EXPORT void SetObjectType(ArchiveObjectType obj_type);
+    LIB_EXPORT void SetVersion(int version);
+
+    LIB_EXPORT const PropertyMap& Properties() const;
+
+    LIB_EXPORT bool AttachProperty(const Property& prop);
+
+    LIB_EXPORT ConstArchiveObjectIDSetPtr SubObjectIDs() const;
+    LIB_EXPORT ConstArchivePtr SubObject(ArchiveObjectID obj_id) const;
+
+    LIB_EXPORT ArchivePtr DefineSubObject(ArchiveObjectID obj_id);
+
+    // Sub-objects in the order they were defined
+    LIB_EXPORT inline int NumSubObjects() const { return m_sub_order.GetSize(); }
+    LIB_EXPORT ConstArchivePtr SubObject(int idx) const;
+    LIB_EXPORT BinaryArchivePtr DefineSubArchive(const ArchiveObjectID& obj_id);
+
+    // Convenience attachment of plain values, stored as string properties of the matching type
+    LIB_EXPORT bool AttachValue(const PropertyID& prop_id, const Apto::String& value);
+    LIB_EXPORT bool AttachValue(const PropertyID& prop_id, int value);
+    LIB_EXPORT bool AttachValue(const PropertyID& prop_id, double value);
+
+    LIB_EXPORT bool Write(const Apto::String& path) const;
+    LIB_EXPORT static BinaryArchivePtr Read(const Apto::String& path);
+
+  private:
+    LIB_LOCAL void encode(std::string& buf) const;
+    LIB_LOCAL bool decode(const std::string& buf, size_t& pos);
+
+    BinaryArchive(const BinaryArchive&); // @not_implemented
+    BinaryArchive& operator=(const BinaryArchive&); // @not_implemented
+  };
+
+};
+
+#endif
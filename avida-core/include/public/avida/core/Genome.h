@@ -64,6 +64,7 @@ namespace Avida {
     LIB_EXPORT Genome(HardwareTypeID hw, const PropertyMap& props, GeneticRepresentationPtr rep);
     LIB_EXPORT explicit Genome(const Apto::String& genome_str);
     LIB_EXPORT Genome(const Genome& genome);
+    LIB_EXPORT ~Genome();
     
     
     // Accessors
@@ -99,6 +100,8 @@ namespace Avida {
     // Operations
     LIB_EXPORT bool operator==(const Genome& genome) const;
     LIB_EXPORT Genome& operator=(const Genome& genome);
+    LIB_EXPORT void Adopt(Genome& genome); // as operator=, but takes genome's representation rather than a clone of it
+    LIB_EXPORT void Share(const Genome& genome); // reference an equal genome's representation, neither may modify it after
 
     LIB_EXPORT bool Serialize(ArchivePtr ar) const;
     LIB_EXPORT static GenomePtr Deserialize(ArchivePtr ar);
@@ -121,6 +121,9 @@ namespace Avida {
     LIB_EXPORT int CountInst(const Instruction& inst) const;
     LIB_EXPORT int MinDistBetween(const Instruction& inst) const;
     LIB_EXPORT inline bool HasInst(const Instruction& inst) const { return (FindInst(inst) >= 0); }
+    
+    // 64-bit hash of the ops, with every bit depending on the whole sequence (so the low bits can pick a table slot)
+    LIB_EXPORT unsigned long long Hash() const;
         
 
     // InstructionSequence Creation Methods
@@ -136,6 +139,8 @@ namespace Avida {
     static int FindBestOffset(const InstructionSequence& seq1, const InstructionSequence& seq2);
     static int FindSlidingDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
     static int FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
+    // Exact when the distance is at most max_dist, otherwise max_dist + 1, giving up as soon as that is certain
+    static int FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int max_dist);
     
     
   protected:
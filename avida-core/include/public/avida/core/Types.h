@@ -36,6 +36,7 @@ namespace Avida {
   // --------------------------------------------------------------------------------------------------------------
   
   class Archive;
+  class BinaryArchive;
   class Context;
   class Feedback;
   class GeneticRepresentation;
@@ -78,6 +79,7 @@ namespace Avida {
   
   typedef Apto::SmartPtr<Archive> ArchivePtr;
   typedef Apto::SmartPtr<const Archive> ConstArchivePtr;
+  typedef Apto::SmartPtr<BinaryArchive> BinaryArchivePtr;
   
   typedef Apto::String ArchiveObjectID;
   typedef Apto::String ArchiveObjectType;
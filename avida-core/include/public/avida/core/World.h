@@ -37,7 +37,8 @@ namespace Avida {
   // A World object contains a collection of facets (WorldFacet) that implement top-level functionality.  These facets
   // can be retrieved and used from essentially any level of a given experimental run.  Facets also participate in the
   // update cycle of the experiment. World schedules the order of execution based on facet dependencies and takes care
-  // of issuing PerformUpdate on all facets in the appropriate order.
+  // of issuing PerformUpdate on all facets in the appropriate order.  Facets that do not depend on one another form a
+  // wave; with SetUpdateThreads() the facets of each wave are updated concurrently, waves still run one after another.
   //
   // Several core facets have convenience/performance accessors, listed below. All others may be retrieve through the
   // main Facet() method.
@@ -45,6 +46,8 @@ namespace Avida {
   class World
   {
   private:
+    class UpdatePool;
+    
     WorldFacetPtr m_data_manager;
     WorldFacetPtr m_environment;
     WorldFacetPtr m_output_manager;
@@ -52,10 +55,14 @@ namespace Avida {
     
     Apto::Map<WorldFacetID, WorldFacetPtr> m_facets;
     Apto::Array<WorldFacetPtr> m_facet_order;
+    Apto::Array<WorldFacetID> m_facet_ids;                  // id of each facet in m_facet_order
+    Apto::Array<Apto::Array<WorldFacetPtr> > m_update_waves; // facets, in order, whose dependencies are all in earlier waves
+    UpdatePool* m_update_pool;
     
   public:
     LIB_EXPORT World();
     LIB_EXPORT World(ConstArchivePtr ar);
+    LIB_EXPORT ~World();
     
     // General facet methods
     LIB_EXPORT bool AttachFacet(WorldFacetID facet_id, WorldFacetPtr facet);
@@ -70,7 +77,17 @@ namespace Avida {
     // Actions
     LIB_EXPORT void PerformUpdate(Context& ctx, Update current_update);
     
+    // Threads (including the calling one) that update the facets of a wave concurrently; 0 or 1 updates every facet
+    // in order on the calling thread, -1 uses all available CPUs.  Facets of a wave share the update context.
+    LIB_EXPORT void SetUpdateThreads(int num_threads);
+    
     LIB_EXPORT bool Serialize(ArchivePtr ar) const;
+    
+  private:
+    LIB_LOCAL void buildUpdateWaves();
+    
+    World(const World&); // @not_implemented
+    World& operator=(const World&); // @not_implemented
   };
   
 
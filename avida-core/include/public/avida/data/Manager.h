@@ -43,6 +43,11 @@ namespace Avida {
       typedef Apto::Set<Apto::String, Apto::DefaultHashBTree, Apto::Multi> ArgMultiSet;
       typedef Apto::SmartPtr<ArgMultiSet> ArgMultiSetPtr;
       
+      class Snapshot;
+      class RecorderView;
+      class RecordingPipeline;
+      typedef Apto::SmartPtr<Snapshot, Apto::InternalRCObject> SnapshotPtr;
+      
     private:
       World* m_world;
       
@@ -60,10 +65,22 @@ namespace Avida {
       Apto::Map<DataID, ProviderPtr> m_active_provider_map;
       Apto::Map<DataID, ArgumentedProviderPtr> m_active_arg_provider_map;
       Apto::Map<DataID, ArgMultiSetPtr> m_active_args;
+      Apto::Map<DataID, int> m_requested;
+      
+      Apto::Array<double> m_provider_update_time;
+      Apto::Array<int> m_provider_update_count;
       
       mutable Apto::Mutex m_current_value_mutex;
       mutable Apto::Map<DataID, PackagePtr> m_current_values;
       
+      // Immutable view of the active providers and attached recorders used by PerformUpdate, republished whenever a
+      // recorder attaches or detaches.  The mutex only guards swapping the pointer.
+      mutable Apto::Mutex m_snapshot_mutex;
+      SnapshotPtr m_snapshot;
+      
+      // Helper thread notifying recorders while the next update runs, NULL unless pipelined recording is enabled
+      RecordingPipeline* m_pipeline;
+      
       static bool s_registered_with_facet_factory;
       
     public:
@@ -74,17 +91,33 @@ namespace Avida {
       LIB_EXPORT bool IsAvailable(const DataID& data_id) const;
       LIB_EXPORT bool IsActive(const DataID& data_id) const;
       
+      // Active providers supply every value they provide, requested marks the values some attached recorder asked for
+      LIB_EXPORT bool IsRequested(const DataID& data_id) const;
+      LIB_EXPORT ConstDataSetPtr GetRequested() const;
+      
+      // Average processor seconds per update spent updating the provider of data_id (-1.0 if it is not updated)
+      LIB_EXPORT double ProviderUpdateCost(const DataID& data_id) const;
+      
       LIB_EXPORT Apto::String Describe(const DataID& data_id) const;
       
       LIB_EXPORT bool AttachRecorder(RecorderPtr recorder, bool concurrent_update = false);
       LIB_EXPORT bool DetachRecorder(RecorderPtr recorder);
       
+      // Pipelined recording captures every requested value at the end of an update and notifies the recorders on a
+      // helper thread, so the next update can begin executing.  Anything reading recorder state (events, the end of the
+      // run) must first call WaitForRecorders.
+      LIB_EXPORT void SetPipelinedRecording(bool enabled);
+      LIB_EXPORT void WaitForRecorders();
+      
       LIB_EXPORT bool Register(const DataID& data_id, ProviderActivateFunctor functor);
       LIB_EXPORT bool Register(const DataID& data_id, ArgumentedProviderActivateFunctor functor);
       
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
       
+    private:
+      LIB_LOCAL void publishSnapshot();
+      
     public:
       LIB_EXPORT bool Serialize(ArchivePtr ar) const;
       
@@ -40,6 +40,7 @@ namespace Avida {
     class Package : public Apto::RefCountObject<Apto::ThreadSafe>, public Apto::ClassAllocator<SmallObjectMalloc>
     {
     public:
+      LIB_EXPORT Package();
       LIB_EXPORT virtual ~Package() = 0;
       
       LIB_EXPORT virtual bool BoolValue() const = 0;
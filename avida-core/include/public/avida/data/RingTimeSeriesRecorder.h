@@ -0,0 +1,111 @@
+/*
+ *  data/RingTimeSeriesRecorder.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaDataRingTimeSeriesRecorder_h
+#define AvidaDataRingTimeSeriesRecorder_h
+
+#include "apto/core/Array.h"
+#include "avida/core/Types.h"
+#include "avida/data/Recorder.h"
+
+
+namespace Avida {
+  namespace Data {
+
+    // Data::RingTimeSeriesRecorder - Fixed memory time series of a numeric value
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Tier 0 holds the most recent recorded values.  Each coarser tier holds blocks summarizing block_size entries of
+    // the tier below it, so tier k spans block_size^k times as many updates in the same number of entries.  Every tier
+    // is a ring of the same capacity, the oldest entries of a tier being overwritten once it is full.
+
+    class RingTimeSeriesRecorder : public Recorder
+    {
+    public:
+      struct Sample
+      {
+        Update first_update;
+        Update last_update;
+        double min;
+        double max;
+        double sum;
+        int count;
+
+        LIB_LOCAL inline Sample() : first_update(-1), last_update(-1), min(0.0), max(0.0), sum(0.0), count(0) { ; }
+
+        LIB_EXPORT inline double Mean() const { return (count) ? sum / count : 0.0; }
+        LIB_EXPORT void Merge(const Sample& sample);
+      };
+
+    private:
+      struct Tier
+      {
+        Apto::Array<Sample> ring;
+        int start;
+        int size;
+        Sample pending;
+        int pending_entries;
+
+        LIB_LOCAL inline Tier() : start(0), size(0), pending_entries(0) { ; }
+
+        LIB_LOCAL inline const Sample& Get(int idx) const { return ring[(start + idx) % ring.GetSize()]; }
+      };
+
+      DataID m_data_id;
+      ConstDataSetPtr m_requested;
+
+      int m_block_size;
+      Apto::Array<Tier> m_tiers;
+
+    public:
+      LIB_EXPORT RingTimeSeriesRecorder(const DataID& data_id, int capacity = 1024, int num_tiers = 4, int block_size = 16);
+
+      // Data::Recorder Interface
+      LIB_EXPORT inline ConstDataSetPtr RequestedData() const { return m_requested; }
+      LIB_EXPORT void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data);
+
+      // Value Access
+      LIB_EXPORT inline const DataID& RecordedDataID() const { return m_data_id; }
+
+      LIB_EXPORT inline int NumTiers() const { return m_tiers.GetSize(); }
+      LIB_EXPORT inline int NumPoints(int tier = 0) const { return m_tiers[tier].size; }
+      LIB_EXPORT inline const Sample& DataPoint(int idx, int tier = 0) const { return m_tiers[tier].Get(idx); }
+
+      // Fills samples with summaries covering the updates from..to, using the finest tier that still retains from and
+      // needs no more than max_points entries (0 = unlimited).  Locating the range is a binary search in that tier.
+      // Returns the tier used, or -1 if nothing has been recorded in the range.
+      LIB_EXPORT int Query(Update from, Update to, int max_points, Apto::Array<Sample>& samples) const;
+
+    protected:
+      LIB_EXPORT virtual bool shouldRecordValue(Update) { return true; }
+      LIB_EXPORT virtual void didRecordValue() { ; }
+
+    private:
+      LIB_LOCAL void addSample(const Sample& sample);
+      LIB_LOCAL void pushEntry(Tier& tier, const Sample& sample);
+      LIB_LOCAL int firstEndingAtOrAfter(const Tier& tier, Update update) const;
+      LIB_LOCAL int firstStartingAfter(const Tier& tier, Update update) const;
+    };
+
+  };
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include "avida/environment/ActionTrigger.h"
 #include "avida/environment/Product.h"
 #include "avida/environment/Reaction.h"
+#include "avida/environment/ReactionGraph.h"
 #include "avida/environment/Resource.h"
 
 
@@ -52,6 +53,10 @@ namespace Avida {
       mutable ReactionIDSetPtr m_reaction_ids;
       mutable ResourceIDSetPtr m_resource_ids;
       
+      // Compiled on first use after any definition or registration; the mutex only guards the pointer
+      mutable Apto::Mutex m_graph_mutex;
+      mutable ConstReactionGraphPtr m_graph;
+      
       static bool s_registered_with_facet_factory;
       
     public:
@@ -71,10 +76,16 @@ namespace Avida {
       LIB_EXPORT ConstResourceIDSetPtr GetResourceIDs() const;
       LIB_EXPORT ConstResourcePtr GetResource(const ResourceID& resource_id) const;
       
+      // Flat, read only form of everything above, safe to share across threads once returned
+      LIB_EXPORT ConstReactionGraphPtr GetReactionGraph() const;
+      
       
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
       
+    private:
+      LIB_LOCAL void invalidateGraph();
+      
     public:
       LIB_EXPORT bool Serialize(ArchivePtr ar) const;
       
@@ -0,0 +1,98 @@
+/*
+ *  environment/ReactionGraph.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaEnvironmentReactionGraph_h
+#define AvidaEnvironmentReactionGraph_h
+
+#include "avida/environment/ActionTrigger.h"
+#include "avida/environment/Product.h"
+#include "avida/environment/Reaction.h"
+#include "avida/environment/Resource.h"
+
+
+namespace Avida {
+  namespace Environment {
+
+    // Environment::ReactionGraph - immutable, integer indexed form of everything registered with the Manager
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Action triggers, products, reactions and resources are numbered once, triggers in the order of the Manager's
+    // ActionTriggerIDSet.  Callers resolve their IDs to indices when they are set up and then work from the flat tables
+    // alone; a graph is never modified after it is published, so worker threads may share it without locking.  The
+    // dispatch tables map each trigger to the product it yields and to its position in the legacy task library.
+
+    class ReactionGraph
+    {
+      friend class Manager;
+    private:
+      Apto::Array<ConstActionTriggerPtr> m_triggers;
+      Apto::Array<int> m_trigger_product;       // product index of each trigger, -1 when it yields none
+      Apto::Array<int> m_trigger_order;         // legacy task ordering of each trigger, -1 when it has none
+      Apto::Array<int> m_order_trigger;         // trigger index of each legacy task ordering, -1 when unused
+      Apto::Array<ConstProductPtr> m_products;
+      Apto::Array<ConstReactionPtr> m_reactions;
+      Apto::Array<ConstResourcePtr> m_resources;
+
+      Apto::Map<ActionTriggerID, int> m_trigger_index;
+      Apto::Map<ReactionID, int> m_reaction_index;
+      Apto::Map<ResourceID, int> m_resource_index;
+
+      LIB_LOCAL inline ReactionGraph() { ; }
+
+    public:
+      LIB_EXPORT inline int NumActionTriggers() const { return m_triggers.GetSize(); }
+      LIB_EXPORT inline const ActionTrigger& GetActionTrigger(int idx) const { return *m_triggers[idx]; }
+      LIB_EXPORT inline int ProductOfActionTrigger(int idx) const { return m_trigger_product[idx]; }
+      LIB_EXPORT inline int TempOrderingOfActionTrigger(int idx) const { return m_trigger_order[idx]; }
+      LIB_EXPORT inline int ActionTriggerWithTempOrdering(int order) const
+      {
+        return (order >= 0 && order < m_order_trigger.GetSize()) ? m_order_trigger[order] : -1;
+      }
+
+      LIB_EXPORT inline int NumProducts() const { return m_products.GetSize(); }
+      LIB_EXPORT inline ConstProductPtr GetProduct(int idx) const { return m_products[idx]; }
+
+      LIB_EXPORT inline int NumReactions() const { return m_reactions.GetSize(); }
+      LIB_EXPORT inline const Reaction& GetReaction(int idx) const { return *m_reactions[idx]; }
+
+      LIB_EXPORT inline int NumResources() const { return m_resources.GetSize(); }
+      LIB_EXPORT inline const Resource& GetResource(int idx) const { return *m_resources[idx]; }
+
+      // Index resolution, for setup rather than per action use; each returns -1 for an unknown ID
+      LIB_EXPORT inline int IndexOfActionTrigger(const ActionTriggerID& trigger_id) const { return lookup(m_trigger_index, trigger_id); }
+      LIB_EXPORT inline int IndexOfReaction(const ReactionID& reaction_id) const { return lookup(m_reaction_index, reaction_id); }
+      LIB_EXPORT inline int IndexOfResource(const ResourceID& resource_id) const { return lookup(m_resource_index, resource_id); }
+
+    private:
+      LIB_LOCAL static inline int lookup(const Apto::Map<Apto::String, int>& index, const Apto::String& obj_id)
+      {
+        int idx = -1;
+        return (index.Get(obj_id, idx)) ? idx : -1;
+      }
+
+      ReactionGraph(const ReactionGraph&); // @not_implemented
+      ReactionGraph& operator=(const ReactionGraph&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
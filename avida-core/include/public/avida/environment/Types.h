@@ -39,6 +39,7 @@ namespace Avida {
     class Manager;
     class Product;
     class Reaction;
+    class ReactionGraph;
     class Resource;
     
     
@@ -64,6 +65,8 @@ namespace Avida {
     typedef Apto::SmartPtr<const ReactionIDSet, Apto::ThreadSafeRefCount> ConstReactionIDSetPtr;
     typedef Apto::Set<ReactionID>::ConstIterator ConstReactionIDSetIterator;
     
+    typedef Apto::SmartPtr<const ReactionGraph, Apto::ThreadSafeRefCount> ConstReactionGraphPtr;
+    
     typedef Apto::String ResourceID;
     typedef Apto::SmartPtr<Resource, Apto::ThreadSafeRefCount> ResourcePtr;
     typedef Apto::SmartPtr<const Resource, Apto::ThreadSafeRefCount> ConstResourcePtr;
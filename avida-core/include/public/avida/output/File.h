@@ -49,6 +49,8 @@ namespace Avida {
       int m_num_cols;
       
       std::ofstream m_fp;
+      AsyncFileBuffer* m_async_buffer;
+      BinaryEncoder* m_binary;
 
       
     public:
@@ -77,7 +79,10 @@ namespace Avida {
       LIB_EXPORT inline bool SetFileType(const Apto::String& ft);
 
       
-      LIB_EXPORT inline std::ofstream& OFStream() { return m_fp; }
+      LIB_EXPORT inline bool IsBinary() const { return (m_binary != NULL); }
+      
+      // Raw stream access is not columnar, so binary files that have not yet written their header revert to text
+      LIB_EXPORT inline std::ofstream& OFStream() { if (m_binary) demoteToText(); return m_fp; }
       
       
       // The following methods output a value into the data file.
@@ -94,15 +99,20 @@ namespace Avida {
       
       // The following methods output a value into the data file anonymously (no column descriptor).
       //  first argument (x, i, data_str, etc.) - the value to write (as double, int, const char *, etc.)
-      LIB_EXPORT inline void WriteAnonymous(double x) { m_fp << x << " "; }
-      LIB_EXPORT inline void WriteAnonymous(int i) { m_fp << i << " "; }
-      LIB_EXPORT inline void WriteAnonymous(long i) { m_fp << i << " "; }
-      LIB_EXPORT inline void WriteAnonymous(const char* data_str) { m_fp << data_str << " "; }
+      LIB_EXPORT inline void WriteAnonymous(double x) { OFStream() << x << " "; }
+      LIB_EXPORT inline void WriteAnonymous(int i) { OFStream() << i << " "; }
+      LIB_EXPORT inline void WriteAnonymous(long i) { OFStream() << i << " "; }
+      LIB_EXPORT inline void WriteAnonymous(const char* data_str) { OFStream() << data_str << " "; }
       
       // The following methods are useful for outputting tables of values with row size x
       LIB_EXPORT void WriteBlockElement(double x, int element, int x_size);
       LIB_EXPORT void WriteBlockElement(int i, int element, int x_size);
       
+      // Whole grid rows in one call: the values are formatted together and handed to the stream in a single write,
+      // separated by spaces (text matches writing them one at a time); binary files store them as one array column
+      LIB_EXPORT void WriteBlock(const Apto::Array<double>& values, const char* descr);
+      LIB_EXPORT void WriteBlock(const Apto::Array<int>& values, const char* descr);
+      
       
       // Writes the description for a single column; keeps track of column numbers and formatting idendifier (optional).
       LIB_EXPORT void WriteColumnDesc(const char* descr, const char* format = "");
@@ -124,7 +134,9 @@ namespace Avida {
     private:
       LIB_EXPORT static FilePtr createWithPath(World* world, Apto::String path, bool append, Feedback* feedback);
 
-      LIB_LOCAL File(World* world, const OutputID& output_id, bool append = false);
+      LIB_LOCAL File(World* world, const OutputID& output_id, bool append = false, FileFormat format = TEXT_FORMAT);
+      
+      LIB_EXPORT void demoteToText();
     };
     
 
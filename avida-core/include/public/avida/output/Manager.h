@@ -48,6 +48,9 @@ namespace Avida {
       Apto::Map<OutputID, SocketWeakRef> m_sockets;
       Apto::Map<OutputID, SocketPtr> m_static_sockets;
       
+      AsyncWriterPtr m_async_writer;
+      FileFormat m_default_format;
+      
     public:
       LIB_EXPORT Manager(const Apto::String& output_path);
       LIB_EXPORT ~Manager();
@@ -61,6 +64,17 @@ namespace Avida {
       
       LIB_EXPORT void FlushAll();
       
+      // Hand formatted output of files opened from now on to a background writer thread, buffering at most max_bytes
+      LIB_EXPORT bool EnableAsyncWriter(int max_bytes);
+      LIB_LOCAL inline AsyncWriterPtr AsyncOutputWriter() const { return m_async_writer; }
+      
+      // For forked child processes, which do not have the writer thread: files opened afterward write directly
+      LIB_EXPORT void AbandonAsyncWriter();
+      
+      // Format of newly created data files; paths ending in ".bdat" are always written as compressed binary
+      LIB_EXPORT inline FileFormat DefaultFileFormat() const { return m_default_format; }
+      LIB_EXPORT inline void SetDefaultFileFormat(FileFormat format) { m_default_format = format; }
+      
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
       
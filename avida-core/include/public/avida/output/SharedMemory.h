@@ -0,0 +1,87 @@
+/*
+ *  output/SharedMemory.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaOutputSharedMemory_h
+#define AvidaOutputSharedMemory_h
+
+#include "avida/output/Socket.h"
+
+#include <cstddef>
+
+
+namespace Avida {
+  namespace Output {
+
+    // Output::SharedMemory - Publishes the latest values of a set of named slots in a memory mapped file
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Monitors map the same file and read it without any system calls.  All values are stored in the host byte
+    // order.
+    //
+    // Header:  char[8] "AVIDASHM", uint32 version (1), uint32 slot count, uint32 sequence, int32 update
+    // Slots:   char[56] NUL terminated name, double value
+    //
+    // The sequence is a seqlock: it is odd while the writer is updating the slots.  Readers copy the update and values
+    // between two reads of the sequence, and retry if the two differ or the first was odd.
+
+    class SharedMemory : public Socket
+    {
+    public:
+      static const int SLOT_NAME_SIZE = 56;
+
+    private:
+      struct Header;
+      struct Slot;
+
+      Header* m_header;
+      Slot* m_slots;
+      size_t m_size;
+      int m_num_slots;
+
+
+    public:
+      LIB_EXPORT static SharedMemoryPtr CreateWithPath(World* world, Apto::String path,
+                                                       const Apto::Array<Apto::String>& slot_names,
+                                                       Feedback* feedback = NULL);
+
+      LIB_EXPORT ~SharedMemory();
+
+      LIB_EXPORT inline bool Fail() const { return (m_header == NULL); }
+      LIB_EXPORT inline int NumSlots() const { return m_num_slots; }
+
+      // Writes the update and the values of every slot as one consistent snapshot; values beyond the slot count are
+      // ignored and missing values are left unchanged
+      LIB_EXPORT void Publish(Update update, const Apto::Array<double>& values);
+
+      LIB_EXPORT void Flush();
+
+    private:
+      LIB_LOCAL SharedMemory(World* world, const OutputID& output_id, const Apto::Array<Apto::String>& slot_names);
+
+      SharedMemory(); // @not_implemented
+      SharedMemory(const SharedMemory&); // @not_implemented
+      SharedMemory& operator=(const SharedMemory&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
@@ -33,18 +33,34 @@ namespace Avida {
     // Class Declarations
     // --------------------------------------------------------------------------------------------------------------
     
+    class AsyncFileBuffer;
+    class AsyncWriter;
+    class BinaryEncoder;
     class File;
     class Manager;
+    class SharedMemory;
     class Socket;
     
     
+    // Enumeration Declarations
+    // --------------------------------------------------------------------------------------------------------------
+    
+    enum FileFormat {
+      TEXT_FORMAT = 0,
+      BINARY_FORMAT = 1,
+      BINARY_COMPRESSED_FORMAT = 2
+    };
+    
+    
     // Type Declarations
     // --------------------------------------------------------------------------------------------------------------
     
     typedef Apto::String OutputID;
     typedef Socket* SocketWeakRef;
+    typedef Apto::SmartPtr<AsyncWriter, Apto::InternalRCObject> AsyncWriterPtr;
     typedef Apto::SmartPtr<File, Apto::InternalRCObject> FilePtr;
     typedef Apto::SmartPtr<Manager, Apto::InternalRCObject> ManagerPtr;
+    typedef Apto::SmartPtr<SharedMemory, Apto::InternalRCObject> SharedMemoryPtr;
     typedef Apto::SmartPtr<Socket, Apto::InternalRCObject> SocketPtr;
   };
 };
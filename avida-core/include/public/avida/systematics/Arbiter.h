@@ -55,6 +55,10 @@ namespace Avida {
       
       // Subclass Methods
       LIB_EXPORT virtual GroupPtr ClassifyNewUnit(UnitPtr u, const ClassificationHints* hints = NULL) = 0;
+      // Classify a batch of units sharing hints, groups[i] receiving the group of units[i] (the default classifies
+      // them one at a time)
+      LIB_EXPORT virtual void ClassifyNewUnits(const Apto::Array<UnitPtr>& units, const ClassificationHints* hints,
+                                               Apto::Array<GroupPtr>& groups);
       LIB_EXPORT virtual GroupPtr Group(GroupID g_id) = 0;
       
       LIB_EXPORT virtual void PerformUpdate(Context& ctx, Update current_update) = 0;
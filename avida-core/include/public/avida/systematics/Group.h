@@ -47,6 +47,39 @@ namespace Avida {
     };
     
     
+    // GroupProperty
+    // --------------------------------------------------------------------------------------------------------------
+    // Integer index of the properties shared by the group implementations, for typed access that neither performs a
+    // string keyed lookup nor requires the group's PropertyMap to be built
+    
+    enum GroupProperty {
+      GROUP_PROP_NAME = 0,
+      GROUP_PROP_GENOME,
+      GROUP_PROP_PARENTS,
+      GROUP_PROP_THRESHOLD,
+      GROUP_PROP_UPDATE_BORN,
+      GROUP_PROP_SRC_TRANSMISSION_TYPE,
+      GROUP_PROP_TOTAL_ORGANISMS,
+      GROUP_PROP_AVE_COPY_SIZE,
+      GROUP_PROP_AVE_EXE_SIZE,
+      GROUP_PROP_AVE_GESTATION_TIME,
+      GROUP_PROP_AVE_REPRO_RATE,
+      GROUP_PROP_AVE_METABOLIC_RATE,
+      GROUP_PROP_AVE_FITNESS,
+      GROUP_PROP_MAX_FITNESS,
+      GROUP_PROP_LAST_BIRTHS,
+      GROUP_PROP_LAST_DEATHS,
+      GROUP_PROP_LAST_BREED_TRUE,
+      GROUP_PROP_LAST_BREED_IN,
+      GROUP_PROP_LAST_BREED_OUT,
+      GROUP_PROP_LAST_BIRTH_CELL,
+      GROUP_PROP_LAST_GROUP_ID,
+      GROUP_PROP_LAST_FORAGER_TYPE,
+      
+      NUM_GROUP_PROPS
+    };
+    
+    
     // Group
     // --------------------------------------------------------------------------------------------------------------
     
@@ -74,6 +107,14 @@ namespace Avida {
       
       LIB_EXPORT virtual const PropertyMap& Properties() const = 0;
       
+      // Typed Property Access (the defaults look the value up in Properties(), implementations override them to read
+      // their fields directly)
+      LIB_EXPORT virtual int IntProperty(GroupProperty prop) const;
+      LIB_EXPORT virtual double DoubleProperty(GroupProperty prop) const;
+      LIB_EXPORT virtual Apto::String StringProperty(GroupProperty prop) const;
+      
+      LIB_EXPORT static const PropertyID& PropertyIDOf(GroupProperty prop);
+      
       LIB_EXPORT virtual bool Serialize(ArchivePtr ar) const;
       LIB_EXPORT virtual bool LegacySave(void* df) const;
       
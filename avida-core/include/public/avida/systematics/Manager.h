@@ -49,6 +49,7 @@ namespace Avida {
       ArbiterPtr ArbiterForRole(const RoleID& role);
       
       LIB_EXPORT void ClassifyNewUnit(UnitPtr u, const RoleClassificationHints* role_hints = NULL);
+      LIB_EXPORT void ClassifyNewUnits(const Apto::Array<UnitPtr>& units, const RoleClassificationHints* role_hints = NULL);
       
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
@@ -0,0 +1,97 @@
+/*
+ *  util/WorldTemplate.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaUtilWorldTemplate_h
+#define AvidaUtilWorldTemplate_h
+
+#include "apto/platform.h"
+#include "avida/core/Types.h"
+
+class cAvidaConfig;
+class cUserFeedback;
+class cWorld;
+
+
+namespace Avida {
+  namespace Util {
+
+    // Util::WorldTemplate - one experiment setup, instantiated as many independent replicate worlds in one process
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // The template loads the configuration once and builds a prototype world from it, which checks the setup, builds
+    // the static instruction libraries and records every input file the setup reads (configuration, instruction sets,
+    // environment, events and their includes).  Those files are then held in memory, shared read-only by every world
+    // of the process, so replicates are built without touching the disk.  Instruction sets, the environment and its
+    // task library still belong to each world, which builds them from the shared text.  Ancestor genomes are only
+    // loaded once a world runs its events; pass them to ShareFile to share them as well.
+    //
+    // Replicate i runs with RANDOM_SEED offset by i and DATA_DIR suffixed with _i, like the worlds of avida-mt.  A
+    // time based seed is drawn once, when the template is built.  Each instantiated world owns its population, random
+    // number generator, output and Avida::World (cWorld::GetNewWorld), and is run by the caller's own WorldDriver.
+
+    class WorldTemplate
+    {
+    private:
+      class InstantiateThread;
+
+      Apto::String m_working_dir;
+      Apto::String m_config_file;
+      Apto::Map<Apto::String, Apto::String> m_sets;
+      Apto::Map<Apto::String, Apto::String> m_defs;
+      int m_base_seed;
+      Apto::String m_base_data_dir;
+      Apto::Array<Apto::String> m_shared_files;
+      bool m_valid;
+
+    public:
+      // sets override configuration entries (as -set does), defs are the file definitions (as -def does)
+      LIB_EXPORT WorldTemplate(const Apto::String& working_dir, const Apto::String& config_file,
+                               const Apto::Map<Apto::String, Apto::String>& sets,
+                               const Apto::Map<Apto::String, Apto::String>& defs, cUserFeedback* feedback = NULL);
+      LIB_EXPORT ~WorldTemplate();
+
+      LIB_EXPORT inline bool IsValid() const { return m_valid; }
+
+      // Share another input file, relative to the working directory
+      LIB_EXPORT bool ShareFile(const Apto::String& filename);
+      LIB_EXPORT inline int GetNumSharedFiles() const { return m_shared_files.GetSize(); }
+      LIB_EXPORT inline const Apto::String& GetSharedFile(int idx) const { return m_shared_files[idx]; }
+
+      // Build one replicate world, NULL on failure; may be called from any number of threads at once
+      LIB_EXPORT cWorld* Instantiate(int replicate, cUserFeedback* feedback = NULL) const;
+
+      // Build replicates first to first + num - 1 on num_threads threads, worlds[i] is NULL for each that failed
+      LIB_EXPORT void InstantiateAll(int first, int num, int num_threads, Apto::Array<cWorld*>& worlds,
+                                     Apto::Array<cUserFeedback, Apto::Smart>& feedback) const;
+
+    private:
+      LIB_LOCAL cAvidaConfig* loadConfig(cUserFeedback* feedback) const;
+      LIB_LOCAL void setupReplicate(cAvidaConfig* cfg, int replicate) const;
+
+      WorldTemplate(); // @not_implemented
+      WorldTemplate(const WorldTemplate&); // @not_implemented
+      WorldTemplate& operator=(const WorldTemplate&); // @not_implemented
+    };
+
+  };
+};
+
+#endif
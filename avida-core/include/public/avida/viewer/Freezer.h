@@ -82,6 +82,10 @@ namespace Avida {
       Apto::Array<Entry> m_entries[3];
       int m_next_id[3];
       
+      // World bundles still being compressed and written by their own threads
+      class BundleWriter;
+      mutable Apto::Array<BundleWriter*> m_pending_writes;
+      
       
     public:
       LIB_EXPORT static FreezerPtr LoadWithPath(const Apto::String& dir);
@@ -148,6 +152,8 @@ namespace Avida {
       
     private:
       LIB_LOCAL Freezer(const Apto::String& dir);
+      
+      LIB_LOCAL void waitForWrites() const;
     };
     
   };
@@ -97,8 +97,46 @@ namespace Avida {
     class Map
     {
     protected:
-      int m_width;
-      int m_height;
+      // Copy of a mode's scale, owned by a snapshot
+      class ScaleSnapshot : public DiscreteScale
+      {
+      public:
+        int range;
+        Apto::Array<Entry> entries;
+        bool categorical;
+        
+        ScaleSnapshot() : range(0), categorical(false) { ; }
+        
+        int GetScaleRange() const { return range; }
+        int GetNumLabeledEntries() const { return entries.GetSize(); }
+        Entry GetEntry(int index) const { return entries[index]; }
+        bool IsCategorical() const { return categorical; }
+      };
+      
+      struct ModeSnapshot
+      {
+        Apto::Array<int> values;
+        Apto::Array<int> counts;
+        ScaleSnapshot scale;
+        Apto::String scale_label;
+      };
+      
+      // Everything the viewer reads from the map, as of the end of one update
+      struct Snapshot
+      {
+        int width;
+        int height;
+        Apto::Array<ModeSnapshot> modes;
+      };
+      
+      // Snapshots are handed from the simulation to the viewer through a triple buffer: the simulation fills m_back,
+      // then swaps it into m_middle; Retain swaps the middle buffer into m_front when a newer one has been published.
+      enum { SNAPSHOT_INDEX = 0x3, SNAPSHOT_FRESH = 0x4 };
+      Snapshot m_snapshots[3];
+      int m_front;            // read by the viewer
+      int m_back;             // written by the simulation
+      volatile int m_middle;  // index of the last published snapshot, with SNAPSHOT_FRESH until the viewer takes it
+      
       int m_num_viewer_colors;
       
       Apto::Array<MapMode*> m_view_modes;  // List of view modes...
@@ -106,7 +144,7 @@ namespace Avida {
       int m_symbol_mode;     // Current map symbol mode (index into m_view_modes, -1 = off)
       int m_tag_mode;        // Current map tag mode (index into m_view_modes, -1 = off)
       
-      Apto::RWLock m_rw_lock;
+      mutable Apto::Mutex m_mode_mutex;  // the modes themselves are updated by the simulation and configured by the viewer
       
       
     public:
@@ -114,8 +152,9 @@ namespace Avida {
       ~Map();
       
       
-      inline int GetWidth() const { return m_width; }
-      inline int GetHeight() const { return m_height; }
+      // The getters below read the snapshot taken by the last Retain
+      inline int GetWidth() const { return m_snapshots[m_front].width; }
+      inline int GetHeight() const { return m_snapshots[m_front].height; }
       
       
       inline int GetColorMode() const { return m_color_mode; }
@@ -123,34 +162,35 @@ namespace Avida {
       inline int GetTagMode() const { return m_tag_mode; }
       
       
-      inline const Apto::Array<int>& GetColors() const { return m_view_modes[m_color_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetSymbols() const { return m_view_modes[m_symbol_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetTags() const { return m_view_modes[m_tag_mode]->GetGridValues(); }
+      inline const Apto::Array<int>& GetColors() const { return mode(m_color_mode).values; }
+      inline const Apto::Array<int>& GetSymbols() const { return mode(m_symbol_mode).values; }
+      inline const Apto::Array<int>& GetTags() const { return mode(m_tag_mode).values; }
       
-      inline const Apto::Array<int>& GetColorCounts() const { return m_view_modes[m_color_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetSymbolCounts() const { return m_view_modes[m_symbol_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetTagCounts() const { return m_view_modes[m_tag_mode]->GetValueCounts(); }
+      inline const Apto::Array<int>& GetColorCounts() const { return mode(m_color_mode).counts; }
+      inline const Apto::Array<int>& GetSymbolCounts() const { return mode(m_symbol_mode).counts; }
+      inline const Apto::Array<int>& GetTagCounts() const { return mode(m_tag_mode).counts; }
       
-      inline const DiscreteScale& GetColorScale() const { return m_view_modes[m_color_mode]->GetScale(); }
-      inline const DiscreteScale& GetSymbolScale() const { return m_view_modes[m_symbol_mode]->GetScale(); }
-      inline const DiscreteScale& GetTagScale() const { return m_view_modes[m_tag_mode]->GetScale(); }
+      inline const DiscreteScale& GetColorScale() const { return mode(m_color_mode).scale; }
+      inline const DiscreteScale& GetSymbolScale() const { return mode(m_symbol_mode).scale; }
+      inline const DiscreteScale& GetTagScale() const { return mode(m_tag_mode).scale; }
       
-      inline const Apto::String& GetColorScaleLabel() const { return m_view_modes[m_color_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetSymbolScaleLabel() const { return m_view_modes[m_symbol_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetTagScaleLabel() const { return m_view_modes[m_tag_mode]->GetScaleLabel(); }
+      inline const Apto::String& GetColorScaleLabel() const { return mode(m_color_mode).scale_label; }
+      inline const Apto::String& GetSymbolScaleLabel() const { return mode(m_symbol_mode).scale_label; }
+      inline const Apto::String& GetTagScaleLabel() const { return mode(m_tag_mode).scale_label; }
       
       inline int GetNumModes() const { return m_view_modes.GetSize(); }
       inline const Apto::String& GetModeName(int idx) const { return m_view_modes[idx]->GetName(); }
       inline int GetModeSupportedTypes(int idx) const { return m_view_modes[idx]->GetSupportedTypes(); }
       bool SetModeProperty(int idx, const Apto::String& property, const Apto::String& value);
-      inline Apto::String GetModeProperty(int idx, const Apto::String& property) const { return m_view_modes[idx]->GetProperty(property); }
+      Apto::String GetModeProperty(int idx, const Apto::String& property) const;
       
       void SetMode(int mode);
       inline void SetNumViewerColors(int num_colors) { m_num_viewer_colors = num_colors; }
       
       
-      inline void Retain() { m_rw_lock.ReadLock(); }
-      inline void Release() { m_rw_lock.ReadUnlock(); }
+      // Take the most recently published snapshot.  Never blocks the simulation; a single viewer thread may read.
+      void Retain();
+      inline void Release() { ; }
       
       
       // Core Viewer Internal Methods
@@ -158,7 +198,8 @@ namespace Avida {
       
       
     protected:
-      void updateMap(cPopulation& pop, int map_id);
+      inline const ModeSnapshot& mode(int idx) const { return m_snapshots[m_front].modes[idx]; }
+      void takeSnapshot(Snapshot& snapshot, cPopulation& pop);
     };
     
   };
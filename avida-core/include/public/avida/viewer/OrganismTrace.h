@@ -25,6 +25,8 @@
 #ifndef AvidaViewerOrganismTrace_h
 #define AvidaViewerOrganismTrace_h
 
+#include "apto/core/Mutex.h"
+
 #include "avida/core/Genome.h"
 #include "avida/core/InstructionSequence.h"
 #include "avida/viewer/Graphic.h"
@@ -36,6 +38,7 @@ class cWorld;
 
 namespace Avida {
   namespace Viewer {    
+    namespace Private { class TraceThread; };
     
     // HardwareSnapshot
     // --------------------------------------------------------------------------------------------------------------  
@@ -125,21 +128,40 @@ namespace Avida {
     // --------------------------------------------------------------------------------------------------------------  
     
     class OrganismTrace
-    {      
+    {
+      friend class Private::TraceThread;
     private:
       GenomePtr m_genome;
       Apto::Array<HardwareSnapshot*> m_snapshots;
       GenomePtr m_offspring_genome;
       
+      // Guards m_snapshots and m_offspring_genome while a background trace is filling them in
+      mutable Apto::Mutex m_mutex;
+      volatile int m_available;   // snapshots that are complete and may be read
+      volatile bool m_complete;
+      Private::TraceThread* m_thread;
+      
+      LIB_LOCAL OrganismTrace(GenomePtr genome);
+      
     public:
       LIB_EXPORT OrganismTrace(cWorld* world, GenomePtr genome, double mut_rate = 0.0, int seed = -1);
       LIB_EXPORT ~OrganismTrace();
       
+      // Start tracing a copy of genome on a background thread and return immediately.  Snapshots become available in
+      // order as they are produced.  Traces with a fixed seed are deterministic, so the most recent of them are cached
+      // and handed out again for the same world, genome, mutation rate, and seed.  The world must not be changed by
+      // other threads while the trace runs.
+      LIB_EXPORT static OrganismTracePtr TraceInBackground(cWorld* world, GenomePtr genome, double mut_rate = 0.0,
+                                                           int seed = -1);
+      
       LIB_EXPORT inline ConstGenomePtr OrganismGenome() const { return m_genome; }
-      LIB_EXPORT inline ConstGenomePtr OffspringGenome() const { return m_offspring_genome; }
+      LIB_EXPORT ConstGenomePtr OffspringGenome() const;
+      
+      LIB_EXPORT inline bool IsComplete() const { return m_complete; }
+      LIB_EXPORT void WaitForCompletion() const;
       
-      LIB_EXPORT inline int SnapshotCount() const { return m_snapshots.GetSize(); }
-      LIB_EXPORT inline const HardwareSnapshot& Snapshot(int idx) const { return *m_snapshots[idx]; }      
+      LIB_EXPORT inline int SnapshotCount() const { return m_available; }
+      LIB_EXPORT const HardwareSnapshot& Snapshot(int idx) const;
     };
     
   };
@@ -869,10 +869,12 @@ private:
   bool m_first;
   double m_1st_inflow;
   int m_start;
+  int m_res_id;
   const double m_pi = 3.1415926535897932384626433832795;
   
 public:
-  cActionSetPeriodicResourceInflow(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_name(""), m_period(0), m_first(true)
+  cActionSetPeriodicResourceInflow(cWorld* world, const cString& args, Feedback&)
+    : cAction(world, args), m_name(""), m_period(0), m_first(true), m_res_id(-1)
   {
     cString largs(args);
     if (largs.GetSize()) m_name = largs.PopWord();
@@ -886,12 +888,16 @@ public:
     if (m_first) {
       m_start = m_world->GetStats().GetUpdate();
       cResource* resource = m_world->GetEnvironment().GetResourceLib().GetResource(m_name);
-      if (NULL != resource) m_1st_inflow = resource->GetInflow();
+      if (NULL != resource) {
+        m_1st_inflow = resource->GetInflow();
+        m_res_id = resource->GetID();
+      }
       m_first = false;
     }
     double step = m_world->GetStats().GetUpdate() - m_start;
     double inflow = m_1st_inflow * (cos(m_pi + step *2*m_pi/m_period) + 1)/2;
-    m_world->GetPopulation().SetResourceInflow(m_name, inflow);
+    if (m_res_id != -1) m_world->GetPopulation().SetResourceInflow(m_res_id, inflow);
+    else m_world->GetPopulation().SetResourceInflow(m_name, inflow);
   }
 };
 
@@ -281,7 +281,7 @@ public:
 };
 
 
-class cActionDumpLandscape : public cAction  // @not_parallelized
+class cActionDumpLandscape : public cAction  // @parallelized
 {
 private:
   cString m_filename;
@@ -312,18 +312,29 @@ public:
         ctx.Driver().Feedback().Notify("Dumping Landscape...");
       }
       
+      // Calculate all of the landscapes in parallel, then write them out in batch order
+      tList<cLandscape> lands;
+      tAnalyzeJobBatch<cLandscape> jobbatch(m_world->GetAnalyze().GetJobQueue());
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
-      while ((genotype = batch_it.Next())) {        
+      while ((genotype = batch_it.Next())) {
+        cLandscape* land = new cLandscape(m_world, genotype->GetGenome());
+        lands.PushRear(land);
+        jobbatch.AddJob(land, &cLandscape::PrepareDump);
+      }
+      jobbatch.RunBatch();
+      
+      batch_it.Reset();
+      cLandscape* land = NULL;
+      while ((genotype = batch_it.Next()) && (land = lands.Pop())) {
         // Create datafile for genotype landscape (${name}.land)
         cString gfn(genotype->GetName());
         gfn += ".land";
         Avida::Output::FilePtr gdf = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)gfn);
         
-        // Create the landscape object and process the dump
-        cLandscape land(m_world, genotype->GetGenome());
-        land.ProcessDump(ctx, *gdf);
-        land.PrintStats(*sdf, -1);
+        land->ProcessDump(ctx, *gdf);
+        land->PrintStats(*sdf, -1);
+        delete land;
       }
     }
   }
@@ -457,7 +468,7 @@ public:
 };
 
 
-class cActionPredictWLandscape : public cAction  // @not_parallelized
+class cActionPredictWLandscape : public cAction  // @parallelized
 {
 private:
   cString m_filename;
@@ -488,18 +499,29 @@ public:
         ctx.Driver().Feedback().Notify("Predicting W Landscape...");
       }
       
+      // Build the one-step fitness charts in parallel, then sample and write them out in batch order
+      tList<cLandscape> lands;
+      tAnalyzeJobBatch<cLandscape> jobbatch(m_world->GetAnalyze().GetJobQueue());
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
       while ((genotype = batch_it.Next())) {
-        cLandscape land(m_world, genotype->GetGenome());
-        land.PredictWProcess(ctx, *df);
+        cLandscape* land = new cLandscape(m_world, genotype->GetGenome());
+        lands.PushRear(land);
+        jobbatch.AddJob(land, &cLandscape::PreparePredict);
+      }
+      jobbatch.RunBatch();
+      
+      cLandscape* land = NULL;
+      while ((land = lands.Pop())) {
+        land->PredictWProcess(ctx, *df);
+        delete land;
       }
     }
   }
 };
 
 
-class cActionPredictNuLandscape : public cAction  // @not_parallelized
+class cActionPredictNuLandscape : public cAction  // @parallelized
 {
 private:
   cString m_filename;
@@ -530,11 +552,22 @@ public:
         ctx.Driver().Feedback().Notify("Predicting Nu Landscape...");
       }
       
+      // Build the one-step fitness charts in parallel, then sample and write them out in batch order
+      tList<cLandscape> lands;
+      tAnalyzeJobBatch<cLandscape> jobbatch(m_world->GetAnalyze().GetJobQueue());
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
       while ((genotype = batch_it.Next())) {
-        cLandscape land(m_world, genotype->GetGenome());
-        land.PredictNuProcess(ctx, *df);
+        cLandscape* land = new cLandscape(m_world, genotype->GetGenome());
+        lands.PushRear(land);
+        jobbatch.AddJob(land, &cLandscape::PreparePredict);
+      }
+      jobbatch.RunBatch();
+      
+      cLandscape* land = NULL;
+      while ((land = lands.Pop())) {
+        land->PredictNuProcess(ctx, *df);
+        delete land;
       }
     }
   }
@@ -657,7 +690,7 @@ public:
 };
 
 
-class cActionHillClimb : public cAction  // @not_parallelized
+class cActionHillClimb : public cAction  // @parallelized
 {
 private:
   cString m_filename;
@@ -687,11 +720,22 @@ public:
       }
       
       Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+      // Climb from every genotype in parallel, then write the climbs out in batch order
+      tList<cLandscape> lands;
+      tAnalyzeJobBatch<cLandscape> jobbatch(m_world->GetAnalyze().GetJobQueue());
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
       while ((genotype = batch_it.Next())) {
-        cLandscape land(m_world, genotype->GetGenome());
-        land.HillClimb(ctx, *df);
+        cLandscape* land = new cLandscape(m_world, genotype->GetGenome());
+        lands.PushRear(land);
+        jobbatch.AddJob(land, &cLandscape::HillClimbProcess);
+      }
+      jobbatch.RunBatch();
+      
+      cLandscape* land = NULL;
+      while ((land = lands.Pop())) {
+        land->PrintHillClimb(*df);
+        delete land;
       }
     }
   }
@@ -704,6 +748,7 @@ class cActionMutationalNeighborhood : public cAction  // @parallelized
 private:
   cString m_filename;
   int m_target;
+  int m_twostep_budget;
   
   struct sBatchEntry {
     cMutationalNeighborhood* mutn;
@@ -716,16 +761,17 @@ private:
   
 public:
   cActionMutationalNeighborhood(cWorld* world, const cString& args, Feedback&)
-    : cAction(world, args), m_filename("mut-neighborhood.dat"), m_target(-1)
+    : cAction(world, args), m_filename("mut-neighborhood.dat"), m_target(-1), m_twostep_budget(-1)
   {
       cString largs(args);
       if (largs.GetSize()) m_filename = largs.PopWord();
       if (largs.GetSize()) m_target = largs.PopWord().AsInt();
+      if (largs.GetSize()) m_twostep_budget = largs.PopWord().AsInt();
   }
   
   static const cString GetDescription()
   {
-    return "Arguments: [string fname='mut-neighborhood.dat'] [int target=-1]";
+    return "Arguments: [string fname='mut-neighborhood.dat'] [int target=-1] [int twostep_budget=-1]";
   }
   
   void Process(cAvidaContext& ctx)
@@ -745,7 +791,7 @@ public:
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       cAnalyzeGenotype* genotype = NULL;
       while ((genotype = batch_it.Next())) {
-        mutn = new cMutationalNeighborhood(m_world, genotype->GetGenome(), m_target);
+        mutn = new cMutationalNeighborhood(m_world, genotype->GetGenome(), m_target, m_twostep_budget);
         m_batch.PushRear(new sBatchEntry(mutn, genotype->GetDepth()));
         jobqueue.AddJob(new tAnalyzeJob<cMutationalNeighborhood>(mutn, &cMutationalNeighborhood::Process));
       }
@@ -923,7 +969,7 @@ public:
         assert(seq);
         
         cString name;
-        if ((bool)Apto::StrAs(genotype->Properties().Get("threshold"))) name = genotype->Properties().Get("name").StringValue();
+        if ((bool)genotype->IntProperty(Systematics::GROUP_PROP_THRESHOLD)) name = genotype->StringProperty(Systematics::GROUP_PROP_NAME);
         else name.Set("%03d-no_name-u%i-c%i", seq->GetSize(), update, orgdata->GetCellID());
 
         
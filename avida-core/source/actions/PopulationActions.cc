@@ -40,6 +40,7 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
+#include "cHardwareTraceRecorder.h"
 #include "cInstSet.h"
 #include "cOrgMessagePredicate.h"
 #include "cPopulation.h"
@@ -128,7 +129,9 @@ public:
     m_world->GetPopulation().Inject(*genome, Systematics::Source(Systematics::DIVISION, "", true), ctx, m_cell_id, m_merit, m_lineage_label, m_neutral_metric, false);
     
     if (m_trace_filename.GetSize()) {
-      HardwareTracerPtr tracer(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)m_trace_filename));
+      HardwareTracerPtr tracer;
+      if (m_world->GetConfig().BINARY_TRACES.Get()) tracer = HardwareTracerPtr(new cHardwareTraceRecorder(m_world, m_trace_filename));
+      else tracer = HardwareTracerPtr(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)m_trace_filename));
       m_world->GetPopulation().GetCell(m_cell_id).GetOrganism()->GetHardware().SetTrace(tracer);
     }
   }
@@ -654,7 +657,9 @@ public:
     m_world->GetPopulation().InjectGroup(*genome, Systematics::Source(Systematics::DIVISION, "", true), ctx, m_cell_id, m_merit, m_lineage_label, m_neutral_metric, m_group_id, m_forager_type, m_trace); 
   
     if (m_trace_filename.GetSize()) {
-      HardwareTracerPtr tracer(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)m_trace_filename));
+      HardwareTracerPtr tracer;
+      if (m_world->GetConfig().BINARY_TRACES.Get()) tracer = HardwareTracerPtr(new cHardwareTraceRecorder(m_world, m_trace_filename));
+      else tracer = HardwareTracerPtr(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)m_trace_filename));
       m_world->GetPopulation().GetCell(m_cell_id).GetOrganism()->GetHardware().SetTrace(tracer);
     }
   }
@@ -1249,11 +1254,7 @@ public:
     for (int i = 0; i < live_orgs.GetSize(); i++) {
       if (live_orgs[i]->SystematicsGroup("genotype")->ID() == dom_id) doomed_orgs.Push(live_orgs[i]->GetCellID());
     }
-    cPopulation& pop = m_world->GetPopulation();                                                
-    
-    for (int j=0; j < doomed_orgs.GetSize(); j++) {
-      pop.KillOrganism(ctx, doomed_orgs[j]);
-    }
+    m_world->GetPopulation().KillOrganisms(doomed_orgs, ctx);
   }
 };
 
@@ -3994,8 +3995,8 @@ public:
       cerr << "cellB: " << temp_x << " " << temp_y << endl;
 #endif
       
-      tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-      tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+      cConnectionList cellA_list = cellA.ConnectionList();
+      cConnectionList cellB_list = cellB.ConnectionList();
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB));
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB0));
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB1));
@@ -4071,8 +4072,8 @@ public:
       cerr << "cellB: " << temp_x << " " << temp_y << endl;
 #endif
       
-      tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-      tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+      cConnectionList cellA_list = cellA.ConnectionList();
+      cConnectionList cellB_list = cellB.ConnectionList();
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB));
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB0));
       cellA_list.Remove(&m_world->GetPopulation().GetCell(idB1));
@@ -4133,8 +4134,8 @@ public:
       cPopulationCell& cellB = m_world->GetPopulation().GetCell(idB);
       
       //grab the cell lists
-      tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-      tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+      cConnectionList cellA_list = cellA.ConnectionList();
+      cConnectionList cellB_list = cellB.ConnectionList();
       
       //these cells are always joined
       if (cellA_list.FindPtr(&cellB)  == NULL) cellA_list.Push(&cellB);
@@ -4209,8 +4210,8 @@ public:
       cPopulationCell& cellB = m_world->GetPopulation().GetCell(idB);
       
       //grab the cell lists
-      tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-      tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+      cConnectionList cellA_list = cellA.ConnectionList();
+      cConnectionList cellB_list = cellB.ConnectionList();
       
       //these cells are always joined
       if (cellA_list.FindPtr(&cellB)  == NULL) cellA_list.Push(&cellB);
@@ -4268,8 +4269,8 @@ public:
     int idB = m_b_y * world_x + m_b_x;
     cPopulationCell& cellA = m_world->GetPopulation().GetCell(idA);
     cPopulationCell& cellB = m_world->GetPopulation().GetCell(idB);
-    tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-    tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+    cConnectionList cellA_list = cellA.ConnectionList();
+    cConnectionList cellB_list = cellB.ConnectionList();
     cellA_list.PushRear(&cellB);
     cellB_list.PushRear(&cellA);
   }
@@ -4308,8 +4309,8 @@ public:
     int idB = m_b_y * world_x + m_b_x;
     cPopulationCell& cellA = m_world->GetPopulation().GetCell(idA);
     cPopulationCell& cellB = m_world->GetPopulation().GetCell(idB);
-    tList<cPopulationCell>& cellA_list = cellA.ConnectionList();
-    tList<cPopulationCell>& cellB_list = cellB.ConnectionList();
+    cConnectionList cellA_list = cellA.ConnectionList();
+    cConnectionList cellB_list = cellB.ConnectionList();
     cellA_list.Remove(&cellB);
     cellB_list.Remove(&cellA);
   }
@@ -28,6 +28,7 @@
 #include "avida/data/Package.h"
 #include "avida/data/Recorder.h"
 #include "avida/output/File.h"
+#include "avida/output/SharedMemory.h"
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Group.h"
 #include "avida/systematics/Manager.h"
@@ -45,6 +46,7 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHistogram.h"
+#include "cInstProfiler.h"
 #include "cInstSet.h"
 #include "cMigrationMatrix.h"
 #include "cOrganism.h"
@@ -97,7 +99,9 @@ STATS_OUT_FILE(PrintRetMessageLog,          retmessage_log.dat  );
 STATS_OUT_FILE(PrintInterruptData,          interrupt.dat       );
 STATS_OUT_FILE(PrintTotalsData,             totals.dat          );
 STATS_OUT_FILE(PrintTasksData,              tasks.dat           );
+STATS_OUT_FILE(PrintSampleData,             sample.dat          );
 STATS_OUT_FILE(PrintThreadsData,            threads.dat         );
+STATS_OUT_FILE(PrintSpeculativeData,        speculative.dat     );
 STATS_OUT_FILE(PrintHostTasksData,          host_tasks.dat      );
 STATS_OUT_FILE(PrintParasiteTasksData,      parasite_tasks.dat  );
 STATS_OUT_FILE(PrintTasksExeData,           tasks_exe.dat       );
@@ -165,6 +169,7 @@ STATS_OUT_FILE(PrintDemeCurrentTaskExeData,	deme_cur_task_exe.dat	);
 STATS_OUT_FILE(PrintDemeMigrationSuicidePoints,	deme_mig_suicide_points.dat	);
 STATS_OUT_FILE(PrintMultiProcessData,       multiprocess.dat);
 STATS_OUT_FILE(PrintProfilingData,          profiling.dat);
+STATS_OUT_FILE(PrintMemoryData,             memory.dat);
 STATS_OUT_FILE(PrintOrganismLocation,       location.dat);
 
 STATS_OUT_FILE(PrintCurrentTaskCounts,      curr_task_counts.dat);
@@ -289,25 +294,18 @@ public:
       df->WriteComment("Column 1 is the update");
       df->WriteComment("Column 2 is the name of the resource");
       df->WriteComment("The remaining columns are abundance of the named resource per cell");
-      df->FlushComments();
+      if (!df->IsBinary()) df->FlushComments();  // binary files keep the comments for their header
       m_first_run = false;
     }
     
     cPopulation& pop = m_world->GetPopulation();
     const cResourceCount& res_count = pop.GetResourceCount();
-    int world_size = pop.GetSize();
     
     for (int res_id=0; res_id < stats.GetResources().GetSize(); res_id++){
-      int geometry = stats.GetResourceGeometries()[res_id];
       if (res_count.IsSpatialResource(res_id)){
-        df->WriteAnonymous(stats.GetUpdate());
-        df->WriteAnonymous(stats.GetResourceNames()[res_id]);
-        for (int cell_ndx=0; cell_ndx < world_size; cell_ndx++){
-          df->OFStream() << stats.GetSpatialResourceCount()[res_id][cell_ndx];
-          if (cell_ndx < world_size-1){
-            df->OFStream() << " ";
-          } 
-        }
+        df->Write(stats.GetUpdate(), "Update");
+        df->Write(stats.GetResourceNames()[res_id], "Resource");
+        df->WriteBlock(stats.GetSpatialResourceCount()[res_id], "Abundance per cell");
         df->Endl();
       }
     }
@@ -471,6 +469,128 @@ public:
   }
 };
 
+// Writes the instruction cost histogram sampled since the last print: for each instruction the mean time per sampled
+// execution (CPU time stamp counter ticks, or microseconds where unavailable) and its share of all sampled time
+class cActionPrintInstProfileData : public cAction
+{
+private:
+  cString m_filename;
+  Apto::String m_inst_set;
+
+public:
+  cActionPrintInstProfileData(cWorld* world, const cString& args, Feedback& feedback)
+  : cAction(world, args), m_inst_set(world->GetHardwareManager().GetDefaultInstSet().GetInstSetName())
+  {
+    cString largs(args);
+    largs.Trim();
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    if (largs.GetSize()) m_inst_set = (const char*)largs.PopWord();
+
+    if (m_filename == "") m_filename.Set("inst_profile-%s.dat", (const char*)m_inst_set);
+
+    if (!world->GetHardwareManager().GetInstProfiler()) {
+      feedback.Warning("PrintInstProfileData: INST_PROFILE_INTERVAL is 0, no instruction costs will be sampled");
+    }
+  }
+
+  static const cString GetDescription() { return "Arguments: [string fname=\"inst_profile-${inst_set}.dat\"] [string inst_set]"; }
+
+  void Process(cAvidaContext&)
+  {
+    const cInstSet& is = m_world->GetHardwareManager().GetInstSet(m_inst_set);
+    Apto::Array<int> samples;
+    Apto::Array<cInstProfiler::tTicks> ticks;
+    cInstProfiler* profiler = m_world->GetHardwareManager().GetInstProfiler();
+    if (profiler) profiler->TakeHistogram(&is, samples, ticks);
+    else {
+      samples.Resize(is.GetSize());
+      ticks.Resize(is.GetSize());
+      samples.SetAll(0);
+      ticks.SetAll(0);
+    }
+
+    double total_ticks = 0.0;
+    int total_samples = 0;
+    for (int i = 0; i < samples.GetSize(); i++) {
+      total_ticks += (double)ticks[i];
+      total_samples += samples[i];
+    }
+
+    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+
+    df->WriteComment("Avida sampled instruction cost data");
+    df->WriteComment("Mean ticks per sampled execution of each instruction, then each instruction's share of sampled ticks");
+    df->WriteTimeStamp();
+
+    df->Write(m_world->GetStats().GetUpdate(), "Update");
+    df->Write(total_samples, "Instructions sampled");
+    for (int i = 0; i < samples.GetSize(); i++) {
+      df->Write((samples[i]) ? (double)ticks[i] / samples[i] : 0.0, cStringUtil::Stringf("%s mean ticks", (const char*)is.GetName(i)));
+    }
+    for (int i = 0; i < samples.GetSize(); i++) {
+      df->Write((total_ticks > 0.0) ? (double)ticks[i] / total_ticks : 0.0, cStringUtil::Stringf("%s share", (const char*)is.GetName(i)));
+    }
+    df->Endl();
+  }
+};
+
+// Publishes the listed data values every update into a memory mapped file (see Output::SharedMemory), for external
+// monitors that poll live runs
+class cActionExportLiveStats : public cAction, public Data::Recorder
+{
+private:
+  Apto::Array<Data::DataID> m_data_ids;
+  Apto::Array<double> m_values;
+  Avida::Output::SharedMemoryPtr m_region;
+  
+public:
+  cActionExportLiveStats(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args)
+  {
+    cString largs(args);
+    largs.Trim();
+    cString filename = (largs.GetSize()) ? largs.PopWord() : cString("live_stats.shm");
+    while (largs.GetSize()) m_data_ids.Push((const char*)largs.PopWord());
+    if (!m_data_ids.GetSize()) {
+      m_data_ids.Push("core.update");
+      m_data_ids.Push("core.world.organisms");
+    }
+    m_values.Resize(m_data_ids.GetSize(), 0.0);
+    
+    m_region = Avida::Output::SharedMemory::CreateWithPath(m_world->GetNewWorld(), (const char*)filename, m_data_ids, &feedback);
+    if (!m_region) return;
+    
+    Data::RecorderPtr thisPtr(this);
+    this->AddReference();
+    if (!m_world->GetDataManager()->AttachRecorder(thisPtr)) {
+      feedback.Error("ExportLiveStats: unable to activate requested data values");
+      m_region = Avida::Output::SharedMemoryPtr(NULL);
+    }
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string fname=\"live_stats.shm\"] [string data_id ...]"; }
+  
+  Data::ConstDataSetPtr RequestedData() const
+  {
+    Data::DataSetPtr ds(new Data::DataSet);
+    for (int i = 0; i < m_data_ids.GetSize(); i++) ds->Insert(m_data_ids[i]);
+    return ds;
+  }
+  
+  void NotifyData(Update update, Data::DataRetrievalFunctor retrieve_data)
+  {
+    if (!m_region) return;
+    for (int i = 0; i < m_data_ids.GetSize(); i++) {
+      Data::PackagePtr value = retrieve_data(m_data_ids[i]);
+      if (value) m_values[i] = value->DoubleValue();
+    }
+    m_region->Publish(update, m_values);
+  }
+  
+  // Values are published as they become available, there is nothing more to do when the event fires
+  void Process(cAvidaContext&) { ; }
+};
+
+
 class cActionPrintFromMessageInstructionData : public cAction, public Data::Recorder
 {
 private:
@@ -555,6 +675,9 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("prey_instruction-%s.dat", (const char*)m_inst_set);
+    
+    // The per class instruction counts are only collected while some action prints them
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"prey_instruction-${inst_set}.dat\"] [string inst_set]"; }
@@ -584,6 +707,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("predator_instruction-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"predator_instruction-${inst_set}.dat\"] [string inst_set]"; }
@@ -613,6 +738,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("top_pred_instruction-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"top_pred_instruction-${inst_set}.dat\"] [string inst_set]"; }
@@ -642,6 +769,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("prey_from_sensor_exec-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"prey_from_sensor_exec-${inst_set}.dat\"] [string inst_set]"; }
@@ -671,6 +800,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("predator_from_sensor_exec-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"predator_from_sensor_exec-${inst_set}.dat\"] [string inst_set]"; }
@@ -700,6 +831,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("top_pred_from_sensor_exec-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"top_pred_from_sensor_exec-${inst_set}.dat\"] [string inst_set]"; }
@@ -729,6 +862,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("group_attacks-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"group_attacks-${inst_set}.dat\"] [string inst_set]"; }
@@ -784,6 +919,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("male_instruction-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"male_instruction-${inst_set}.dat\"] [string inst_set]"; }
@@ -813,6 +950,8 @@ public:
     if (largs.GetSize()) m_inst_set = largs.PopWord();
     
     if (m_filename == "") m_filename.Set("female_instruction-%s.dat", (const char*)m_inst_set);
+    
+    world->GetStats().RequestClassInstStats();
   }
   
   static const cString GetDescription() { return "Arguments: [string fname=\"female_instruction-${inst_set}.dat\"] [string inst_set]"; }
@@ -857,12 +996,11 @@ public:
     inst_counts.SetAll(0);
     
     //looping through all CPUs counting up instructions
-    const int num_cells = population.GetSize();
-    for (int x = 0; x < num_cells; x++) {
-      cPopulationCell& cell = population.GetCell(x);
-      if (cell.IsOccupied() && cell.GetOrganism()->GetGenome().Properties().Get("instset").StringValue() == is.GetInstSetName()) {
+    const cPopulationSnapshot& snapshot = population.GetSnapshot();
+    for (int x = 0; x < snapshot.GetSize(); x++) {
+      if (snapshot[x].inst_set == is.GetInstSetName()) {
         // access this CPU's code block
-        cCPUMemory& cpu_mem = cell.GetOrganism()->GetHardware().GetMemory();
+        cCPUMemory& cpu_mem = snapshot[x].org->GetHardware().GetMemory();
         const int mem_size = cpu_mem.GetSize();
         for (int y = 0; y < mem_size; y++) inst_counts[cpu_mem[y].GetOp()]++;
       }
@@ -955,7 +1093,7 @@ public:
     
     while (it->Next()) {
       Systematics::GroupPtr bg = it->Get();
-      int transmission_type = Apto::StrAs(bg->Properties().Get("src_transmission_type"));
+      int transmission_type = bg->IntProperty(Systematics::GROUP_PROP_SRC_TRANSMISSION_TYPE);
       if(transmission_type == Systematics::HORIZONTAL || transmission_type == Systematics::VERTICAL)
       {
         if (bg->Depth() < min) min = bg->Depth();
@@ -976,7 +1114,7 @@ public:
     it = classmgr->ArbiterForRole("genotype")->Begin();
     while (it->Next()) {
       Systematics::GroupPtr bg = it->Get();
-      int transmission_type = Apto::StrAs(bg->Properties().Get("src_transmission_type"));
+      int transmission_type = bg->IntProperty(Systematics::GROUP_PROP_SRC_TRANSMISSION_TYPE);
       if(transmission_type == Systematics::HORIZONTAL || transmission_type == Systematics::VERTICAL)
       {
         n[bg->Depth() - min] += bg->NumUnits();
@@ -1020,7 +1158,7 @@ public:
     
     while (it->Next()) {
       Systematics::GroupPtr bg = it->Get();
-      int transmission_type = Apto::StrAs(bg->Properties().Get("src_transmission_type"));
+      int transmission_type = bg->IntProperty(Systematics::GROUP_PROP_SRC_TRANSMISSION_TYPE);
       if(transmission_type == Systematics::HORIZONTAL || transmission_type == Systematics::VERTICAL)
       {
         if (bg->Depth() < min) min = bg->Depth();
@@ -1038,7 +1176,7 @@ public:
     it = classmgr->ArbiterForRole("genotype")->Begin();
     while (it->Next()) {
       Systematics::GroupPtr bg = it->Get();
-      int transmission_type = Apto::StrAs(bg->Properties().Get("src_transmission_type"));
+      int transmission_type = bg->IntProperty(Systematics::GROUP_PROP_SRC_TRANSMISSION_TYPE);
       if(transmission_type == Systematics::HORIZONTAL || transmission_type == Systematics::VERTICAL)
       {
         n[bg->Depth() - min] += bg->NumUnits();
@@ -1201,9 +1339,9 @@ public:
     Systematics::GroupPtr bg = it->Next();
     if (bg) {
       cString filename(m_filename);
-      if (filename == "") filename.Set("archive/%s.org", (const char*)bg->Properties().Get("name").StringValue());
+      if (filename == "") filename.Set("archive/%s.org", (const char*)bg->StringProperty(Systematics::GROUP_PROP_NAME));
       cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-      testcpu->PrintGenome(ctx, Genome(bg->Properties().Get("genome")), filename, m_world->GetStats().GetUpdate());
+      testcpu->PrintGenome(ctx, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME)), filename, m_world->GetStats().GetUpdate());
       delete testcpu;
     }
   }
@@ -1243,10 +1381,10 @@ public:
       
       if (!bg) break;
       
-      if (bg && ((bool)Apto::StrAs(bg->Properties().Get("threshold")) || i == 0)) {
-        int last_birth_group_id = Apto::StrAs(bg->Properties().Get("last_group_id")); 
-        int last_birth_cell = Apto::StrAs(bg->Properties().Get("last_birth_cell"));
-        int last_birth_forager_type = Apto::StrAs(bg->Properties().Get("last_forager_type")); 
+      if (bg && ((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD) || i == 0)) {
+        int last_birth_group_id = bg->IntProperty(Systematics::GROUP_PROP_LAST_GROUP_ID); 
+        int last_birth_cell = bg->IntProperty(Systematics::GROUP_PROP_LAST_BIRTH_CELL);
+        int last_birth_forager_type = bg->IntProperty(Systematics::GROUP_PROP_LAST_FORAGER_TYPE); 
         if (i != 0) {
           for (int j = 0; j < birth_groups_checked.GetSize(); j++) {
             if (last_birth_group_id == birth_groups_checked[j]) {
@@ -1260,14 +1398,14 @@ public:
         if (already_used) continue;
         
         cString filename(m_filename);
-        if (filename == "") filename.Set("archive/grp%d_ft%d_%s.org", last_birth_group_id, last_birth_forager_type, (const char*)bg->Properties().Get("name").StringValue());
+        if (filename == "") filename.Set("archive/grp%d_ft%d_%s.org", last_birth_group_id, last_birth_forager_type, (const char*)bg->StringProperty(Systematics::GROUP_PROP_NAME));
         else filename = filename.Set(filename + "grp%d_ft%d", last_birth_group_id, last_birth_forager_type); 
         
         // need a random number generator to pass to testcpu that does not affect any other random number pulls (since this is just for printing the genome)
         Apto::RNG::AvidaRNG rng(0);
         cAvidaContext ctx2(&m_world->GetDriver(), rng);
         cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx2);
-        testcpu->PrintGenome(ctx2, Genome(bg->Properties().Get("genome")), filename, m_world->GetStats().GetUpdate(), true, last_birth_cell, last_birth_group_id, last_birth_forager_type);
+        testcpu->PrintGenome(ctx2, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME)), filename, m_world->GetStats().GetUpdate(), true, last_birth_cell, last_birth_group_id, last_birth_forager_type);
         delete testcpu;
       }
     }
@@ -1307,10 +1445,10 @@ public:
       
       if (!bg) break;
       
-      if (bg && ((bool)Apto::StrAs(bg->Properties().Get("threshold")) || i == 0)) {
-        int last_birth_group_id = Apto::StrAs(bg->Properties().Get("last_group_id")); 
-        int last_birth_cell = Apto::StrAs(bg->Properties().Get("last_birth_cell"));
-        int last_birth_forager_type = Apto::StrAs(bg->Properties().Get("last_forager_type")); 
+      if (bg && ((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD) || i == 0)) {
+        int last_birth_group_id = bg->IntProperty(Systematics::GROUP_PROP_LAST_GROUP_ID); 
+        int last_birth_cell = bg->IntProperty(Systematics::GROUP_PROP_LAST_BIRTH_CELL);
+        int last_birth_forager_type = bg->IntProperty(Systematics::GROUP_PROP_LAST_FORAGER_TYPE); 
         if (i != 0) {
           for (int j = 0; j < birth_forage_types_checked.GetSize(); j++) {
             if (last_birth_forager_type == birth_forage_types_checked[j]) { 
@@ -1325,14 +1463,14 @@ public:
         
         
         cString filename(m_filename);
-        if (filename == "") filename.Set("archive/ft%d_grp%d_%s.org", last_birth_forager_type, last_birth_group_id, (const char*)bg->Properties().Get("name").StringValue());
+        if (filename == "") filename.Set("archive/ft%d_grp%d_%s.org", last_birth_forager_type, last_birth_group_id, (const char*)bg->StringProperty(Systematics::GROUP_PROP_NAME));
         else filename = filename.Set(filename + ".ft%d_grp%d", last_birth_forager_type, last_birth_group_id); 
         
         // need a random number generator to pass to testcpu that does not affect any other random number pulls (since this is just for printing the genome)
         Apto::RNG::AvidaRNG rng(0);
         cAvidaContext ctx2(&m_world->GetDriver(), rng);
         cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx2);
-        testcpu->PrintGenome(ctx2, Genome(bg->Properties().Get("genome")), filename, m_world->GetStats().GetUpdate(), true, last_birth_cell, last_birth_group_id, last_birth_forager_type);
+        testcpu->PrintGenome(ctx2, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME)), filename, m_world->GetStats().GetUpdate(), true, last_birth_cell, last_birth_group_id, last_birth_forager_type);
         delete testcpu;
       }
     }
@@ -1374,9 +1512,23 @@ private:
   double m_hist_fstep;
   cString m_filenames[3];
   
+  // Gathered by Prepare(), written by Process()
+  bool m_prepared;
+  int m_update;
+  double m_generation;
+  Apto::Array<int> m_histo;
+  Apto::Array<int> m_histo_testCPU;
+  int m_n;
+  int m_nhist_tot;
+  int m_nhist_tot_testCPU;
+  double m_fave;
+  double m_fave_testCPU;
+  double m_max_fitness;
+  Systematics::GroupPtr m_max_f_genotype;
+  
 public:
   cActionPrintDetailedFitnessData(cWorld* world, const cString& args, Feedback&)
-  : cAction(world, args), m_save_max(0), m_print_fitness_histo(0), m_hist_fmax(1.0), m_hist_fstep(0.1)
+  : cAction(world, args), m_save_max(0), m_print_fitness_histo(0), m_hist_fmax(1.0), m_hist_fstep(0.1), m_prepared(false)
   {
     cString largs(args);
     if (largs.GetSize()) m_save_max = largs.PopWord().AsInt();
@@ -1390,41 +1542,42 @@ public:
   
   static const cString GetDescription() { return "Arguments: [int save_max_f_genotype=0] [int print_fitness_histo=0] [double hist_fmax=1] [double hist_fstep=0.1] [string datafn=\"fitness.dat\"] [string histofn=\"fitness_histos.dat\"] [string histotestfn=\"fitness_histos_testCPU.dat\"]"; }
   
-  void Process(cAvidaContext& ctx)
+  bool IsReadOnly() const { return true; }
+  
+  void Prepare(cAvidaContext& ctx)
   {
     cPopulation& pop = m_world->GetPopulation();
-    const int update = m_world->GetStats().GetUpdate();
-    const double generation = m_world->GetStats().SumGeneration().Average();
+    m_update = m_world->GetStats().GetUpdate();
+    m_generation = m_world->GetStats().SumGeneration().Average();
     
     // the histogram variables
-    Apto::Array<int> histo;
-    Apto::Array<int> histo_testCPU;
+    m_histo.Resize(0);
+    m_histo_testCPU.Resize(0);
     int bins = 0;
     
     if (m_print_fitness_histo) {
       bins = static_cast<int>(m_hist_fmax / m_hist_fstep) + 1;
-      histo.Resize(bins, 0);
-      histo_testCPU.Resize(bins, 0 );
+      m_histo.Resize(bins, 0);
+      m_histo_testCPU.Resize(bins, 0 );
     }
     
-    int n = 0;
-    int nhist_tot = 0;
-    int nhist_tot_testCPU = 0;
-    double fave = 0;
-    double fave_testCPU = 0;
-    double max_fitness = -1; // we set this to -1, so that even 0 is larger...
-    Systematics::GroupPtr max_f_genotype;
+    m_n = 0;
+    m_nhist_tot = 0;
+    m_nhist_tot_testCPU = 0;
+    m_fave = 0;
+    m_fave_testCPU = 0;
+    m_max_fitness = -1; // we set this to -1, so that even 0 is larger...
+    m_max_f_genotype = Systematics::GroupPtr();
     
     cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
     
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (pop.GetCell(i).IsOccupied() == false) continue;  // One use organisms.
-      
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++) {
+      cOrganism* organism = snapshot[i].org;
+      Systematics::GroupPtr genotype = snapshot[i].genotype;
       
       cCPUTestInfo test_info;
-      testcpu->TestGenome(ctx, test_info, Genome(genotype->Properties().Get("genome")));
+      testcpu->TestGenome(ctx, test_info, Genome(genotype->StringProperty(Systematics::GROUP_PROP_GENOME)));
       // We calculate the fitness based on the current merit,
       // but with the true gestation time. Also, we set the fitness
       // to zero if the creature is not viable.
@@ -1434,36 +1587,49 @@ public:
       // Get the maximum fitness in the population
       // Here, we want to count only organisms that can truly replicate,
       // to avoid complications
-      if (f_testCPU > max_fitness && test_info.GetTestPhenotype().CopyTrue()) {
-        max_fitness = f_testCPU;
-        max_f_genotype = genotype;
+      if (f_testCPU > m_max_fitness && test_info.GetTestPhenotype().CopyTrue()) {
+        m_max_fitness = f_testCPU;
+        m_max_f_genotype = genotype;
       }
       
-      fave += f;
-      fave_testCPU += f_testCPU;
-      n += 1;
+      m_fave += f;
+      m_fave_testCPU += f_testCPU;
+      m_n += 1;
       
       
       // histogram
       if (m_print_fitness_histo && f < m_hist_fmax) {
-        histo[static_cast<int>(f / m_hist_fstep)] += 1;
-        nhist_tot += 1;
+        m_histo[static_cast<int>(f / m_hist_fstep)] += 1;
+        m_nhist_tot += 1;
       }
       
       if (m_print_fitness_histo && f_testCPU < m_hist_fmax) {
-        histo_testCPU[static_cast<int>(f_testCPU / m_hist_fstep)] += 1;
-        nhist_tot_testCPU += 1;
+        m_histo_testCPU[static_cast<int>(f_testCPU / m_hist_fstep)] += 1;
+        m_nhist_tot_testCPU += 1;
       }
     }
     
+    delete testcpu;
+    m_prepared = true;
+  }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    if (!m_prepared) Prepare(ctx);
+    m_prepared = false;
+    
+    const int update = m_update;
+    const double generation = m_generation;
+    const int n = m_n;
+    const double fave = m_fave;
     
     // determine the name of the maximum fitness genotype
     cString max_f_name;
-    if ((bool)Apto::StrAs(max_f_genotype->Properties().Get("threshold")))
-      max_f_name = max_f_genotype->Properties().Get("name").StringValue();
+    if ((bool)m_max_f_genotype->IntProperty(Systematics::GROUP_PROP_THRESHOLD))
+      max_f_name = m_max_f_genotype->StringProperty(Systematics::GROUP_PROP_NAME);
     else {
       // we put the current update into the name, so that it becomes unique.
-      Genome gen(max_f_genotype->Properties().Get("genome"));
+      Genome gen(m_max_f_genotype->StringProperty(Systematics::GROUP_PROP_GENOME));
       InstructionSequencePtr seq;
       seq.DynamicCastFrom(gen.Representation());
       max_f_name.Set("%03d-no_name-u%i", seq->GetSize(), update);
@@ -1473,20 +1639,20 @@ public:
     df->Write(update, "Update");
     df->Write(generation, "Generation");
     df->Write(fave / static_cast<double>(n), "Average Fitness");
-    df->Write(fave_testCPU / static_cast<double>(n), "Average Test Fitness");
+    df->Write(m_fave_testCPU / static_cast<double>(n), "Average Test Fitness");
     df->Write(n, "Organism Total");
-    df->Write(max_fitness, "Maximum Fitness");
+    df->Write(m_max_fitness, "Maximum Fitness");
     df->Write(max_f_name, "Maxfit genotype name");
     df->Endl();
     
     if (m_save_max) {
       cString filename;
       filename.Set("archive/%s", static_cast<const char*>(max_f_name));
-      testcpu->PrintGenome(ctx, Genome(max_f_genotype->Properties().Get("genome")), filename);
+      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      testcpu->PrintGenome(ctx, Genome(m_max_f_genotype->StringProperty(Systematics::GROUP_PROP_GENOME)), filename);
+      delete testcpu;
     }
     
-    delete testcpu;
-    
     if (m_print_fitness_histo) {
       Avida::Output::FilePtr hdf = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filenames[1]);
       hdf->Write(update, "Update");
@@ -1494,8 +1660,8 @@ public:
       hdf->Write(fave / static_cast<double>(n), "Average Fitness");
       
       // now output the fitness histo
-      for (int i = 0; i < histo.GetSize(); i++)
-        hdf->WriteAnonymous(static_cast<double>(histo[i]) / static_cast<double>(nhist_tot));
+      for (int i = 0; i < m_histo.GetSize(); i++)
+        hdf->WriteAnonymous(static_cast<double>(m_histo[i]) / static_cast<double>(m_nhist_tot));
       hdf->Endl();
       
       
@@ -1505,8 +1671,8 @@ public:
       tdf->Write(fave / static_cast<double>(n), "Average Fitness");
       
       // now output the fitness histo
-      for (int i = 0; i < histo_testCPU.GetSize(); i++)
-        tdf->WriteAnonymous(static_cast<double>(histo_testCPU[i]) / static_cast<double>(nhist_tot_testCPU));
+      for (int i = 0; i < m_histo_testCPU.GetSize(); i++)
+        tdf->WriteAnonymous(static_cast<double>(m_histo_testCPU[i]) / static_cast<double>(m_nhist_tot_testCPU));
       tdf->Endl();
     }
   }
@@ -1565,11 +1731,10 @@ public:
     const int update = m_world->GetStats().GetUpdate();
     
     //For each organism in the population, find what coalescence clade it belongs to and count
-    for (int k = 0; k < pop.GetSize(); k++)
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int k = 0; k < snapshot.GetSize(); k++)
     {
-      if (!pop.GetCell(k).IsOccupied())
-        continue;
-      int cclade_id = pop.GetCell(k).GetOrganism()->GetCCladeLabel();
+      int cclade_id = snapshot[k].org->GetCCladeLabel();
       int count = 0;
       if (!cclade_count.Get(cclade_id, count))
         clade_ids.insert(cclade_id);
@@ -1700,7 +1865,7 @@ public:
       double fitness = 0.0;
       if (mode == "TEST_CPU" || mode == "ACTUAL"){
         test_info.UseManualInputs(orgs[i]->GetOrgInterface().GetInputs());
-        testcpu->TestGenome(ctx, test_info, Genome(gens[i]->Properties().Get("genome")));
+        testcpu->TestGenome(ctx, test_info, Genome(gens[i]->StringProperty(Systematics::GROUP_PROP_GENOME)));
       }
       
       if (mode == "TEST_CPU"){
@@ -1761,13 +1926,11 @@ public:
     Apto::Array<cOrganism*> orgs;
     Apto::Array<Systematics::GroupPtr> gens;
     
-    for (int i = 0; i < pop.GetSize(); i++)
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++)
     {
-      if (pop.GetCell(i).IsOccupied() == false) continue;  //Skip unoccupied cells
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
-      orgs.Push(organism);
-      gens.Push(genotype);
+      orgs.Push(snapshot[i].org);
+      gens.Push(snapshot[i].genotype);
     }
     
     Apto::Array<int> histogram = MakeHistogram(orgs, gens, m_hist_fmin, m_hist_fstep, m_hist_fmax, m_mode, m_world, ctx);
@@ -1874,8 +2037,8 @@ public:
       cCPUTestInfo test_info;
       double fitness = 0.0;
       double parent_fitness = 1.0;
-      if (gens[i]->Properties().Get("parents").StringValue() != "") {
-        cStringList parents((const char*)gens[i]->Properties().Get("parents").StringValue(), ',');
+      if (gens[i]->StringProperty(Systematics::GROUP_PROP_PARENTS) != "") {
+        cStringList parents((const char*)gens[i]->StringProperty(Systematics::GROUP_PROP_PARENTS), ',');
         
         Systematics::GroupPtr pbg = Systematics::Manager::Of(world->GetNewWorld())->ArbiterForRole("genotype")->Group(parents.Pop().AsInt());
         parent_fitness = Apto::StrAs(pbg->Properties().Get("fitness"));
@@ -1883,7 +2046,7 @@ public:
       
       if (mode == "TEST_CPU" || mode == "ACTUAL"){
         test_info.UseManualInputs( orgs[i]->GetOrgInterface().GetInputs() );
-        testcpu->TestGenome(ctx, test_info, Genome(gens[i]->Properties().Get("genome")));
+        testcpu->TestGenome(ctx, test_info, Genome(gens[i]->StringProperty(Systematics::GROUP_PROP_GENOME)));
       }
       
       if (mode == "TEST_CPU"){
@@ -1902,7 +2065,7 @@ public:
       
       //Update the histogram
       if (parent_fitness <= 0.0) {
-        ctx.Driver().Feedback().Error(cString("PrintRelativeFitness::MakeHistogram reports a parent fitness is zero.") + gens[i]->Properties().Get("parents").StringValue());
+        ctx.Driver().Feedback().Error(cString("PrintRelativeFitness::MakeHistogram reports a parent fitness is zero.") + gens[i]->StringProperty(Systematics::GROUP_PROP_PARENTS));
         ctx.Driver().Abort(Avida::INTERNAL_ERROR);
       }
       
@@ -1941,13 +2104,11 @@ public:
     Apto::Array<cOrganism*> orgs;
     Apto::Array<Systematics::GroupPtr> gens;
     
-    for (int i = 0; i < pop.GetSize(); i++)
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++)
     {
-      if (pop.GetCell(i).IsOccupied() == false) continue;  //Skip unoccupied cells
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
-      orgs.Push(organism);
-      gens.Push(genotype);
+      orgs.Push(snapshot[i].org);
+      gens.Push(snapshot[i].genotype);
     }
     
     Apto::Array<int> histogram = MakeHistogram(orgs, gens, m_hist_fmin, m_hist_fstep, m_hist_fmax, m_mode, m_world, ctx);
@@ -2038,10 +2199,10 @@ public:
     map< int, Apto::Array<Systematics::GroupPtr> > gen_map;  //Map of ccladeID to array of genotype IDs
     
     //Collect clade information
-    for (int i = 0; i < pop.GetSize(); i++){
-      if (pop.GetCell(i).IsOccupied() == false) continue;  //Skip unoccupied cells
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++){
+      cOrganism* organism = snapshot[i].org;
+      Systematics::GroupPtr genotype = snapshot[i].genotype;
       int cladeID = organism->GetCCladeLabel();
       
       map< int, Apto::Array<cOrganism*> >::iterator oit = org_map.find(cladeID);
@@ -2167,10 +2328,10 @@ public:
     map< int, Apto::Array<Systematics::GroupPtr> > gen_map;  //Map of ccladeID to array of genotype IDs
     
     //Collect clade information
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (pop.GetCell(i).IsOccupied() == false) continue;  //Skip unoccupied cells
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++) {
+      cOrganism* organism = snapshot[i].org;
+      Systematics::GroupPtr genotype = snapshot[i].genotype;
       int cladeID = organism->GetCCladeLabel();
       
       map< int, Apto::Array<cOrganism*> >::iterator oit = org_map.find(cladeID);
@@ -2261,12 +2422,10 @@ public:
     else //We're not in analyze mode, process the population
     {
       cPopulation& pop = m_world->GetPopulation();
-      for (int i = 0; i < pop.GetSize(); i++)
+      const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+      for (int i = 0; i < snapshot.GetSize(); i++)
       {
-        if (pop.GetCell(i).IsOccupied() == false) continue;  //Skip unoccupied cells
-        ConstInstructionSequencePtr seq;
-        seq.DynamicCastFrom(pop.GetCell(i).GetOrganism()->GetGenome().Representation());
-        aligned.Push((const char*)seq->AsString());
+        aligned.Push((const char*)snapshot[i].seq->AsString());
       }
       AlignStringArray(aligned);  //Align our population genomes
     }
@@ -2345,6 +2504,17 @@ private:
 
 
 
+// Runs the plasticity tests of every run mode genotype that lacks a summary as one batch, ahead of the per genotype
+// cPhenPlastUtil lookups of the actions below
+static void preparePhenPlastSummaries(cAvidaContext& ctx, cWorld* world, Systematics::ManagerPtr classmgr)
+{
+  Apto::Array<Systematics::GroupPtr, Apto::Smart> groups;
+  Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
+  while (it->Next()) groups.Push(it->Get());
+  cPhenPlastUtil::PrepareSummaries(ctx, world, groups);
+}
+
+
 /*
  This function will go through all genotypes in the population/batch and
  allow you to retrieve information about the different plastic phenotypes.
@@ -2360,6 +2530,12 @@ private:
   cString m_filename;
   int     m_num_trials;
   
+  // Run mode genotypes measured by Prepare(), written by Process()
+  bool m_prepared;
+  Apto::Array<Apto::SmartPtr<cPhenPlastGenotype>, Apto::Smart> m_ppgens;
+  Apto::Array<int, Apto::Smart> m_ids;
+  Apto::Array<cString, Apto::Smart> m_parents;
+  
 private:
   void PrintHeader(ofstream& fot)
   {
@@ -2404,7 +2580,7 @@ private:
   
 public:
   cActionPrintPhenotypicPlasticity(cWorld* world, const cString& args, Feedback&)
-  : cAction(world,  args)
+  : cAction(world,  args), m_prepared(false)
   {
     cString largs(args);
     m_filename = (largs.GetSize()) ? largs.PopWord() : "phenplast";
@@ -2413,6 +2589,28 @@ public:
   
   static const cString GetDescription() { return "Arguments: [string filename='phenplast'] [int num_trials=1000]"; };
   
+  bool IsReadOnly() const { return true; }
+  
+  // Run mode only; analyze mode works straight from the current batch in Process()
+  void Prepare(cAvidaContext& ctx)
+  {
+    m_ppgens.Resize(0);
+    m_ids.Resize(0);
+    m_parents.Resize(0);
+    
+    Apto::Array<Genome, Apto::Smart> genomes;
+    Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
+    Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
+    while (it->Next()) {
+      Systematics::GroupPtr bg = it->Get();
+      genomes.Push(Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME)));
+      m_ids.Push(bg->ID());
+      m_parents.Push((const char*)bg->StringProperty(Systematics::GROUP_PROP_PARENTS));
+    }
+    cPhenPlastUtil::TestPlasticity(ctx, m_world, genomes, m_num_trials, m_ppgens);
+    m_prepared = true;
+  }
+  
   void Process(cAvidaContext& ctx)
   {
     cCPUTestInfo test_info;
@@ -2434,13 +2632,10 @@ public:
       ofstream& fot = df->OFStream();
       PrintHeader(fot);
       
-      Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
-      Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
-      while (it->Next()) {
-        Systematics::GroupPtr bg = it->Get();
-        Apto::SmartPtr<cPhenPlastGenotype> ppgen(new cPhenPlastGenotype(Genome(bg->Properties().Get("genome")), m_num_trials, test_info, m_world, ctx));
-        PrintPPG(fot, ppgen, bg->ID(), (const char*)bg->Properties().Get("parents").StringValue());
-      }
+      if (!m_prepared) Prepare(ctx);
+      m_prepared = false;
+      for (int i = 0; i < m_ppgens.GetSize(); i++) PrintPPG(fot, m_ppgens[i], m_ids[i], m_parents[i]);
+      m_ppgens.Resize(0);
     }
   }
 };
@@ -2517,6 +2712,7 @@ public:
     }
     else {  // E X P E R I M E N T    M O D E  (See above for explination)
       Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
+      preparePhenPlastSummaries(ctx, m_world, classmgr);
       Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
       while (it->Next()) {
         Systematics::GroupPtr bg = it->Get();
@@ -2636,6 +2832,7 @@ public:
     }
     else {  // E X P E R I M E N T    M O D E    (See above for explination)
       Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
+      preparePhenPlastSummaries(ctx, m_world, classmgr);
       Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
       pp_entropy.ResizeClear(num_genotypes);
       pp_taskentropy.ResizeClear(num_genotypes);
@@ -2733,7 +2930,7 @@ public:
     Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
     Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
     it->Next();
-    Genome best_genome(it->Get()->Properties().Get("genome"));
+    Genome best_genome(it->Get()->StringProperty(Systematics::GROUP_PROP_GENOME));
     InstructionSequencePtr best_seq;
     best_seq.DynamicCastFrom(best_genome.Representation());
     dom_dist = InstructionSequence::FindHammingDistance(*m_r_seq, *best_seq);
@@ -2742,7 +2939,7 @@ public:
     count += it->Get()->NumUnits();
     // now cycle over the remaining genotypes
     while ((it->Next())) {
-      Genome cur_gen(it->Get()->Properties().Get("genome"));
+      Genome cur_gen(it->Get()->StringProperty(Systematics::GROUP_PROP_GENOME));
       InstructionSequencePtr cur_seq;
       cur_seq.DynamicCastFrom(cur_gen.Representation());
       int dist = InstructionSequence::FindHammingDistance(*m_r_seq, *cur_seq);
@@ -2820,7 +3017,7 @@ public:
     Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
     while ((it->Next())) {
       Systematics::GroupPtr bg = it->Get();
-      const Genome genome(bg->Properties().Get("genome"));
+      const Genome genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME));
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(genome.Representation());
       const int num_orgs = bg->NumUnits();
@@ -2830,7 +3027,7 @@ public:
       sum_fitness += (double)Apto::StrAs(bg->Properties().Get("fitness")) * num_orgs;
       sum_num_organisms += num_orgs;
       
-      df->Write(bg->Properties().Get("name").StringValue(), "Genotype Name");
+      df->Write(bg->StringProperty(Systematics::GROUP_PROP_NAME), "Genotype Name");
       df->Write((double)Apto::StrAs(bg->Properties().Get("fitness")), "Fitness");
       df->Write(num_orgs, "Abundance");
       df->Write(InstructionSequence::FindHammingDistance(*r_seq, *seq), "Hamming distance to reference");
@@ -2840,7 +3037,7 @@ public:
       // save into archive
       if (m_save_genotypes) {
         cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-        testcpu->PrintGenome(ctx, genome, cStringUtil::Stringf("archive/%s.org", (const char*)(bg->Properties().Get("name").StringValue())));
+        testcpu->PrintGenome(ctx, genome, cStringUtil::Stringf("archive/%s.org", (const char*)(bg->StringProperty(Systematics::GROUP_PROP_NAME))));
         delete testcpu;
       }
       
@@ -2869,7 +3066,7 @@ public:
     Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
     Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
     Systematics::GroupPtr bg = it->Next();
-    Genome genome(bg->Properties().Get("genome"));
+    Genome genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME));
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(genome.Representation());
     
@@ -2915,9 +3112,10 @@ public:
     cPopulation& pop = m_world->GetPopulation();
     cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
     
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (pop.GetCell(i).IsOccupied() == false) continue;
-      cOrganism* organism = pop.GetCell(i).GetOrganism();
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int s = 0; s < snapshot.GetSize(); s++) {
+      const int i = snapshot[s].cell_id;
+      cOrganism* organism = snapshot[s].org;
       
       // create a test-cpu for the current creature
       cCPUTestInfo test_info;
@@ -2959,7 +3157,7 @@ public:
       df->Write(parent_sum_tasks_rewarded, "Parent Number of Tasks Rewared");
       df->Write(parent_sum_tasks_all, "Parent Total Number of Tasks Done");
       df->Write(test_info.GetColonyFitness(), "Genotype Fitness");
-      df->Write(organism->SystematicsGroup("genotype")->ID(), "Genotype ID");
+      df->Write(snapshot[s].genotype->ID(), "Genotype ID");
       df->Endl();
     }
     
@@ -2986,10 +3184,9 @@ public:
     
     int ave_tot_tasks = 0;
     int num_task_orgs = 0;
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (pop.GetCell(i).IsOccupied() == false) continue;
-      
-      cPhenotype& phenotype = pop.GetCell(i).GetOrganism()->GetPhenotype();
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++) {
+      cPhenotype& phenotype = snapshot[i].org->GetPhenotype();
       int num_tasks = m_world->GetEnvironment().GetNumTasks();
       
       int sum_tasks = 0;
@@ -3037,10 +3234,10 @@ public:
     Apto::Array<int> tasks(num_tasks);
     tasks.SetAll(0);
     
-    for (int i = 0; i < pop.GetSize(); i++) {
-      if (!pop.GetCell(i).IsOccupied()) continue;
-      if (pop.GetCell(i).GetOrganism()->GetTestFitness(ctx) > 0.0) {
-        cPhenotype& phenotype = pop.GetCell(i).GetOrganism()->GetPhenotype();
+    const cPopulationSnapshot& snapshot = pop.GetSnapshot();
+    for (int i = 0; i < snapshot.GetSize(); i++) {
+      if (snapshot[i].org->GetTestFitness(ctx) > 0.0) {
+        cPhenotype& phenotype = snapshot[i].org->GetPhenotype();
         for (int j = 0; j < num_tasks; j++) if (phenotype.GetCurTaskCount()[j] > 0) tasks[j]++;
       }
     }
@@ -3095,7 +3292,7 @@ public:
     while ((it->Next())) {
       Systematics::GroupPtr bg = it->Get();
       const int num_organisms = bg->NumUnits();
-      const Genome genome(bg->Properties().Get("genome"));
+      const Genome genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME));
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(genome.Representation());
       const int length = seq->GetSize();
@@ -3167,7 +3364,7 @@ public:
     cDoubleSum distance_sum;
     while ((it->Next())) {
       const int num_organisms = it->Get()->NumUnits();
-      Genome cur_gen(it->Get()->Properties().Get("genome"));
+      Genome cur_gen(it->Get()->StringProperty(Systematics::GROUP_PROP_GENOME));
       InstructionSequencePtr cur_seq;
       cur_seq.DynamicCastFrom(cur_gen.Representation());
       const int cur_dist = InstructionSequence::FindEditDistance(con_genome, *cur_seq);
@@ -3179,7 +3376,7 @@ public:
     //    cGenotype* con_genotype = classmgr.FindGenotype(con_genome, -1);
     
     it = classmgr->ArbiterForRole("genotype")->Begin();
-    Genome best_genome(it->Next()->Properties().Get("genome"));
+    Genome best_genome(it->Next()->StringProperty(Systematics::GROUP_PROP_GENOME));
     InstructionSequencePtr best_seq;
     best_seq.DynamicCastFrom(best_genome.Representation());
     const int best_dist = InstructionSequence::FindEditDistance(con_genome, *best_seq);
@@ -3534,7 +3731,7 @@ public:
         if (bg) {
           int color = 0;
           for (; color < m_num_colors; color++) if (m_genotype_chart[color] == bg->ID()) break;
-          if (color == m_num_colors && (bool)Apto::StrAs(bg->Properties().Get("threshold"))) color++;
+          if (color == m_num_colors && (bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD)) color++;
           fp << color << " ";
         } else {
           fp << "-1 ";
@@ -4147,7 +4344,7 @@ public:
           cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
           if(organism->GetNumParasites() > 0)
           {
-            Apto::Array<Systematics::UnitPtr> parasites = organism->GetParasites();
+            const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites = organism->GetParasites();
             Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
             parasite.DynamicCastFrom(parasites[0]);
             virulence = parasite->GetVirulence();
@@ -4313,12 +4510,11 @@ public:
     }
     
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    std::ofstream& fout = df->OFStream();
     
     if (first_time){
       df->WriteComment("First column is update, second column is reaction name, subsequent columns are individual cells");
       df->WriteComment("-1 for a reaction count indicates the cell is not occupied.");
-      df->FlushComments();
+      if (!df->IsBinary()) df->FlushComments();  // binary files keep the comments for their header
       first_time = false;
     }
     const int UNOCCUPIED = -1;
@@ -4326,18 +4522,20 @@ public:
     cPopulation& pop = m_world->GetPopulation();
     cReactionLib& rlib = m_world->GetEnvironment().GetReactionLib();
     const int update = m_world->GetStats().GetUpdate();
+    Apto::Array<int> counts(pop.GetSize());
     for (int react=0; react < rlib.GetSize(); react++){
-      fout << update << " " << rlib.GetReaction(react)->GetName();
       for (int cell=0; cell < pop.GetSize(); cell++){  
-        fout << " ";
         if (!pop.GetCell(cell).IsOccupied())
-          fout << UNOCCUPIED;
+          counts[cell] = UNOCCUPIED;
         else
-          fout << pop.GetCell(cell).GetOrganism()->GetPhenotype().GetLastReactionCount()[react];
+          counts[cell] = pop.GetCell(cell).GetOrganism()->GetPhenotype().GetLastReactionCount()[react];
       }
+      df->Write(update, "Update");
+      df->Write(rlib.GetReaction(react)->GetName(), "Reaction");
+      df->WriteBlock(counts, "Count per cell");
       df->Endl();
-      df->Flush();
     }
+    if (!df->IsBinary()) df->Flush();
   }
 };
 
@@ -4375,11 +4573,10 @@ public:
     }
     
     Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
-    std::ofstream& fout = df->OFStream();
     if (first_time){
       df->WriteComment("First column is update, second column is reaction name, subsequent columns are individual cells");
       df->WriteComment("-1 for a reaction count indicates the cell is not occupied.");
-      df->FlushComments();
+      if (!df->IsBinary()) df->FlushComments();  // binary files keep the comments for their header
       first_time = false;
     }
     const int UNOCCUPIED = -1;
@@ -4387,18 +4584,20 @@ public:
     cPopulation& pop = m_world->GetPopulation();
     cReactionLib& rlib = m_world->GetEnvironment().GetReactionLib();
     const int update = m_world->GetStats().GetUpdate();
+    Apto::Array<int> counts(pop.GetSize());
     for (int react=0; react < rlib.GetSize(); react++){
-      fout << update << " " << rlib.GetReaction(react)->GetName();
       for (int cell=0; cell < pop.GetSize(); cell++){  
-        fout << " ";
         if (!pop.GetCell(cell).IsOccupied())
-          fout << UNOCCUPIED;
+          counts[cell] = UNOCCUPIED;
         else
-          fout << pop.GetCell(cell).GetOrganism()->GetPhenotype().GetCurReactionCount()[react];
+          counts[cell] = pop.GetCell(cell).GetOrganism()->GetPhenotype().GetCurReactionCount()[react];
       }
+      df->Write(update, "Update");
+      df->Write(rlib.GetReaction(react)->GetName(), "Reaction");
+      df->WriteBlock(counts, "Count per cell");
       df->Endl();
-      df->Flush();
     }
+    if (!df->IsBinary()) df->Flush();
   }
 };
 
@@ -4516,7 +4715,7 @@ public:
           cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
           if (organism->GetNumParasites() > 0)
           {
-            Apto::Array<Systematics::UnitPtr> parasites = organism->GetParasites();
+            const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites = organism->GetParasites();
             Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
             parasite.DynamicCastFrom(parasites[0]);
             genome_seq = parasite->UnitGenome().Representation()->AsString();
@@ -4560,7 +4759,7 @@ public:
           cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
           if(organism->GetNumParasites() > 0)
           {
-            Apto::Array<Systematics::UnitPtr> parasites = organism->GetParasites();
+            const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites = organism->GetParasites();
             Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
             parasite.DynamicCastFrom(parasites[0]);
             genome_seq = parasite->UnitGenome().Representation()->AsString();
@@ -4657,7 +4856,7 @@ public:
     
     fp << "# org_id,age,num_divides" << endl;
     
-    const Apto::Array <cOrganism*, Apto::Smart> live_orgs = m_world->GetPopulation().GetLiveOrgList();
+    const Apto::Array <cOrganism*, Apto::Smart>& live_orgs = m_world->GetPopulation().GetLiveOrgList();
     for (int i = 0; i < live_orgs.GetSize(); i++) {  
       cOrganism* org = live_orgs[i];
       const int id = org->GetID();
@@ -4696,7 +4895,7 @@ public:
     
     const int worldx = m_world->GetConfig().WORLD_X.Get();
     
-    const Apto::Array <cOrganism*, Apto::Smart> live_orgs = m_world->GetPopulation().GetLiveOrgList();
+    const Apto::Array <cOrganism*, Apto::Smart>& live_orgs = m_world->GetPopulation().GetLiveOrgList();
     for (int i = 0; i < live_orgs.GetSize(); i++) {  
       cOrganism* org = live_orgs[i];
       const int id = org->GetID();
@@ -4749,7 +4948,7 @@ public:
     const int worldx = m_world->GetConfig().WORLD_X.Get();
     
     Apto::Array<int> neighborhood;
-    const Apto::Array <cOrganism*, Apto::Smart> live_orgs = m_world->GetPopulation().GetLiveOrgList();
+    const Apto::Array <cOrganism*, Apto::Smart>& live_orgs = m_world->GetPopulation().GetLiveOrgList();
     for (int i = 0; i < live_orgs.GetSize(); i++) {
       cOrganism* org = live_orgs[i];
       if (!org->IsPreyFT()) continue;
@@ -5136,6 +5335,57 @@ public:
 };
 
 
+// Lists each data value currently requested by a recorder, with the average time per update spent computing it,
+// followed by the on-demand statistics collectors that are enabled
+class cActionPrintDataActivity : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionPrintDataActivity(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  {
+    cString largs(args);
+    largs.Trim();
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    else m_filename = "data_activity.dat";
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string fname=\"data_activity.dat\"]"; }
+  
+  void Process(cAvidaContext&)
+  {
+    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+    df->WriteComment("Avida demand-driven data activity");
+    df->WriteComment("Provider cost is the average processor seconds per update, shared by all values of a provider");
+    df->WriteComment("(-1 when the value is not computed by an updated provider)");
+    df->WriteTimeStamp();
+    
+    const int update = m_world->GetStats().GetUpdate();
+    Data::ManagerPtr mgr = m_world->GetDataManager();
+    Data::ConstDataSetPtr requested = mgr->GetRequested();
+    for (Data::ConstDataSetIterator it = requested->Begin(); it.Next();) {
+      df->Write(update, "Update");
+      df->Write((const char*)*it.Get(), "Data ID");
+      df->Write(mgr->ProviderUpdateCost(*it.Get()), "Provider Cost");
+      df->Endl();
+    }
+    
+    cStats& stats = m_world->GetStats();
+    const char* collectors[] = { "stats.collect.env_test", "stats.collect.class_inst", "stats.collect.from_message_inst" };
+    const bool enabled[] = { stats.ShouldCollectEnvTestStats(), stats.ShouldCollectClassInstStats(),
+      stats.ShouldCollectFromMessageInstStats() };
+    for (int i = 0; i < 3; i++) {
+      if (!enabled[i]) continue;
+      df->Write(update, "Update");
+      df->Write(collectors[i], "Data ID");
+      df->Write(-1.0, "Provider Cost");
+      df->Endl();
+    }
+  }
+};
+
+
 //@CHC Mating type-related actions
 //Prints counts of the number of organisms of each mating type alive in the population
 class cActionPrintMatingTypeHistogram : public cAction
@@ -5391,9 +5641,12 @@ class cActionPrintDominantData : public cAction
 {
 private:
   cString m_filename;
+  int m_dom_id;       // dominant genotype of the last row, whose genome length is cached below
+  int m_dom_length;
   
 public:
-  cActionPrintDominantData(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("dominant.dat")
+  cActionPrintDominantData(cWorld* world, const cString& args, Feedback&)
+    : cAction(world, args), m_filename("dominant.dat"), m_dom_id(-1), m_dom_length(0)
   {
     cString largs(args);
     largs.Trim();
@@ -5416,25 +5669,30 @@ public:
     Systematics::GroupPtr bg = it->Next();
     if (!bg) return;
     
-    df->Write(bg->Properties().Get("ave_metabolic_rate").DoubleValue(),       "Average Merit of the Dominant Genotype");
-    df->Write(bg->Properties().Get("ave_gestation_time").DoubleValue(),   "Average Gestation Time of the Dominant Genotype");
-    df->Write(bg->Properties().Get("ave_fitness").DoubleValue(),     "Average Fitness of the Dominant Genotype");
-    df->Write(bg->Properties().Get("ave_repro_rate").DoubleValue(),  "Repro Rate?");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_METABOLIC_RATE),       "Average Merit of the Dominant Genotype");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_GESTATION_TIME),   "Average Gestation Time of the Dominant Genotype");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_FITNESS),     "Average Fitness of the Dominant Genotype");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_REPRO_RATE),  "Repro Rate?");
     
-    Genome gen(bg->Properties().Get("genome"));
-    InstructionSequencePtr seq;
-    seq.DynamicCastFrom(gen.Representation());
-    df->Write(seq->GetSize(),        "Size of Dominant Genotype");
-    df->Write(bg->Properties().Get("ave_copy_size").DoubleValue(), "Copied Size of Dominant Genotype");
-    df->Write(bg->Properties().Get("ave_exe_size").DoubleValue(), "Executed Size of Dominant Genotype");
+    // Genomes are fixed per genotype, only rebuild it when the dominant has changed
+    if (bg->ID() != m_dom_id) {
+      Genome gen(bg->StringProperty(Systematics::GROUP_PROP_GENOME));
+      InstructionSequencePtr seq;
+      seq.DynamicCastFrom(gen.Representation());
+      m_dom_id = bg->ID();
+      m_dom_length = seq->GetSize();
+    }
+    df->Write(m_dom_length,        "Size of Dominant Genotype");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_COPY_SIZE), "Copied Size of Dominant Genotype");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_AVE_EXE_SIZE), "Executed Size of Dominant Genotype");
     df->Write(bg->NumUnits(),   "Abundance of Dominant Genotype");
-    df->Write(bg->Properties().Get("last_births").IntValue(),      "Number of Births");
-    df->Write(bg->Properties().Get("last_breed_true").IntValue(),  "Number of Dominant Breed True?");
+    df->Write(bg->IntProperty(Systematics::GROUP_PROP_LAST_BIRTHS),      "Number of Births");
+    df->Write(bg->IntProperty(Systematics::GROUP_PROP_LAST_BREED_TRUE),  "Number of Dominant Breed True?");
     df->Write(bg->Depth(),  "Dominant Gene Depth");
-    df->Write(bg->Properties().Get("last_breed_in").IntValue(),    "Dominant Breed In");
-    df->Write(bg->Properties().Get("max_fitness").DoubleValue(),     "Max Fitness?");
+    df->Write(bg->IntProperty(Systematics::GROUP_PROP_LAST_BREED_IN),    "Dominant Breed In");
+    df->Write(bg->DoubleProperty(Systematics::GROUP_PROP_MAX_FITNESS),     "Max Fitness?");
     df->Write(bg->ID(), "Genotype ID of Dominant Genotype");
-    df->Write(bg->Properties().Get("name").StringValue(),        "Name of the Dominant Genotype");
+    df->Write(bg->StringProperty(Systematics::GROUP_PROP_NAME),        "Name of the Dominant Genotype");
     df->Endl();    
   }
 };
@@ -5447,10 +5705,12 @@ public:
 void RegisterPrintActions(cActionLibrary* action_lib)
 {
   action_lib->Register<cActionPrintDebug>("PrintDebug");
+  action_lib->Register<cActionPrintDataActivity>("PrintDataActivity");
   
   
   // Stats Out Files
   action_lib->Register<cActionPrintAverageData>("PrintAverageData");
+  action_lib->Register<cActionPrintSampleData>("PrintSampleData");
   action_lib->Register<cActionPrintDemeAverageData>("PrintDemeAverageData");
   action_lib->Register<cActionPrintFlowRateTuples>("PrintFlowRateTuples");
   action_lib->Register<cActionPrintErrorData>("PrintErrorData");
@@ -5462,6 +5722,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintInterruptData>("PrintInterruptData");
   action_lib->Register<cActionPrintTotalsData>("PrintTotalsData");
   action_lib->Register<cActionPrintThreadsData>("PrintThreadsData");
+  action_lib->Register<cActionPrintSpeculativeData>("PrintSpeculativeData");
   action_lib->Register<cActionPrintTasksData>("PrintTasksData");
   action_lib->Register<cActionPrintSoloTaskSnapshot>("PrintSoloTaskSnapshot");
   action_lib->Register<cActionPrintHostTasksData>("PrintHostTasksData");
@@ -5513,6 +5774,8 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintSenseData>("PrintSenseData");
   action_lib->Register<cActionPrintSenseExeData>("PrintSenseExeData");
   action_lib->Register<cActionPrintInstructionData>("PrintInstructionData");
+  action_lib->Register<cActionPrintInstProfileData>("PrintInstProfileData");
+  action_lib->Register<cActionExportLiveStats>("ExportLiveStats");
   action_lib->Register<cActionPrintInternalTasksData>("PrintInternalTasksData");
   action_lib->Register<cActionPrintInternalTasksQualData>("PrintInternalTasksQualData");
   action_lib->Register<cActionPrintSleepData>("PrintSleepData");
@@ -5616,6 +5879,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   
   action_lib->Register<cActionPrintMultiProcessData>("PrintMultiProcessData");
   action_lib->Register<cActionPrintProfilingData>("PrintProfilingData");
+  action_lib->Register<cActionPrintMemoryData>("PrintMemoryData");
   action_lib->Register<cActionPrintOrganismLocation>("PrintOrganismLocation");
   action_lib->Register<cActionPrintOrgLocData>("PrintOrgLocData");
   action_lib->Register<cActionPrintPreyFlockingData>("PrintPreyFlockingData");
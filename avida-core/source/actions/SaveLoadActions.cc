@@ -136,10 +136,12 @@ private:
   bool m_save_group_info;
   bool m_save_avatars;
   bool m_save_rebirth;
+  bool m_background;
   
 public:
   cActionSavePopulation(cWorld* world, const cString& args, Feedback& feedback)
     : cAction(world, args), m_filename(""), m_save_historic(true), m_save_group_info(false), m_save_avatars(false), m_save_rebirth(false)
+    , m_background(false)
   {
     cArgSchema schema(':','=');
     
@@ -151,6 +153,7 @@ public:
     schema.AddEntry("save_groups", 1, 0, 1, 0);
     schema.AddEntry("save_avatars", 2, 0, 1, 0);
     schema.AddEntry("save_rebirth", 3, 0, 1, 0);
+    schema.AddEntry("background", 4, 0, 1, 0);
 
     cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
     
@@ -160,18 +163,23 @@ public:
       m_save_group_info = argc->GetInt(1);
       m_save_avatars = argc->GetInt(2);
       m_save_rebirth = argc->GetInt(3);
+      m_background = argc->GetInt(4);
     }
     
     delete argc;
   }
   
-  static const cString GetDescription() { return "Arguments: [string filename='detail'] [boolean save_historic=1] [boolean save_groups=0] [boolean save_avatars=0] [boolean save_rebirth=0]"; }
+  static const cString GetDescription() { return "Arguments: [string filename='detail'] [boolean save_historic=1] [boolean save_groups=0] [boolean save_avatars=0] [boolean save_rebirth=0] [boolean background=0]"; }
   
   void Process(cAvidaContext&)
   {
     int update = m_world->GetStats().GetUpdate();
     cString filename = cStringUtil::Stringf("%s-%d.spop", (const char*)m_filename, update);
-    m_world->GetPopulation().SavePopulation(filename, m_save_historic, m_save_group_info, m_save_avatars, m_save_rebirth);
+    if (m_background) {
+      m_world->GetPopulation().SavePopulationInBackground(filename, m_save_historic, m_save_group_info, m_save_avatars, m_save_rebirth);
+    } else {
+      m_world->GetPopulation().SavePopulation(filename, m_save_historic, m_save_group_info, m_save_avatars, m_save_rebirth);
+    }
   }
 };
 
@@ -281,6 +289,49 @@ public:
   }
 };
 
+class cActionSaveCheckpoint : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionSaveCheckpoint(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("checkpoint.ckp")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string filename='checkpoint.ckp']"; }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    m_world->GetPopulation().SaveCheckpoint(m_filename, ctx);
+  }
+};
+
+class cActionLoadCheckpoint : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionLoadCheckpoint(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("checkpoint.ckp")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string filename='checkpoint.ckp']"; }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    if (!m_world->GetPopulation().LoadCheckpoint(m_filename, ctx)) {
+      m_world->GetDriver().Feedback().Error("failed to load checkpoint");
+      m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
+    }
+  }
+};
+
 void RegisterSaveLoadActions(cActionLibrary* action_lib)
 {
   action_lib->Register<cActionLoadParasiteGenotypeList>("LoadParasiteGenotypeList");
@@ -290,4 +341,6 @@ void RegisterSaveLoadActions(cActionLibrary* action_lib)
   action_lib->Register<cActionLoadStructuredSystematicsGroup>("LoadStructuredSystematicsGroup");
   action_lib->Register<cActionSaveStructuredSystematicsGroup>("SaveStructuredSystematicsGroup");
   action_lib->Register<cActionSaveFlameData>("SaveFlameData");
+  action_lib->Register<cActionSaveCheckpoint>("SaveCheckpoint");
+  action_lib->Register<cActionLoadCheckpoint>("LoadCheckpoint");
 }
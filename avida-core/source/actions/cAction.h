@@ -45,6 +45,13 @@ public:
   const cString& GetArgs() const { return m_args; }
   
   virtual void Process(cAvidaContext& ctx) = 0;
+  
+  // Actions that only read simulation state may split their work, gathering and computing their results in Prepare()
+  // and writing them in Process().  With PARALLEL_PRINT set, the event list runs Prepare() for read-only actions that
+  // fire together on the analyze threads, each with its own random stream, then calls Process() for each in event
+  // order on the simulation thread.  Otherwise only Process() is called, and must do the whole job.
+  virtual bool IsReadOnly() const { return false; }
+  virtual void Prepare(cAvidaContext&) { ; }
 };
 
 #endif
@@ -31,6 +31,8 @@
 
 #include "avida/private/util/GenomeLoader.h"
 
+#include "apto/core/FileSystem.h"
+#include "apto/platform.h"
 #include "apto/rng.h"
 #include "apto/scheduler.h"
 
@@ -48,9 +50,12 @@
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
+#include "cFile.h"
+#include "cGenotypeColumns.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
+#include "cHardwareTraceRecorder.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
 #include "cLandscape.h"
@@ -858,8 +863,251 @@ void cAnalyze::LoadFile(cString cur_string)
 }
 
 
+// A block of raw genotype file lines, parsed into genotypes independently of every other block
+class cAnalyzeStreamChunk
+{
+private:
+  cWorld* m_world;
+  tList< tDataEntryCommand<cAnalyzeGenotype> >& m_format;
+  const Genome& m_default_genome;
+  Apto::Array<cString> m_lines;
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  
+public:
+  cAnalyzeStreamChunk(cWorld* world, tList< tDataEntryCommand<cAnalyzeGenotype> >& format, const Genome& default_genome)
+    : m_world(world), m_format(format), m_default_genome(default_genome) { ; }
+  
+  Apto::Array<cString>& Lines() { return m_lines; }
+  Apto::Array<cAnalyzeGenotype*>& Genotypes() { return m_genotypes; }
+  
+  void Parse(cAvidaContext&)
+  {
+    m_genotypes.Resize(m_lines.GetSize());
+    tListIterator< tDataEntryCommand<cAnalyzeGenotype> > format_it(m_format);
+    for (int i = 0; i < m_lines.GetSize(); i++) {
+      cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, m_default_genome);
+      format_it.Reset();
+      tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
+      while ((data_command = format_it.Next()) != NULL) data_command->SetValue(genotype, m_lines[i].PopWord());
+      m_genotypes[i] = genotype;
+    }
+    m_lines.Resize(0);
+  }
+};
+
+
+void cAnalyze::LoadFileStream(cString cur_string)
+{
+  // LOAD_STREAM [filename] [stat relation value]...
+  
+  const int CHUNK_LINES = 1024;
+  
+  cString filename = cur_string.PopWord();
+  
+  // Collect the filters that each record must pass to be kept
+  tList< tDataEntryCommand<cAnalyzeGenotype> > filter_list;
+  Apto::Array<cString> filter_values;
+  Apto::Array<Apto::Array<bool> > filter_rels;
+  bool error_found = (cur_string.CountNumWords() % 3) != 0;
+  while (!error_found && cur_string.CountNumWords() >= 3) {
+    cString stat_name = cur_string.PopWord();
+    cString relation = cur_string.PopWord();
+    filter_values.Push(cur_string.PopWord());
+    
+    tDataEntryCommand<cAnalyzeGenotype>* stat_command = cAnalyzeGenotype::GetDataCommandManager().GetDataCommand(stat_name);
+    if (stat_command == NULL) {
+      cerr << "Error: Unknown stat '" << stat_name << "'" << endl;
+      error_found = true;
+    } else {
+      filter_list.PushRear(stat_command);
+    }
+    
+    Apto::Array<bool> rel_ok;
+    if (!ParseFilterRelation(relation, rel_ok)) error_found = true;
+    filter_rels.Push(rel_ok);
+  }
+  
+  if (error_found) {
+    cerr << "Format: LOAD_STREAM [filename] [stat relation value]..." << endl;
+    cerr << "Example: LOAD_STREAM detail-1000.spop fitness >= 10.0 num_cpus > 1" << endl;
+    while (filter_list.GetSize()) delete filter_list.Pop();
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  cout << "Streaming: " << filename << endl;
+  
+  cFile input_file(cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(m_world->GetWorkingDir()))));
+  if (!input_file.IsOpen()) {
+    cerr << "error: unable to open file '" << filename << "'." << endl;
+    while (filter_list.GetSize()) delete filter_list.Pop();
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  // Setup the genome...
+  const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
+  HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
+  Genome default_genome(is.GetHardwareType(), props, GeneticRepresentationPtr(new InstructionSequence(1)));
+  
+  // Chunks are parsed on the analyze threads when PARALLEL_ANALYZE is set, so keep enough of them in flight to
+  // occupy every worker.  Memory use is bounded by the chunks in flight plus the records that survive filtering.
+  const bool parallel = m_world->GetConfig().PARALLEL_ANALYZE.Get();
+  const int chunks_per_round = parallel ? 2 * Apto::Platform::AvailableCPUs() : 1;
+  
+  tList< tDataEntryCommand<cAnalyzeGenotype> > output_list;
+  cString filetype("unknown");
+  cStringList format;
+  bool id_inc = false;
+  bool format_ready = false;
+  int load_count = 0;
+  int kept_count = 0;
+  
+  Apto::Array<cAnalyzeStreamChunk*> chunks;
+  cString cur_line;
+  bool eof = false;
+  while (!eof) {
+    // Fill up this round's chunks with data lines, processing any header directives encountered along the way
+    while (!eof && (chunks.GetSize() < chunks_per_round || chunks[chunks.GetSize() - 1]->Lines().GetSize() < CHUNK_LINES)) {
+      if (input_file.Eof() || !input_file.ReadLine(cur_line)) {
+        eof = true;
+        break;
+      }
+      
+      if (cur_line.GetSize() && cur_line[0] == '#') {
+        cString directive = cur_line.PopWord();
+        if (directive == "#filetype") filetype = cur_line.PopWord();
+        else if (directive == "#format" && format.GetSize() == 0) format.Load(cur_line);
+        continue;
+      }
+      
+      int comment_pos = cur_line.Find('#');
+      if (comment_pos >= 0) cur_line.Clip(comment_pos);
+      cur_line.CompressWhitespace();
+      if (cur_line.GetSize() == 0) continue;
+      
+      // The header must be complete by the time the first record is seen
+      if (!format_ready) {
+        if (filetype != "population_data" &&  // Deprecated
+            filetype != "genotype_data") {
+          cerr << "error: cannot load files of type \"" << filetype << "\"." << endl;
+          error_found = true;
+          break;
+        }
+        
+        cUserFeedback feedback;
+        cAnalyzeGenotype::GetDataCommandManager().LoadCommandList(format, output_list, &feedback);
+        for (int i = 0; i < feedback.GetNumMessages(); i++) {
+          switch (feedback.GetMessageType(i)) {
+            case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+            case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+            default: break;
+          };
+          cerr << feedback.GetMessage(i) << endl;
+        }
+        if (feedback.GetNumErrors()) {
+          error_found = true;
+          break;
+        }
+        
+        id_inc = format.HasString("id");
+        format_ready = true;
+      }
+      
+      if (chunks.GetSize() == 0 || chunks[chunks.GetSize() - 1]->Lines().GetSize() >= CHUNK_LINES) {
+        chunks.Push(new cAnalyzeStreamChunk(m_world, output_list, default_genome));
+      }
+      chunks[chunks.GetSize() - 1]->Lines().Push(cur_line);
+    }
+    
+    if (error_found) break;
+    
+    // Parse this round's chunks
+    if (parallel) {
+      tAnalyzeJobBatch<cAnalyzeStreamChunk> jobbatch(m_jobqueue);
+      for (int i = 0; i < chunks.GetSize(); i++) jobbatch.AddJob(chunks[i], &cAnalyzeStreamChunk::Parse);
+      jobbatch.RunBatch();
+    } else {
+      for (int i = 0; i < chunks.GetSize(); i++) chunks[i]->Parse(m_ctx);
+    }
+    
+    // Name, filter and keep the parsed records in file order
+    for (int i = 0; i < chunks.GetSize(); i++) {
+      Apto::Array<cAnalyzeGenotype*>& genotypes = chunks[i]->Genotypes();
+      for (int j = 0; j < genotypes.GetSize(); j++) {
+        cAnalyzeGenotype* genotype = genotypes[j];
+        
+        // Give this genotype a name.  Base it on the ID if possible.
+        if (id_inc == false) {
+          cString name = cStringUtil::Stringf("org-%d", load_count);
+          genotype->SetName(name);
+        }
+        else {
+          cString name = cStringUtil::Stringf("org-%d", genotype->GetID());
+          genotype->SetName(name);
+        }
+        load_count++;
+        
+        bool keep = true;
+        tListIterator< tDataEntryCommand<cAnalyzeGenotype> > filter_it(filter_list);
+        for (int f = 0; keep && filter_it.Next() != NULL; f++) {
+          int compare = 1 + CompareFlexStat(filter_it.Get()->GetValue(genotype), filter_values[f]);
+          keep = filter_rels[f][compare];
+        }
+        
+        if (keep) {
+          batch[cur_batch].List().PushRear(genotype);
+          kept_count++;
+        } else {
+          delete genotype;
+        }
+      }
+      delete chunks[i];
+    }
+    chunks.Resize(0);
+  }
+  
+  for (int i = 0; i < chunks.GetSize(); i++) delete chunks[i];
+  while (filter_list.GetSize()) delete filter_list.Pop();
+  while (output_list.GetSize()) delete output_list.Pop();
+  input_file.Close();
+  
+  if (error_found) {
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "  Kept " << kept_count << " of " << load_count << " genotypes." << endl;
+  }
+  
+  // Adjust the flags on this batch
+  batch[cur_batch].SetLineage(false);
+  batch[cur_batch].SetAligned(false);
+}
+
+
 //////////////// Reduction....
 
+bool cAnalyze::ParseFilterRelation(const cString& relation, Apto::Array<bool>& rel_ok)
+{
+  // Check relationship types.  rel_ok[0] = less_ok; rel_ok[1] = same_ok; rel_ok[2] = gtr_ok
+  rel_ok.Resize(3);
+  rel_ok.SetAll(false);
+  if (relation == "==")      {                    rel_ok[1] = true;                    }
+  else if (relation == "!=") { rel_ok[0] = true;                     rel_ok[2] = true; }
+  else if (relation == "<")  { rel_ok[0] = true;                                       }
+  else if (relation == ">")  {                                       rel_ok[2] = true; }
+  else if (relation == "<=") { rel_ok[0] = true;  rel_ok[1] = true;                    }
+  else if (relation == ">=") {                    rel_ok[1] = true;  rel_ok[2] = true; }
+  else {
+    cerr << "Error: Unknown relation '" << relation << "'" << endl;
+    return false;
+  }
+  return true;
+}
+
 void cAnalyze::CommandFilter(cString cur_string)
 {
   // First three arguments are: setting, relation, comparison
@@ -886,18 +1134,8 @@ void cAnalyze::CommandFilter(cString cur_string)
     error_found = true;
   }
   
-  // Check relationship types.  rel_ok[0] = less_ok; rel_ok[1] = same_ok; rel_ok[2] = gtr_ok
-  Apto::Array<bool> rel_ok(3); rel_ok.SetAll(false);
-  if (relation == "==")      {                    rel_ok[1] = true;                    }
-  else if (relation == "!=") { rel_ok[0] = true;                     rel_ok[2] = true; }
-  else if (relation == "<")  { rel_ok[0] = true;                                       }
-  else if (relation == ">")  {                                       rel_ok[2] = true; }
-  else if (relation == "<=") { rel_ok[0] = true;  rel_ok[1] = true;                    }
-  else if (relation == ">=") {                    rel_ok[1] = true;  rel_ok[2] = true; }
-  else {
-    cerr << "Error: Unknown relation '" << relation << "'" << endl;
-    error_found = true;
-  }
+  Apto::Array<bool> rel_ok;
+  if (!ParseFilterRelation(relation, rel_ok)) error_found = true;
   
   if (error_found == true) {
     cerr << "Format: FILTER [stat] [relation] [value] [batch=current]" << endl;
@@ -916,6 +1154,15 @@ void cAnalyze::CommandFilter(cString cur_string)
   }
   
   
+  // Compacted batches are filtered directly on their columns when the stat is stored as one.
+  cGenotypeColumns* columns = batch[cur_batch].GetColumns();
+  if (columns && columns->Filter(stat_name, rel_ok, test_value)) {
+    delete stat_command;
+    batch[cur_batch].SetLineage(false);
+    batch[cur_batch].SetAligned(false);
+    return;
+  }
+  
   // Loop through the genotypes and remove the entries that don't match.
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * cur_genotype = NULL;
@@ -1071,33 +1318,29 @@ void cAnalyze::FindLineage(cString cur_string)
   // Otherwise, trace back through the id numbers to mark all of those
   // in the ancestral lineage...
   
-  // Construct a list of genotypes found...
+  // Construct a list of genotypes found, each parent is a single lookup in the batch's ID index...
   
   tListPlus<cAnalyzeGenotype> found_list;
+  Apto::Set<cAnalyzeGenotype*> lineage;
   found_list.Push(found_gen);
-  int next_id = found_gen->GetParentID();
-  bool found = true;
-  while (found == true) {
-    found = false;
-    
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      if (found_gen->GetID() == next_id) {
-        batch_it.Remove();
-        found_list.Push(found_gen);
-        next_id = found_gen->GetParentID();
-        found = true;
-        break;
-      }
-    }
+  found_gen = batch[cur_batch].GetGenotypeWithID(found_gen->GetParentID());
+  while (found_gen != NULL && !lineage.Has(found_gen)) {
+    lineage.Insert(found_gen);
+    found_list.Push(found_gen);
+    found_gen = batch[cur_batch].GetGenotypeWithID(found_gen->GetParentID());
   }
   
   // We now have all of the genotypes in this lineage, delete everything
   // else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  int total_removed = 0;
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  while ((found_gen = batch_it.Next()) != NULL) {
+    batch_it.Remove();
+    if (!lineage.Has(found_gen)) {
+      delete found_gen;
+      total_removed++;
+    }
   }
   
   // And fill it back in with the good stuff.
@@ -1294,12 +1537,11 @@ void cAnalyze::FindClade(cString cur_string)
     return;
   }
   
-  // Do this the brute force way... scan for one step at a time.
-  
-  // Construct a list of genotypes found...
+  // Construct a list of genotypes found, walking down the batch's parent->children index...
   
   tListPlus<cAnalyzeGenotype> found_list; // Found and finished.
   tListPlus<cAnalyzeGenotype> scan_list;  // Found, but need to scan for children.
+  Apto::Set<cAnalyzeGenotype*> clade;
   scan_list.Push(found_gen);
   
   // Keep going as long as there is something in the scan list...
@@ -1309,22 +1551,25 @@ void cAnalyze::FindClade(cString cur_string)
     int parent_id = found_gen->GetID();
     found_list.Push(found_gen);
     
-    // Seach for all of the children of this genotype...
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      // If we found a child, place it into the scan list.
-      if (found_gen->GetParentID() == parent_id) {
-        batch_it.Remove();
-        scan_list.Push(found_gen);
-      }
+    // Place all of the children of this genotype into the scan list.
+    const Apto::Array<cAnalyzeGenotype*, Apto::Smart>* children = batch[cur_batch].GetChildrenOf(parent_id);
+    for (int i = 0; children && i < children->GetSize(); i++) {
+      if (clade.Has((*children)[i])) continue;
+      clade.Insert((*children)[i]);
+      scan_list.Push((*children)[i]);
     }
   }
   
   // We now have all of the genotypes in this clade, delete everything else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  int total_removed = 0;
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  while ((found_gen = batch_it.Next()) != NULL) {
+    batch_it.Remove();
+    if (!clade.Has(found_gen)) {
+      delete found_gen;
+      total_removed++;
+    }
   }
   
   // And fill it back in with the good stuff.
@@ -1361,14 +1606,8 @@ void cAnalyze::FindLastCommonAncestor(cString)
   tListIterator<cAnalyzeGenotype> child_it(batch[cur_batch].List());
   cAnalyzeGenotype * on_child = NULL;
   while ((on_child = child_it.Next()) != NULL) {
-    tListIterator<cAnalyzeGenotype> parent_it(batch[cur_batch].List());
-    cAnalyzeGenotype * on_parent = NULL;
-    while ((on_parent = parent_it.Next()) != NULL) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
+    cAnalyzeGenotype * on_parent = batch[cur_batch].GetGenotypeWithID(on_child->GetParentID());
+    if (on_parent != NULL) on_child->LinkParent(on_parent);
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -1812,6 +2051,33 @@ void cAnalyze::CommandTrace(cString cur_string)
 }
 
 
+// Converts a binary trace recording (BINARY_TRACES) into the text trace layout
+void cAnalyze::CommandDecodeTrace(cString cur_string)
+{
+  if (cur_string.GetSize() == 0) {
+    cerr << "Error: DECODE_TRACE must be given the trace recording to decode." << endl;
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  cString in_filename = cur_string.PopWord();
+  cString out_filename = in_filename + ".txt";
+  if (cur_string.GetSize() != 0) out_filename = cur_string.PopWord();
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "Decoding " << in_filename << " to " << out_filename << endl;
+  else cout << "Decoding trace..." << endl;
+  
+  Avida::Output::ManagerPtr mgr = Avida::Output::Manager::Of(m_world->GetNewWorld());
+  cString in_path((const char*)mgr->OutputIDFromPath((const char*)in_filename));
+  
+  Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)out_filename);
+  if (!df || !cHardwareTraceRecorder::Decode(in_path, df->OFStream())) {
+    cerr << "Error: unable to decode trace recording '" << in_filename << "'." << endl;
+    if (exit_on_error) exit(1);
+  }
+}
+
+
 void cAnalyze::CommandPrintTasks(cString cur_string)
 {
   if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "Printing tasks in batch " << cur_batch << endl;
@@ -1883,6 +2149,9 @@ void cAnalyze::CommandDetail(cString cur_string)
   if (filename == "cout") {
     CommandDetail_Header(cout, file_type, output_it);
     CommandDetail_Body(cout, file_type, output_it);
+  } else if (file_extension == "bdat") {
+    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
+    CommandDetail_Columns(*df, output_it);
   } else {
     Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
     ofstream& fp = df->OFStream();
@@ -1996,6 +2265,19 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
                                   tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it,
                                   int time_step, int max_time)
 {
+  // Resolve the column list once, rather than walking it for every genotype
+  Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*> columns;
+  output_it.Reset();
+  while (output_it.Next() != NULL) columns.Push(output_it.Get());
+  const int num_cols = columns.GetSize();
+  
+  // HTML rows are colored against the previous genotype, whose values are kept from the row that printed it
+  Apto::Array<cFlexVar> row_values[2];
+  row_values[0].Resize(num_cols);
+  row_values[1].Resize(num_cols);
+  int cur_row = 0;
+  cAnalyzeGenotype* last_genotype = NULL;
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * cur_genotype = batch_it.Next();
@@ -2009,7 +2291,6 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
       << " at depth " << cur_genotype->GetDepth()
       << endl;
     }
-    output_it.Reset();
     if (format_type == FILE_TYPE_HTML) {
       fp << "<tr>";
       if (time_step > 0) fp << "<td>" << cur_time << " ";
@@ -2018,22 +2299,26 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
       fp << cur_time << " ";
     }
     
-    tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
-    while ((data_command = output_it.Next()) != NULL) {
-      cFlexVar cur_value = data_command->GetValue(cur_genotype);
-      if (format_type == FILE_TYPE_HTML) {
+    if (format_type == FILE_TYPE_HTML) {
+      Apto::Array<cFlexVar>& cur_values = row_values[cur_row];
+      const Apto::Array<cFlexVar>& last_values = row_values[1 - cur_row];
+      for (int col = 0; col < num_cols; col++) {
+        tDataEntryCommand<cAnalyzeGenotype>* data_command = columns[col];
+        cur_values[col] = data_command->GetValue(cur_genotype);
         int compare = 0;
         if (prev_genotype) {
-          cFlexVar prev_value = data_command->GetValue(prev_genotype);
+          cFlexVar prev_value = (prev_genotype == last_genotype) ? last_values[col] : data_command->GetValue(prev_genotype);
           int compare_type = data_command->GetCompareType();
-          compare = CompareFlexStat(cur_value, prev_value, compare_type);
+          compare = CompareFlexStat(cur_values[col], prev_value, compare_type);
         }
-        HTMLPrintStat(cur_value, fp, compare, data_command->GetHtmlCellFlags(), data_command->GetNull());
-      }
-      else {  // if (format_type == FILE_TYPE_TEXT) {
-        fp << data_command->GetValue(cur_genotype) << " ";
-      }
+        HTMLPrintStat(cur_values[col], fp, compare, data_command->GetHtmlCellFlags(), data_command->GetNull());
       }
+      last_genotype = cur_genotype;
+      cur_row = 1 - cur_row;
+    }
+    else {  // if (format_type == FILE_TYPE_TEXT) {
+      for (int col = 0; col < num_cols; col++) fp << columns[col]->GetValue(cur_genotype) << " ";
+    }
     if (format_type == FILE_TYPE_HTML) fp << "</tr>";
     fp << endl;
     
@@ -2061,6 +2346,44 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
   }
   }
 
+
+void cAnalyze::CommandDetail_Columns(Avida::Output::File& df, tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it)
+{
+  // Binary columnar detail dump (*.bdat); the column schema is taken from the value types of the first genotype
+  Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*> columns;
+  Apto::Array<cString> descs;
+  cAnalyzeGenotype* first_genotype = batch[cur_batch].List().GetFirst();
+  output_it.Reset();
+  while (output_it.Next() != NULL) {
+    columns.Push(output_it.Get());
+    descs.Push(output_it.Get()->GetDesc(first_genotype));
+  }
+  
+  df.SetFileType("genotype_data");
+  
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  cAnalyzeGenotype* cur_genotype = NULL;
+  while ((cur_genotype = batch_it.Next()) != NULL) {
+    for (int col = 0; col < columns.GetSize(); col++) {
+      const cFlexVar value = columns[col]->GetValue(cur_genotype);
+      const char* name = columns[col]->GetName();
+      switch (value.GetType()) {
+        case cFlexVar::TYPE_INT:
+        case cFlexVar::TYPE_BOOL:
+          df.Write(value.AsInt(), (const char*)descs[col], name);
+          break;
+        case cFlexVar::TYPE_DOUBLE:
+          df.Write(value.AsDouble(), (const char*)descs[col], name);
+          break;
+        default:
+          df.Write((const char*)value.AsString(), (const char*)descs[col], name);
+          break;
+      }
+    }
+    df.Endl();
+  }
+}
+
 void cAnalyze::CommandDetailAverage_Body(ostream& fp, int nucoutputs,
                                          tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it)
 {
@@ -2418,11 +2741,29 @@ void cAnalyze::CommandHistogram_Header(ostream& fp, int format_type,
 void cAnalyze::CommandHistogram_Body(ostream& fp, int format_type,
                                      tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it)
 {
+  Apto::Array<tDataEntryCommand<cAnalyzeGenotype>*> columns;
   output_it.Reset();
-  tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
+  while (output_it.Next() != NULL) columns.Push(output_it.Get());
   cAnalyzeGenotype* first_genotype = batch[cur_batch].List().GetFirst();
   
-  while ((data_command = output_it.Next()) != NULL) {
+  // Collect the counts for every column in a single pass through the genotypes in this batch
+  Apto::Array<Apto::Map<Apto::String, int> > count_dicts(columns.GetSize());
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  cAnalyzeGenotype * cur_genotype;
+  while ((cur_genotype = batch_it.Next()) != NULL) {
+    for (int col = 0; col < columns.GetSize(); col++) {
+      const Apto::String cur_name((const char*)columns[col]->GetValue(cur_genotype).AsString());
+      int count = 0;
+      count_dicts[col].Get(cur_name, count);
+      count += cur_genotype->GetNumCPUs();
+      count_dicts[col].Set(cur_name, count);
+    }
+  }
+  
+  for (int col = 0; col < columns.GetSize(); col++) {
+    tDataEntryCommand<cAnalyzeGenotype>* data_command = columns[col];
+    Apto::Map<Apto::String, int>& count_dict = count_dicts[col];
+    
     if (format_type == FILE_TYPE_TEXT) {
       fp << "# --- " << data_command->GetDesc(first_genotype) << " ---" << endl;
     } else {
@@ -2431,19 +2772,6 @@ void cAnalyze::CommandHistogram_Body(ostream& fp, int format_type,
       << data_command->GetDesc(first_genotype) << "</th></tr>" << endl;
     }
     
-    Apto::Map<Apto::String, int> count_dict;
-    
-    // Loop through all genotypes in this batch to collect the info we need.
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    cAnalyzeGenotype * cur_genotype;
-    while ((cur_genotype = batch_it.Next()) != NULL) {
-      const Apto::String cur_name((const char*)data_command->GetValue(cur_genotype).AsString());
-      int count = 0;
-      count_dict.Get(cur_name, count);
-      count += cur_genotype->GetNumCPUs();
-      count_dict.Set(cur_name, count);
-    }
-        
     // Figure out the maximum count and the maximum widths...
     int max_count = 0;
     int max_name_width = 0;
@@ -2747,6 +3075,95 @@ void cAnalyze::CommandPrintDiversity(cString cur_string)
 }
 
 
+// The single site mutants of a genome at one line, each tested on the test CPU with this job's own copy of the test info
+class cAnalyzeSiteMutants
+{
+private:
+  cWorld* m_world;
+  const Genome& m_base_genome;
+  int m_line;
+  const Apto::Array<int>& m_ops;
+  cCPUTestInfo m_test_info;
+  Apto::Array<double>* m_fitness;
+  Apto::Array<cAnalyzeGenotype*>* m_mutants;  // kept for callers that need more than fitness
+  
+public:
+  cAnalyzeSiteMutants(cWorld* world, const Genome& base_genome, int line, const Apto::Array<int>& ops,
+                      const cCPUTestInfo& test_info, Apto::Array<double>& fitness)
+    : m_world(world), m_base_genome(base_genome), m_line(line), m_ops(ops), m_test_info(test_info)
+    , m_fitness(&fitness), m_mutants(NULL) { ; }
+  cAnalyzeSiteMutants(cWorld* world, const Genome& base_genome, int line, const Apto::Array<int>& ops,
+                      const cCPUTestInfo& test_info, Apto::Array<cAnalyzeGenotype*>& mutants)
+    : m_world(world), m_base_genome(base_genome), m_line(line), m_ops(ops), m_test_info(test_info)
+    , m_fitness(NULL), m_mutants(&mutants) { ; }
+  
+  void Test(cAvidaContext& ctx)
+  {
+    Genome mod_genome(m_base_genome);
+    InstructionSequencePtr mod_seq_p;
+    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+    mod_seq_p.DynamicCastFrom(mod_rep_p);
+    InstructionSequence& mod_seq = *mod_seq_p;
+    
+    if (m_fitness) m_fitness->Resize(m_ops.GetSize());
+    if (m_mutants) m_mutants->Resize(m_ops.GetSize());
+    for (int i = 0; i < m_ops.GetSize(); i++) {
+      mod_seq[m_line].SetOp(m_ops[i]);
+      if (m_mutants) {
+        cAnalyzeGenotype* test_genotype = new cAnalyzeGenotype(m_world, mod_genome);
+        test_genotype->Recalculate(ctx, &m_test_info);
+        (*m_mutants)[i] = test_genotype;
+      } else {
+        cAnalyzeGenotype test_genotype(m_world, mod_genome);
+        test_genotype.Recalculate(ctx, &m_test_info);
+        (*m_fitness)[i] = test_genotype.GetFitness();
+      }
+    }
+  }
+};
+
+
+void cAnalyze::TestSiteMutants(const Genome& base_genome, const cCPUTestInfo& test_info,
+                               const Apto::Array<Apto::Array<int> >& site_ops, Apto::Array<Apto::Array<double> >& fitness)
+{
+  fitness.Resize(site_ops.GetSize());
+  
+  Apto::Array<cAnalyzeSiteMutants*> sites(site_ops.GetSize());
+  for (int line = 0; line < site_ops.GetSize(); line++) {
+    sites[line] = new cAnalyzeSiteMutants(m_world, base_genome, line, site_ops[line], test_info, fitness[line]);
+  }
+  RunSiteMutants(sites);
+}
+
+
+void cAnalyze::TestSiteMutants(const Genome& base_genome, const cCPUTestInfo& test_info,
+                               const Apto::Array<Apto::Array<int> >& site_ops,
+                               Apto::Array<Apto::Array<cAnalyzeGenotype*> >& mutants)
+{
+  mutants.Resize(site_ops.GetSize());
+  
+  Apto::Array<cAnalyzeSiteMutants*> sites(site_ops.GetSize());
+  for (int line = 0; line < site_ops.GetSize(); line++) {
+    sites[line] = new cAnalyzeSiteMutants(m_world, base_genome, line, site_ops[line], test_info, mutants[line]);
+  }
+  RunSiteMutants(sites);
+}
+
+
+void cAnalyze::RunSiteMutants(Apto::Array<cAnalyzeSiteMutants*>& sites)
+{
+  if (m_world->GetConfig().PARALLEL_ANALYZE.Get()) {
+    tAnalyzeJobBatch<cAnalyzeSiteMutants> jobbatch(m_jobqueue);
+    for (int line = 0; line < sites.GetSize(); line++) jobbatch.AddJob(sites[line], &cAnalyzeSiteMutants::Test);
+    jobbatch.RunBatch();
+  } else {
+    for (int line = 0; line < sites.GetSize(); line++) sites[line]->Test(m_ctx);
+  }
+  
+  for (int line = 0; line < sites.GetSize(); line++) delete sites[line];
+}
+
+
 void cAnalyze::PhyloCommunityComplexity(cString cur_string)
 {
   /////////////////////////////////////////////////////////////////////////
@@ -2983,22 +3400,15 @@ void cAnalyze::PhyloCommunityComplexity(cString cur_string)
       given_seq_p.DynamicCastFrom(given_rep_p);
       const InstructionSequence& given_seq = *given_seq_p;
       
-      Genome mod_genome(base_genome);
-      InstructionSequencePtr mod_seq_p;
-      GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-      mod_seq_p.DynamicCastFrom(mod_rep_p);
-      InstructionSequence& mod_seq = *mod_seq_p;
+      Apto::Array<Apto::Array<int> > given_ops(length_genome);
+      for (int line = 0; line < length_genome; ++ line) given_ops[line].Push(given_seq[line].GetOp());
+      Apto::Array<Apto::Array<double> > given_fitness;
+      TestSiteMutants(base_genome, test_info, given_ops, given_fitness);
       
       for (int line = 0; line < length_genome; ++ line) {
-        int given_inst = given_seq[line].GetOp();
-        mod_genome = base_genome;
-        mod_seq[line].SetOp(given_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx, &test_info);
-        
         // Only when given inst make the genotype alive
-        if (test_genotype.GetFitness() > 0) {
-          prob[line][given_inst] += pow(1 - 1.0/length_genome, min_depth_dist);
+        if (given_fitness[line][0] > 0) {
+          prob[line][given_ops[line][0]] += pow(1 - 1.0/length_genome, min_depth_dist);
         }
       }
       
@@ -3023,33 +3433,23 @@ void cAnalyze::PhyloCommunityComplexity(cString cur_string)
     double base_fitness = genotype->GetFitness();
     cout << base_fitness << endl;
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr base_rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(base_rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
+    Apto::Array<Apto::Array<int> > mut_ops(length_genome);
+    for (int line = 0; line < length_genome; ++ line) {
+      for (int mod_inst = 0; mod_inst < num_insts; ++ mod_inst) mut_ops[line].Push(mod_inst);
+    }
+    Apto::Array<Apto::Array<double> > mut_fitness;
+    TestSiteMutants(base_genome, test_info, mut_ops, mut_fitness);
     
     for (int line = 0; line < length_genome; ++ line) {
-      int cur_inst = base_seq[line].GetOp();
-      
       for (int mod_inst = 0; mod_inst < num_insts; ++ mod_inst) {
-        mod_seq[line].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx, &test_info);
-        if (test_genotype.GetFitness() >= base_fitness) {
+        if (mut_fitness[line][mod_inst] >= base_fitness) {
           neutral_mut[line][mod_inst] = true;
         } 
-        if (test_genotype.GetFitness() > 0) {
+        if (mut_fitness[line][mod_inst] > 0) {
           alive_mut[line][mod_inst] = true;
         }
       }
-      
-      mod_seq[line].SetOp(cur_inst);
     }
     
     
@@ -3514,6 +3914,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
   // Test point mutation of each genotype in community
   
   map<int, tMatrix<double> > point_mut; 
+  map<int, vector<double> > site_entropy;
   int size_community = community.size();
   int length_genome = 0;
   if (size_community > 1) {
@@ -3530,32 +3931,24 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
     genotype->Recalculate(m_ctx, &test_info);
     
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
-    
     const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
     double base_fitness = genotype->GetFitness();
+    
+    Apto::Array<Apto::Array<int> > mut_ops(length_genome);
+    for (int line = 0; line < length_genome; ++ line) {
+      for (int mod_inst = 0; mod_inst < num_insts; ++ mod_inst) mut_ops[line].Push(mod_inst);
+    }
+    Apto::Array<Apto::Array<double> > mut_fitness;
+    TestSiteMutants(base_genome, test_info, mut_ops, mut_fitness);
 
     tMatrix<double> prob(length_genome, num_insts);
-    
+    vector<double> entropy(length_genome, 0.0);
     
     for (int line = 0; line < length_genome; ++ line) {
-      int cur_inst = base_seq[line].GetOp();
       int num_neutral = 0;
       
       for (int mod_inst = 0; mod_inst < num_insts; ++ mod_inst) {
-        seq[line].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx, &test_info);
-        if (test_genotype.GetFitness() >= base_fitness) {
+        if (mut_fitness[line][mod_inst] >= base_fitness) {
           prob[line][mod_inst] = 1.0;
           num_neutral ++;
         } else {
@@ -3567,11 +3960,16 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
         prob[line][mod_inst] /= num_neutral;
       }
       
-      
-      seq[line].SetOp(cur_inst);
+      // Every pairing below needs the entropy of each site, so it is worked out once per genotype
+      for (int mod_inst = 0; mod_inst < num_insts; ++ mod_inst) {
+        if (prob[line][mod_inst] > 0) {
+          entropy[line] -= prob[line][mod_inst] * (log(prob[line][mod_inst]) / log(1.0*num_insts));
+        }
+      }
     }
     
     point_mut.insert(make_pair(genotype->GetID(), prob));
+    site_entropy.insert(make_pair(genotype->GetID(), entropy));
   }
   
   //////////////////////////////////////
@@ -3587,18 +3985,11 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
   genotype = community[0];
   double oo_initial_entropy = length_genome;
   double oo_conditional_entropy = 0.0;
-  tMatrix<double> this_prob = point_mut.find(genotype->GetID())->second;
   const Genome& cur_genome = genotype->GetGenome();
   const int num_insts = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue()).GetSize();
+  const vector<double>& first_entropy = site_entropy.find(genotype->GetID())->second;
   for (int line = 0; line < length_genome; ++ line) {
-    double oneline_entropy = 0.0;
-    for (int inst = 0; inst < num_insts; ++ inst) {
-      if (this_prob[line][inst] > 0) {
-        oneline_entropy -= this_prob[line][inst] * (log(this_prob[line][inst]) /
-                                                    log(1.0*num_insts));
-      }
-    }
-    oo_conditional_entropy += oneline_entropy;
+    oo_conditional_entropy += first_entropy[line];
   }
   
   double new_info = oo_initial_entropy - oo_conditional_entropy;
@@ -3639,12 +4030,14 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
     double oo_initial_entropy = 0.0;
     double oo_conditional_entropy = 0.0;
     cAnalyzeGenotype* used_genotype = NULL;
-    tMatrix<double> this_prob = point_mut.find(genotype->GetID())->second;
+    const tMatrix<double>& this_prob = point_mut.find(genotype->GetID())->second;
+    const vector<double>& this_entropy = site_entropy.find(genotype->GetID())->second;
     
     // For any given genotype, calculate the new information in genotype
     for (unsigned int j = 0; j < given_genotypes.size(); ++ j) {
       
-      tMatrix<double> given_prob = point_mut.find(given_genotypes[j]->GetID())->second;
+      const tMatrix<double>& given_prob = point_mut.find(given_genotypes[j]->GetID())->second;
+      const vector<double>& given_entropy = site_entropy.find(given_genotypes[j]->GetID())->second;
       double new_info = 0.0;
       double total_initial_entropy = 0.0;
       double total_conditional_entropy = 0.0;
@@ -3661,13 +4054,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
           }
         }
         
-        double given_site_entropy = 0.0;
-        for (int inst = 0; inst < num_insts; ++ inst) {
-          if (given_prob[line][inst] > 0) {
-            given_site_entropy -= given_prob[line][inst] * (log(given_prob[line][inst]) /
-                                                            log(1.0*num_insts));
-          }
-        }
+        double given_site_entropy = given_entropy[line];
         
         
         double entropy_overlap = 0.0;
@@ -3683,13 +4070,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
         total_initial_entropy += initial_entropy;
         
         // H(genotype|E, known_genotype) = H(genotype|Env)
-        double conditional_entropy = 0.0;
-        for (int inst = 0; inst < num_insts; ++ inst) {
-          if (this_prob[line][inst] > 0) {
-            conditional_entropy -= this_prob[line][inst] * (log(this_prob[line][inst]) / 
-                                                            log(1.0*num_insts));
-          }
-        }
+        double conditional_entropy = this_entropy[line];
         total_conditional_entropy += conditional_entropy;
         
         if (conditional_entropy > initial_entropy + 0.00001) {
@@ -4480,6 +4861,69 @@ void cAnalyze::AnalyzeComplexityDelta(cString cur_string)
   }
 }
 
+// A set of single or paired knockouts of a genome, run through one test CPU as a batch
+class cAnalyzeKnockoutJob
+{
+private:
+  cWorld* m_world;
+  const Genome& m_base_genome;
+  Instruction m_null_inst;
+  cCPUTestInfo m_test_info;
+  Apto::Array<int> m_sites1;
+  Apto::Array<int> m_sites2;  // -1 for single knockouts
+  Apto::Array<double> m_fitness;
+  
+public:
+  cAnalyzeKnockoutJob(cWorld* world, const Genome& base_genome, const Instruction& null_inst)
+    : m_world(world), m_base_genome(base_genome), m_null_inst(null_inst) { ; }
+  
+  void AddKnockout(int site1, int site2 = -1) { m_sites1.Push(site1); m_sites2.Push(site2); }
+  
+  int GetNumKnockouts() const { return m_sites1.GetSize(); }
+  int GetSite1(int idx) const { return m_sites1[idx]; }
+  int GetSite2(int idx) const { return m_sites2[idx]; }
+  double GetFitness(int idx) const { return m_fitness[idx]; }
+  
+  void Test(cAvidaContext& ctx)
+  {
+    Genome mod_genome(m_base_genome);
+    InstructionSequencePtr mod_seq_p;
+    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+    mod_seq_p.DynamicCastFrom(mod_rep_p);
+    InstructionSequence& mod_seq = *mod_seq_p;
+    
+    Apto::Array<Genome> knockouts;
+    for (int i = 0; i < m_sites1.GetSize(); i++) {
+      const int cur_inst1 = mod_seq[m_sites1[i]].GetOp();
+      const int cur_inst2 = (m_sites2[i] >= 0) ? mod_seq[m_sites2[i]].GetOp() : 0;
+      mod_seq[m_sites1[i]] = m_null_inst;
+      if (m_sites2[i] >= 0) mod_seq[m_sites2[i]] = m_null_inst;
+      knockouts.Push(mod_genome); // copies the sequence
+      mod_seq[m_sites1[i]].SetOp(cur_inst1);
+      if (m_sites2[i] >= 0) mod_seq[m_sites2[i]].SetOp(cur_inst2);
+    }
+    
+    cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+    cTestCPU::sBatchResults results;
+    testcpu->TestGenomes(ctx, m_test_info, knockouts, results);
+    m_fitness = results.fitness;
+    delete testcpu;
+  }
+};
+
+
+void cAnalyze::RunKnockoutJobs(Apto::Array<cAnalyzeKnockoutJob*>& jobs, bool parallel)
+{
+  if (parallel) {
+    tAnalyzeJobBatch<cAnalyzeKnockoutJob> jobbatch(m_jobqueue);
+    for (int j = 0; j < jobs.GetSize(); j++) jobbatch.AddJob(jobs[j], &cAnalyzeKnockoutJob::Test);
+    jobbatch.RunBatch();
+  } else {
+    for (int j = 0; j < jobs.GetSize(); j++) jobs[j]->Test(m_ctx);
+  }
+}
+
+
 void cAnalyze::AnalyzeKnockouts(cString cur_string)
 {
   cout << "Analyzing the effects of knockouts..." << endl;
@@ -4496,6 +4940,9 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
   df->WriteTimeStamp();  
   
   
+  const bool recalculated = ParallelRecalculate(cCPUTestInfo());
+  const bool parallel = m_world->GetConfig().PARALLEL_ANALYZE.Get();
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * genotype = NULL;
@@ -4503,26 +4950,29 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "  Knockout: " << genotype->GetName() << endl;
     
     // Calculate the stats for the genotype we're working with...
-    genotype->Recalculate(m_ctx);
+    if (!recalculated) genotype->Recalculate(m_ctx);
     const double base_fitness = genotype->GetFitness();
     
     const int max_line = genotype->GetLength();
     
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
     
     Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code, split over several batches when the analyze threads are in use
+    const int num_jobs = (parallel) ? Apto::Max(1, Apto::Min(max_line, 4 * Apto::Platform::AvailableCPUs())) : 1;
+    Apto::Array<cAnalyzeKnockoutJob*> jobs;
+    for (int j = 0; j < num_jobs; j++) jobs.Push(new cAnalyzeKnockoutJob(m_world, base_genome, null_inst));
+    for (int line_num = 0; line_num < max_line; line_num++) jobs[line_num % num_jobs]->AddKnockout(line_num);
+    RunKnockoutJobs(jobs, parallel);
+    
+    Apto::Array<double> ko_fitness_by_line(max_line);
+    for (int j = 0; j < jobs.GetSize(); j++) {
+      for (int i = 0; i < jobs[j]->GetNumKnockouts(); i++) ko_fitness_by_line[jobs[j]->GetSite1(i)] = jobs[j]->GetFitness(i);
+      delete jobs[j];
+    }
+    
+    // Loop through all the lines of code, scoring the removal of each.
     // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
     int dead_count = 0;
     int neg_count = 0;
@@ -4530,13 +4980,7 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     int pos_count = 0;
     Apto::Array<int> ko_effect(max_line);
     for (int line_num = 0; line_num < max_line; line_num++) {
-      // Save a copy of the current instruction and replace it with "NULL"
-      int cur_inst = base_seq[line_num].GetOp();
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
-      
-      double ko_fitness = ko_genotype.GetFitness();
+      double ko_fitness = ko_fitness_by_line[line_num];
       if (ko_fitness == 0.0) {
         dead_count++;
         ko_effect[line_num] = -2;
@@ -4552,23 +4996,33 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
       } else {
         cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
       }
-      
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
     }
     
     Apto::Array<int> ko_pair_effect(ko_effect);
     if (max_knockouts > 1) {
+      // A pair only changes the effects of its lines when both single knockouts fell on the same side of neutral, so
+      // the pairs that mix a harmful line with a neutral or beneficial one are never tested.  Each line can only be
+      // moved one way (harmful to neutral, or neutral to harmful), so the order the pairs are scored in is immaterial.
+      // Pairs are batched by their first line.
+      jobs.Resize(0);
       for (int line1 = 0; line1 < max_line; line1++) {
-      	for (int line2 = line1+1; line2 < max_line; line2++) {
-          int cur_inst1 = base_seq[line1].GetOp();
-          int cur_inst2 = base_seq[line2].GetOp();
-          mod_seq[line1] = null_inst;
-          mod_seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
-          
-          double ko_fitness = ko_genotype.GetFitness();
+        cAnalyzeKnockoutJob* job = NULL;
+        for (int line2 = line1+1; line2 < max_line; line2++) {
+          if ((ko_effect[line1] < 0) != (ko_effect[line2] < 0)) continue;
+          if (job == NULL) {
+            job = new cAnalyzeKnockoutJob(m_world, base_genome, null_inst);
+            jobs.Push(job);
+          }
+          job->AddKnockout(line1, line2);
+        }
+      }
+      RunKnockoutJobs(jobs, parallel);
+      
+      for (int j = 0; j < jobs.GetSize(); j++) {
+        for (int i = 0; i < jobs[j]->GetNumKnockouts(); i++) {
+          const int line1 = jobs[j]->GetSite1(i);
+          const int line2 = jobs[j]->GetSite2(i);
+          double ko_fitness = jobs[j]->GetFitness(i);
           
           // If both individual knockouts are both harmful, but in combination
           // they are neutral or even beneficial, they should not count as 
@@ -4587,11 +5041,8 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
             ko_pair_effect[line1] = -1;
             ko_pair_effect[line2] = -1;
           }	
-          
-          // Reset the mod_genome back to the original sequence.
-          mod_seq[line1].SetOp(cur_inst1);
-          mod_seq[line2].SetOp(cur_inst2);
         }
+        delete jobs[j];
       }
     }    
     
@@ -5081,36 +5532,123 @@ genotype_vector cAnalyze::LoadDetailFileAsVector(cString cur_string)
   return genotypes;
 }
 
+// Set of genome sequences keyed on InstructionSequence::Hash(), with an optional count per sequence.  Entries stay in
+// insertion order; sequences are held by pointer, so the genotypes they came from must outlive the set.
+class cAnalyzeSequenceSet
+{
+private:
+  struct sEntry
+  {
+    unsigned long long hash;
+    const InstructionSequence* seq;
+    int count;
+  };
+  
+  Apto::Array<sEntry, Apto::Smart> m_entries;
+  Apto::Array<int> m_table;  // open addressing (linear probe) into m_entries, -1 for empty slots
+  
+public:
+  cAnalyzeSequenceSet() : m_table(16) { m_table.SetAll(-1); }
+  
+  int GetSize() const { return m_entries.GetSize(); }
+  const InstructionSequence& GetSequence(int idx) const { return *m_entries[idx].seq; }
+  int GetCount(int idx) const { return m_entries[idx].count; }
+  
+  int Find(const InstructionSequence& seq) const { return find(seq, seq.Hash()); }
+  bool Has(const InstructionSequence& seq) const { return (Find(seq) >= 0); }
+  bool Has(const cAnalyzeGenotype& genotype) const { return Has(sequenceOf(genotype)); }
+  
+  // Adds count to the entry for seq, creating it if needed, and returns its index
+  int Add(const InstructionSequence& seq, int count = 1)
+  {
+    const unsigned long long hash = seq.Hash();
+    int idx = find(seq, hash);
+    if (idx >= 0) {
+      m_entries[idx].count += count;
+      return idx;
+    }
+    
+    if (2 * (m_entries.GetSize() + 1) > m_table.GetSize()) rehash(2 * m_table.GetSize());
+    
+    idx = m_entries.GetSize();
+    sEntry entry = { hash, &seq, count };
+    m_entries.Push(entry);
+    insert(idx);
+    return idx;
+  }
+  int Add(const cAnalyzeGenotype& genotype, int count = 1) { return Add(sequenceOf(genotype), count); }
+  
+  // Adds the first member of each lineage (most recent first) whose sequence is in origins
+  void AddLineageOrigins(const lineage_vector& lineages, const cAnalyzeSequenceSet& origins)
+  {
+    for (lineage_vector::const_iterator lineage = lineages.begin(); lineage != lineages.end(); ++lineage) {
+      for (genotype_vector::const_iterator genotype = lineage->begin(); genotype != lineage->end(); ++genotype) {
+        const int origin = origins.Find(sequenceOf(*genotype));
+        if (origin >= 0) {
+          Add(origins.GetSequence(origin));
+          break;
+        }
+      }
+    }
+  }
+  
+  static const InstructionSequence& sequenceOf(const cAnalyzeGenotype& genotype)
+  {
+    ConstInstructionSequencePtr seq_p;
+    seq_p.DynamicCastFrom(genotype.GetGenome().Representation());
+    return *seq_p;  // owned by the genotype's genome
+  }
+  
+private:
+  int find(const InstructionSequence& seq, unsigned long long hash) const
+  {
+    const int mask = m_table.GetSize() - 1;
+    for (int slot = (int)(hash & mask); m_table[slot] >= 0; slot = (slot + 1) & mask) {
+      const sEntry& entry = m_entries[m_table[slot]];
+      if (entry.hash == hash && *entry.seq == seq) return m_table[slot];
+    }
+    return -1;
+  }
+  
+  void insert(int idx)
+  {
+    const int mask = m_table.GetSize() - 1;
+    int slot = (int)(m_entries[idx].hash & mask);
+    while (m_table[slot] >= 0) slot = (slot + 1) & mask;
+    m_table[slot] = idx;
+  }
+  
+  void rehash(int size)
+  {
+    m_table.Resize(size);
+    m_table.SetAll(-1);
+    for (int i = 0; i < m_entries.GetSize(); i++) insert(i);
+  }
+};
+
+
 lineage_vector cAnalyze::MakeLineageVector(genotype_vector current_genotypes)
 {
   lineage_vector lineages;
 
+  // Index the genotypes by id (first occurrence wins, as the old linear scan did)
+  Apto::Map<int, int> id_index;
+  for (int i = 0; i < (int)current_genotypes.size(); i++) {
+    if (!id_index.Has(current_genotypes[i].GetID())) id_index.Set(current_genotypes[i].GetID(), i);
+  }
+
   for (int i=0; i < (int)current_genotypes.size(); i++)
   {
     if (current_genotypes[i].GetNumCPUs() > 0)
     {
-      cAnalyzeGenotype* found_gen = &current_genotypes[i];
-  
-      // Otherwise, trace back through the id numbers to mark all of those
-      // in the ancestral lineage...
-  
-      // Construct a list of genotypes found...
-      
+      // Trace back through the id numbers to collect all of the genotypes in the ancestral lineage...
       genotype_vector found_list;
-      found_list.push_back(*found_gen);
-      int next_id = found_gen->GetParentID();
-      bool found = true;
-      while (found == true) {
-        found = false;
-        
-        for (genotype_vector::iterator found_gen = current_genotypes.begin(); found_gen != current_genotypes.end(); ++found_gen) {
-          if (found_gen->GetID() == next_id) {
-            found_list.push_back(*found_gen);
-            next_id = found_gen->GetParentID();
-            found = true;
-            break;
-          }
-        }
+      found_list.push_back(current_genotypes[i]);
+      int next_idx = -1;
+      int next_id = current_genotypes[i].GetParentID();
+      while (id_index.Get(next_id, next_idx)) {
+        found_list.push_back(current_genotypes[next_idx]);
+        next_id = current_genotypes[next_idx].GetParentID();
       }
       lineages.push_back(found_list);
     }
@@ -5172,85 +5710,26 @@ void cAnalyze::CountNewSignificantLineages(cString cur_string)
 
   // Find lineage's most recent parent in the coalescnece time detail file and save to hash (skipping if it is already in the hash)
 
-  std::map<InstructionSequence, int> lineage1_map;
-
-  for (lineage_vector::iterator current_lineage = current_lineages.begin(); current_lineage != current_lineages.end(); ++current_lineage){
-
-    for (genotype_vector::iterator curr_genotype = current_lineage->begin(); curr_genotype != current_lineage->end(); ++curr_genotype)
-    {
-      const Genome& cur_genome = curr_genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      bool found = false;
-      
-      for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (cur_seq == coal_seq){
-            lineage1_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet current_coal_set;
+  for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) current_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage1_set;
+  lineage1_set.AddLineageOrigins(current_lineages, current_coal_set);
  
   // Same for second file
   
-  std::map<InstructionSequence, int> lineage2_map;
-
-  for (std::vector<vector<cAnalyzeGenotype> >::iterator previous_lineage = previous_lineages.begin(); previous_lineage != previous_lineages.end(); ++previous_lineage){
-
-    for (std::vector<cAnalyzeGenotype>::iterator prev_genotype = previous_lineage->begin(); prev_genotype != previous_lineage->end(); ++prev_genotype)
-    {
-      const Genome& prev_genome = prev_genotype->GetGenome();
-      ConstInstructionSequencePtr prev_seq_p;
-      ConstGeneticRepresentationPtr prev_rep_p = prev_genome.Representation();
-      prev_seq_p.DynamicCastFrom(prev_rep_p);
-      const InstructionSequence& prev_seq = *prev_seq_p;
-      bool found = false;
-      
-      
-      for (std::vector<cAnalyzeGenotype>::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (prev_seq == coal_seq){
-            lineage2_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet previous_coal_set;
+  for (genotype_vector::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) previous_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage2_set;
+  lineage2_set.AddLineageOrigins(previous_lineages, previous_coal_set);
   // Count number of significant lineages that are in first file but not second (ie are new!)
   int sig_lineages = 0;
   
-  for (std::map<InstructionSequence, int>::iterator key_it = lineage1_map.begin(); key_it != lineage1_map.end(); ++key_it)
-  {
-    if (lineage2_map.count(key_it->first)==0)
-    {
-      sig_lineages++;
-    }
+  for (int i = 0; i < lineage1_set.GetSize(); i++) {
+    if (!lineage2_set.Has(lineage1_set.GetSequence(i))) sig_lineages++;
   }
   // TODO: Have it then go back for every timepoint based on the gap between the two files
   cout << "Number of new significant lineages " << sig_lineages << endl;
@@ -5283,31 +5762,14 @@ void cAnalyze::CountNovelSkeletons(cString cur_string)
   genotype_vector current_genotypes = GetSkeletons(first_file);
   genotype_vector coal_genotypes = GetSkeletons(coal_point_name);
 
-  std::map<InstructionSequence, bool> coal_set;
-
-  for (genotype_vector::iterator iter = coal_genotypes.begin(); iter != coal_genotypes.end(); ++iter)
-    {
-      const Genome& cur_genome = iter->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      coal_set[cur_seq] = true;
-    }
+  cAnalyzeSequenceSet coal_set;
+  for (genotype_vector::iterator iter = coal_genotypes.begin(); iter != coal_genotypes.end(); ++iter) coal_set.Add(*iter);
 
   int count = 0;
 
   for (genotype_vector::iterator genotype = current_genotypes.begin(); genotype != current_genotypes.end(); ++genotype)
     {
-      const Genome& cur_genome = genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      if (!coal_set[cur_seq])
-	{
-	  count++;
-	}
+      if (!coal_set.Has(*genotype)) count++;
     }
   cout << "Novel Genotypes: " << count << endl;
   ofstream outfile;
@@ -5385,36 +5847,23 @@ void cAnalyze::ShannonDiversitySkeletons(cString cur_string){
 
   genotype_vector skeletons = GetSkeletons(file_name);
   
-  std::map<InstructionSequence, int> skeleton_counts;
+  cAnalyzeSequenceSet skeleton_counts;
   float pop_size = 0.0;
 
   for (genotype_vector::iterator iter = skeletons.begin(); iter != skeletons.end(); ++iter)
     {
       if (iter->GetNumCPUs() > 0)
 	{
-	  const Genome& cur_genome = iter->GetGenome();
-	  ConstInstructionSequencePtr cur_seq_p;
-	  ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-	  cur_seq_p.DynamicCastFrom(cur_rep_p);
-	  const InstructionSequence& cur_seq = *cur_seq_p;
 	  pop_size += iter->GetNumCPUs();
-	  if (skeleton_counts.count(cur_seq) > 0)
-	    {
-	      skeleton_counts[cur_seq] += iter->GetNumCPUs();
-	    } 
-	  else {
-	    //cout << "Found new skeleton! " << cur_seq.AsString() << endl;
-	    skeleton_counts[cur_seq] = iter->GetNumCPUs();
-	  }
+	  skeleton_counts.Add(*iter, iter->GetNumCPUs());
 	}
     }
   float diversity = 0.0;
 
-  for (std::map<InstructionSequence, int>::iterator iter = skeleton_counts.begin(); iter != skeleton_counts.end(); ++iter)
+  for (int i = 0; i < skeleton_counts.GetSize(); i++)
     {
-      float prob = iter->second/pop_size;
+      float prob = skeleton_counts.GetCount(i)/pop_size;
       diversity += prob * log2(prob);
-      //cout << iter->first.AsString() << " " << iter->second << " " << prob << " " << diversity << endl;
     }
   cout << "Skeleton diversity: " << diversity*-1 << endl;
   ofstream outfile;
@@ -5519,101 +5968,33 @@ void cAnalyze::ChangeDebugging(cString cur_string)
 
   // Find lineage's most recent parent in the coalescnece time detail file and save to hash (skipping if it is already in the hash)
 
-  std::map<InstructionSequence, int> lineage1_map;
-
-  for (lineage_vector::iterator current_lineage = current_lineages.begin(); current_lineage != current_lineages.end(); ++current_lineage){
-
-    for (genotype_vector::iterator curr_genotype = current_lineage->begin(); curr_genotype != current_lineage->end(); ++curr_genotype)
-    {
-      const Genome& cur_genome = curr_genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      bool found = false;
-      
-      for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (cur_seq == coal_seq){
-            lineage1_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet current_coal_set;
+  for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) current_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage1_set;
+  lineage1_set.AddLineageOrigins(current_lineages, current_coal_set);
  
   // Same for second file
   
-  std::map<InstructionSequence, int> lineage2_map;
-
-  for (std::vector<vector<cAnalyzeGenotype> >::iterator previous_lineage = previous_lineages.begin(); previous_lineage != previous_lineages.end(); ++previous_lineage){
-
-    for (std::vector<cAnalyzeGenotype>::iterator prev_genotype = previous_lineage->begin(); prev_genotype != previous_lineage->end(); ++prev_genotype)
-    {
-      const Genome& prev_genome = prev_genotype->GetGenome();
-      ConstInstructionSequencePtr prev_seq_p;
-      ConstGeneticRepresentationPtr prev_rep_p = prev_genome.Representation();
-      prev_seq_p.DynamicCastFrom(prev_rep_p);
-      const InstructionSequence& prev_seq = *prev_seq_p;
-      bool found = false;
-      
-      
-      for (std::vector<cAnalyzeGenotype>::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (prev_seq == coal_seq){
-            lineage2_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet previous_coal_set;
+  for (genotype_vector::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) previous_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage2_set;
+  lineage2_set.AddLineageOrigins(previous_lineages, previous_coal_set);
 
   ofstream change_outfile;
   change_outfile.open("change_list.csv", ios_base::app);
    //     change_outfile << key_it->first.AsString() << endl;
     //    change_outfile.close();
-  for (std::map<InstructionSequence, int>::iterator key_it = lineage1_map.begin(); key_it != lineage1_map.end(); ++key_it)
+  // Go through and find the genotypes that the new instruction sequences came from
+  for (genotype_vector::iterator curr_genotype = current_genotypes.begin(); curr_genotype != current_genotypes.end(); ++curr_genotype)
   {
-    if (lineage2_map.count(key_it->first)==0)
-    {
-      //Go through and find the genotype that this instruction sequence came from
-      for (genotype_vector::iterator curr_genotype = current_genotypes.begin(); curr_genotype != current_genotypes.end(); ++curr_genotype)
-      {
-      
-      const Genome& cur_genome = curr_genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      if (cur_seq == key_it->first) {
-        change_outfile << key_it->first.AsString() << " ";
-        change_outfile << curr_genotype->GetUpdateBorn() << endl;
-        
-        
-        }
-      }
+    const InstructionSequence& cur_seq = cAnalyzeSequenceSet::sequenceOf(*curr_genotype);
+    if (lineage1_set.Has(cur_seq) && !lineage2_set.Has(cur_seq)) {
+      change_outfile << cur_seq.AsString() << " ";
+      change_outfile << curr_genotype->GetUpdateBorn() << endl;
     }
   }
 
@@ -5678,76 +6059,21 @@ void cAnalyze::ComplexityDebugging(cString cur_string)
 
   // Find lineage's most recent parent in the coalescnece time detail file and save to hash (skipping if it is already in the hash)
 
-  std::map<InstructionSequence, int> lineage1_map;
-
-  for (lineage_vector::iterator current_lineage = current_lineages.begin(); current_lineage != current_lineages.end(); ++current_lineage){
-
-    for (genotype_vector::iterator curr_genotype = current_lineage->begin(); curr_genotype != current_lineage->end(); ++curr_genotype)
-    {
-      const Genome& cur_genome = curr_genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      bool found = false;
-      
-      for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (cur_seq == coal_seq){
-            lineage1_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet current_coal_set;
+  for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) current_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage1_set;
+  lineage1_set.AddLineageOrigins(current_lineages, current_coal_set);
  
   // Same for second file
   
-  std::map<InstructionSequence, int> lineage2_map;
-
-  for (std::vector<vector<cAnalyzeGenotype> >::iterator previous_lineage = previous_lineages.begin(); previous_lineage != previous_lineages.end(); ++previous_lineage){
-
-    for (std::vector<cAnalyzeGenotype>::iterator prev_genotype = previous_lineage->begin(); prev_genotype != previous_lineage->end(); ++prev_genotype)
-    {
-      const Genome& prev_genome = prev_genotype->GetGenome();
-      ConstInstructionSequencePtr prev_seq_p;
-      ConstGeneticRepresentationPtr prev_rep_p = prev_genome.Representation();
-      prev_seq_p.DynamicCastFrom(prev_rep_p);
-      const InstructionSequence& prev_seq = *prev_seq_p;
-      bool found = false;
-      
-      
-      for (std::vector<cAnalyzeGenotype>::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (prev_seq == coal_seq){
-            lineage2_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet previous_coal_set;
+  for (genotype_vector::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) previous_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage2_set;
+  lineage2_set.AddLineageOrigins(previous_lineages, previous_coal_set);
 
   Genome winner;
   int largest = 0;
@@ -5842,85 +6168,26 @@ void cAnalyze::AllComplexityBarriers(cString cur_string)
 
   // Find lineage's most recent parent in the coalescnece time detail file and save to hash (skipping if it is already in the hash)
 
-  std::map<InstructionSequence, int> lineage1_map;
-
-  for (lineage_vector::iterator current_lineage = current_lineages.begin(); current_lineage != current_lineages.end(); ++current_lineage){
-
-    for (genotype_vector::iterator curr_genotype = current_lineage->begin(); curr_genotype != current_lineage->end(); ++curr_genotype)
-    {
-      const Genome& cur_genome = curr_genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      bool found = false;
-      
-      for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (cur_seq == coal_seq){
-            lineage1_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet current_coal_set;
+  for (genotype_vector::iterator coal_genotype = current_coal_genotypes.begin(); coal_genotype != current_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) current_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage1_set;
+  lineage1_set.AddLineageOrigins(current_lineages, current_coal_set);
  
   // Same for second file
   
-  std::map<InstructionSequence, int> lineage2_map;
-
-  for (std::vector<vector<cAnalyzeGenotype> >::iterator previous_lineage = previous_lineages.begin(); previous_lineage != previous_lineages.end(); ++previous_lineage){
-
-    for (std::vector<cAnalyzeGenotype>::iterator prev_genotype = previous_lineage->begin(); prev_genotype != previous_lineage->end(); ++prev_genotype)
-    {
-      const Genome& prev_genome = prev_genotype->GetGenome();
-      ConstInstructionSequencePtr prev_seq_p;
-      ConstGeneticRepresentationPtr prev_rep_p = prev_genome.Representation();
-      prev_seq_p.DynamicCastFrom(prev_rep_p);
-      const InstructionSequence& prev_seq = *prev_seq_p;
-      bool found = false;
-      
-      
-      for (std::vector<cAnalyzeGenotype>::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype)
-      {
-        if (coal_genotype->GetNumCPUs() > 0)
-        {
-          const Genome& coal_genome = coal_genotype->GetGenome();
-          ConstInstructionSequencePtr coal_seq_p;
-          ConstGeneticRepresentationPtr coal_rep_p = coal_genome.Representation();
-          coal_seq_p.DynamicCastFrom(coal_rep_p);
-          const InstructionSequence& coal_seq = *coal_seq_p;
-
-          if (prev_seq == coal_seq){
-            lineage2_map[coal_seq]++;
-            found = true;
-            break;
-          }
-        }
-      }
-      if (found) break;
-    }
+  cAnalyzeSequenceSet previous_coal_set;
+  for (genotype_vector::iterator coal_genotype = previous_coal_genotypes.begin(); coal_genotype != previous_coal_genotypes.end(); ++coal_genotype) {
+    if (coal_genotype->GetNumCPUs() > 0) previous_coal_set.Add(*coal_genotype);
   }
+  cAnalyzeSequenceSet lineage2_set;
+  lineage2_set.AddLineageOrigins(previous_lineages, previous_coal_set);
   // Count number of significant lineages that are in first file but not second (ie are new!)
   int sig_lineages = 0;
   
-  for (std::map<InstructionSequence, int>::iterator key_it = lineage1_map.begin(); key_it != lineage1_map.end(); ++key_it)
-  {
-    if (lineage2_map.count(key_it->first)==0)
-    {
-      sig_lineages++;
-    }
+  for (int i = 0; i < lineage1_set.GetSize(); i++) {
+    if (!lineage2_set.Has(lineage1_set.GetSequence(i))) sig_lineages++;
   }
   // TODO: Have it then go back for every timepoint based on the gap between the two files
   cout << "Number of new significant lineages " << sig_lineages << endl;
@@ -5935,31 +6202,14 @@ void cAnalyze::AllComplexityBarriers(cString cur_string)
   current_genotypes = current_genotypes_backup;
   current_coal_genotypes = current_coal_genotypes_backup;
  
-  std::map<InstructionSequence, bool> coal_set;
-
-  for (genotype_vector::iterator iter = current_coal_genotypes.begin(); iter != current_coal_genotypes.end(); ++iter)
-    {
-      const Genome& cur_genome = iter->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      coal_set[cur_seq] = true;
-    }
+  cAnalyzeSequenceSet coal_set;
+  for (genotype_vector::iterator iter = current_coal_genotypes.begin(); iter != current_coal_genotypes.end(); ++iter) coal_set.Add(*iter);
 
   int count = 0;
 
   for (genotype_vector::iterator genotype = current_genotypes.begin(); genotype != current_genotypes.end(); ++genotype)
     {
-      const Genome& cur_genome = genotype->GetGenome();
-      ConstInstructionSequencePtr cur_seq_p;
-      ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-      cur_seq_p.DynamicCastFrom(cur_rep_p);
-      const InstructionSequence& cur_seq = *cur_seq_p;
-      if (!coal_set[cur_seq])
-	{
-	  count++;
-	}
+      if (!coal_set.Has(*genotype)) count++;
     }
   cout << "Novel Genotypes: " << count << endl;
   ofstream novelty_outfile;
@@ -5970,36 +6220,23 @@ void cAnalyze::AllComplexityBarriers(cString cur_string)
   current_genotypes = current_genotypes_backup;
   current_coal_genotypes = current_coal_genotypes_backup;
   
-  std::map<InstructionSequence, int> skeleton_counts;
+  cAnalyzeSequenceSet skeleton_counts;
   float pop_size = 0.0;
 
   for (genotype_vector::iterator iter = current_genotypes.begin(); iter != current_genotypes.end(); ++iter)
     {
       if (iter->GetNumCPUs() > 0)
 	{
-	  const Genome& cur_genome = iter->GetGenome();
-	  ConstInstructionSequencePtr cur_seq_p;
-	  ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
-	  cur_seq_p.DynamicCastFrom(cur_rep_p);
-	  const InstructionSequence& cur_seq = *cur_seq_p;
 	  pop_size += iter->GetNumCPUs();
-	  if (skeleton_counts.count(cur_seq) > 0)
-	    {
-	      skeleton_counts[cur_seq] += iter->GetNumCPUs();
-	    } 
-	  else {
-	    //cout << "Found new skeleton! " << cur_seq.AsString() << endl;
-	    skeleton_counts[cur_seq] = iter->GetNumCPUs();
-	  }
+	  skeleton_counts.Add(*iter, iter->GetNumCPUs());
 	}
     }
   float diversity = 0.0;
 
-  for (std::map<InstructionSequence, int>::iterator iter = skeleton_counts.begin(); iter != skeleton_counts.end(); ++iter)
+  for (int i = 0; i < skeleton_counts.GetSize(); i++)
     {
-      float prob = iter->second/pop_size;
+      float prob = skeleton_counts.GetCount(i)/pop_size;
       diversity += prob * log2(prob);
-      //cout << iter->first.AsString() << " " << iter->second << " " << prob << " " << diversity << endl;
     }
   cout << "Skeleton diversity: " << diversity*-1 << endl;
   ofstream ecology_outfile;
@@ -6123,6 +6360,12 @@ void cAnalyze::CommandMapTasks(cString cur_string)
   }
   
   
+  cCPUTestInfo batch_test_info;
+  if (use_manual_inputs)
+    batch_test_info.UseManualInputs(manual_inputs);
+  batch_test_info.SetResourceOptions(use_resources, m_resources);
+  const bool recalculated = ParallelRecalculate(batch_test_info);
+  
   ///////////////////////////////////////////////////////
   // Loop through all of the genotypes in this batch...
   
@@ -6163,7 +6406,7 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     if (use_manual_inputs)
       test_info.UseManualInputs(manual_inputs);
     test_info.SetResourceOptions(use_resources, m_resources);
-    genotype->Recalculate(m_ctx, &test_info);
+    if (!recalculated) genotype->Recalculate(m_ctx, &test_info);
     
     // Headers...
     if (file_type == FILE_TYPE_TEXT) {
@@ -6252,12 +6495,6 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
-    
     // Keep track of the number of failues/successes for attributes...
     int * col_pass_count = new int[num_cols];
     int * col_fail_count = new int[num_cols];
@@ -6269,14 +6506,17 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
     const Instruction null_inst = is.ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code up front, so only the printing below is serial
+    Apto::Array<Apto::Array<int> > site_ops(max_line);
+    for (int line_num = 0; line_num < max_line; line_num++) site_ops[line_num].Push(null_inst.GetOp());
+    Apto::Array<Apto::Array<cAnalyzeGenotype*> > knockouts;
+    TestSiteMutants(base_genome, test_info, site_ops, knockouts);
+    
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
       
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx, &test_info);
+      cAnalyzeGenotype& test_genotype = *knockouts[line_num][0];
       
       if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
       fp << (line_num + 1) << " ";
@@ -6313,8 +6553,7 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
       
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
+      delete knockouts[line_num][0];
     }
     
     
@@ -7053,12 +7292,6 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
-    
     const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
     const int num_insts = inst_set.GetSize();
     
@@ -7124,12 +7357,24 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     
     cString color_string;  // For coloring cells...
     
-    // Loop through all the lines of code, testing all mutations...
+    // Test every point mutation and the knockout at each line up front, so only the printing below is serial
+    Apto::Array<Apto::Array<int> > site_ops(max_line);
+    for (int line_num = 0; line_num < max_line; line_num++) {
+      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+        if (mod_inst != base_seq[line_num].GetOp()) site_ops[line_num].Push(mod_inst);
+      }
+      site_ops[line_num].Push(null_inst.GetOp());
+    }
+    Apto::Array<Apto::Array<double> > site_fitness;
+    TestSiteMutants(base_genome, cCPUTestInfo(), site_ops, site_fitness);
+    
+    // Loop through all the lines of code, printing all mutations...
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
       int row_dead = 0, row_neg = 0, row_neut = 0, row_pos = 0;
       double row_fitness = 0.0;
+      int test_num = 0;
       
       // Column 1... the original instruction in the geneome.
       if (file_type == FILE_TYPE_HTML) {
@@ -7149,10 +7394,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
           }
         }
         else {
-          seq[line_num].SetOp(mod_inst);
-          cAnalyzeGenotype test_genotype(m_world, mod_genome);
-          test_genotype.Recalculate(m_ctx);
-          const double test_fitness = test_genotype.GetFitness() / base_fitness;
+          const double test_fitness = site_fitness[line_num][test_num++] / base_fitness;
           row_fitness += test_fitness;
           total_fitness += test_fitness;
           col_fitness[mod_inst] += test_fitness;
@@ -7185,10 +7427,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       }
       
       // Column: Knockout
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
-      const double test_fitness = test_genotype.GetFitness() / base_fitness;
+      const double test_fitness = site_fitness[line_num][test_num] / base_fitness;
       col_fitness[num_insts] += test_fitness;
       
       // Categorize this mutation if its in HTML mode (color only)...
@@ -7227,10 +7466,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       
       // End this row...
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
-      fp << endl;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
+      fp << endl;
     }
     
     
@@ -7306,6 +7542,103 @@ void cAnalyze::CommandMapDepth(cString cur_string)
   }
 }
 
+// A run of the genotypes of the second batch, whose distances to every genotype of the first batch are summed
+// independently of every other tile
+class cAnalyzeDistanceTile
+{
+private:
+  const Apto::Array<cAnalyzeGenotype*>& m_genotypes1;
+  const Apto::Array<cAnalyzeGenotype*>& m_genotypes2;
+  const Apto::Array<const InstructionSequence*>& m_seqs1;
+  const Apto::Array<const InstructionSequence*>& m_seqs2;
+  bool m_edit_distance;
+  int m_begin;
+  int m_end;
+  double m_total_dist;
+  double m_total_count;
+  
+public:
+  cAnalyzeDistanceTile(const Apto::Array<cAnalyzeGenotype*>& genotypes1, const Apto::Array<cAnalyzeGenotype*>& genotypes2,
+                       const Apto::Array<const InstructionSequence*>& seqs1,
+                       const Apto::Array<const InstructionSequence*>& seqs2, bool edit_distance, int begin, int end)
+    : m_genotypes1(genotypes1), m_genotypes2(genotypes2), m_seqs1(seqs1), m_seqs2(seqs2)
+    , m_edit_distance(edit_distance), m_begin(begin), m_end(end), m_total_dist(0.0), m_total_count(0.0) { ; }
+  
+  double GetTotalDist() const { return m_total_dist; }
+  double GetTotalCount() const { return m_total_count; }
+  
+  void Sum(cAvidaContext&)
+  {
+    for (int i = 0; i < m_genotypes1.GetSize(); i++) {
+      const int count1 = m_genotypes1[i]->GetNumCPUs();
+      for (int j = m_begin; j < m_end; j++) {
+        // Determine the counts...
+        const int count2 = m_genotypes2[j]->GetNumCPUs();
+        const int num_pairs = (m_genotypes1[i] == m_genotypes2[j]) ?
+          ((count1 - 1) * (count2 - 1)) : (count1 * count2);
+        if (num_pairs == 0) continue;
+        
+        // And do the tests...
+        const int dist = (m_edit_distance) ? InstructionSequence::FindEditDistance(*m_seqs1[i], *m_seqs2[j]) :
+          InstructionSequence::FindHammingDistance(*m_seqs1[i], *m_seqs2[j]);
+        m_total_dist += dist * num_pairs;
+        m_total_count += num_pairs;
+      }
+    }
+  }
+};
+
+
+double cAnalyze::SumPairDistances(int batch1, int batch2, bool edit_distance, double& total_dist)
+{
+  // Unpack every genome once, rather than once per pair
+  Apto::Array<cAnalyzeGenotype*> genotypes[2];
+  Apto::Array<const InstructionSequence*> seqs[2];
+  const int batch_ids[2] = { batch1, batch2 };
+  for (int b = 0; b < 2; b++) {
+    tListIterator<cAnalyzeGenotype> list_it(batch[batch_ids[b]].List());
+    cAnalyzeGenotype* genotype = NULL;
+    while ((genotype = list_it.Next()) != NULL) {
+      ConstInstructionSequencePtr seq_p;
+      seq_p.DynamicCastFrom(genotype->GetGenome().Representation());
+      genotypes[b].Push(genotype);
+      seqs[b].Push(&(*seq_p));
+    }
+  }
+  
+  // Tiles are summed in order whether or not they ran on the analyze threads.  Every term is a whole number, so the
+  // totals come out exactly as a single pass over the pairs would give them.
+  const bool parallel = m_world->GetConfig().PARALLEL_ANALYZE.Get();
+  const int num_cols = genotypes[1].GetSize();
+  const int num_tiles = (parallel) ? Apto::Min(num_cols, 4 * Apto::Platform::AvailableCPUs()) : 1;
+  
+  Apto::Array<cAnalyzeDistanceTile*> tiles;
+  for (int t = 0; t < num_tiles; t++) {
+    const int begin = (int)((long long)num_cols * t / num_tiles);
+    const int end = (int)((long long)num_cols * (t + 1) / num_tiles);
+    tiles.Push(new cAnalyzeDistanceTile(genotypes[0], genotypes[1], seqs[0], seqs[1], edit_distance, begin, end));
+  }
+  
+  if (parallel) {
+    tAnalyzeJobBatch<cAnalyzeDistanceTile> jobbatch(m_jobqueue);
+    for (int t = 0; t < tiles.GetSize(); t++) jobbatch.AddJob(tiles[t], &cAnalyzeDistanceTile::Sum);
+    jobbatch.RunBatch();
+  } else {
+    for (int t = 0; t < tiles.GetSize(); t++) tiles[t]->Sum(m_ctx);
+  }
+  
+  double total_count = 0.0;
+  total_dist = 0.0;
+  for (int t = 0; t < tiles.GetSize(); t++) {
+    total_dist += tiles[t]->GetTotalDist();
+    total_count += tiles[t]->GetTotalCount();
+    delete tiles[t];
+  }
+  
+  return total_count;
+}
+
+
 void cAnalyze::CommandHamming(cString cur_string)
 {
   cString filename("hamming.dat");
@@ -7328,45 +7661,8 @@ void cAnalyze::CommandHamming(cString cur_string)
     cout.flush();
   }
   
-  // Setup some variables;
-  cAnalyzeGenotype * genotype1 = NULL;
-  cAnalyzeGenotype * genotype2 = NULL;
-
   double total_dist = 0;
-  double total_count = 0;
-  
-  tListIterator<cAnalyzeGenotype> list1_it(batch[batch1].List());
-  tListIterator<cAnalyzeGenotype> list2_it(batch[batch2].List());
-  
-  while ((genotype1 = list1_it.Next()) != NULL) {
-    list2_it.Reset();
-    while ((genotype2 = list2_it.Next()) != NULL) {
-      // Determine the counts...
-      const int count1 = genotype1->GetNumCPUs();
-      const int count2 = genotype2->GetNumCPUs();
-      const int num_pairs = (genotype1 == genotype2) ?
-        ((count1 - 1) * (count2 - 1)) : (count1 * count2);
-      if (num_pairs == 0) continue;
-      
-      // And do the tests...
-      const Genome& genotype1_genome = genotype1->GetGenome();
-      ConstInstructionSequencePtr genotype1_seq_p;
-      ConstGeneticRepresentationPtr genotype1_rep_p = genotype1_genome.Representation();
-      genotype1_seq_p.DynamicCastFrom(genotype1_rep_p);
-      const InstructionSequence& genotype1_seq = *genotype1_seq_p;
-      
-      const Genome& genotype2_genome = genotype2->GetGenome();
-      ConstInstructionSequencePtr genotype2_seq_p;
-      ConstGeneticRepresentationPtr genotype2_rep_p = genotype2_genome.Representation();
-      genotype2_seq_p.DynamicCastFrom(genotype2_rep_p);
-      const InstructionSequence& genotype2_seq = *genotype2_seq_p;
-
-      const int dist = InstructionSequence::FindHammingDistance(genotype1_seq, genotype2_seq);
-      total_dist += dist * num_pairs;
-      total_count += num_pairs;
-    }
-  }
-  
+  double total_count = SumPairDistances(batch1, batch2, false, total_dist);
   
   // Calculate the final answer
   double ave_dist = (double) total_dist / (double) total_count;
@@ -7406,44 +7702,8 @@ void cAnalyze::CommandLevenstein(cString cur_string)
     cout.flush();
   }
   
-  // Setup some variables;
-  cAnalyzeGenotype * genotype1 = NULL;
-  cAnalyzeGenotype * genotype2 = NULL;
   double total_dist = 0;
-  double total_count = 0;
-  
-  tListIterator<cAnalyzeGenotype> list1_it(batch[batch1].List());
-  tListIterator<cAnalyzeGenotype> list2_it(batch[batch2].List());
-  
-  // Loop through all of the genotypes in each batch...
-  while ((genotype1 = list1_it.Next()) != NULL) {
-    list2_it.Reset();
-    while ((genotype2 = list2_it.Next()) != NULL) {
-      // Determine the counts...
-      const int count1 = genotype1->GetNumCPUs();
-      const int count2 = genotype2->GetNumCPUs();
-      const int num_pairs = (genotype1 == genotype2) ?
-        ((count1 - 1) * (count2 - 1)) : (count1 * count2);
-      if (num_pairs == 0) continue;
-      
-      // And do the tests...
-      const Genome& genotype1_genome = genotype1->GetGenome();
-      ConstInstructionSequencePtr genotype1_seq_p;
-      ConstGeneticRepresentationPtr genotype1_rep_p = genotype1_genome.Representation();
-      genotype1_seq_p.DynamicCastFrom(genotype1_rep_p);
-      const InstructionSequence& genotype1_seq = *genotype1_seq_p;
-
-      const Genome& genotype2_genome = genotype2->GetGenome();
-      ConstInstructionSequencePtr genotype2_seq_p;
-      ConstGeneticRepresentationPtr genotype2_rep_p = genotype2_genome.Representation();
-      genotype2_seq_p.DynamicCastFrom(genotype2_rep_p);
-      const InstructionSequence& genotype2_seq = *genotype2_seq_p;
-
-      const int dist = InstructionSequence::FindEditDistance(genotype1_seq, genotype2_seq);
-      total_dist += dist * num_pairs;
-      total_count += num_pairs;
-    }
-  }
+  double total_count = SumPairDistances(batch1, batch2, true, total_dist);
   
   // Calculate the final answer
   double ave_dist = (double) total_dist / (double) total_count;
@@ -7591,6 +7851,26 @@ void cAnalyze::CommandSpecies(cString cur_string)
   df->Endl();
 }
 
+Genome cAnalyze::Crossover(const Genome& genome0, int start0, int end0, const Genome& genome1, int start1, int end1)
+{
+  ConstInstructionSequencePtr seq0_p;
+  ConstInstructionSequencePtr seq1_p;
+  seq0_p.DynamicCastFrom(genome0.Representation());
+  seq1_p.DynamicCastFrom(genome1.Representation());
+  const InstructionSequence& seq0 = *seq0_p;
+  const InstructionSequence& seq1 = *seq1_p;
+  
+  // Fill the offspring at its final size, rather than cropping and splicing copies of the parents
+  InstructionSequence* child = new InstructionSequence(seq0.GetSize() - (end0 - start0) + (end1 - start1));
+  int pos = 0;
+  for (int i = 0; i < start0; i++) (*child)[pos++] = seq0[i];
+  for (int i = start1; i < end1; i++) (*child)[pos++] = seq1[i];
+  for (int i = end0; i < seq0.GetSize(); i++) (*child)[pos++] = seq0[i];
+  
+  return Genome(genome0.HardwareType(), genome0.Properties(), GeneticRepresentationPtr(child));
+}
+
+
 void cAnalyze::CommandRecombine(cString cur_string)
 {
   int batch1 = PopBatch(cur_string.PopWord());
@@ -7623,39 +7903,36 @@ void cAnalyze::CommandRecombine(cString cur_string)
       
       
       assert(num_compare!=0);
+      const Genome& genome0 = genotype1->GetGenome();
+      const Genome& genome1 = genotype2->GetGenome();
+      ConstInstructionSequencePtr seq0;
+      ConstInstructionSequencePtr seq1;
+      seq0.DynamicCastFrom(genome0.Representation());
+      seq1.DynamicCastFrom(genome1.Representation());
+      const int length0 = seq0->GetSize();
+      const int length1 = seq1->GetSize();
+      
       // And do the tests...
       for (int iter=1; iter < num_compare; iter++) {
-        Genome test_genome0 = genotype1->GetGenome(); 
-        InstructionSequencePtr test_genome0_seq_p;
-        GeneticRepresentationPtr test_genome0_rep_p = test_genome0.Representation();
-        test_genome0_seq_p.DynamicCastFrom(test_genome0_rep_p);
-        InstructionSequence& test_genome0_seq = *test_genome0_seq_p;
-        
-        Genome test_genome1 = genotype2->GetGenome(); 
-        InstructionSequencePtr test_genome1_seq_p;
-        GeneticRepresentationPtr test_genome1_rep_p = test_genome1.Representation();
-        test_genome1_seq_p.DynamicCastFrom(test_genome1_rep_p);
-        InstructionSequence& test_genome1_seq = *test_genome1_seq_p;
-        
         double start_frac = m_world->GetRandom().GetDouble();
         double end_frac = m_world->GetRandom().GetDouble();
         if (start_frac > end_frac) Swap(start_frac, end_frac);
         
-        int start0 = (int) (start_frac * (double) test_genome0_seq.GetSize());
-        int end0   = (int) (end_frac * (double) test_genome0_seq.GetSize());
-        int start1 = (int) (start_frac * (double) test_genome1_seq.GetSize());
-        int end1   = (int) (end_frac * (double) test_genome1_seq.GetSize());
-        assert( start0 >= 0  &&  start0 < test_genome0_seq.GetSize() );
-        assert( end0   >= 0  &&  end0   < test_genome0_seq.GetSize() );
-        assert( start1 >= 0  &&  start1 < test_genome1_seq.GetSize() );
-        assert( end1   >= 0  &&  end1   < test_genome1_seq.GetSize() );
+        int start0 = (int) (start_frac * (double) length0);
+        int end0   = (int) (end_frac * (double) length0);
+        int start1 = (int) (start_frac * (double) length1);
+        int end1   = (int) (end_frac * (double) length1);
+        assert( start0 >= 0  &&  start0 < length0 );
+        assert( end0   >= 0  &&  end0   < length0 );
+        assert( start1 >= 0  &&  start1 < length1 );
+        assert( end1   >= 0  &&  end1   < length1 );
         
         // Calculate size of sections crossing over...    
         int size0 = end0 - start0;
         int size1 = end1 - start1;
         
-        int new_size0 = test_genome0_seq.GetSize() - size0 + size1;   
-        int new_size1 = test_genome1_seq.GetSize() - size1 + size0;
+        int new_size0 = length0 - size0 + size1;   
+        int new_size1 = length1 - size1 + size0;
         
         // Don't Crossover if offspring will be illegal!!!
         if (new_size0 < MIN_GENOME_LENGTH || new_size0 > MAX_GENOME_LENGTH || 
@@ -7664,20 +7941,9 @@ void cAnalyze::CommandRecombine(cString cur_string)
           break; 
         } 
         
-        if (size0 > 0 && size1 > 0) {
-          InstructionSequence cross0 = test_genome0_seq.Crop(start0, end0);
-          InstructionSequence cross1 = test_genome1_seq.Crop(start1, end1);
-          test_genome0_seq.Replace(start0, size0, cross1);
-          test_genome1_seq.Replace(start1, size1, cross0);
-        }
-        else if (size0 > 0) {
-          InstructionSequence cross0 = test_genome0_seq.Crop(start0, end0);
-          test_genome1_seq.Replace(start1, size1, cross0);
-        }
-        else if (size1 > 0) {
-          InstructionSequence cross1 = test_genome1_seq.Crop(start1, end1);
-          test_genome0_seq.Replace(start0, size0, cross1);
-        }
+        // A parent that receives an empty section is passed on unchanged
+        Genome test_genome0 = (size1 > 0) ? Crossover(genome0, start0, end0, genome1, start1, end1) : genome0;
+        Genome test_genome1 = (size0 > 0) ? Crossover(genome1, start1, end1, genome0, start0, end0) : genome1;
         
         cAnalyzeGenotype* new_genotype0 = new cAnalyzeGenotype(m_world, test_genome0); 
         cAnalyzeGenotype* new_genotype1 = new cAnalyzeGenotype(m_world, test_genome1); 
@@ -7730,32 +7996,34 @@ void cAnalyze::CommandRecombineSample(cString cur_string)
     
     int fail_count = 0;
     
-    Genome test_genome0 = genotype1->GetGenome(); 
-    Genome test_genome1 = genotype2->GetGenome(); 
-    InstructionSequencePtr seq0;
-    InstructionSequencePtr seq1;
-    seq0.DynamicCastFrom(test_genome0.Representation());
-    seq1.DynamicCastFrom(test_genome1.Representation());
+    const Genome& genome0 = genotype1->GetGenome();
+    const Genome& genome1 = genotype2->GetGenome();
+    ConstInstructionSequencePtr seq0;
+    ConstInstructionSequencePtr seq1;
+    seq0.DynamicCastFrom(genome0.Representation());
+    seq1.DynamicCastFrom(genome1.Representation());
+    const int length0 = seq0->GetSize();
+    const int length1 = seq1->GetSize();
         
     double start_frac = m_world->GetRandom().GetDouble();
     double end_frac = m_world->GetRandom().GetDouble();
     if (start_frac > end_frac) Swap(start_frac, end_frac);
     
-    int start0 = (int) (start_frac * (double) seq0->GetSize());
-    int end0   = (int) (end_frac * (double) seq0->GetSize());
-    int start1 = (int) (start_frac * (double) seq1->GetSize());
-    int end1   = (int) (end_frac * (double) seq1->GetSize());
-    assert( start0 >= 0  &&  start0 < seq0->GetSize() );
-    assert( end0   >= 0  &&  end0   < seq0->GetSize() );
-    assert( start1 >= 0  &&  start1 < seq1->GetSize() );
-    assert( end1   >= 0  &&  end1   < seq1->GetSize() );
+    int start0 = (int) (start_frac * (double) length0);
+    int end0   = (int) (end_frac * (double) length0);
+    int start1 = (int) (start_frac * (double) length1);
+    int end1   = (int) (end_frac * (double) length1);
+    assert( start0 >= 0  &&  start0 < length0 );
+    assert( end0   >= 0  &&  end0   < length0 );
+    assert( start1 >= 0  &&  start1 < length1 );
+    assert( end1   >= 0  &&  end1   < length1 );
     
     // Calculate size of sections crossing over...    
     int size0 = end0 - start0;
     int size1 = end1 - start1;
     
-    int new_size0 = seq0->GetSize() - size0 + size1;   
-    int new_size1 = seq1->GetSize() - size1 + size0;
+    int new_size0 = length0 - size0 + size1;   
+    int new_size1 = length1 - size1 + size0;
     
     // Don't Crossover if offspring will be illegal!!!
     if (new_size0 < MIN_GENOME_LENGTH || new_size0 > MAX_GENOME_LENGTH || 
@@ -7764,20 +8032,8 @@ void cAnalyze::CommandRecombineSample(cString cur_string)
       break; 
     } 
     
-    if (size0 > 0 && size1 > 0) {
-      InstructionSequence cross0 = seq0->Crop(start0, end0);
-      InstructionSequence cross1 = seq1->Crop(start1, end1);
-      seq0->Replace(start0, size0, cross1);
-      seq1->Replace(start1, size1, cross0);
-    }
-    else if (size0 > 0) {
-      InstructionSequence cross0 = seq0->Crop(start0, end0);
-      seq1->Replace(start1, size1, cross0);
-    }
-    else if (size1 > 0) {
-      InstructionSequence cross1 = seq1->Crop(start1, end1);
-      seq0->Replace(start0, size0, cross1);
-    }
+    // Only the first offspring is kept; it is passed on unchanged if it receives an empty section
+    Genome test_genome0 = (size1 > 0) ? Crossover(genome0, start0, end0, genome1, start1, end1) : genome0;
     
     cAnalyzeGenotype* new_genotype0 = new cAnalyzeGenotype(m_world, test_genome0); 
     //cAnalyzeGenotype* new_genotype1 = new cAnalyzeGenotype(m_world, test_genome1); 
@@ -7825,6 +8081,124 @@ void cAnalyze::CommandMutagenize(cString)
   
 }
 
+// The pairwise stage of CommandAlign: the edit paths from each genotype of a run of the batch to its predecessor,
+// found independently of every other run
+class cAnalyzeAlignPairs
+{
+private:
+  const Apto::Array<cString>& m_seqs;
+  Apto::Array<Apto::Array<char> >& m_paths;
+  int m_begin;
+  int m_end;
+  
+public:
+  cAnalyzeAlignPairs(const Apto::Array<cString>& seqs, Apto::Array<Apto::Array<char> >& paths, int begin, int end)
+    : m_seqs(seqs), m_paths(paths), m_begin(begin), m_end(end) { ; }
+  
+  void Align(cAvidaContext&)
+  {
+    for (int i = m_begin; i < m_end; i++) alignPair(m_seqs[i - 1], m_seqs[i], m_paths[i]);
+  }
+  
+private:
+  // Edit path from prev to cur, one step per column: 'M' pairs a site of each (match or mutation), 'I' is a site only
+  // in cur, 'D' a site only in prev.  The band starts narrow and doubles until it holds a path no longer than itself,
+  // which is then an optimal one; lineage neighbors rarely differ by more than a handful of sites.
+  static void alignPair(const cString& prev, const cString& cur, Apto::Array<char>& path)
+  {
+    const int prev_size = prev.GetSize();
+    const int cur_size = cur.GetSize();
+    const int max_size = Apto::Max(prev_size, cur_size);
+    
+    Apto::Array<char> trace;
+    int band = Apto::Max(abs(cur_size - prev_size), 8);
+    while (true) {
+      const int dist = alignBand(prev, cur, band, trace);
+      if (dist <= band || band >= max_size) break;
+      band = Apto::Min(band * 2, max_size);
+    }
+    
+    // Walk the trace back from the corner, then lay the steps out front to back
+    const int width = 2 * band + 1;
+    Apto::Array<char> steps;
+    int i = prev_size;
+    int j = cur_size;
+    while (i > 0 || j > 0) {
+      const char step = trace[i * width + (j - i + band)];
+      if (step == 'D') { steps.Push('D'); i--; }
+      else if (step == 'I') { steps.Push('I'); j--; }
+      else { steps.Push('M'); i--; j--; }
+    }
+    path.Resize(steps.GetSize());
+    for (int k = 0; k < steps.GetSize(); k++) path[k] = steps[steps.GetSize() - 1 - k];
+  }
+  
+  // Edit distance DP over the cells within band of the main diagonal (prev down, cur across), with the choices of
+  // cStringUtil::EditDistance; trace receives the step into each cell, row by row, 2 * band + 1 cells per row
+  static int alignBand(const cString& prev, const cString& cur, int band, Apto::Array<char>& trace)
+  {
+    const int prev_size = prev.GetSize();
+    const int cur_size = cur.GetSize();
+    const int width = 2 * band + 1;
+    const int unreachable = prev_size + cur_size + 1;
+    
+    trace.Resize((prev_size + 1) * width);
+    Apto::Array<int> rows(2 * width);
+    int* last_row = &rows[0];
+    int* row = &rows[width];
+    
+    for (int k = 0; k < width; k++) {
+      const int j = k - band;
+      last_row[k] = (j < 0 || j > cur_size) ? unreachable : j;
+      trace[k] = (j == 0) ? 'N' : 'I';
+    }
+    
+    for (int i = 1; i <= prev_size; i++) {
+      char* trace_row = &trace[i * width];
+      for (int k = 0; k < width; k++) {
+        const int j = i + k - band;
+        if (j < 0 || j > cur_size) {
+          row[k] = unreachable;
+          continue;
+        }
+        if (j == 0) {
+          row[k] = i;
+          trace_row[k] = 'D';
+          continue;
+        }
+        
+        // Same site in both, keep the distance through the diagonal
+        if (prev[i - 1] == cur[j - 1]) {
+          row[k] = last_row[k];
+          trace_row[k] = 'N';
+          continue;
+        }
+        
+        const int mut_dist = last_row[k] + 1;
+        const int ins_dist = ((k > 0) ? row[k - 1] : unreachable) + 1;
+        const int del_dist = ((k + 1 < width) ? last_row[k + 1] : unreachable) + 1;
+        
+        if (mut_dist < ins_dist && mut_dist < del_dist) {
+          row[k] = mut_dist;
+          trace_row[k] = 'M';
+        } else if (ins_dist < del_dist) {
+          row[k] = ins_dist;
+          trace_row[k] = 'I';
+        } else {
+          row[k] = del_dist;
+          trace_row[k] = 'D';
+        }
+      }
+      int* done_row = row;
+      row = last_row;
+      last_row = done_row;
+    }
+    
+    return last_row[cur_size - prev_size + band];
+  }
+};
+
+
 void cAnalyze::CommandAlign(cString cur_string)
 {
   // Align does not need any args yet.
@@ -7837,67 +8211,98 @@ void cAnalyze::CommandAlign(cString cur_string)
     << endl;
   }
   
-  // Create an array of all the sequences we need to align.
+  // Collect all the sequences we need to align.
   tListPlus<cAnalyzeGenotype> & glist = batch[cur_batch].List();
   tListIterator<cAnalyzeGenotype> batch_it(glist);
   const int num_sequences = glist.GetSize();
-  cString * sequences = new cString[num_sequences];
+  Apto::Array<cString> sequences(num_sequences);
   
-  // Move through each sequence and update it.
   batch_it.Reset();
-  cString diff_info;
   for (int i = 0; i < num_sequences; i++) {
     const Genome& batch_genome = batch_it.Next()->GetGenome();
     ConstInstructionSequencePtr batch_seq_p;
     ConstGeneticRepresentationPtr batch_rep_p = batch_genome.Representation();
     batch_seq_p.DynamicCastFrom(batch_rep_p);
-    const InstructionSequence& batch_it_seq = *batch_seq_p;
-    
-    sequences[i] = batch_it_seq.AsString();
-    if (i == 0) continue;
-    // Track of the number of insertions and deletions to shift properly.
-    int num_ins = 0;
-    int num_del = 0;
-    
-    // Compare each string to the previous.
-    cStringUtil::EditDistance(sequences[i], sequences[i-1], diff_info, '_');
-    
-    while (diff_info.GetSize() != 0) {
-      cString cur_mut = diff_info.Pop(',');
-      const char mut_type = cur_mut[0];
-      cur_mut.ClipFront(1); cur_mut.ClipEnd(1);
-      int position = cur_mut.AsInt();
-      
-      // Nothing to do with Mutations
-      if (mut_type == 'M') continue;
-      
-      // Handle insertions...
-      if (mut_type == 'I') {
-        // Loop back and insert an '_' into all previous sequences.
-        for (int j = 0; j < i; j++) {
-          sequences[j].Insert('_', position + num_del);
-        }
-        num_ins++;
+    sequences[i] = batch_seq_p->AsString();
+  }
+  
+  // The guide tree is the lineage itself: every sequence is aligned to its predecessor.  Those pairwise alignments
+  // only need the raw sequences, so they run side by side on the analyze threads.
+  Apto::Array<Apto::Array<char> > paths(num_sequences);
+  const bool parallel = m_world->GetConfig().PARALLEL_ANALYZE.Get();
+  const int num_runs = (parallel) ? Apto::Min(num_sequences, 4 * Apto::Platform::AvailableCPUs()) : 1;
+  
+  Apto::Array<cAnalyzeAlignPairs*> runs;
+  for (int r = 0; r < num_runs; r++) {
+    const int begin = Apto::Max((int)((long long)num_sequences * r / num_runs), 1);
+    const int end = (int)((long long)num_sequences * (r + 1) / num_runs);
+    if (begin < end) runs.Push(new cAnalyzeAlignPairs(sequences, paths, begin, end));
+  }
+  
+  if (parallel) {
+    tAnalyzeJobBatch<cAnalyzeAlignPairs> jobbatch(m_jobqueue);
+    for (int r = 0; r < runs.GetSize(); r++) jobbatch.AddJob(runs[r], &cAnalyzeAlignPairs::Align);
+    jobbatch.RunBatch();
+  } else {
+    for (int r = 0; r < runs.GetSize(); r++) runs[r]->Align(m_ctx);
+  }
+  for (int r = 0; r < runs.GetSize(); r++) delete runs[r];
+  
+  // Merge the pairs front to back into one list of alignment columns (column 0 is the head of the list).  Each site
+  // takes the column of the site it pairs with in its predecessor; a site of its own goes into the next column when
+  // the predecessor has a gap there, and otherwise into a new column, so no earlier sequence is ever rewritten.
+  Apto::Array<int, Apto::Smart> col_next;
+  Apto::Array<int, Apto::Smart> col_last_seq;   // last sequence with a site in the column
+  col_next.Push(-1);
+  col_last_seq.Push(-1);
+  Apto::Array<Apto::Array<int> > site_cols(num_sequences);
+  
+  for (int i = 0; i < num_sequences; i++) {
+    const cString& seq = sequences[i];
+    Apto::Array<int>& cols = site_cols[i];
+    cols.Resize(seq.GetSize());
+    
+    int prev_site = 0;
+    int site = 0;
+    int last_col = 0;
+    const int num_steps = (i == 0) ? seq.GetSize() : paths[i].GetSize();
+    for (int s = 0; s < num_steps; s++) {
+      const char step = (i == 0) ? 'I' : paths[i][s];
+      if (step == 'D') {
+        last_col = site_cols[i - 1][prev_site++];
+        continue;
       }
       
-      // Handle Deletions...
-      else if (mut_type == 'D') {
-        // Insert '_' into the current sequence at the point of deletions.
-        sequences[i].Insert("_", position + num_ins);
-        num_del++;
+      int col = -1;
+      if (step == 'M') {
+        col = site_cols[i - 1][prev_site++];
+      } else if (col_next[last_col] != -1 && col_last_seq[col_next[last_col]] != i - 1) {
+        col = col_next[last_col];
+      } else {
+        col = col_next.GetSize();
+        col_next.Push(col_next[last_col]);
+        col_last_seq.Push(-1);
+        col_next[last_col] = col;
       }
       
+      cols[site++] = col;
+      col_last_seq[col] = i;
+      last_col = col;
     }
   }
   
+  // Number the columns in order and lay every sequence out across them
+  Apto::Array<int> col_index(col_next.GetSize());
+  int num_cols = 0;
+  for (int col = col_next[0]; col != -1; col = col_next[col]) col_index[col] = num_cols++;
+  
   batch_it.Reset();
   for (int i = 0; i < num_sequences; i++) {
-    batch_it.Next()->SetAlignedSequence(sequences[i]);
+    std::string aligned(num_cols, '_');
+    for (int site = 0; site < sequences[i].GetSize(); site++) aligned[col_index[site_cols[i][site]]] = sequences[i][site];
+    batch_it.Next()->SetAlignedSequence(cString(aligned.c_str(), num_cols));
   }
   
-  // Cleanup
-  delete [] sequences;
-  
   // Adjust the flags on this batch
   // batch[cur_batch].SetLineage(false);
   batch[cur_batch].SetAligned(true);
@@ -8785,6 +9190,67 @@ void cAnalyze::AnalyzeMutationTraceback(cString cur_string)
   delete testcpu;
 }
 
+// Follows consecutive genotypes of a lineage scan, to decide which of the previous genotype's mutant tests carry over
+// to the next one.  The mutants at a set of sites of the two genotypes differ only at the other sites where the
+// genotypes themselves differ, so they are the same genomes when those are all mutated sites.  Differing sites that
+// neither genotype executed are taken to stay outside the mutant's influence too, the approximation this mode trades
+// for skipping their retests.
+class cAnalyzeLineageSites
+{
+private:
+  Apto::Array<int> m_prev_ops;
+  Apto::String m_prev_instset;
+  cString m_prev_flags;
+  Apto::Array<int> m_changed;   // sites at which the current genotype differs from the previous one
+  Apto::Array<bool> m_quiet;    // changed sites executed by neither genotype
+  bool m_comparable;
+  
+public:
+  cAnalyzeLineageSites() : m_comparable(false) { ; }
+  
+  // Compare the genotype with the previous one advanced to, and make it the previous one
+  void Advance(const Genome& genome, const cString& executed_flags)
+  {
+    ConstInstructionSequencePtr seq_p;
+    ConstGeneticRepresentationPtr rep_p = genome.Representation();
+    seq_p.DynamicCastFrom(rep_p);
+    const InstructionSequence& seq = *seq_p;
+    const Apto::String instset = genome.Properties().Get("instset").StringValue();
+    
+    m_comparable = (m_prev_ops.GetSize() == seq.GetSize() && m_prev_instset == instset);
+    const bool traced = (m_prev_flags.GetSize() == seq.GetSize() && executed_flags.GetSize() == seq.GetSize());
+    m_changed.Resize(0);
+    m_quiet.Resize(0);
+    if (m_comparable) {
+      for (int i = 0; i < seq.GetSize(); i++) {
+        if (seq[i].GetOp() == m_prev_ops[i]) continue;
+        m_changed.Push(i);
+        m_quiet.Push(traced && m_prev_flags[i] == '-' && executed_flags[i] == '-');
+      }
+    }
+    
+    m_prev_ops.Resize(seq.GetSize());
+    for (int i = 0; i < seq.GetSize(); i++) m_prev_ops[i] = seq[i].GetOp();
+    m_prev_instset = instset;
+    m_prev_flags = executed_flags;
+  }
+  
+  bool IsComparable() const { return m_comparable; }
+  int GetNumChanged() const { return m_changed.GetSize(); }
+  
+  // Can the mutants at site1 (and site2, if not -1) be taken from the previous genotype?
+  bool CanReuse(int site1, int site2 = -1) const
+  {
+    if (!m_comparable) return false;
+    for (int i = 0; i < m_changed.GetSize(); i++) {
+      if (m_changed[i] == site1 || m_changed[i] == site2) continue;
+      if (!m_quiet[i]) return false;
+    }
+    return true;
+  }
+};
+
+
 void cAnalyze::AnalyzeComplexity(cString cur_string)
 {
   cout << "Analyzing genome complexity..." << endl;
@@ -8817,13 +9283,22 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
   // amount ahead in the batch.  It defaults to 1, so that default analyzes
   // all the organisms in the batch.  It is always the 4th arg.
   int batchFrequency = 1;
-  if(words == 4) {
+  if(words >= 4) {
     batchFrequency = cur_string.PopWord().AsInt();
     if(batchFrequency <= 0) {
       batchFrequency = 1;
     }
   }
   
+  // Lineage reuse is the optional 5th arg.  When it is non-zero, the mutant tests of each analyzed genotype are
+  // carried over from the previous one wherever cAnalyzeLineageSites allows, and only the other lines are retested.
+  bool reuseLineage = false;
+  if(words >= 5) {
+    reuseLineage = (cur_string.PopWord().AsInt() != 0);
+  }
+  cAnalyzeLineageSites lineage_sites;
+  Apto::Array<Apto::Array<double> > prev_line_fitness;
+  
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(m_ctx);
   
   ///////////////////////////////////////////////////////
@@ -8841,6 +9316,10 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
   Avida::Output::FilePtr lineage_df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)lineage_filename);
   ofstream& lineage_fp = lineage_df->OFStream();
   
+  cCPUTestInfo batch_test_info;
+  batch_test_info.SetResourceOptions(useResources, m_resources, -1, m_resource_time_spent_offset);
+  const bool recalculated = ParallelRecalculate(batch_test_info, 1, true, batchFrequency);
+  
   while ((genotype = batch_it.Next()) != NULL) {
     if (m_world->GetVerbosity() >= VERBOSE_ON) {
       cout << "  Analyzing complexity for " << genotype->GetName() << endl;
@@ -8860,7 +9339,7 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
     test_info.SetResourceOptions(useResources, m_resources, updateBorn, m_resource_time_spent_offset);
     
     // Calculate the stats for the genotype we're working with ...
-    genotype->Recalculate(m_ctx, &test_info);
+    if (!recalculated) genotype->Recalculate(m_ctx, &test_info);
     cout << genotype->GetFitness() << endl;
     const int max_line = genotype->GetLength();
 
@@ -8878,6 +9357,10 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
     
     const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
     
+    if (reuseLineage) lineage_sites.Advance(base_genome, genotype->GetExecutedFlags());
+    Apto::Array<Apto::Array<double> > line_fitness(max_line);
+    int lines_reused = 0;
+    
     // Loop through all the lines of code, testing all mutations...
     Apto::Array<double> test_fitness(num_insts);
     Apto::Array<double> prob(num_insts);
@@ -8887,13 +9370,22 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
       // Column 1 ... the original instruction in the genome.
       fp << cur_inst << " ";
       
-      // Test fitness of each mutant.
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-        seq[line_num].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
-        test_fitness[mod_inst] = test_genotype.GetFitness();
+      // Test fitness of each mutant, unless the previous genotype's tests of this line still hold.
+      if (reuseLineage && lineage_sites.CanReuse(line_num)) {
+        test_fitness = prev_line_fitness[line_num];
+        lines_reused++;
+      } else {
+        for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+          seq[line_num].SetOp(mod_inst);
+          cAnalyzeGenotype test_genotype(m_world, mod_genome);
+          test_genotype.Recalculate(m_ctx);
+          test_fitness[mod_inst] = test_genotype.GetFitness();
+        }
+        
+        // Reset the mod_genome back to the original sequence.
+        seq[line_num].SetOp(cur_inst);
       }
+      line_fitness[line_num] = test_fitness;
       
       // Ajust fitness
       double cur_inst_fitness = test_fitness[cur_inst];
@@ -8949,11 +9441,15 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
       fp << complexity << endl;
       
       lineage_fp << complexity << " ";
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     }
     
+    if (reuseLineage) {
+      prev_line_fitness = line_fitness;
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "  Reused mutant tests at " << lines_reused << " of " << max_line << " lines ("
+             << lineage_sites.GetNumChanged() << " changed sites)" << endl;
+      }
+    }
     
     lineage_fp << endl;
     
@@ -9121,6 +9617,7 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
    * Arguments:
    * 1) N-mutant (default: 2)
    * 2) directory
+   * 3) reuse lineage (default: 0 -- retest every genotype in full)
    */
 
   // number of arguments provided
@@ -9160,6 +9657,23 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
     cout << "  - Analysis results to directory: " << directory << endl;
   }
 
+  //
+  // argument 3 -- reuse lineage
+  //   - carry the mutant counts at each site (or pair of sites) over from the previous genotype wherever
+  //     cAnalyzeLineageSites allows and the two genotypes have the same fitness, retesting only the rest
+  //
+  bool reuse_lineage = false;
+  if (words >= 3) {
+    reuse_lineage = (cur_string.PopWord().AsInt() != 0);
+  }
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "  - Reuse lineage set to: " << reuse_lineage << endl;
+  }
+  cAnalyzeLineageSites lineage_sites;
+  double prev_fitness = 0.0;
+  Apto::Array<int> prev_posneut_counts;
+  Apto::Array<int> prev_pos_counts;
+
   // test cpu
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(m_ctx);
 
@@ -9197,6 +9711,16 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
     int posneutmut = 0; //number of positive and nuetral mutations
     int posmut = 0;
 
+    // Mutant counts at each site (n = 1) or pair of sites (n = 2, indexed gene_num1 * gen_length + gene_num2), kept
+    // for the next genotype when reusing the lineage
+    if (reuse_lineage) lineage_sites.Advance(base_genome, genotype->GetExecutedFlags());
+    const bool can_reuse = reuse_lineage && lineage_sites.IsComparable() && gen_fitness == prev_fitness;
+    const int num_units = (n == 1) ? gen_length : ((n == 2) ? gen_length * gen_length : 0);
+    Apto::Array<int> posneut_counts(num_units);
+    Apto::Array<int> pos_counts(num_units);
+    posneut_counts.SetAll(0);
+    pos_counts.SetAll(0);
+
     cout << "The base genome fitness is: " << gen_fitness << endl;
 
     /*
@@ -9208,6 +9732,15 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
     // run through each gene in genome
     if( n ==  1 ) {
       for (int gene_num = 0; gene_num < gen_length; gene_num++) {
+        // take the counts from the previous genotype if its mutants at this site still hold
+        if (can_reuse && lineage_sites.CanReuse(gene_num)) {
+          posneut_counts[gene_num] = prev_posneut_counts[gene_num];
+          pos_counts[gene_num] = prev_pos_counts[gene_num];
+          posneutmut += posneut_counts[gene_num];
+          posmut += pos_counts[gene_num];
+          continue;
+        }
+
         // get the current instruction at this line/site
         int cur_inst = (*base_seq)[gene_num].GetOp();
 
@@ -9223,14 +9756,16 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
             cout << "Mod Fitness: " << mod_fitness << endl;
             if (mod_fitness >= gen_fitness) {
               //cout << "Mutant has better fitness" << endl;
-              posneutmut += 1;
+              posneut_counts[gene_num] += 1;
             }
             if (mod_fitness > gen_fitness) {
-              posmut +=1;
+              pos_counts[gene_num] +=1;
             }
           }
         }
         (*seq_p)[gene_num].SetOp(cur_inst);
+        posneutmut += posneut_counts[gene_num];
+        posmut += pos_counts[gene_num];
       }
     }
     /*
@@ -9246,6 +9781,16 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
       for (int gene_num1 = 0; gene_num1 < (gen_length-1); gene_num1++) {
         for (int gene_num2 = gene_num1+1; gene_num2 < gen_length; gene_num2++) {
           //cout << "line #1, #2: " << gene_num1 << ", " << gene_num2 << endl;
+          const int pair = gene_num1 * gen_length + gene_num2;
+
+          // take the counts from the previous genotype if its mutants at these sites still hold
+          if (can_reuse && lineage_sites.CanReuse(gene_num1, gene_num2)) {
+            posneut_counts[pair] = prev_posneut_counts[pair];
+            pos_counts[pair] = prev_pos_counts[pair];
+            posneutmut += posneut_counts[pair];
+            posmut += pos_counts[pair];
+            continue;
+          }
 
           // get current instructions at site 1 and site 2
           int cur_inst1 = (*base_seq)[gene_num1].GetOp();
@@ -9263,15 +9808,17 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
               double mod_fitness = test_genotype.GetFitness();
               //cout << "Mutant Fitness: " << mod_fitness << endl;
               if (mod_fitness >= gen_fitness) {
-                posneutmut += 1;
+                posneut_counts[pair] += 1;
               }
               if (mod_fitness > gen_fitness) {
-                posmut += 1;
+                pos_counts[pair] += 1;
               }
             }
           }
           (*seq_p)[gene_num1].SetOp(cur_inst1);
           (*seq_p)[gene_num2].SetOp(cur_inst2);
+          posneutmut += posneut_counts[pair];
+          posmut += pos_counts[pair];
         }
       }
     }
@@ -9280,6 +9827,12 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
         //TODO
     }
 
+    if (reuse_lineage) {
+      prev_fitness = gen_fitness;
+      prev_posneut_counts = posneut_counts;
+      prev_pos_counts = pos_counts;
+    }
+
     //cout << "Genome Length: " << gen_length << endl;
     //cout << "Postive & Neutral Mutations: " << posneutmut << endl;
     
@@ -10151,6 +10704,7 @@ void cAnalyze::ConfigSet(cString cur_string)
     cerr << "Error: Configuration Variable '" << cvar << "' was not found." << endl;
     return;
   }
+  m_world->RefreshRuntimeConfig();
   
   if (m_world->GetVerbosity() >= VERBOSE_ON)
     cout << "Setting configuration variable " << cvar << " to " << val << endl;
@@ -10232,6 +10786,21 @@ void cAnalyze::BatchPurge(cString cur_string)
   batch[batch_id].SetAligned(false);
 }
 
+void cAnalyze::BatchCompact(cString cur_string)
+{
+  int batch_id = cur_batch;
+  if (cur_string.CountNumWords() > 0) batch_id = cur_string.PopWord().AsInt();
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "Compacting batch " << batch_id << endl;
+  
+  batch[batch_id].Compact(m_world);
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "  " << batch[batch_id].GetSize() << " genotypes in "
+    << batch[batch_id].GetColumns()->GetMemoryUsed() << " bytes of column storage" << endl;
+  }
+}
+
 void cAnalyze::BatchDuplicate(cString cur_string)
 {
   if (cur_string.GetSize() == 0) {
@@ -10258,6 +10827,46 @@ void cAnalyze::BatchDuplicate(cString cur_string)
   batch[batch_to].SetAligned(false);
 }
 
+class cAnalyzeRecalculateJob : public cAnalyzeJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  cCPUTestInfo m_test_info;
+  int m_num_trials;
+
+public:
+  cAnalyzeRecalculateJob(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info, int num_trials)
+    : m_genotype(genotype), m_test_info(test_info), m_num_trials(num_trials) { ; }
+  
+  cCPUTestInfo& TestInfo() { return m_test_info; }
+  
+  void Run(cAvidaContext& ctx) { m_genotype->Recalculate(ctx, &m_test_info, NULL, m_num_trials); }
+};
+
+
+bool cAnalyze::ParallelRecalculate(cGenotypeBatch& target, const cCPUTestInfo& test_info, int num_trials,
+                                   bool use_update_born, int frequency)
+{
+  if (!m_world->GetConfig().PARALLEL_ANALYZE.Get()) return false;
+  
+  // Every recalculation gets its own copy of the test info, so that the workers never share test state
+  Apto::Array<cAnalyzeJob*> jobs;
+  tListIterator<cAnalyzeGenotype> batch_it(target.List());
+  cAnalyzeGenotype* genotype = batch_it.Next();
+  while (genotype != NULL) {
+    cAnalyzeRecalculateJob* job = new cAnalyzeRecalculateJob(genotype, test_info, num_trials);
+    if (use_update_born) job->TestInfo().SetResourceUpdate(genotype->GetUpdateBorn());
+    jobs.Push(job);
+    for (int count = 0; genotype != NULL && count < frequency; count++) genotype = batch_it.Next();
+  }
+  
+  m_jobqueue.AddJobs(jobs);
+  m_jobqueue.Execute();
+  
+  return true;
+}
+
+
 void cAnalyze::BatchRecalculate(cString cur_string)
 {
   Apto::Array<int> manual_inputs;  // Used only if manual inputs are specified
@@ -10303,21 +10912,31 @@ void cAnalyze::BatchRecalculate(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  RecalculateBatch(batch[cur_batch], test_info);
+}
+
+
+void cAnalyze::RecalculateBatch(cGenotypeBatch& target, const cCPUTestInfo& test_info)
+{
+  // The test CPU runs are independent, so they may all be done up front; parent stats depend on
+  // the parent having been recalculated first, so they are always filled in by the serial pass
+  const bool recalculated = ParallelRecalculate(target, test_info);
+  
+  cCPUTestInfo serial_test_info(test_info);
+  tListIterator<cAnalyzeGenotype> batch_it(target.List());
   cAnalyzeGenotype * genotype = NULL;
   cAnalyzeGenotype * last_genotype = NULL;
   while ((genotype = batch_it.Next()) != NULL) {    
     // If the previous genotype was the parent of this one, pass in a pointer
     // to it for improved recalculate (such as distance to parent, etc.)
     if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info);
+      if (recalculated) genotype->RecalculateParentStats(last_genotype);
+      else genotype->Recalculate(m_ctx, &serial_test_info, last_genotype);
+    } else if (!recalculated) {
+      genotype->Recalculate(m_ctx, &serial_test_info);
     }
     last_genotype = genotype;
   }
-    
-  return;
 }
 
 
@@ -10396,6 +11015,10 @@ void cAnalyze::BatchRecalculateWithArgs(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
+  // The test CPU runs are independent, so they may all be done up front; parent stats depend on
+  // the parent having been recalculated first, so they are always filled in by the serial pass
+  const bool recalculated = ParallelRecalculate(test_info, num_trials);
+  
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * genotype = NULL;
   cAnalyzeGenotype * last_genotype = NULL;
@@ -10403,8 +11026,9 @@ void cAnalyze::BatchRecalculateWithArgs(cString cur_string)
     // If the previous genotype was the parent of this one, pass in a pointer
     // to it for improved recalculate (such as distance to parent, etc.)
     if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype, num_trials);
-    } else {
+      if (recalculated) genotype->RecalculateParentStats(last_genotype);
+      else genotype->Recalculate(m_ctx, &test_info, last_genotype, num_trials);
+    } else if (!recalculated) {
       genotype->Recalculate(m_ctx, &test_info, NULL, num_trials);
     }
     last_genotype = genotype;
@@ -11206,6 +11830,7 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("LOAD_SEQUENCE", &cAnalyze::LoadSequence);
   AddLibraryDef("LOAD_RESOURCES", &cAnalyze::LoadResources);
   AddLibraryDef("LOAD", &cAnalyze::LoadFile);
+  AddLibraryDef("LOAD_STREAM", &cAnalyze::LoadFileStream);
   
   // Reduction and sampling commands...
   AddLibraryDef("FILTER", &cAnalyze::CommandFilter);
@@ -11225,6 +11850,7 @@ void cAnalyze::SetupCommandDefLibrary()
   // Direct output commands...
   AddLibraryDef("PRINT", &cAnalyze::CommandPrint);
   AddLibraryDef("TRACE", &cAnalyze::CommandTrace);
+  AddLibraryDef("DECODE_TRACE", &cAnalyze::CommandDecodeTrace);
   AddLibraryDef("PRINT_TASKS", &cAnalyze::CommandPrintTasks);
   AddLibraryDef("PRINT_TASKS_QUALITY", &cAnalyze::CommandPrintTasksQuality);
   AddLibraryDef("DETAIL", &cAnalyze::CommandDetail);
@@ -11308,6 +11934,7 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("NAME_BATCH", &cAnalyze::BatchName);
   AddLibraryDef("TAG_BATCH", &cAnalyze::BatchTag);
   AddLibraryDef("PURGE_BATCH", &cAnalyze::BatchPurge);
+  AddLibraryDef("COMPACT_BATCH", &cAnalyze::BatchCompact);
   AddLibraryDef("DUPLICATE", &cAnalyze::BatchDuplicate);
   AddLibraryDef("RECALCULATE", &cAnalyze::BatchRecalculate);
   AddLibraryDef("RECALC", &cAnalyze::BatchRecalculateWithArgs);
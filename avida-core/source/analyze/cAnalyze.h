@@ -24,6 +24,8 @@
 #define cAnalyze_h
 
 #include "apto/rng.h"
+#include "avida/core/Types.h"
+#include "avida/output/Types.h"
 
 #include <iostream>
 #include <vector>
@@ -48,7 +50,9 @@ class cAnalyzeCommand;
 class cAnalyzeCommandDefBase;
 class cAnalyzeFunction;
 class cAnalyzeGenotype;
+class cAnalyzeKnockoutJob;
 class cAnalyzeScreen;
+class cAnalyzeSiteMutants;
 class cCPUTestInfo;
 class cEnvironment;
 class cInitFile;
@@ -145,6 +149,9 @@ public:
   
   void AlignCurrentBatch() { CommandAlign(""); }
   
+  // Run every genotype of target through the test CPUs, as RECALC does for the current batch
+  void RecalculateBatch(cGenotypeBatch& target, const cCPUTestInfo& test_info);
+  
   static void PopCommonCPUTestParameters(cWorld* in_world, cString& cur_string, cCPUTestInfo& test_info,
     cResourceHistory* in_resource_history = NULL, int in_resource_time_spent_offset = 0);
     
@@ -172,6 +179,33 @@ private:
   void PreProcessArgs(cString& args);
   void ProcessCommands(tList<cAnalyzeCommand>& clist);
   
+  // Recalculate a batch on the job queue (when PARALLEL_ANALYZE is set), returns false if not done
+  bool ParallelRecalculate(cGenotypeBatch& target, const cCPUTestInfo& test_info, int num_trials = 1,
+                           bool use_update_born = false, int frequency = 1);
+  bool ParallelRecalculate(const cCPUTestInfo& test_info, int num_trials = 1, bool use_update_born = false, int frequency = 1)
+    { return ParallelRecalculate(batch[cur_batch], test_info, num_trials, use_update_born, frequency); }
+  
+  // Sum a genome distance (Hamming or edit) over every pair of organisms drawn from two batches, tiled over the job
+  // queue when PARALLEL_ANALYZE is set, returning the number of pairs
+  double SumPairDistances(int batch1, int batch2, bool edit_distance, double& total_dist);
+  
+  // Test the fitness of base_genome with each instruction of site_ops[line] substituted in at that line, one job per
+  // line on the job queue when PARALLEL_ANALYZE is set; fitness[line][i] receives the result for site_ops[line][i]
+  void TestSiteMutants(const Avida::Genome& base_genome, const cCPUTestInfo& test_info,
+                       const Apto::Array<Apto::Array<int> >& site_ops, Apto::Array<Apto::Array<double> >& fitness);
+  // As above, but keeping each recalculated mutant in mutants[line][i] (owned by the caller) instead of its fitness
+  void TestSiteMutants(const Avida::Genome& base_genome, const cCPUTestInfo& test_info,
+                       const Apto::Array<Apto::Array<int> >& site_ops,
+                       Apto::Array<Apto::Array<cAnalyzeGenotype*> >& mutants);
+  void RunSiteMutants(Apto::Array<cAnalyzeSiteMutants*>& sites);
+  
+  // Build a copy of genome0 with its section [start0, end0) replaced by the section [start1, end1) of genome1
+  Avida::Genome Crossover(const Avida::Genome& genome0, int start0, int end0,
+                          const Avida::Genome& genome1, int start1, int end1);
+  
+  // Test each knockout batch, on the job queue when parallel
+  void RunKnockoutJobs(Apto::Array<cAnalyzeKnockoutJob*>& jobs, bool parallel);
+  
   // Helper functions for printing to HTML files...
   void HTMLPrintStat(const cFlexVar& value, std::ostream& fp, int compare=0,
                      const cString& cell_flags="align=center", const cString& null_text = "0", bool print_text = true);
@@ -193,6 +227,7 @@ private:
   void CommandDetail_Body(std::ostream& fp, int format_type,
                           tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it,
                           int time_step = -1, int max_time = 1);
+  void CommandDetail_Columns(Avida::Output::File& df, tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it);
   void CommandDetailAverage_Body(std::ostream& fp, int num_arguments,
                                  tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it);
   void CommandHistogram_Header(std::ostream& fp, int format_type,
@@ -208,10 +243,13 @@ private:
   // from a file specified by the user, or resource.dat by default.
   void LoadResources(cString cur_string);
   void LoadFile(cString cur_string);
+  // Loads a genotype file a chunk at a time, keeping only the records that pass the given filters
+  void LoadFileStream(cString cur_string);
   genotype_vector LoadDetailFileAsVector(cString cur_string); 
   //Loads all sequences from a detail file into a vector
   
   // Reduction and Sampling
+  bool ParseFilterRelation(const cString& relation, Apto::Array<bool>& rel_ok);
   void CommandFilter(cString cur_string);
   void FindGenotype(cString cur_string);
   void FindOrganism(cString cur_string);
@@ -229,6 +267,7 @@ private:
   void CommandPrint(cString cur_string);
   void CommandTrace(cString cur_string);
   void CommandTraceWithResources(cString cur_string);
+  void CommandDecodeTrace(cString cur_string);
   void CommandPrintTasks(cString cur_string);
   void CommandPrintTasksQuality(cString cur_string);
   void CommandDetail(cString cur_string);
@@ -322,6 +361,7 @@ private:
   void BatchName(cString cur_string);
   void BatchTag(cString cur_string);
   void BatchPurge(cString cur_string);
+  void BatchCompact(cString cur_string);
   void BatchDuplicate(cString cur_string);
   void BatchRecalculate(cString cur_string);
   void BatchRecalculateWithArgs(cString cur_string);
@@ -599,25 +599,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
 
   
   // Setup a new parent stats if we have a parent to work with.
-  if (parent_genotype != NULL) {
-    fitness_ratio = GetFitness() / parent_genotype->GetFitness();
-    efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
-    comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
-    ConstInstructionSequencePtr seq_p;
-    GeneticRepresentationPtr rep_p = m_genome.Representation();
-    seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& seq = *seq_p;
-    
-    const Genome& parent_genome = parent_genotype->GetGenome();
-    ConstInstructionSequencePtr parent_seq_p;
-    ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
-    parent_seq_p.DynamicCastFrom(parent_rep_p);
-    const InstructionSequence& parent_seq = *parent_seq_p;
-    
-    parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
-    
-    ancestor_dist = parent_genotype->GetAncestorDist() + parent_dist;
-  }
+  if (parent_genotype != NULL) RecalculateParentStats(parent_genotype);
   
   // Summarize plasticity information if multiple recalculations performed
   if (num_trials > 1){
@@ -630,6 +612,29 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
 }
 
 
+void cAnalyzeGenotype::RecalculateParentStats(cAnalyzeGenotype* parent_genotype)
+{
+  assert(parent_genotype != NULL);
+  fitness_ratio = GetFitness() / parent_genotype->GetFitness();
+  efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
+  comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
+  ConstInstructionSequencePtr seq_p;
+  GeneticRepresentationPtr rep_p = m_genome.Representation();
+  seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& seq = *seq_p;
+  
+  const Genome& parent_genome = parent_genotype->GetGenome();
+  ConstInstructionSequencePtr parent_seq_p;
+  ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
+  parent_seq_p.DynamicCastFrom(parent_rep_p);
+  const InstructionSequence& parent_seq = *parent_seq_p;
+  
+  parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
+  
+  ancestor_dist = parent_genotype->GetAncestorDist() + parent_dist;
+}
+
+
 void cAnalyzeGenotype::PrintTasks(ofstream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = task_counts.GetSize();
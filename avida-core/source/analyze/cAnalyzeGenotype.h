@@ -73,6 +73,7 @@ public:
 class cAnalyzeGenotype
 {
   friend class ReadToken;
+  friend class cGenotypeColumns;
 private:
   cWorld* m_world;
   Genome m_genome;        // Full Genome
@@ -232,6 +233,7 @@ public:
   void SetCPUTestInfo(cCPUTestInfo& in_cpu_test_info) { m_cpu_test_info = in_cpu_test_info; }
   
   void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1);
+  void RecalculateParentStats(cAnalyzeGenotype* parent_genotype);
   void PrintTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintTasksQuality(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintInternalTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
@@ -28,14 +28,18 @@ class cAnalyzeJob
 {
 private:
   int m_id;
+  int m_seed;
   
 public:
-  cAnalyzeJob() : m_id(0) { ; }
+  cAnalyzeJob() : m_id(0), m_seed(0) { ; }
   virtual ~cAnalyzeJob() { ; }
   
   void SetID(int newid) { m_id = newid; }
   int GetID() { return m_id; }
   
+  void SetSeed(int seed) { m_seed = seed; }
+  int GetSeed() { return m_seed; }
+  
   virtual void Run(cAvidaContext& ctx) = 0;
 };
 
@@ -27,8 +27,11 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAnalyzeJobWorker.h"
+#include "cAvidaContext.h"
 #include "cWorld.h"
 
+#include <cassert>
+
 
 #if APTO_PLATFORM(WINDOWS) && defined(AddJob)
 # undef AddJob
@@ -38,7 +41,8 @@ using namespace Avida;
 
 
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
-: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+: m_world(world), m_last_jobid(0), m_next_deque(0), m_submitted(0), m_completed(0), m_terminate(false)
+, m_workers(Apto::Platform::AvailableCPUs())
 {
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
@@ -46,8 +50,9 @@ cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
   m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
   
   if (m_workers.GetSize() > 1) {
+    m_deques.Resize(m_workers.GetSize());
     for (int i = 0; i < m_workers.GetSize(); i++) {
-      m_workers[i] = new cAnalyzeJobWorker(this);
+      m_workers[i] = new cAnalyzeJobWorker(this, i);
       m_workers[i]->Start();
     }
   } else {
@@ -59,18 +64,10 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
 {
   const int num_workers = m_workers.GetSize();
   
+  // Signal all workers to terminate once they next run out of work
   m_mutex.Lock();
-  
-  // Clean out any waiting jobs
-  cAnalyzeJob* job;
-  while ((job = m_queue.Pop())) delete job;
-  
-  // Set job count so that all workers receive NULL jobs
-  m_jobs = num_workers;
-  
+  m_terminate = true;
   m_mutex.Unlock();
-  
-  // Signal all workers to check job queue
   m_cond.Broadcast();
   
   for (int i = 0; i < num_workers; i++) {
@@ -78,30 +75,90 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
     delete m_workers[i];
   }
   
+  // Clean out any waiting jobs
+  for (int i = 0; i < m_deques.GetSize(); i++) {
+    cAnalyzeJob* job;
+    while ((job = m_deques[i].jobs.Pop())) delete job;
+  }
+  
   delete m_job_seed_rng;
 }
 
-inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
+// Must be called with m_mutex held.  Seeds are drawn at submission so that each job's random stream depends only on
+// the order in which jobs were queued, not on which worker happens to pick it up.
+inline void cAnalyzeJobQueue::prepareJob(cAnalyzeJob* job)
 {
-  if (m_workers.GetSize()) m_queue.PushRear(job);
-  else singleThreadedJobExecution(job);
+  job->SetID(m_last_jobid++);
+  job->SetSeed(m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()));
+}
+
+void cAnalyzeJobQueue::queueJobs(cAnalyzeJob* const* jobs, int num_jobs)
+{
+  if (!m_workers.GetSize()) {
+    for (int i = 0; i < num_jobs; i++) {
+      m_mutex.Lock();
+      prepareJob(jobs[i]);
+      m_mutex.Unlock();
+      singleThreadedJobExecution(jobs[i]);
+    }
+    return;
+  }
+  
+  // Assign IDs, seeds and target deques under the queue lock, then deal the jobs out taking each deque lock once
+  m_mutex.Lock();
+  const int num_deques = m_deques.GetSize();
+  const int first_deque = m_next_deque;
+  for (int i = 0; i < num_jobs; i++) prepareJob(jobs[i]);
+  m_next_deque = (m_next_deque + num_jobs) % num_deques;
+  m_mutex.Unlock();
+  
+  for (int d = 0; d < num_deques && d < num_jobs; d++) {
+    sJobDeque& deque = m_deques[(first_deque + d) % num_deques];
+    deque.mutex.Lock();
+    for (int i = d; i < num_jobs; i += num_deques) deque.jobs.PushRear(jobs[i]);
+    deque.mutex.Unlock();
+  }
+  
+  // Publish the jobs only once they are reachable, so that an idle worker that sees the new count will find them
+  m_mutex.Lock();
+  m_submitted += num_jobs;
+  m_mutex.Unlock();
+}
+
+cAnalyzeJob* cAnalyzeJobQueue::nextJob(int worker_id)
+{
+  const int num_deques = m_deques.GetSize();
+  
+  sJobDeque& own = m_deques[worker_id];
+  own.mutex.Lock();
+  cAnalyzeJob* job = own.jobs.Pop();
+  own.mutex.Unlock();
+  
+  for (int i = 1; !job && i < num_deques; i++) {
+    sJobDeque& victim = m_deques[(worker_id + i) % num_deques];
+    victim.mutex.Lock();
+    job = victim.jobs.PopRear();
+    victim.mutex.Unlock();
+  }
+  
+  return job;
 }
 
 void cAnalyzeJobQueue::AddJob(cAnalyzeJob* job)
 {
-  Apto::MutexAutoLock lock(m_mutex);
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
+  queueJobs(&job, 1);
+}
+
+void cAnalyzeJobQueue::AddJobs(const Apto::Array<cAnalyzeJob*>& jobs, int start, int count)
+{
+  if (count < 0) count = jobs.GetSize() - start;
+  assert(start >= 0 && start + count <= jobs.GetSize());
+  if (count > 0) queueJobs(&jobs[start], count);
 }
 
 void cAnalyzeJobQueue::AddJobImmediate(cAnalyzeJob* job)
 {
-  m_mutex.Lock();
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
-  m_mutex.Unlock(); // should unlock prior to signaling condition variable
+  queueJobs(&job, 1);
   m_cond.Signal();
 }
 
@@ -124,7 +181,7 @@ void cAnalyzeJobQueue::Execute()
   
   // Wait for term signal
   m_mutex.Lock();
-  while (m_jobs > 0 || m_pending > 0) {
+  while (m_completed < m_submitted) {
     m_term_cond.Wait(m_mutex);
   }
   m_mutex.Unlock();
@@ -135,9 +192,8 @@ void cAnalyzeJobQueue::Execute()
 
 void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
-  Apto::RNG::AvidaRNG rng(GetSeedForJob(job->GetID()));
+  Apto::RNG::AvidaRNG rng(job->GetSeed());
   cAvidaContext ctx(&m_world->GetDriver(), rng);
   job->Run(ctx);
   delete job;
 }
-
@@ -44,22 +44,36 @@ class cAnalyzeJobQueue
   friend class cAnalyzeJobWorker;
   
 private:
+  // Each worker owns a deque of jobs.  Submitted jobs are dealt round-robin across the deques; a worker takes jobs from
+  // the front of its own deque and, once that runs dry, steals from the rear of the others.  The queue-wide mutex is
+  // only taken on submission and when a worker runs out of work, never per job.
+  struct sJobDeque
+  {
+    Apto::Mutex mutex;
+    tList<cAnalyzeJob> jobs;
+  };
+  
   cWorld* m_world;
-  tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
   Apto::Random* m_job_seed_rng;
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
   
-  volatile int m_jobs;      // count of waiting jobs, used in condition variable constructs
-  volatile int m_pending;   // count of currently executing jobs
+  Apto::Array<sJobDeque, Apto::ManagedPointer> m_deques;
+  int m_next_deque;
+  
+  volatile int m_submitted; // count of jobs ever queued
+  volatile int m_completed; // count of queued jobs reported complete by workers that have gone idle
+  volatile bool m_terminate;
   
   Apto::Array<cAnalyzeJobWorker*> m_workers;
 
 
   void singleThreadedJobExecution(cAnalyzeJob* job);
-  inline void queueJob(cAnalyzeJob* job);
+  inline void prepareJob(cAnalyzeJob* job);
+  void queueJobs(cAnalyzeJob* const* jobs, int num_jobs);
+  cAnalyzeJob* nextJob(int worker_id);
 
   
   cAnalyzeJobQueue(); // @not_implemented
@@ -72,12 +86,11 @@ public:
   ~cAnalyzeJobQueue();
 
   void AddJob(cAnalyzeJob* job);
+  void AddJobs(const Apto::Array<cAnalyzeJob*>& jobs, int start = 0, int count = -1);
   void AddJobImmediate(cAnalyzeJob* job);
 
   void Start();
   void Execute();
-  
-  int GetSeedForJob(int jobid) { Apto::MutexAutoLock lock(m_mutex); return m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()); }
 };
 
 #endif
@@ -32,34 +32,35 @@ void cAnalyzeJobWorker::Run()
   cAvidaContext ctx(&m_queue->m_world->GetDriver(), rng);
   ctx.SetAnalyzeMode();
   
-  cAnalyzeJob* job = NULL;
+  int completed = 0;  // jobs finished since this worker last reported to the queue
   
-  while (1) {
+  m_queue->m_mutex.Lock();
+  int seen_submitted = m_queue->m_submitted;
+  m_queue->m_mutex.Unlock();
+  
+  while (!m_queue->m_terminate) {
+    cAnalyzeJob* job = m_queue->nextJob(m_id);
+    if (job) {
+      // Set RNG from the seed assigned on submission and execute the job
+      rng.ResetSeed(job->GetSeed());
+      job->Run(ctx);
+      delete job;
+      completed++;
+      continue;
+    }
+    
+    // Out of work everywhere: report completions, then sleep unless more jobs were published since the last look
     m_queue->m_mutex.Lock();
-    while (m_queue->m_jobs == 0) {
+    m_queue->m_completed += completed;
+    completed = 0;
+    if (m_queue->m_completed == m_queue->m_submitted) m_queue->m_term_cond.Broadcast();
+    while (!m_queue->m_terminate && m_queue->m_submitted == seen_submitted) {
       m_queue->m_cond.Wait(m_queue->m_mutex);
     }
-    job = m_queue->m_queue.Pop();
-    m_queue->m_jobs--;
-    m_queue->m_pending++; 
+    seen_submitted = m_queue->m_submitted;
+    const bool terminate = m_queue->m_terminate;
     m_queue->m_mutex.Unlock();
     
-    if (job) {
-      // Set RNG from the waiting pool and execute the job
-      rng.ResetSeed(m_queue->GetSeedForJob(job->GetID()));
-      job->Run(ctx);
-      delete job;
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-    } else {
-      // Terminate worker on NULL job receipt
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-      break;
-    }
+    if (terminate) break;
   }
 }
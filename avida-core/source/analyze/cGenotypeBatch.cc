@@ -22,10 +22,14 @@
 #include "cGenotypeBatch.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cGenotypeColumns.h"
 
 
-cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs) : m_list(rhs.m_list), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned)
+cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs) : m_list(rhs.m_list), m_columns(NULL)
+  , m_id_index_valid(false), m_child_index_valid(false), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned)
 {
+  if (rhs.m_columns) m_columns = new cGenotypeColumns(*rhs.m_columns);
+  
   if (rhs.m_lineage_head) {
     m_lineage_head = new cAnalyzeGenotype(*(rhs.m_lineage_head));
   }
@@ -41,6 +45,7 @@ cGenotypeBatch::~cGenotypeBatch()
   cAnalyzeGenotype* genotype = NULL;
   while ((genotype = it.Next())) delete genotype;
   
+  delete m_columns;
   delete m_lineage_head;
   delete m_clade_head;
 }
@@ -55,6 +60,10 @@ cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
   m_name =       rhs.m_name;
   m_is_lineage = rhs.m_is_lineage;
   m_is_aligned = rhs.m_is_aligned;
+  
+  delete m_columns;
+  m_columns = (rhs.m_columns) ? new cGenotypeColumns(*rhs.m_columns) : NULL;
+  invalidateIndex();
 
   // pointery bits
   delete m_lineage_head;
@@ -71,89 +80,150 @@ cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
 }
 
 
+int cGenotypeBatch::GetSize()
+{
+  return (m_columns) ? m_columns->GetSize() : m_list.GetSize();
+}
+
+
+void cGenotypeBatch::Compact(cWorld* world)
+{
+  if (m_columns) return;
+  
+  m_columns = new cGenotypeColumns(world);
+  cAnalyzeGenotype* genotype = NULL;
+  while ((genotype = m_list.Pop())) {
+    m_columns->Push(*genotype);
+    delete genotype;
+  }
+}
+
+
+void cGenotypeBatch::materialize() const
+{
+  cGenotypeColumns* columns = m_columns;
+  m_columns = NULL;
+  columns->MaterializeAll(m_list);
+  delete columns;
+  invalidateIndex();
+}
+
+
+cAnalyzeGenotype* cGenotypeBatch::GetGenotypeWithID(int gid) const
+{
+  if (!m_id_index_valid) {
+    m_id_index.Clear();
+    tListIterator<cAnalyzeGenotype> it(list());
+    cAnalyzeGenotype* genotype = NULL;
+    while ((genotype = it.Next())) {
+      if (!m_id_index.Has(genotype->GetID())) m_id_index.Set(genotype->GetID(), genotype);
+    }
+    m_id_index_valid = true;
+  }
+  
+  return m_id_index.GetWithDefault(gid, NULL);
+}
+
+
+const Apto::Array<cAnalyzeGenotype*, Apto::Smart>* cGenotypeBatch::GetChildrenOf(int parent_id) const
+{
+  if (!m_child_index_valid) {
+    m_child_index.Clear();
+    tListIterator<cAnalyzeGenotype> it(list());
+    cAnalyzeGenotype* genotype = NULL;
+    while ((genotype = it.Next())) m_child_index[genotype->GetParentID()].Push(genotype);
+    m_child_index_valid = true;
+  }
+  
+  if (!m_child_index.Has(parent_id)) return NULL;
+  return &m_child_index[parent_id];
+}
+
+
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeNumCPUs() const
 {
-  return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetNumCPUs)));
+  return new cAnalyzeGenotype(*(list().FindMax(&cAnalyzeGenotype::GetNumCPUs)));
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeNumCPUs()
 {
   clearFlags();
-  return m_list.PopMax(&cAnalyzeGenotype::GetNumCPUs);
+  return list().PopMax(&cAnalyzeGenotype::GetNumCPUs);
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeTotalCPUs() const
 {
-  return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetTotalCPUs)));
+  return new cAnalyzeGenotype(*(list().FindMax(&cAnalyzeGenotype::GetTotalCPUs)));
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeTotalCPUs()
 {
   clearFlags();
-  return m_list.PopMax(&cAnalyzeGenotype::GetTotalCPUs);
+  return list().PopMax(&cAnalyzeGenotype::GetTotalCPUs);
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeMetabolicRate() const
 {
-  return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetMerit)));
+  return new cAnalyzeGenotype(*(list().FindMax(&cAnalyzeGenotype::GetMerit)));
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeMetabolicRate()
 {
   clearFlags();
-  return m_list.PopMax(&cAnalyzeGenotype::GetMerit);
+  return list().PopMax(&cAnalyzeGenotype::GetMerit);
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeFitness() const
 {
-  return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetFitness)));
+  return new cAnalyzeGenotype(*(list().FindMax(&cAnalyzeGenotype::GetFitness)));
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeFitness()
 {
   clearFlags();
-  return m_list.PopMax(&cAnalyzeGenotype::GetFitness);
+  return list().PopMax(&cAnalyzeGenotype::GetFitness);
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeID(int gid) const
 {
-  return new cAnalyzeGenotype(*(m_list.FindValue(&cAnalyzeGenotype::GetID, gid)));
+  cAnalyzeGenotype* genotype = GetGenotypeWithID(gid);
+  return (genotype) ? new cAnalyzeGenotype(*genotype) : NULL;
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeID(int gid)
 {
   clearFlags();
-  return m_list.PopValue(&cAnalyzeGenotype::GetID, gid);
+  return list().PopValue(&cAnalyzeGenotype::GetID, gid);
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeRandom(Apto::Random& rng) const
 {
-  if (m_list.GetSize() == 0) return NULL;
+  if (list().GetSize() == 0) return NULL;
   
-  return new cAnalyzeGenotype(*(m_list.GetPos(rng.GetUInt(m_list.GetSize()))));
+  return new cAnalyzeGenotype(*(list().GetPos(rng.GetUInt(list().GetSize()))));
 }
 
 cAnalyzeGenotype* cGenotypeBatch::PopGenotypeRandom(Apto::Random& rng)
 {
-  if (m_list.GetSize() == 0) return NULL;
+  if (list().GetSize() == 0) return NULL;
 
   clearFlags();
-  return m_list.PopPos(rng.GetUInt(m_list.GetSize()));
+  return list().PopPos(rng.GetUInt(list().GetSize()));
 }
 
 
 cAnalyzeGenotype* cGenotypeBatch::FindOrganismRandom(Apto::Random& rng) const
 {
-  if (m_list.GetSize() == 0) return NULL;
+  if (list().GetSize() == 0) return NULL;
   
-  int num_orgs = m_list.Count(&cAnalyzeGenotype::GetNumCPUs);
+  int num_orgs = list().Count(&cAnalyzeGenotype::GetNumCPUs);
   while (true) {
-    cAnalyzeGenotype* genotype = m_list.FindSummedValue(rng.GetUInt(num_orgs), &cAnalyzeGenotype::GetNumCPUs);
+    cAnalyzeGenotype* genotype = list().FindSummedValue(rng.GetUInt(num_orgs), &cAnalyzeGenotype::GetNumCPUs);
     if (genotype->GetNumCPUs()) return new cAnalyzeGenotype(*genotype);
   }
   
@@ -162,18 +232,18 @@ cAnalyzeGenotype* cGenotypeBatch::FindOrganismRandom(Apto::Random& rng) const
 
 cAnalyzeGenotype* cGenotypeBatch::PopOrganismRandom(Apto::Random& rng)
 {
-  if (m_list.GetSize() == 0) return NULL;
+  if (list().GetSize() == 0) return NULL;
 
-  int num_orgs = m_list.Count(&cAnalyzeGenotype::GetNumCPUs);
+  int num_orgs = list().Count(&cAnalyzeGenotype::GetNumCPUs);
   while (true) {
-    cAnalyzeGenotype* genotype = m_list.FindSummedValue(rng.GetUInt(num_orgs), &cAnalyzeGenotype::GetNumCPUs);
+    cAnalyzeGenotype* genotype = list().FindSummedValue(rng.GetUInt(num_orgs), &cAnalyzeGenotype::GetNumCPUs);
     if (genotype->GetNumCPUs()) {
       genotype->SetNumCPUs(genotype->GetNumCPUs() - 1);
       return new cAnalyzeGenotype(*genotype);
     }
   }
   
-  return m_list.PopPos(rng.GetUInt(m_list.GetSize()));
+  return list().PopPos(rng.GetUInt(list().GetSize()));
 }
 
 
@@ -184,20 +254,14 @@ cAnalyzeGenotype* cGenotypeBatch::FindLastCommonAncestor()
   // i.e. have an update_died of -1.
   
   // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> it(m_list);
-  tListIterator<cAnalyzeGenotype> parent_it(m_list);
+  tListIterator<cAnalyzeGenotype> it(list());
   cAnalyzeGenotype* on_child = NULL;
   while ((on_child = it.Next())) {
-    parent_it.Reset();
-    cAnalyzeGenotype* on_parent = NULL;
-    while ((on_parent = parent_it.Next())) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
+    cAnalyzeGenotype* on_parent = GetGenotypeWithID(on_child->GetParentID());
+    if (on_parent) on_child->LinkParent(on_parent);
   }
-    
+  
+
   // Find the genotype without a parent (there should only be one)
   it.Reset();
   cAnalyzeGenotype* lca = NULL;
@@ -233,12 +297,16 @@ cGenotypeBatch* cGenotypeBatch::FindLineage(int end_genotype_id) const
   cGenotypeBatch* batch = new cGenotypeBatch;
   cAnalyzeGenotype* found_gen = FindGenotypeID(end_genotype_id);
   
-  while ((found_gen)) {
-    batch->m_list.Push(found_gen);
+  // Guard against cycles in corrupt parent data, which would otherwise never terminate
+  Apto::Set<int> visited;
+  while ((found_gen) && !visited.Has(found_gen->GetID())) {
+    visited.Insert(found_gen->GetID());
+    batch->list().Push(found_gen);
     batch->m_lineage_head = found_gen;
     found_gen = FindGenotypeID(found_gen->GetParentID());
   }
-    
+  if (found_gen && visited.Has(found_gen->GetID())) delete found_gen;
+  
   return batch;
 }
 
@@ -262,9 +330,10 @@ cGenotypeBatch* cGenotypeBatch::FindSexLineage(int end_genotype_id, bool use_gen
   cAnalyzeGenotype* gen_p2 = NULL;
   
   // Construct a list of genotypes found...  
-  tListPlus<cAnalyzeGenotype> src_list(m_list);
-  tListPlus<cAnalyzeGenotype>& trgt_list = batch->m_list;
+  tListPlus<cAnalyzeGenotype>& trgt_list = batch->list();
+  Apto::Set<int> trgt_ids;
   trgt_list.Push(found_gen);
+  trgt_ids.Insert(found_gen->GetID());
   int next_id1 = found_gen->GetParentID();
   int next_id2 = found_gen->GetParent2ID();
   
@@ -275,70 +344,34 @@ cGenotypeBatch* cGenotypeBatch::FindSexLineage(int end_genotype_id, bool use_gen
     found_p1 = false;
     found_p2 = false;
     
-    // Look for the secondary parent first....
-    tListIterator<cAnalyzeGenotype> src_it(src_list);
-    while ((gen_p2 = src_it.Next())) {
-      if (gen_p2->GetID() == next_id2) {
-        src_it.Remove();
-        trgt_list.Push(new cAnalyzeGenotype(*gen_p2));
-        found_p2 = true;
-        break;
-      }
-    }
-    
-    // Secondary parent may have already been found
-    if (!found_p2) {
-      tListIterator<cAnalyzeGenotype> trgt_it(trgt_list);
-      while ((gen_p2 = trgt_it.Next())) {
-        if (gen_p2->GetID() == next_id2) {
-          found_p2 = true;
-          break;
-        }
-      }
+    // Look for the secondary parent first, it may have already been found
+    gen_p2 = GetGenotypeWithID(next_id2);
+    if (!gen_p2) break;
+    found_p2 = true;
+    if (!trgt_ids.Has(next_id2)) {
+      trgt_ids.Insert(next_id2);
+      trgt_list.Push(new cAnalyzeGenotype(*gen_p2));
     }
     
-    // If the secondary parent still has not been found, proceed no further
-    if (!found_p2) break;
-    
-    // Next, look for the primary parent...
-    src_it.Reset();
-    while ((gen_p1 = src_it.Next())) {
-      if (gen_p1->GetID() == next_id1) {
-        src_it.Remove();
+    // Next, look for the primary parent, it may already have been placed in the target list as a secondary parent
+    gen_p1 = GetGenotypeWithID(next_id1);
+    if (gen_p1) {
+      const bool already_found = trgt_ids.Has(next_id1);
+      if (!already_found) {
+        trgt_ids.Insert(next_id1);
         trgt_list.Push(new cAnalyzeGenotype(*gen_p1));
-        
-        // if finding lineages by parental length, may have to swap 
-        if (use_genome_size && gen_p1->GetLength() < gen_p2->GetLength()) { 
-          cAnalyzeGenotype* temp = gen_p1; 
-          gen_p1 = gen_p2; 
-          gen_p2 = temp; 
-        }
-        next_id1 = gen_p1->GetParentID();
-        next_id2 = gen_p2->GetParent2ID();
-        found_p1 = true;
-        break;
       }
-    }
-    
-    // If the primary parent was not found, it may already have been placed in the target list as a secondary parent... 
-    if (!found_p1) {
-      tListIterator<cAnalyzeGenotype> trgt_it(trgt_list);
-      while ((gen_p1 = trgt_it.Next()) != NULL) {
-        if (gen_p1->GetID() == next_id1) {
-          // Don't move to found list, since its already there, but update to the next ids.
-          // if finding lineages by parental length, may have to swap
-          if (use_genome_size && gen_p1->GetLength() < gen_p2->GetLength()) {
-            cAnalyzeGenotype* temp = gen_p1;
-            gen_p1 = gen_p2;
-            gen_p2 = temp;
-          }
-          next_id1 = gen_p1->GetParentID();
-          next_id2 = gen_p1->GetParent2ID();
-          found_p1 = true;
-          break;
-        }
+      
+      // if finding lineages by parental length, may have to swap 
+      if (use_genome_size && gen_p1->GetLength() < gen_p2->GetLength()) { 
+        cAnalyzeGenotype* temp = gen_p1; 
+        gen_p1 = gen_p2; 
+        gen_p2 = temp; 
       }
-    }    
+      next_id1 = gen_p1->GetParentID();
+      next_id2 = (already_found) ? gen_p1->GetParent2ID() : gen_p2->GetParent2ID();
+      found_p1 = true;
+    }
   }
   
   return batch;
@@ -355,27 +388,29 @@ cGenotypeBatch* cGenotypeBatch::FindClade(cAnalyzeGenotype* start_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindClade(int start_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  tList<cAnalyzeGenotype> list(m_list);
   Apto::Array<int, Apto::Smart> scan_list;
+  Apto::Set<int> scanned;
   cAnalyzeGenotype* found_gen = FindGenotypeID(start_genotype_id);
  
   if ((found_gen)) {
-    batch->m_list.Push(found_gen);
+    batch->list().Push(found_gen);
     batch->m_clade_head = found_gen;
     scan_list.Push(found_gen->GetID());
+    scanned.Insert(found_gen->GetID());
   }
   
   while (scan_list.GetSize()) {
     int parent_id = scan_list.Pop();
     
-    // Seach for all of the offspring of this genotype...
-    tListIterator<cAnalyzeGenotype> it(list);
-    while ((found_gen = it.Next()) != NULL) {
-      if (found_gen->GetParentID() == parent_id) {
-        it.Remove();
-        scan_list.Push(found_gen->GetID());
-        batch->m_list.Push(new cAnalyzeGenotype(*found_gen));
-      }
+    // Collect all of the offspring of this genotype...
+    const Apto::Array<cAnalyzeGenotype*, Apto::Smart>* children = GetChildrenOf(parent_id);
+    if (!children) continue;
+    for (int i = 0; i < children->GetSize(); i++) {
+      found_gen = (*children)[i];
+      if (scanned.Has(found_gen->GetID())) continue;
+      scanned.Insert(found_gen->GetID());
+      scan_list.Push(found_gen->GetID());
+      batch->list().Push(new cAnalyzeGenotype(*found_gen));
     }
   }
 
@@ -391,7 +426,7 @@ void cGenotypeBatch::RemoveClade(cAnalyzeGenotype* start_genotype)
 void cGenotypeBatch::RemoveClade(int start_genotype_id)
 {
   if (m_is_lineage) {
-    tListIterator<cAnalyzeGenotype> it(m_list);
+    tListIterator<cAnalyzeGenotype> it(list());
     cAnalyzeGenotype* genotype = NULL;
     
     while ((genotype = it.Next())) {
@@ -403,32 +438,46 @@ void cGenotypeBatch::RemoveClade(int start_genotype_id)
     }
     while ((genotype = it.Next())) { it.Remove(); delete genotype; }
   } else {
-    Apto::Array<int, Apto::Smart> scan_list;
-    cAnalyzeGenotype* found_gen = PopGenotypeID(start_genotype_id);
-    
-    if ((found_gen)) scan_list.Push(found_gen->GetID());
+    cAnalyzeGenotype* start_gen = GetGenotypeWithID(start_genotype_id);
+    if (!start_gen) {
+      clearFlags();
+      return;
+    }
     
+    // Gather the IDs of the whole clade from the child index, then remove its members in a single pass
+    Apto::Array<int, Apto::Smart> scan_list;
+    Apto::Set<int> clade_ids;
+    scan_list.Push(start_genotype_id);
+    clade_ids.Insert(start_genotype_id);
     while (scan_list.GetSize()) {
-      int parent_id = scan_list.Pop();
-      
-      // Seach for all of the offspring of this genotype...
-      tListIterator<cAnalyzeGenotype> it(m_list);
-      while ((found_gen = it.Next()) != NULL) {
-        if (found_gen->GetParentID() == parent_id) {
-          it.Remove();
-          scan_list.Push(found_gen->GetID());
-          delete found_gen;
-        }
+      const Apto::Array<cAnalyzeGenotype*, Apto::Smart>* children = GetChildrenOf(scan_list.Pop());
+      if (!children) continue;
+      for (int i = 0; i < children->GetSize(); i++) {
+        const int child_id = (*children)[i]->GetID();
+        if (clade_ids.Has(child_id)) continue;
+        clade_ids.Insert(child_id);
+        scan_list.Push(child_id);
+      }
+    }
+    
+    tListIterator<cAnalyzeGenotype> it(list());
+    cAnalyzeGenotype* found_gen = NULL;
+    while ((found_gen = it.Next()) != NULL) {
+      if (found_gen == start_gen || clade_ids.Has(found_gen->GetParentID())) {
+        it.Remove();
+        delete found_gen;
       }
     }
+    clearFlags();
   }
+  invalidateIndex();
 }
 
 
 void cGenotypeBatch::PruneExtinctGenotypes()
 {
   cAnalyzeGenotype* genotype = NULL;
-  tListIterator<cAnalyzeGenotype> it(m_list);
+  tListIterator<cAnalyzeGenotype> it(list());
   
   while ((genotype = it.Next())) {
     if (genotype->GetNumCPUs() == 0) {
@@ -443,7 +492,7 @@ void cGenotypeBatch::PruneExtinctGenotypes()
 void cGenotypeBatch::PruneNonViableGenotypes()
 {
   cAnalyzeGenotype* genotype = NULL;
-  tListIterator<cAnalyzeGenotype> it(m_list);
+  tListIterator<cAnalyzeGenotype> it(list());
   
   while ((genotype = it.Next())) {
     if (!genotype->GetViable()) {
@@ -23,6 +23,8 @@
 #ifndef cGenotypeBatch_h
 #define cGenotypeBatch_h
 
+#include "apto/core.h"
+
 #ifndef cString_h
 #include "cString.h"
 #endif
@@ -33,12 +35,22 @@
 // cGenotypeBatch      : Collection of cAnalyzeGenotypes
 
 class cAnalyzeGenotype;
+class cGenotypeColumns;
+class cWorld;
 
 
 class cGenotypeBatch
 {
 private:
-  tListPlus<cAnalyzeGenotype> m_list;
+  mutable tListPlus<cAnalyzeGenotype> m_list;
+  mutable cGenotypeColumns* m_columns;  // when set, the batch is compacted and m_list is empty until a command needs it
+  
+  // Ancestry indexes over m_list, built on demand by the lineage queries and dropped whenever the list may change
+  mutable Apto::Map<int, cAnalyzeGenotype*> m_id_index;  // first genotype in the list with each ID
+  mutable Apto::Map<int, Apto::Array<cAnalyzeGenotype*, Apto::Smart> > m_child_index;  // genotypes by parent ID, in list order
+  mutable bool m_id_index_valid;
+  mutable bool m_child_index_valid;
+  
   cString m_name;
   cAnalyzeGenotype* m_lineage_head;
   cAnalyzeGenotype* m_clade_head;
@@ -46,17 +58,23 @@ private:
   bool m_is_aligned;
   
 public:
-  cGenotypeBatch() : m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false) { ; }
+  cGenotypeBatch()
+    : m_columns(NULL), m_id_index_valid(false), m_child_index_valid(false), m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false) { ; }
   cGenotypeBatch(const cGenotypeBatch&);
   ~cGenotypeBatch();
 
   cGenotypeBatch& operator=(const cGenotypeBatch&);
 
-  tListPlus<cAnalyzeGenotype>& List() { return m_list; }
+  tListPlus<cAnalyzeGenotype>& List() { invalidateIndex(); return list(); }
   cString& Name() { return m_name; }
   const cString& GetName() const { return m_name; }
   
-  int GetSize() { return m_list.GetSize(); }
+  int GetSize();
+  
+  // Move the genotypes into columnar storage; they are rebuilt as objects the next time List() is used
+  void Compact(cWorld* world);
+  bool IsCompact() const { return (m_columns); }
+  cGenotypeColumns* GetColumns() { return m_columns; }
   
   bool IsLineage() { return m_is_lineage || (m_lineage_head); }
   bool IsClade() { return (m_clade_head); }
@@ -65,7 +83,7 @@ public:
   void SetLineage(bool _val = true) { m_is_lineage = _val; }
   void SetAligned(bool _val = true) { m_is_aligned = _val; }
   
-  void MergeWith(cGenotypeBatch* batch) { m_list.Append(batch->m_list); }
+  void MergeWith(cGenotypeBatch* batch) { List().Append(batch->List()); }
   
   cAnalyzeGenotype* FindGenotypeNumCPUs() const;
   cAnalyzeGenotype* PopGenotypeNumCPUs();
@@ -89,6 +107,10 @@ public:
   
   cAnalyzeGenotype* FindLastCommonAncestor();
   
+  // Indexed lookups returning genotypes owned by the batch (not copies).  Results are invalidated by List().
+  cAnalyzeGenotype* GetGenotypeWithID(int gid) const;
+  const Apto::Array<cAnalyzeGenotype*, Apto::Smart>* GetChildrenOf(int parent_id) const;
+  
   cGenotypeBatch* FindLineage(cAnalyzeGenotype* end_genotype) const;
   cGenotypeBatch* FindLineage(int end_genotype_id) const;
 
@@ -106,7 +128,12 @@ public:
 
   
 private:
-  inline void clearFlags() { m_lineage_head = NULL; m_is_lineage = false; m_clade_head = NULL; m_is_aligned = false; }
+  void materialize() const;
+  inline tListPlus<cAnalyzeGenotype>& list() const { if (m_columns) materialize(); return m_list; }
+  
+  inline void invalidateIndex() const { m_id_index_valid = false; m_child_index_valid = false; }
+  
+  inline void clearFlags() { invalidateIndex(); m_lineage_head = NULL; m_is_lineage = false; m_clade_head = NULL; m_is_aligned = false; }
 };
 
 
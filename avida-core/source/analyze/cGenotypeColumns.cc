@@ -0,0 +1,263 @@
+/*
+ *  cGenotypeColumns.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenotypeColumns.h"
+
+#include "avida/core/Genome.h"
+
+#include "cAnalyzeGenotype.h"
+
+using namespace Avida;
+
+
+namespace {
+  enum eColumn {
+    COL_VIABLE = 0,
+    COL_ID,
+    COL_PARENT_ID,
+    COL_PARENT2_ID,
+    COL_NUM_CPUS,
+    COL_TOTAL_CPUS,
+    COL_UPDATE_BORN,
+    COL_UPDATE_DEAD,
+    COL_DEPTH,
+    COL_LENGTH,
+    COL_COPY_LENGTH,
+    COL_EXE_LENGTH,
+    COL_MERIT,
+    COL_GEST_TIME,
+    COL_FITNESS,
+    COL_ERRORS,
+    COL_PARENT_DIST,
+    COL_ANCESTOR_DIST
+  };
+}
+
+
+void cGenotypeColumns::cStringColumn::Push(const char* str, int size)
+{
+  for (int i = 0; i < size; i++) m_chars.Push(str[i]);
+  m_offsets.Push(m_chars.GetSize());
+}
+
+
+void cGenotypeColumns::cIntArrayColumn::Push(const Apto::Array<int>& values)
+{
+  for (int i = 0; i < values.GetSize(); i++) m_values.Push(values[i]);
+  m_offsets.Push(m_values.GetSize());
+}
+
+void cGenotypeColumns::cIntArrayColumn::Get(int row, Apto::Array<int>& values) const
+{
+  const int start = m_offsets[row];
+  values.Resize(m_offsets[row + 1] - start);
+  for (int i = 0; i < values.GetSize(); i++) values[i] = m_values[start + i];
+}
+
+
+int cGenotypeColumns::GetMemoryUsed() const
+{
+  int used = m_genome.GetMemoryUsed() + m_name.GetMemoryUsed() + m_tag.GetMemoryUsed() + m_aligned_sequence.GetMemoryUsed();
+  used += m_src_args.GetMemoryUsed() + m_parent_str.GetMemoryUsed() + m_cells.GetMemoryUsed();
+  used += m_gest_offsets.GetMemoryUsed() + m_executed_flags.GetMemoryUsed() + m_parent_muts.GetMemoryUsed();
+  used += m_task_order.GetMemoryUsed() + m_task_counts.GetMemoryUsed();
+  used += m_size * (sizeof(Systematics::Source) + sizeof(bool) + 27 * sizeof(int) + 6 * sizeof(double));
+  return used;
+}
+
+
+void cGenotypeColumns::Push(const cAnalyzeGenotype& genotype)
+{
+  m_genome.Push((const char*)genotype.m_genome.AsString());
+  m_name.Push(genotype.name);
+  m_tag.Push(genotype.tag);
+  m_aligned_sequence.Push(genotype.aligned_sequence);
+  m_src_args.Push(genotype.m_src_args);
+  m_parent_str.Push(genotype.m_parent_str);
+  m_cells.Push(genotype.m_cells);
+  m_gest_offsets.Push(genotype.m_gest_offsets);
+  m_executed_flags.Push(genotype.executed_flags);
+  m_parent_muts.Push(genotype.parent_muts);
+  m_task_order.Push(genotype.task_order);
+  m_task_counts.Push(genotype.task_counts);
+  
+  m_src.Push(genotype.m_src);
+  m_viable.Push(genotype.viable);
+  m_id.Push(genotype.id_num);
+  m_parent_id.Push(genotype.parent_id);
+  m_parent2_id.Push(genotype.parent2_id);
+  m_num_cpus.Push(genotype.num_cpus);
+  m_total_cpus.Push(genotype.total_cpus);
+  m_update_born.Push(genotype.update_born);
+  m_update_dead.Push(genotype.update_dead);
+  m_depth.Push(genotype.depth);
+  m_length.Push(genotype.length);
+  m_copy_length.Push(genotype.copy_length);
+  m_exe_length.Push(genotype.exe_length);
+  m_merit.Push(genotype.merit);
+  m_gest_time.Push(genotype.gest_time);
+  m_fitness.Push(genotype.fitness);
+  m_errors.Push(genotype.errors);
+  m_div_type.Push(genotype.div_type);
+  m_mate_id.Push(genotype.mate_id);
+  m_mating_type.Push(genotype.m_mating_type);
+  m_mate_preference.Push(genotype.m_mate_preference);
+  m_mating_display_a.Push(genotype.m_mating_display_a);
+  m_mating_display_b.Push(genotype.m_mating_display_b);
+  m_fitness_ratio.Push(genotype.fitness_ratio);
+  m_efficiency_ratio.Push(genotype.efficiency_ratio);
+  m_comp_merit_ratio.Push(genotype.comp_merit_ratio);
+  m_parent_dist.Push(genotype.parent_dist);
+  m_ancestor_dist.Push(genotype.ancestor_dist);
+  m_lineage_label.Push(genotype.lineage_label);
+  
+  m_size++;
+}
+
+
+cAnalyzeGenotype* cGenotypeColumns::Materialize(int row) const
+{
+  assert(row >= 0 && row < m_size);
+  
+  Genome genome(Apto::String((const char*)m_genome.Get(row)));
+  cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, genome);
+  
+  genotype->name = m_name.Get(row);
+  genotype->tag = m_tag.Get(row);
+  genotype->aligned_sequence = m_aligned_sequence.Get(row);
+  genotype->m_src_args = m_src_args.Get(row);
+  genotype->m_parent_str = m_parent_str.Get(row);
+  genotype->m_cells = m_cells.Get(row);
+  genotype->m_gest_offsets = m_gest_offsets.Get(row);
+  genotype->executed_flags = m_executed_flags.Get(row);
+  genotype->parent_muts = m_parent_muts.Get(row);
+  genotype->task_order = m_task_order.Get(row);
+  m_task_counts.Get(row, genotype->task_counts);
+  
+  genotype->m_src = m_src[row];
+  genotype->viable = m_viable[row];
+  genotype->id_num = m_id[row];
+  genotype->parent_id = m_parent_id[row];
+  genotype->parent2_id = m_parent2_id[row];
+  genotype->num_cpus = m_num_cpus[row];
+  genotype->total_cpus = m_total_cpus[row];
+  genotype->update_born = m_update_born[row];
+  genotype->update_dead = m_update_dead[row];
+  genotype->depth = m_depth[row];
+  genotype->length = m_length[row];
+  genotype->copy_length = m_copy_length[row];
+  genotype->exe_length = m_exe_length[row];
+  genotype->merit = m_merit[row];
+  genotype->gest_time = m_gest_time[row];
+  genotype->fitness = m_fitness[row];
+  genotype->errors = m_errors[row];
+  genotype->div_type = m_div_type[row];
+  genotype->mate_id = m_mate_id[row];
+  genotype->m_mating_type = m_mating_type[row];
+  genotype->m_mate_preference = m_mate_preference[row];
+  genotype->m_mating_display_a = m_mating_display_a[row];
+  genotype->m_mating_display_b = m_mating_display_b[row];
+  genotype->fitness_ratio = m_fitness_ratio[row];
+  genotype->efficiency_ratio = m_efficiency_ratio[row];
+  genotype->comp_merit_ratio = m_comp_merit_ratio[row];
+  genotype->parent_dist = m_parent_dist[row];
+  genotype->ancestor_dist = m_ancestor_dist[row];
+  genotype->lineage_label = m_lineage_label[row];
+  
+  return genotype;
+}
+
+void cGenotypeColumns::MaterializeAll(tList<cAnalyzeGenotype>& list) const
+{
+  for (int row = 0; row < m_size; row++) list.PushRear(Materialize(row));
+}
+
+
+int cGenotypeColumns::findColumn(const cString& stat) const
+{
+  if (stat == "viable") return COL_VIABLE;
+  if (stat == "id") return COL_ID;
+  if (stat == "parent_id") return COL_PARENT_ID;
+  if (stat == "parent2_id") return COL_PARENT2_ID;
+  if (stat == "num_cpus") return COL_NUM_CPUS;
+  if (stat == "total_cpus") return COL_TOTAL_CPUS;
+  if (stat == "update_born") return COL_UPDATE_BORN;
+  if (stat == "update_dead") return COL_UPDATE_DEAD;
+  if (stat == "depth") return COL_DEPTH;
+  if (stat == "length") return COL_LENGTH;
+  if (stat == "copy_length") return COL_COPY_LENGTH;
+  if (stat == "exe_length") return COL_EXE_LENGTH;
+  if (stat == "merit") return COL_MERIT;
+  if (stat == "gest_time") return COL_GEST_TIME;
+  if (stat == "fitness") return COL_FITNESS;
+  if (stat == "errors") return COL_ERRORS;
+  if (stat == "parent_dist") return COL_PARENT_DIST;
+  if (stat == "ancestor_dist") return COL_ANCESTOR_DIST;
+  return -1;
+}
+
+cFlexVar cGenotypeColumns::getValue(int column, int row) const
+{
+  switch (column) {
+    case COL_VIABLE:        return cFlexVar((int)m_viable[row]);
+    case COL_ID:            return cFlexVar(m_id[row]);
+    case COL_PARENT_ID:     return cFlexVar(m_parent_id[row]);
+    case COL_PARENT2_ID:    return cFlexVar(m_parent2_id[row]);
+    case COL_NUM_CPUS:      return cFlexVar(m_num_cpus[row]);
+    case COL_TOTAL_CPUS:    return cFlexVar(m_total_cpus[row]);
+    case COL_UPDATE_BORN:   return cFlexVar(m_update_born[row]);
+    case COL_UPDATE_DEAD:   return cFlexVar(m_update_dead[row]);
+    case COL_DEPTH:         return cFlexVar(m_depth[row]);
+    case COL_LENGTH:        return cFlexVar(m_length[row]);
+    case COL_COPY_LENGTH:   return cFlexVar(m_copy_length[row]);
+    case COL_EXE_LENGTH:    return cFlexVar(m_exe_length[row]);
+    case COL_MERIT:         return cFlexVar(m_merit[row]);
+    case COL_GEST_TIME:     return cFlexVar(m_gest_time[row]);
+    case COL_FITNESS:       return cFlexVar(m_fitness[row]);
+    case COL_ERRORS:        return cFlexVar(m_errors[row]);
+    case COL_PARENT_DIST:   return cFlexVar(m_parent_dist[row]);
+    case COL_ANCESTOR_DIST: return cFlexVar(m_ancestor_dist[row]);
+  }
+  assert(false);
+  return cFlexVar(0);
+}
+
+
+bool cGenotypeColumns::Filter(const cString& stat, const Apto::Array<bool>& rel_ok, const cFlexVar& value)
+{
+  const int column = findColumn(stat);
+  if (column < 0) return false;
+  
+  // Rows are copied through a full genotype only when kept, so filtering never holds the whole batch in object form
+  cGenotypeColumns kept(m_world);
+  for (int row = 0; row < m_size; row++) {
+    const cFlexVar cur_value = getValue(column, row);
+    const int compare = (cur_value == value) ? 1 : ((cur_value > value) ? 2 : 0);
+    if (rel_ok[compare]) {
+      cAnalyzeGenotype* genotype = Materialize(row);
+      kept.Push(*genotype);
+      delete genotype;
+    }
+  }
+  
+  *this = kept;
+  return true;
+}
@@ -0,0 +1,148 @@
+/*
+ *  cGenotypeColumns.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenotypeColumns_h
+#define cGenotypeColumns_h
+
+#include "avida/systematics/Unit.h"
+
+#ifndef cFlexVar_h
+#include "cFlexVar.h"
+#endif
+#ifndef cString_h
+#include "cString.h"
+#endif
+#ifndef tList_h
+#include "tList.h"
+#endif
+
+// cGenotypeColumns    : Compact, column-oriented storage for the genotypes of a batch
+
+class cAnalyzeGenotype;
+class cWorld;
+
+
+class cGenotypeColumns
+{
+private:
+  // Variable length strings packed end to end in a single arena, indexed by row
+  class cStringColumn
+  {
+  private:
+    Apto::Array<char, Apto::Smart> m_chars;
+    Apto::Array<int, Apto::Smart> m_offsets;
+    
+  public:
+    cStringColumn() { m_offsets.Push(0); }
+    
+    void Push(const char* str, int size);
+    void Push(const cString& str) { Push(str, str.GetSize()); }
+    cString Get(int row) const { return cString(m_chars.GetSize() ? &m_chars[m_offsets[row]] : "", m_offsets[row + 1] - m_offsets[row]); }
+    int GetMemoryUsed() const { return m_chars.GetSize() + m_offsets.GetSize() * sizeof(int); }
+  };
+  
+  // Variable length integer arrays packed end to end, indexed by row
+  class cIntArrayColumn
+  {
+  private:
+    Apto::Array<int, Apto::Smart> m_values;
+    Apto::Array<int, Apto::Smart> m_offsets;
+    
+  public:
+    cIntArrayColumn() { m_offsets.Push(0); }
+    
+    void Push(const Apto::Array<int>& values);
+    void Get(int row, Apto::Array<int>& values) const;
+    int GetMemoryUsed() const { return (m_values.GetSize() + m_offsets.GetSize()) * sizeof(int); }
+  };
+  
+  
+  cWorld* m_world;
+  int m_size;
+  
+  cStringColumn m_genome;   // Genome::AsString() of each genotype, rebuilt into a Genome on materialization
+  cStringColumn m_name;
+  cStringColumn m_tag;
+  cStringColumn m_aligned_sequence;
+  cStringColumn m_src_args;
+  cStringColumn m_parent_str;
+  cStringColumn m_cells;
+  cStringColumn m_gest_offsets;
+  cStringColumn m_executed_flags;
+  cStringColumn m_parent_muts;
+  cStringColumn m_task_order;
+  cIntArrayColumn m_task_counts;
+  
+  Apto::Array<Avida::Systematics::Source, Apto::Smart> m_src;
+  Apto::Array<bool, Apto::Smart> m_viable;
+  Apto::Array<int, Apto::Smart> m_id;
+  Apto::Array<int, Apto::Smart> m_parent_id;
+  Apto::Array<int, Apto::Smart> m_parent2_id;
+  Apto::Array<int, Apto::Smart> m_num_cpus;
+  Apto::Array<int, Apto::Smart> m_total_cpus;
+  Apto::Array<int, Apto::Smart> m_update_born;
+  Apto::Array<int, Apto::Smart> m_update_dead;
+  Apto::Array<int, Apto::Smart> m_depth;
+  Apto::Array<int, Apto::Smart> m_length;
+  Apto::Array<int, Apto::Smart> m_copy_length;
+  Apto::Array<int, Apto::Smart> m_exe_length;
+  Apto::Array<double, Apto::Smart> m_merit;
+  Apto::Array<int, Apto::Smart> m_gest_time;
+  Apto::Array<double, Apto::Smart> m_fitness;
+  Apto::Array<int, Apto::Smart> m_errors;
+  Apto::Array<double, Apto::Smart> m_div_type;
+  Apto::Array<int, Apto::Smart> m_mate_id;
+  Apto::Array<int, Apto::Smart> m_mating_type;
+  Apto::Array<int, Apto::Smart> m_mate_preference;
+  Apto::Array<int, Apto::Smart> m_mating_display_a;
+  Apto::Array<int, Apto::Smart> m_mating_display_b;
+  Apto::Array<double, Apto::Smart> m_fitness_ratio;
+  Apto::Array<double, Apto::Smart> m_efficiency_ratio;
+  Apto::Array<double, Apto::Smart> m_comp_merit_ratio;
+  Apto::Array<int, Apto::Smart> m_parent_dist;
+  Apto::Array<int, Apto::Smart> m_ancestor_dist;
+  Apto::Array<int, Apto::Smart> m_lineage_label;
+  
+  
+  int findColumn(const cString& stat) const;
+  cFlexVar getValue(int column, int row) const;
+  
+  cGenotypeColumns(); // @not_implemented
+  
+public:
+  cGenotypeColumns(cWorld* world) : m_world(world), m_size(0) { ; }
+  
+  int GetSize() const { return m_size; }
+  int GetMemoryUsed() const;
+  
+  // Append a copy of the genotype's stored state as a new row
+  void Push(const cAnalyzeGenotype& genotype);
+  
+  // Build a full genotype object for the given row
+  cAnalyzeGenotype* Materialize(int row) const;
+  void MaterializeAll(tList<cAnalyzeGenotype>& list) const;
+  
+  // Keep only the rows whose stat satisfies the relation (rel_ok as in cAnalyze::CommandFilter).  Returns false, doing
+  // nothing, if the stat is not stored as a column.
+  bool Filter(const cString& stat, const Apto::Array<bool>& rel_ok, const cFlexVar& value);
+};
+
+#endif
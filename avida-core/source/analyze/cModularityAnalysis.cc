@@ -90,6 +90,17 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
+    // Knock out each line in turn, and run all of the knockouts through the Test CPU as a single batch
+    Apto::Array<Genome> knockouts;
+    for (int line_num = 0; line_num < max_line; line_num++) {
+      int cur_inst = base_seq[line_num].GetOp();
+      mod_seq[line_num] = null_inst;
+      knockouts.Push(mod_genome); // copies the sequence
+      mod_seq[line_num].SetOp(cur_inst);
+    }
+    cTestCPU::sBatchResults results;
+    testcpu->TestGenomes(ctx, test_info, knockouts, results);
+    
     // Create and initialize the modularity matrix
     tMatrix<int> mod_matrix(num_tasks, max_line);
     mod_matrix.SetAll(0);
@@ -99,17 +110,10 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     Apto::Array<int> sites_per_task(num_tasks); // number of sites involved in each task
     sites_per_task.SetAll(0);
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Loop through all the lines of code, scoring the removal of each.
     for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      
-      mod_seq[line_num] = null_inst;
-      
-      // Run the modified genome through the Test CPU
-      testcpu->TestGenome(ctx, test_info, mod_genome);
-      
-      if (test_info.GetColonyFitness() > 0.0) {
-        const Apto::Array<int>& test_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+      if (results.colony_fitness[line_num] > 0.0) {
+        const Apto::Array<int>& test_tasks = results.task_counts[line_num];
         
         for (int cur_task = 0; cur_task < num_tasks; cur_task++) {
           // This is done so that under 'binary' option it marks
@@ -124,9 +128,6 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
           }
         }
       }
-          
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
     }
     
     Apto::Array<int> sites_inv_x_tasks(num_tasks + 1);  // # of inst's involved in 0,1,2,3... tasks
@@ -227,6 +228,8 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     mod_data->ave_task_position = ave_task_position;
     m_genotype->SetGenotypeData(GD_MD_ID, mod_data);
   }
+  
+  delete testcpu;
 }
 
 #ifdef DEBUG
@@ -39,10 +39,10 @@
 using namespace std;
 
 
-cMutationalNeighborhood::cMutationalNeighborhood(cWorld* world, const Genome& genome, int target)
+cMutationalNeighborhood::cMutationalNeighborhood(cWorld* world, const Genome& genome, int target, int twostep_budget)
   : m_world(world), m_initialized(false)
   , m_inst_set(m_world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue()))
-  , m_target(target), m_base_genome(genome)
+  , m_target(target), m_twostep_budget(twostep_budget), m_twostep_rate(1.0), m_base_genome(genome)
 {
   InstructionSequencePtr seq;
   seq.DynamicCastFrom(m_base_genome.Representation());
@@ -198,6 +198,13 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
   m_fitness_insert.ResizeClear(m_base_genome_size + 1, m_inst_set.GetSize());
   m_fitness_delete.ResizeClear(m_base_genome_size, 1);
   
+  // With a two step budget, each two step mutant is tested with the probability needed to hit the budget on average
+  m_twostep_rate = 1.0;
+  if (m_twostep_budget >= 0) {
+    double twostep_total = CountTwoStepMutants();
+    if (twostep_total > m_twostep_budget) m_twostep_rate = m_twostep_budget / twostep_total;
+  }
+  
   m_cur_site = 0;
   m_completed = 0;
   m_initialized = true;
@@ -215,6 +222,23 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
 }
 
 
+double cMutationalNeighborhood::CountTwoStepMutants() const
+{
+  // Approximates the loop bounds of the ProcessTwoStep* and Process*Combo methods
+  const double len = m_base_genome_size;
+  const double insts = m_inst_set.GetSize();
+  
+  double total = (insts - 1.0) * (insts - 1.0) * len * (len - 1.0) / 2.0;   // point + point
+  total += insts * insts * (len + 1.0) * (len + 2.0) / 2.0;                 // insert + insert
+  total += len * (len - 1.0) / 2.0;                                         // delete + delete
+  total += insts * (insts - 1.0) * (len + 1.0) * len;                       // insert + point
+  total += insts * (len + 1.0) * len;                                       // insert + delete
+  total += (insts - 1.0) * len * (len - 1.0);                               // delete + point
+  
+  return total;
+}
+
+
 void cMutationalNeighborhood::ProcessOneStepPoint(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, int cur_site)
 {
   const int inst_size = m_inst_set.GetSize();
@@ -503,6 +527,9 @@ double cMutationalNeighborhood::ProcessTwoStepGenome(cAvidaContext& ctx, cTestCP
                                                      const Genome& mod_genome, sTwoStep& tdata,
                                                      const sPendFit& cur, const sPendFit& oth)
 {
+  // Subsample the two step space when running under a budget
+  if (m_twostep_rate < 1.0 && ctx.GetRandom().GetDouble() >= m_twostep_rate) return 0.0;
+  
   // Run the modified genome through the Test CPU
   testcpu->TestGenome(ctx, test_info, mod_genome);
   
@@ -1161,6 +1188,8 @@ void cMutationalNeighborhood::PrintStats(Avida::Output::File& df, int update) co
   df.Write(GetDelPntKnockout(), "Delete/Point Knockout Task");
   df.Write(GetDelPntProbKnockout(), "Delete/Point Probability Knockout Task");
   df.Write(GetDelPntAverageSizeKnockout(), "Delete/Point Average Size of Task Knockout");
+
+  df.Write(GetTwoStepSampleRate(), "Two Step Sample Rate");
   
   df.Endl();
 }
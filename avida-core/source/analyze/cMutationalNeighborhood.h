@@ -57,6 +57,8 @@ private:
   
   const cInstSet& m_inst_set;  
   int m_target;
+  int m_twostep_budget;
+  double m_twostep_rate;
   
   
   
@@ -231,7 +233,7 @@ private:
 public:
   // Public Methods - Instantiate and Process Only.   All results must be read with a cMutationalNeighborhood object.
   // -----------------------------------------------------------------------------------------------------------------------
-  cMutationalNeighborhood(cWorld* world, const Genome& genome, int target);
+  cMutationalNeighborhood(cWorld* world, const Genome& genome, int target, int twostep_budget = -1);
   ~cMutationalNeighborhood() { ; }
   
   void Process(cAvidaContext& ctx);
@@ -241,6 +243,7 @@ private:
   // Internal Calculation Methods
   // -----------------------------------------------------------------------------------------------------------------------
   void ProcessInitialize(cAvidaContext& ctx);
+  double CountTwoStepMutants() const;
   
   void ProcessOneStepPoint(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, int cur_site);
   void ProcessOneStepInsert(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, int cur_site);
@@ -268,6 +271,7 @@ private:
   void PrintStats(Avida::Output::File& df, int update = -1) const;
   
   inline int GetTargetTask() const { return m_target; }
+  inline double GetTwoStepSampleRate() const { return m_twostep_rate; }
 
   inline const Genome& GetBaseGenome() const { return m_base_genome; }
   inline int GetBaseGenomeSize() const { return m_base_genome_size; }
@@ -54,6 +54,7 @@ public:
   inline void PrintStats(Avida::Output::File& df, int update = -1) const { m_src.PrintStats(df, update); }
   
   inline int GetTargetTask() const { return m_src.GetTargetTask(); }
+  inline double GetTwoStepSampleRate() const { return m_src.GetTwoStepSampleRate(); }
   
   inline const Genome& GetBaseGenome() const { return m_src.GetBaseGenome(); }
   inline double GetBaseFitness() const { return m_src.GetBaseFitness(); }
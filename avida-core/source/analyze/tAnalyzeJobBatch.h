@@ -44,7 +44,8 @@ protected:
 protected:
   cAnalyzeJobQueue& m_queue;
   
-  int m_jobs;
+  int m_jobs;                             // jobs of this batch not yet complete
+  Apto::Array<cAnalyzeJob*> m_unsubmitted; // jobs collected by AddJob, handed to the queue together by RunBatch
   
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
@@ -55,14 +56,18 @@ public:
   
   void AddJob(JobClass* target, void (JobClass::*funJ)(cAvidaContext&))
   {
-    m_mutex.Lock();
-    m_jobs++;
-    m_mutex.Unlock();
-    m_queue.AddJob(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
+    m_unsubmitted.Push(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
   }
   
+  // Waits only for the jobs of this batch, leaving any other queued work running
   void RunBatch()
   {
+    m_mutex.Lock();
+    m_jobs += m_unsubmitted.GetSize();
+    m_mutex.Unlock();
+    m_queue.AddJobs(m_unsubmitted);
+    m_unsubmitted.Resize(0);
+    
     m_queue.Start();
     m_mutex.Lock();
     while (m_jobs > 0) {
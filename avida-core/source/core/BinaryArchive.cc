@@ -0,0 +1,393 @@
+/*
+ *  core/BinaryArchive.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/core/BinaryArchive.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+
+static Avida::PropertyDescriptionMap s_prop_desc_map;
+
+
+namespace {
+  static const unsigned int ARCHIVE_FORMAT_VERSION = 1;
+  static const unsigned int ARCHIVE_BLOCK_SIZE = 64 * 1024;
+
+  static const int LZ_MIN_MATCH = 4;
+  static const int LZ_HASH_BITS = 12;
+  static const int LZ_MAX_OFFSET = 65535;
+
+
+  template <typename T> inline void appendValue(std::string& buf, const T& value)
+  {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T> inline bool readValue(const std::string& buf, size_t& pos, T& value)
+  {
+    if (buf.size() - pos < sizeof(T)) return false;
+    memcpy(&value, buf.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  inline void appendString(std::string& buf, const Apto::String& str)
+  {
+    appendValue(buf, static_cast<unsigned int>(str.GetSize()));
+    buf.append((const char*)str, str.GetSize());
+  }
+
+  inline bool readString(const std::string& buf, size_t& pos, Apto::String& str)
+  {
+    unsigned int len = 0;
+    if (!readValue(buf, pos, len) || buf.size() - pos < len) return false;
+    str = std::string(buf, pos, len).c_str();
+    pos += len;
+    return true;
+  }
+
+  // Property types must outlive the properties that refer to them, so decoded types are mapped back to the statics
+  const Avida::PropertyTypeID& knownType(const Apto::String& type)
+  {
+    if (type == Avida::PropertyTraits<int>::Type) return Avida::PropertyTraits<int>::Type;
+    if (type == Avida::PropertyTraits<double>::Type) return Avida::PropertyTraits<double>::Type;
+    if (type == Avida::PropertyTraits<bool>::Type) return Avida::PropertyTraits<bool>::Type;
+    if (type == Avida::PropertyTraits<Apto::String>::Type) return Avida::PropertyTraits<Apto::String>::Type;
+    return Avida::Property::Null;
+  }
+
+
+  // Block compression - a byte oriented LZ77 in the style of LZ4.  Each sequence is a token (high nibble literal
+  // count, low nibble match length - 4, either extended by 255 valued bytes when 15), the literals, then a 16-bit
+  // little endian match offset.  The final sequence carries only literals.
+
+  inline unsigned int read32(const unsigned char* p)
+  {
+    unsigned int v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  inline void appendLength(std::string& out, int len)
+  {
+    for (; len >= 255; len -= 255) out.push_back(static_cast<char>(255));
+    out.push_back(static_cast<char>(len));
+  }
+
+  void appendSequence(std::string& out, const unsigned char* lit, int lit_len, int match_len, int offset)
+  {
+    const int match_code = (match_len) ? match_len - LZ_MIN_MATCH : 0;
+    unsigned char token = static_cast<unsigned char>(((lit_len < 15) ? lit_len : 15) << 4);
+    token |= static_cast<unsigned char>((match_code < 15) ? match_code : 15);
+    out.push_back(static_cast<char>(token));
+    if (lit_len >= 15) appendLength(out, lit_len - 15);
+    out.append(reinterpret_cast<const char*>(lit), lit_len);
+
+    if (!match_len) return;
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) appendLength(out, match_code - 15);
+  }
+
+  void compressBlock(const unsigned char* src, int size, std::string& out)
+  {
+    int table[1 << LZ_HASH_BITS];
+    for (int i = 0; i < (1 << LZ_HASH_BITS); i++) table[i] = -1;
+
+    int anchor = 0;
+    int pos = 0;
+    while (pos + LZ_MIN_MATCH <= size) {
+      const unsigned int seq = read32(src + pos);
+      const unsigned int h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+      const int ref = table[h];
+      table[h] = pos;
+
+      if (ref < 0 || pos - ref > LZ_MAX_OFFSET || read32(src + ref) != seq) {
+        pos++;
+        continue;
+      }
+
+      int len = LZ_MIN_MATCH;
+      while (pos + len < size && src[ref + len] == src[pos + len]) len++;
+
+      appendSequence(out, src + anchor, pos - anchor, len, pos - ref);
+      pos += len;
+      anchor = pos;
+    }
+    appendSequence(out, src + anchor, size - anchor, 0, 0);
+  }
+
+  bool readLength(const unsigned char* src, int size, int& pos, int& len)
+  {
+    unsigned char b;
+    do {
+      if (pos >= size) return false;
+      b = src[pos++];
+      len += b;
+    } while (b == 255);
+    return true;
+  }
+
+  bool decompressBlock(const unsigned char* src, int size, int raw_size, std::string& out)
+  {
+    const size_t base = out.size();
+    int pos = 0;
+    while (pos < size) {
+      const unsigned char token = src[pos++];
+
+      int lit_len = token >> 4;
+      if (lit_len == 15 && !readLength(src, size, pos, lit_len)) return false;
+      if (size - pos < lit_len) return false;
+      out.append(reinterpret_cast<const char*>(src + pos), lit_len);
+      pos += lit_len;
+
+      if (pos == size) break;
+
+      if (size - pos < 2) return false;
+      const int offset = src[pos] | (src[pos + 1] << 8);
+      pos += 2;
+      int match_len = token & 0x0F;
+      if (match_len == 15 && !readLength(src, size, pos, match_len)) return false;
+      match_len += LZ_MIN_MATCH;
+
+      if (offset == 0 || static_cast<size_t>(offset) > out.size() - base) return false;
+      if (out.size() - base + match_len > static_cast<size_t>(raw_size)) return false;
+
+      // Byte at a time, matches may overlap the bytes they produce
+      size_t from = out.size() - offset;
+      for (int i = 0; i < match_len; i++) out.push_back(out[from + i]);
+    }
+    return (out.size() - base == static_cast<size_t>(raw_size));
+  }
+}
+
+
+Avida::BinaryArchive::BinaryArchive(const ArchiveObjectID& obj_id) : m_id(obj_id), m_version(0)
+{
+}
+
+Avida::BinaryArchive::~BinaryArchive() { ; }
+
+
+Avida::ArchiveObjectID Avida::BinaryArchive::ObjectID() const { return m_id; }
+Avida::ArchiveObjectType Avida::BinaryArchive::ObjectType() const { return m_type; }
+int Avida::BinaryArchive::Version() const { return m_version; }
+
+void Avida::BinaryArchive::SetObjectType(ArchiveObjectType obj_type) { m_type = obj_type; }
+void Avida::BinaryArchive::SetVersion(int version) { m_version = version; }
+
+const Avida::PropertyMap& Avida::BinaryArchive::Properties() const { return m_props; }
+
+
+bool Avida::BinaryArchive::AttachProperty(const Property& prop)
+{
+  // Snapshot the current value, the source property may be bound to live state
+  m_props.Define(PropertyPtr(new StringProperty(prop)));
+  return true;
+}
+
+bool Avida::BinaryArchive::AttachValue(const PropertyID& prop_id, const Apto::String& value)
+{
+  return AttachProperty(StringProperty(prop_id, s_prop_desc_map, value));
+}
+
+bool Avida::BinaryArchive::AttachValue(const PropertyID& prop_id, int value)
+{
+  return AttachProperty(StringProperty(prop_id, s_prop_desc_map, value));
+}
+
+bool Avida::BinaryArchive::AttachValue(const PropertyID& prop_id, double value)
+{
+  // Seventeen significant digits round trip every double exactly
+  return AttachProperty(StringProperty(prop_id, PropertyTraits<double>::Type, s_prop_desc_map,
+                                       Apto::FormatStr("%.17g", value)));
+}
+
+
+Avida::ConstArchiveObjectIDSetPtr Avida::BinaryArchive::SubObjectIDs() const
+{
+  ArchiveObjectIDSetPtr ids(new ArchiveObjectIDSet);
+  for (int i = 0; i < m_sub_order.GetSize(); i++) ids->Insert(m_sub_order[i]);
+  return ids;
+}
+
+Avida::ConstArchivePtr Avida::BinaryArchive::SubObject(ArchiveObjectID obj_id) const
+{
+  BinaryArchivePtr sub;
+  if (m_subs.Get(obj_id, sub)) return sub;
+  return ConstArchivePtr(NULL);
+}
+
+Avida::ConstArchivePtr Avida::BinaryArchive::SubObject(int idx) const
+{
+  return SubObject(m_sub_order[idx]);
+}
+
+Avida::ArchivePtr Avida::BinaryArchive::DefineSubObject(ArchiveObjectID obj_id)
+{
+  return DefineSubArchive(obj_id);
+}
+
+Avida::BinaryArchivePtr Avida::BinaryArchive::DefineSubArchive(const ArchiveObjectID& obj_id)
+{
+  BinaryArchivePtr sub;
+  if (!m_subs.Get(obj_id, sub)) {
+    sub = BinaryArchivePtr(new BinaryArchive(obj_id));
+    m_subs.Set(obj_id, sub);
+    m_sub_order.Push(obj_id);
+  }
+  return sub;
+}
+
+
+bool Avida::BinaryArchive::Write(const Apto::String& path) const
+{
+  std::string raw;
+  encode(raw);
+
+  // Written beside the target and renamed over it, so an interrupted write never replaces the previous archive
+  const Apto::String tmp_path = path + ".tmp";
+  std::ofstream out((const char*)tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.good()) return false;
+
+  const unsigned int total_size = raw.size();
+  out.write("AVIDACKP", 8);
+  out.write(reinterpret_cast<const char*>(&ARCHIVE_FORMAT_VERSION), sizeof(ARCHIVE_FORMAT_VERSION));
+  out.write(reinterpret_cast<const char*>(&total_size), sizeof(total_size));
+
+  std::string block;
+  for (size_t offset = 0; offset < raw.size(); offset += ARCHIVE_BLOCK_SIZE) {
+    const unsigned int raw_size = (raw.size() - offset < ARCHIVE_BLOCK_SIZE) ? raw.size() - offset : ARCHIVE_BLOCK_SIZE;
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(raw.data() + offset);
+
+    block.clear();
+    compressBlock(src, raw_size, block);
+
+    const bool stored = (block.size() >= raw_size);
+    const unsigned int stored_size = (stored) ? raw_size : block.size();
+    out.write(reinterpret_cast<const char*>(&raw_size), sizeof(raw_size));
+    out.write(reinterpret_cast<const char*>(&stored_size), sizeof(stored_size));
+    out.write((stored) ? raw.data() + offset : block.data(), stored_size);
+  }
+
+  out.close();
+  if (out.fail()) {
+    remove((const char*)tmp_path);
+    return false;
+  }
+  return (rename((const char*)tmp_path, (const char*)path) == 0);
+}
+
+
+Avida::BinaryArchivePtr Avida::BinaryArchive::Read(const Apto::String& path)
+{
+  std::ifstream in((const char*)path, std::ios::in | std::ios::binary);
+  if (!in.good()) return BinaryArchivePtr(NULL);
+
+  char magic[8];
+  unsigned int version = 0;
+  unsigned int total_size = 0;
+  in.read(magic, 8);
+  in.read(reinterpret_cast<char*>(&version), sizeof(version));
+  in.read(reinterpret_cast<char*>(&total_size), sizeof(total_size));
+  if (!in.good() || memcmp(magic, "AVIDACKP", 8) != 0 || version != ARCHIVE_FORMAT_VERSION) {
+    return BinaryArchivePtr(NULL);
+  }
+
+  std::string raw;
+  raw.reserve(total_size);
+  std::string stored;
+  while (raw.size() < total_size) {
+    unsigned int raw_size = 0;
+    unsigned int stored_size = 0;
+    in.read(reinterpret_cast<char*>(&raw_size), sizeof(raw_size));
+    in.read(reinterpret_cast<char*>(&stored_size), sizeof(stored_size));
+    if (!in.good() || raw_size > ARCHIVE_BLOCK_SIZE || stored_size > raw_size) return BinaryArchivePtr(NULL);
+
+    stored.resize(stored_size);
+    in.read(&stored[0], stored_size);
+    if (!in.good()) return BinaryArchivePtr(NULL);
+
+    if (stored_size == raw_size) {
+      raw.append(stored);
+    } else {
+      const unsigned char* src = reinterpret_cast<const unsigned char*>(stored.data());
+      if (!decompressBlock(src, stored_size, raw_size, raw)) return BinaryArchivePtr(NULL);
+    }
+  }
+  if (raw.size() != total_size) return BinaryArchivePtr(NULL);
+
+  BinaryArchivePtr root(new BinaryArchive);
+  size_t pos = 0;
+  if (!root->decode(raw, pos) || pos != raw.size()) return BinaryArchivePtr(NULL);
+  return root;
+}
+
+
+void Avida::BinaryArchive::encode(std::string& buf) const
+{
+  appendString(buf, m_id);
+  appendString(buf, m_type);
+  appendValue(buf, m_version);
+
+  ConstPropertyIDSetPtr prop_ids = m_props.PropertyIDs();
+  appendValue(buf, static_cast<unsigned int>(prop_ids->GetSize()));
+  for (PropertyIDSet::ConstIterator it = prop_ids->Begin(); it.Next();) {
+    const Property& prop = m_props.Get(*it.Get());
+    appendString(buf, prop.ID());
+    appendString(buf, prop.Type());
+    appendString(buf, prop.StringValue());
+  }
+
+  appendValue(buf, static_cast<unsigned int>(m_sub_order.GetSize()));
+  for (int i = 0; i < m_sub_order.GetSize(); i++) m_subs.Get(m_sub_order[i])->encode(buf);
+}
+
+
+bool Avida::BinaryArchive::decode(const std::string& buf, size_t& pos)
+{
+  if (!readString(buf, pos, m_id) || !readString(buf, pos, m_type) || !readValue(buf, pos, m_version)) return false;
+
+  unsigned int num_props = 0;
+  if (!readValue(buf, pos, num_props)) return false;
+  for (unsigned int i = 0; i < num_props; i++) {
+    Apto::String prop_id;
+    Apto::String prop_type;
+    Apto::String prop_value;
+    if (!readString(buf, pos, prop_id) || !readString(buf, pos, prop_type) || !readString(buf, pos, prop_value)) {
+      return false;
+    }
+    m_props.Define(PropertyPtr(new StringProperty(prop_id, knownType(prop_type), s_prop_desc_map, prop_value)));
+  }
+
+  unsigned int num_subs = 0;
+  if (!readValue(buf, pos, num_subs)) return false;
+  for (unsigned int i = 0; i < num_subs; i++) {
+    BinaryArchivePtr sub(new BinaryArchive);
+    if (!sub->decode(buf, pos)) return false;
+    m_subs.Set(sub->m_id, sub);
+    m_sub_order.Push(sub->m_id);
+  }
+
+  return true;
+}
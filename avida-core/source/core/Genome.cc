@@ -29,6 +29,8 @@
 #include "avida/core/InstructionSequence.h"
 #include "avida/output/File.h"
 
+#include "avida/private/util/MemoryStats.h"
+
 #include "cInstSet.h"
 #include "cHardwareManager.h"
 
@@ -50,12 +52,13 @@ void cHardwareManager::SetupPropertyMap(PropertyMap& props, const Apto::String&
 
 
 
-Avida::Genome::Genome() : m_hw_type(-1) { ; }
+Avida::Genome::Genome() : m_hw_type(-1) { Util::MemoryStats::Created(Util::MemoryStats::GENOMES); }
 
 Avida::Genome::Genome(HardwareTypeID hw, const PropertyMap& props, GeneticRepresentationPtr rep)
   : m_hw_type(hw), m_representation(rep)
 {
   assert(rep);
+  Util::MemoryStats::Created(Util::MemoryStats::GENOMES);
   
   // Copy over properties
   m_props.SetValue(s_prop_id_instset, props.Get(s_prop_id_instset).StringValue());
@@ -63,6 +66,8 @@ Avida::Genome::Genome(HardwareTypeID hw, const PropertyMap& props, GeneticRepres
 
 Avida::Genome::Genome(const Apto::String& genome_str)
 {
+  Util::MemoryStats::Created(Util::MemoryStats::GENOMES);
+  
   // @TODO - unpack genome string more generally
   Apto::String str(genome_str);
   m_hw_type = Apto::StrAs(str.Pop(','));
@@ -73,9 +78,15 @@ Avida::Genome::Genome(const Apto::String& genome_str)
 Avida::Genome::Genome(const Genome& genome)
 : m_hw_type(genome.m_hw_type), m_representation(genome.m_representation->Clone())
 {
+  Util::MemoryStats::Created(Util::MemoryStats::GENOMES);
   m_props.SetValue(s_prop_id_instset, genome.m_props.Get(s_prop_id_instset).StringValue().Clone());
 }
 
+Avida::Genome::~Genome()
+{
+  Util::MemoryStats::Destroyed(Util::MemoryStats::GENOMES);
+}
+
 
 Apto::String Avida::Genome::AsString() const
 {
@@ -108,11 +119,33 @@ Avida::Genome& Avida::Genome::operator=(const Genome& genome)
   return *this;
 }
 
-bool Avida::Genome::Serialize(ArchivePtr) const
+void Avida::Genome::Adopt(Genome& genome)
 {
-  // @TODO - genome serialize
-  assert(false);
-  return false;
+  m_hw_type = genome.m_hw_type;
+  
+  m_props.SetValue(s_prop_id_instset, genome.m_props.Get(s_prop_id_instset).StringValue());
+  
+  // genome is left without a representation, it must be assigned a new one before further use
+  m_representation = genome.m_representation;
+  genome.m_representation = GeneticRepresentationPtr();
+}
+
+void Avida::Genome::Share(const Genome& genome)
+{
+  assert(m_representation && genome.m_representation);
+  assert(*m_representation == *genome.m_representation);
+  m_representation = genome.m_representation;
+}
+
+bool Avida::Genome::Serialize(ArchivePtr ar) const
+{
+  // Same fields as LegacySave, so either form can be loaded back through the legacy property dictionary
+  ar->SetObjectType("core.genome");
+  ar->SetVersion(1);
+  ar->AttachProperty(StringProperty("hw_type", s_prop_desc_map, m_hw_type));
+  ar->AttachProperty(StringProperty("inst_set", s_prop_desc_map, m_props.Get(s_prop_id_instset).StringValue()));
+  ar->AttachProperty(StringProperty("sequence", s_prop_desc_map, m_representation->AsString()));
+  return true;
 }
 
 Avida::GenomePtr Avida::Genome::Deserialize(ArchivePtr)
@@ -345,8 +345,10 @@ void Avida::InstructionSequence::Rotate(int n)
 
 void Avida::InstructionSequence::operator=(const InstructionSequence& other_seq)
 {
+  // Keep the current storage when it can hold the other sequence without being far too large, as adjustCapacity does
+  const int array_size = m_seq.GetSize();
   m_active_size = other_seq.m_active_size;
-  m_seq.ResizeClear(m_active_size);
+  if (m_active_size > array_size || m_active_size * MEMORY_SHRINK_TEST_FACTOR < array_size) m_seq.ResizeClear(m_active_size);
   
   // Now that both code arrays are the same size, copy the other one over
   for (int i = 0; i < m_active_size; i++) m_seq[i] = other_seq[i];
@@ -428,6 +430,25 @@ int Avida::InstructionSequence::MinDistBetween(const Instruction& inst) const
 }
 
 
+unsigned long long Avida::InstructionSequence::Hash() const
+{
+  // FNV-1a over the instruction ops, seeded with the length, followed by a 64-bit finalizer
+  unsigned long long hash = 14695981039346656037ULL ^ (unsigned long long)m_active_size;
+  for (int i = 0; i < m_active_size; i++) {
+    hash ^= (unsigned long long)m_seq[i].GetOp();
+    hash *= 1099511628211ULL;
+  }
+  
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  
+  return hash;
+}
+
+
 Avida::InstructionSequence Avida::InstructionSequence::Crop(int start, int end) const
 {
   assert(end > start);                // Must have a positive length clip!
@@ -544,14 +565,145 @@ int Avida::InstructionSequence::FindSlidingDistance(const InstructionSequence& s
 }
 
 
+namespace {
+  typedef unsigned long long EditWord;
+  const int EDIT_WORD_BITS = 64;
+  
+  // Advance one block of rows of the edit distance chart by a column.  hin is the change along the row above the
+  // block, the change along its bottom row is returned.
+  inline int advanceEditBlock(EditWord& pv, EditWord& mv, EditWord eq, int hin)
+  {
+    const EditWord hin_neg = (hin < 0) ? 1 : 0;
+    const EditWord xv = eq | mv;
+    eq |= hin_neg;
+    const EditWord xh = (((eq & pv) + pv) ^ pv) | eq;
+    EditWord ph = mv | ~(xh | pv);
+    EditWord mh = pv & xh;
+    
+    int hout = 0;
+    if (ph >> (EDIT_WORD_BITS - 1)) hout = 1;
+    else if (mh >> (EDIT_WORD_BITS - 1)) hout = -1;
+    
+    ph = (ph << 1) | ((hin > 0) ? 1 : 0);
+    mh = (mh << 1) | hin_neg;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+  }
+  
+  int findBitEditDistance(const Avida::InstructionSequence& pattern, const Avida::InstructionSequence& text, int start,
+                          int m, int n, int max_dist)
+  {
+    // Myers' bit-vector algorithm in Hyyro's blocked form: each column of the chart is held as the vertical differences
+    // between adjacent rows, one bit per pattern site in each of two words per EDIT_WORD_BITS rows (pv for +1, mv for
+    // -1), and a whole block is advanced one text site with a handful of word operations.  score[b] tracks the chart
+    // value at the bottom row of block b.
+    //
+    // Only rows that can still lie on an alignment within max_dist are kept, as a band of blocks first..last that
+    // follows the diagonal down the chart (Ukkonen's cutoff).  A cell is dropped once its value, or its distance from
+    // the diagonal ending at the bottom-right corner, proves any path through it costs more than max_dist.  Blocks
+    // entering the band below last start from the largest values consistent with the block above, and the block at
+    // first sees its top neighbour grow by one every column; both only overestimate cells that are off every such path.
+    const int num_blocks = (m + EDIT_WORD_BITS - 1) / EDIT_WORD_BITS;
+    
+    // Match masks, per instruction appearing in the pattern, with a final all-zero row for everything else
+    int sym_row[256];
+    for (int i = 0; i < 256; i++) sym_row[i] = -1;
+    int num_syms = 0;
+    for (int i = 0; i < m; i++) {
+      const int op = pattern[start + i].GetOp();
+      if (sym_row[op] == -1) sym_row[op] = num_syms++;
+    }
+    Apto::Array<EditWord> peq((num_syms + 1) * num_blocks);
+    peq.SetAll(0);
+    for (int i = 0; i < m; i++) {
+      peq[sym_row[pattern[start + i].GetOp()] * num_blocks + i / EDIT_WORD_BITS] |= EditWord(1) << (i % EDIT_WORD_BITS);
+    }
+    
+    Apto::Array<EditWord> pv(num_blocks);
+    Apto::Array<EditWord> mv(num_blocks);
+    Apto::Array<int> score(num_blocks);
+    
+    // The top row of the chart is never stored.  A path can run along it for as long as j + |n - j - m| <= max_dist,
+    // so block 0, which it feeds, stays in the band a column beyond that.
+    const int top_row_end = (max_dist + n - m) / 2 + 1;
+    
+    // Column zero is the difference from nothing, climbing by one down every row.
+    int first = 0;
+    int last = Apto::Min(num_blocks - 1, (max_dist - 1) / EDIT_WORD_BITS);
+    for (int b = 0; b <= last; b++) {
+      pv[b] = ~EditWord(0);
+      mv[b] = 0;
+      score[b] = (b + 1) * EDIT_WORD_BITS;
+    }
+    
+    for (int j = 1; j <= n; j++) {
+      const int row = sym_row[text[start + j - 1].GetOp()];
+      const EditWord* eq = &peq[((row == -1) ? num_syms : row) * num_blocks];
+      
+      // Advance the band a column, the top row of the chart growing by one each site of the text
+      int hout = 1;
+      for (int b = first; b <= last; b++) {
+        hout = advanceEditBlock(pv[b], mv[b], eq[b], hout);
+        score[b] += hout;
+      }
+      
+      // Pull in the block below while the bottom of the band, before or after this column, is within max_dist
+      while (last < num_blocks - 1 && (score[last] - hout <= max_dist || score[last] < max_dist)) {
+        last++;
+        pv[last] = ~EditWord(0);
+        mv[last] = 0;
+        const int block_hout = advanceEditBlock(pv[last], mv[last], eq[last], hout);
+        score[last] = score[last - 1] - hout + EDIT_WORD_BITS + block_hout;
+        hout = block_hout;
+      }
+      
+      // Drop blocks off either end of the band that no longer hold a cell of a path within max_dist
+      while (last >= first && (last > 0 || j > top_row_end) && (score[last] >= max_dist + EDIT_WORD_BITS ||
+                               score[last] + (last + 1) * EDIT_WORD_BITS - 2 * (EDIT_WORD_BITS - 1) + n - j - m > max_dist)) {
+        last--;
+      }
+      while (first <= last && (first > 0 || j > top_row_end) && (score[first] >= max_dist + EDIT_WORD_BITS ||
+                               score[first] - (first + 1) * EDIT_WORD_BITS + m - n + j > max_dist)) {
+        first++;
+      }
+      if (first > last) return max_dist + 1;
+    }
+    if (last != num_blocks - 1) return max_dist + 1;
+    
+    // The last block runs past the end of the pattern, walk its bottom score back up to row m.
+    int dist = score[last];
+    for (int bit = m - last * EDIT_WORD_BITS; bit < EDIT_WORD_BITS; bit++) {
+      if ((pv[last] >> bit) & 1) dist--;
+      else if ((mv[last] >> bit) & 1) dist++;
+    }
+    
+    return (dist <= max_dist) ? dist : max_dist + 1;
+  }
+}
+
+
 int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2)
 {
+  // The distance can never exceed the longer length, so this bound leaves the result exact.
+  return FindEditDistance(seq1, seq2, Apto::Max(seq1.GetSize(), seq2.GetSize()));
+}
+
+
+int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2,
+                                                 int max_dist)
+{
+  if (max_dist < 0) return max_dist + 1;
+  
   const int size1 = seq1.GetSize();
   const int size2 = seq2.GetSize();
   const int min_size = (size1 < size2) ? size1 : size2;
   
   // If either size is zero, return the other one!
-  if (!min_size) return (size1 > size2) ? size1 : size2;
+  if (!min_size) return Apto::Min((size1 > size2) ? size1 : size2, max_dist + 1);
+  
+  // The length difference alone has to be made up by insertions or deletions.
+  if (Abs(size1 - size2) > max_dist) return max_dist + 1;
   
   // Count how many direct matches we have at the front and end.
   int match_front = 0, match_end = 0;
@@ -564,50 +716,15 @@ int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1
   
   if (test_size1 <= 0 || test_size2 <=0) return abs(test_size1 - test_size2);
   
-  // Now match everything else...
-  int* cur_row  = new int[test_size1];  // The row we are calculating
-  int* prev_row = new int[test_size1];  // The last row we calculated
-  
-  // Initialize the previous row to record the differece from nothing.
-  for (int i = 0; i < test_size1; i++)  prev_row[i] = i + 1;
-  
-  // Loop through each subsequent character in the test code
-  for (int i = 0; i < test_size2; i++) {
-    // Initialize the first entry in cur_row.
-    if (seq1[match_front] == seq2[match_front + i]) cur_row[0] = i;
-    else cur_row[0] = (i < prev_row[0]) ? (i+1) : (prev_row[0] + 1);
-    
-    // Move down the cur_row and fill it out.
-    for (int j = 1; j < test_size1; j++) {
-      // If the values are equal, keep the value in the upper left.
-      if (seq1[match_front + j] == seq2[match_front + i]) {
-        cur_row[j] = prev_row[j-1];
-      }
-      
-      // Otherwise, set the current position the the minimal of the three
-      // numbers above (insertion), to the left (deletion), or upper left
-      // (mutation) in the chart, plus one.
-      else {
-        cur_row[j] = (prev_row[j] < prev_row[j-1]) ? prev_row[j] : prev_row[j-1];
-        if (cur_row[j-1] < cur_row[j]) cur_row[j] = cur_row[j-1];
-        cur_row[j]++;
-      }
-    }
-    
-    // Swap cur_row and prev_row. (we only really need to move the cur row
-    // over to prev, but this saves us from having to keep re-allocating
-    // new rows.  We recycle!
-    int* temp_row = cur_row;
-    cur_row = prev_row;
-    prev_row = temp_row;
-  }
-  
-  // Now that we are done, return the bottom-right corner of the chart.
-  
-  const int value = prev_row[test_size1 - 1];
+  // The sequences differ somewhere in the middle.
+  if (max_dist == 0) return 1;
   
-  delete [] cur_row;
-  delete [] prev_row;
+  // Now match everything else, using the shorter middle as the pattern down the rows of the chart.
+  const bool swap = (test_size1 > test_size2);
+  const InstructionSequence& pattern = (swap) ? seq2 : seq1;
+  const InstructionSequence& text = (swap) ? seq1 : seq2;
+  const int m = (swap) ? test_size2 : test_size1;
+  const int n = (swap) ? test_size1 : test_size2;
   
-  return value;
+  return findBitEditDistance(pattern, text, match_front, m, n, max_dist);
 }
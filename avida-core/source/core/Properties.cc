@@ -175,9 +175,10 @@ Avida::ConstPropertyIDSetPtr Avida::HashPropertyMap::PropertyIDs() const
 }
 
 
-bool Avida::HashPropertyMap::Serialize(ArchivePtr) const
+bool Avida::HashPropertyMap::Serialize(ArchivePtr ar) const
 {
-  // @TODO
-  assert(false);
-  return false;
+  Apto::Map<PropertyID, PropertyPtr, PropertyMapStorage, Apto::ExplicitDefault>::KeyIterator it = m_prop_map.Keys();
+  while (it.Next()) ar->AttachProperty(*m_prop_map.GetWithDefault(*it.Get(), s_default_prop));
+  
+  return true;
 }
@@ -26,6 +26,8 @@
 
 #include "avida/core/Archive.h"
 
+#include "apto/core/Thread.h"
+
 
 static const int WORLD_ARCHIVE_VERSION = 1;
 
@@ -35,10 +37,131 @@ const Avida::WorldFacetID Avida::Reserved::OutputManagerFacetID("outputmanager")
 const Avida::WorldFacetID Avida::Reserved::SystematicsFacetID("systematics");
 
 
-Avida::World::World()
+// World::UpdatePool - Worker threads that, together with the updating thread, update the facets of a wave
+// --------------------------------------------------------------------------------------------------------------
+
+class Avida::World::UpdatePool
 {
+private:
+  class Worker : public Apto::Thread
+  {
+  private:
+    UpdatePool* m_pool;
+    
+    void Run() { m_pool->work(); }
+    
+  public:
+    Worker(UpdatePool* pool) : m_pool(pool) { ; }
+  };
+  
+  Apto::Array<Worker*> m_workers;
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_done_cond;
+  
+  const Apto::Array<WorldFacetPtr>* m_wave;
+  Context* m_ctx;
+  Update m_update;
+  
+  int m_pass;        // incremented to release the workers for a new wave
+  int m_next_facet;  // next facet of the wave to be claimed
+  int m_facets_done;
+  bool m_terminate;
+  
+  
+  // Update unclaimed facets of the current wave until none are left
+  void updateFacets()
+  {
+    while (true) {
+      m_mutex.Lock();
+      const int facet_idx = m_next_facet;
+      if (facet_idx < m_wave->GetSize()) m_next_facet++;
+      m_mutex.Unlock();
+      
+      if (facet_idx >= m_wave->GetSize()) break;
+      
+      (*m_wave)[facet_idx]->PerformUpdate(*m_ctx, m_update);
+      
+      m_mutex.Lock();
+      const bool all_done = (++m_facets_done == m_wave->GetSize());
+      m_mutex.Unlock();
+      if (all_done) m_done_cond.Signal();
+    }
+  }
+  
+  void work()
+  {
+    int last_pass = 0;
+    while (true) {
+      m_mutex.Lock();
+      while (m_pass == last_pass) m_cond.Wait(m_mutex);
+      last_pass = m_pass;
+      m_mutex.Unlock();
+      
+      if (m_terminate) break;
+      
+      updateFacets();
+    }
+  }
+  
+public:
+  UpdatePool(int num_workers)
+    : m_wave(NULL), m_ctx(NULL), m_update(0), m_pass(0), m_next_facet(0), m_facets_done(0), m_terminate(false)
+  {
+    m_workers.Resize(num_workers);
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i] = new Worker(this);
+      m_workers[i]->Start();
+    }
+  }
+  
+  ~UpdatePool()
+  {
+    m_mutex.Lock();
+    m_terminate = true;
+    m_pass++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+    
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i]->Join();
+      delete m_workers[i];
+    }
+  }
   
+  // Update every facet of wave, returning once all of them are done
+  void UpdateWave(const Apto::Array<WorldFacetPtr>& wave, Context& ctx, Update current_update)
+  {
+    m_mutex.Lock();
+    m_wave = &wave;
+    m_ctx = &ctx;
+    m_update = current_update;
+    m_next_facet = 0;
+    m_facets_done = 0;
+    m_pass++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+    
+    updateFacets();
+    
+    m_mutex.Lock();
+    while (m_facets_done < wave.GetSize()) m_done_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  }
+};
+
+
+
+Avida::World::World() : m_update_pool(NULL)
+{
   
+  
+}
+
+Avida::World::~World()
+{
+  delete m_update_pool;
 }
 
 
@@ -81,7 +204,11 @@ bool Avida::World::AttachFacet(WorldFacetID facet_id, WorldFacetPtr facet)
   
   // Push new facet onto the end, then shift values until it is in position.
   m_facet_order.Push(facet);
-  for (int i = m_facet_order.GetSize() - 1; i > insert_at; i--) m_facet_order.Swap(i, i - 1);
+  m_facet_ids.Push(facet_id);
+  for (int i = m_facet_order.GetSize() - 1; i > insert_at; i--) {
+    m_facet_order.Swap(i, i - 1);
+    m_facet_ids.Swap(i, i - 1);
+  }
   
   if (facet_id == Reserved::DataManagerFacetID) m_data_manager = facet;
   else if (facet_id == Reserved::EnvironmentFacetID) m_environment = facet;
@@ -89,16 +216,57 @@ bool Avida::World::AttachFacet(WorldFacetID facet_id, WorldFacetPtr facet)
   else if (facet_id == Reserved::SystematicsFacetID) m_systematics = facet;
   
   m_facets[facet_id] = facet;
-        
-        
+  
+  buildUpdateWaves();
+  
   return true;
 }
 
 void Avida::World::PerformUpdate(Context& ctx, Update current_update)
 {
+  if (!m_update_pool) {
+    for (int i = 0; i < m_facet_order.GetSize(); i++) {
+      m_facet_order[i]->PerformUpdate(ctx, current_update);
+    }
+    return;
+  }
+  
+  for (int wave = 0; wave < m_update_waves.GetSize(); wave++) {
+    if (m_update_waves[wave].GetSize() == 1) m_update_waves[wave][0]->PerformUpdate(ctx, current_update);
+    else m_update_pool->UpdateWave(m_update_waves[wave], ctx, current_update);
+  }
+}
+
+
+void Avida::World::SetUpdateThreads(int num_threads)
+{
+  delete m_update_pool;
+  m_update_pool = NULL;
+  
+  if (num_threads < 0) num_threads = Apto::Platform::AvailableCPUs();
+  if (num_threads > 1) m_update_pool = new UpdatePool(num_threads - 1);
+}
+
+
+void Avida::World::buildUpdateWaves()
+{
+  // m_facet_order is already consistent with every constraint, so each facet's wave is one past the latest wave of
+  // the facets it must follow
+  Apto::Array<int> facet_wave(m_facet_order.GetSize());
+  int num_waves = 0;
   for (int i = 0; i < m_facet_order.GetSize(); i++) {
-    m_facet_order[i]->PerformUpdate(ctx, current_update);
+    facet_wave[i] = 0;
+    for (int j = 0; j < i; j++) {
+      const bool depends = (m_facet_order[i]->UpdateAfter() == m_facet_ids[j] ||
+                            m_facet_order[j]->UpdateBefore() == m_facet_ids[i]);
+      if (depends && facet_wave[j] + 1 > facet_wave[i]) facet_wave[i] = facet_wave[j] + 1;
+    }
+    if (facet_wave[i] + 1 > num_waves) num_waves = facet_wave[i] + 1;
   }
+  
+  m_update_waves.Resize(num_waves);
+  for (int wave = 0; wave < num_waves; wave++) m_update_waves[wave].Resize(0);
+  for (int i = 0; i < m_facet_order.GetSize(); i++) m_update_waves[facet_wave[i]].Push(m_facet_order[i]);
 }
 
 
@@ -22,6 +22,8 @@
 
 #include "cCPUMemory.h"
 
+#include <cstring>
+
 using namespace std;
 using namespace Avida;
 
@@ -54,6 +56,30 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
 }
 
 
+int cCPUMemory::countFlag(unsigned char mask, int begin, int end) const
+{
+  assert(begin >= 0 && end <= m_active_size);
+  
+  // Test eight sites at a time, one flag byte per lane of a 64-bit word
+  const unsigned long long lanes = 0x0101010101010101ULL * mask;
+  int count = 0;
+  int i = begin;
+  for (; i + 8 <= end; i += 8) {
+    unsigned long long word;
+    memcpy(&word, &m_flag_array[i], sizeof(word));
+    word &= lanes;
+#ifdef __GNUC__
+    count += __builtin_popcountll(word);
+#else
+    for (; word; word &= word - 1) count++;
+#endif
+  }
+  for (; i < end; i++) if (m_flag_array[i] & mask) count++;
+  
+  return count;
+}
+
+
 void cCPUMemory::Reset(int new_size)
 {
   assert(new_size >= 0);
@@ -42,6 +42,7 @@ private:
 
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
+  int countFlag(unsigned char mask, int begin, int end) const;
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
@@ -71,6 +72,10 @@ public:
 	inline void ClearFlagCopyMut(int pos)    { m_flag_array[pos] &= ~MASK_COPYMUT;  }
   inline void ClearFlagInjected(int pos)   { m_flag_array[pos] &= ~MASK_INJECTED; }
   
+  // Number of sites in [begin, end) with the flag set
+  inline int CountFlagCopied(int begin, int end) const   { return countFlag(MASK_COPIED, begin, end); }
+  inline int CountFlagExecuted(int begin, int end) const { return countFlag(MASK_EXECUTED, begin, end); }
+  
   
   void Clear()
 	{
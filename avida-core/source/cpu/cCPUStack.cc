@@ -28,22 +28,6 @@
 using namespace std;
 
 
-cCPUStack::cCPUStack(const cCPUStack & in_stack)
-{
-  for (int i = 0; i < nHardware::STACK_SIZE; i++) {
-    stack[i] = in_stack.stack[i];
-  }
-  stack_pointer = in_stack.stack_pointer;
-}
-
-void cCPUStack::operator=(const cCPUStack & in_stack)
-{
-  for (int i = 0; i < nHardware::STACK_SIZE; i++) {
-    stack[i] = in_stack.stack[i];
-  }
-  stack_pointer = in_stack.stack_pointer;
-}
-
 void cCPUStack::Flip()
 {
   int new_stack[nHardware::STACK_SIZE];
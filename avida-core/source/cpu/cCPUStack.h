@@ -23,12 +23,15 @@
 #ifndef cCPUStack_h
 #define cCPUStack_h
 
+#include <cstring>
 #include <iostream>
 
 #ifndef nHardware_h
 #include "nHardware.h"
 #endif
 
+// The stack is a fixed ring of nHardware::STACK_SIZE values stored inline, so it holds no pointers and the compiler
+// generated copy (made whenever a thread forks or hardware is reset) is a plain copy of the few dozen bytes.
 class cCPUStack
 {
 private:
@@ -37,10 +40,6 @@ private:
 
 public:
   cCPUStack() { Clear(); }
-  cCPUStack(const cCPUStack& in_stack);
-  ~cCPUStack() { ; }
-
-  void operator=(const cCPUStack& in_stack);
 
   inline void Push(int value);
   inline int Pop();
@@ -81,7 +80,7 @@ inline int cCPUStack::Get(int depth) const
 
 inline void cCPUStack::Clear()
 {
-  for (int i = 0; i < nHardware::STACK_SIZE; i++) stack[i] = 0;
+  memset(stack, 0, sizeof(stack));
   stack_pointer = 0;
 }
 
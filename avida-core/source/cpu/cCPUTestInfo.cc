@@ -38,6 +38,7 @@ cCPUTestInfo::cCPUTestInfo(int max_tests)
   , use_random_inputs(false)
   , use_manual_inputs(false)
   , m_tracer(NULL)
+  , m_record_site_exec(false)
   , m_cur_sg(0)
   , org_array(max_tests)
   , m_res_method(RES_INITIAL)
@@ -64,6 +65,7 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
   manual_inputs = test_info.manual_inputs; 
   if (test_info.m_tracer) { m_tracer = test_info.m_tracer; }
   m_mut_rates = test_info.m_mut_rates;
+  m_record_site_exec = test_info.m_record_site_exec;
   m_cur_sg = test_info.m_cur_sg;
   is_viable = test_info.is_viable;
   max_depth = test_info.max_depth;
@@ -71,6 +73,7 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
   max_cycle = test_info.max_cycle;
   cycle_to = test_info.cycle_to;
   used_inputs = test_info.used_inputs; 
+  m_site_first_exec = test_info.m_site_first_exec;
   org_array = test_info.org_array;
   m_res_method = test_info.m_res_method;
   m_res = NULL;  //Beware -- Resource history is NOT COPIED.
@@ -95,6 +98,7 @@ void cCPUTestInfo::Clear()
   depth_found = -1;
   max_cycle = 0;
   cycle_to = -1;
+  m_site_first_exec.Resize(0);
 
   for (int i = 0; i < generation_tests; i++) {
     if (org_array[i] == NULL) break;
@@ -55,6 +55,7 @@ private:
   Apto::Array<int> manual_inputs;  //   if so, use these.
   HardwareTracerPtr m_tracer;
   cMutationRates m_mut_rates;
+  bool m_record_site_exec;    // Should we record when each site of the tested genome is first executed?
   
   int m_cur_sg;
 
@@ -65,6 +66,7 @@ private:
   int max_cycle;          // Longest cycle found.
   int cycle_to;           // Cycle path of the last genotype.
 	Apto::Array<int> used_inputs; //Depth 0 inputs
+  Apto::Array<int> m_site_first_exec; // Depth 0 cycle at which each site was first executed (-1 if never)
 
   Apto::Array<cOrganism*> org_array;
   
@@ -89,8 +91,10 @@ public:
   void UseManualInputs(Apto::Array<int> inputs) {use_manual_inputs = true; use_random_inputs = false; manual_inputs = inputs;}
   void ResetInputMode() {use_manual_inputs = false; use_random_inputs = false;}
   void SetTraceExecution(HardwareTracerPtr tracer) { m_tracer = tracer; }
+  void RecordSiteExecution(bool record = true) { m_record_site_exec = record; }
   void SetResourceOptions(int res_method = RES_INITIAL, cResourceHistory* res = NULL, int update = 0, int cpu_cycle_offset = 0)
     { m_res_method = (eTestCPUResourceMethod)res_method; m_res = res; m_res_update = update; m_res_cpu_cycle_offset = cpu_cycle_offset; }
+  void SetResourceUpdate(int update) { m_res_update = update; }
   
   void SetCurrentStateGridID(int sg) { m_cur_sg = sg; }
   cMutationRates& MutationRates() { return m_mut_rates; }
@@ -110,6 +114,7 @@ public:
   int GetDepthFound() const { return depth_found; }
   int GetMaxCycle() const { return max_cycle; }
   int GetCycleTo() const { return cycle_to; }
+  const Apto::Array<int>& GetSiteFirstExecuted() const { return m_site_first_exec; }
 
   // Genotype Stats...
   inline cOrganism* GetTestOrganism(int level = 0);
@@ -31,19 +31,16 @@
 using namespace std;
 
 
-const int cCodeLabel::MAX_LENGTH = 10;
+const int cCodeLabel::MAX_LENGTH;
 
 
 void cCodeLabel::ReadString(const cString& label_str)
 {
   cString lbl(label_str);
   lbl.Trim();
-  m_nops.Resize(lbl.GetSize());
+  Clear();
   
-  for (int i = 0; i < lbl.GetSize(); i++) {
-    int nop = lbl[i] - 'A';
-    m_nops[i] =  nop;
-  }
+  for (int i = 0; i < lbl.GetSize(); i++) AddNop(lbl[i] - 'A');
 }
 
 
@@ -51,17 +48,10 @@ void cCodeLabel::ReadString(const cString& label_str)
 // the label affected.
 int cCodeLabel::FindSublabel(const cCodeLabel& sub_label) const
 {
-  bool error = false;
-
-  for (int offset = 0; offset <= m_nops.GetSize() - sub_label.GetSize(); offset++) {
-    for (int i = 0; i < sub_label.GetSize(); i++) {
-      if (m_nops[i + offset] != sub_label[i]) {
-	error = true;
-	break;
-      }
-    }
-    if (!error) return offset;
-    error = false;
+  const unsigned long long mask = lowMask(sub_label.m_size);
+  
+  for (int offset = 0; offset <= m_size - sub_label.m_size; offset++) {
+    if (((m_nops >> (BITS_PER_NOP * offset)) & mask) == sub_label.m_nops) return offset;
   }
 
   return -1;
@@ -81,9 +71,9 @@ int cCodeLabel::AsInt(const int base) const
 {
   int value = 0;
 
-  for (int i = 0; i < m_nops.GetSize(); i++) {
+  for (int i = 0; i < m_size; i++) {
     value *= base;
-    value += m_nops[i];
+    value += (*this)[i];
   }
 
   return value;
@@ -94,16 +84,16 @@ int cCodeLabel::AsIntGreyCode(const int base) const
   int value = 0;
   int oddCount = 0;
 
-  for (int i = 0; i < m_nops.GetSize(); i++) {
+  for (int i = 0; i < m_size; i++) {
     value *= base;
 
     if(oddCount % 2 == 0) {
-      value += m_nops[i];
+      value += (*this)[i];
     } else {
-      value += (base - 1) - m_nops[i];
+      value += (base - 1) - (*this)[i];
     }
 
-    if(m_nops[i] % 2 == 1) {
+    if((*this)[i] % 2 == 1) {
       oddCount++;
     }
   }
@@ -115,9 +105,9 @@ int cCodeLabel::AsIntDirect(const int base) const
 {
   int value = 0;
   
-  for (int i = 0; i < m_nops.GetSize(); i++) {
+  for (int i = 0; i < m_size; i++) {
     value *= base;
-    value += m_nops[i];
+    value += (*this)[i];
   }
 
   return value;
@@ -139,9 +129,9 @@ int cCodeLabel::AsIntUnique(const int base) const
 {
   int value = 0;
   
-  for (int i = 0; i < m_nops.GetSize(); i++) {
+  for (int i = 0; i < m_size; i++) {
     value *= base;
-    value += m_nops[i] + 1;
+    value += (*this)[i] + 1;
   }
   
   return value;
@@ -151,16 +141,16 @@ int cCodeLabel::AsIntAdditivePolynomial(const int) const
 {
   double value = 0.0;
 
-  for (int i = 0; i < m_nops.GetSize(); i++) {
+  for (int i = 0; i < m_size; i++) {
 #if 1
-    int n = (int)m_nops[i] + 1;
-    double a = pow((double)n, 0.4 * (double)(m_nops.GetSize() - 1));
-    double b = 0.3 * (double)i * (double)(m_nops.GetSize() - 1);
+    int n = (int)(*this)[i] + 1;
+    double a = pow((double)n, 0.4 * (double)(m_size - 1));
+    double b = 0.3 * (double)i * (double)(m_size - 1);
     double c = 0.45 * (double)i;
     value += a + b + c;
 #else
-    value += (pow(((double)m_nops[i] + 1.0), (0.4 * (double)(m_nops.GetSize() - 1))) +
-	      (0.3 * (double)i * (double)(m_nops.GetSize() - 1)) +
+    value += (pow(((double)(*this)[i] + 1.0), (0.4 * (double)(m_size - 1))) +
+	      (0.3 * (double)i * (double)(m_size - 1)) +
 	      (0.45 * (double)i));
 #endif
   }
@@ -182,8 +172,8 @@ int cCodeLabel::AsIntFib(const int base) const
     fib[i] = fib[i-2] + fib[i-1];
   }
 
-  for (int i = 0; i < m_nops.GetSize(); i++) {
-    value += fib[(int)m_nops[i]];
+  for (int i = 0; i < m_size; i++) {
+    value += fib[(int)(*this)[i]];
 
     fib[2] = fib[base-2] + fib[base-1];
     fib[1] = fib[base-1];
@@ -199,18 +189,18 @@ int cCodeLabel::AsIntPolynomialCoefficent(const int base) const
 {
   int value = 0;
 
-  int extra = m_nops.GetSize() % 2;
+  int extra = m_size % 2;
   int c = 1;
 
-  for (int i = 0; i < m_nops.GetSize() - extra; i+=2, c++) {
-    int b = m_nops[i];
-    int a = m_nops[i+1];
+  for (int i = 0; i < m_size - extra; i+=2, c++) {
+    int b = (*this)[i];
+    int a = (*this)[i+1];
 
     value += (int)pow((double)((a * base) + b), c);
   }
 
   if(extra) {
-    value += (int)pow((double)m_nops[m_nops.GetSize() - 1], c);
+    value += (int)pow((double)(*this)[m_size - 1], c);
   }
 
   return value;
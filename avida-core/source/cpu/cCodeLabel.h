@@ -28,6 +28,8 @@
 #include "cString.h"
 #include "nHardware.h"
 
+#include <cassert>
+
 /**
  * The cCodeLabel class is used to identify a label within the genotype of
  * a creature, and aid in its manipulation.
@@ -36,31 +38,44 @@
 class cCodeLabel
 {
 public:
-  static const int MAX_LENGTH;
+  static const int MAX_LENGTH = 10;
   
 private:
-  Apto::Array<char, Apto::Smart> m_nops;
+  // Nops are packed into a single word, nop i in bits [BITS_PER_NOP * i, BITS_PER_NOP * (i + 1)), so that copying,
+  // comparing and searching labels are a handful of register operations.  Bits past the last nop are always zero.
+  static const int BITS_PER_NOP = 5;
+  static const unsigned long long NOP_MASK = (1ULL << BITS_PER_NOP) - 1;
+  
+  unsigned long long m_nops;
+  int m_size;
+  
+  static inline unsigned long long lowMask(int size) { return (1ULL << (BITS_PER_NOP * size)) - 1; }
 
 public:
-  inline cCodeLabel() { m_nops.SetReserve(MAX_LENGTH); }
-  inline cCodeLabel(const cCodeLabel& in_label) : m_nops(in_label.m_nops) { ; }
+  inline cCodeLabel() : m_nops(0), m_size(0) { ; }
+  inline cCodeLabel(const cCodeLabel& in_label) : m_nops(in_label.m_nops), m_size(in_label.m_size) { ; }
   ~cCodeLabel() { ; }
 
-  inline bool operator==(const cCodeLabel& other_label) const;
+  inline bool operator==(const cCodeLabel& other_label) const
+    { return m_nops == other_label.m_nops && m_size == other_label.m_size; }
   inline bool operator!=(const cCodeLabel& other_label) const { return !(operator==(other_label)); }
-  inline char operator[](int position) const { return (int) m_nops[position]; }
-  inline cCodeLabel& operator=(const cCodeLabel& in_lbl) { m_nops = in_lbl.m_nops; return *this; }
+  inline char operator[](int position) const
+    { assert(position >= 0 && position < m_size); return (char)((m_nops >> (BITS_PER_NOP * position)) & NOP_MASK); }
+  inline cCodeLabel& operator=(const cCodeLabel& in_lbl) { m_nops = in_lbl.m_nops; m_size = in_lbl.m_size; return *this; }
 
   void ReadString(const cString& label_str);
   
   int FindSublabel(const cCodeLabel& sub_label) const;
   inline bool Contains(const cCodeLabel& sub_label) const { return (FindSublabel(sub_label) >= 0); }
 
-  inline void Clear() { m_nops.Resize(0); }
+  inline void Clear() { m_nops = 0; m_size = 0; }
   inline void AddNop(int nop_num);
   inline void Rotate(const int rot, const int base);
 
-  inline int GetSize() const { return m_nops.GetSize(); }
+  inline int GetSize() const { return m_size; }
+  
+  // Distinct for every distinct label, for use as a hash or map key
+  inline unsigned long long AsPacked() const { return (m_nops << 4) | (unsigned long long)m_size; }
   
   inline cString AsString() const;
   
@@ -76,38 +91,33 @@ public:
 
 inline void cCodeLabel::AddNop(int nop_num)
 {
-  if (m_nops.GetSize() < MAX_LENGTH) {
-    m_nops.Push((char)nop_num);
+  assert(nop_num >= 0 && (unsigned long long)nop_num <= NOP_MASK);
+  if (m_size < MAX_LENGTH) {
+    m_nops |= (unsigned long long)nop_num << (BITS_PER_NOP * m_size);
+    m_size++;
   }
 }
 
 inline void cCodeLabel::Rotate(const int rot, const int base)
 {
-  for (int i = 0; i < m_nops.GetSize(); i++) {
-    m_nops[i] += rot;
-    if (m_nops[i] >= base) m_nops[i] -= base;
+  unsigned long long rotated = 0;
+  for (int i = 0; i < m_size; i++) {
+    int nop = (int)((m_nops >> (BITS_PER_NOP * i)) & NOP_MASK) + rot;
+    if (nop >= base) nop -= base;
+    rotated |= (unsigned long long)nop << (BITS_PER_NOP * i);
   }
+  m_nops = rotated;
 }
 
 
 inline cString cCodeLabel::AsString() const
 {
   cString out_string;
-  for (int i = 0; i < m_nops.GetSize(); i++) {
-    out_string += m_nops[i] + 'A';
+  for (int i = 0; i < m_size; i++) {
+    out_string += (*this)[i] + 'A';
   }
 
   return out_string;
 }
 
-
-inline bool cCodeLabel::operator==(const cCodeLabel & other_label) const
-{
-  if (m_nops.GetSize() != other_label.GetSize()) return false;
-  
-  for (int i = 0; i < m_nops.GetSize(); i++) if (m_nops[i] != other_label[i]) return false;
-  
-  return true;
-}
-
 #endif
@@ -49,7 +49,7 @@ using namespace Avida;
 using namespace AvidaTools;
 
 
-tInstLib<cHardwareBCR::tMethod>* cHardwareBCR::s_inst_slib = cHardwareBCR::initInstLib();
+tInstLib<cHardwareBCR::tMethod>* cHardwareBCR::s_inst_slib = NULL;
 
 tInstLib<cHardwareBCR::tMethod>* cHardwareBCR::initInstLib(void)
 {
@@ -289,7 +289,7 @@ tInstLib<cHardwareBCR::tMethod>* cHardwareBCR::initInstLib(void)
 cHardwareBCR::cHardwareBCR(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set)
 : cHardwareBase(world, in_organism, in_inst_set), m_genes(0), m_mem_array(1), m_sensor(world, in_organism), m_sensor_sessions(NUM_NOPS)
 {
-  m_functions = s_inst_slib->GetFunctions();
+  m_functions = GetInstLib()->GetFunctions();
   
   m_spec_die = false;
   
@@ -627,7 +627,11 @@ bool cHardwareBCR::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instructi
   m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
   
   // And execute it.
+  cInstProfiler::tTicks sample_start = 0;
+  const bool sampled = beginInstSample(sample_start);
+  const cInstSet* sample_inst_set = m_inst_set;
   const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  if (sampled) endInstSample(sample_inst_set, actual_inst.GetOp(), sample_start);
   
   // decremenet if the instruction was not executed successfully
   if (exec_success == false) {
@@ -1285,12 +1289,8 @@ inline int cHardwareBCR::FindUpstreamModifiedRegister(int offset, int default_re
 
 int cHardwareBCR::calcCopiedSize(const int parent_size, const int child_size)
 {
-  int copied_size = 0;
   const cCPUMemory& memory = m_mem_array[m_cur_offspring];
-  for (int i = 0; i < memory.GetSize(); i++) {
-    if (memory.FlagCopied(i)) copied_size++;
-	}
-  return copied_size;
+  return memory.CountFlagCopied(0, memory.GetSize());
 }
 
 
@@ -1311,7 +1311,7 @@ bool cHardwareBCR::Divide_Main(cAvidaContext& ctx, int mem_space_used, int write
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
   
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
 	
   // Handle Divide Mutations...
   Divide_DoMutations(ctx, mut_multiplier);
@@ -2393,11 +2393,10 @@ bool cHardwareBCR::Inst_Repro(cAvidaContext& ctx)
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;  
+  m_organism->OffspringGenome().Adopt(offspring);  
   m_organism->GetPhenotype().SetLinesCopied(memory.GetSize());
   
-  int lines_executed = 0;
-  for (int i = 0; i < memory.GetSize(); i++) if (memory.FlagExecuted(i)) lines_executed++;
+  const int lines_executed = memory.CountFlagExecuted(0, memory.GetSize());
   m_organism->GetPhenotype().SetLinesExecuted(lines_executed);
   
   const Genome& org = m_organism->GetGenome();
@@ -2412,9 +2411,22 @@ bool cHardwareBCR::Inst_Repro(cAvidaContext& ctx)
 
   // Perform Copy Mutations...
   if (m_organism->GetCopyMutProb() > 0) { // Skip this if no mutations....
-    for (int i = 0; i < child_seq.GetSize(); i++) {
-//    for (int i = 0; i < m_memory.GetSize(); i++) {
-      if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+    if (m_world->GetConfig().COPY_MUT_SKIP.Get()) {
+      // Jump straight to each mutated site rather than testing every one
+      const double prob = m_organism->GetCopyMutProb();
+      const int size = child_seq.GetSize();
+      int i = ctx.GetTrialsToNextEvent(prob);
+      while (i < size) {
+        child_seq[i] = m_inst_set->GetRandomInst(ctx);
+        const int skip = ctx.GetTrialsToNextEvent(prob);
+        if (skip >= size - i - 1) break;
+        i += skip + 1;
+      }
+    } else {
+      for (int i = 0; i < child_seq.GetSize(); i++) {
+//      for (int i = 0; i < m_memory.GetSize(); i++) {
+        if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+      }
     }
   }
   
@@ -3701,7 +3713,7 @@ bool cHardwareBCR::Inst_AttackFTPrey(cAvidaContext& ctx)
     if (!target->IsPreyFT())  { return false; }
   }    
   else if (m_use_avatar == 2) {
-    const Apto::Array<cOrganism*>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
+    const Apto::Array<cOrganism*, Apto::Smart>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
     bool target_match = false;
     int rand_index = ctx.GetRandom().GetUInt(0, av_neighbors.GetSize());
     int j = 0;
@@ -289,7 +289,7 @@ public:
   cHardwareBCR(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set);
   ~cHardwareBCR() { ; }
   
-  static tInstLib<cHardwareBCR::tMethod>* GetInstLib() { return s_inst_slib; }
+  static tInstLib<cHardwareBCR::tMethod>* GetInstLib() { if (!s_inst_slib) s_inst_slib = initInstLib(); return s_inst_slib; }
   
   
   // --------  Core Execution Methods  --------
@@ -31,6 +31,7 @@
 #include "cEnvironment.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
+#include "cHardwareTraceRecorder.h"
 #include "cHeadCPU.h"
 #include "cInstSet.h"
 #include "cOrganism.h"
@@ -53,6 +54,7 @@ cHardwareBase::cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* in
 , m_has_res_costs(m_inst_set->HasResCosts()), m_has_fem_res_costs(m_inst_set->HasFemResCosts())
 , m_has_female_costs(m_inst_set->HasFemaleCosts()), m_has_choosy_female_costs(m_inst_set->HasChoosyFemaleCosts())
 , m_has_post_costs(inst_set->HasPostCosts()), m_has_bonus_costs(inst_set->HasBonusCosts())
+, m_inst_profiler(world->GetHardwareManager().GetInstProfiler()), m_inst_sample_countdown(0)
 {
 	m_task_switching_cost=0;
 	int switch_cost =  world->GetConfig().TASK_SWITCH_PENALTY.Get();
@@ -63,6 +65,7 @@ cHardwareBase::cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* in
                              m_world->GetConfig().IMPLICIT_REPRO_BONUS.Get() ||
                              m_world->GetConfig().IMPLICIT_REPRO_END.Get() ||
                              m_world->GetConfig().IMPLICIT_REPRO_ENERGY.Get());
+  if (m_inst_profiler) m_inst_sample_countdown = m_inst_profiler->GetInterval();
 	
   assert(m_organism != NULL);
 }
@@ -129,12 +132,7 @@ void cHardwareBase::ResizeCostArrays(int new_size)
 
 int cHardwareBase::calcExecutedSize(const int parent_size)
 {
-  int executed_size = 0;
-  const cCPUMemory& memory = GetMemory();
-  for (int i = 0; i < parent_size; i++) {
-    if (memory.FlagExecuted(i)) executed_size++;
-  }  
-  return executed_size;
+  return GetMemory().CountFlagExecuted(0, parent_size);
 }
 
 bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size, const int child_size, bool using_repro)
@@ -153,21 +151,22 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
   
   const int genome_size = seq.GetSize();
 
-  const int juv_age = m_world->GetConfig().JUV_PERIOD.Get();
+  const cRuntimeConfig& rt_conf = m_world->GetRuntimeConfig();
+  const int juv_age = rt_conf.juv_period;
   const int parent_age = m_organism->GetPhenotype().GetTimeUsed();
   if (parent_age < juv_age) {
     ORG_FAULT(cStringUtil::Stringf("Org is juvenile (%d < %d)", parent_age, juv_age));
     return false;
   }
   
-  const int min_age = m_world->GetConfig().MIN_CYCLES.Get();
+  const int min_age = rt_conf.min_cycles;
   if (parent_age < min_age) {
     ORG_FAULT(cStringUtil::Stringf("Org too young (%d < %d)", parent_age, min_age));
     return false;
   }
 
   // Make sure that neither parent nor child will be below the minimum size.  
-  const double size_range = m_world->GetConfig().OFFSPRING_SIZE_RANGE.Get();
+  const double size_range = rt_conf.offspring_size_range;
   const int min_size = Apto::Max(MIN_GENOME_LENGTH, static_cast<int>(genome_size / size_range));
   const int max_size = Apto::Min(MAX_GENOME_LENGTH, static_cast<int>(genome_size * size_range));
   
@@ -181,8 +180,8 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
   }
   
   // Absolute minimum and maximum child/parent size limits -- @JEB
-  const int max_genome_size = m_world->GetConfig().MAX_GENOME_SIZE.Get();
-  const int min_genome_size = m_world->GetConfig().MIN_GENOME_SIZE.Get();
+  const int max_genome_size = rt_conf.max_genome_size;
+  const int min_genome_size = rt_conf.min_genome_size;
   if ( (min_genome_size && (child_size < min_genome_size)) || (max_genome_size && (child_size > max_genome_size)) ) {
     ORG_FAULT(cStringUtil::Stringf("Invalid absolute offspring length (%d)",child_size));
     return false; // (divide fails)
@@ -197,7 +196,7 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
   // specified fraction has been reached.
   
   const int executed_size = calcExecutedSize(parent_size);
-  const int min_exe_lines = static_cast<int>(parent_size * m_world->GetConfig().MIN_EXE_LINES.Get());
+  const int min_exe_lines = static_cast<int>(parent_size * rt_conf.min_exe_lines);
   if (executed_size < min_exe_lines) {
     ORG_FAULT(cStringUtil::Stringf("Too few executed lines (%d < %d)", executed_size, min_exe_lines));
     return false; // (divide fails)
@@ -208,7 +207,7 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
   if (!using_repro) {
     // Normal organisms check to see how much was copied
     copied_size = calcCopiedSize(parent_size, child_size); // Fails for REPRO organisms
-    const int min_copied = static_cast<int>(child_size * m_world->GetConfig().MIN_COPIED_LINES.Get());
+    const int min_copied = static_cast<int>(child_size * rt_conf.min_copied_lines);
     
     if (copied_size < min_copied) {
       ORG_FAULT(cStringUtil::Stringf("Too few copied commands (%d < %d)", copied_size, min_copied));
@@ -216,10 +215,10 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
     }
   }
 
-  if (m_world->GetConfig().USE_FORM_GROUPS.Get()) {
+  if (rt_conf.use_form_groups) {
     if (!m_organism->GetOrgInterface().HasOpinion(m_organism)) {
-      if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) {
-        m_organism->GetOrgInterface().SetOpinion(m_world->GetConfig().DEFAULT_GROUP.Get(), m_organism);
+      if (rt_conf.default_group != -1) {
+        m_organism->GetOrgInterface().SetOpinion(rt_conf.default_group, m_organism);
       } else {
         // No default group, so divide fails (group opinion is required by cPopulation::ActivateOffspring)
         return false;
@@ -229,7 +228,7 @@ bool cHardwareBase::Divide_CheckViable(cAvidaContext& ctx, const int parent_size
   
   if (m_organism->Divide_CheckViable(ctx) == false) 
   {
-    if (m_world->GetConfig().DIVIDE_FAILURE_RESETS.Get())
+    if (rt_conf.divide_failure_resets)
     {
       internalResetOnFailedDivide();
     }
@@ -1163,6 +1162,11 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
   return totalMutations;
 }
 
+void cHardwareBase::PointMutateSite(cAvidaContext& ctx, int site)
+{
+  GetMemory()[site] = m_inst_set->GetRandomInst(ctx);
+}
+
 
 
 tBuffer<int>& cHardwareBase::GetInputBuf() 
@@ -1188,11 +1192,12 @@ void cHardwareBase::checkImplicitRepro(cAvidaContext& ctx, bool exec_last_inst)
   //Dividing a dead organism causes all kinds of problems
   if (m_organism->IsDead()) return;
   
-  if( (m_world->GetConfig().IMPLICIT_REPRO_TIME.Get() && (m_organism->GetPhenotype().GetTimeUsed() >= m_world->GetConfig().IMPLICIT_REPRO_TIME.Get()))
-     || (m_world->GetConfig().IMPLICIT_REPRO_CPU_CYCLES.Get() && (m_organism->GetPhenotype().GetCPUCyclesUsed() >= m_world->GetConfig().IMPLICIT_REPRO_CPU_CYCLES.Get()))
-     || (m_world->GetConfig().IMPLICIT_REPRO_BONUS.Get() && (m_organism->GetPhenotype().GetCurBonus() >= m_world->GetConfig().IMPLICIT_REPRO_BONUS.Get()))
-     || (m_world->GetConfig().IMPLICIT_REPRO_END.Get() && exec_last_inst)
-     || (m_world->GetConfig().IMPLICIT_REPRO_ENERGY.Get() && (m_organism->GetPhenotype().GetStoredEnergy() >= m_world->GetConfig().IMPLICIT_REPRO_ENERGY.Get())) )
+  const cRuntimeConfig& rt_conf = m_world->GetRuntimeConfig();
+  if( (rt_conf.implicit_repro_time && (m_organism->GetPhenotype().GetTimeUsed() >= rt_conf.implicit_repro_time))
+     || (rt_conf.implicit_repro_cpu_cycles && (m_organism->GetPhenotype().GetCPUCyclesUsed() >= rt_conf.implicit_repro_cpu_cycles))
+     || (rt_conf.implicit_repro_bonus && (m_organism->GetPhenotype().GetCurBonus() >= rt_conf.implicit_repro_bonus))
+     || (rt_conf.implicit_repro_end && exec_last_inst)
+     || (rt_conf.implicit_repro_energy && (m_organism->GetPhenotype().GetStoredEnergy() >= rt_conf.implicit_repro_energy)) )
   {
     Inst_Repro(ctx);
   }
@@ -1235,12 +1240,24 @@ bool cHardwareBase::Inst_DefaultEnergyUsage(cAvidaContext& ctx)
 }
 
 
+void cHardwareBase::endInstSample(const cInstSet* inst_set, int op, cInstProfiler::tTicks start)
+{
+  const cInstProfiler::tTicks end = cInstProfiler::Ticks();
+  m_inst_profiler->Record(inst_set, op, end - start);
+
+  // Jitter the gap to the next sample with the clock, so that loops whose length divides the interval are not always
+  // sampled at the same instruction.  The world's random number generator is left alone so runs are unchanged.
+  const int interval = m_inst_profiler->GetInterval();
+  m_inst_sample_countdown = 1 + (int)(end % (cInstProfiler::tTicks)(2 * interval));
+}
+
+
 // This method will test to see if all costs have been paid associated
 // with executing an instruction and only return true when that instruction
 // should proceed.
 bool cHardwareBase::SingleProcess_PayPreCosts(cAvidaContext& ctx, const Instruction& cur_inst, const int thread_id)
 { 
-  if (m_world->GetConfig().ENERGY_ENABLED.Get() > 0) {
+  if (m_world->GetRuntimeConfig().energy_enabled) {
     // TODO:  Get rid of magic number. check avaliable energy first
     double energy_req = m_inst_energy_cost[cur_inst.GetOp()] * (m_organism->GetPhenotype().GetMerit().GetDouble() / 100.0); //compensate by factor of 100
     
@@ -1349,7 +1366,7 @@ bool cHardwareBase::SingleProcess_PayPreCosts(cAvidaContext& ctx, const Instruct
     if (m_active_thread_costs[thread_id] == 1) m_active_thread_costs[thread_id] = 0;
   }
   
-  if (m_world->GetConfig().ENERGY_ENABLED.Get() > 0) {
+  if (m_world->GetRuntimeConfig().energy_enabled) {
     m_inst_energy_cost[cur_inst.GetOp()] = m_inst_set->GetEnergyCost(cur_inst); // reset instruction energy cost
   }
   return true;
@@ -1427,7 +1444,8 @@ void cHardwareBase::InsertGenomeFragment(const InstructionSequence& fragment) {
 
 void cHardwareBase::SetMiniTrace(const cString& filename)
 {
-  m_tracer = HardwareTracerPtr(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)filename, true));
+  if (m_world->GetConfig().BINARY_TRACES.Get()) m_tracer = HardwareTracerPtr(new cHardwareTraceRecorder(m_world, filename, true));
+  else m_tracer = HardwareTracerPtr(new cHardwareStatusPrinter(m_world->GetNewWorld(), (const char*)filename, true));
   m_minitrace = true;
 }
 
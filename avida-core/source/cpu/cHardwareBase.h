@@ -32,6 +32,7 @@
 #include <iostream>
 
 #include "cHardwareTracer.h"
+#include "cInstProfiler.h"
 #include "cInstSet.h"
 #include "tBuffer.h"
 
@@ -100,6 +101,10 @@ protected:
   Apto::Array<int, Apto::Smart> m_ext_mem;
   bool m_implicit_repro_active;
   
+  // --------  Instruction Cost Sampling  ---------
+  cInstProfiler* m_inst_profiler;   // NULL unless INST_PROFILE_INTERVAL is set
+  int m_inst_sample_countdown;
+  
 	// --------  Bit masks  ---------
 	static const unsigned int MASK_SIGNBIT = 0x7FFFFFFF;	
 	static const unsigned int MASK24       = 0xFFFFFF;
@@ -142,6 +147,10 @@ public:
   // --------  Helper methods  --------
   virtual int GetType() const = 0;
   virtual bool SupportsSpeculative() const = 0;
+  // Implicit reproduction can divide from within SingleProcess, which must never happen while speculating
+  bool CanSpeculate() const { return SupportsSpeculative() && !m_implicit_repro_active; }
+  bool SupportsConcurrentSpeculative() const
+    { return CanSpeculate() && !m_has_any_costs && !m_tracer; }
   virtual void PrintStatus(std::ostream& fp) = 0;
   virtual void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) = 0;
   virtual void PrintMiniTraceSuccess(std::ostream& fp, const int exec_success) = 0;
@@ -217,6 +226,7 @@ public:
     
   // --------  Mutation  --------
   virtual int PointMutate(cAvidaContext& ctx, double override_mut_rate = 0.0);
+  void PointMutateSite(cAvidaContext& ctx, int site);   // one substitution, as drawn across the whole population
 
   
   // --------  Input/Output Buffers  --------
@@ -253,6 +263,10 @@ protected:
   virtual void internalReset() = 0;
 	virtual void internalResetOnFailedDivide() = 0;
   
+  // Bracket an instruction handler; only the instructions picked by the sampling countdown are timed
+  inline bool beginInstSample(cInstProfiler::tTicks& start);
+  void endInstSample(const cInstSet* inst_set, int op, cInstProfiler::tTicks start);
+  
   
   // --------  No-Operation Instruction  --------
   bool Inst_Nop(cAvidaContext& ctx);  // A no-operation instruction that does nothing! 
@@ -295,4 +309,12 @@ private:
 };
 
 
+inline bool cHardwareBase::beginInstSample(cInstProfiler::tTicks& start)
+{
+  if (!m_inst_profiler || --m_inst_sample_countdown > 0) return false;
+  start = cInstProfiler::Ticks();
+  return true;
+}
+
+
 #endif
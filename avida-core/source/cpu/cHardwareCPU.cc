@@ -60,7 +60,7 @@ using namespace Avida;
 using namespace AvidaTools;
 
 
-tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::s_inst_slib = cHardwareCPU::initInstLib();
+tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::s_inst_slib = NULL;
 
 tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
 {
@@ -771,7 +771,7 @@ cHardwareCPU::cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_orga
 : cHardwareBase(world, in_organism, in_inst_set)
 , m_last_cell_data(false, 0)
 {
-  m_functions = s_inst_slib->GetFunctions();
+  m_functions = GetInstLib()->GetFunctions();
   
   m_spec_die = false;
   m_epigenetic_state = false;
@@ -781,8 +781,14 @@ cHardwareCPU::cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_orga
   
   m_promoters_enabled = m_world->GetConfig().PROMOTERS_ENABLED.Get();
   m_constitutive_regulation = m_world->GetConfig().CONSTITUTIVE_REGULATION.Get();
+  m_promoter_processivity = m_world->GetConfig().PROMOTER_PROCESSIVITY.Get();
+  m_promoter_inst_max = m_world->GetConfig().PROMOTER_INST_MAX.Get();
+  m_no_promoter_halts = (m_world->GetConfig().NO_ACTIVE_PROMOTER_EFFECT.Get() == 2);
   
   m_slip_read_head = !m_world->GetConfig().SLIP_COPY_MODE.Get();
+  m_copy_mut_skip = m_world->GetConfig().COPY_MUT_SKIP.Get();
+  
+  setupFastDispatch();
   
   // Initialize memory...
   const Genome& in_genome = in_organism->GetGenome();
@@ -822,6 +828,12 @@ void cHardwareCPU::internalReset()
   m_thread_id_chart = 1; // Mark only the first thread as taken...
   m_cur_thread = 0;
   
+  m_copy_mut_countdown.Reset();
+  m_copy_ins_countdown.Reset();
+  m_copy_del_countdown.Reset();
+  m_copy_uniform_countdown.Reset();
+  m_copy_slip_countdown.Reset();
+  
   // But then reset thread to have any epigenetic information we have saved
   if (m_epigenetic_state) {
     for (int i=0; i<NUM_REGISTERS; i++) {
@@ -907,7 +919,11 @@ void cHardwareCPU::SetupMiniTraceFileHeader(Avida::Output::File& df, const int g
 
 bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
 {
-  assert(!speculative || (speculative && !m_thread_slicing_parallel));
+  // With parallel thread slicing a single call executes one instruction per thread; a stall partway through could not
+  // be rolled back, so only organisms running a single thread are speculated.
+  if (speculative && m_thread_slicing_parallel && m_threads.GetSize() > 1) return false;
+  
+  if (m_fast_dispatch && !m_tracer) return (this->*m_fast_process)(ctx, speculative);
   
   int last_IP_pos = getIP().GetPosition();
   
@@ -927,7 +943,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
   
   // Count the cpu cycles used
   phenotype.IncCPUCyclesUsed();
-  if (!m_world->GetConfig().NO_CPU_CYCLE_TIME.Get()) phenotype.IncTimeUsed();
+  if (!m_no_cpu_cycle_time) phenotype.IncTimeUsed();
   
   int num_threads = m_threads.GetSize();
   
@@ -975,7 +991,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
     if (m_constitutive_regulation) Inst_SenseRegulate(ctx); 
     
     // If there are no active promoters and a certain mode is set, then don't execute any further instructions
-    if (m_promoters_enabled && m_world->GetConfig().NO_ACTIVE_PROMOTER_EFFECT.Get() == 2 && m_promoter_index == -1) exec = false;
+    if (m_promoters_enabled && m_no_promoter_halts && m_promoter_index == -1) exec = false;
     
     // Now execute the instruction...
     if (exec == true) {
@@ -1017,9 +1033,8 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
       
       // In the promoter model, we may force termination after a certain number of inst have been executed
       if (m_promoters_enabled) {
-        const double processivity = m_world->GetConfig().PROMOTER_PROCESSIVITY.Get();
-        if (ctx.GetRandom().P(1 - processivity)) Inst_Terminate(ctx);
-        if (m_world->GetConfig().PROMOTER_INST_MAX.Get() && (m_threads[m_cur_thread].GetPromoterInstExecuted() >= m_world->GetConfig().PROMOTER_INST_MAX.Get())) 
+        if (ctx.GetRandom().P(1 - m_promoter_processivity)) Inst_Terminate(ctx);
+        if (m_promoter_inst_max && (m_threads[m_cur_thread].GetPromoterInstExecuted() >= m_promoter_inst_max)) 
           Inst_Terminate(ctx);
       }
       
@@ -1059,6 +1074,141 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
 
 // This method will handle the actual execution of an instruction
 // within a single process, once that function has been finalized.
+// The fast path only covers configurations where none of the optional per instruction machinery of SingleProcess
+// (costs, promoters, constitutive regulation, task switching penalties) can have an effect, so everything it does
+// need can be decoded once per opcode up front.
+void cHardwareCPU::setupFastDispatch()
+{
+  m_fast_dispatch = (m_world->GetConfig().CPU_FAST_DISPATCH.Get() && !m_has_any_costs && !m_promoters_enabled &&
+                     !m_constitutive_regulation && !m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get());
+  if (!m_fast_dispatch) {
+    m_decoded.Resize(0);
+    return;
+  }
+  
+  m_decoded.Resize(m_inst_set->GetSize());
+  for (int i = 0; i < m_decoded.GetSize(); i++) {
+    const Instruction inst(i);
+    m_decoded[i].handler = m_functions[m_inst_set->GetLibFunctionIndex(inst)];
+    m_decoded[i].time_cost = m_inst_set->GetAddlTimeCost(inst);
+    m_decoded[i].prob_fail = m_inst_set->GetProbFail(inst);
+    m_decoded[i].stall = m_inst_set->ShouldStall(inst);
+  }
+  
+  if (m_thread_slicing_parallel) {
+    m_fast_process = m_no_cpu_cycle_time ? &cHardwareCPU::singleProcessFast<true, false> : &cHardwareCPU::singleProcessFast<true, true>;
+  } else {
+    m_fast_process = m_no_cpu_cycle_time ? &cHardwareCPU::singleProcessFast<false, false> : &cHardwareCPU::singleProcessFast<false, true>;
+  }
+}
+
+
+// Equivalent to SingleProcess for the configurations accepted by setupFastDispatch, minus the tracer.  The template
+// arguments fix THREAD_SLICING_METHOD == 1 and !NO_CPU_CYCLE_TIME, so neither is tested per cycle.
+template <bool PARALLEL_THREADS, bool CYCLE_TIME>
+bool cHardwareCPU::singleProcessFast(cAvidaContext& ctx, bool speculative)
+{
+  int last_IP_pos = getIP().GetPosition();
+  
+  // Mark this organism as running...
+  m_organism->SetRunning(true);
+  
+  if (!speculative && m_spec_die) {
+    m_organism->Die(ctx);
+    m_organism->SetRunning(false);
+    return false;
+  }
+  
+  cPhenotype& phenotype = m_organism->GetPhenotype();
+  
+  // Count the cpu cycles used
+  phenotype.IncCPUCyclesUsed();
+  if (CYCLE_TIME) phenotype.IncTimeUsed();
+  
+  int num_threads = m_threads.GetSize();
+  int num_inst_exec = PARALLEL_THREADS ? num_threads : 1;
+  
+  for (int i = 0; i < num_inst_exec; i++) {
+    int last_thread = m_cur_thread;
+    
+    m_cur_thread++;
+    if (m_cur_thread >= num_threads) m_cur_thread = 0;
+    
+    m_advance_ip = true;
+    cHeadCPU& ip = m_threads[m_cur_thread].heads[nHardware::HEAD_IP];
+    ip.Adjust();
+    
+    const Instruction cur_inst = ip.GetInst();
+    const sDecodedInst& decoded = m_decoded[cur_inst.GetOp()];
+    
+    if (speculative && (m_spec_die || decoded.stall)) {
+      // Speculative instruction reject, flush and return
+      m_cur_thread = last_thread;
+      phenotype.DecCPUCyclesUsed();
+      if (CYCLE_TIME) phenotype.IncTimeUsed(-1);
+      m_organism->SetRunning(false);
+      return false;
+    }
+    
+    // Copy out of the record first, the instruction may replace this hardware's memory (e.g. divide)
+    const int time_cost = decoded.time_cost;
+    const tMethod handler = decoded.handler;
+    
+    bool exec = true;
+    if (decoded.prob_fail > 0.0) exec = !(ctx.GetRandom().P(decoded.prob_fail));
+    
+    // Mark the instruction as executed, even if it failed
+    getIP().SetFlagExecuted();
+    
+    if (exec) {
+      phenotype.IncCurInstCount(cur_inst.GetOp());
+      cInstProfiler::tTicks sample_start = 0;
+      const bool sampled = beginInstSample(sample_start);
+      const cInstSet* sample_inst_set = m_inst_set;
+      if (!(this->*handler)(ctx)) phenotype.DecCurInstCount(cur_inst.GetOp());
+      if (sampled) endInstSample(sample_inst_set, cur_inst.GetOp(), sample_start);
+    }
+    
+    // Check if the instruction just executed caused premature death, break out of execution if so
+    if (phenotype.GetToDelete()) break;
+    
+    if (m_advance_ip == true) ip.Advance();
+    
+    // Pay the time cost of the instruction now
+    phenotype.IncTimeUsed(time_cost);
+    
+    // check for difference in thread count caused by KillThread or ForkThread
+    if (num_threads == m_threads.GetSize()+1){
+      --num_threads;
+      --num_inst_exec;
+    } else if (num_threads > m_threads.GetSize() && m_threads.GetSize() == 1) {
+      num_threads = 1;
+      num_inst_exec=0;
+    } else if (num_threads > m_threads.GetSize()) {
+      cerr<<cur_inst.GetOp()<<" "<<cur_inst.GetSymbol()<<" "<< num_threads << " " << m_threads.GetSize() <<endl;
+      m_organism->Fault(FAULT_LOC_DEFAULT, FAULT_TYPE_ERROR);
+      cerr<<"Error in thread handling\n";
+      exit(-1);
+    }
+  }
+  
+  // Kill creatures who have reached their max num of instructions executed
+  const int max_executed = m_organism->GetMaxExecuted();
+  if ((max_executed > 0 && phenotype.GetTimeUsed() >= max_executed) || phenotype.GetToDie() == true) {
+    if (speculative) m_spec_die = true;
+    else m_organism->Die(ctx);
+  }
+  if (!speculative && phenotype.GetToDelete()) m_spec_die = true;
+  
+  // Note: if organism just died, this will NOT let it repro.
+  CheckImplicitRepro(ctx, last_IP_pos > m_threads[m_cur_thread].heads[nHardware::HEAD_IP].GetPosition());
+  
+  m_organism->SetRunning(false);
+  
+  return !m_spec_die;
+}
+
+
 bool cHardwareCPU::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst) 
 {
   // Copy Instruction locally to handle stochastic effects
@@ -1071,14 +1221,18 @@ bool cHardwareCPU::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instructi
   m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
 	
   // And execute it.
+  cInstProfiler::tTicks sample_start = 0;
+  const bool sampled = beginInstSample(sample_start);
+  const cInstSet* sample_inst_set = m_inst_set;
   const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  if (sampled) endInstSample(sample_inst_set, actual_inst.GetOp(), sample_start);
   
   // NOTE: Organism may be dead now if instruction executed killed it (such as some divides, "die", or "explode")
   
   // Add in a cycle cost for switching which task is performed
-  if (m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get()) {
+  if (m_world->GetRuntimeConfig().task_switch_penalty_type) {
     if (m_organism->GetPhenotype().GetNumNewUniqueReactions()) {
-      int cost = m_organism->GetPhenotype().GetNumNewUniqueReactions() * m_world->GetConfig().TASK_SWITCH_PENALTY.Get();
+      int cost = m_organism->GetPhenotype().GetNumNewUniqueReactions() * m_world->GetRuntimeConfig().task_switch_penalty;
       IncrementTaskSwitchingCost(cost);
 			
       m_organism->GetPhenotype().ResetNumNewUniqueReactions();
@@ -1764,11 +1918,7 @@ bool cHardwareCPU::Allocate_Main(cAvidaContext& ctx, const int allocated_size)
 
 int cHardwareCPU::calcCopiedSize(const int parent_size, const int child_size)
 {
-  int copied_size = 0;
-  for (int i = parent_size; i < parent_size + child_size; i++) {
-    if (m_memory.FlagCopied(i)) copied_size++;
-  }
-  return copied_size;
+  return m_memory.CountFlagCopied(parent_size, parent_size + child_size);
 }  
 
 
@@ -1797,7 +1947,7 @@ bool cHardwareCPU::Divide_Main(cAvidaContext& ctx, const int div_point,
     return false;
   }
   
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
   
   // Cut off everything in this memory past the divide point.
   m_memory.Resize(div_point);
@@ -1867,7 +2017,7 @@ bool cHardwareCPU::Divide_MainRS(cAvidaContext& ctx, const int div_point,
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
   
   // Cut off everything in this memory past the divide point.
   m_memory.Resize(div_point);
@@ -1966,7 +2116,7 @@ bool cHardwareCPU::Divide_Main1RS(cAvidaContext& ctx, const int div_point,
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
   
   // Cut off everything in this memory past the divide point.
   m_memory.Resize(div_point);
@@ -2060,7 +2210,7 @@ bool cHardwareCPU::Divide_Main2RS(cAvidaContext& ctx, const int div_point,
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
   
   // Cut off everything in this memory past the divide point.
   m_memory.Resize(div_point);
@@ -2343,7 +2493,6 @@ bool cHardwareCPU::Inst_IfAboveResLevel(cAvidaContext& ctx)
   const double resCrossoverLevel = 100;
   
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
-  const Apto::Array<double>& resource_count_array =  GetOrganism()->GetOrgInterface().GetResources(ctx);
   const cResourceCount& resource_count = m_world->GetPopulation().GetResourceCount();
   
   if (resource_count.GetSize() == 0) assert(false); // change to: return false;
@@ -2352,7 +2501,7 @@ bool cHardwareCPU::Inst_IfAboveResLevel(cAvidaContext& ctx)
   cResource* res = resLib.GetResource("pheromone");
   
   if (strncmp(resource_count.GetResName(res->GetID()), "pheromone", 9) == 0) {
-    pher_amount += resource_count_array[res->GetID()];
+    pher_amount += m_organism->GetOrgInterface().GetResourceVal(ctx, res->GetID());
   }
 	
   if (pher_amount > resCrossoverLevel) {
@@ -2368,7 +2517,6 @@ bool cHardwareCPU::Inst_IfAboveResLevelEnd(cAvidaContext& ctx)
   
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
   
-  const Apto::Array<double>& resource_count_array =  GetOrganism()->GetOrgInterface().GetResources(ctx);
   const cResourceCount& resource_count = m_world->GetPopulation().GetResourceCount();
 	
   if (resource_count.GetSize() == 0) assert(false); // change to: return false;
@@ -2377,7 +2525,7 @@ bool cHardwareCPU::Inst_IfAboveResLevelEnd(cAvidaContext& ctx)
   cResource* res = resLib.GetResource("pheromone");
   
   if (strncmp(resource_count.GetResName(res->GetID()), "pheromone", 9) == 0) {
-    pher_amount += resource_count_array[res->GetID()];
+    pher_amount += m_organism->GetOrgInterface().GetResourceVal(ctx, res->GetID());
   }
 	
   if (pher_amount > resCrossoverLevel) {
@@ -2393,7 +2541,6 @@ bool cHardwareCPU::Inst_IfNotAboveResLevel(cAvidaContext& ctx)
 	
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
   
-  const Apto::Array<double>& resource_count_array =  GetOrganism()->GetOrgInterface().GetResources(ctx);
   const cResourceCount& resource_count = m_world->GetPopulation().GetResourceCount();
   
   if (resource_count.GetSize() == 0) assert(false); // change to: return false;
@@ -2402,7 +2549,7 @@ bool cHardwareCPU::Inst_IfNotAboveResLevel(cAvidaContext& ctx)
   cResource* res = resLib.GetResource("pheromone");
   
   if (strncmp(resource_count.GetResName(res->GetID()), "pheromone", 9) == 0) {
-    pher_amount += resource_count_array[res->GetID()];
+    pher_amount += m_organism->GetOrgInterface().GetResourceVal(ctx, res->GetID());
   }
 	
   if (pher_amount <= resCrossoverLevel) {
@@ -2417,7 +2564,6 @@ bool cHardwareCPU::Inst_IfNotAboveResLevelEnd(cAvidaContext& ctx)
   const double resCrossoverLevel = 100;
   
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
-  const Apto::Array<double>& resource_count_array =  GetOrganism()->GetOrgInterface().GetResources(ctx);
   const cResourceCount& resource_count = m_world->GetPopulation().GetResourceCount();
   
   if (resource_count.GetSize() == 0) assert(false); // change to: return false;
@@ -2426,7 +2572,7 @@ bool cHardwareCPU::Inst_IfNotAboveResLevelEnd(cAvidaContext& ctx)
   cResource* res = resLib.GetResource("pheromone");
   
   if (strncmp(resource_count.GetResName(res->GetID()), "pheromone", 9) == 0) {
-    pher_amount += resource_count_array[res->GetID()];
+    pher_amount += m_organism->GetOrgInterface().GetResourceVal(ctx, res->GetID());
   }
   
   if (pher_amount <= resCrossoverLevel) {
@@ -3383,7 +3529,25 @@ bool cHardwareCPU::Inst_Repro(cAvidaContext& ctx)
   Divide_DoTransposons(ctx);
   
   // Perform Copy Mutations...
-  if (m_organism->GetCopyMutProb() > 0) { // Skip this if no mutations....
+  if (m_organism->GetCopyMutProb() > 0 && m_copy_mut_skip) {
+    // Jump straight to each mutated site rather than testing every one
+    const double prob = m_organism->GetCopyMutProb();
+    const int size = offspring_seq->GetSize();
+    const cString no_mut_list = m_world->GetConfig().NO_MUT_INSTS.Get();
+    int i = ctx.GetTrialsToNextEvent(prob);
+    while (i < size) {
+      //Need to check no_mut_insts for head to head kaboom experiments
+      bool in_list = false;
+      char test_inst = (*offspring_seq)[i].GetSymbol()[0];
+      for (int j = 0; j < (int)strlen(no_mut_list); j++) {
+        if ((char) no_mut_list[j] == test_inst) in_list = true;
+      }
+      if (!in_list) (*offspring_seq)[i] = m_inst_set->GetRandomInst(ctx);
+      const int skip = ctx.GetTrialsToNextEvent(prob);
+      if (skip >= size - i - 1) break;
+      i += skip + 1;
+    }
+  } else if (m_organism->GetCopyMutProb() > 0) { // Skip this if no mutations....
     for (int i = 0; i < offspring_seq->GetSize(); i++) {
       //Need to check no_mut_insts for head to head kaboom experiments
       bool in_list = false;
@@ -4513,15 +4677,15 @@ bool cHardwareCPU::Inst_SenseNextResLevel(cAvidaContext& ctx)
 
 bool cHardwareCPU::Inst_SenseDiffFaced(cAvidaContext& ctx) 
 {
-  const Apto::Array<double> res_count = m_organism->GetOrgInterface().GetResources(ctx);
   if(m_organism->GetOrgInterface().HasOpinion(m_organism)) {
     int opinion = m_organism->GetOpinion().first;
     int reg_to_set = FindModifiedRegister(REG_BX);
-    double faced_res = m_organism->GetOrgInterface().GetFacedCellResources(ctx)[opinion];  
+    double res_here = m_organism->GetOrgInterface().GetResourceVal(ctx, opinion);
+    double faced_res = m_organism->GetOrgInterface().GetFacedResourceVal(ctx, opinion);
     // return % change
     int res_diff = 0;
-    if (res_count[opinion] == 0) res_diff = (int) faced_res;
-    else res_diff = (int) (((faced_res - res_count[opinion])/res_count[opinion]) * 100 + 0.5);
+    if (res_here == 0) res_diff = (int) faced_res;
+    else res_diff = (int) (((faced_res - res_here)/res_here) * 100 + 0.5);
     GetRegister(reg_to_set) = res_diff;
   }
   return true;
@@ -4852,7 +5016,7 @@ bool cHardwareCPU::Inst_IfResources(cAvidaContext& ctx)
   const cReactionLib& rxlib = m_world->GetEnvironment().GetReactionLib();
   for (int i=0; i<rxlib.GetSize(); ++i) {
     cReaction* rx = rxlib.GetReaction(i);
-    tLWConstListIterator<cReactionProcess> processes(rx->GetProcesses());
+    tArrayListIterator<cReactionProcess> processes(rx->GetProcesses());
     while (!processes.AtEnd()) {
       const cReactionProcess* proc = processes.Next();
       cResource* res = proc->GetResource(); // Infinite resource == 0.
@@ -5050,11 +5214,7 @@ bool cHardwareCPU::Inst_DonateKin(cAvidaContext& ctx)
     bool found = false;
     Systematics::GroupPtr bg = m_organism->SystematicsGroup("genotype");
     if (!bg) return false;
-    Systematics::SexualAncestryPtr sa = bg->GetData<Systematics::SexualAncestry>();
-    if (!sa) {
-      sa = Systematics::SexualAncestryPtr(new Systematics::SexualAncestry(bg));
-      bg->AttachData(sa);
-    }
+    Systematics::SexualAncestryPtr sa = Systematics::SexualAncestry::Of(bg);
     
     while (neighbor_id < max_id) {
       neighbor = m_organism->GetNeighbor();
@@ -5119,7 +5279,7 @@ bool cHardwareCPU::Inst_DonateEditDist(cAvidaContext& ctx)
         neighbor_seq_p.DynamicCastFrom(neighbor_genome.Representation());
         const InstructionSequence& neighbor_seq = *neighbor_seq_p;
         
-        edit_dist = InstructionSequence::FindEditDistance(org_seq, neighbor_seq);
+        edit_dist = InstructionSequence::FindEditDistance(org_seq, neighbor_seq, max_dist);
       }
       if (edit_dist <= max_dist) {
         found = true;
@@ -7141,7 +7301,7 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
   ReadInst(read_inst.GetOp());
   
   //checkNoMutList is for head to head kaboom experiments
-  if (m_organism->TestCopyMut(ctx) && !(checkNoMutList(read_head))) {
+  if (testCopyMut(ctx) && !(checkNoMutList(read_head))) {
     read_inst = m_inst_set->GetRandomInst(ctx);
     write_head.SetFlagMutated();
     write_head.SetFlagCopyMut();
@@ -7150,10 +7310,10 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
   write_head.SetInst(read_inst);
   write_head.SetFlagCopied();  // Set the copied flag...
   
-  if (m_organism->TestCopyIns(ctx)) write_head.InsertInst(m_inst_set->GetRandomInst(ctx));
-  if (m_organism->TestCopyDel(ctx)) write_head.RemoveInst();
-  if (m_organism->TestCopyUniform(ctx)) doUniformCopyMutation(ctx, write_head);
-  if (m_organism->TestCopySlip(ctx)) {
+  if (testCopyIns(ctx)) write_head.InsertInst(m_inst_set->GetRandomInst(ctx));
+  if (testCopyDel(ctx)) write_head.RemoveInst();
+  if (testCopyUniform(ctx)) doUniformCopyMutation(ctx, write_head);
+  if (testCopySlip(ctx)) {
     if (m_slip_read_head) {
       read_head.Set(ctx.GetRandom().GetInt(m_memory.GetSize()));
     } else {
@@ -7166,6 +7326,38 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
   return true;
 }
 
+// Mutation tests for h-copy.  The geometric skip yields the same per-site rates as testing every site, drawing once per
+// mutation (see cMutationCountdown).
+bool cHardwareCPU::testCopyMut(cAvidaContext& ctx)
+{
+  if (!m_copy_mut_skip) return m_organism->TestCopyMut(ctx);
+  return m_copy_mut_countdown.Test(ctx, m_organism->MutationRates().GetCopyMutProb());
+}
+
+bool cHardwareCPU::testCopyIns(cAvidaContext& ctx)
+{
+  if (!m_copy_mut_skip) return m_organism->TestCopyIns(ctx);
+  return m_copy_ins_countdown.Test(ctx, m_organism->MutationRates().GetCopyInsProb());
+}
+
+bool cHardwareCPU::testCopyDel(cAvidaContext& ctx)
+{
+  if (!m_copy_mut_skip) return m_organism->TestCopyDel(ctx);
+  return m_copy_del_countdown.Test(ctx, m_organism->MutationRates().GetCopyDelProb());
+}
+
+bool cHardwareCPU::testCopyUniform(cAvidaContext& ctx)
+{
+  if (!m_copy_mut_skip) return m_organism->TestCopyUniform(ctx);
+  return m_copy_uniform_countdown.Test(ctx, m_organism->MutationRates().GetCopyUniformProb());
+}
+
+bool cHardwareCPU::testCopySlip(cAvidaContext& ctx)
+{
+  if (!m_copy_mut_skip) return m_organism->TestCopySlip(ctx);
+  return m_copy_slip_countdown.Test(ctx, m_organism->MutationRates().GetCopySlipProb());
+}
+
 // This instruction assumes that there is a corresponding resource for
 // every instruction in the instruction set. It checks to see if the organism
 // has the resource required for instruction at the read head. If it does,
@@ -8632,7 +8824,6 @@ bool cHardwareCPU::DoSensePheromoneGlobal(cAvidaContext& ctx, tRegisters REG_DEF
   int reg_to_set = FindModifiedRegister(REG_DEFAULT);
   
   const cResourceLib& resLib = m_world->GetEnvironment().GetResourceLib();
-  const Apto::Array<double>& resource_count_array = m_organism->GetOrgInterface().GetResources(ctx);
   const cResourceCount& resource_count = m_world->GetPopulation().GetResourceCount();
 	
   if (resource_count.GetSize() == 0) assert(false); // change to: return false;
@@ -8641,7 +8832,7 @@ bool cHardwareCPU::DoSensePheromoneGlobal(cAvidaContext& ctx, tRegisters REG_DEF
   cResource* res = resLib.GetResource("pheromone");
 	
   if (strncmp(resource_count.GetResName(res->GetID()), "pheromone", 9) == 0) {
-    pher_amount += resource_count_array[res->GetID()];
+    pher_amount += m_organism->GetOrgInterface().GetResourceVal(ctx, res->GetID());
   }
   
   GetRegister(reg_to_set) = static_cast<int>(floor(pher_amount + 0.5));
@@ -10202,10 +10393,8 @@ bool cHardwareCPU::Inst_ProduceString(cAvidaContext&)
   int string_size = 0;
   bool val; 
 	
-  m_organism->InitStringMap(); 
-  
   // Figure out if it has produced any of the strings 
-  std::vector < cString > temp_strings = m_world->GetEnvironment().GetMatchStringsFromTask(); 
+  const std::vector<cMatchString>& temp_strings = m_world->GetEnvironment().GetMatchStringsFromTask(); 
   if (temp_strings.size()) string_size = temp_strings[0].GetSize();
   for (unsigned int i=0; i < temp_strings.size(); i++){
     num = m_organism->MatchOutputBuffer(temp_strings[i]); 
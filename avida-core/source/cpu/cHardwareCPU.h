@@ -30,6 +30,7 @@
 #include "cCPUMemory.h"
 #include "cCPUStack.h"
 #include "cHardwareBase.h"
+#include "cMutationRates.h"
 #include "cString.h"
 #include "cStats.h"
 #include "tInstLib.h"
@@ -53,6 +54,7 @@ class cOrganism;
 
 class cHardwareCPU : public cHardwareBase
 {
+  friend class cHardwareCPULockstep;
 public:
   typedef bool (cHardwareCPU::*tMethod)(cAvidaContext& ctx);
 
@@ -126,11 +128,38 @@ protected:
     bool m_constitutive_regulation:1;
 
     bool m_slip_read_head:1;
+    bool m_copy_mut_skip:1;
+    
+    bool m_fast_dispatch:1;
+  };
+  
+  // Copies left before the next h-copy mutation of each kind, when COPY_MUT_SKIP is set
+  cMutationCountdown m_copy_mut_countdown;
+  cMutationCountdown m_copy_ins_countdown;
+  cMutationCountdown m_copy_del_countdown;
+  cMutationCountdown m_copy_uniform_countdown;
+  cMutationCountdown m_copy_slip_countdown;
+
+  // Pre-decoded per-opcode execution record used by singleProcessFast()
+  struct sDecodedInst
+  {
+    tMethod handler;
+    int time_cost;
+    double prob_fail;
+    bool stall;
   };
+  Apto::Array<sDecodedInst> m_decoded;
+  
+  // singleProcessFast specialization for this organism's thread slicing and cycle time settings
+  typedef bool (cHardwareCPU::*tProcessMethod)(cAvidaContext& ctx, bool speculative);
+  tProcessMethod m_fast_process;
 
   // <-- Promoter model
   int m_promoter_index;       //site to begin looking for the next active promoter from
   int m_promoter_offset;      //bit offset when testing whether a promoter is on
+  double m_promoter_processivity;
+  int m_promoter_inst_max;
+  bool m_no_promoter_halts;  //NO_ACTIVE_PROMOTER_EFFECT == 2, stop executing while no promoter is active
 
   struct cPromoter 
   {
@@ -154,6 +183,8 @@ protected:
 
 
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
+  void setupFastDispatch();
+  template <bool PARALLEL_THREADS, bool CYCLE_TIME> bool singleProcessFast(cAvidaContext& ctx, bool speculative);
   
   // --------  Stack Manipulation...  --------
   inline void StackPush(int value);
@@ -215,6 +246,12 @@ protected:
 
   void internalResetOnFailedDivide();
 
+  bool testCopyMut(cAvidaContext& ctx);
+  bool testCopyIns(cAvidaContext& ctx);
+  bool testCopyDel(cAvidaContext& ctx);
+  bool testCopyUniform(cAvidaContext& ctx);
+  bool testCopySlip(cAvidaContext& ctx);
+
 
   int calcCopiedSize(const int parent_size, const int child_size);
 
@@ -238,7 +275,7 @@ public:
   cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set);
   ~cHardwareCPU() { ; }
 
-  static tInstLib<tMethod>* GetInstLib() { return s_inst_slib; }
+  static tInstLib<tMethod>* GetInstLib() { if (!s_inst_slib) s_inst_slib = initInstLib(); return s_inst_slib; }
   static cString GetDefaultInstFilename() { return "instset-heads.cfg"; }
 
   bool SingleProcess(cAvidaContext& ctx, bool speculative = false);
@@ -0,0 +1,407 @@
+/*
+ *  cHardwareCPULockstep.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cHardwareCPULockstep.h"
+
+#include "cAvidaContext.h"
+#include "cCodeLabel.h"
+#include "cCPUMemory.h"
+#include "cHardwareCPU.h"
+#include "cInstSet.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+
+
+cHardwareCPULockstep::cHardwareCPULockstep(cWorld* world, cTestCPU* test_cpu)
+  : m_test_cpu(test_cpu), m_inst_set(NULL), m_usable(true)
+  , m_max_label_exe_size(world->GetConfig().MAX_LABEL_EXE_SIZE.Get()), m_inputs_lane(-1)
+{
+  for (int i = 0; i < MAX_OPS; i++) {
+    m_kind[i] = KIND_SCALAR;
+    m_nop_mod[i] = -1;
+  }
+}
+
+
+// Same positions cHeadCPU::Adjust produces for the single memory space of cHardwareCPU
+inline int cHardwareCPULockstep::adjust(int pos, int size) const
+{
+  if (pos >= 0 && pos < size) return pos;
+  if (size == 0 || pos < 0) return 0;
+  if (pos < 2 * size) return pos - size;
+  return pos % size;
+}
+
+// cHardwareCPU::FindModifiedRegister/FindModifiedHead: a nop following the IP is consumed as the modifier
+inline int cHardwareCPULockstep::findModifier(int lane, int default_mod)
+{
+  cCPUMemory& mem = *m_lanes[lane].mem;
+  const int next = m_head[nHardware::HEAD_IP][lane] + 1;
+  if (next < mem.GetSize()) {
+    const int nop_mod = m_nop_mod[mem[next].GetOp()];
+    if (nop_mod >= 0) {
+      m_head[nHardware::HEAD_IP][lane] = next;
+      mem.SetFlagExecuted(next);
+      return nop_mod;
+    }
+  }
+  return default_mod;
+}
+
+// The loop condition of cTestCPU::ProcessGestation
+inline bool cHardwareCPULockstep::isRunning(const sLane& lane) const
+{
+  return (lane.time_used < lane.time_allocated && lane.phenotype->GetNumDivides() == 0 && !lane.org->IsDead());
+}
+
+inline void cHardwareCPULockstep::skipNext(int lane)
+{
+  m_head[nHardware::HEAD_IP][lane] = adjust(m_head[nHardware::HEAD_IP][lane] + 1, m_lanes[lane].mem->GetSize());
+}
+
+
+bool cHardwareCPULockstep::setupInstSet(cHardwareCPU* hw)
+{
+  typedef cHardwareCPU::tMethod tMethod;
+
+  m_inst_set = hw->m_inst_set;
+  if (m_inst_set->GetSize() > MAX_OPS) m_usable = false;
+
+  for (int op = 0; m_usable && op < m_inst_set->GetSize(); op++) {
+    const cHardwareCPU::sDecodedInst& decoded = hw->m_decoded[op];
+    const tMethod handler = decoded.handler;
+
+    if (op < m_inst_set->GetNumNops()) m_nop_mod[op] = m_inst_set->GetNopMod(Instruction(op));
+
+    if (handler == &cHardwareCPU::Inst_Nop) m_kind[op] = KIND_NOP;
+    else if (handler == &cHardwareCPU::Inst_IfNEqu) m_kind[op] = KIND_IF_N_EQU;
+    else if (handler == &cHardwareCPU::Inst_IfLess) m_kind[op] = KIND_IF_LESS;
+    else if (handler == &cHardwareCPU::Inst_Pop) m_kind[op] = KIND_POP;
+    else if (handler == &cHardwareCPU::Inst_Push) m_kind[op] = KIND_PUSH;
+    else if (handler == &cHardwareCPU::Inst_SwitchStack) m_kind[op] = KIND_SWAP_STK;
+    else if (handler == &cHardwareCPU::Inst_Swap) m_kind[op] = KIND_SWAP;
+    else if (handler == &cHardwareCPU::Inst_ShiftR) m_kind[op] = KIND_SHIFT_R;
+    else if (handler == &cHardwareCPU::Inst_ShiftL) m_kind[op] = KIND_SHIFT_L;
+    else if (handler == &cHardwareCPU::Inst_Inc) m_kind[op] = KIND_INC;
+    else if (handler == &cHardwareCPU::Inst_Dec) m_kind[op] = KIND_DEC;
+    else if (handler == &cHardwareCPU::Inst_Add) m_kind[op] = KIND_ADD;
+    else if (handler == &cHardwareCPU::Inst_Sub) m_kind[op] = KIND_SUB;
+    else if (handler == &cHardwareCPU::Inst_Nand) m_kind[op] = KIND_NAND;
+    else if (handler == &cHardwareCPU::Inst_MoveHead) m_kind[op] = KIND_MOV_HEAD;
+    else if (handler == &cHardwareCPU::Inst_JumpHead) m_kind[op] = KIND_JMP_HEAD;
+    else if (handler == &cHardwareCPU::Inst_GetHead) m_kind[op] = KIND_GET_HEAD;
+    else if (handler == &cHardwareCPU::Inst_SetFlow) m_kind[op] = KIND_SET_FLOW;
+    else if (handler == &cHardwareCPU::Inst_IfLabel) m_kind[op] = KIND_IF_LABEL;
+    else if (handler == &cHardwareCPU::Inst_HeadCopy) m_kind[op] = KIND_H_COPY;
+    else if (handler == &cHardwareCPU::Inst_TaskIO || handler == &cHardwareCPU::Inst_MaxAlloc ||
+             handler == &cHardwareCPU::Inst_HeadDivide || handler == &cHardwareCPU::Inst_HeadSearch) {
+      m_kind[op] = KIND_SCALAR;
+    } else {
+      // Anything else could depend on state the lanes keep outside the hardware, or on more than one thread
+      m_usable = false;
+    }
+
+    if (decoded.time_cost != 0 || decoded.prob_fail > 0.0) m_kind[op] = KIND_SCALAR;
+  }
+
+  return m_usable;
+}
+
+
+bool cHardwareCPULockstep::AddLane(cOrganism* org, int time_used, int time_allocated, Apto::Array<int>* site_exec)
+{
+  if (!m_usable) return false;
+
+  cHardwareCPU* hw = dynamic_cast<cHardwareCPU*>(&org->GetHardware());
+  if (!hw || !hw->m_fast_dispatch || hw->m_tracer || hw->m_inst_profiler || hw->m_implicit_repro_active) return false;
+  if (hw->m_threads.GetSize() != 1 || hw->m_cur_thread != 0) return false;
+
+  const cMutationRates& rates = org->MutationRates();
+  if (rates.GetCopyMutProb() > 0.0 || rates.GetCopyInsProb() > 0.0 || rates.GetCopyDelProb() > 0.0 ||
+      rates.GetCopyUniformProb() > 0.0 || rates.GetCopySlipProb() > 0.0) {
+    return false;
+  }
+
+  if (!m_inst_set) {
+    if (!setupInstSet(hw)) return false;
+  } else if (hw->m_inst_set != m_inst_set) {
+    return false;
+  }
+
+  const int lane = m_lanes.GetSize();
+  m_lanes.Resize(lane + 1);
+  for (int i = 0; i < NUM_REGISTERS; i++) m_reg[i].Resize(lane + 1);
+  for (int i = 0; i < nHardware::NUM_HEADS; i++) m_head[i].Resize(lane + 1);
+
+  sLane& cur = m_lanes[lane];
+  cur.org = org;
+  cur.hw = hw;
+  cur.mem = &hw->m_memory;
+  cur.phenotype = &org->GetPhenotype();
+  cur.time_used = time_used;
+  cur.time_allocated = time_allocated;
+  cur.max_executed = org->GetMaxExecuted();
+  cur.site_exec = site_exec;
+  cur.inputs = m_test_cpu->input_array;
+  cur.cur_input = m_test_cpu->cur_input;
+  cur.cur_receive = m_test_cpu->cur_receive;
+
+  gatherLane(lane);
+
+  return true;
+}
+
+
+void cHardwareCPULockstep::gatherLane(int lane)
+{
+  const cHardwareCPU::cLocalThread& thread = m_lanes[lane].hw->m_threads[0];
+  for (int i = 0; i < NUM_REGISTERS; i++) m_reg[i][lane] = thread.reg[i];
+  for (int i = 0; i < nHardware::NUM_HEADS; i++) m_head[i][lane] = thread.heads[i].GetPosition();
+}
+
+void cHardwareCPULockstep::scatterLane(int lane)
+{
+  cHardwareCPU::cLocalThread& thread = m_lanes[lane].hw->m_threads[0];
+  for (int i = 0; i < NUM_REGISTERS; i++) thread.reg[i] = m_reg[i][lane];
+  for (int i = 0; i < nHardware::NUM_HEADS; i++) thread.heads[i].AbsSet(m_head[i][lane]);
+}
+
+void cHardwareCPULockstep::loadInputs(int lane)
+{
+  if (m_inputs_lane == lane) return;
+
+  if (m_inputs_lane >= 0) {
+    sLane& prev = m_lanes[m_inputs_lane];
+    prev.inputs = m_test_cpu->input_array;
+    prev.cur_input = m_test_cpu->cur_input;
+    prev.cur_receive = m_test_cpu->cur_receive;
+  }
+
+  sLane& cur = m_lanes[lane];
+  m_test_cpu->input_array = cur.inputs;
+  m_test_cpu->cur_input = cur.cur_input;
+  m_test_cpu->cur_receive = cur.cur_receive;
+  m_inputs_lane = lane;
+}
+
+
+void cHardwareCPULockstep::Run(cAvidaContext& ctx)
+{
+  m_active.Resize(0);
+  for (int i = 0; i < m_lanes.GetSize(); i++) if (isRunning(m_lanes[i])) m_active.Push(i);
+
+  while (m_active.GetSize()) {
+    for (int k = 0; k < NUM_KINDS; k++) m_bucket[k].Resize(0);
+
+    // Sort the live lanes by the instruction each executes this step, doing the part of ProcessGestation that precedes
+    // SingleProcess on the way
+    for (int i = 0; i < m_active.GetSize(); i++) {
+      const int lane = m_active[i];
+      sLane& cur = m_lanes[lane];
+
+      int& ip = m_head[nHardware::HEAD_IP][lane];
+      if (cur.site_exec && ip >= 0 && ip < cur.site_exec->GetSize() && (*cur.site_exec)[ip] == -1) {
+        (*cur.site_exec)[ip] = cur.time_used;
+      }
+      cur.time_used++;
+
+      ip = adjust(ip, cur.mem->GetSize());
+      int kind = m_kind[(*cur.mem)[ip].GetOp()];
+
+      // Steps that end in death are left to the hardware
+      const int next_time = cur.phenotype->GetTimeUsed() + (cur.hw->m_no_cpu_cycle_time ? 0 : 1);
+      if ((cur.max_executed > 0 && next_time >= cur.max_executed) || cur.phenotype->GetToDie() || cur.hw->m_spec_die) {
+        kind = KIND_SCALAR;
+      }
+
+      m_bucket[kind].Push(lane);
+    }
+
+    for (int k = 0; k < KIND_SCALAR; k++) if (m_bucket[k].GetSize()) stepKind(k);
+    for (int i = 0; i < m_bucket[KIND_SCALAR].GetSize(); i++) stepScalar(ctx, m_bucket[KIND_SCALAR][i]);
+
+    // Retire the lanes whose gestation is over
+    int num_active = 0;
+    for (int i = 0; i < m_active.GetSize(); i++) {
+      const int lane = m_active[i];
+      if (isRunning(m_lanes[lane])) {
+        m_active[num_active++] = lane;
+      } else {
+        scatterLane(lane);
+      }
+    }
+    m_active.Resize(num_active);
+  }
+}
+
+
+void cHardwareCPULockstep::stepScalar(cAvidaContext& ctx, int lane)
+{
+  scatterLane(lane);
+  loadInputs(lane);
+  m_lanes[lane].hw->SingleProcess(ctx);
+  gatherLane(lane);
+}
+
+
+// One instruction for every lane in the kind's bucket.  Each case follows the bookkeeping of singleProcessFast
+// (cycle and time counts, executed flag, instruction count) and then the semantics of the cHardwareCPU handler.
+void cHardwareCPULockstep::stepKind(int kind)
+{
+  const Apto::Array<int, Apto::Smart>& bucket = m_bucket[kind];
+  const int num_lanes = bucket.GetSize();
+  int* const reg_bx = &m_reg[cHardwareCPU::REG_BX][0];
+  int* const reg_cx = &m_reg[cHardwareCPU::REG_CX][0];
+  int* const head_ip = &m_head[nHardware::HEAD_IP][0];
+  int* const head_read = &m_head[nHardware::HEAD_READ][0];
+  int* const head_write = &m_head[nHardware::HEAD_WRITE][0];
+  int* const head_flow = &m_head[nHardware::HEAD_FLOW][0];
+
+  for (int i = 0; i < num_lanes; i++) {
+    const int lane = bucket[i];
+    sLane& cur = m_lanes[lane];
+    cCPUMemory& mem = *cur.mem;
+    cPhenotype& phenotype = *cur.phenotype;
+
+    phenotype.IncCPUCyclesUsed();
+    if (!cur.hw->m_no_cpu_cycle_time) phenotype.IncTimeUsed();
+    mem.SetFlagExecuted(head_ip[lane]);
+    phenotype.IncCurInstCount(mem[head_ip[lane]].GetOp());
+
+    bool advance_ip = true;
+
+    switch (kind) {
+      case KIND_NOP:
+        break;
+
+      case KIND_IF_N_EQU:
+      case KIND_IF_LESS:
+      {
+        const int op1 = findModifier(lane, cHardwareCPU::REG_BX);
+        const int op2 = (op1 + 1) % NUM_REGISTERS;
+        const int val1 = m_reg[op1][lane];
+        const int val2 = m_reg[op2][lane];
+        if ((kind == KIND_IF_N_EQU) ? (val1 == val2) : (val1 >= val2)) skipNext(lane);
+        break;
+      }
+
+      case KIND_POP:
+      {
+        const int reg_used = findModifier(lane, cHardwareCPU::REG_BX);
+        m_reg[reg_used][lane] = cur.hw->StackPop();
+        break;
+      }
+
+      case KIND_PUSH:
+      {
+        const int reg_used = findModifier(lane, cHardwareCPU::REG_BX);
+        cur.hw->StackPush(m_reg[reg_used][lane]);
+        break;
+      }
+
+      case KIND_SWAP_STK:
+        cur.hw->SwitchStack();
+        break;
+
+      case KIND_SWAP:
+      {
+        const int op1 = findModifier(lane, cHardwareCPU::REG_BX);
+        const int op2 = (op1 + 1) % NUM_REGISTERS;
+        const int tmp = m_reg[op1][lane];
+        m_reg[op1][lane] = m_reg[op2][lane];
+        m_reg[op2][lane] = tmp;
+        break;
+      }
+
+      case KIND_SHIFT_R: m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] >>= 1; break;
+      case KIND_SHIFT_L: m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] <<= 1; break;
+      case KIND_INC:     m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] += 1; break;
+      case KIND_DEC:     m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] -= 1; break;
+
+      case KIND_ADD: m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] = reg_bx[lane] + reg_cx[lane]; break;
+      case KIND_SUB: m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] = reg_bx[lane] - reg_cx[lane]; break;
+      case KIND_NAND: m_reg[findModifier(lane, cHardwareCPU::REG_BX)][lane] = ~(reg_bx[lane] & reg_cx[lane]); break;
+
+      case KIND_MOV_HEAD:
+      {
+        // cHeadCPU::Set(const cHeadCPU&) copies the position without adjusting it
+        const int head_used = findModifier(lane, nHardware::HEAD_IP);
+        m_head[head_used][lane] = head_flow[lane];
+        if (head_used == nHardware::HEAD_IP) advance_ip = false;
+        break;
+      }
+
+      case KIND_JMP_HEAD:
+      {
+        const int head_used = findModifier(lane, nHardware::HEAD_IP);
+        m_head[head_used][lane] = adjust(m_head[head_used][lane] + reg_cx[lane], mem.GetSize());
+        break;
+      }
+
+      case KIND_GET_HEAD:
+      {
+        const int head_used = findModifier(lane, nHardware::HEAD_IP);
+        reg_cx[lane] = m_head[head_used][lane];
+        break;
+      }
+
+      case KIND_SET_FLOW:
+      {
+        const int reg_used = findModifier(lane, cHardwareCPU::REG_CX);
+        head_flow[lane] = adjust(m_reg[reg_used][lane], mem.GetSize());
+        break;
+      }
+
+      case KIND_IF_LABEL:
+      {
+        // cHardwareCPU::ReadLabel, leaving the IP on the last nop of the label
+        cCodeLabel& label = cur.hw->GetLabel();
+        label.Clear();
+        for (int count = 0; count < cCodeLabel::MAX_LENGTH; count++) {
+          const int next = head_ip[lane] + 1;
+          if (next >= mem.GetSize() || m_nop_mod[mem[next].GetOp()] < 0) break;
+          head_ip[lane] = next;
+          label.AddNop(m_nop_mod[mem[next].GetOp()]);
+          if (label.GetSize() <= m_max_label_exe_size) mem.SetFlagExecuted(next);
+        }
+        label.Rotate(1, cHardwareCPU::NUM_NOPS);
+        if (label != cur.hw->GetReadLabel()) skipNext(lane);
+        break;
+      }
+
+      case KIND_H_COPY:
+      {
+        const int read_pos = adjust(head_read[lane], mem.GetSize());
+        const int write_pos = adjust(head_write[lane], mem.GetSize());
+        const Instruction read_inst = mem[read_pos];
+        cur.hw->ReadInst(read_inst.GetOp());
+        mem[write_pos] = read_inst;
+        mem.SetFlagCopied(write_pos);
+        head_read[lane] = adjust(read_pos + 1, mem.GetSize());
+        head_write[lane] = adjust(write_pos + 1, mem.GetSize());
+        break;
+      }
+    }
+
+    if (advance_ip) head_ip[lane] = adjust(head_ip[lane] + 1, mem.GetSize());
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ *  cHardwareCPULockstep.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cHardwareCPULockstep_h
+#define cHardwareCPULockstep_h
+
+#include "apto/core.h"
+
+#include "nHardware.h"
+
+class cAvidaContext;
+class cCPUMemory;
+class cHardwareCPU;
+class cInstSet;
+class cOrganism;
+class cPhenotype;
+class cTestCPU;
+class cWorld;
+
+
+// cHardwareCPULockstep - runs a chunk of test CPU gestations side by side (TEST_CPU_LOCKSTEP)
+// -------------------------------------------------------------------------------------------
+//
+// Every lane is one organism on original (heads) hardware.  Registers and head positions of all lanes are held as one
+// array per register and head, and each step advances every live lane by one instruction: lanes are grouped by the
+// kind of instruction they are about to execute and each group runs as a single loop over its lanes.  Memory, stacks
+// and labels stay in each lane's own hardware.
+//
+// Only the plain heads instructions (nops, flow control, math, stack and h-copy) run in lockstep.  h-alloc, h-divide,
+// h-search and IO, any instruction with a time cost or failure probability, and the step that reaches the organism's
+// execution limit are handed to the lane's cHardwareCPU::SingleProcess.  A lane is only accepted when those are the
+// only differences from cHardwareCPU's own execution: one thread, fast dispatch, no tracer, profiler, implicit
+// reproduction or copy mutations, and an instruction set made of nothing but the instructions above.
+//
+// The test CPU's resources must be fixed for the whole run (see cTestCPU::TestGenomes).
+
+class cHardwareCPULockstep
+{
+private:
+  enum eKind {
+    KIND_NOP = 0, KIND_IF_N_EQU, KIND_IF_LESS, KIND_POP, KIND_PUSH, KIND_SWAP_STK, KIND_SWAP, KIND_SHIFT_R, KIND_SHIFT_L,
+    KIND_INC, KIND_DEC, KIND_ADD, KIND_SUB, KIND_NAND, KIND_MOV_HEAD, KIND_JMP_HEAD, KIND_GET_HEAD, KIND_SET_FLOW,
+    KIND_IF_LABEL, KIND_H_COPY,
+    KIND_SCALAR,        // executed by the lane's own hardware
+    NUM_KINDS
+  };
+
+  static const int NUM_REGISTERS = 3;
+  static const int MAX_OPS = 256;
+
+  struct sLane
+  {
+    cOrganism* org;
+    cHardwareCPU* hw;
+    cCPUMemory* mem;
+    cPhenotype* phenotype;
+    int time_used;
+    int time_allocated;
+    int max_executed;
+    Apto::Array<int>* site_exec;
+
+    // The lane's share of the test CPU's input state, swapped in around scalar steps
+    Apto::Array<int> inputs;
+    int cur_input;
+    int cur_receive;
+  };
+
+  cTestCPU* m_test_cpu;
+
+  const cInstSet* m_inst_set;
+  bool m_usable;
+  signed char m_kind[MAX_OPS];
+  signed char m_nop_mod[MAX_OPS];   // -1 when the op is not a nop
+  int m_max_label_exe_size;
+
+  Apto::Array<sLane, Apto::Smart> m_lanes;
+  Apto::Array<int> m_reg[NUM_REGISTERS];
+  Apto::Array<int> m_head[nHardware::NUM_HEADS];
+
+  Apto::Array<int> m_active;
+  Apto::Array<int, Apto::Smart> m_bucket[NUM_KINDS];
+  int m_inputs_lane;                // lane whose input state is loaded in the test CPU, -1 for none
+
+
+public:
+  cHardwareCPULockstep(cWorld* world, cTestCPU* test_cpu);
+  ~cHardwareCPULockstep() { ; }
+
+  // Take over a freshly set up organism whose gestation has used time_used of time_allocated cycles; returns false,
+  // leaving the organism untouched, when it cannot run in lockstep
+  bool AddLane(cOrganism* org, int time_used, int time_allocated, Apto::Array<int>* site_exec);
+  int GetNumLanes() const { return m_lanes.GetSize(); }
+
+  // Run every lane to the end of its gestation, leaving its state in its hardware
+  void Run(cAvidaContext& ctx);
+
+private:
+  bool setupInstSet(cHardwareCPU* hw);
+
+  void gatherLane(int lane);
+  void scatterLane(int lane);
+  void loadInputs(int lane);
+
+  void stepScalar(cAvidaContext& ctx, int lane);
+  void stepKind(int kind);
+
+  inline int adjust(int pos, int size) const;
+  inline int findModifier(int lane, int default_mod);
+  inline void skipNext(int lane);
+  inline bool isRunning(const sLane& lane) const;
+
+  cHardwareCPULockstep(); // @not_implemented
+  cHardwareCPULockstep(const cHardwareCPULockstep&); // @not_implemented
+  cHardwareCPULockstep& operator=(const cHardwareCPULockstep&); // @not_implemented
+};
+
+#endif
@@ -62,7 +62,7 @@ inline unsigned int cHardwareExperimental::BitCount(unsigned int value) const
 }
 
 
-tInstLib<cHardwareExperimental::tMethod>* cHardwareExperimental::s_inst_slib = cHardwareExperimental::initInstLib();
+tInstLib<cHardwareExperimental::tMethod>* cHardwareExperimental::s_inst_slib = NULL;
 
 tInstLib<cHardwareExperimental::tMethod>* cHardwareExperimental::initInstLib(void)
 {
@@ -436,7 +436,7 @@ tInstLib<cHardwareExperimental::tMethod>* cHardwareExperimental::initInstLib(voi
 cHardwareExperimental::cHardwareExperimental(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set)
 : cHardwareBase(world, in_organism, in_inst_set), m_sensor(world, in_organism)
 {
-  m_functions = s_inst_slib->GetFunctions();
+  m_functions = GetInstLib()->GetFunctions();
   
   m_spec_die = false;
   
@@ -561,7 +561,9 @@ void cHardwareExperimental::cLocalThread::Reset(cHardwareExperimental* in_hardwa
 
 bool cHardwareExperimental::SingleProcess(cAvidaContext& ctx, bool speculative)
 {
-  assert(!speculative || (speculative && !m_thread_slicing_parallel));
+  // With parallel thread slicing a single call executes one instruction per thread; a stall partway through could not
+  // be rolled back, so only organisms running a single thread are speculated.
+  if (speculative && m_thread_slicing_parallel && m_threads.GetSize() > 1) return false;
   
   // Mark this organism as running...
   m_organism->SetRunning(true);
@@ -753,7 +755,11 @@ bool cHardwareExperimental::SingleProcess_ExecuteInst(cAvidaContext& ctx, const
   // And execute it.
   m_from_sensor = false;
   m_from_message = false;
+  cInstProfiler::tTicks sample_start = 0;
+  const bool sampled = beginInstSample(sample_start);
+  const cInstSet* sample_inst_set = m_inst_set;
   const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  if (sampled) endInstSample(sample_inst_set, actual_inst.GetOp(), sample_start);
   
 	if (exec_success) {
     int code_len = m_world->GetConfig().INST_CODE_LENGTH.Get();
@@ -1537,11 +1543,7 @@ bool cHardwareExperimental::Allocate_Main(cAvidaContext& ctx, const int allocate
 
 int cHardwareExperimental::calcCopiedSize(const int parent_size, const int child_size)
 {
-  int copied_size = 0;
-  for (int i = parent_size; i < parent_size + child_size; i++) {
-    if (m_memory.FlagCopied(i)) copied_size++;
-  }
-  return copied_size;
+  return m_memory.CountFlagCopied(parent_size, parent_size + child_size);
 }  
 
 bool cHardwareExperimental::Divide_Main(cAvidaContext& ctx, const int div_point, const int extra_lines, double mut_multiplier)
@@ -1559,7 +1561,7 @@ bool cHardwareExperimental::Divide_Main(cAvidaContext& ctx, const int div_point,
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
   
   // Cut off everything in this memory past the divide point.
   m_memory.Resize(div_point);
@@ -2984,11 +2986,10 @@ bool cHardwareExperimental::Inst_Repro(cAvidaContext& ctx)
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;  
+  m_organism->OffspringGenome().Adopt(offspring);  
   m_organism->GetPhenotype().SetLinesCopied(m_memory.GetSize());
   
-  int lines_executed = 0;
-  for (int i = 0; i < m_memory.GetSize(); i++) if (m_memory.FlagExecuted(i)) lines_executed++;
+  const int lines_executed = m_memory.CountFlagExecuted(0, m_memory.GetSize());
   m_organism->GetPhenotype().SetLinesExecuted(lines_executed);
   
   const Genome& org = m_organism->GetGenome();
@@ -3003,9 +3004,22 @@ bool cHardwareExperimental::Inst_Repro(cAvidaContext& ctx)
 
   // Perform Copy Mutations...
   if (m_organism->GetCopyMutProb() > 0 && (m_organism->GetForageTarget() < -1 || !m_world->GetConfig().PREY_MUT_OFF.Get())) { // Skip this if no mutations....
-    for (int i = 0; i < child_seq.GetSize(); i++) {
-//    for (int i = 0; i < m_memory.GetSize(); i++) {
-      if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+    if (m_world->GetConfig().COPY_MUT_SKIP.Get()) {
+      // Jump straight to each mutated site rather than testing every one
+      const double prob = m_organism->GetCopyMutProb();
+      const int size = child_seq.GetSize();
+      int i = ctx.GetTrialsToNextEvent(prob);
+      while (i < size) {
+        child_seq[i] = m_inst_set->GetRandomInst(ctx);
+        const int skip = ctx.GetTrialsToNextEvent(prob);
+        if (skip >= size - i - 1) break;
+        i += skip + 1;
+      }
+    } else {
+      for (int i = 0; i < child_seq.GetSize(); i++) {
+//      for (int i = 0; i < m_memory.GetSize(); i++) {
+        if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+      }
     }
   }
   
@@ -5752,7 +5766,7 @@ bool cHardwareExperimental::Inst_AttackFTPrey(cAvidaContext& ctx)
     if (!target->IsPreyFT())  { results.success = 1; return TestAttackResultsOut(results); }
   }    
   else if (m_use_avatar == 2) {
-    const Apto::Array<cOrganism*>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
+    const Apto::Array<cOrganism*, Apto::Smart>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
     bool target_match = false;
     int rand_index = ctx.GetRandom().GetUInt(0, av_neighbors.GetSize());
     int j = 0;
@@ -5823,7 +5837,7 @@ bool cHardwareExperimental::Inst_AttackPoisonFTPrey(cAvidaContext& ctx)
     if (!target->IsPreyFT())  { results.success = 1; return TestAttackResultsOut(results); }
   }    
   else if (m_use_avatar == 2) {
-    const Apto::Array<cOrganism*>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
+    const Apto::Array<cOrganism*, Apto::Smart>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
     bool target_match = false;
     int rand_index = ctx.GetRandom().GetUInt(0, av_neighbors.GetSize());
     int j = 0;
@@ -5885,7 +5899,7 @@ bool cHardwareExperimental::Inst_AttackPoisonFTPreyGenetic(cAvidaContext& ctx)
     if (!target->IsPreyFT())  { results.success = 1; return TestAttackResultsOut(results); }
   }
   else if (m_use_avatar == 2) {
-    const Apto::Array<cOrganism*>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
+    const Apto::Array<cOrganism*, Apto::Smart>& av_neighbors = m_organism->GetOrgInterface().GetFacedPreyAVs();
     bool target_match = false;
     int rand_index = ctx.GetRandom().GetUInt(0, av_neighbors.GetSize());
     int j = 0;
@@ -7229,7 +7243,7 @@ Apto::Array<cOrganism*> cHardwareExperimental::GetPredGroupAttackNeighbors()
     m_organism->GetOrgInterface().GetAVNeighborhoodCellIDs(neighborhood);
     for (int j = 0; j < neighborhood.GetSize(); j++) {
       if (m_organism->GetOrgInterface().GetCell(neighborhood[j])->HasPredAV()) {
-        Apto::Array<cOrganism*> predators = m_organism->GetOrgInterface().GetCell(neighborhood[j])->GetCellInputAVs();
+        const Apto::Array<cOrganism*, Apto::Smart>& predators = m_organism->GetOrgInterface().GetCell(neighborhood[j])->ReadCellInputAVs();
         for (int i = 0; i < predators.GetSize(); i++) {
           if (!predators[i]->IsDead() && !predators[i]->IsPreyFT()) pack.Push(predators[i]);
          }
@@ -7263,7 +7277,7 @@ Apto::Array<cOrganism*> cHardwareExperimental::GetPredSameGroupAttackNeighbors()
     m_organism->GetOrgInterface().GetAVNeighborhoodCellIDs(neighborhood);
     for (int j = 0; j < neighborhood.GetSize(); j++) {
       if (m_organism->GetOrgInterface().GetCell(neighborhood[j])->HasPredAV()) {
-        Apto::Array<cOrganism*> predators = m_organism->GetOrgInterface().GetCell(neighborhood[j])->GetCellInputAVs();
+        const Apto::Array<cOrganism*, Apto::Smart>& predators = m_organism->GetOrgInterface().GetCell(neighborhood[j])->ReadCellInputAVs();
         for (int i = 0; i < predators.GetSize(); i++) {
           if (!predators[i]->IsDead() && !predators[i]->IsPreyFT() && predators[i]->HasOpinion()) {
             if (predators[i]->GetOpinion().first == opinion) pack.Push(predators[i]);
@@ -104,19 +104,22 @@ private:
     DataValue* m_stack;
     int m_sp;
     
+    // Thread resets and copies keep the same size, so the storage is only replaced when the size changes
+    inline void setSize(int sz) { if (sz != m_sz) { delete [] m_stack; m_sz = sz; m_stack = new DataValue[sz]; } }
+    
   public:
     Stack() : m_sz(0), m_stack(NULL), m_sp(0) { ; }
-    inline Stack(const Stack& is) : m_sp(is.m_sp) { Clear(is.m_sz); for (int i = 0; i < m_sz; i++) m_stack[i] = is.m_stack[i]; }
+    inline Stack(const Stack& is) : m_sz(0), m_stack(NULL), m_sp(is.m_sp) { setSize(is.m_sz); for (int i = 0; i < m_sz; i++) m_stack[i] = is.m_stack[i]; }
     ~Stack() { delete [] m_stack; }
     
-    inline void operator=(const Stack& is) { m_sp = is.m_sp; Clear(is.m_sz); for (int i = 0; i < m_sz; i++) m_stack[i] = is.m_stack[i]; }
+    inline void operator=(const Stack& is) { m_sp = is.m_sp; setSize(is.m_sz); for (int i = 0; i < m_sz; i++) m_stack[i] = is.m_stack[i]; }
     
     inline void Push(const DataValue& value) { if (--m_sp < 0) m_sp = m_sz - 1; m_stack[(int)m_sp] = value; }
     inline DataValue Pop() { DataValue v = m_stack[(int)m_sp]; m_stack[(int)m_sp].Clear(); if (++m_sp == m_sz) m_sp = 0; return v; }
     inline DataValue& Peek() { return m_stack[(int)m_sp]; }
     inline const DataValue& Peek() const { return m_stack[(int)m_sp]; }
     inline const DataValue& Get(int d = 0) const { assert(d >= 0); int p = d + m_sp; return m_stack[(p >= m_sz) ? (p - m_sz) : p]; }
-    inline void Clear(int sz) { delete [] m_stack; m_sz = sz; m_stack = new DataValue[sz]; }
+    inline void Clear(int sz) { if (sz == m_sz) { for (int i = 0; i < m_sz; i++) m_stack[i].Clear(); } else setSize(sz); }
   };
   
   
@@ -240,7 +243,7 @@ public:
   cHardwareExperimental(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set);
   ~cHardwareExperimental() { ; }
   
-  static tInstLib<cHardwareExperimental::tMethod>* GetInstLib() { return s_inst_slib; }
+  static tInstLib<cHardwareExperimental::tMethod>* GetInstLib() { if (!s_inst_slib) s_inst_slib = initInstLib(); return s_inst_slib; }
   static cString GetDefaultInstFilename() { return "instset-experimental.cfg"; }
   
   
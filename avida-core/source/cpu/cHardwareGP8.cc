@@ -49,7 +49,7 @@ using namespace Avida;
 using namespace AvidaTools;
 
 
-cHardwareGP8::GP8InstLib* cHardwareGP8::s_inst_slib = cHardwareGP8::initInstLib();
+cHardwareGP8::GP8InstLib* cHardwareGP8::s_inst_slib = NULL;
 
 cHardwareGP8::GP8InstLib* cHardwareGP8::initInstLib(void)
 {
@@ -237,9 +237,9 @@ cHardwareGP8::GP8InstLib* cHardwareGP8::initInstLib(void)
 cHardwareGP8::cHardwareGP8(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set)
 : cHardwareBase(world, in_organism, in_inst_set), m_genes(0), m_mem_array(1), m_sensor(world, in_organism), m_sensor_sessions(NUM_NOPS)
 {
-  m_functions = s_inst_slib->Functions();
-  m_hw_units = s_inst_slib->HWUnits();
-  m_imm_methods = s_inst_slib->ImmediateMethods();
+  m_functions = getInstLib()->Functions();
+  m_hw_units = getInstLib()->HWUnits();
+  m_imm_methods = getInstLib()->ImmediateMethods();
   
   m_spec_die = false;
   
@@ -623,7 +623,11 @@ bool cHardwareGP8::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instructi
   m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
   
   // And execute it.
+  cInstProfiler::tTicks sample_start = 0;
+  const bool sampled = beginInstSample(sample_start);
+  const cInstSet* sample_inst_set = m_inst_set;
   const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  if (sampled) endInstSample(sample_inst_set, actual_inst.GetOp(), sample_start);
   
   // decremenet if the instruction was not executed successfully
   if (exec_success == false) {
@@ -1315,12 +1319,8 @@ inline int cHardwareGP8::FindUpstreamModifiedRegister(int offset, int default_re
 
 int cHardwareGP8::calcCopiedSize(const int parent_size, const int child_size)
 {
-  int copied_size = 0;
   const cCPUMemory& memory = m_mem_array[m_cur_offspring];
-  for (int i = 0; i < memory.GetSize(); i++) {
-    if (memory.FlagCopied(i)) copied_size++;
-	}
-  return copied_size;
+  return memory.CountFlagCopied(0, memory.GetSize());
 }
 
 
@@ -1341,7 +1341,7 @@ bool cHardwareGP8::Divide_Main(cAvidaContext& ctx, int mem_space_used, int write
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
   
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
 	
   // Handle Divide Mutations...
   Divide_DoMutations(ctx, mut_multiplier);
@@ -2167,11 +2167,10 @@ bool cHardwareGP8::Inst_Repro(cAvidaContext& ctx)
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;  
+  m_organism->OffspringGenome().Adopt(offspring);  
   m_organism->GetPhenotype().SetLinesCopied(memory.GetSize());
   
-  int lines_executed = 0;
-  for (int i = 0; i < memory.GetSize(); i++) if (memory.FlagExecuted(i)) lines_executed++;
+  const int lines_executed = memory.CountFlagExecuted(0, memory.GetSize());
   m_organism->GetPhenotype().SetLinesExecuted(lines_executed);
   
   const Genome& org = m_organism->GetGenome();
@@ -2186,9 +2185,22 @@ bool cHardwareGP8::Inst_Repro(cAvidaContext& ctx)
 
   // Perform Copy Mutations...
   if (m_organism->GetCopyMutProb() > 0) { // Skip this if no mutations....
-    for (int i = 0; i < child_seq.GetSize(); i++) {
-//    for (int i = 0; i < m_memory.GetSize(); i++) {
-      if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+    if (m_world->GetConfig().COPY_MUT_SKIP.Get()) {
+      // Jump straight to each mutated site rather than testing every one
+      const double prob = m_organism->GetCopyMutProb();
+      const int size = child_seq.GetSize();
+      int i = ctx.GetTrialsToNextEvent(prob);
+      while (i < size) {
+        child_seq[i] = m_inst_set->GetRandomInst(ctx);
+        const int skip = ctx.GetTrialsToNextEvent(prob);
+        if (skip >= size - i - 1) break;
+        i += skip + 1;
+      }
+    } else {
+      for (int i = 0; i < child_seq.GetSize(); i++) {
+//      for (int i = 0; i < m_memory.GetSize(); i++) {
+        if (m_organism->TestCopyMut(ctx)) child_seq[i] = m_inst_set->GetRandomInst(ctx);
+      }
     }
   }
   
@@ -322,7 +322,7 @@ public:
   cHardwareGP8(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set);
   ~cHardwareGP8() { ; }
   
-  static cInstLib* GetInstLib() { return s_inst_slib; }
+  static cInstLib* GetInstLib() { return getInstLib(); }
   
   
   // --------  Core Execution Methods  --------
@@ -384,7 +384,7 @@ public:
   
 private:
   
-  static GP8InstLib* getInstLib() { return s_inst_slib; }
+  static GP8InstLib* getInstLib() { if (!s_inst_slib) s_inst_slib = initInstLib(); return s_inst_slib; }
 
   // --------  Core Execution Methods  --------
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
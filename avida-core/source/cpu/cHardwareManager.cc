@@ -33,26 +33,48 @@
 #include "cHardwareTransSMT.h"
 #include "cHardwareStatusPrinter.h"
 #include "cInitFile.h"
+#include "cInstProfiler.h"
 #include "cInstSet.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 
+#include <new>
+
 using namespace Avida;
 
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
 
 cHardwareManager::cHardwareManager(cWorld* world)
 : m_world(world)
+, m_test_cache(world->GetConfig().TEST_CPU_CACHE_SIZE.Get())
+, m_inst_profiler(NULL)
 {
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.Set("(default)", 0);
+  
+  const int profile_interval = world->GetConfig().INST_PROFILE_INTERVAL.Get();
+  if (profile_interval > 0) m_inst_profiler = new cInstProfiler(profile_interval);
 
 }
 
 cHardwareManager::~cHardwareManager()
 {
+  for (int i = 0; i < m_hw_pool.GetSize(); i++) {
+    for (int j = 0; j < m_hw_pool[i].GetSize(); j++) ::operator delete(m_hw_pool[i][j]);
+  }
   for (int i = 0; i < m_inst_sets.GetSize(); i++) delete m_inst_sets[i];
+  delete m_inst_profiler;
+}
+
+
+void cHardwareManager::SetupInstLibs()
+{
+  cHardwareCPU::GetInstLib();
+  cHardwareTransSMT::GetInstLib();
+  cHardwareExperimental::GetInstLib();
+  cHardwareGP8::GetInstLib();
+  cHardwareBCR::GetInstLib();
 }
 
 
@@ -150,6 +172,7 @@ bool cHardwareManager::loadInstSet(int hw_type, const Apto::String& name, int st
   
   int inst_set_id = m_inst_sets.GetSize();
   m_inst_sets.Push(inst_set);
+  m_hw_pool.Resize(m_inst_sets.GetSize());
   m_is_name_map.Set(name, inst_set_id);
   
   Apto::Array<cString> names(inst_set->GetSize());
@@ -255,22 +278,33 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
     return NULL; // inst_set/hw_type mismatch
   }
   
+  // Reuse the storage of previously destroyed hardware of this instruction set, when available.  It is only ever
+  // pooled by instruction set, so it always came from an object of the same type (and size) built below.
+  void* storage = NULL;
+  m_pool_mutex.Lock();
+  Apto::Array<void*, Apto::Smart>& pool = m_hw_pool[inst_set_id];
+  if (pool.GetSize()) {
+    storage = pool[pool.GetSize() - 1];
+    pool.Resize(pool.GetSize() - 1);
+  }
+  m_pool_mutex.Unlock();
+  
   cHardwareBase* hw = 0;
   switch (inst_set->GetHardwareType()) {
     case HARDWARE_TYPE_CPU_ORIGINAL:
-      hw = new cHardwareCPU(ctx, m_world, org, inst_set);
+      hw = (storage) ? new (storage) cHardwareCPU(ctx, m_world, org, inst_set) : new cHardwareCPU(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_TRANSSMT:
-      hw = new cHardwareTransSMT(ctx, m_world, org, inst_set);
+      hw = (storage) ? new (storage) cHardwareTransSMT(ctx, m_world, org, inst_set) : new cHardwareTransSMT(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_EXPERIMENTAL:
-      hw = new cHardwareExperimental(ctx, m_world, org, inst_set);
+      hw = (storage) ? new (storage) cHardwareExperimental(ctx, m_world, org, inst_set) : new cHardwareExperimental(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_GP8:
-      hw = new cHardwareGP8(ctx, m_world, org, inst_set);
+      hw = (storage) ? new (storage) cHardwareGP8(ctx, m_world, org, inst_set) : new cHardwareGP8(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_BCR:
-      hw = new cHardwareBCR(ctx, m_world, org, inst_set);
+      hw = (storage) ? new (storage) cHardwareBCR(ctx, m_world, org, inst_set) : new cHardwareBCR(ctx, m_world, org, inst_set);
       break;
     default:
       assert(false);
@@ -282,12 +316,36 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   return hw;
 }
 
+void cHardwareManager::Recycle(cHardwareBase* hw)
+{
+  if (!hw) return;
+  
+  int inst_set_id = -1;
+  for (int i = 0; i < m_inst_sets.GetSize(); i++) {
+    if (m_inst_sets[i] == &hw->GetInstSet()) {
+      inst_set_id = i;
+      break;
+    }
+  }
+  
+  Apto::MutexAutoLock lock(m_pool_mutex);
+  if (inst_set_id == -1 || m_hw_pool[inst_set_id].GetSize() >= MAX_POOLED_HARDWARE) {
+    delete hw;
+    return;
+  }
+  
+  // Destroy the object but hold on to its storage for the next Create with this instruction set
+  hw->~cHardwareBase();
+  m_hw_pool[inst_set_id].Push(static_cast<void*>(hw));
+}
+
 bool cHardwareManager::RegisterInstSet(const Apto::String& name, cInstSet* inst_set)
 {
   if (m_is_name_map.Has(name)) return false;
   
   int inst_set_id = m_inst_sets.GetSize();
   m_inst_sets.Push(inst_set);
+  m_hw_pool.Resize(m_inst_sets.GetSize());
   m_is_name_map.Set(name, inst_set_id);  
   
   return true;
@@ -23,6 +23,9 @@
 #define cHardwareManager_h
 
 #include "cTestCPU.h"
+#include "cTestCPUCache.h"
+
+#include "apto/core/Mutex.h"
 
 namespace Avida {
   class Genome;
@@ -30,6 +33,7 @@ namespace Avida {
 
 class cAvidaContext;
 class cHardwareBase;
+class cInstProfiler;
 class cInstSet;
 class cOrganism;
 class cStringList;
@@ -46,6 +50,14 @@ private:
   cWorld* m_world;
   Apto::Array<cInstSet*> m_inst_sets;
   Apto::Map<Apto::String, int> m_is_name_map;
+  
+  // Storage of destroyed hardware, per instruction set (and so per hardware type), reused by Create
+  Apto::Mutex m_pool_mutex;
+  Apto::Array<Apto::Array<void*, Apto::Smart> > m_hw_pool;
+  static const int MAX_POOLED_HARDWARE = 4096;
+  
+  cTestCPUCache m_test_cache;
+  cInstProfiler* m_inst_profiler;   // NULL unless INST_PROFILE_INTERVAL is set
 
   
   cHardwareManager(); // @not_implemented
@@ -60,14 +72,22 @@ public:
   static void Initialize();
   static void SetupPropertyMap(PropertyMap& props, const Apto::String& inst_set);
   
+  // Build the instruction libraries of every hardware type now, rather than when an instruction set first needs one
+  static void SetupInstLibs();
+  
   
   bool LoadInstSets(cUserFeedback* feedback = NULL);
   bool ConvertLegacyInstSetFile(cString filename, cStringList& str_list, cUserFeedback* feedback = NULL);
   
   cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg);
+  void Recycle(cHardwareBase* hw);
   inline cTestCPU* CreateTestCPU(cAvidaContext& ctx) { return new cTestCPU(ctx, m_world); }
+  cTestCPUCache& GetTestCPUCache() { return m_test_cache; }
+  const cTestCPUCache& GetTestCPUCache() const { return m_test_cache; }
+  cInstProfiler* GetInstProfiler() { return m_inst_profiler; }
 
   inline bool IsInstSet(const Apto::String& name) const { return m_is_name_map.Has(name); }
+  inline int GetInstSetID(const Apto::String& name) const { return (name == "(default)") ? 0 : m_is_name_map.GetWithDefault(name, -1); }
   
   inline const cInstSet& GetInstSet(const Apto::String& name) const;
   inline cInstSet& GetInstSet(const Apto::String& name);
@@ -0,0 +1,378 @@
+/*
+ *  cHardwareTraceRecorder.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cHardwareTraceRecorder.h"
+
+#include "avida/core/InstructionSequence.h"
+#include "avida/output/Manager.h"
+#include "avida/private/output/AsyncWriter.h"
+#include "avida/systematics/Group.h"
+
+#include "cHardwareBase.h"
+#include "cHeadCPU.h"
+#include "cInstSet.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cStats.h"
+#include "cString.h"
+#include "cWorld.h"
+#include "nHardware.h"
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace Avida;
+using namespace std;
+
+
+namespace {
+  static const unsigned int TRACE_RECORDER_VERSION = 1;
+  static const unsigned int TRACE_ENDIAN_MARKER = 0x01020304;
+
+  // Sequential reader over a recording held in memory; any read past the end marks the reader as failed
+  class cTraceReader
+  {
+  private:
+    const std::string& m_data;
+    size_t m_pos;
+    bool m_failed;
+
+  public:
+    cTraceReader(const std::string& data) : m_data(data), m_pos(0), m_failed(false) { ; }
+
+    bool AtEnd() const { return m_failed || m_pos >= m_data.size(); }
+    bool Failed() const { return m_failed; }
+
+    bool Read(void* dest, size_t size)
+    {
+      if (m_failed || m_pos + size > m_data.size()) { m_failed = true; return false; }
+      m_data.copy(static_cast<char*>(dest), size, m_pos);
+      m_pos += size;
+      return true;
+    }
+
+    int ReadInt() { int value = 0; Read(&value, sizeof(int)); return value; }
+
+    cString ReadString()
+    {
+      const int len = ReadInt();
+      if (len < 0 || m_pos + len > m_data.size()) { m_failed = true; return cString(""); }
+      cString str(m_data.data() + m_pos, len);
+      m_pos += len;
+      return str;
+    }
+  };
+}
+
+
+cHardwareTraceRecorder::cHardwareTraceRecorder(cWorld* world, const cString& filename, bool minitracer)
+  : m_world(world), m_minitracer(minitracer), m_header_done(false), m_update(-1), m_num_regs(0), m_regs_valid(false)
+  , m_block_used(0)
+{
+  Avida::Output::ManagerPtr mgr = Avida::Output::Manager::Of(world->GetNewWorld());
+  Apto::String path = mgr->OutputIDFromPath((const char*)filename);
+  if (path.GetSize()) m_fp.open((const char*)path, ios::out | ios::trunc | ios::binary);
+  if (!m_fp.good()) return;
+
+  m_writer = mgr->AsyncOutputWriter();
+
+  append("AVIDATRC", 8);
+  append(&TRACE_RECORDER_VERSION, sizeof(TRACE_RECORDER_VERSION));
+  append(&TRACE_ENDIAN_MARKER, sizeof(TRACE_ENDIAN_MARKER));
+}
+
+cHardwareTraceRecorder::~cHardwareTraceRecorder()
+{
+  if (!m_fp.is_open()) return;
+
+  flushBlock();
+
+  // Queued blocks write to the filebuf, so they must all land before it is closed
+  if (m_writer) m_writer->WaitIdle();
+  m_fp.close();
+}
+
+
+void cHardwareTraceRecorder::TraceHardware(cAvidaContext&, cHardwareBase& hardware, bool bonus, bool mini, int exec_success)
+{
+  if (!m_fp.is_open() || !hardware.GetOrganism()) return;
+
+  // Mirrors cHardwareStatusPrinter: full traces record every status call, mini-traces record the status before and
+  // the result after each instruction, and the first mini-trace call always records the status
+  bool in_setup = false;
+  if (!m_header_done) {
+    if (m_minitracer && !mini) return;
+    writeHeader(hardware);
+    in_setup = m_minitracer;
+  }
+
+  if (exec_success == -2 || in_setup) {
+    if (!m_minitracer && !mini) recordStep(hardware, bonus);
+    else if (m_minitracer && mini) recordStep(hardware, false);
+  }
+  if (exec_success != -2 && m_minitracer && mini) {
+    appendRecordType(RECORD_SUCCESS);
+    appendInt(exec_success);
+  }
+}
+
+void cHardwareTraceRecorder::PrintSuccess(cOrganism*, int exec_success)
+{
+  if (!m_fp.is_open() || !m_header_done) return;
+
+  appendRecordType(RECORD_SUCCESS);
+  appendInt(exec_success);
+}
+
+void cHardwareTraceRecorder::TraceTestCPU(int time_used, int time_allocated, const cOrganism&)
+{
+  if (!m_fp.is_open() || !m_header_done) return;
+
+  appendRecordType(RECORD_FINAL);
+  appendInt(time_used);
+  appendInt(time_allocated);
+}
+
+
+void cHardwareTraceRecorder::writeHeader(cHardwareBase& hardware)
+{
+  cOrganism* organism = hardware.GetOrganism();
+
+  int gen_id = -1;
+  cString genotype_name("");
+  Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+  if (genotype) {
+    gen_id = genotype->ID();
+    genotype_name = (const char*)genotype->Properties().Get("genotype").StringValue();
+  }
+
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(organism->GetGenome().Representation());
+
+  m_num_regs = hardware.GetNumRegisters();
+  if (m_num_regs > MAX_REGISTERS) m_num_regs = MAX_REGISTERS;
+
+  appendInt(m_minitracer ? 1 : 0);
+  appendInt(hardware.GetType());
+  appendInt(m_num_regs);
+  appendInt(organism->GetID());
+  appendInt(gen_id);
+  appendInt(m_world->GetStats().GetUpdate());
+  appendInt((seq) ? seq->GetSize() : 0);
+  appendString(genotype_name);
+
+  const cInstSet& inst_set = hardware.GetInstSet();
+  appendInt(inst_set.GetSize());
+  for (int i = 0; i < inst_set.GetSize(); i++) appendString(inst_set.GetName(i));
+
+  m_header_done = true;
+}
+
+void cHardwareTraceRecorder::recordStep(cHardwareBase& hardware, bool bonus)
+{
+  const int update = m_world->GetStats().GetUpdate();
+  if (update != m_update) {
+    appendRecordType(RECORD_UPDATE);
+    appendInt(update);
+    m_update = update;
+  }
+
+  sStep step;
+  step.cycle = hardware.GetOrganism()->GetPhenotype().GetCPUCyclesUsed();
+  step.ip = hardware.IP().GetPosition();
+  const int num_heads = hardware.GetNumHeads();
+  for (int h = 0; h < 3; h++) {
+    step.heads[h] = (nHardware::HEAD_READ + h < num_heads) ? hardware.GetHead(nHardware::HEAD_READ + h).GetPosition() : -1;
+  }
+  step.opcode = static_cast<unsigned short>(hardware.IP().GetInst().GetOp());
+  step.thread = static_cast<unsigned char>(hardware.GetCurThread());
+  step.bonus = (bonus) ? 1 : 0;
+
+  // The first step carries every register, later steps only the ones that changed
+  int values[MAX_REGISTERS];
+  step.reg_mask = 0;
+  for (int i = 0; i < m_num_regs; i++) {
+    values[i] = hardware.GetRegister(i);
+    if (!m_regs_valid || values[i] != m_regs[i]) step.reg_mask |= (1u << i);
+  }
+  m_regs_valid = true;
+
+  appendRecordType(RECORD_STEP);
+  append(&step, sizeof(step));
+  for (int i = 0; i < m_num_regs; i++) {
+    if (step.reg_mask & (1u << i)) {
+      appendInt(values[i]);
+      m_regs[i] = values[i];
+    }
+  }
+}
+
+
+void cHardwareTraceRecorder::appendString(const cString& str)
+{
+  appendInt(str.GetSize());
+  append((const char*)str, str.GetSize());
+}
+
+void cHardwareTraceRecorder::flushBlock()
+{
+  if (!m_block_used) return;
+
+  if (m_writer) {
+    // The writer copies the block, so it can be refilled right away
+    m_writer->Submit(m_fp.rdbuf(), m_block, m_block_used);
+  } else {
+    m_fp.write(m_block, m_block_used);
+  }
+  m_block_used = 0;
+}
+
+
+
+bool cHardwareTraceRecorder::Decode(const cString& in_path, ostream& out)
+{
+  ifstream in((const char*)in_path, ios::in | ios::binary);
+  if (!in.good()) return false;
+  ostringstream contents;
+  contents << in.rdbuf();
+  const std::string data = contents.str();
+
+  cTraceReader reader(data);
+  char magic[8];
+  unsigned int version = 0;
+  unsigned int marker = 0;
+  reader.Read(magic, 8);
+  reader.Read(&version, sizeof(version));
+  reader.Read(&marker, sizeof(marker));
+  if (reader.Failed() || std::string(magic, 8) != "AVIDATRC" || version != TRACE_RECORDER_VERSION ||
+      marker != TRACE_ENDIAN_MARKER) {
+    return false;
+  }
+
+  // A recording whose organism never ran holds no header
+  if (reader.AtEnd()) return true;
+
+  const bool minitrace = (reader.ReadInt() != 0);
+  reader.ReadInt(); // hardware type
+  const int num_regs = reader.ReadInt();
+  const int org_id = reader.ReadInt();
+  const int gen_id = reader.ReadInt();
+  const int update_born = reader.ReadInt();
+  const int genome_length = reader.ReadInt();
+  const cString genotype_name = reader.ReadString();
+  const int num_insts = reader.ReadInt();
+  if (reader.Failed() || num_regs < 0 || num_regs > MAX_REGISTERS || num_insts < 0) return false;
+  Apto::Array<cString> inst_names(num_insts);
+  for (int i = 0; i < num_insts; i++) inst_names[i] = reader.ReadString();
+
+  if (minitrace) {
+    out << "# Update Born: " << update_born << endl;
+    out << "# Org ID: " << org_id << endl;
+    out << "# Genotype ID: " << gen_id << endl;
+    out << "# Genotype: " << genotype_name << endl;
+    out << "# Genome Length: " << genome_length << endl;
+    out << "# " << endl;
+    out << "# Exec Stats Columns:" << endl;
+    out << "# CPU Cycle" << endl;
+    out << "# Current Update" << endl;
+    out << "# Register Contents" << endl;
+    out << "# Current Thread" << endl;
+    out << "# IP Position" << endl;
+    out << "# RH Position" << endl;
+    out << "# WH Position" << endl;
+    out << "# FH Position" << endl;
+    out << "# Queued Instruction" << endl;
+    out << "# Did Queued Instruction Execute (-1=no, paying cpu costs; 0=failed; 1=yes)" << endl;
+    out << endl;
+  }
+
+  int update = -1;
+  int regs[MAX_REGISTERS];
+  for (int i = 0; i < MAX_REGISTERS; i++) regs[i] = 0;
+  bool line_open = false;
+
+  while (!reader.AtEnd()) {
+    unsigned char type = 0;
+    reader.Read(&type, 1);
+
+    switch (type) {
+      case RECORD_UPDATE:
+        update = reader.ReadInt();
+        break;
+
+      case RECORD_STEP:
+      {
+        sStep step;
+        reader.Read(&step, sizeof(step));
+        for (int i = 0; i < num_regs; i++) if (step.reg_mask & (1u << i)) regs[i] = reader.ReadInt();
+        if (reader.Failed()) break;
+
+        cString inst_name = (step.opcode < num_insts) ? inst_names[step.opcode] : cString("?");
+        if (minitrace) {
+          if (line_open) out << endl;
+          out << step.cycle << " " << update << " ";
+          for (int i = 0; i < num_regs; i++) out << regs[i] << " ";
+          out << static_cast<int>(step.thread) << " " << step.ip << " ";
+          out << step.heads[0] << " " << step.heads[1] << " " << step.heads[2] << " ";
+          out << inst_name << " ";
+          line_open = true;
+        } else {
+          out << "---------------------------" << endl;
+          out << "U:" << update << endl;
+          out << step.cycle << " IP:" << step.ip << " (" << inst_name << ")" << endl;
+          for (int i = 0; i < num_regs; i++) {
+            out << static_cast<char>('A' + i) << "X:" << regs[i] << " ";
+            out << setbase(16) << "[0x" << regs[i] << "]  " << setbase(10);
+          }
+          out << endl;
+          out << "  R-Head:" << step.heads[0] << " W-Head:" << step.heads[1] << " F-Head:" << step.heads[2] << endl;
+        }
+        break;
+      }
+
+      case RECORD_SUCCESS:
+      {
+        const int exec_success = reader.ReadInt();
+        if (reader.Failed()) break;
+        out << exec_success << endl;
+        line_open = false;
+        break;
+      }
+
+      case RECORD_FINAL:
+      {
+        const int time_used = reader.ReadInt();
+        const int time_allocated = reader.ReadInt();
+        if (reader.Failed()) break;
+        out << "---------------------------" << endl;
+        if (time_used == time_allocated) out << endl << "# TIMEOUT: No offspring produced." << endl;
+        else out << endl << "# Time Used: " << time_used << " of " << time_allocated << endl;
+        break;
+      }
+
+      default:
+        return false;
+    }
+  }
+  if (line_open) out << endl;
+
+  return !reader.Failed();
+}
@@ -0,0 +1,125 @@
+/*
+ *  cHardwareTraceRecorder.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cHardwareTraceRecorder_h
+#define cHardwareTraceRecorder_h
+
+#include "avida/output/Types.h"
+
+#include "cHardwareTracer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+class cString;
+class cWorld;
+
+
+// cHardwareTraceRecorder - traces execution as compact binary records instead of formatted text (BINARY_TRACES)
+// --------------------------------------------------------------------------------------------------------------
+//
+// Each traced instruction appends a fixed size step record to an in memory block; full blocks are handed to the
+// asynchronous output writer when ASYNC_OUTPUT is on, otherwise written directly.  Decode() turns a recording back
+// into the text layout of cHardwareStatusPrinter for the state every hardware type shares.
+//
+// Header:  "AVIDATRC", uint32 version (1), uint32 endian marker (0x01020304), then int32 mini-trace flag, hardware
+//          type, register count, org id, genotype id, update, genome length, genotype name and instruction names
+//          (each an int32 count followed by that many strings, every string an int32 length and its characters);
+//          all in host byte order
+//
+// Records: a uint8 record type followed by its fields
+//
+//   STEP (1)     sStep, then one int32 for every register whose bit is set in sStep::reg_mask (value changed since
+//                the previous step; the first step of a recording sets every bit)
+//   SUCCESS (2)  int32 execution result of the preceding step (-1 = paying cpu costs, 0 = failed, 1 = executed)
+//   UPDATE (3)   int32 update, written before the first step of each new update
+//   FINAL (4)    int32 time used, int32 time allocated (test CPU traces)
+
+class cHardwareTraceRecorder : public cHardwareTracer
+{
+public:
+  enum RecordType { RECORD_STEP = 1, RECORD_SUCCESS, RECORD_UPDATE, RECORD_FINAL };
+
+  static const int MAX_REGISTERS = 32;
+  static const int BLOCK_SIZE = 64 * 1024;
+
+  struct sStep
+  {
+    int cycle;
+    int ip;
+    int heads[3];          // read, write, flow (-1 when the hardware has no such head)
+    unsigned short opcode;
+    unsigned char thread;
+    unsigned char bonus;
+    unsigned int reg_mask;
+  };
+
+private:
+  cWorld* m_world;
+  std::ofstream m_fp;
+  Avida::Output::AsyncWriterPtr m_writer;
+  bool m_minitracer;
+  bool m_header_done;
+
+  int m_update;
+  int m_num_regs;
+  int m_regs[MAX_REGISTERS];
+  bool m_regs_valid;
+
+  char m_block[BLOCK_SIZE];
+  int m_block_used;
+
+
+public:
+  cHardwareTraceRecorder(cWorld* world, const cString& filename, bool minitracer = false);
+  ~cHardwareTraceRecorder();
+
+  void TraceHardware(cAvidaContext& ctx, cHardwareBase& hardware, bool bonus, bool mini, int exec_success);
+  void PrintSuccess(cOrganism* organism, int exec_success);
+  void TraceTestCPU(int time_used, int time_allocated, const cOrganism& organism);
+
+  // Writes the text form of the recording at in_path to out, returning false if it is not a trace recording
+  static bool Decode(const cString& in_path, std::ostream& out);
+
+private:
+  void writeHeader(cHardwareBase& hardware);
+  void recordStep(cHardwareBase& hardware, bool bonus);
+
+  inline void append(const void* data, int size);
+  inline void appendInt(int value) { append(&value, sizeof(int)); }
+  inline void appendRecordType(RecordType type) { const unsigned char t = type; append(&t, 1); }
+  void appendString(const cString& str);
+  void flushBlock();
+
+  cHardwareTraceRecorder(); // @not_implemented
+  cHardwareTraceRecorder(const cHardwareTraceRecorder&); // @not_implemented
+  cHardwareTraceRecorder& operator=(const cHardwareTraceRecorder&); // @not_implemented
+};
+
+
+inline void cHardwareTraceRecorder::append(const void* data, int size)
+{
+  if (m_block_used + size > BLOCK_SIZE) flushBlock();
+  memcpy(m_block + m_block_used, data, size);
+  m_block_used += size;
+}
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
+#include "cDeme.h"
 #include "cEnvironment.h"
 #include "cInstLib.h"
 #include "cInstSet.h"
@@ -43,7 +44,7 @@
 using namespace std;
 using namespace AvidaTools;
 
-tInstLib<cHardwareTransSMT::tMethod>* cHardwareTransSMT::s_inst_slib = cHardwareTransSMT::initInstLib();
+tInstLib<cHardwareTransSMT::tMethod>* cHardwareTransSMT::s_inst_slib = NULL;
 
 tInstLib<cHardwareTransSMT::tMethod>* cHardwareTransSMT::initInstLib(void)
 {
@@ -135,7 +136,12 @@ tInstLib<cHardwareTransSMT::tMethod>* cHardwareTransSMT::initInstLib(void)
 cHardwareTransSMT::cHardwareTransSMT(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set)
 : cHardwareBase(world, in_organism, in_inst_set), m_mem_array(1)
 {
-  m_functions = s_inst_slib->GetFunctions();
+  m_functions = GetInstLib()->GetFunctions();
+  
+  m_slicing_parallel = (m_world->GetConfig().THREAD_SLICING_METHOD.Get() == 1);
+  m_host_virulence = (m_world->GetConfig().VIRULENCE_SOURCE.Get() == 2);
+  m_parasite_virulence = m_world->GetConfig().PARASITE_VIRULENCE.Get();
+  m_thread_quantum = m_slicing_parallel ? 1 : Apto::Max(1, m_world->GetConfig().SMT_THREAD_QUANTUM.Get());
 	
   const Genome& org = in_organism->GetGenome();
   ConstInstructionSequencePtr org_seq_p;
@@ -161,6 +167,7 @@ void cHardwareTransSMT::internalReset()
   // Reset that single thread.
   m_threads[0].Reset(this, 0);
   m_cur_thread = 0;
+  m_quantum_left = 0;
   
   // Reset all stacks (local and global)
   for(int i = 0; i < NUM_STACKS; i++) {
@@ -212,51 +219,58 @@ bool cHardwareTransSMT::SingleProcess(cAvidaContext& ctx, bool speculative)
   cPhenotype& phenotype = m_organism->GetPhenotype();
   phenotype.IncTimeUsed();
 	
-  const int num_inst_exec = (m_world->GetConfig().THREAD_SLICING_METHOD.Get() == 1) ? m_threads.GetSize() : 1;
+  const int num_inst_exec = m_slicing_parallel ? m_threads.GetSize() : 1;
   
   for (int i = 0; i < num_inst_exec; i++) {
-    double parasiteVirulence;
-    // Setup the hardware for the next instruction to be executed.
-    m_cur_thread++;
-		//Ignore incremeting the thread, set it to be the parasite, unless we draw something lower thean 0.8
-		//Then set it to the parasite
-    if (m_threads.GetSize() > 1 &&  m_threads[1].owner->UnitSource().transmission_type == Systematics::HORIZONTAL)
-    {
-      Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
-      parasite.DynamicCastFrom(m_threads[1].owner);
-      //Virulence can be from parasite or host
-      if (m_world->GetConfig().VIRULENCE_SOURCE.Get() == 2) {
-        //Host controls threads donated to parasite @AEJ
-        parasiteVirulence = m_organism->GetParaDonate();
-      } else {
-        //Parasite inherited virulence
-        parasiteVirulence = parasite->GetVirulence();
+    // Keep running the current thread until its quantum is used up
+    if (m_quantum_left > 0 && m_cur_thread < m_threads.GetSize()) {
+      m_quantum_left--;
+    } else {
+      m_quantum_left = m_thread_quantum - 1;
+      
+      double parasiteVirulence;
+      // Setup the hardware for the next instruction to be executed.
+      m_cur_thread++;
+      //Ignore incremeting the thread, set it to be the parasite, unless we draw something lower thean 0.8
+      //Then set it to the parasite
+      if (m_threads.GetSize() > 1 &&  m_threads[1].owner->UnitSource().transmission_type == Systematics::HORIZONTAL)
+      {
+        Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
+        parasite.DynamicCastFrom(m_threads[1].owner);
+        //Virulence can be from parasite or host
+        if (m_host_virulence) {
+          //Host controls threads donated to parasite @AEJ
+          parasiteVirulence = m_organism->GetParaDonate();
+        } else {
+          //Parasite inherited virulence
+          parasiteVirulence = parasite->GetVirulence();
+        }
+      }
+      else
+      {
+        parasiteVirulence = m_parasite_virulence;
       }
-    }
-    else
-    {
-      parasiteVirulence = m_world->GetConfig().PARASITE_VIRULENCE.Get();
-    }
-    
-    //Parasites steal CPU cycles only if threads execute one at a time.
-		if (parasiteVirulence != -1 && m_world->GetConfig().THREAD_SLICING_METHOD.Get() == 0) {
       
-			double probThread = ctx.GetRandom().GetDouble();
+      //Parasites steal CPU cycles only if threads execute one at a time.
+      if (parasiteVirulence != -1 && !m_slicing_parallel) {
+        
+        double probThread = ctx.GetRandom().GetDouble();
+        
+        //Default to the first thread
+        m_cur_thread = 0;
+        if (probThread < parasiteVirulence)
+        {
+          //LZ- this only works for MAX_THREADS 2 right now
+          m_cur_thread = 1;
+        }
+      };
       
-      //Default to the first thread
-			m_cur_thread = 0;
-			if (probThread < parasiteVirulence)
-			{
-        //LZ- this only works for MAX_THREADS 2 right now
-				m_cur_thread = 1;
-			}
-		};
-		
-		//If we don't have a parasite, this will fix it. 
-    if (m_cur_thread >= m_threads.GetSize())
-		{
-			m_cur_thread = 0;			
-		}    
+      //If we don't have a parasite, this will fix it. 
+      if (m_cur_thread >= m_threads.GetSize())
+      {
+        m_cur_thread = 0;			
+      }    
+    }
     
     if(m_threads[m_cur_thread].skipExecution)
       m_cur_thread++;
@@ -323,7 +337,11 @@ bool cHardwareTransSMT::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Inst
   m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
 	
   // And execute it.
+  cInstProfiler::tTicks sample_start = 0;
+  const bool sampled = beginInstSample(sample_start);
+  const cInstSet* sample_inst_set = m_inst_set;
   const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  if (sampled) endInstSample(sample_inst_set, actual_inst.GetOp(), sample_start);
 	
   // decremenet if the instruction was not executed successfully
   if (exec_success == false) {
@@ -664,8 +682,12 @@ bool cHardwareTransSMT::InjectParasite(cAvidaContext& ctx, double mut_multiplier
 	m_organism->GetPhenotype().UpdateParasiteTasks();
   
   //If running in Analyze mode, reset the organisms last_task_count now so we know what the parasite did
-  if(m_world->GetConfig().INJECT_RESETS_TASKS.Get())
+  if(m_world->GetConfig().INJECT_RESETS_TASKS.Get()) {
+    cDeme* deme = m_organism->GetDeme();
+    if (deme) deme->RemoveOrgTotals(m_organism->GetPhenotype());
     m_organism->GetPhenotype().SetLastTaskCount(m_organism->GetPhenotype().GetCurTaskCount());
+    if (deme) deme->AddOrgTotals(m_organism->GetPhenotype());
+  }
   
   m_mem_array[mem_space_used].Resize(end_pos);
   cCPUMemory injected_code = m_mem_array[mem_space_used];
@@ -1038,12 +1060,8 @@ inline int cHardwareTransSMT::FindComplementStack(int base_stack)
 
 int cHardwareTransSMT::calcCopiedSize(const int, const int)
 {
-  int copied_size = 0;
   const cCPUMemory& memory = m_mem_array[m_cur_child];
-  for (int i = 0; i < memory.GetSize(); i++) {
-    if (memory.FlagCopied(i)) copied_size++;
-	}
-  return copied_size;
+  return memory.CountFlagCopied(0, memory.GetSize());
 }
 
 void cHardwareTransSMT::Inject_DoMutations(cAvidaContext& ctx, double mut_multiplier, cCPUMemory& injected_code)
@@ -1177,7 +1195,7 @@ bool cHardwareTransSMT::Divide_Main(cAvidaContext& ctx, double mut_multiplier)
   cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
   Genome offspring(GetType(), props, offspring_seq);
 
-  m_organism->OffspringGenome() = offspring;
+  m_organism->OffspringGenome().Adopt(offspring);
 	
   // Handle Divide Mutations...
   Divide_DoMutations(ctx, mut_multiplier);
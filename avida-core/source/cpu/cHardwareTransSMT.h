@@ -100,6 +100,13 @@ protected:
   Apto::Map<int, int> m_thread_lbls;
   int m_cur_thread;
   int m_cur_child;
+  
+  // Thread scheduling settings, read once from the config
+  bool m_slicing_parallel;      // THREAD_SLICING_METHOD == 1
+  bool m_host_virulence;        // VIRULENCE_SOURCE == 2
+  double m_parasite_virulence;  // PARASITE_VIRULENCE
+  int m_thread_quantum;
+  int m_quantum_left;           // time slices the current thread keeps before the next pick
 
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
   	
@@ -181,7 +188,7 @@ public:
   cHardwareTransSMT(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set);
   ~cHardwareTransSMT() { ; }
 
-  static cInstLib* GetInstLib() { return s_inst_slib; }
+  static tInstLib<cHardwareTransSMT::tMethod>* GetInstLib() { if (!s_inst_slib) s_inst_slib = initInstLib(); return s_inst_slib; }
   static cString GetDefaultInstFilename() { return "instset-transsmt.cfg"; }
 	
   bool SingleProcess(cAvidaContext& ctx, bool speculative = false);
@@ -0,0 +1,79 @@
+/*
+ *  cInstProfiler.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cInstProfiler.h"
+
+#include "cInstSet.h"
+
+
+cInstProfiler::~cInstProfiler()
+{
+  for (int i = 0; i < m_histograms.GetSize(); i++) delete m_histograms[i];
+}
+
+
+void cInstProfiler::Record(const cInstSet* inst_set, int op, tTicks ticks)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  sHistogram* hist = histogramFor(inst_set);
+  if (op >= hist->samples.GetSize()) {
+    const int old_size = hist->samples.GetSize();
+    hist->samples.Resize(op + 1);
+    hist->ticks.Resize(op + 1);
+    for (int i = old_size; i <= op; i++) {
+      hist->samples[i] = 0;
+      hist->ticks[i] = 0;
+    }
+  }
+  hist->samples[op]++;
+  hist->ticks[op] += ticks;
+}
+
+
+void cInstProfiler::TakeHistogram(const cInstSet* inst_set, Apto::Array<int>& samples, Apto::Array<tTicks>& ticks)
+{
+  const int num_insts = inst_set->GetSize();
+  samples.Resize(num_insts);
+  ticks.Resize(num_insts);
+  samples.SetAll(0);
+  ticks.SetAll(0);
+
+  Apto::MutexAutoLock lock(m_mutex);
+  sHistogram* hist = histogramFor(inst_set);
+  for (int i = 0; i < num_insts && i < hist->samples.GetSize(); i++) {
+    samples[i] = hist->samples[i];
+    ticks[i] = hist->ticks[i];
+  }
+  hist->samples.SetAll(0);
+  hist->ticks.SetAll(0);
+}
+
+
+cInstProfiler::sHistogram* cInstProfiler::histogramFor(const cInstSet* inst_set)
+{
+  // Only a handful of instruction sets are ever loaded, a linear search is cheaper than a map here
+  for (int i = 0; i < m_histograms.GetSize(); i++) if (m_histograms[i]->inst_set == inst_set) return m_histograms[i];
+
+  sHistogram* hist = new sHistogram;
+  hist->inst_set = inst_set;
+  m_histograms.Push(hist);
+  return hist;
+}
@@ -0,0 +1,94 @@
+/*
+ *  cInstProfiler.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cInstProfiler_h
+#define cInstProfiler_h
+
+#include "apto/platform.h"
+#include "apto/core/Array.h"
+#include "apto/core/Mutex.h"
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <sys/time.h>
+#endif
+#include <ctime>
+
+class cInstSet;
+
+
+// cInstProfiler collects a histogram of instruction execution cost, per instruction set and opcode.  Hardware samples
+// roughly one in every INST_PROFILE_INTERVAL executed instructions, timing the handler with the CPU time stamp
+// counter where available.  The histograms are drained by the PrintInstProfileData action.  The hardware manager owns
+// a profiler only when INST_PROFILE_INTERVAL is set.
+
+class cInstProfiler
+{
+public:
+  typedef unsigned long long tTicks;
+
+private:
+  struct sHistogram
+  {
+    const cInstSet* inst_set;
+    Apto::Array<int, Apto::Smart> samples;
+    Apto::Array<tTicks, Apto::Smart> ticks;
+  };
+
+  const int m_interval;
+  Apto::Mutex m_mutex;
+  Apto::Array<sHistogram*> m_histograms;
+
+  cInstProfiler(); // @not_implemented
+  cInstProfiler(const cInstProfiler&); // @not_implemented
+  cInstProfiler& operator=(const cInstProfiler&); // @not_implemented
+
+public:
+  cInstProfiler(int interval) : m_interval(interval) { ; }
+  ~cInstProfiler();
+
+  int GetInterval() const { return m_interval; }
+
+  static inline tTicks Ticks();
+
+  void Record(const cInstSet* inst_set, int op, tTicks ticks);
+
+  // Copy out the samples collected for inst_set since the last call, and clear them
+  void TakeHistogram(const cInstSet* inst_set, Apto::Array<int>& samples, Apto::Array<tTicks>& ticks);
+
+private:
+  sHistogram* histogramFor(const cInstSet* inst_set);
+};
+
+
+inline cInstProfiler::tTicks cInstProfiler::Ticks()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  return __builtin_ia32_rdtsc();
+#elif APTO_PLATFORM(WINDOWS)
+  return clock();
+#else
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return (tTicks)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+#endif
@@ -43,6 +43,8 @@ cInstSet::cInstSet(const cInstSet& _in)
   , m_hw_type(_in.m_hw_type)
   , m_inst_lib(_in.m_inst_lib)
   , m_lib_name_map(_in.m_lib_name_map)
+  , m_lib_nopmod_map(_in.m_lib_nopmod_map)
+  , m_name_lookup(_in.m_name_lookup)
   , m_mutation_index(NULL)
   , m_has_costs(_in.m_has_costs)
   , m_has_ft_costs(_in.m_has_ft_costs)
@@ -64,6 +66,8 @@ cInstSet& cInstSet::operator=(const cInstSet& _in)
   m_hw_type = _in.m_hw_type;
   m_inst_lib = _in.m_inst_lib;
   m_lib_name_map = _in.m_lib_name_map;
+  m_lib_nopmod_map = _in.m_lib_nopmod_map;
+  m_name_lookup = _in.m_name_lookup;
   m_mutation_index = NULL;
   m_has_costs = _in.m_has_costs;
   m_has_ft_costs = _in.m_has_ft_costs;
@@ -82,9 +86,7 @@ cInstSet& cInstSet::operator=(const cInstSet& _in)
 
 Instruction cInstSet::GetRandomInst(cAvidaContext& ctx) const
 {
-  double weight = ctx.GetRandom().GetDouble(m_mutation_index->GetTotalWeight());
-  unsigned inst_ndx = m_mutation_index->FindPosition(weight);
-  return Instruction(inst_ndx);
+  return Instruction(m_mutation_index->FindAliasPosition(ctx.GetRandom().GetDouble()));
 }
 
 
@@ -104,6 +106,8 @@ Instruction cInstSet::ActivateNullInst()
   m_lib_name_map.Resize(inst_id + 1);
   
   // Setup the new function...
+  m_lib_name_map[inst_id].nop_mod = -1;
+  m_lib_name_map[inst_id].flags = (*m_inst_lib)[null_fun_id].GetFlags();
   m_lib_name_map[inst_id].lib_fun_id = null_fun_id;
   m_lib_name_map[inst_id].redundancy = 0;
   m_lib_name_map[inst_id].cost = 0;
@@ -116,6 +120,9 @@ Instruction cInstSet::ActivateNullInst()
   m_lib_name_map[inst_id].post_cost = 0;
   m_lib_name_map[inst_id].bonus_cost = 0.0;
   
+  const Apto::String null_name((const char*)m_inst_lib->GetName(null_fun_id));
+  if (!m_name_lookup.Has(null_name)) m_name_lookup.Set(null_name, inst_id);
+  
   return Instruction(inst_id);
 }
 
@@ -227,6 +234,8 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
     m_lib_name_map.Resize(inst_id + 1);
     
     // Setup the new function...
+    m_lib_name_map[inst_id].nop_mod = -1;
+    m_lib_name_map[inst_id].flags = (*m_inst_lib)[fun_id].GetFlags();
     m_lib_name_map[inst_id].lib_fun_id = fun_id;
     m_lib_name_map[inst_id].redundancy = redundancy;
     m_lib_name_map[inst_id].cost = args->GetInt(0);
@@ -241,6 +250,9 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
     m_lib_name_map[inst_id].post_cost = args->GetInt(6);
     m_lib_name_map[inst_id].bonus_cost = args->GetDouble(4);
     
+    const Apto::String lookup_name((const char*)m_inst_lib->GetName(fun_id));
+    if (!m_name_lookup.Has(lookup_name)) m_name_lookup.Set(lookup_name, inst_id);
+    
     if (m_lib_name_map[inst_id].cost > 1) m_has_costs = true;
     if (m_lib_name_map[inst_id].ft_cost) m_has_ft_costs = true;
     if (m_lib_name_map[inst_id].energy_cost) m_has_energy_costs = true;
@@ -292,6 +304,7 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
 
       m_lib_nopmod_map.Resize(inst_id + 1);
       m_lib_nopmod_map[inst_id] = fun_id;
+      m_lib_name_map[inst_id].nop_mod = m_inst_lib->GetNopMod(fun_id);
     }
     
     // Clean up the argument container for this instruction
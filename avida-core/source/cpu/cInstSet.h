@@ -57,14 +57,17 @@ public:
   int m_hw_type;
   cInstLib* m_inst_lib;
   
+  // Fields read for nearly every executed or searched site lead the entry, so an opcode's lookup stays in one cache line
   struct sInstEntry {
+    int nop_mod;              // nop modifier, -1 for instructions that are not nops
+    unsigned int flags;       // nInstFlag bits of the library function, copied here to avoid the library lookup
     int lib_fun_id;
-    int redundancy;           // Weight in instruction set (not impl.)
     int cost;                 // additional time spent to exectute inst within the thread that executed the instruction
     int ft_cost;              // time spent first time exec (in add to cost)
-    int energy_cost;          // energy required to execute.
     double prob_fail;         // probability of failing to execute inst
     int addl_time_cost;       // additional time added to age for executing instruction
+    int redundancy;           // Weight in instruction set (not impl.)
+    int energy_cost;          // energy required to execute.
     int inst_code;            // instruction binary code
     double res_cost;          // resources (from bins) required to execute inst
     double fem_res_cost;      
@@ -77,6 +80,8 @@ public:
   
   Apto::Array<int> m_lib_nopmod_map;
   
+  Apto::Map<Apto::String, int> m_name_lookup;  // instruction name to the first opcode using it, for genome loading
+  
   cOrderedWeightedIndex* m_mutation_index;     // Weighted index for instructions 
   
   bool m_has_costs;
@@ -127,11 +132,7 @@ public:
   
   int GetLibFunctionIndex(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].lib_fun_id; }
 
-  int GetNopMod(const Instruction& inst) const
-  {
-    int nopmod = m_lib_nopmod_map[inst.GetOp()];
-    return m_inst_lib->GetNopMod(nopmod);
-  }
+  int GetNopMod(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].nop_mod; }
 
   Instruction GetRandomInst(cAvidaContext& ctx) const;
   int GetRandFunctionIndex(cAvidaContext& ctx) const { return m_lib_name_map[ GetRandomInst(ctx).GetOp() ].lib_fun_id; }
@@ -154,14 +155,14 @@ public:
   
   // Instruction Analysis.
   int IsNop(const Instruction& inst) const { return (inst.GetOp() < m_lib_nopmod_map.GetSize()); }
-  bool IsLabel(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsLabel(); }
-  bool IsPromoter(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsPromoter(); }
-  bool IsTerminator(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsTerminator(); }
-  bool ShouldStall(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).ShouldStall(); }
-  bool ShouldSleep(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).ShouldSleep(); }
-  bool IsImmediateValue(const Instruction& inst) const { return (inst != GetInstError() && m_inst_lib->Get(GetLibFunctionIndex(inst)).IsImmediateValue()); }
+  bool IsLabel(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::LABEL) != 0; }
+  bool IsPromoter(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::PROMOTER) != 0; }
+  bool IsTerminator(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::TERMINATOR) != 0; }
+  bool ShouldStall(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::STALL) != 0; }
+  bool ShouldSleep(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::SLEEP) != 0; }
+  bool IsImmediateValue(const Instruction& inst) const { return (inst != GetInstError() && (GetFlags(inst) & nInstFlag::IMMEDIATE_VALUE)); }
   
-  unsigned int GetFlags(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).GetFlags(); }
+  unsigned int GetFlags(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].flags; }
   
 
   // Insertion of new instructions...
@@ -176,6 +177,7 @@ public:
   const cInstLib* GetInstLib() const { return m_inst_lib; }
 
   inline Instruction GetInst(const cString& in_name) const;
+  inline bool FindInst(const char* name, Instruction& inst) const;
   cString FindBestMatch(const cString& in_name) const;
   bool InstInSet(const cString& in_name) const;
 
@@ -190,11 +192,8 @@ public:
 
 inline Instruction cInstSet::GetInst(const cString & in_name) const
 {
-  for (int i = 0; i < m_lib_name_map.GetSize(); i++) {
-    if (m_inst_lib->GetName(m_lib_name_map[i].lib_fun_id) == in_name) {
-      return Instruction(i);
-    }
-  }
+  Instruction inst;
+  if (FindInst((const char*)in_name, inst)) return inst;
 
   // @CAO Hacking this to make sure we don't have defaults...
   cerr << "Error: Unknown instruction '" << in_name << "'.  Exiting..." << endl;
@@ -205,4 +204,12 @@ inline Instruction cInstSet::GetInst(const cString & in_name) const
   return Instruction(255);
 }
 
+inline bool cInstSet::FindInst(const char* name, Instruction& inst) const
+{
+  int op = 0;
+  if (!m_name_lookup.Get(name, op)) return false;
+  inst = Instruction(op);
+  return true;
+}
+
 #endif
@@ -28,8 +28,10 @@
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
+#include "cHardwareCPULockstep.h"
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
+#include "cHeadCPU.h"
 #include "cInstSet.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
@@ -54,6 +56,7 @@ cTestCPU::cTestCPU(cAvidaContext& ctx, cWorld* world)
 	m_use_manual_inputs = false;
   m_test_solo_res = -1;
   m_test_solo_res_lev = 0;
+  m_batch_resources = false;
   InitResources(ctx);
 }  
 
@@ -140,11 +143,10 @@ void cTestCPU::ModifyResources(cAvidaContext& ctx, const Apto::Array<double>& re
 }
 
 
-// NOTE: This method assumes that the organism is a fresh creation.
-bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth)
+// Sets up inputs, resources and site recording for the gestation of the organism at cur_depth, returning the time
+// allocated to it.
+int cTestCPU::prepareGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth, Apto::Array<int>*& site_exec)
 {
-  assert(test_info.org_array[cur_depth] != NULL);
-
   cOrganism & organism = *( test_info.org_array[cur_depth] );
 
   // Determine how long this organism should be tested for...
@@ -158,15 +160,48 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
   cur_receive = 0;
 
   // Prepare the resources
-  InitResources(ctx, test_info.m_res_method, test_info.m_res, test_info.m_res_update, test_info.m_res_cpu_cycle_offset);
+  if (!m_batch_resources) {
+    InitResources(ctx, test_info.m_res_method, test_info.m_res, test_info.m_res_update, test_info.m_res_cpu_cycle_offset);
+  }
 	
 	
+  // Record the first execution of each site of the tested genome, when requested.  Mutational scans can use this to
+  // tell which sites the parent's gestation depends on.
+  site_exec = NULL;
+  if (cur_depth == 0 && test_info.m_record_site_exec) {
+    site_exec = &test_info.m_site_first_exec;
+    site_exec->Resize(seq->GetSize());
+    site_exec->SetAll(-1);
+  }
+  
+  return time_allocated;
+}
+
+
+// NOTE: This method assumes that the organism is a fresh creation.
+bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth)
+{
+  assert(test_info.org_array[cur_depth] != NULL);
+
+  cOrganism & organism = *( test_info.org_array[cur_depth] );
+
+  Apto::Array<int>* site_exec = NULL;
+  const int time_allocated = prepareGestation(ctx, test_info, cur_depth, site_exec);
+  
   // This way of keeping track of time is only used to update resources...
   int time_used = m_res_cpu_cycle_offset; // Note: the offset is zero by default if no resources being used @JEB
   
   organism.GetHardware().SetTrace(test_info.GetTracer());
   while (time_used < time_allocated && organism.GetPhenotype().GetNumDivides() == 0 && !organism.IsDead())
   {
+    if (site_exec) {
+      const cHeadCPU& ip = organism.GetHardware().GetHead(nHardware::HEAD_IP);
+      const int pos = ip.GetPosition();
+      if (ip.GetMemSpace() == 0 && pos >= 0 && pos < site_exec->GetSize() && (*site_exec)[pos] == -1) {
+        (*site_exec)[pos] = time_used;
+      }
+    }
+    
     time_used++;
     
     // @CAO Need to watch out for parasites.
@@ -230,7 +265,127 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
+bool cTestCPU::TestGenomeCached(cAvidaContext& ctx, const Genome& genome, cTestCPUCache::sTestResult& result)
+{
+  cTestCPUCache& cache = m_world->GetHardwareManager().GetTestCPUCache();
+  
+  // The genome string carries the instruction set; the remaining inputs to a default test are the environment and the
+  // time allotted to the test
+  Apto::String key;
+  if (cache.IsEnabled()) {
+    key = genome.AsString() + Apto::FormatStr("|%d|%d", m_world->GetEnvironment().GetVersion(),
+                                              m_world->GetConfig().TEST_CPU_TIME_MOD.Get());
+    if (cache.Get(key, result)) return result.is_viable;
+  }
+  
+  cCPUTestInfo test_info;
+  TestGenome(ctx, test_info, genome);
+  
+  cPhenotype& phenotype = test_info.GetTestPhenotype();
+  result.is_viable = test_info.IsViable();
+  result.fitness = test_info.GetGenotypeFitness();
+  result.colony_fitness = test_info.GetColonyFitness();
+  result.merit = phenotype.GetMerit().GetDouble();
+  result.copied_size = phenotype.GetCopiedSize();
+  result.executed_size = phenotype.GetExecutedSize();
+  result.gestation_time = phenotype.GetGestationTime();
+  result.task_counts = phenotype.GetLastTaskCount();
+  
+  if (cache.IsEnabled()) cache.Set(key, result);
+  
+  return result.is_viable;
+}
+
+void cTestCPU::TestGenomes(cAvidaContext& ctx, cCPUTestInfo& test_info, const Apto::Array<Genome>& genomes,
+                          sBatchResults& results)
+{
+  results.Resize(genomes.GetSize());
+  
+  // Resources that are neither depleted nor follow the update schedule never change during a test, so they only need
+  // to be set up once for the whole batch
+  if (test_info.m_res_method < RES_UPDATED_DEPLETABLE) {
+    InitResources(ctx, test_info.m_res_method, test_info.m_res, test_info.m_res_update, test_info.m_res_cpu_cycle_offset);
+    m_batch_resources = true;
+  }
+  
+  // Lockstep runs interleave the tests of a chunk, which needs resources that stay put; traces and random inputs are
+  // kept to one test at a time so that they still follow test order
+  const int lockstep = m_world->GetConfig().TEST_CPU_LOCKSTEP.Get();
+  if (lockstep > 1 && m_batch_resources && !test_info.GetTracer() && !test_info.GetUseRandomInputs()) {
+    testGenomesLockstep(ctx, test_info, genomes, results, lockstep);
+  } else {
+    for (int i = 0; i < genomes.GetSize(); i++) {
+      TestGenome(ctx, test_info, genomes[i]);
+      recordBatchResult(test_info, results, i);
+    }
+  }
+  
+  m_batch_resources = false;
+}
+
+void cTestCPU::recordBatchResult(cCPUTestInfo& test_info, sBatchResults& results, int i)
+{
+  cPhenotype& phenotype = test_info.GetTestPhenotype();
+  results.is_viable[i] = test_info.IsViable();
+  results.fitness[i] = test_info.GetGenotypeFitness();
+  results.colony_fitness[i] = test_info.GetColonyFitness();
+  results.merit[i] = phenotype.GetMerit().GetDouble();
+  results.gestation_time[i] = phenotype.GetGestationTime();
+  results.copied_size[i] = phenotype.GetCopiedSize();
+  results.executed_size[i] = phenotype.GetExecutedSize();
+  if (results.is_viable[i]) results.task_counts[i] = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+  else results.task_counts[i].Resize(0);
+}
+
+// Runs the first gestation of chunk_size genomes at a time side by side in a cHardwareCPULockstep; offspring tests and
+// genomes the engine does not take run one at a time as usual.
+void cTestCPU::testGenomesLockstep(cAvidaContext& ctx, cCPUTestInfo& test_info, const Apto::Array<Genome>& genomes,
+                                   sBatchResults& results, int chunk_size)
+{
+  test_info.Clear();
+  
+  for (int start = 0; start < genomes.GetSize(); start += chunk_size) {
+    const int num_lanes = Apto::Min(chunk_size, genomes.GetSize() - start);
+    Apto::Array<cCPUTestInfo*> lane_info(num_lanes);
+    cHardwareCPULockstep engine(m_world, this);
+    
+    ctx.SetTestMode();
+    for (int i = 0; i < num_lanes; i++) {
+      lane_info[i] = new cCPUTestInfo(test_info);
+      lane_info[i]->org_array.SetAll(NULL);
+      lane_info[i]->m_res = test_info.m_res;
+      
+      setupTest(ctx, *lane_info[i], genomes[start + i], 0);
+      Apto::Array<int>* site_exec = NULL;
+      const int time_allocated = prepareGestation(ctx, *lane_info[i], 0, site_exec);
+      if (!engine.AddLane(lane_info[i]->org_array[0], m_res_cpu_cycle_offset, time_allocated, site_exec)) {
+        ProcessGestation(ctx, *lane_info[i], 0);
+      }
+    }
+    
+    engine.Run(ctx);
+    
+    for (int i = 0; i < num_lanes; i++) {
+      finishTest(ctx, *lane_info[i], 0);
+      recordBatchResult(*lane_info[i], results, start + i);
+      delete lane_info[i];
+    }
+    ctx.ClearTestMode();
+  }
+}
+
 bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
+{
+  setupTest(ctx, test_info, genome, cur_depth);
+
+  // Run the current organism.
+  ProcessGestation(ctx, test_info, cur_depth);
+
+  return finishTest(ctx, test_info, cur_depth);
+}
+
+// Builds the organism for cur_depth and the inputs it will see
+void cTestCPU::setupTest(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
 
@@ -270,10 +425,12 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(genome.Representation());
   organism->GetPhenotype().SetupInject(*seq);
+}
 
-  // Run the current organism.
-  ProcessGestation(ctx, test_info, cur_depth);
-
+// Classifies the finished gestation at cur_depth, testing the offspring when that is what decides viability
+bool cTestCPU::finishTest(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth)
+{
+  cOrganism* organism = test_info.org_array[cur_depth];
   
   // Notify the organism that it has died to allow for various cleanup methods to run
   organism->NotifyDeath(ctx);
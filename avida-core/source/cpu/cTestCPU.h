@@ -28,6 +28,7 @@
 #include "cString.h"
 #include "cResourceCount.h"
 #include "cCPUTestInfo.h"
+#include "cTestCPUCache.h"
 #include "cWorld.h"
 
 
@@ -42,7 +43,32 @@ using namespace Avida;
 
 class cTestCPU
 {
+  friend class cHardwareCPULockstep;
 public:
+  // Columnar summary of a batch of genome tests, one entry per genome
+  struct sBatchResults
+  {
+    Apto::Array<bool> is_viable;
+    Apto::Array<double> fitness;
+    Apto::Array<double> colony_fitness;
+    Apto::Array<double> merit;
+    Apto::Array<int> gestation_time;
+    Apto::Array<int> copied_size;
+    Apto::Array<int> executed_size;
+    Apto::Array<Apto::Array<int> > task_counts;  // last task counts of the colony organism, empty if not viable
+    
+    void Resize(int num)
+    {
+      is_viable.Resize(num);
+      fitness.Resize(num);
+      colony_fitness.Resize(num);
+      merit.Resize(num);
+      gestation_time.Resize(num);
+      copied_size.Resize(num);
+      executed_size.Resize(num);
+      task_counts.Resize(num);
+    }
+  };
 
 private:
   cWorld* m_world;
@@ -66,10 +92,18 @@ private:
   cResourceCount m_faced_cell_resource_count;
   cResourceCount m_deme_resource_count;
   cResourceCount m_cell_resource_count;
+  
+  bool m_batch_resources; // Resources were initialized once for the current batch and stay fixed across its tests
     
 
+  int prepareGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth, Apto::Array<int>*& site_exec);
   bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
   bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  void setupTest(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  bool finishTest(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
+  void testGenomesLockstep(cAvidaContext& ctx, cCPUTestInfo& test_info, const Apto::Array<Genome>& genomes,
+                           sBatchResults& results, int chunk_size);
+  void recordBatchResult(cCPUTestInfo& test_info, sBatchResults& results, int i);
 
   
   cTestCPU(); // @not_implemented
@@ -90,6 +124,12 @@ public:
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ofstream& out_fp);
   
+  // Summary results of a default test of the genome, memoized in the hardware manager's test CPU cache
+  bool TestGenomeCached(cAvidaContext& ctx, const Genome& genome, cTestCPUCache::sTestResult& result);
+  
+  // Test many genomes sharing test_info's settings, reusing the resource setup across the batch where it is static
+  void TestGenomes(cAvidaContext& ctx, cCPUTestInfo& test_info, const Apto::Array<Genome>& genomes, sBatchResults& results);
+  
   void PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
 
   inline int GetInput();
@@ -0,0 +1,114 @@
+/*
+ *  cTestCPUCache.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+
+#include "cTestCPUCache.h"
+
+
+cTestCPUCache::cTestCPUCache(int max_entries)
+  : m_shard_capacity((max_entries > 0) ? Apto::Max(1, max_entries / NUM_SHARDS) : 0)
+{
+}
+
+
+inline cTestCPUCache::sShard& cTestCPUCache::shardOf(const Apto::String& key)
+{
+  unsigned int hash = 2166136261u;
+  for (int i = 0; i < key.GetSize(); i++) {
+    hash ^= (unsigned char)key[i];
+    hash *= 16777619u;
+  }
+  return m_shards[hash % NUM_SHARDS];
+}
+
+
+bool cTestCPUCache::Get(const Apto::String& key, sTestResult& result)
+{
+  if (!IsEnabled()) return false;
+  
+  sShard& shard = shardOf(key);
+  Apto::MutexAutoLock lock(shard.mutex);
+  if (shard.entries.Get(key, result)) {
+    shard.hits++;
+    return true;
+  }
+  shard.misses++;
+  return false;
+}
+
+
+void cTestCPUCache::Set(const Apto::String& key, const sTestResult& result)
+{
+  if (!IsEnabled()) return;
+  
+  sShard& shard = shardOf(key);
+  Apto::MutexAutoLock lock(shard.mutex);
+  if (shard.entries.GetSize() >= m_shard_capacity && !shard.entries.Has(key)) shard.entries.Clear();
+  shard.entries.Set(key, result);
+}
+
+
+void cTestCPUCache::Clear()
+{
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    Apto::MutexAutoLock lock(m_shards[i].mutex);
+    m_shards[i].entries.Clear();
+  }
+}
+
+
+int cTestCPUCache::GetHits() const
+{
+  int hits = 0;
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    Apto::MutexAutoLock lock(m_shards[i].mutex);
+    hits += m_shards[i].hits;
+  }
+  return hits;
+}
+
+
+int cTestCPUCache::GetMisses() const
+{
+  int misses = 0;
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    Apto::MutexAutoLock lock(m_shards[i].mutex);
+    misses += m_shards[i].misses;
+  }
+  return misses;
+}
+
+
+double cTestCPUCache::GetHitRate() const
+{
+  const int hits = GetHits();
+  const int total = hits + GetMisses();
+  return (total) ? (double)hits / (double)total : 0.0;
+}
+
+
+int cTestCPUCache::GetNumEntries() const
+{
+  int entries = 0;
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    Apto::MutexAutoLock lock(m_shards[i].mutex);
+    entries += m_shards[i].entries.GetSize();
+  }
+  return entries;
+}
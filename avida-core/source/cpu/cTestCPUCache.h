@@ -0,0 +1,91 @@
+/*
+ *  cTestCPUCache.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+
+#ifndef cTestCPUCache_h
+#define cTestCPUCache_h
+
+#include "apto/core.h"
+#include "apto/core/Mutex.h"
+
+
+// cTestCPUCache memoizes the summary results of test CPU evaluations.  Entries are keyed by the full genome string
+// (which names the instruction set) combined with a fingerprint of everything else the result depends on: the
+// environment version and the test settings.  The cache is split into independently locked shards so that concurrent
+// analyze threads rarely contend; a shard that reaches its share of the configured capacity is flushed.
+
+class cTestCPUCache
+{
+public:
+  struct sTestResult
+  {
+    bool is_viable;
+    double fitness;
+    double colony_fitness;
+    double merit;
+    int copied_size;
+    int executed_size;
+    int gestation_time;
+    Apto::Array<int> task_counts;
+    
+    sTestResult() : is_viable(false), fitness(0.0), colony_fitness(0.0), merit(0.0), copied_size(0), executed_size(0),
+      gestation_time(0) { ; }
+  };
+  
+  static const int NUM_SHARDS = 16;
+  
+private:
+  struct sShard
+  {
+    mutable Apto::Mutex mutex;
+    Apto::Map<Apto::String, sTestResult> entries;
+    int hits;
+    int misses;
+    
+    sShard() : hits(0), misses(0) { ; }
+  };
+  
+  sShard m_shards[NUM_SHARDS];
+  int m_shard_capacity;
+  
+  
+  cTestCPUCache(); // @not_implemented
+  cTestCPUCache(const cTestCPUCache&); // @not_implemented
+  cTestCPUCache& operator=(const cTestCPUCache&); // @not_implemented
+  
+public:
+  cTestCPUCache(int max_entries);
+  ~cTestCPUCache() { ; }
+  
+  bool IsEnabled() const { return m_shard_capacity > 0; }
+  
+  bool Get(const Apto::String& key, sTestResult& result);
+  void Set(const Apto::String& key, const sTestResult& result);
+  void Clear();
+  
+  int GetHits() const;
+  int GetMisses() const;
+  double GetHitRate() const;
+  int GetNumEntries() const;
+  
+private:
+  inline sShard& shardOf(const Apto::String& key);
+};
+
+#endif
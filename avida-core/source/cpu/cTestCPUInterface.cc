@@ -170,10 +170,9 @@ Apto::Array<cOrganism*> cTestCPUInterface::GetCellAVs(int cell_id, int av_num)
   return null_array;
 }
 
-Apto::Array<cOrganism*> cTestCPUInterface::GetFacedPreyAVs(int av_num)
+const Apto::Array<cOrganism*, Apto::Smart>& cTestCPUInterface::GetFacedPreyAVs(int av_num)
 {
-  Apto::Array<cOrganism*> null_array;
-  null_array.SetAll(NULL);
+  static const Apto::Array<cOrganism*, Apto::Smart> null_array;
   return null_array;
 }
 
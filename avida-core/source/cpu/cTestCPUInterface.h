@@ -221,6 +221,7 @@ public:
   void IncNumPreyOrganisms() { ; }
   void IncNumPredOrganisms() { ; }
   void IncNumTopPredOrganisms() { ; }
+  void ForageTargetChanged() { ; }
   void AttackFacedOrg(cAvidaContext& ctx, int) { ; }
   void TryWriteBirthLocData(int) { ; }
   void InjectPreyClone(cAvidaContext& ctx, int gen_id) { ; }
@@ -264,7 +265,7 @@ public:
   cOrganism* GetRandFacedPreyAV(int av_num = 0) { return NULL; }
   Apto::Array<cOrganism*> GetFacedAVs(int av_num = 0);
   Apto::Array<cOrganism*> GetCellAVs(int cell_id, int av_num = 0);
-  Apto::Array<cOrganism*> GetFacedPreyAVs(int av_num = 0);
+  const Apto::Array<cOrganism*, Apto::Smart>& GetFacedPreyAVs(int av_num = 0);
   const Apto::Array<double>& GetAVResources(cAvidaContext& ctx, int av_num = 0);
   double GetAVResourceVal(cAvidaContext& ctx, int res_id, int av_num = 0);
   const Apto::Array<double>& GetAVFacedResources(cAvidaContext& ctx, int av_num = 0);
@@ -29,7 +29,182 @@
 #include "avida/data/Provider.h"
 #include "avida/data/Recorder.h"
 
+#include "apto/core/Thread.h"
+
 #include <cassert>
+#include <ctime>
+
+
+// Each data ID requested by an attached recorder is resolved once, when the snapshot is built, to a handle indexing
+// slots (and the per update value array built alongside it)
+class Avida::Data::Manager::Snapshot : public Apto::RefCountObject<Apto::ThreadSafe>
+{
+public:
+  struct ValueSlot
+  {
+    DataID data_id;
+    ProviderPtr provider;
+    ArgumentedProviderPtr arg_provider;
+    DataID raw_id;
+    Argument argument;
+  };
+  
+  struct RecorderEntry
+  {
+    RecorderPtr recorder;
+    Apto::Array<int> handles;
+  };
+  
+  Apto::Array<ProviderPtr> providers;
+  Apto::Array<ValueSlot> slots;
+  Apto::Map<DataID, int> handles;
+  Apto::Array<RecorderEntry> recorders;
+};
+
+
+// Retrieval functor target handed to a single recorder.  The requested values are matched against the recorder's own
+// handles by plain comparison, starting after the last match since recorders tend to retrieve in a stable order.
+// Without a manager the view only answers from values captured beforehand, and never touches a provider.
+class Avida::Data::Manager::RecorderView
+{
+private:
+  const Manager* m_mgr;
+  const Snapshot& m_snapshot;
+  Apto::Array<PackagePtr>& m_values;
+  const Apto::Array<int>& m_handles;
+  mutable int m_next;
+  
+public:
+  RecorderView(const Manager* mgr, const Snapshot& snapshot, Apto::Array<PackagePtr>& values,
+               const Apto::Array<int>& handles)
+    : m_mgr(mgr), m_snapshot(snapshot), m_values(values), m_handles(handles), m_next(0) { ; }
+  
+  PackagePtr Retrieve(const DataID& data_id) const
+  {
+    const int num_handles = m_handles.GetSize();
+    for (int n = 0; n < num_handles; n++) {
+      const int idx = (m_next + n) % num_handles;
+      const int handle = m_handles[idx];
+      if (m_snapshot.slots[handle].data_id == data_id) {
+        m_next = idx + 1;
+        return valueOf(handle);
+      }
+    }
+    
+    // Not one of the recorder's requests, fall back to the general lookup
+    return (m_mgr) ? m_mgr->GetCurrentValue(data_id) : PackagePtr();
+  }
+  
+private:
+  PackagePtr valueOf(int handle) const
+  {
+    // Values are retrieved from their provider at most once per update, on first use
+    if (!m_values[handle] && m_mgr) {
+      const Snapshot::ValueSlot& slot = m_snapshot.slots[handle];
+      if (slot.arg_provider) m_values[handle] = slot.arg_provider->GetProvidedValueForArgument(slot.raw_id, slot.argument);
+      else m_values[handle] = slot.provider->GetProvidedValue(slot.data_id);
+    }
+    return m_values[handle];
+  }
+};
+
+
+// Helper thread that notifies the recorders of a captured update while the updating thread moves on to the next one.
+// At most one update is in flight: Submit waits for the previous notification to finish before handing over the next.
+class Avida::Data::Manager::RecordingPipeline
+{
+private:
+  class Worker : public Apto::Thread
+  {
+  private:
+    RecordingPipeline* m_pipeline;
+    
+    void Run() { m_pipeline->work(); }
+    
+  public:
+    Worker(RecordingPipeline* pipeline) : m_pipeline(pipeline) { ; }
+  };
+  
+  Worker* m_worker;
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_done_cond;
+  
+  SnapshotPtr m_snapshot;
+  Apto::Array<PackagePtr> m_values;
+  Update m_update;
+  bool m_pending;
+  bool m_terminate;
+  
+  
+  void work()
+  {
+    while (true) {
+      m_mutex.Lock();
+      while (!m_pending && !m_terminate) m_cond.Wait(m_mutex);
+      if (!m_pending) {
+        m_mutex.Unlock();
+        break;
+      }
+      m_mutex.Unlock();
+      
+      for (int i = 0; i < m_snapshot->recorders.GetSize(); i++) {
+        const Snapshot::RecorderEntry& entry = m_snapshot->recorders[i];
+        RecorderView view(NULL, *m_snapshot, m_values, entry.handles);
+        DataRetrievalFunctor drf(&view, &RecorderView::Retrieve);
+        entry.recorder->NotifyData(m_update, drf);
+      }
+      
+      m_mutex.Lock();
+      m_snapshot = SnapshotPtr();
+      m_values.Resize(0);
+      m_pending = false;
+      m_mutex.Unlock();
+      m_done_cond.Broadcast();
+    }
+  }
+  
+public:
+  RecordingPipeline() : m_update(0), m_pending(false), m_terminate(false)
+  {
+    m_worker = new Worker(this);
+    m_worker->Start();
+  }
+  
+  ~RecordingPipeline()
+  {
+    // The worker finishes any notification still in flight before it exits
+    m_mutex.Lock();
+    m_terminate = true;
+    m_mutex.Unlock();
+    m_cond.Signal();
+    
+    m_worker->Join();
+    delete m_worker;
+  }
+  
+  // Notify the recorders of snapshot with the captured values on the worker
+  void Submit(SnapshotPtr snapshot, const Apto::Array<PackagePtr>& values, Update current_update)
+  {
+    Wait();
+    m_mutex.Lock();
+    m_snapshot = snapshot;
+    m_values = values;
+    m_update = current_update;
+    m_pending = true;
+    m_mutex.Unlock();
+    m_cond.Signal();
+  }
+  
+  // Return once no notification is in flight
+  void Wait()
+  {
+    m_mutex.Lock();
+    while (m_pending) m_done_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  }
+};
 
 
 static Avida::WorldFacetPtr DeserializeDataManager(Avida::ArchivePtr)
@@ -42,20 +217,40 @@ bool Avida::Data::Manager::s_registered_with_facet_factory =
   Avida::WorldFacet::RegisterFacetType(Avida::Reserved::DataManagerFacetID, DeserializeDataManager);
 
 
-Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet)
+Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet), m_pipeline(NULL)
 {
   
 }
 
 Avida::Data::Manager::~Manager()
 {
+  delete m_pipeline;
+}
+
+
+void Avida::Data::Manager::SetPipelinedRecording(bool enabled)
+{
+  if (enabled && !m_pipeline) {
+    m_pipeline = new RecordingPipeline;
+  } else if (!enabled && m_pipeline) {
+    delete m_pipeline;
+    m_pipeline = NULL;
+  }
+}
+
+void Avida::Data::Manager::WaitForRecorders()
+{
+  if (m_pipeline) m_pipeline->Wait();
 }
 
 
 Avida::Data::ConstDataSetPtr Avida::Data::Manager::GetAvailable() const
 {
-  // @TODO - this should lock and return a copy
-  return m_available;
+  DataSetPtr available(new DataSet);
+  m_rwlock.ReadLock();
+  *available = *m_available;
+  m_rwlock.ReadUnlock();
+  return available;
 }
 
 bool Avida::Data::Manager::IsAvailable(const DataID& data_id) const
@@ -80,6 +275,40 @@ bool Avida::Data::Manager::IsActive(const DataID& data_id) const
   return is_available;
 }
 
+bool Avida::Data::Manager::IsRequested(const DataID& data_id) const
+{
+  m_rwlock.ReadLock();
+  bool is_requested = m_requested.Has(data_id);
+  m_rwlock.ReadUnlock();
+  return is_requested;
+}
+
+Avida::Data::ConstDataSetPtr Avida::Data::Manager::GetRequested() const
+{
+  DataSetPtr requested(new DataSet);
+  m_rwlock.ReadLock();
+  for (Apto::Map<DataID, int>::KeyIterator it = m_requested.Keys(); it.Next();) requested->Insert(*it.Get());
+  m_rwlock.ReadUnlock();
+  return requested;
+}
+
+double Avida::Data::Manager::ProviderUpdateCost(const DataID& data_id) const
+{
+  double cost = -1.0;
+  m_rwlock.ReadLock();
+  ProviderPtr provider;
+  if (m_active_provider_map.Get(data_id, provider)) {
+    for (int i = 0; i < m_active_providers.GetSize() && i < m_provider_update_count.GetSize(); i++) {
+      if (m_active_providers[i] == provider) {
+        if (m_provider_update_count[i] > 0) cost = m_provider_update_time[i] / m_provider_update_count[i];
+        break;
+      }
+    }
+  }
+  m_rwlock.ReadUnlock();
+  return cost;
+}
+
 
 Apto::String Avida::Data::Manager::Describe(const DataID& data_id) const
 {
@@ -295,6 +524,10 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     }
   }
   
+  for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+    m_requested[*it.Get()] = m_requested.GetWithDefault(*it.Get(), 0) + 1;
+  }
+  
   m_rwlock.WriteUnlock();
   
   
@@ -319,6 +552,8 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
   m_recorder_mutex.Lock();
   m_recorders.Insert(recorder);
   m_recorder_mutex.Unlock();
+  
+  publishSnapshot();
   return true;
 }
 
@@ -329,6 +564,20 @@ bool Avida::Data::Manager::DetachRecorder(RecorderPtr recorder)
   success = m_recorders.Remove(recorder);
   // @TODO - this should probably deactivate data providers that are no longer needed, or at least adjust schedule
   m_recorder_mutex.Unlock();
+  
+  if (success) {
+    ConstDataSetPtr requested = recorder->RequestedData();
+    m_rwlock.WriteLock();
+    for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+      int count = 0;
+      if (m_requested.Get(*it.Get(), count) && --count > 0) m_requested[*it.Get()] = count;
+      else m_requested.Remove(*it.Get());
+    }
+    m_rwlock.WriteUnlock();
+    
+    publishSnapshot();
+  }
+  
   return success;
 }
 
@@ -400,6 +649,67 @@ Avida::Data::ManagerPtr Avida::Data::Manager::Of(World* world)
 }
 
 
+void Avida::Data::Manager::publishSnapshot()
+{
+  // Held across the build so that concurrent publishers cannot replace a newer snapshot with an older one
+  Apto::MutexAutoLock snapshot_lock(m_snapshot_mutex);
+  
+  SnapshotPtr snapshot(new Snapshot);
+  
+  m_rwlock.ReadLock();
+  m_recorder_mutex.Lock();
+  
+  snapshot->providers = m_active_providers;
+  
+  snapshot->recorders.Resize(m_recorders.GetSize());
+  int rec_idx = 0;
+  for (Apto::Set<RecorderPtr>::Iterator it = m_recorders.Begin(); it.Next(); rec_idx++) {
+    Snapshot::RecorderEntry& entry = snapshot->recorders[rec_idx];
+    entry.recorder = *it.Get();
+    
+    ConstDataSetPtr requested = entry.recorder->RequestedData();
+    for (ConstDataSetIterator rit = requested->Begin(); rit.Next();) {
+      const DataID& data_id = *rit.Get();
+      
+      int handle = -1;
+      if (!snapshot->handles.Get(data_id, handle)) {
+        Snapshot::ValueSlot slot;
+        slot.data_id = data_id;
+        if (data_id.GetSize() && data_id[data_id.GetSize() - 1] == ']') {
+          int start_idx = -1;
+          for (int i = 0; i < data_id.GetSize(); i++) {
+            if (data_id[i] == '[') {
+              start_idx = i + 1;
+              break;
+            }
+          }
+          if (start_idx != -1) {
+            slot.argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
+            slot.raw_id = data_id.Substring(0, start_idx) + "]";
+            m_active_arg_provider_map.Get(slot.raw_id, slot.arg_provider);
+          }
+        } else {
+          m_active_provider_map.Get(data_id, slot.provider);
+        }
+        
+        // Unresolved values are left to the general lookup
+        if (!slot.provider && !slot.arg_provider) continue;
+        
+        handle = snapshot->slots.GetSize();
+        snapshot->slots.Push(slot);
+        snapshot->handles[data_id] = handle;
+      }
+      entry.handles.Push(handle);
+    }
+  }
+  
+  m_recorder_mutex.Unlock();
+  m_rwlock.ReadUnlock();
+  
+  m_snapshot = snapshot;
+}
+
+
 bool Avida::Data::Manager::Serialize(ArchivePtr) const
 {
   // @TODO
@@ -420,28 +730,53 @@ Avida::WorldFacetID Avida::Data::Manager::UpdateAfter() const
 
 void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 {
+  // The previous update's recorders may still be reading their captured values
+  WaitForRecorders();
+  
   m_current_value_mutex.Lock();
   m_current_values.Clear();
   m_current_value_mutex.Unlock();
   
-  m_rwlock.ReadLock();
+  // Recorders attached or detached while updating take effect with the next update's snapshot
+  m_snapshot_mutex.Lock();
+  SnapshotPtr snapshot = m_snapshot;
+  m_snapshot_mutex.Unlock();
+  if (!snapshot) return;
   
-  // Update all of the active providers
-  for (int i = 0; i < m_active_providers.GetSize(); i++) m_active_providers[i]->UpdateProvidedValues(current_update);
+  // Update all of the active providers, accumulating the processor time each one takes
+  const int num_providers = snapshot->providers.GetSize();
+  if (m_provider_update_time.GetSize() < num_providers) {
+    m_provider_update_time.Resize(num_providers, 0.0);
+    m_provider_update_count.Resize(num_providers, 0);
+  }
+  for (int i = 0; i < num_providers; i++) {
+    std::clock_t start = std::clock();
+    snapshot->providers[i]->UpdateProvidedValues(current_update);
+    m_provider_update_time[i] += double(std::clock() - start) / CLOCKS_PER_SEC;
+    m_provider_update_count[i]++;
+  }
   
   // Notify recorders that new data is available
-  DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
-
-  // Lock recorder mutex before releasing RWLock, so that only recorders that have values will be notified
-  m_recorder_mutex.Lock();
+  Apto::Array<PackagePtr> values(snapshot->slots.GetSize());
   
-  // Release RWLock before notification to prevent double RWLocking deadlock during recorder attachment
-  m_rwlock.ReadUnlock();
+  if (m_pipeline) {
+    // Capture every requested value now, while the providers still describe this update, then let the recorders run
+    // alongside the next update
+    for (int i = 0; i < snapshot->slots.GetSize(); i++) {
+      const Snapshot::ValueSlot& slot = snapshot->slots[i];
+      if (slot.arg_provider) values[i] = slot.arg_provider->GetProvidedValueForArgument(slot.raw_id, slot.argument);
+      else values[i] = slot.provider->GetProvidedValue(slot.data_id);
+    }
+    m_pipeline->Submit(snapshot, values, current_update);
+    return;
+  }
   
-  for (Apto::Set<RecorderPtr>::Iterator it = m_recorders.Begin(); it.Next();) {
-    (*it.Get())->NotifyData(current_update, drf);
+  for (int i = 0; i < snapshot->recorders.GetSize(); i++) {
+    const Snapshot::RecorderEntry& entry = snapshot->recorders[i];
+    RecorderView view(this, *snapshot, values, entry.handles);
+    DataRetrievalFunctor drf(&view, &RecorderView::Retrieve);
+    entry.recorder->NotifyData(current_update, drf);
   }
-  m_recorder_mutex.Unlock();
 }
 
 Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data_id) const
@@ -24,12 +24,15 @@
 
 #include "avida/data/Package.h"
 
+#include "avida/private/util/MemoryStats.h"
+
 #include <limits>
 
 // Data::Package
 // --------------------------------------------------------------------------------------------------------------
 
-Avida::Data::Package::~Package() { ; }
+Avida::Data::Package::Package() { Util::MemoryStats::Created(Util::MemoryStats::DATA_PACKAGES); }
+Avida::Data::Package::~Package() { Util::MemoryStats::Destroyed(Util::MemoryStats::DATA_PACKAGES); }
 
 bool Avida::Data::Package::IsAggregate() const { return false; }
 Apto::String Avida::Data::Package::GetAggregateDescriptor() const { return Apto::String(); }
@@ -0,0 +1,175 @@
+/*
+ *  data/RingTimeSeriesRecorder.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/data/RingTimeSeriesRecorder.h"
+
+#include "avida/data/Package.h"
+
+#include <cassert>
+
+
+void Avida::Data::RingTimeSeriesRecorder::Sample::Merge(const Sample& sample)
+{
+  if (!sample.count) return;
+
+  if (!count) {
+    *this = sample;
+    return;
+  }
+
+  if (sample.first_update < first_update) first_update = sample.first_update;
+  if (sample.last_update > last_update) last_update = sample.last_update;
+  if (sample.min < min) min = sample.min;
+  if (sample.max > max) max = sample.max;
+  sum += sample.sum;
+  count += sample.count;
+}
+
+
+Avida::Data::RingTimeSeriesRecorder::RingTimeSeriesRecorder(const DataID& data_id, int capacity, int num_tiers,
+                                                            int block_size)
+  : m_data_id(data_id), m_block_size(block_size)
+{
+  assert(capacity > 0 && num_tiers > 0 && block_size > 1);
+
+  DataSetPtr ds(new DataSet);
+  ds->Insert(m_data_id);
+  m_requested = ds;
+
+  m_tiers.Resize(num_tiers);
+  for (int i = 0; i < num_tiers; i++) m_tiers[i].ring.Resize(capacity);
+}
+
+
+void Avida::Data::RingTimeSeriesRecorder::NotifyData(Update current_update, DataRetrievalFunctor retrieve_data)
+{
+  if (!shouldRecordValue(current_update)) return;
+
+  PackagePtr value = retrieve_data(m_data_id);
+  if (!value) return;
+
+  Sample sample;
+  sample.first_update = current_update;
+  sample.last_update = current_update;
+  sample.min = sample.max = sample.sum = value->DoubleValue();
+  sample.count = 1;
+  addSample(sample);
+
+  didRecordValue();
+}
+
+
+int Avida::Data::RingTimeSeriesRecorder::Query(Update from, Update to, int max_points, Apto::Array<Sample>& samples) const
+{
+  samples.Resize(0);
+  if (to < from) return -1;
+
+  // Walk from the finest tier to the first that both reaches back to from and fits within max_points
+  int tier_idx = -1;
+  int begin = 0;
+  int end = 0;
+  for (int i = 0; i < m_tiers.GetSize(); i++) {
+    const Tier& tier = m_tiers[i];
+    if (!tier.size) break;
+
+    tier_idx = i;
+    begin = firstEndingAtOrAfter(tier, from);
+    end = firstStartingAfter(tier, to);
+
+    const bool covers = (tier.Get(0).first_update <= from);
+    const bool fits = (max_points <= 0 || end - begin <= max_points);
+    if (covers && fits) break;
+  }
+  if (tier_idx == -1) return -1;
+
+  // Even the coarsest tier has too many entries, merge consecutive runs of them down to max_points
+  const Tier& tier = m_tiers[tier_idx];
+  const int num_entries = end - begin;
+  const int group = (max_points > 0 && num_entries > max_points) ? (num_entries + max_points - 1) / max_points : 1;
+
+  samples.Resize((num_entries + group - 1) / group);
+  for (int i = 0; i < num_entries; i++) samples[i / group].Merge(tier.Get(begin + i));
+
+  // The most recent updates of a coarse tier are still accumulating in its pending block
+  const Sample& pending = tier.pending;
+  if (pending.count && pending.first_update <= to && pending.last_update >= from) samples.Push(pending);
+
+  if (!samples.GetSize()) return -1;
+  return tier_idx;
+}
+
+
+void Avida::Data::RingTimeSeriesRecorder::addSample(const Sample& sample)
+{
+  pushEntry(m_tiers[0], sample);
+
+  // Cascade completed blocks into the coarser tiers
+  Sample completed = sample;
+  for (int i = 1; i < m_tiers.GetSize(); i++) {
+    Tier& tier = m_tiers[i];
+    tier.pending.Merge(completed);
+    if (++tier.pending_entries < m_block_size) break;
+
+    completed = tier.pending;
+    pushEntry(tier, completed);
+    tier.pending = Sample();
+    tier.pending_entries = 0;
+  }
+}
+
+
+void Avida::Data::RingTimeSeriesRecorder::pushEntry(Tier& tier, const Sample& sample)
+{
+  const int capacity = tier.ring.GetSize();
+  if (tier.size < capacity) {
+    tier.ring[(tier.start + tier.size) % capacity] = sample;
+    tier.size++;
+  } else {
+    tier.ring[tier.start] = sample;
+    tier.start = (tier.start + 1) % capacity;
+  }
+}
+
+
+int Avida::Data::RingTimeSeriesRecorder::firstEndingAtOrAfter(const Tier& tier, Update update) const
+{
+  int lo = 0;
+  int hi = tier.size;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (tier.Get(mid).last_update < update) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
+int Avida::Data::RingTimeSeriesRecorder::firstStartingAfter(const Tier& tier, Update update) const
+{
+  int lo = 0;
+  int hi = tier.size;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (tier.Get(mid).first_update <= update) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
@@ -28,6 +28,7 @@
 #include "avida/environment/ActionTrigger.h"
 #include "avida/environment/Product.h"
 #include "avida/environment/Reaction.h"
+#include "avida/environment/ReactionGraph.h"
 #include "avida/environment/Resource.h"
 
 
@@ -54,6 +55,7 @@ bool Avida::Environment::Manager::DefineActionTrigger(const ActionTriggerID& tri
   ActionTriggerPtr trigger(new ActionTrigger(trigger_id, desc, product, tmp_order));
   m_action_triggers[trigger_id] = trigger;
   if (m_action_trigger_ids) m_action_trigger_ids->Insert(trigger_id);
+  invalidateGraph();
   return true;
 }
 
@@ -62,6 +64,7 @@ bool Avida::Environment::Manager::Register(ReactionPtr reaction)
   if (m_reactions.Has(reaction->GetID())) return false;
   m_reactions[reaction->GetID()] = reaction;
   if (m_reaction_ids) m_reaction_ids->Insert(reaction->GetID());
+  invalidateGraph();
   return true;
 }
 
@@ -70,6 +73,7 @@ bool Avida::Environment::Manager::Register(ResourcePtr resource)
   if (m_resources.Has(resource->GetID())) return false;
   m_resources[resource->GetID()] = resource;
   if (m_resource_ids) m_resource_ids->Insert(resource->GetID());
+  invalidateGraph();
   return true;
 }
 
@@ -136,6 +140,68 @@ Avida::Environment::ConstResourcePtr Avida::Environment::Manager::GetResource(co
   return resource;
 }
 
+
+Avida::Environment::ConstReactionGraphPtr Avida::Environment::Manager::GetReactionGraph() const
+{
+  Apto::MutexAutoLock graph_lock(m_graph_mutex);
+  if (m_graph) return m_graph;
+  
+  ReactionGraph* graph = new ReactionGraph;
+  
+  ConstActionTriggerIDSetPtr trigger_ids = GetActionTriggerIDs();
+  graph->m_triggers.Resize(trigger_ids->GetSize());
+  graph->m_trigger_product.Resize(trigger_ids->GetSize());
+  graph->m_trigger_order.Resize(trigger_ids->GetSize());
+  int idx = 0;
+  for (ConstActionTriggerIDSetIterator it = trigger_ids->Begin(); it.Next(); idx++) {
+    ActionTriggerPtr trigger;
+    m_action_triggers.Get(*it.Get(), trigger);
+    graph->m_triggers[idx] = trigger;
+    graph->m_trigger_index[*it.Get()] = idx;
+    
+    // Triggers sharing a product share its index
+    graph->m_trigger_product[idx] = -1;
+    if (trigger->GetProduct()) {
+      for (int p = 0; p < graph->m_products.GetSize(); p++) {
+        if (graph->m_products[p] == trigger->GetProduct()) graph->m_trigger_product[idx] = p;
+      }
+      if (graph->m_trigger_product[idx] == -1) {
+        graph->m_trigger_product[idx] = graph->m_products.GetSize();
+        graph->m_products.Push(trigger->GetProduct());
+      }
+    }
+    
+    const int order = trigger->TempOrdering();
+    graph->m_trigger_order[idx] = order;
+    if (order >= 0) {
+      while (graph->m_order_trigger.GetSize() <= order) graph->m_order_trigger.Push(-1);
+      graph->m_order_trigger[order] = idx;
+    }
+  }
+  
+  ConstReactionIDSetPtr reaction_ids = GetReactionIDs();
+  for (ConstReactionIDSetIterator it = reaction_ids->Begin(); it.Next();) {
+    graph->m_reaction_index[*it.Get()] = graph->m_reactions.GetSize();
+    graph->m_reactions.Push(GetReaction(*it.Get()));
+  }
+  
+  ConstResourceIDSetPtr resource_ids = GetResourceIDs();
+  for (ConstResourceIDSetIterator it = resource_ids->Begin(); it.Next();) {
+    graph->m_resource_index[*it.Get()] = graph->m_resources.GetSize();
+    graph->m_resources.Push(GetResource(*it.Get()));
+  }
+  
+  m_graph = ConstReactionGraphPtr(graph);
+  return m_graph;
+}
+
+void Avida::Environment::Manager::invalidateGraph()
+{
+  Apto::MutexAutoLock graph_lock(m_graph_mutex);
+  m_graph = ConstReactionGraphPtr(NULL);
+}
+
+
 bool Avida::Environment::Manager::AttachTo(World* world)
 {
   WorldFacetPtr ptr(this);
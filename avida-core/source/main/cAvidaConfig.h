@@ -282,6 +282,23 @@ public:
   CONFIG_ADD_VAR(VERBOSITY, int, 1, "0 = No output at all\n1 = Normal output\n2 = Verbose output, detailing progress\n3 = High level of details, as available\n4 = Print Debug Information, as applicable");
   CONFIG_ADD_VAR(RANDOM_SEED, int, -1, "Random number seed (<0 for based on time)");
   CONFIG_ADD_VAR(SPECULATIVE, bool, 1, "Enable speculative execution\n(pre-execute instructions that don't affect other organisms)");
+  CONFIG_ADD_VAR(UPDATE_THREADS, int, 0, "Number of worker threads used to speculatively pre-execute population tiles each update\n(requires SPECULATIVE; 0 = off, -1 = use all available)");
+  CONFIG_ADD_VAR(UPDATE_TILE_SIZE, int, 16, "Width and height, in cells, of the tiles executed by UPDATE_THREADS\n(demes are used as tiles when NUM_DEMES > 1)");
+  CONFIG_ADD_VAR(DEME_THREADS, int, 0, "Number of worker threads that execute demes independently each update\n(0 = off, -1 = use all available; requires NUM_DEMES > 1 and only deme resources,\n each deme then has its own scheduler, random stream and resource clock)");
+  CONFIG_ADD_VAR(NUMA_PLACEMENT, bool, 0, "Split the tiles of UPDATE_THREADS or the demes of DEME_THREADS across the NUMA nodes (Linux only):\nworkers are pinned to a node, run that node's share first, and the share's cells and spatial\nresource grids are moved to the node's memory");
+  CONFIG_ADD_VAR(RESOURCE_THREADS, int, 0, "Number of worker threads used to update independent spatial and gradient resources\n(0 = off, -1 = use all available; resources then draw from their own random streams)");
+  CONFIG_ADD_VAR(PARALLEL_PRINT, bool, 0, "Gather the data of read-only print actions that fire together concurrently on the analyze threads\n(files are still written in event order; the gathering then draws from its own random streams)");
+  CONFIG_ADD_VAR(FACET_THREADS, int, 0, "Number of threads that update independent world facets (systematics, environment, output)\nconcurrently at the end of each update (0 = off, -1 = use all available)");
+  CONFIG_ADD_VAR(PIPELINED_RECORDING, bool, 0, "Notify data recorders (stats, print and export actions) of each update on a helper thread while\nthe next update executes; the values are captured first, and updates that fire events wait for it\n(command line driver only)");
+  CONFIG_ADD_VAR(ASYNC_OUTPUT, int, 0, "Kilobytes of formatted data file rows that may be buffered for a background writer thread,\nso updates do not block on disk I/O (0 = off, write on the simulation thread)");
+  CONFIG_ADD_VAR(STATS_SAMPLE_SIZE, int, 0, "Estimate the per update organism statistics from a random sample of this many organisms\n(0 = exact statistics over every organism)");
+  CONFIG_ADD_VAR(STATS_EXACT_INTERVAL, int, 100, "While sampling, compute exact organism statistics every this many updates (0 = never)");
+  CONFIG_ADD_VAR(DATA_FILE_FORMAT, int, 0, "Format of data files\n0 = Whitespace delimited text\n1 = Binary columnar\n2 = Binary columnar, compressing column blocks where it helps\n(files named *.bdat are always binary; files written as raw text stay text)");
+  CONFIG_ADD_VAR(BINARY_TRACES, bool, 0, "Record organism traces (trace files of injected organisms and mini-traces) as compact binary\nrecords instead of text; convert them back to text with the analyze command DECODE_TRACE");
+  CONFIG_ADD_VAR(PROFILE_UPDATES, bool, 0, "Time the phases of every update (events, stats, execution, resources, demes, post-update, output);\nsee the PrintProfilingData action and the core.profile.* data values");
+  CONFIG_ADD_VAR(PRINT_RUN_TIMINGS, bool, 0, "Print a one line summary of updates, instructions executed, and wall time spent in each\nphase of the update loop when the run ends (read by the test runner's benchmark mode)");
+  CONFIG_ADD_VAR(TRACK_ALLOCATIONS, bool, 0, "Count the live and created organisms, genotypes, genomes, phenotypes and data packages;\nsee the PrintMemoryData action and the core.memory.* data values (allocator statistics are always available)");
+  CONFIG_ADD_VAR(VIEW_REFRESH_MS, int, 0, "Minimum milliseconds between redraws of the text viewer while the run is unpaused;\nupdates in between only poll for keypresses (0 = redraw every update)");
   CONFIG_ADD_VAR(POPULATION_CAP, int, 0, "Carrying capacity in number of organisms (use 0 for no cap)");
   CONFIG_ADD_VAR(POP_CAP_ELDEST, int, 0, "Carrying capacity in number of organisms (use 0 for no cap). Will kill oldest organism in population, but still use birth method to place new offspring."); 
   
@@ -307,6 +324,7 @@ public:
   // -------- Mutation config options --------
   CONFIG_ADD_GROUP(MUTATION_GROUP, "Mutation rates");  
   CONFIG_ADD_VAR(COPY_MUT_PROB, double, 0.0075, "Substitution rate (per copy)");
+  CONFIG_ADD_VAR(COPY_MUT_SKIP, int, 0, "How copy mutations (h-copy and per site copy mutations at divide) pick their sites:\n0 = Test every copied site\n1 = Draw the number of sites to the next mutation (same rates, different random sequence)");
   CONFIG_ADD_VAR(COPY_INS_PROB, double, 0.0, "Insertion rate (per copy)");
   CONFIG_ADD_VAR(COPY_DEL_PROB, double, 0.0, "Deletion rate (per copy)");
   CONFIG_ADD_VAR(COPY_UNIFORM_PROB, double, 0.0, "Uniform mutation probability (per copy)\n- Randomly apply insertion, deletion or substition mutation");
@@ -467,12 +485,17 @@ public:
   CONFIG_ADD_GROUP(ARCHETECTURE_GROUP, "Details on how CPU should work");
   CONFIG_ADD_VAR(IO_EXPIRE, bool, 1, "Is the expiration functionality of '-expire' I/O instructions enabled?");
   CONFIG_ADD_VAR(POISON_PENALTY, double, 0.01, "Metabolic rate penalty applied when the 'poison' instruction is executed.");
+  CONFIG_ADD_VAR(CPU_FAST_DISPATCH, bool, 1, "Use pre-decoded instruction dispatch in cHardwareCPU when the instruction set has no costs\nand promoters, regulation and task switching penalties are off (results are unchanged).");
+  CONFIG_ADD_VAR(INST_PROFILE_INTERVAL, int, 0, "Time roughly one in every N executed instructions and histogram the cost per instruction\nfor the PrintInstProfileData action (0 = off)");
 
   
   // -------- Pprocessing of multiple, distributed populations config options --------
   CONFIG_ADD_GROUP(MP_GROUP, "Config options for multiple, distributed populations");
   CONFIG_ADD_VAR(ENABLE_MP, int, 0, "Enable multi-process Avida; 0=disabled (default),\n1=enabled.");
   CONFIG_ADD_VAR(MP_SCHEDULING_STYLE, int, 0, "Style of scheduling:\n0=non-MP aware (default)\n1=MP aware, integrated across worlds.");
+  CONFIG_ADD_VAR(MP_BALANCE_INTERVAL, int, 0, "Updates between load rebalancing of mass action (BIRTH_METHOD 4) worlds;\n0=disabled (default).  Organisms are relocated from the ranks whose\nupdates take longest into empty cells of the faster ranks.");
+  CONFIG_ADD_VAR(MP_BALANCE_TOLERANCE, double, 0.1, "Fraction by which a rank's mean update time may exceed the mean of all\nranks before organisms are relocated from it.");
+  CONFIG_ADD_VAR(MP_NUM_WORLDS, int, 1, "Number of worlds that avida-mt runs, each on its own thread.  Spatial\n(BIRTH_METHOD 0) universes require a square number of worlds.");
 	
   
   // -------- Deme config options --------
@@ -542,6 +565,7 @@ public:
   CONFIG_ADD_GROUP(TIME_GROUP, "Time Slicing");
   CONFIG_ADD_VAR(AVE_TIME_SLICE, int, 30, "Average number of CPU-cycles per org per update");
   CONFIG_ADD_VAR(SLICING_METHOD, int, 1, "0 = CONSTANT: all organisms receive equal number of CPU cycles\n1 = PROBABILISTIC: CPU cycles distributed randomly, proportional to merit.\n2 = INTEGRATED: CPU cycles given out deterministicly, proportional to merit\n3 = DEME_PROBABALISTIC: Demes receive fixed number of CPU cycles, awarded probabalistically to members\n4 = CROSS_DEME_PROBABALISTIC: Demes receive CPU cycles proportional to living population size, awarded probabalistically to members");
+  CONFIG_ADD_VAR(SLICING_BATCH_SIZE, int, 1, "Consecutive CPU cycles given to an organism per scheduling decision\n(INTEGRATED and PROBABILISTIC only; 1 = one cycle per decision)");
   CONFIG_ADD_VAR(BASE_MERIT_METHOD, int, 4, "How should merit be initialized?\n0 = Constant (merit independent of size)\n1 = Merit proportional to copied size\n2 = Merit prop. to executed size\n3 = Merit prop. to full size\n4 = Merit prop. to min of executed or copied size\n5 = Merit prop. to sqrt of the minimum size\n6 = Merit prop. to num times MERIT_BONUS_INST is in genome.");
   CONFIG_ADD_VAR(BASE_CONST_MERIT, int, 100, "Base merit valse for BASE_MERIT_METHOD 0");
   CONFIG_ADD_VAR(MERIT_BONUS_INST, int, 0, "Instruction ID to count for BASE_MERIT_METHOD 6"); 
@@ -558,6 +582,7 @@ public:
   CONFIG_ADD_VAR(FITNESS_COEFF_2, double, 1.0, "2nd FITNESS_METHOD parameter");
   CONFIG_ADD_VAR(MAX_CPU_THREADS, int, 1, "Maximum number of Threads a CPU can spawn");
   CONFIG_ADD_VAR(THREAD_SLICING_METHOD, int, 0, "Formula for allocating CPU cycles across threads in an organism\n  (num_threads-1) * THREAD_SLICING_METHOD + 1\n0 = One thread executed per time slice.\n1 = All threads executed each time slice.\n");
+  CONFIG_ADD_VAR(SMT_THREAD_QUANTUM, int, 1, "With THREAD_SLICING_METHOD 0, number of consecutive time slices a TransSMT thread\n(or the thread chosen by parasite virulence) runs before the next thread is picked");
   CONFIG_ADD_VAR(NO_CPU_CYCLE_TIME, int, 0, "Don't count each CPU cycle as part of gestation time\n");
   CONFIG_ADD_VAR(MAX_LABEL_EXE_SIZE, int, 1, "Max nops marked as executed when labels are used");
   CONFIG_ADD_VAR(PRECALC_PHENOTYPE, int, 0, "0 = Disabled\n 1 = Assign precalculated merit at birth (unlimited resources only)\n 2 = Assign precalculated gestation time\n 3 = Assign precalculated merit AND gestation time.\n 4 = Assign last instruction counts \n 5 = Assign last instruction counts and merit\n 6 = Assign last instruction counts and gestation time \n 7 = Assign everything currently supported\nFitness will be evaluated for organism based on these settings.");
@@ -592,6 +617,11 @@ public:
   CONFIG_ADD_GROUP(GENEOLOGY_GROUP, "Geneology");
   CONFIG_ADD_VAR(THRESHOLD, int, 3, "Number of organisms in a genotype needed for it\n  to be considered viable.");
   CONFIG_ADD_VAR(TEST_CPU_TIME_MOD, int, 20, "Time allocated in test CPUs (multiple of length)");
+  CONFIG_ADD_VAR(TEST_CPU_LOCKSTEP, int, 0, "Number of genomes a batch of test CPU runs (landscapes, knockouts) executes side by side\nin lockstep, for heads instruction sets without mutations on copy (0 or 1 = one at a time)");
+  CONFIG_ADD_VAR(TEST_CPU_CACHE_SIZE, int, 10000, "Maximum number of genome test results to memoize (0 disables)");
+  CONFIG_ADD_VAR(PHYLOGENY_LOG, cString, "", "File, in the data directory, that genotype births (with parents and genome) and extinctions are\nstreamed to as a compact binary log, for rebuilding full phylogenies offline ('' = off);\ncombine with DISABLE_GENOTYPE_CLASSIFICATION to keep no extinct ancestors in memory");
+  CONFIG_ADD_VAR(PHYLOGENY_LOG_PRUNE, bool, 0, "Also log when a genotype is left without living descendants, so that offline reconstructions\ncan prune dead branches (only meaningful while DISABLE_GENOTYPE_CLASSIFICATION is off)");
+  CONFIG_ADD_VAR(BACKGROUND_GENOME_TESTS, bool, 0, "Evaluate genotypes on test CPUs in worker threads as they cross the threshold, so their metrics\nare ready when first requested (threads are limited by MAX_CONCURRENCY)");
   
 
   // -------- Organism Network config options --------
@@ -638,6 +668,7 @@ public:
   // -------- Analyze config options --------
   CONFIG_ADD_GROUP(ANALYZE_GROUP, "Analysis Settings");
   CONFIG_ADD_VAR(MAX_CONCURRENCY, int, -1, "Maximum number of analyze threads, -1 == use all available.");
+  CONFIG_ADD_VAR(PARALLEL_ANALYZE, bool, 0, "Recalculate all genotypes of a batch on the analyze threads before serial\nanalyze commands format their output. 0/1 (off/on)");
   CONFIG_ADD_VAR(INJECT_RESETS_TASKS, int, 0, "Executing INJECT (semi-succesfully) will trigger last_task_count to be writen from current_task_count");
   CONFIG_ADD_VAR(ANALYZE_OPTION_1, cString, "", "String variable accessible from analysis scripts");
   CONFIG_ADD_VAR(ANALYZE_OPTION_2, cString, "", "String variable accessible from analysis scripts");
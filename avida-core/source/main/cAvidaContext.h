@@ -28,6 +28,11 @@
 
 #include "avida/core/Types.h"
 
+#include "cCounterRNG.h"
+
+#include <climits>
+#include <cmath>
+
 class cWorld;
 
 
@@ -36,14 +41,15 @@ class cAvidaContext
 private:
   Avida::WorldDriver* m_driver;
   Apto::Random* m_rng;
+  cCounterRNG* m_counter_rng;
 
   bool m_analyze;
   bool m_testing;
   bool m_org_faults;
   
 public:
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_counter_rng(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_counter_rng(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
   ~cAvidaContext() { ; }
   
   Avida::WorldDriver& Driver() { return *m_driver; }
@@ -53,6 +59,28 @@ public:
   void SetRandom(Apto::Random* rng) { m_rng = rng; }
   Apto::Random& GetRandom() { return *m_rng; }
   
+  // Number of failed trials before the next success of a per trial probability (geometric), so that a run of
+  // independent P(prob) tests can be replaced by one draw per success; INT_MAX when prob is zero
+  int GetTrialsToNextEvent(double prob)
+  {
+    if (prob <= 0.0) return INT_MAX;
+    if (prob >= 1.0) return 0;
+    const double skip = floor(log(1.0 - m_rng->GetDouble()) / log(1.0 - prob));
+    return (skip < INT_MAX) ? static_cast<int>(skip) : INT_MAX;
+  }
+  
+  // With a counter RNG attached, KeyRandom() restarts the random stream at a point determined only by the counter
+  // RNG's seed, the update and the cell, so draws made while processing that cell do not depend on what ran before
+  void SetCounterRandom(cCounterRNG* rng) { m_counter_rng = rng; }
+  bool HasCounterRandom() const { return (m_counter_rng != NULL); }
+  cCounterRNG& GetCounterRandom() { return *m_counter_rng; }
+  void KeyRandom(int update, int cell)
+  {
+    if (!m_counter_rng) return;
+    m_counter_rng->SetStream(update, cell);
+    m_rng->ResetSeed(static_cast<int>(m_counter_rng->GetUInt(m_rng->MaxSeed())));
+  }
+  
   void SetAnalyzeMode() { m_analyze = true; }
   void ClearAnalyzeMode() { m_analyze = false; }
   bool GetAnalyzeMode() { return m_analyze; }
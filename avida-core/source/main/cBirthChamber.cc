@@ -175,6 +175,13 @@ void cBirthChamber::ClearEntry(cBirthEntry& entry)
 }
 
 
+// Load [start, end) of genome into a recombination buffer, reusing the buffer's storage
+static inline void loadRegion(InstructionSequence& buf, const InstructionSequence& genome, int start, int end)
+{
+  buf.Resize(end - start);
+  for (int i = start; i < end; i++) buf[i - start] = genome[i];
+}
+
 bool cBirthChamber::RegionSwap(InstructionSequence& genome0, InstructionSequence& genome1, int start0, int end0, int start1, int end1)
 {
    assert( start0 >= 0  &&  start0 < genome0.GetSize() );
@@ -195,31 +202,45 @@ bool cBirthChamber::RegionSwap(InstructionSequence& genome0, InstructionSequence
      return false;
    } 
 
-   if (size0 > 0 && size1 > 0) {
-     InstructionSequence cross0 = genome0.Crop(start0, end0);
-     InstructionSequence cross1 = genome1.Crop(start1, end1);
-     genome0.Replace(start0, size0, cross1);
-     genome1.Replace(start1, size1, cross0);
+   if (size0 > 0 && size0 == size1) {
+     // Equal sections (the common case for equal length parents) are exchanged in place
+     for (int i = 0; i < size0; i++) {
+       Instruction inst = genome0[start0 + i];
+       genome0[start0 + i] = genome1[start1 + i];
+       genome1[start1 + i] = inst;
+     }
+   } else if (size0 > 0 && size1 > 0) {
+     loadRegion(m_cross_buf0, genome0, start0, end0);
+     loadRegion(m_cross_buf1, genome1, start1, end1);
+     genome0.Replace(start0, size0, m_cross_buf1);
+     genome1.Replace(start1, size1, m_cross_buf0);
    } else if (size0 > 0) {
-     InstructionSequence cross0 = genome0.Crop(start0, end0);
-     genome1.Replace(start1, size1, cross0);
+     loadRegion(m_cross_buf0, genome0, start0, end0);
+     genome1.Replace(start1, size1, m_cross_buf0);
    } else if (size1 > 0) {
-     InstructionSequence cross1 = genome1.Crop(start1, end1);
-     genome0.Replace(start0, size0, cross1);
+     loadRegion(m_cross_buf1, genome1, start1, end1);
+     genome0.Replace(start0, size0, m_cross_buf1);
    }
 
    return true;
 }
 
-void cBirthChamber::GenomeSwap(InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1)
+bool cBirthChamber::BlendMerits(double cut_frac, double& merit0, double& merit1)
 {
-  InstructionSequence genome0_tmp = genome0;
-  genome0 = genome1;
-  genome1 = genome0_tmp;
+  double stay_frac = 1.0 - cut_frac;
 
-  double merit0_tmp = merit0;
-  merit0 = merit1;
-  merit1 = merit0_tmp;
+  // Adjust the merits....
+  double tmp_merit0 = merit0 * stay_frac + merit1 * cut_frac;
+  merit1 = merit1 * stay_frac + merit0 * cut_frac;
+  merit0 = tmp_merit0;
+
+  // Majority of the genome should stay in the offspring, so rather than copying the genomes back the caller swaps
+  // which genome each child is built from
+  if (stay_frac < cut_frac) {
+    Swap(merit0, merit1);
+    return true;
+  }
+  return false;
 }
 
 
@@ -283,7 +304,7 @@ bool cBirthChamber::DoPairAsexBirth(cAvidaContext& ctx, const cBirthEntry& old_e
 
 
 
-void cBirthChamber::DoBasicRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+bool cBirthChamber::DoBasicRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                          double& merit0, double& merit1)
 {
   double start_frac = ctx.GetRandom().GetDouble();
@@ -292,7 +313,6 @@ void cBirthChamber::DoBasicRecombination(cAvidaContext& ctx, InstructionSequence
     
   // calculate the proportion of the genome  that will be swapped
   double cut_frac = end_frac - start_frac;
-  double stay_frac = 1.0 - cut_frac;
 
   int start0 = (int) (start_frac * (double) genome0.GetSize());
   int end0   = (int) (end_frac * (double) genome0.GetSize());
@@ -301,18 +321,10 @@ void cBirthChamber::DoBasicRecombination(cAvidaContext& ctx, InstructionSequence
 
   RegionSwap(genome0, genome1, start0, end0, start1, end1);
 
-  // Adjust the merits....
-  double tmp_merit0 = merit0 * stay_frac + merit1 * cut_frac;
-  merit1 = merit1 * stay_frac + merit0 * cut_frac;
-  merit0 = tmp_merit0;
-
-  // Majority of the genome should stay in the offspring
-  if (stay_frac < cut_frac) {
-     GenomeSwap(genome0, genome1, merit0, merit1); 
-  } 
+  return BlendMerits(cut_frac, merit0, merit1);
 }
 
-void cBirthChamber::DoModularContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+bool cBirthChamber::DoModularContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                                double& merit0, double& merit1)
 {
   const int num_modules = m_world->GetConfig().MODULE_NUM.Get();
@@ -327,7 +339,6 @@ void cBirthChamber::DoModularContRecombination(cAvidaContext& ctx, InstructionSe
 	    
   // calculate the proportion of the genome  that will be swapped
   double cut_frac = end_frac - start_frac;
-  double stay_frac = 1.0 - cut_frac;
 
   int start0 = (int) (start_frac * (double) genome0.GetSize());
   int end0   = (int) (end_frac * (double) genome0.GetSize());
@@ -336,18 +347,10 @@ void cBirthChamber::DoModularContRecombination(cAvidaContext& ctx, InstructionSe
 
   RegionSwap(genome0, genome1, start0, end0, start1, end1);
 
-  // Adjust the merits....
-  double tmp_merit0 = merit0 * stay_frac + merit1 * cut_frac;
-  merit1 = merit1 * stay_frac + merit0 * cut_frac;
-  merit0 = tmp_merit0;
-
-  // Majority of the genome should stay in the offspring
-  if (stay_frac < cut_frac) {
-     GenomeSwap(genome0, genome1, merit0, merit1); 
-  } 
+  return BlendMerits(cut_frac, merit0, merit1);
 }
 
-void cBirthChamber::DoModularNonContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+bool cBirthChamber::DoModularNonContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                                   double& merit0, double& merit1)
 {
   const int num_modules = m_world->GetConfig().MODULE_NUM.Get();
@@ -368,24 +371,16 @@ void cBirthChamber::DoModularNonContRecombination(cAvidaContext& ctx, Instructio
   }
 
   double cut_frac = ((double) swap_count) / (double) num_modules;
-  double stay_frac = 1.0 - cut_frac;
-
-  // Adjust the merits....
-  double tmp_merit0 = merit0 * stay_frac + merit1 * cut_frac;
-  merit1 = merit1 * stay_frac + merit0 * cut_frac;
-  merit0 = tmp_merit0;
 
-  // Majority of the genome should stay in the offspring
-  if (stay_frac < cut_frac) {
-     GenomeSwap(genome0, genome1, merit0, merit1); 
-  } 
+  return BlendMerits(cut_frac, merit0, merit1);
 }
 
-void cBirthChamber::DoModularShuffleRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+bool cBirthChamber::DoModularShuffleRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                                    double& merit0, double& merit1)
 {
   const int num_modules = m_world->GetConfig().MODULE_NUM.Get();
-  Apto::Array<bool> swapped_region(num_modules);
+  Apto::Array<bool>& swapped_region = m_swapped_region;
+  if (swapped_region.GetSize() != num_modules) swapped_region.Resize(num_modules);
   swapped_region.SetAll(false);
 
   int swap_count = 0;
@@ -418,17 +413,8 @@ void cBirthChamber::DoModularShuffleRecombination(cAvidaContext& ctx, Instructio
   }
 
   double cut_frac = ((double) swap_count) / (double) num_modules;
-  double stay_frac = 1.0 - cut_frac;
 
-  // Adjust the merits....
-  double tmp_merit0 = merit0 * stay_frac + merit1 * cut_frac;
-  merit1 = merit1 * stay_frac + merit0 * cut_frac;
-  merit0 = tmp_merit0;
-
-  // Majority of the genome should stay in the offspring
-  if (stay_frac < cut_frac) {
-     GenomeSwap(genome0, genome1, merit0, merit1); 
-  } 
+  return BlendMerits(cut_frac, merit0, merit1);
 }
 
 
@@ -507,25 +493,30 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
   genome1_seq_p.DynamicCastFrom(genome1_rep_p);
   InstructionSequence& genome1_seq = *genome1_seq_p;
 
+  bool swapped = false;
   if (num_modules == 0) {
-    DoBasicRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
+    swapped = DoBasicRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
   }
 
   // If we ARE modular, and continuous...
   else if (continuous_regions == 1) {
-    DoModularContRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
+    swapped = DoModularContRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
   }
 
   // If we are NOT continuous, but NO shuffling...
   else if (shuffle_regions == 0) {
-    DoModularNonContRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
+    swapped = DoModularNonContRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
   }
 
   // If there IS shuffling (NON-continuous required)
   else {
-    DoModularShuffleRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
+    swapped = DoModularShuffleRecombination(ctx, genome0_seq, genome1_seq, meritOrEnergy0, meritOrEnergy1);
   }
 
+  // The merits already follow the majority of each genome, build the children to match
+  const Genome& child_genome0 = (swapped) ? genome1 : genome0;
+  const Genome& child_genome1 = (swapped) ? genome0 : genome1;
+
   // Should there be a 2-fold cost to sex?
 
   const int two_fold_cost = m_world->GetConfig().TWO_FOLD_COST_SEX.Get();
@@ -535,8 +526,8 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
   
   if (two_fold_cost == 0) {	// Build the two organisms.
     child_array.Resize(2);
-    child_array[0] = new cOrganism(m_world, ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
-    child_array[1] = new cOrganism(m_world, ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+    child_array[0] = new cOrganism(m_world, ctx, child_genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+    child_array[1] = new cOrganism(m_world, ctx, child_genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
     
     if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
       child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy0);
@@ -559,7 +550,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
     merit_array.Resize(1);
 
     if (ctx.GetRandom().GetDouble() < 0.5) {
-      child_array[0] = new cOrganism(m_world, ctx, genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+      child_array[0] = new cOrganism(m_world, ctx, child_genome0, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
       if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
         child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy0);
         meritOrEnergy0 = child_array[0]->GetPhenotype().ConvertEnergyToMerit(child_array[0]->GetPhenotype().GetStoredEnergy());
@@ -570,7 +561,7 @@ bool cBirthChamber::SubmitOffspring(cAvidaContext& ctx, const Genome& offspring,
       SetupGenotypeInfo(child_array[0], parent0_groups, parent1_groups);
     } 
     else {
-      child_array[0] = new cOrganism(m_world, ctx, genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
+      child_array[0] = new cOrganism(m_world, ctx, child_genome1, parent_phenotype.GetGeneration(), Systematics::Source(Systematics::DIVISION, ""));
       if(m_world->GetConfig().ENERGY_ENABLED.Get() == 1) {
         child_array[0]->GetPhenotype().SetEnergy(meritOrEnergy1);
         meritOrEnergy1 = child_array[1]->GetPhenotype().ConvertEnergyToMerit(child_array[1]->GetPhenotype().GetStoredEnergy());
@@ -23,6 +23,7 @@
 #ifndef cBirthChamber_h
 #define cBirthChamber_h
 
+#include "avida/core/InstructionSequence.h"
 #include "avida/systematics/Group.h"
 
 #include "cBirthEntry.h"
@@ -49,6 +50,11 @@ private:
   cWorld* m_world;
   Apto::Map<int, cBirthSelectionHandler*> m_handler_map;
 
+  // Recombination scratch space, kept between births so that crossover does not allocate once it has warmed up
+  InstructionSequence m_cross_buf0;
+  InstructionSequence m_cross_buf1;
+  Apto::Array<bool> m_swapped_region;
+
 
   cBirthChamber(); // @not_implemented
   cBirthChamber(const cBirthChamber&); // @not_implemented
@@ -76,7 +82,7 @@ private:
   cBirthSelectionHandler* getSelectionHandler(int hw_type);
   
   bool RegionSwap(InstructionSequence& genome0, InstructionSequence& genome1, int start0, int end0, int start1, int end1);
-  void GenomeSwap(InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1);
+  bool BlendMerits(double cut_frac, double& merit0, double& merit1);
   
   bool DoAsexBirth(cAvidaContext& ctx, const Genome& offspring_genome, cOrganism& parent,
                    Apto::Array<cOrganism*>& child_array, Apto::Array<cMerit>& merit_array);
@@ -84,12 +90,14 @@ private:
                        Apto::Array<cOrganism*>& child_array, Apto::Array<cMerit>& merit_array);
   
 
-  void DoBasicRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1);
-  void DoModularContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+  // Recombination operators return true when the majority of each genome has crossed over, in which case the
+  // merits have been exchanged and the children should be built from the opposite genomes
+  bool DoBasicRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1, double& merit0, double& merit1);
+  bool DoModularContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                   double& merit0, double& merit1);
-  void DoModularNonContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+  bool DoModularNonContRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                      double& merit0, double& merit1);
-  void DoModularShuffleRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
+  bool DoModularShuffleRecombination(cAvidaContext& ctx, InstructionSequence& genome0, InstructionSequence& genome1,
                                      double& merit0, double& merit1);
   
   void SetupGenotypeInfo(cOrganism* organism, Systematics::ConstGroupMembershipPtr p0grps, Systematics::ConstGroupMembershipPtr p1grps = Systematics::ConstGroupMembershipPtr(NULL));
@@ -34,6 +34,7 @@
 #include "cTaskEntry.h"
 #include "cString.h"
 
+#include <climits>
 #include <iostream>
 
 
@@ -82,12 +83,12 @@ cBirthEntry* cBirthMatingTypeGlobalHandler::SelectOffspring(cAvidaContext& ctx,
 int cBirthMatingTypeGlobalHandler::GetWaitingOffspringNumber(int which_mating_type)
 {
   //if (which_mating_type == -1) return 0;
-  int num_waiting = 0;
+  purgeExpired();
   
-  for (int i = 0; i < m_entries.GetSize(); i++) {
-    if (m_bc->ValidateBirthEntry(m_entries[i])) {
-      if (m_entries[i].GetMatingType() == which_mating_type) num_waiting++;
-    }
+  int num_waiting = 0;
+  std::map<std::pair<int, int>, int>::const_iterator it = m_bucket_ids.lower_bound(std::make_pair(which_mating_type, INT_MIN));
+  for (; it != m_bucket_ids.end() && it->first.first == which_mating_type; it++) {
+    num_waiting += m_buckets[it->second].GetSize();
   }
   return num_waiting;
 }
@@ -180,6 +181,70 @@ int cBirthMatingTypeGlobalHandler::getTaskID(cString task_name, cWorld* world)
   return -1;
 }
 
+// Bucket holding the waiting entries of a mating type (within a group, if mating is restricted to groups), -1 if none
+int cBirthMatingTypeGlobalHandler::findBucket(int mating_type, int group_id) const
+{
+  if (!m_world->GetConfig().MATE_IN_GROUPS.Get()) group_id = 0;
+  std::map<std::pair<int, int>, int>::const_iterator it = m_bucket_ids.find(std::make_pair(mating_type, group_id));
+  return (it == m_bucket_ids.end()) ? -1 : it->second;
+}
+
+void cBirthMatingTypeGlobalHandler::fileEntry(int entry)
+{
+  const int group_id = (m_world->GetConfig().MATE_IN_GROUPS.Get()) ? m_entries[entry].GetGroupID() : 0;
+  const std::pair<int, int> key(m_entries[entry].GetMatingType(), group_id);
+  int bucket = findBucket(key.first, key.second);
+  if (bucket == -1) {
+    bucket = m_buckets.GetSize();
+    m_buckets.Resize(bucket + 1);
+    m_bucket_ids[key] = bucket;
+  }
+  
+  m_entry_bucket[entry] = bucket;
+  m_entry_pos[entry] = m_buckets[bucket].GetSize();
+  m_buckets[bucket].Push(entry);
+  m_entry_seq[entry] = m_next_seq;
+  m_store_order.push_back(std::make_pair(entry, m_next_seq++));
+  
+  // Records of entries that left early pile up behind a long waiting one, drop them once they dominate
+  if ((int)m_store_order.size() > 2 * m_entries.GetSize()) {
+    std::deque<std::pair<int, int> > waiting;
+    for (std::size_t i = 0; i < m_store_order.size(); i++) {
+      const std::pair<int, int>& record = m_store_order[i];
+      if (m_entry_bucket[record.first] != -1 && m_entry_seq[record.first] == record.second) waiting.push_back(record);
+    }
+    m_store_order.swap(waiting);
+  }
+}
+
+void cBirthMatingTypeGlobalHandler::unfileEntry(int entry)
+{
+  const int bucket = m_entry_bucket[entry];
+  if (bucket == -1) return;
+  
+  Apto::Array<int, Apto::Smart>& waiting = m_buckets[bucket];
+  const int last = waiting[waiting.GetSize() - 1];
+  waiting[m_entry_pos[entry]] = last;
+  m_entry_pos[last] = m_entry_pos[entry];
+  waiting.Pop();
+  
+  m_entry_bucket[entry] = -1;
+  m_free_entries.Push(entry);
+}
+
+// Drop the entries that have waited longer than MAX_BIRTH_WAIT_TIME, which are the oldest ones
+void cBirthMatingTypeGlobalHandler::purgeExpired()
+{
+  while (!m_store_order.empty()) {
+    const int entry = m_store_order.front().first;
+    if (m_entry_bucket[entry] != -1 && m_entry_seq[entry] == m_store_order.front().second) {
+      if (m_bc->ValidateBirthEntry(m_entries[entry])) break;
+      unfileEntry(entry);
+    }
+    m_store_order.pop_front();
+  }
+}
+
 //Stores the specified offspring in the specified birth chamber
 void cBirthMatingTypeGlobalHandler::storeOffspring(cAvidaContext&, const Genome& offspring, cOrganism* parent)
 {
@@ -190,39 +255,30 @@ void cBirthMatingTypeGlobalHandler::storeOffspring(cAvidaContext&, const Genome&
     return;
   }
   
-  //Find an empty entry
+  //Use an empty entry
   //If there are none, make room for one
   //But if the birth chamber is at the size limit already, over-write the oldest one
-  int oldest_index = -1;
-  int entry_list_size = m_entries.GetSize();
-  //Loop through all the birth entries
-  for (int i = 0; i < entry_list_size; i++) {
-    if (m_bc->ValidateBirthEntry(m_entries[i])) {
-      //Current entry is valid, so let's just keep track of the oldest one
-      if (oldest_index == -1) oldest_index = i;
-      else oldest_index = (m_entries[i].timestamp < m_entries[oldest_index].timestamp ? i : oldest_index);
-    } else {
-      //Current entry is empty, so let's use this one
-      m_bc->ClearEntry(m_entries[i]);
-      m_bc->StoreAsEntry(offspring, parent, m_entries[i]);
-      return;
-    }
+  purgeExpired();
+  int max_buffer_size = m_world->GetConfig().MAX_GLOBAL_BIRTH_CHAMBER_SIZE.Get();
+  if (m_free_entries.GetSize() == 0 && m_entries.GetSize() >= max_buffer_size && !m_store_order.empty()) {
+    unfileEntry(m_store_order.front().first);
+    m_store_order.pop_front();
   }
-
-  //If we're still here, it means we didn't find any empty entries
-  //So, let's make room for one and then store it; but if the list is already at its max size,
-  // we'll just have to over-write the oldest one
+  
   int store_index = m_entries.GetSize();
-  int max_buffer_size = m_world->GetConfig().MAX_GLOBAL_BIRTH_CHAMBER_SIZE.Get();
-  if (store_index >= max_buffer_size) {
-    //m_bc->ClearEntry(m_entries[oldest_index]);
-    store_index = oldest_index;
+  if (m_free_entries.GetSize()) {
+    store_index = m_free_entries.Pop();
   } else {
     m_entries.Resize(store_index + 1);
+    m_entry_bucket.Resize(store_index + 1);
+    m_entry_pos.Resize(store_index + 1);
+    m_entry_seq.Resize(store_index + 1);
+    m_entry_bucket[store_index] = -1;
   }
   
   m_bc->ClearEntry(m_entries[store_index]);
   m_bc->StoreAsEntry(offspring, parent, m_entries[store_index]);
+  fileEntry(store_index);
 }
 
 //Compares two birth entries and decides which one is preferred
@@ -305,70 +361,34 @@ bool cBirthMatingTypeGlobalHandler::compareBirthEntries(cAvidaContext& ctx, int
 //If none is found, it returns NULL
 cBirthEntry* cBirthMatingTypeGlobalHandler::selectMate(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent, int which_mating_type, int mate_choice_method)
 {
-  //Loop through the entry list and find a mate
+  //Find a mate among the waiting entries of the compatible mating type
   //If none are found, store the current offspring and return NULL
-  int num_waiting = m_entries.GetSize();
-  if (num_waiting == 0) {
-    storeOffspring(ctx, offspring, parent);
-    return NULL;
-  }
-  
-  int selected_index = -1;
+  purgeExpired();
   
   if (m_world->GetConfig().FORCED_MATE_PREFERENCE.Get() != -1) {
     mate_choice_method = m_world->GetConfig().FORCED_MATE_PREFERENCE.Get();
   }
   
-  if (mate_choice_method == MATE_PREFERENCE_RANDOM) {
-    //This is a non-choosy individual, so pick a mate randomly!
-    //First, get a list of every element of m_entries that contains a waiting offspring (of the compatible sex)
-    //Then pick one at random
-    Apto::Array<int> compatible_entries; //This will hold a list of all the compatible birth entries waiting in the birth chamber
-    compatible_entries.Resize(num_waiting, -1);
-    int last_compatible = -1; //The index of the last entry in compatible_entries holding a compatible m_entries index
-    for (int i = 0; i < num_waiting; i++) {
-      if (m_bc->ValidateBirthEntry(m_entries[i])) { //Is the current entry valid/alive?
-        //Here, check to see if the current entry belongs to the parent's group! @CHC
-        bool groups_match = false;
-        if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
-          groups_match = true; //Within-group mating is turned off, so don't need to check
-        } else {
-          //Within-group mating is turned on, so we need to check if the parent's group is the same
-          if (parent->HasOpinion()) {
-            groups_match = (m_entries[i].GetGroupID() == parent->GetOpinion().first);
-          }
-        }
-        if (groups_match) {
-          if (m_entries[i].GetMatingType() == which_mating_type) { //Is the current entry a compatible mating type?
-            last_compatible++;
-            compatible_entries[last_compatible] = i;
-          }
-        }
-      }
-    }
-    if (last_compatible > -1) { //Don't bother picking one if we haven't found any compatible entries
-      selected_index = compatible_entries[ctx.GetRandom().GetUInt(last_compatible+1)];
-    }    
-  } else {
-    //This is a choosy female, so go through all the mates and pick the "best" one!
-    for (int i = 0; i < num_waiting; i++) {
-      if (m_bc->ValidateBirthEntry(m_entries[i])) { //Is the current entry valid/alive?
-        //Here, check to see if the current entry belongs to the parent's group! @CHC
-        bool groups_match = false;
-        if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
-          groups_match = true; //Within-group mating is turned off, so don't need to check
-        } else {
-          //Within-group mating is turned on, so we need to check if the parent's group is the same
-          if (parent->HasOpinion()) {
-            groups_match = (m_entries[i].GetGroupID() == parent->GetOpinion().first);
-          }
-        }
-        if (groups_match) {
-          if (m_entries[i].GetMatingType() == which_mating_type) { //Is the current entry a compatible mating type?
-            if (selected_index == -1) selected_index = i;
-            else selected_index = compareBirthEntries(ctx, mate_choice_method, m_entries[i], m_entries[selected_index]) ? i : selected_index;
-          }
-        }
+  //If within-group mating is turned on, only the entries of the parent's group are compatible @CHC
+  int bucket = -1;
+  if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
+    bucket = findBucket(which_mating_type, 0);
+  } else if (parent->HasOpinion()) {
+    bucket = findBucket(which_mating_type, parent->GetOpinion().first);
+  }
+  
+  int selected_index = -1;
+  if (bucket != -1 && m_buckets[bucket].GetSize() > 0) {
+    const Apto::Array<int, Apto::Smart>& compatible_entries = m_buckets[bucket];
+    if (mate_choice_method == MATE_PREFERENCE_RANDOM) {
+      //This is a non-choosy individual, so pick a mate randomly!
+      selected_index = compatible_entries[ctx.GetRandom().GetUInt(compatible_entries.GetSize())];
+    } else {
+      //This is a choosy female, so go through all the mates and pick the "best" one!
+      for (int i = 0; i < compatible_entries.GetSize(); i++) {
+        const int entry = compatible_entries[i];
+        if (selected_index == -1) selected_index = entry;
+        else selected_index = compareBirthEntries(ctx, mate_choice_method, m_entries[entry], m_entries[selected_index]) ? entry : selected_index;
       }
     }
   }
@@ -378,6 +398,9 @@ cBirthEntry* cBirthMatingTypeGlobalHandler::selectMate(cAvidaContext& ctx, const
     storeOffspring(ctx, offspring, parent);
     return NULL;
   }
+  
+  //The birth chamber clears the selected entry once the mating is done
+  unfileEntry(selected_index);
   //cout << "Selected " << m_entries[selected_index].GetPhenotypeString() << "\n";
   return &(m_entries[selected_index]);
   
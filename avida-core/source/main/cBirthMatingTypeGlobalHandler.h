@@ -28,24 +28,46 @@
 #include "cBirthEntry.h"
 #include "cBirthSelectionHandler.h"
 
+#include <deque>
+#include <map>
+#include <utility>
+
 class cBirthChamber;
 
 
+// Waiting entries are filed in buckets by mating type (and by group when MATE_IN_GROUPS is set), so that choosing a
+// mate only looks at the compatible entries.  Entries leave their bucket when they are handed out as a mate (the
+// birth chamber clears them right after) or when they time out; timed out entries are always the oldest, so they are
+// found from the front of the store order.
+
 class cBirthMatingTypeGlobalHandler : public cBirthSelectionHandler
 {
 private:
   cWorld* m_world;
   cBirthChamber* m_bc;
   Apto::Array<cBirthEntry> m_entries;
+  
+  Apto::Array<int> m_entry_bucket;      // bucket each entry is filed in, -1 if it is not waiting
+  Apto::Array<int> m_entry_pos;         // position of each entry in its bucket
+  Apto::Array<int> m_entry_seq;         // store sequence number of each entry
+  Apto::Array< Apto::Array<int, Apto::Smart>, Apto::Smart > m_buckets;
+  std::map<std::pair<int, int>, int> m_bucket_ids;   // (mating type, group) to bucket
+  Apto::Array<int> m_free_entries;
+  std::deque<std::pair<int, int> > m_store_order;    // (entry, sequence number), oldest first
+  int m_next_seq;
 
   int getTaskID(cString task_name, cWorld* world);
+  int findBucket(int mating_type, int group_id) const;
+  void fileEntry(int entry);
+  void unfileEntry(int entry);
+  void purgeExpired();
   void storeOffspring(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent);
   cBirthEntry* selectMate(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent, int which_mating_type, int mate_choice_method);
   int getWaitingOffspringMostTask(int which_mating_type, int task_id);
   bool compareBirthEntries(cAvidaContext& ctx, int mate_choice_method, const cBirthEntry& entry1, const cBirthEntry& entry2);
   
 public:
-  cBirthMatingTypeGlobalHandler(cWorld* world, cBirthChamber* bc) : m_world(world), m_bc(bc) { ; }
+  cBirthMatingTypeGlobalHandler(cWorld* world, cBirthChamber* bc) : m_world(world), m_bc(bc), m_next_seq(0) { ; }
   ~cBirthMatingTypeGlobalHandler();
   
   cBirthEntry* SelectOffspring(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent);
@@ -0,0 +1,105 @@
+/*
+ *  cCellAgeOrder.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCellAgeOrder.h"
+
+#include <cassert>
+
+
+void cCellAgeOrder::Setup(int num_cells)
+{
+  m_cell_slot.Resize(num_cells);
+  m_slot_cell.Resize(num_cells);
+  m_prev.Resize(num_cells);
+  m_next.Resize(num_cells);
+  m_stamp.Resize(num_cells);
+  m_linked.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_cell_slot[i] = m_slot_cell[i] = i;
+    m_prev[i] = m_next[i] = -1;
+    m_stamp[i] = 0;
+    m_linked[i] = false;
+  }
+  m_head = m_tail = -1;
+  m_size = 0;
+}
+
+
+void cCellAgeOrder::Insert(int cell_id, int stamp)
+{
+  const int slot = m_cell_slot[cell_id];
+  if (m_linked[slot]) unlink(slot);
+  link(slot, stamp);
+}
+
+
+void cCellAgeOrder::Remove(int cell_id)
+{
+  const int slot = m_cell_slot[cell_id];
+  if (m_linked[slot]) unlink(slot);
+}
+
+
+void cCellAgeOrder::Swap(int cell_id1, int cell_id2)
+{
+  const int slot1 = m_cell_slot[cell_id1];
+  const int slot2 = m_cell_slot[cell_id2];
+  m_cell_slot[cell_id1] = slot2;
+  m_cell_slot[cell_id2] = slot1;
+  m_slot_cell[slot1] = cell_id2;
+  m_slot_cell[slot2] = cell_id1;
+}
+
+
+void cCellAgeOrder::link(int slot, int stamp)
+{
+  // Walk back from the youngest; newborns stop immediately
+  int prev = m_tail;
+  while (prev != -1 && m_stamp[prev] > stamp) prev = m_prev[prev];
+
+  const int next = (prev == -1) ? m_head : m_next[prev];
+  m_prev[slot] = prev;
+  m_next[slot] = next;
+  if (prev == -1) m_head = slot;
+  else m_next[prev] = slot;
+  if (next == -1) m_tail = slot;
+  else m_prev[next] = slot;
+
+  m_stamp[slot] = stamp;
+  m_linked[slot] = true;
+  m_size++;
+}
+
+
+void cCellAgeOrder::unlink(int slot)
+{
+  assert(m_linked[slot]);
+
+  const int prev = m_prev[slot];
+  const int next = m_next[slot];
+  if (prev == -1) m_head = next;
+  else m_next[prev] = next;
+  if (next == -1) m_tail = prev;
+  else m_prev[next] = prev;
+
+  m_prev[slot] = m_next[slot] = -1;
+  m_linked[slot] = false;
+  m_size--;
+}
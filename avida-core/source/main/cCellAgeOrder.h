@@ -0,0 +1,80 @@
+/*
+ *  cCellAgeOrder.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCellAgeOrder_h
+#define cCellAgeOrder_h
+
+#include "apto/core/Array.h"
+
+
+// cCellAgeOrder keeps the occupied cells of the population in a doubly linked list ordered by a birth stamp, eldest
+// first.  The stamp is the update at which the occupant's age was last zero, so it does not change as ages advance
+// together and a newborn always belongs at the end of the list, making the usual insertion constant time.
+//
+// List nodes are slots rather than cells; every cell owns exactly one slot, which lets two cells exchange occupants
+// (and their places in the order) by exchanging slots.
+
+class cCellAgeOrder
+{
+private:
+  Apto::Array<int> m_cell_slot;   // slot owned by each cell
+  Apto::Array<int> m_slot_cell;   // cell owning each slot
+  Apto::Array<int> m_prev;        // previous (older) slot, -1 at the head
+  Apto::Array<int> m_next;        // next (younger) slot, -1 at the tail
+  Apto::Array<int> m_stamp;       // birth stamp of each linked slot
+  Apto::Array<bool> m_linked;
+  int m_head;
+  int m_tail;
+  int m_size;
+
+  void link(int slot, int stamp);
+  void unlink(int slot);
+
+
+public:
+  cCellAgeOrder() : m_head(-1), m_tail(-1), m_size(0) { ; }
+
+  // Start over with num_cells cells, none of them in the order
+  void Setup(int num_cells);
+
+  inline int GetSize() const { return m_size; }
+  inline bool Contains(int cell_id) const { return m_linked[m_cell_slot[cell_id]]; }
+  inline int GetStamp(int cell_id) const { return m_stamp[m_cell_slot[cell_id]]; }
+
+  // Add a cell, placed after every cell whose stamp is not greater
+  void Insert(int cell_id, int stamp);
+  void Remove(int cell_id);
+
+  // The contents of two cells were exchanged
+  void Swap(int cell_id1, int cell_id2);
+
+  // Walk from the eldest cell; both return -1 past the end
+  inline int GetEldest() const { return (m_head == -1) ? -1 : m_slot_cell[m_head]; }
+  inline int GetNext(int cell_id) const;
+};
+
+
+inline int cCellAgeOrder::GetNext(int cell_id) const
+{
+  const int next = m_next[m_cell_slot[cell_id]];
+  return (next == -1) ? -1 : m_slot_cell[next];
+}
+
+#endif
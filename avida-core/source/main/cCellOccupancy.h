@@ -0,0 +1,152 @@
+/*
+ *  cCellOccupancy.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCellOccupancy_h
+#define cCellOccupancy_h
+
+#include "apto/core/Array.h"
+
+#include <cassert>
+
+class cOrganism;
+
+
+// cCellOccupancy mirrors, in dense arrays indexed by cell id, which cells of the population are occupied, by whom,
+// and the merit each cell was last scheduled with.  Scans over the whole population can then read a bitset a word
+// at a time, skipping empty stretches of cells, rather than touching every cPopulationCell.
+
+class cCellOccupancy
+{
+private:
+  enum { WORD_BITS = 32 };
+
+  Apto::Array<unsigned int> m_bits;
+  Apto::Array<cOrganism*> m_orgs;
+  Apto::Array<double> m_merits;   // zero for empty cells
+  int m_version;                  // bumped whenever a cell changes occupant
+
+  static inline int lowestBit(unsigned int word);
+
+
+public:
+  cCellOccupancy() : m_version(0) { ; }
+
+  // Start over with num_cells empty cells
+  inline void Setup(int num_cells);
+
+  inline int GetSize() const { return m_orgs.GetSize(); }
+  inline bool IsOccupied(int cell_id) const { return (m_bits[cell_id / WORD_BITS] >> (cell_id % WORD_BITS)) & 1u; }
+  inline cOrganism* GetOrganism(int cell_id) const { return m_orgs[cell_id]; }
+  inline double GetMerit(int cell_id) const { return m_merits[cell_id]; }
+  inline int GetVersion() const { return m_version; }
+
+  inline void Insert(int cell_id, cOrganism* org);
+  inline void Remove(int cell_id);   // also clears the merit
+  inline void SetMerit(int cell_id, double merit) { m_merits[cell_id] = merit; }
+
+  // The contents of two cells were exchanged; their merits are set again as they are rescheduled
+  inline void Swap(int cell_id1, int cell_id2);
+
+  // First occupied cell at or after cell_id, or -1 if there is none
+  inline int NextOccupied(int cell_id) const;
+
+  // Sum of the merits of all cells
+  inline double GetTotalMerit() const;
+};
+
+
+inline int cCellOccupancy::lowestBit(unsigned int word)
+{
+  assert(word);
+#ifdef __GNUC__
+  return __builtin_ctz(word);
+#else
+  int bit = 0;
+  while (!(word & 1u)) { word >>= 1; bit++; }
+  return bit;
+#endif
+}
+
+inline void cCellOccupancy::Setup(int num_cells)
+{
+  m_bits.Resize((num_cells + WORD_BITS - 1) / WORD_BITS);
+  m_orgs.Resize(num_cells);
+  m_merits.Resize(num_cells);
+  m_version++;
+  for (int i = 0; i < m_bits.GetSize(); i++) m_bits[i] = 0;
+  for (int i = 0; i < num_cells; i++) {
+    m_orgs[i] = NULL;
+    m_merits[i] = 0.0;
+  }
+}
+
+inline void cCellOccupancy::Insert(int cell_id, cOrganism* org)
+{
+  assert(org != NULL);
+  m_bits[cell_id / WORD_BITS] |= (1u << (cell_id % WORD_BITS));
+  m_orgs[cell_id] = org;
+  m_version++;
+}
+
+inline void cCellOccupancy::Remove(int cell_id)
+{
+  m_bits[cell_id / WORD_BITS] &= ~(1u << (cell_id % WORD_BITS));
+  m_orgs[cell_id] = NULL;
+  m_merits[cell_id] = 0.0;
+  m_version++;
+}
+
+inline void cCellOccupancy::Swap(int cell_id1, int cell_id2)
+{
+  cOrganism* org1 = m_orgs[cell_id1];
+  cOrganism* org2 = m_orgs[cell_id2];
+  const unsigned int mask1 = 1u << (cell_id1 % WORD_BITS);
+  const unsigned int mask2 = 1u << (cell_id2 % WORD_BITS);
+
+  if (org2) m_bits[cell_id1 / WORD_BITS] |= mask1;
+  else m_bits[cell_id1 / WORD_BITS] &= ~mask1;
+  if (org1) m_bits[cell_id2 / WORD_BITS] |= mask2;
+  else m_bits[cell_id2 / WORD_BITS] &= ~mask2;
+  m_orgs[cell_id1] = org2;
+  m_orgs[cell_id2] = org1;
+  m_version++;
+}
+
+inline int cCellOccupancy::NextOccupied(int cell_id) const
+{
+  if (cell_id >= m_orgs.GetSize()) return -1;
+
+  int word_id = cell_id / WORD_BITS;
+  unsigned int word = m_bits[word_id] & (~0u << (cell_id % WORD_BITS));
+  while (!word) {
+    if (++word_id == m_bits.GetSize()) return -1;
+    word = m_bits[word_id];
+  }
+  return word_id * WORD_BITS + lowestBit(word);
+}
+
+inline double cCellOccupancy::GetTotalMerit() const
+{
+  double total = 0.0;
+  for (int i = 0; i < m_merits.GetSize(); i++) total += m_merits[i];
+  return total;
+}
+
+#endif
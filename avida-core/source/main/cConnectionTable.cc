@@ -0,0 +1,158 @@
+/*
+ *  cConnectionTable.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cConnectionTable.h"
+
+
+void cConnectionTable::Setup(cPopulationCell* cells, int num_cells)
+{
+  m_cells = cells;
+  m_pool.Resize(0);
+  m_start.Resize(num_cells);
+  m_capacity.Resize(num_cells);
+  m_degree.Resize(num_cells);
+  m_facing.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_start[i] = 0;
+    m_capacity[i] = 0;
+    m_degree[i] = 0;
+    m_facing[i] = 0;
+  }
+  m_unused = 0;
+}
+
+
+void cConnectionTable::Compact()
+{
+  int total = 0;
+  for (int i = 0; i < m_degree.GetSize(); i++) total += m_degree[i];
+
+  Apto::Array<int, Apto::Smart> pool;
+  pool.Resize(total);
+  int next = 0;
+  for (int i = 0; i < m_start.GetSize(); i++) {
+    for (int j = 0; j < m_degree[i]; j++) pool[next + j] = m_pool[m_start[i] + j];
+    m_start[i] = next;
+    m_capacity[i] = m_degree[i];
+    next += m_degree[i];
+  }
+  m_pool = pool;
+  m_unused = 0;
+}
+
+
+void cConnectionTable::AddEdges(int first_cell, int num_cells, const Apto::Array<int, Apto::Smart>& edges)
+{
+  assert(edges.GetSize() % 2 == 0);
+
+  for (int i = first_cell; i < first_cell + num_cells; i++) {
+    assert(m_degree[i] == 0);
+    m_unused += m_capacity[i];
+    m_capacity[i] = 0;
+  }
+  for (int e = 0; e < edges.GetSize(); e++) m_capacity[first_cell + edges[e]]++;
+
+  // One block at the end of the pool holds every new slice, in cell order
+  int next = m_pool.GetSize();
+  m_pool.Resize(next + edges.GetSize());
+  for (int i = first_cell; i < first_cell + num_cells; i++) {
+    m_start[i] = next;
+    m_facing[i] = 0;
+    next += m_capacity[i];
+  }
+
+  // Later edges go in front of earlier ones, so slices fill from their ends
+  for (int e = 0; e < edges.GetSize(); e += 2) {
+    const int u = first_cell + edges[e];
+    const int v = first_cell + edges[e + 1];
+    m_degree[u]++;
+    m_degree[v]++;
+    m_pool[m_start[u] + m_capacity[u] - m_degree[u]] = v;
+    m_pool[m_start[v] + m_capacity[v] - m_degree[v]] = u;
+  }
+}
+
+
+int cConnectionTable::Find(int cell_id, int neighbor_id) const
+{
+  for (int pos = 0; pos < m_degree[cell_id]; pos++) {
+    if (m_pool[slot(cell_id, pos)] == neighbor_id) return pos;
+  }
+  return -1;
+}
+
+
+void cConnectionTable::InsertFront(int cell_id, int neighbor_id)
+{
+  if (m_degree[cell_id] == m_capacity[cell_id]) grow(cell_id);
+
+  // The new neighbor takes the faced position, everything from there on moves up one
+  const int start = m_start[cell_id];
+  const int facing = m_facing[cell_id];
+  for (int j = m_degree[cell_id]; j > facing; j--) m_pool[start + j] = m_pool[start + j - 1];
+  m_pool[start + facing] = neighbor_id;
+  m_degree[cell_id]++;
+}
+
+
+void cConnectionTable::InsertRear(int cell_id, int neighbor_id)
+{
+  // Just before the faced neighbor is the end of the circular order
+  InsertFront(cell_id, neighbor_id);
+  Rotate(cell_id, 1);
+}
+
+
+bool cConnectionTable::Remove(int cell_id, int neighbor_id)
+{
+  const int pos = Find(cell_id, neighbor_id);
+  if (pos == -1) return false;
+
+  const int start = m_start[cell_id];
+  const int offset = slot(cell_id, pos) - start;
+  const int degree = --m_degree[cell_id];
+  for (int j = offset; j < degree; j++) m_pool[start + j] = m_pool[start + j + 1];
+
+  // Keep facing the same neighbor, or its successor when it was the one removed
+  int& facing = m_facing[cell_id];
+  if (offset < facing) facing--;
+  if (facing >= degree) facing = 0;
+  return true;
+}
+
+
+void cConnectionTable::grow(int cell_id)
+{
+  // Reclaim the space left by earlier moves once it would make up most of the pool
+  if (m_unused + m_capacity[cell_id] > m_pool.GetSize() / 2) Compact();
+
+  const int degree = m_degree[cell_id];
+  const int capacity = (m_capacity[cell_id] < 4) ? 8 : m_capacity[cell_id] * 2;
+
+  // Move the slice to the end of the pool, straightening it out so that the faced neighbor comes first
+  const int new_start = m_pool.GetSize();
+  m_pool.Resize(new_start + capacity);
+  for (int pos = 0; pos < degree; pos++) m_pool[new_start + pos] = m_pool[slot(cell_id, pos)];
+
+  m_unused += m_capacity[cell_id];
+  m_start[cell_id] = new_start;
+  m_capacity[cell_id] = capacity;
+  m_facing[cell_id] = 0;
+}
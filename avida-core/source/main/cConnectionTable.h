@@ -0,0 +1,130 @@
+/*
+ *  cConnectionTable.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cConnectionTable_h
+#define cConnectionTable_h
+
+#include "apto/core/Array.h"
+
+#include <cassert>
+
+class cPopulationCell;
+
+
+// cConnectionTable holds the neighbor ids of every cell of the population in one flat array, each cell owning a
+// contiguous slice of it (compressed sparse row).  Rather than rotating a list, the cell being faced is kept as an
+// index into the slice, and neighbors are numbered from it, so neighbor 0 is always the faced cell.
+//
+// Slices that outgrow their capacity are moved to the end of the array, which keeps the incremental construction
+// done by the topology builders cheap; Compact() then packs the slices in cell order once the topology is built.
+
+class cConnectionTable
+{
+private:
+  cPopulationCell* m_cells;
+  Apto::Array<int, Apto::Smart> m_pool;   // neighbor ids, one slice per cell
+  Apto::Array<int> m_start;               // first position of the slice of each cell
+  Apto::Array<int> m_capacity;
+  Apto::Array<int> m_degree;
+  Apto::Array<int> m_facing;              // slice offset of the faced neighbor
+  int m_unused;                           // pool positions left behind by moved slices
+
+  void grow(int cell_id);
+  inline int slot(int cell_id, int pos) const;
+
+
+public:
+  cConnectionTable() : m_cells(NULL), m_unused(0) { ; }
+
+  // Start over with num_cells unconnected cells, stored contiguously from cells
+  void Setup(cPopulationCell* cells, int num_cells);
+
+  // Pack every slice tightly, in cell order
+  void Compact();
+
+  // Connect the num_cells still unconnected cells starting at first_cell by the edges in edges, each a pair of
+  // positions relative to first_cell, with their slices laid out in a single pass.  The neighbors of each cell are
+  // ordered as if every edge had been added in turn with InsertFront from both ends.
+  void AddEdges(int first_cell, int num_cells, const Apto::Array<int, Apto::Smart>& edges);
+
+  inline cPopulationCell* GetCells() const { return m_cells; }
+
+  inline int GetSize(int cell_id) const { return m_degree[cell_id]; }
+  inline int GetNeighborID(int cell_id, int pos) const { return m_pool[slot(cell_id, pos)]; }
+  inline int GetFacedID(int cell_id) const { return m_degree[cell_id] ? m_pool[m_start[cell_id] + m_facing[cell_id]] : -1; }
+  int Find(int cell_id, int neighbor_id) const;
+
+  // Turn to face the next (by > 0) or previous (by < 0) neighbors
+  inline void Rotate(int cell_id, int by);
+
+  // Add a neighbor, either as the faced neighbor or as the last one before it
+  void InsertFront(int cell_id, int neighbor_id);
+  void InsertRear(int cell_id, int neighbor_id);
+  bool Remove(int cell_id, int neighbor_id);
+};
+
+
+// cConnectionList is the view of one cell's neighbors handed out by cPopulationCell::ConnectionList().  Positions
+// count from the faced neighbor, as with the lists the topology code and instructions were written against.
+
+class cConnectionList
+{
+private:
+  cConnectionTable* m_table;
+  int m_cell_id;
+
+public:
+  cConnectionList(cConnectionTable* table, int cell_id) : m_table(table), m_cell_id(cell_id) { ; }
+
+  inline int GetSize() const { return m_table ? m_table->GetSize(m_cell_id) : 0; }
+  inline int GetFirstID() const { return m_table ? m_table->GetFacedID(m_cell_id) : -1; }
+  inline int GetIDAt(int pos) const { return m_table->GetNeighborID(m_cell_id, pos); }
+
+  inline cPopulationCell* GetFirst() const;
+  inline cPopulationCell* GetPos(int pos) const;
+  inline cPopulationCell* FindPtr(cPopulationCell* cell) const;
+
+  inline void CircNext() { if (m_table) m_table->Rotate(m_cell_id, 1); }
+  inline void CircPrev() { if (m_table) m_table->Rotate(m_cell_id, -1); }
+
+  inline void Push(cPopulationCell* cell);
+  inline void PushRear(cPopulationCell* cell);
+  inline void Remove(cPopulationCell* cell);
+};
+
+
+inline int cConnectionTable::slot(int cell_id, int pos) const
+{
+  assert(pos >= 0 && pos < m_degree[cell_id]);
+  int offset = m_facing[cell_id] + pos;
+  if (offset >= m_degree[cell_id]) offset -= m_degree[cell_id];
+  return m_start[cell_id] + offset;
+}
+
+inline void cConnectionTable::Rotate(int cell_id, int by)
+{
+  const int degree = m_degree[cell_id];
+  if (!degree) return;
+  int facing = (m_facing[cell_id] + by) % degree;
+  if (facing < 0) facing += degree;
+  m_facing[cell_id] = facing;
+}
+
+#endif
@@ -3,6 +3,26 @@
 using namespace std;
 
 
+void cContextPhenotype::SetupCounts(int number_tasks, int number_reactions)
+{
+    // Size the count arrays without adding to them, as AddTaskCounts and AddReactionCounts would with empty counts
+    if(m_number_tasks != number_tasks) {
+      m_cur_task_count.ResizeClear(number_tasks);
+      for(int count=0;count<number_tasks;count++) {
+        m_cur_task_count[count] = 0;
+      }
+      m_number_tasks = number_tasks;
+    }
+    if(m_number_reactions != number_reactions) {
+      m_cur_reaction_count.ResizeClear(number_reactions);
+      for(int count=0;count<number_reactions;count++) {
+        m_cur_reaction_count[count] = 0;
+      }
+      m_number_reactions = number_reactions;
+    }
+}
+
+
 void cContextPhenotype::AddTaskCounts(int number_tasks, Apto::Array<int>& cur_task_count)
 {
     // Step 1: Resize m_cur_thread_task_count array if necessary.  This is necessary
@@ -27,17 +27,15 @@
 
 #include <climits>
 
-#ifndef tList_h
-#include "tList.h"
-#endif
+#include "tArrayList.h"
 
 class cReaction;
 
 class cContextReactionRequisite
 {
 private:
-  tList<cReaction> prior_reaction_list;
-  tList<cReaction> prior_noreaction_list;
+  tArrayList<cReaction> prior_reaction_list;
+  tArrayList<cReaction> prior_noreaction_list;
   int min_task_count;
   int max_task_count;
   int min_reaction_count;
@@ -57,8 +55,8 @@ public:
 	  min_tot_reaction_count(0), max_tot_reaction_count(INT_MAX), divide_only(0), parasite_only(0) { ; }
   ~cContextReactionRequisite() { ; }
 
-  const tList<cReaction>& GetReactions() const { return prior_reaction_list; }
-  const tList<cReaction>& GetNoReactions() const { return prior_noreaction_list; }
+  const tArrayList<cReaction>& GetReactions() const { return prior_reaction_list; }
+  const tArrayList<cReaction>& GetNoReactions() const { return prior_noreaction_list; }
   int GetMinTaskCount() const { return min_task_count; }
   int GetMaxTaskCount() const { return max_task_count; }
   int GetMinReactionCount() const { return min_reaction_count; }
@@ -148,6 +148,9 @@ cDeme& cDeme::operator=(const cDeme& in_deme)
   last_org_task_count                 = in_deme.last_org_task_count;
   last_org_task_exe_count             = in_deme.last_org_task_exe_count;
   last_org_reaction_count             = in_deme.last_org_reaction_count;
+  m_live_task_count                   = in_deme.m_live_task_count;
+  m_live_task_exe_count               = in_deme.m_live_task_exe_count;
+  m_live_reaction_count               = in_deme.m_live_reaction_count;
   avg_founder_generation              = in_deme.avg_founder_generation;
   generations_per_lifetime            = in_deme.generations_per_lifetime;
   _germline                           = in_deme._germline;
@@ -231,6 +234,12 @@ void cDeme::Setup(int id, const Apto::Array<int> & in_cells, int in_width, cWorl
   last_org_task_exe_count.SetAll(0);
   last_org_reaction_count.ResizeClear(num_reactions);
   last_org_reaction_count.SetAll(0);
+  m_live_task_count.ResizeClear(num_tasks);
+  m_live_task_count.SetAll(0);
+  m_live_task_exe_count.ResizeClear(num_tasks);
+  m_live_task_exe_count.SetAll(0);
+  m_live_reaction_count.ResizeClear(num_reactions);
+  m_live_reaction_count.SetAll(0);
   m_total_res_consumed = 0;
   m_switch_penalties = 0;
   m_num_active = 0;
@@ -620,12 +629,12 @@ void cDeme::UpdateGenerationsPerLifetime(double old_avg_founder_generation, Apto
 void cDeme::KillAll(cAvidaContext& ctx) 
 {
   last_org_count = GetOrgCount();
+  cPopulation& pop = m_world->GetPopulation();
+  Apto::Array<int, Apto::Smart> victims;
   for (int i=0; i<GetSize(); ++i) {
-    cPopulationCell& cell = m_world->GetPopulation().GetCell(cell_ids[i]);
-    if(cell.IsOccupied()) {
-      m_world->GetPopulation().KillOrganism(cell, ctx); 
-    }
+    if (pop.GetOccupancy().IsOccupied(cell_ids[i])) victims.Push(cell_ids[i]);
   }
+  pop.KillOrganisms(victims, ctx);
 
   // HACK: organism are killed after DivideReset is called.
   // need clear a deme before it is reset.
@@ -636,38 +645,23 @@ void cDeme::UpdateStats()
 {
   //save stats about what tasks our orgs were doing
   //usually called before KillAll
-  
-  for (int j = 0; j < cur_org_task_count.GetSize(); j++) {
-    int count = 0;
-    for (int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += (m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastTaskCount()[j] > 0);
-      }
-      cur_org_task_count[j] = count; 
-    }
-  }
-  
-  for(int j = 0; j < cur_org_task_exe_count.GetSize(); j++) {
-    int count = 0;
-    for(int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastTaskCount()[j];
-      }
-      cur_org_task_exe_count[j] = count; 
-    }
+  cur_org_task_count = m_live_task_count;
+  cur_org_task_exe_count = m_live_task_exe_count;
+  cur_org_reaction_count = m_live_reaction_count;
+}
+
+
+void cDeme::adjustOrgTotals(const cPhenotype& phenotype, int sign)
+{
+  const Apto::Array<int>& task_count = phenotype.GetLastTaskCount();
+  for (int j = 0; j < m_live_task_count.GetSize(); j++) {
+    m_live_task_count[j] += sign * (task_count[j] > 0);
+    m_live_task_exe_count[j] += sign * task_count[j];
   }
   
-  for(int j = 0; j < cur_org_reaction_count.GetSize(); j++) {
-    int count = 0;
-    for(int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastReactionCount()[j];
-      }
-      cur_org_reaction_count[j] = count; 
-    }
+  const Apto::Array<int>& reaction_count = phenotype.GetLastReactionCount();
+  for (int j = 0; j < m_live_reaction_count.GetSize(); j++) {
+    m_live_reaction_count[j] += sign * reaction_count[j];
   }
 }
 
@@ -741,6 +735,7 @@ void cDeme::SetupDemeRes(int id, cResource * res, int verbosity, cWorld* world)
                             res->GetMinSize(), res->GetMaxSize(), res->GetConfig(), res->GetCount(), res->GetResistance(), res->GetDamage(),
                             res->GetDeathOdds(), res->IsPath(), res->IsHammer(), res->GetInitialPlatVal(), res->GetThreshold(), res->GetRefuge(), res->GetGradient()
                             ); 
+  deme_resource_count.SetSpatialInterval(id, res->GetSpatialInterval(), res->GetFlowTolerance());
   
   if(res->GetEnergyResource()) {
     energy_res_ids.Push(id);
@@ -754,14 +749,11 @@ double cDeme::GetCellEnergy(int absolute_cell_id, cAvidaContext& ctx) const
 
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   // sum all energy resources
   for (int i = 0; i < energy_res_ids.GetSize(); i++) {
-    if (cell_resources[energy_res_ids[i]] > 0.0) {
-      total_energy += cell_resources[energy_res_ids[i]];
-      cell_resources[energy_res_ids[i]] *= -1.0;
-    }
+    double cell_energy = deme_resource_count.GetCellResVal(ctx, relative_cell_id, energy_res_ids[i]);
+    if (cell_energy > 0.0) total_energy += cell_energy;
   }
 
   return total_energy;
@@ -774,19 +766,16 @@ double cDeme::GetAndClearCellEnergy(int absolute_cell_id, cAvidaContext& ctx)
   
   double total_energy = 0.0;
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
-  // sum all energy resources
+  // sum all energy resources, setting each to zero; other deme resources in the cell are left alone
   for (int i = 0; i < energy_res_ids.GetSize(); i++) {
-    if (cell_resources[energy_res_ids[i]] > 0.0) {
-      total_energy += cell_resources[energy_res_ids[i]];
-      cell_resources[energy_res_ids[i]] *= -1.0;
+    double cell_energy = deme_resource_count.GetCellResVal(ctx, relative_cell_id, energy_res_ids[i]);
+    if (cell_energy > 0.0) {
+      total_energy += cell_energy;
+      deme_resource_count.ModifyCell(ctx, energy_res_ids[i], -cell_energy, relative_cell_id);
     }
   }
 
-  // set energy resources to zero
-  deme_resource_count.ModifyCell(ctx, cell_resources, relative_cell_id);
-
   return total_energy;
 }
 
@@ -796,15 +785,13 @@ void cDeme::GiveBackCellEnergy(int absolute_cell_id, double value, cAvidaContext
   assert(absolute_cell_id <= cell_ids[cell_ids.GetSize()-1]);
   
   int relative_cell_id = GetRelativeCellID(absolute_cell_id);
-  Apto::Array<double> cell_resources = deme_resource_count.GetCellResources(relative_cell_id, ctx);
   
   double amount_per_resource = value / energy_res_ids.GetSize();
   
   // put back energy resources evenly
   for(int i = 0; i < energy_res_ids.GetSize(); i++) {
-    cell_resources[energy_res_ids[i]] += amount_per_resource;
+    deme_resource_count.ModifyCell(ctx, energy_res_ids[i], amount_per_resource, relative_cell_id);
   }
-  deme_resource_count.ModifyCell(ctx, cell_resources, relative_cell_id);
 }
 
 void cDeme::SetCellEvent(int x1, int y1, int x2, int y2,
@@ -105,6 +105,11 @@ private:
   Apto::Array<int> last_org_task_count;
   Apto::Array<int> last_org_task_exe_count;
   Apto::Array<int> last_org_reaction_count;
+
+  // Running totals over the organisms living in the deme, UpdateStats() snapshots them into the cur_org_* counts
+  Apto::Array<int> m_live_task_count;      //!< Organisms whose last gestation performed each task
+  Apto::Array<int> m_live_task_exe_count;  //!< Last gestation task executions, summed over the organisms
+  Apto::Array<int> m_live_reaction_count;  //!< Last gestation reaction counts, summed over the organisms
   
   double avg_founder_generation;  //Average generation of current founders                                    
   double generations_per_lifetime; //Generations between current founders and founders of parent  
@@ -138,6 +143,8 @@ private:
 	unsigned int migrations_out; 
 	unsigned int migrations_in;
 	unsigned int suicides;
+  
+  void adjustOrgTotals(const cPhenotype& phenotype, int sign);
 	
 public:
 	//! Constructor.
@@ -186,6 +193,11 @@ public:
   void IncOrgCount() { cur_org_count++; }
   void DecOrgCount() { cur_org_count--; }
 
+  //! Add or remove an organism's last gestation task and reaction counts from the running totals.  cPopulation
+  //! calls these as organisms enter and leave the deme, and around phenotype roll overs (divide, new trial).
+  void AddOrgTotals(const cPhenotype& phenotype) { adjustOrgTotals(phenotype, 1); }
+  void RemoveOrgTotals(const cPhenotype& phenotype) { adjustOrgTotals(phenotype, -1); }
+
   int GetSleepingCount() const { return sleeping_count; }
   void IncSleepingCount() { sleeping_count++; }
   void DecSleepingCount() { sleeping_count--; }
@@ -275,6 +287,10 @@ public:
   void SetupDemeRes(int id, cResource * res, int verbosity, cWorld* world);                 
   void UpdateDemeRes(cAvidaContext& ctx) { deme_resource_count.GetResources(ctx); } 
   void Update(double time_step) { deme_resource_count.Update(time_step); }
+  
+  //! Share the population step clock; the deme resources catch up to it whenever they are accessed.
+  void SetStepTimeSource(const double* step_time) { deme_resource_count.SetStepTimeSource(step_time); }
+  void FlushStepTime() { deme_resource_count.FlushStepTime(); }
   int GetRelativeCellID(int absolute_cell_id) const { return absolute_cell_id % GetSize(); } //!< assumes all demes are the same size
   int GetAbsoluteCellID(int relative_cell_id) const { return relative_cell_id + (_id * GetSize()); } //!< assumes all demes are the same size
 	
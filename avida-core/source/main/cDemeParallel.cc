@@ -0,0 +1,310 @@
+/*
+ *  cDemeParallel.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDemeParallel.h"
+
+#include "apto/platform.h"
+#include "apto/rng.h"
+
+#include "cAvidaConfig.h"
+#include "cAvidaContext.h"
+#include "cDeme.h"
+#include "cHardwareBase.h"
+#include "cNUMAPlacement.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cWorld.h"
+
+
+cDemeParallel::cDemeParallel(cWorld* world, cPopulation* pop, int num_threads, const double* pop_step_time)
+: m_world(world), m_pop(pop), m_pop_step_time(pop_step_time)
+, m_count_cells(world->GetConfig().SLICING_METHOD.Get() == SLICE_CONSTANT ||
+                world->GetConfig().SLICING_METHOD.Get() == SLICE_PROB_DEMESIZE_PROB_MERIT)
+, m_equal_demes(world->GetConfig().SLICING_METHOD.Get() == SLICE_DEME_PROB_MERIT)
+, m_numa(NULL), m_pass(0), m_demes_done(0), m_terminate(false)
+{
+  const int num_demes = m_pop->GetNumDemes();
+
+  // Schedulers and streams are seeded from the master RNG in deme order
+  m_demes.Resize(num_demes);
+  m_clock.Resize(num_demes);
+  m_clock.SetAll(0.0);
+  for (int i = 0; i < num_demes; i++) {
+    sDemeState& deme = m_demes[i];
+    deme.scheduler = m_pop->CreateScheduler(m_pop->GetDeme(i).GetSize());
+    deme.rng = new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed()));
+    deme.budget = 0;
+    deme.used = 0;
+    deme.clock_step = 0.0;
+    deme.pending = -1;
+    deme.parallel_steps = 0;
+    m_pop->GetDeme(i).SetStepTimeSource(&m_clock[i]);
+  }
+
+  m_priority.Resize(m_pop->GetSize());
+  m_priority.SetAll(0.0);
+
+  if (num_threads < 0) num_threads = Apto::Platform::AvailableCPUs();
+  if (num_threads > num_demes) num_threads = num_demes;
+
+  if (num_threads > 1 && m_world->GetConfig().NUMA_PLACEMENT.Get()) {
+    m_numa = new cNUMAPlacement;
+    if (m_numa->GetNumNodes() < 2) {
+      delete m_numa;
+      m_numa = NULL;
+    }
+  }
+
+  const int num_nodes = (m_numa) ? m_numa->GetNumNodes() : 1;
+  m_node_first.Resize(num_nodes + 1);
+  m_node_first.SetAll(num_demes);
+  for (int i = num_demes - 1; i >= 0; i--) m_node_first[(m_numa) ? m_numa->NodeOf(i, num_demes) : 0] = i;
+  for (int node = num_nodes - 1; node >= 0; node--) {
+    if (m_node_first[node] > m_node_first[node + 1]) m_node_first[node] = m_node_first[node + 1];
+  }
+  m_node_next.Resize(num_nodes);
+  m_node_next.SetAll(num_demes);
+
+  if (num_threads > 1) {
+    m_workers.Resize(num_threads);
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i] = new cWorker(this, (m_numa) ? m_numa->NodeOf(i, num_threads) : 0);
+      m_workers[i]->Start();
+    }
+  }
+}
+
+cDemeParallel::~cDemeParallel()
+{
+  m_mutex.Lock();
+  m_terminate = true;
+  m_pass++;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+
+  for (int i = 0; i < m_demes.GetSize(); i++) {
+    m_pop->GetDeme(i).SetStepTimeSource(m_pop_step_time);
+    delete m_demes[i].scheduler;
+    delete m_demes[i].rng;
+  }
+
+  delete m_numa;
+}
+
+
+void cDemeParallel::GetCellNodes(Apto::Array<int>& cell_node) const
+{
+  cell_node.Resize(m_pop->GetSize());
+  cell_node.SetAll(0);
+  if (!m_numa) return;
+
+  for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) {
+    const cDeme& deme = m_pop->GetDeme(deme_id);
+    const int node = m_numa->NodeOf(deme_id, m_demes.GetSize());
+    for (int i = 0; i < deme.GetSize(); i++) cell_node[deme.GetCellID(i)] = node;
+  }
+}
+
+
+void cDemeParallel::AdjustPriority(int deme_id, int cell_id, double priority)
+{
+  m_priority[cell_id] = priority;
+  m_demes[deme_id].scheduler->AdjustPriority(m_pop->GetDeme(deme_id).GetRelativeCellID(cell_id), priority);
+}
+
+
+// Share of the population schedule held by a deme: its scheduled merit, its number of scheduled cells, or one for
+// every deme with a scheduled cell (SLICING_METHOD 3, where demes receive equal cycles)
+double cDemeParallel::demeWeight(int deme_id) const
+{
+  const cDeme& deme = m_pop->GetDeme(deme_id);
+  double weight = 0.0;
+  for (int i = 0; i < deme.GetSize(); i++) {
+    const double priority = m_priority[deme.GetCellID(i)];
+    if (priority <= 0.0) continue;
+    if (m_equal_demes) return 1.0;
+    weight += (m_count_cells) ? 1.0 : priority;
+  }
+  return weight;
+}
+
+
+int cDemeParallel::Execute(int update_size)
+{
+  if (update_size <= 0) return 0;
+  const double step_size = 1.0 / (double)update_size;
+
+  // Split the update between the demes in proportion to their share of the population schedule.  Rounding the
+  // cumulative share keeps the budgets summing to update_size exactly.
+  double total_weight = 0.0;
+  for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) total_weight += demeWeight(deme_id);
+
+  double cum_weight = 0.0;
+  int prev_end = 0;
+  for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) {
+    cum_weight += demeWeight(deme_id);
+    const int end = (total_weight > 0.0) ? (int)(update_size * (cum_weight / total_weight) + 0.5) : 0;
+
+    sDemeState& state = m_demes[deme_id];
+    state.budget = end - prev_end;
+    state.used = 0;
+    state.clock_step = (state.budget) ? (1.0 / (double)state.budget) : 0.0;
+    state.pending = -1;
+    prev_end = end;
+  }
+
+  int parallel_steps = 0;
+  while (true) {
+    runPass();
+
+    // Barrier: the steps that reach shared state run here, one deme at a time
+    bool any_pending = false;
+    for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) {
+      sDemeState& state = m_demes[deme_id];
+      parallel_steps += state.parallel_steps;
+      if (state.pending < 0) continue;
+
+      const int cell_id = state.pending;
+      state.pending = -1;
+      state.used++;
+      any_pending = true;
+
+      // An earlier deme at this barrier may have replaced or emptied the cell (migration, deme replication)
+      if (!m_pop->GetCell(cell_id).IsOccupied()) continue;
+
+      cAvidaContext ctx(&m_world->GetDriver(), state.rng);
+      m_pop->ProcessStep(ctx, step_size, cell_id);
+      m_clock[deme_id] += state.clock_step;
+    }
+    if (!any_pending) break;
+  }
+
+  // Every deme's resources see the whole update, including demes that had nothing to run
+  m_clock.SetAll(1.0);
+
+  return parallel_steps;
+}
+
+
+void cDemeParallel::runPass()
+{
+  if (m_workers.GetSize()) {
+    m_mutex.Lock();
+    for (int node = 0; node < m_node_next.GetSize(); node++) m_node_next[node] = m_node_first[node];
+    m_demes_done = 0;
+    m_pass++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+
+    m_mutex.Lock();
+    while (m_demes_done < m_demes.GetSize()) m_done_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  } else {
+    for (int i = 0; i < m_demes.GetSize(); i++) runDeme(i);
+  }
+}
+
+
+void cDemeParallel::runDeme(int deme_id)
+{
+  sDemeState& state = m_demes[deme_id];
+  state.parallel_steps = 0;
+  if (state.used >= state.budget) return;
+
+  cDeme& deme = m_pop->GetDeme(deme_id);
+  cAvidaContext ctx(&m_world->GetDriver(), state.rng);
+
+  while (state.used < state.budget) {
+    const int local_id = state.scheduler->Next();
+
+    // Nothing left alive in this deme, the rest of its share is forfeit
+    if (local_id < 0) {
+      state.used = state.budget;
+      break;
+    }
+
+    const int cell_id = deme.GetAbsoluteCellID(local_id);
+    cPopulationCell& cell = m_pop->GetCell(cell_id);
+    assert(cell.IsOccupied());
+    cHardwareBase* hw = cell.GetHardware();
+
+    // A stalled instruction has not been executed, it is handed to the barrier as this deme's next step
+    if (!hw->SupportsConcurrentSpeculative() || !hw->SingleProcess(ctx, true)) {
+      state.pending = cell_id;
+      break;
+    }
+
+    deme.IncTimeUsed(cell.GetOrganism()->GetPhenotype().GetMerit().GetDouble());
+    state.used++;
+    state.parallel_steps++;
+    m_clock[deme_id] += state.clock_step;
+  }
+}
+
+
+// Claim the next deme of node, or of the other nodes once that one is exhausted; -1 when none is left (mutex held)
+int cDemeParallel::claimDeme(int node)
+{
+  for (int i = 0; i < m_node_next.GetSize(); i++) {
+    const int n = (node + i) % m_node_next.GetSize();
+    if (m_node_next[n] < m_node_first[n + 1]) return m_node_next[n]++;
+  }
+  return -1;
+}
+
+
+void cDemeParallel::cWorker::Run()
+{
+  if (m_runner->m_numa) m_runner->m_numa->PinCurrentThread(m_node);
+
+  int last_pass = 0;
+
+  while (1) {
+    m_runner->m_mutex.Lock();
+    while (m_runner->m_pass == last_pass) m_runner->m_cond.Wait(m_runner->m_mutex);
+    last_pass = m_runner->m_pass;
+    m_runner->m_mutex.Unlock();
+
+    if (m_runner->m_terminate) break;
+
+    while (1) {
+      m_runner->m_mutex.Lock();
+      int deme_id = m_runner->claimDeme(m_node);
+      m_runner->m_mutex.Unlock();
+
+      if (deme_id < 0) break;
+
+      m_runner->runDeme(deme_id);
+
+      m_runner->m_mutex.Lock();
+      bool all_done = (++m_runner->m_demes_done == m_runner->m_demes.GetSize());
+      m_runner->m_mutex.Unlock();
+      if (all_done) m_runner->m_done_cond.Signal();
+    }
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ *  cDemeParallel.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDemeParallel_h
+#define cDemeParallel_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+class cNUMAPlacement;
+class cPopulation;
+class cWorld;
+
+
+// cDemeParallel runs every deme as its own sub-simulation during an update.  Each deme owns a scheduler over its cells,
+// an RNG stream and the clock its deme resources integrate against, and receives a share of the update in proportion
+// to its share of the population schedule.  Demes execute on a pool of worker threads until each has either used its
+// share or drawn an organism whose next instruction reaches shared state (the stall instructions of speculative
+// execution: births, kills, movement, ...).  Those steps are then executed serially at a barrier, in deme order,
+// through cPopulation::ProcessStep, which is also where implicit deme replication happens, and the workers are
+// released again until every deme is done.
+//
+// Deme streams are seeded from the master RNG when the runner is built, so a run is reproducible for any thread count.
+// With NUMA_PLACEMENT the demes and workers are split into contiguous blocks per NUMA node; workers run the demes of
+// their own node first and only then help with the demes of other nodes.
+
+class cDemeParallel
+{
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cDemeParallel* m_runner;
+    int m_node;
+
+    void Run();
+
+  public:
+    cWorker(cDemeParallel* runner, int node) : m_runner(runner), m_node(node) { ; }
+  };
+
+  struct sDemeState
+  {
+    Apto::PriorityScheduler* scheduler;  // entries are cell positions within the deme
+    Apto::Random* rng;
+    int budget;           // steps this deme receives during the current update
+    int used;
+    double clock_step;    // clock advance per step, so that the clock reaches 1.0 with the budget
+    int pending;          // cell to be executed serially at the next barrier, -1 if none
+    int parallel_steps;   // steps executed by the workers during the current pass
+  };
+
+  cWorld* m_world;
+  cPopulation* m_pop;
+  const double* m_pop_step_time;
+  bool m_count_cells;                 // weight demes by scheduled cells instead of scheduled merit
+  bool m_equal_demes;                 // every deme with a scheduled cell gets the same weight
+
+  Apto::Array<sDemeState> m_demes;
+  Apto::Array<double> m_clock;        // step time source of each deme's resources
+  Apto::Array<double> m_priority;     // last priority of every cell in the population
+  Apto::Array<cWorker*> m_workers;
+  cNUMAPlacement* m_numa;             // NULL unless NUMA_PLACEMENT is on and there are several nodes
+  Apto::Array<int> m_node_first;      // first deme of each node, plus one past the last deme
+  Apto::Array<int> m_node_next;       // next deme of each node to be claimed during the current pass
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_done_cond;
+
+  volatile int m_pass;        // incremented to release workers for a new pass
+  volatile int m_demes_done;  // number of demes completed during the current pass
+  volatile bool m_terminate;
+
+
+  double demeWeight(int deme_id) const;
+  void runPass();
+  void runDeme(int deme_id);
+  int claimDeme(int node);
+
+  cDemeParallel(); // @not_implemented
+  cDemeParallel(const cDemeParallel&); // @not_implemented
+  cDemeParallel& operator=(const cDemeParallel&); // @not_implemented
+
+public:
+  cDemeParallel(cWorld* world, cPopulation* pop, int num_threads, const double* pop_step_time);
+  ~cDemeParallel();
+
+  int GetNumThreads() const { return (m_workers.GetSize()) ? m_workers.GetSize() : 1; }
+  const cNUMAPlacement* GetNUMA() const { return m_numa; }
+
+  // Node of every population cell under the deme partitioning
+  void GetCellNodes(Apto::Array<int>& cell_node) const;
+
+  void AdjustPriority(int deme_id, int cell_id, double priority);
+
+  // Execute an update of update_size steps, returning the number of steps that ran on the workers (the serial steps
+  // account for themselves in cPopulation::ProcessStep)
+  int Execute(int update_size);
+
+  // Restart the deme clocks once the deme resources have been flushed at the end of an update
+  void ResetClocks() { m_clock.SetAll(0.0); }
+};
+
+#endif
@@ -60,18 +60,22 @@ private:
 	cString compareOperator;
 	double resourceThresholdValue;
 	bool previouslySatisfied;
+	int demeResourceID; // every deme resource count has the same layout, so this is looked up once
 	
 public:
 	cDemeResourceThresholdPredicate(cString resourceName, cString comparisonOperator, double threasholdValue) :
 		demeResourceName(resourceName),
 		compareOperator(comparisonOperator),
 		resourceThresholdValue(threasholdValue),
-		previouslySatisfied(false)
+		previouslySatisfied(false),
+		demeResourceID(-1)
 		{ ; }
 	
 	bool operator()(cAvidaContext& ctx, void* arg) {
 		assert(arg != NULL);
-		double resourceLevel = static_cast<cResourceCount*>(arg)->Get(ctx, static_cast<cResourceCount*>(arg)->GetResourceCountID(demeResourceName));
+		cResourceCount* res_count = static_cast<cResourceCount*>(arg);
+		if (demeResourceID == -1) demeResourceID = res_count->GetResourceCountID(demeResourceName);
+		double resourceLevel = res_count->Get(ctx, demeResourceID);
 
 		if(compareOperator == ">=") {
 			if(resourceLevel >= resourceThresholdValue) {
@@ -0,0 +1,98 @@
+/*
+ *  cDemeScheduler.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDemeScheduler.h"
+
+#include "cFenwickScheduler.h"
+
+#include <cassert>
+
+
+cDemeScheduler::cDemeScheduler(int num_demes, int deme_size, eDemeWeight weight, Apto::SmartPtr<Apto::Random> rng)
+  : m_weight(weight), m_deme_size(deme_size), m_rng(rng), m_members(num_demes), m_is_alive(num_demes * deme_size)
+  , m_num_alive(num_demes), m_live_pos(num_demes), m_demes(NULL)
+{
+  assert(num_demes > 0 && deme_size > 0);
+
+  for (int i = 0; i < num_demes; i++) m_members[i] = new cFenwickScheduler(deme_size, rng);
+  m_is_alive.SetAll(false);
+  m_num_alive.SetAll(0);
+  m_live_pos.SetAll(-1);
+  if (m_weight == DEME_BY_SIZE) m_demes = new cFenwickScheduler(num_demes, rng);
+}
+
+cDemeScheduler::~cDemeScheduler()
+{
+  for (int i = 0; i < m_members.GetSize(); i++) delete m_members[i];
+  delete m_demes;
+}
+
+
+void cDemeScheduler::AdjustPriority(int entry_id, double priority)
+{
+  assert(entry_id >= 0 && entry_id < m_is_alive.GetSize());
+
+  const int deme_id = entry_id / m_deme_size;
+  m_members[deme_id]->AdjustPriority(entry_id - deme_id * m_deme_size, priority);
+
+  const bool alive = (priority > 0.0);
+  if (alive == m_is_alive[entry_id]) return;
+  m_is_alive[entry_id] = alive;
+
+  const int prev_alive = m_num_alive[deme_id];
+  const int num_alive = prev_alive + (alive ? 1 : -1);
+  m_num_alive[deme_id] = num_alive;
+
+  if (m_weight == DEME_BY_SIZE) {
+    m_demes->AdjustPriority(deme_id, num_alive);
+  } else if (prev_alive == 0) {
+    m_live_pos[deme_id] = m_live_demes.GetSize();
+    m_live_demes.Push(deme_id);
+  } else if (num_alive == 0) {
+    // Move the last live deme into the vacated slot
+    const int pos = m_live_pos[deme_id];
+    const int last = m_live_demes[m_live_demes.GetSize() - 1];
+    m_live_demes[pos] = last;
+    m_live_pos[last] = pos;
+    m_live_demes.Resize(m_live_demes.GetSize() - 1);
+    m_live_pos[deme_id] = -1;
+  }
+}
+
+
+int cDemeScheduler::nextDeme()
+{
+  if (m_weight == DEME_BY_SIZE) return m_demes->Next();
+
+  if (m_live_demes.GetSize() == 0) return -1;
+  return m_live_demes[m_rng->GetUInt(m_live_demes.GetSize())];
+}
+
+
+int cDemeScheduler::Next()
+{
+  const int deme_id = nextDeme();
+  if (deme_id < 0) return -1;
+
+  // Every deme drawn has a living member, so its own draw always succeeds
+  const int member = m_members[deme_id]->Next();
+  assert(member >= 0);
+  return deme_id * m_deme_size + member;
+}
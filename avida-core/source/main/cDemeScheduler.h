@@ -0,0 +1,77 @@
+/*
+ *  cDemeScheduler.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDemeScheduler_h
+#define cDemeScheduler_h
+
+#include "avida/core/Types.h"
+
+#include "apto/rng.h"
+
+class cFenwickScheduler;
+
+
+// cDemeScheduler hands out population cells in two steps: a deme is drawn first, then a member of that deme in
+// proportion to its priority (merit), each deme holding a cFenwickScheduler over its own cells.  Demes are the
+// contiguous blocks of deme_size cells that cPopulation lays them out as.
+//
+//   DEME_EQUAL (SLICING_METHOD 3)  - every deme with a living member is equally likely, so demes receive the same
+//                                    share of cycles whatever their size or merit; O(1) deme draw
+//   DEME_BY_SIZE (SLICING_METHOD 4) - demes are drawn in proportion to their number of living (positive priority)
+//                                    members; O(log num_demes) deme draw
+//
+// Deme weights follow every AdjustPriority at once, since only a change in whether a cell is alive moves them.
+
+class cDemeScheduler : public Apto::PriorityScheduler
+{
+public:
+  enum eDemeWeight { DEME_EQUAL, DEME_BY_SIZE };
+
+private:
+  eDemeWeight m_weight;
+  int m_deme_size;
+  Apto::SmartPtr<Apto::Random> m_rng;
+  Apto::Array<cFenwickScheduler*> m_members;  // per deme, entries are positions within the deme
+  Apto::Array<bool> m_is_alive;               // per cell, priority > 0 as last handed in
+  Apto::Array<int> m_num_alive;               // per deme
+
+  // DEME_EQUAL: the demes with a living member, packed, and each deme's position in that list (-1 if absent)
+  Apto::Array<int, Apto::Smart> m_live_demes;
+  Apto::Array<int> m_live_pos;
+
+  // DEME_BY_SIZE: demes weighted by m_num_alive
+  cFenwickScheduler* m_demes;
+
+
+  cDemeScheduler(const cDemeScheduler&); // @not_implemented
+  cDemeScheduler& operator=(const cDemeScheduler&); // @not_implemented
+
+  int nextDeme();
+
+
+public:
+  cDemeScheduler(int num_demes, int deme_size, eDemeWeight weight, Apto::SmartPtr<Apto::Random> rng);
+  ~cDemeScheduler();
+
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
+};
+
+#endif
@@ -31,7 +31,9 @@
 #endif
 
 #if BOOST_IS_AVAILABLE
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include "cDemeTopologyNetwork.h"
 #include "cDemeNetworkUtils.h"
 #include "cDeme.h"
@@ -56,30 +58,43 @@ static const char* LINK_LENGTH_SUM="link length sum [link_sum]";
  */
 cDemeTopologyNetwork::cDemeTopologyNetwork(cWorld* world, cDeme& deme)
 : cDemeNetwork(world, deme)
+, m_cell_vertex(deme.GetSize(), -1)
+, m_next_decay(std::numeric_limits<int>::max())
 , m_link_length_sum(0.0) {
 }
 
 
-/*! Returns true if an edge should be decayed, false otherwise.
- */
-bool cDemeTopologyNetwork::edge_decayed::operator()(Network::edge_descriptor e) {
-	if((_now - _network[e]._t) > _decay) {
-		return true;
-	}
-	return false;
-}
-
-
 /*! Called at the end of every update.
  
- This removes "old" edges, if so configured.
+ This removes "old" edges, if so configured.  Edges only get younger when they are
+ refreshed, so nothing can have decayed before m_next_decay and the edges are only
+ swept once that update is reached.
  */
 void cDemeTopologyNetwork::ProcessUpdate() {
-	if((m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get() != 0) && (boost::num_edges(m_network)>0)) {
-		boost::remove_edge_if(edge_decayed(m_world->GetStats().GetUpdate(),
-																			 m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get(),
-																			 m_network),
-													m_network);
+	const int decay = m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get();
+	if((decay == 0) || (boost::num_edges(m_network) == 0)) {
+		return;
+	}
+	
+	const int now = m_world->GetStats().GetUpdate();
+	if(now < m_next_decay) {
+		return;
+	}
+	
+	std::vector<std::pair<Network::vertex_descriptor,Network::vertex_descriptor> > decayed;
+	m_next_decay = std::numeric_limits<int>::max();
+	Network::edge_iterator ei,ei_end;
+	for(boost::tie(ei,ei_end)=boost::edges(m_network); ei!=ei_end; ++ei) {
+		if((now - m_network[*ei]._t) > decay) {
+			decayed.push_back(std::make_pair(boost::source(*ei, m_network), boost::target(*ei, m_network)));
+		} else {
+			m_next_decay = std::min(m_next_decay, m_network[*ei]._t + decay + 1);
+		}
+	}
+	
+	for(std::size_t i=0; i<decayed.size(); ++i) {
+		boost::remove_edge(decayed[i].first, decayed[i].second, m_network);
+		UnlinkNeighbors(decayed[i].first, decayed[i].second);
 	}
 }
 
@@ -88,19 +103,25 @@ void cDemeTopologyNetwork::ProcessUpdate() {
  */
 void cDemeTopologyNetwork::OrganismDeath(cPopulationCell& u) {
 	if(m_world->GetConfig().DEME_NETWORK_REMOVE_NODE_ON_DEATH.Get()) {
-		CellVertexMap::iterator ui=m_cv.find(u.GetID());
-		if(ui!=m_cv.end()) {
+		int ui=FindVertex(u);
+		if(ui >= 0) {
 			// it would be nice if this worked generally:
-			boost::clear_vertex(ui->second, m_network);
+			boost::clear_vertex(ui, m_network);
 			// but, warning: this can trigger a double-delete bug if there are self-loops.
 			
 			// it would also be nice to do this:
-			//			boost::remove_vertex(ui->second, m_network);
-			//			m_cv.erase(ui);
+			//			boost::remove_vertex(ui, m_network);
+			//			m_cell_vertex[...] = -1;
 			// but because we're using a vecS for the vertex list, this invalidates *all*
-			// the other vertex descriptors in m_cv.  we also can't change to a listS
+			// the other vertex descriptors in m_cell_vertex.  we also can't change to a listS
 			// because some of the functionality over in cDemeNetworkUtils.h requires
 			// a vecS.  oh well.
+			NeighborList& nu = m_neighbors[ui];
+			for(std::size_t i=0; i<nu.size(); ++i) {
+				NeighborList& nv = m_neighbors[nu[i]];
+				nv.erase(std::lower_bound(nv.begin(), nv.end(), static_cast<Network::vertex_descriptor>(ui)));
+			}
+			nu.clear();
 		}
 	}
 }
@@ -115,32 +136,44 @@ void cDemeTopologyNetwork::Connect(cPopulationCell& u, cPopulationCell& v, doubl
 	}
 	
 	// find or create the vertex for u
-	CellVertexMap::iterator ui=m_cv.find(u.GetID());
-	if(ui==m_cv.end()) {
-		ui = m_cv.insert(std::make_pair(u.GetID(), boost::add_vertex(vertex_properties(u.GetPosition(), u.GetID()), m_network))).first;
+	int ui=FindVertex(u);
+	if(ui < 0) {
+		ui = boost::add_vertex(vertex_properties(u.GetPosition(), u.GetID()), m_network);
+		m_cell_vertex[m_deme.GetRelativeCellID(u.GetID())] = ui;
+		m_neighbors.push_back(NeighborList());
 	}
 	
 	// find or create the vertex for v
-	CellVertexMap::iterator vi=m_cv.find(v.GetID());
-	if(vi==m_cv.end()) {
-		vi = m_cv.insert(std::make_pair(v.GetID(), boost::add_vertex(vertex_properties(v.GetPosition(), v.GetID()), m_network))).first;
+	int vi=FindVertex(v);
+	if(vi < 0) {
+		vi = boost::add_vertex(vertex_properties(v.GetPosition(), v.GetID()), m_network);
+		m_cell_vertex[m_deme.GetRelativeCellID(v.GetID())] = vi;
+		m_neighbors.push_back(NeighborList());
 	}
 	
 	// sanity
-	assert(ui->second != vi->second);
+	assert(ui != vi);
+	assert(m_neighbors.size() == boost::num_vertices(m_network));
 	
 	// create the edge if it doesn't already exist
-	std::pair<Network::edge_descriptor,bool> e = boost::edge(ui->second, vi->second, m_network);
+	const int now = m_world->GetStats().GetUpdate();
+	std::pair<Network::edge_descriptor,bool> e = boost::edge(ui, vi, m_network);
 	if(!e.second) {
 		// create the edge
-		boost::add_edge(ui->second, vi->second, edge_properties(m_world->GetStats().GetUpdate()), m_network);
+		boost::add_edge(ui, vi, edge_properties(now), m_network);
+		LinkNeighbors(ui, vi);
 		// we have to track link lengths here in order to bypass a bug that's triggered when
 		// links decay.  if links decay, the network could actually have dissipated by the time
 		// we get around to calculating fitness.
-		m_link_length_sum += distance(ui->second, vi->second, m_network);
+		m_link_length_sum += distance(ui, vi, m_network);
+		
+		const int decay = m_world->GetConfig().DEME_NETWORK_LINK_DECAY.Get();
+		if(decay != 0) {
+			m_next_decay = std::min(m_next_decay, now + decay + 1);
+		}
 	} else {
 		// update the create time of the edge
-		m_network[e.first]._t = m_world->GetStats().GetUpdate();
+		m_network[e.first]._t = now;
 	}
 }
 
@@ -149,17 +182,15 @@ void cDemeTopologyNetwork::Connect(cPopulationCell& u, cPopulationCell& v, doubl
  */
 void cDemeTopologyNetwork::BroadcastToNeighbors(cPopulationCell& s, cOrgMessage& msg, cPopulationInterface* pop_interface) {
 	// if the sender isn't part of the network, we're all done:
-	CellVertexMap::iterator ui=m_cv.find(s.GetID());
-	if(ui==m_cv.end()) {
+	int ui=FindVertex(s);
+	if(ui < 0) {
 		return;
 	}
 	
-	Network::adjacency_iterator ai,ae;
-	boost::tie(ai,ae) = boost::adjacent_vertices(ui->second, m_network);
-	
-	// now, send a message to all the cells that were returned:
-	for( ; ai!=ae; ++ai) {
-		pop_interface->SendMessage(msg, m_network[*ai]._cell_id);
+	// now, send a message to all the neighboring cells:
+	const NeighborList& nu = m_neighbors[ui];
+	for(std::size_t i=0; i<nu.size(); ++i) {
+		pop_interface->SendMessage(msg, m_network[nu[i]]._cell_id);
 	}
 }
 
@@ -168,19 +199,16 @@ void cDemeTopologyNetwork::BroadcastToNeighbors(cPopulationCell& s, cOrgMessage&
  */
 void cDemeTopologyNetwork::Unicast(cPopulationCell& s, cOrgMessage& msg, cPopulationInterface* pop_interface) {
 	// if the sender isn't part of the network, we're all done:
-	CellVertexMap::iterator ui=m_cv.find(s.GetID());
-	if(ui==m_cv.end()) {
+	int ui=FindVertex(s);
+	if(ui < 0) {
 		return;
 	}
 	
 	// activate an edge for this vertex; if we can't we're all done.
-	if(ActivateEdge(ui->second)) {
-		assert(m_network[ui->second]._active_edge >= 0);
-		assert(static_cast<std::size_t>(m_network[ui->second]._active_edge) < boost::out_degree(ui->second, m_network));
-		Network::adjacency_iterator ai,ae;
-		boost::tie(ai,ae) = boost::adjacent_vertices(ui->second, m_network);
-		std::advance(ai, m_network[ui->second]._active_edge);
-		pop_interface->SendMessage(msg, m_network[*ai]._cell_id);
+	if(ActivateEdge(ui)) {
+		assert(m_network[ui]._active_edge >= 0);
+		assert(static_cast<std::size_t>(m_network[ui]._active_edge) < m_neighbors[ui].size());
+		pop_interface->SendMessage(msg, m_network[m_neighbors[ui][m_network[ui]._active_edge]]._cell_id);
 	}
 }
 
@@ -189,13 +217,13 @@ void cDemeTopologyNetwork::Unicast(cPopulationCell& s, cOrgMessage& msg, cPopula
  */
 void cDemeTopologyNetwork::Rotate(cPopulationCell& s, int x) {
 	// if the cell isn't part of the network, we're all done:
-	CellVertexMap::iterator ui=m_cv.find(s.GetID());
-	if(ui==m_cv.end()) {
+	int ui=FindVertex(s);
+	if(ui < 0) {
 		return;
 	}
 	
-	m_network[ui->second]._active_edge += x;
-	ActivateEdge(ui->second);
+	m_network[ui]._active_edge += x;
+	ActivateEdge(ui);
 }
 
 
@@ -203,30 +231,61 @@ void cDemeTopologyNetwork::Rotate(cPopulationCell& s, int x) {
  */
 void cDemeTopologyNetwork::Select(cPopulationCell& s, int x) {
 	// if the cell isn't part of the network, we're all done:
-	CellVertexMap::iterator ui=m_cv.find(s.GetID());
-	if(ui==m_cv.end()) {
+	int ui=FindVertex(s);
+	if(ui < 0) {
 		return;
 	}
 	
-	m_network[ui->second]._active_edge = x;
-	ActivateEdge(ui->second);	
+	m_network[ui]._active_edge = x;
+	ActivateEdge(ui);	
 }
 
 
 /*! Ensure that the active edge of the given vertex is valid.
  */
 bool cDemeTopologyNetwork::ActivateEdge(Network::vertex_descriptor u) {
-	// if we haven't yet initialized this vertex's active_edge, we're done:
-	if(m_network[u]._active_edge == -1) {
+	// if we haven't yet initialized this vertex's active_edge, or it has no edges, we're done:
+	const int degree = static_cast<int>(m_neighbors[u].size());
+	if((m_network[u]._active_edge == -1) || (degree == 0)) {
 		return false;
 	}
 	
 	// reset the active edge so that it can't index beyond the bounds of this vertex's degree:
-	m_network[u]._active_edge %= boost::out_degree(u, m_network);
+	m_network[u]._active_edge %= degree;
+	if(m_network[u]._active_edge < 0) {
+		m_network[u]._active_edge += degree;
+	}
 	return true;
 }
 
 
+/*! Returns the vertex of the given cell, or -1 if the cell isn't part of the network.
+ */
+int cDemeTopologyNetwork::FindVertex(cPopulationCell& u) const {
+	return m_cell_vertex[m_deme.GetRelativeCellID(u.GetID())];
+}
+
+
+/*! Add the undirected edge u-v to the neighbor lists.
+ */
+void cDemeTopologyNetwork::LinkNeighbors(Network::vertex_descriptor u, Network::vertex_descriptor v) {
+	NeighborList& nu = m_neighbors[u];
+	nu.insert(std::lower_bound(nu.begin(), nu.end(), v), v);
+	NeighborList& nv = m_neighbors[v];
+	nv.insert(std::lower_bound(nv.begin(), nv.end(), u), u);
+}
+
+
+/*! Remove the undirected edge u-v from the neighbor lists.
+ */
+void cDemeTopologyNetwork::UnlinkNeighbors(Network::vertex_descriptor u, Network::vertex_descriptor v) {
+	NeighborList& nu = m_neighbors[u];
+	nu.erase(std::lower_bound(nu.begin(), nu.end(), v));
+	NeighborList& nv = m_neighbors[v];
+	nv.erase(std::lower_bound(nv.begin(), nv.end(), u));
+}
+
+
 /*! Returns the fitness of the network, as determined by the DEME_NETWORK_TOPOLOGY_FITNESS config option.
  
  This is funky because we want to report as many network stats as we can...
@@ -67,20 +67,12 @@ public:
   //! An ease-of-use typedef to support the distributed construction of a network.
   typedef boost::adjacency_list<boost::setS, boost::vecS, boost::undirectedS, vertex_properties, edge_properties> Network;
   
-  //! A map of cell IDs to vertex descriptors.
-  typedef std::map<int, Network::vertex_descriptor> CellVertexMap;
+  //! Neighbors of a vertex, kept sorted so that they are in the same order as the vertex's out edges.
+  typedef std::vector<Network::vertex_descriptor> NeighborList;
   
   //! Map of cell IDs to counts.
   typedef std::map<int, unsigned int> CellCountMap;
 	
-  //! Function object to remove edges if they've decayed.
-	struct edge_decayed {
-		edge_decayed(int n, int d, Network& net) : _now(n), _decay(d), _network(net) { }
-		bool operator()(Network::edge_descriptor e);
-		int _now, _decay;
-		Network& _network;
-	};
-	
 	//! Constructor.
 	cDemeTopologyNetwork(cWorld* world, cDeme& deme);
 	
@@ -121,8 +113,17 @@ protected:
 	//! Ensure that the active edge of the given vertex is valid.
 	bool ActivateEdge(Network::vertex_descriptor u);
 	
+	//! Returns the vertex of the given cell, or -1 if the cell isn't part of the network.
+	int FindVertex(cPopulationCell& u) const;
+	
+	//! Add or remove the undirected edge u-v in the neighbor lists.
+	void LinkNeighbors(Network::vertex_descriptor u, Network::vertex_descriptor v);
+	void UnlinkNeighbors(Network::vertex_descriptor u, Network::vertex_descriptor v);
+	
 	Network m_network; //!< Underlying network model.
-	CellVertexMap m_cv; //!< Map of cell ids to vertex descriptors.
+	std::vector<int> m_cell_vertex; //!< Vertex of each cell in the deme (by relative cell id), -1 if none.
+	std::vector<NeighborList> m_neighbors; //!< Neighbors of each vertex, mirrors m_network for messaging.
+	int m_next_decay; //!< Earliest update at which an edge can have decayed.
 	double m_link_length_sum; //!< Sum of all link lengths, at connection.
 	
 private:
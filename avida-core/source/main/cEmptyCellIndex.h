@@ -0,0 +1,154 @@
+/*
+ *  cEmptyCellIndex.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cEmptyCellIndex_h
+#define cEmptyCellIndex_h
+
+#include "apto/core/Array.h"
+#include "apto/rng.h"
+
+#include <cassert>
+
+
+// cEmptyCellIndex holds the ids of the empty cells of the population, both as a whole and split into equally sized
+// groups of consecutive cells (demes).  Each list is kept dense, with the position of every member recorded, so that
+// insertion, removal and picking a uniformly random member all take constant time.  The order of the lists is arbitrary.
+
+class cEmptyCellIndex
+{
+private:
+  Apto::Array<int, Apto::Smart> m_cells;                   // all empty cells
+  Apto::Array<int> m_pos;                                  // position of each cell in m_cells, -1 if occupied
+  int m_group_size;
+  Apto::Array<Apto::Array<int, Apto::Smart> > m_group_cells;  // empty cells of each group, only kept with multiple groups
+  Apto::Array<int> m_group_pos;                            // position of each cell in its group list
+
+
+  inline void removeAt(Apto::Array<int, Apto::Smart>& cells, Apto::Array<int>& pos, int cell_id)
+  {
+    const int idx = pos[cell_id];
+    const int last = cells[cells.GetSize() - 1];
+    cells[idx] = last;
+    pos[last] = idx;
+    cells.Pop();
+    pos[cell_id] = -1;
+  }
+
+
+public:
+  cEmptyCellIndex() : m_group_size(0) { ; }
+
+  // Start over with every one of num_cells cells empty, grouped into runs of group_size consecutive cells
+  inline void Setup(int num_cells, int group_size);
+
+  inline bool Contains(int cell_id) const { return m_pos[cell_id] != -1; }
+  inline int GetSize() const { return m_cells.GetSize(); }
+  inline int GetSize(int group_id) const;
+
+  inline void Insert(int cell_id);
+  inline void Remove(int cell_id);
+
+  // The contents of two cells were exchanged
+  inline void Swap(int cell_id1, int cell_id2);
+
+  // Uniformly random empty cell, of the population or of one group, or -1 if there is none
+  inline int Pick(Apto::Random& rng) const;
+  inline int Pick(int group_id, Apto::Random& rng) const;
+};
+
+
+inline void cEmptyCellIndex::Setup(int num_cells, int group_size)
+{
+  assert(group_size > 0);
+
+  m_cells.Resize(num_cells);
+  m_pos.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) m_cells[i] = m_pos[i] = i;
+
+  // A single group is just the whole population
+  m_group_size = group_size;
+  const int num_groups = (group_size < num_cells) ? (num_cells + group_size - 1) / group_size : 0;
+  m_group_cells.Resize(num_groups);
+  m_group_pos.Resize(num_groups ? num_cells : 0);
+  for (int g = 0; g < num_groups; g++) m_group_cells[g].Resize(0);
+  for (int i = 0; i < m_group_pos.GetSize(); i++) {
+    Apto::Array<int, Apto::Smart>& group = m_group_cells[i / m_group_size];
+    m_group_pos[i] = group.GetSize();
+    group.Push(i);
+  }
+}
+
+inline int cEmptyCellIndex::GetSize(int group_id) const
+{
+  if (!m_group_cells.GetSize()) return m_cells.GetSize();
+  return m_group_cells[group_id].GetSize();
+}
+
+inline void cEmptyCellIndex::Insert(int cell_id)
+{
+  if (m_pos[cell_id] != -1) return;
+
+  m_pos[cell_id] = m_cells.GetSize();
+  m_cells.Push(cell_id);
+  if (m_group_cells.GetSize()) {
+    Apto::Array<int, Apto::Smart>& group = m_group_cells[cell_id / m_group_size];
+    m_group_pos[cell_id] = group.GetSize();
+    group.Push(cell_id);
+  }
+}
+
+inline void cEmptyCellIndex::Remove(int cell_id)
+{
+  if (m_pos[cell_id] == -1) return;
+
+  removeAt(m_cells, m_pos, cell_id);
+  if (m_group_cells.GetSize()) removeAt(m_group_cells[cell_id / m_group_size], m_group_pos, cell_id);
+}
+
+inline void cEmptyCellIndex::Swap(int cell_id1, int cell_id2)
+{
+  const bool empty1 = Contains(cell_id1);
+  if (empty1 == Contains(cell_id2)) return;
+
+  if (empty1) {
+    Remove(cell_id1);
+    Insert(cell_id2);
+  } else {
+    Remove(cell_id2);
+    Insert(cell_id1);
+  }
+}
+
+inline int cEmptyCellIndex::Pick(Apto::Random& rng) const
+{
+  if (!m_cells.GetSize()) return -1;
+  return m_cells[rng.GetUInt(m_cells.GetSize())];
+}
+
+inline int cEmptyCellIndex::Pick(int group_id, Apto::Random& rng) const
+{
+  if (!m_group_cells.GetSize()) return Pick(rng);
+
+  const Apto::Array<int, Apto::Smart>& group = m_group_cells[group_id];
+  if (!group.GetSize()) return -1;
+  return group[rng.GetUInt(group.GetSize())];
+}
+
+#endif
@@ -48,12 +48,15 @@
 #include "cTaskEntry.h"
 #include "cWorld.h"
 
+#include <cmath>
+
 using namespace Avida;
 
 
 cEnvironment::cEnvironment(cWorld* world) : m_world(world) , m_tasklib(world),
 m_input_size(INPUT_SIZE_DEFAULT), m_output_size(OUTPUT_SIZE_DEFAULT), m_true_rand(false),
-m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false)
+m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false), m_version(0),
+m_logic_reactions_size(-1)
 {
   mut_rates.Setup(world);
   if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) possible_group_ids.insert(m_world->GetConfig().DEFAULT_GROUP.Get());
@@ -575,6 +578,14 @@ bool cEnvironment::LoadResource(cString desc, Feedback& feedback)
         if (!AssertInputDouble(var_value, "ygravity", var_type, feedback)) return false;
         new_resource->SetYGravity( var_value.AsDouble() );
       }
+      else if (var_name == "update_interval") {
+        if (!AssertInputInt(var_value, "update_interval", var_type, feedback)) return false;
+        new_resource->SetSpatialInterval( var_value.AsInt() );
+      }
+      else if (var_name == "flow_tolerance") {
+        if (!AssertInputDouble(var_value, "flow_tolerance", var_type, feedback)) return false;
+        new_resource->SetFlowTolerance( var_value.AsDouble() );
+      }
       else if (var_name == "deme") {
         if (!new_resource->SetDemeResource( var_value )) {
           feedback.Error("in %s, %s must be true or false", (const char*)var_type, (const char*)var_value);
@@ -633,6 +644,20 @@ bool cEnvironment::LoadResource(cString desc, Feedback& feedback)
       return false;
     }
 
+    // A scaled spatial step moves interval times as much matter, keep it within the range of a single stable step
+    const int interval = new_resource->GetSpatialInterval();
+    if (interval < 1) {
+      feedback.Error("update_interval must be at least 1 in resource '%s'", (const char*)name);
+      return false;
+    }
+    const double max_flow = Apto::Max(Apto::Max(fabs(new_resource->GetXDiffuse()), fabs(new_resource->GetYDiffuse())),
+                                      Apto::Max(fabs(new_resource->GetXGravity()), fabs(new_resource->GetYGravity())));
+    if (interval * max_flow > 1.0) {
+      feedback.Error("update_interval %d is too long for the diffusion and gravity of resource '%s'",
+                     interval, (const char*)name);
+      return false;
+    }
+
     // If there are valid values for X/Y1's but not for X/Y2's assume that
     // the user is interested only in one point and set the X/Y2's to the
     // same value as X/Y1's
@@ -825,9 +850,36 @@ bool cEnvironment::LoadReaction(cString desc, Feedback& feedback)
   if (envreqs.GetMinOutputs() > m_output_size) m_output_size = envreqs.GetMinOutputs();
   if (envreqs.GetTrueRandInputs()) m_true_rand = true;
 
+  buildReactionIndex();
   return true;
 }
 
+
+void cEnvironment::buildReactionIndex()
+{
+  const int num_reactions = reaction_lib.GetSize();
+  m_logic_reactions.ResizeClear(257);
+  for (int i = 0; i < m_logic_reactions.GetSize(); i++) m_logic_reactions[i].Resize(0);
+  
+  for (int i = 0; i < num_reactions; i++) {
+    const cReaction* cur_reaction = reaction_lib.GetReaction(i);
+    const cTaskEntry* cur_task = cur_reaction->GetTask();
+    
+    // Phenotypic plasticity bonuses can mark a task that was not performed, so those reactions are always tested
+    bool logic_only = (cur_task != NULL && cur_task->IsLogicOnly());
+    tArrayListIterator<cReactionProcess> proc_it(cur_reaction->GetProcesses());
+    const cReactionProcess* cur_proc;
+    while (logic_only && (cur_proc = proc_it.Next()) != NULL) {
+      if (cur_proc->GetPhenPlastBonusMethod() != DEFAULT) logic_only = false;
+    }
+    
+    for (int logic_id = -1; logic_id < 256; logic_id++) {
+      if (!logic_only || cur_task->PerformedByLogicId(logic_id)) m_logic_reactions[logic_id + 1].Push(i);
+    }
+  }
+  m_logic_reactions_size = num_reactions;
+}
+
 bool cEnvironment::LoadGradientResource(cString desc, Feedback& feedback) 
 {
   if (desc.GetSize() == 0) {
@@ -1187,6 +1239,7 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
 /* Routine to read in a line from the enviroment file and hand that line
  line to the approprate routine to process it.                         */
 {
+  m_version++;
   cString type = line.PopWord();      // Determine type of this entry.
   type.ToUpper();                     // Make type case insensitive.
 
@@ -1327,9 +1380,17 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
   // Do setup for reaction tests...
   m_tasklib.SetupTests(taskctx);
 
-  // Loop through all reactions to see if any have been triggered...
-  const int num_reactions = reaction_lib.GetSize();
-  for (int i = 0; i < num_reactions; i++) {
+  if (context_phenotype != 0) context_phenotype->SetupCounts(task_count.GetSize(), reaction_lib.GetSize());
+
+  // Loop through all reactions to see if any have been triggered.  Only those that the logic id of the output can
+  // trigger need to be examined.
+  const Apto::Array<int, Apto::Smart>* candidates = NULL;
+  if (m_logic_reactions_size == reaction_lib.GetSize()) {
+    candidates = &m_logic_reactions[taskctx.GetLogicId() + 1];
+  }
+  const int num_reactions = (candidates) ? candidates->GetSize() : reaction_lib.GetSize();
+  for (int r = 0; r < num_reactions; r++) {
+    const int i = (candidates) ? (*candidates)[r] : r;
     cReaction* cur_reaction = reaction_lib.GetReaction(i);
     assert(cur_reaction != NULL);
 
@@ -1353,18 +1414,6 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
     }
 
     if (context_phenotype != 0) {
-      Apto::Array<int> blank_tasks;
-      Apto::Array<int> blank_reactions;
-      blank_tasks.ResizeClear(task_count.GetSize());
-      for(int count=0;count<task_count.GetSize();count++) {
-        blank_tasks[count] = 0;
-      }
-      blank_reactions.ResizeClear(this->GetReactionLib().GetSize());
-      for(int count=0;count<reaction_count.GetSize();count++) {
-        blank_reactions[count] = 0;
-      }
-      context_phenotype->AddTaskCounts(blank_tasks.GetSize(), blank_tasks);
-      context_phenotype->AddReactionCounts(blank_reactions.GetSize(), blank_reactions);
       int context_task_count = context_phenotype->GetTaskCounts()[task_id];
       if (TestContextRequisites(cur_reaction, context_task_count, context_phenotype->GetReactionCounts(), on_divide) == false) {
         if (!skipProcessing) {  // for those parasites again
@@ -1408,7 +1457,7 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
 bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_reaction,
                                   int task_count, const Apto::Array<int>& reaction_count, const bool on_divide, bool is_parasite) const
 {
-  const tList<cReactionRequisite>& req_list = cur_reaction->GetRequisites();
+  const tArrayList<cReactionRequisite>& req_list = cur_reaction->GetRequisites();
   const int num_reqs = req_list.GetSize();
 
   // If there are no requisites, there is nothing to meet!
@@ -1418,7 +1467,7 @@ bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_re
     return !on_divide;
   }
 
-  tLWConstListIterator<cReactionRequisite> req_it(req_list);
+  tArrayListIterator<cReactionRequisite> req_it(req_list);
   for (int i = 0; i < num_reqs; i++) {
     // See if this requisite batch can be satisfied.
     const cReactionRequisite* cur_req = req_it.Next();
@@ -1427,7 +1476,7 @@ bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_re
     if (taskctx.GetOrganism()) {
       // Have all reactions been met?
       const Apto::Array<int>& stolen_reactions = taskctx.GetOrganism()->GetPhenotype().GetStolenReactionCount();
-      tLWConstListIterator<cReaction> reaction_it(cur_req->GetReactions());
+      tArrayListIterator<cReaction> reaction_it(cur_req->GetReactions());
       while (reaction_it.Next() != NULL) {
         int react_id = reaction_it.Get()->GetID();
         if (reaction_count[react_id] == 0 && stolen_reactions[react_id] == 0) {   
@@ -1438,7 +1487,7 @@ bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_re
     }
     // If being called as a deme reaction..
     else {
-      tLWConstListIterator<cReaction> reaction_it(cur_req->GetReactions());
+      tArrayListIterator<cReaction> reaction_it(cur_req->GetReactions());
       while (reaction_it.Next() != NULL) {
         int react_id = reaction_it.Get()->GetID();
         if (reaction_count[react_id] == 0) {
@@ -1451,7 +1500,7 @@ bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_re
     if (satisfied == false) continue;
 
     // Have all no-reactions been met?
-    tLWConstListIterator<cReaction> noreaction_it(cur_req->GetNoReactions());
+    tArrayListIterator<cReaction> noreaction_it(cur_req->GetNoReactions());
     while (noreaction_it.Next() != NULL) {
       int react_id = noreaction_it.Get()->GetID();
       if (reaction_count[react_id] != 0) {
@@ -1507,7 +1556,7 @@ bool cEnvironment::TestContextRequisites(const cReaction* cur_reaction,
 					 int task_count, const Apto::Array<int>& reaction_count,
 					 const bool on_divide) const
 {
-  const tList<cContextReactionRequisite>& req_list = cur_reaction->GetContextRequisites();
+  const tArrayList<cContextReactionRequisite>& req_list = cur_reaction->GetContextRequisites();
   const int num_reqs = req_list.GetSize();
 
   // If there are no requisites, there is nothing to meet!
@@ -1517,14 +1566,14 @@ bool cEnvironment::TestContextRequisites(const cReaction* cur_reaction,
     return !on_divide;
   }
 
-  tLWConstListIterator<cContextReactionRequisite> req_it(req_list);
+  tArrayListIterator<cContextReactionRequisite> req_it(req_list);
   for (int i = 0; i < num_reqs; i++) {
     // See if this requisite batch can be satisfied.
     const cContextReactionRequisite* cur_req = req_it.Next();
     bool satisfied = true;
 
     // Have all reactions been met?
-    tLWConstListIterator<cReaction> reaction_it(cur_req->GetReactions());
+    tArrayListIterator<cReaction> reaction_it(cur_req->GetReactions());
     while (reaction_it.Next() != NULL) {
       int react_id = reaction_it.Get()->GetID();
       if (reaction_count[react_id] == 0) {
@@ -1535,7 +1584,7 @@ bool cEnvironment::TestContextRequisites(const cReaction* cur_reaction,
     if (satisfied == false) continue;
 
     // Have all no-reactions been met?
-    tLWConstListIterator<cReaction> noreaction_it(cur_req->GetNoReactions());
+    tArrayListIterator<cReaction> noreaction_it(cur_req->GetNoReactions());
     while (noreaction_it.Next() != NULL) {
       int react_id = noreaction_it.Get()->GetID();
       if (reaction_count[react_id] != 0) {
@@ -1578,7 +1627,7 @@ bool cEnvironment::TestContextRequisites(const cReaction* cur_reaction,
 
 
 double cEnvironment::GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskctx,
-                                        const tList<cReactionProcess>& req_proc, bool& force_mark_task) const
+                                        const tArrayList<cReactionProcess>& req_proc, bool& force_mark_task) const
 {
   force_mark_task = false;
   if (ctx.GetTestMode()) { //If we're in test-cpu mode, do not do this.
@@ -1586,7 +1635,7 @@ double cEnvironment::GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskct
   }
 
   double task_prob = -1.0;
-  tLWConstListIterator<cReactionProcess> proc_it(req_proc);
+  tArrayListIterator<cReactionProcess> proc_it(req_proc);
   cReactionProcess* cur_proc;
   bool test_plasticity = false;
   while ( (cur_proc = proc_it.Next()) != NULL){  //Determine whether or not we need to test for plastcity
@@ -1607,14 +1656,17 @@ double cEnvironment::GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskct
 
 
 
-void cEnvironment::DoProcesses(cAvidaContext& ctx, const tList<cReactionProcess>& process_list,
+void cEnvironment::DoProcesses(cAvidaContext& ctx, const tArrayList<cReactionProcess>& process_list,
                                const Apto::Array<double>& resource_count, const Apto::Array<double>& rbins_count,
                                const double task_quality, const double task_probability, const int task_count,
                                const int reaction_id, cReactionResult& result, cTaskContext& taskctx) const
 {
   const int num_process = process_list.GetSize();
+  const bool may_use_rbins = m_world->GetConfig().USE_RESOURCE_BINS.Get();
+  const double use_stored_fraction = m_world->GetConfig().USE_STORED_FRACTION.Get();
+  const double env_fraction_threshold = m_world->GetConfig().ENV_FRACTION_THRESHOLD.Get();
   
-  tLWConstListIterator<cReactionProcess> process_it(process_list);
+  tArrayListIterator<cReactionProcess> process_it(process_list);
   for (int i = 0; i < num_process; i++) {
     // See if this requisite batch can be satisfied.
     const cReactionProcess* cur_process = process_it.Next();
@@ -1676,7 +1728,6 @@ void cEnvironment::DoProcesses(cAvidaContext& ctx, const tList<cReactionProcess>
         assert(consumed >= 0.0);
       }
 
-      bool may_use_rbins = m_world->GetConfig().USE_RESOURCE_BINS.Get();
       bool using_rbins = false;  //default: not using resource bins
 
       if (may_use_rbins) assert(rbins_count.GetSize() > res_id);
@@ -1693,10 +1744,8 @@ void cEnvironment::DoProcesses(cAvidaContext& ctx, const tList<cReactionProcess>
        *   of what we could consume from the outside environment?
        */
       else if (may_use_rbins && rbins_count[res_id] > 0 &&
-          (m_world->GetConfig().USE_STORED_FRACTION.Get() * rbins_count[res_id]) >
-          (m_world->GetConfig().ENV_FRACTION_THRESHOLD.Get() * consumed)
-          ) {
-        consumed = m_world->GetConfig().USE_STORED_FRACTION.Get() * rbins_count[res_id];
+          (use_stored_fraction * rbins_count[res_id]) > (env_fraction_threshold * consumed)) {
+        consumed = use_stored_fraction * rbins_count[res_id];
         using_rbins = true;
       }
 
@@ -1876,6 +1925,7 @@ double cEnvironment::GetReactionValue(int reaction_id)
 
 bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, double value)
 {
+  m_version++;
   const int num_reactions = reaction_lib.GetSize();
 
   // See if this should be applied to all reactions.
@@ -1917,6 +1967,7 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
 
 bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->MultiplyValue(value_mult);
@@ -1925,6 +1976,7 @@ bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 
 bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyInst(inst_name);
@@ -1933,6 +1985,7 @@ bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 
 bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinTaskCount( min_count );
@@ -1940,6 +1993,7 @@ bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 
 bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxTaskCount( max_count );
@@ -1947,6 +2001,7 @@ bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 
 bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinReactionCount( reaction_min_count );
@@ -1954,6 +2009,7 @@ bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_cou
 
 bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxReactionCount( reaction_max_count );
@@ -1961,6 +2017,7 @@ bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_cou
 
 bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
 
@@ -1969,6 +2026,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
     if (m_tasklib.GetTask(i).GetName() == task)
     {
       found_reaction->SetTask( m_tasklib.GetTaskReference(i) );
+      buildReactionIndex();
       return true;
     }
   }
@@ -1978,6 +2036,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 
 bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 {
+  m_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetInflow( _inflow );
@@ -1986,14 +2045,28 @@ bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 
 bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 {
+  m_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetOutflow( _outflow );
   return true;
 }
 
+void cEnvironment::SetResourceInflow(int res_id, double _inflow)
+{
+  m_version++;
+  resource_lib.GetResource(res_id)->SetInflow(_inflow);
+}
+
+void cEnvironment::SetResourceOutflow(int res_id, double _outflow)
+{
+  m_version++;
+  resource_lib.GetResource(res_id)->SetOutflow(_outflow);
+}
+
 bool cEnvironment::ChangeResource(cReaction* reaction, const cString& res, int process_num)
 {
+  m_version++;
   cReactionProcess* process = reaction->GetProcess(process_num);
   process->SetResource(m_world->GetEnvironment().GetResourceLib().GetResource(res));
   return true;
@@ -31,6 +31,7 @@
 #include "cResourceLib.h"
 #include "cString.h"
 #include "cTaskLib.h"
+#include "tArrayList.h"
 #include "tList.h"
 
 #include <set>
@@ -83,6 +84,14 @@ private:
   bool m_hammers;
   bool m_paths;
   
+  int m_version; // Incremented on every change that can alter how an organism is evaluated
+  
+  // Reactions that can be triggered by an output with logic id i - 1 (0 holds those for inconsistent outputs)
+  Apto::Array<Apto::Array<int, Apto::Smart> > m_logic_reactions;
+  int m_logic_reactions_size;  // size of the reaction library the index was built for
+  
+  void buildReactionIndex();
+  
   cEnvironment(); // @not_implemented
   cEnvironment(const cEnvironment&); // @not_implemented
   cEnvironment& operator=(const cEnvironment&); // @not_implemented
@@ -96,8 +105,8 @@ public:
 
   // Interaction with the organisms
   void SetupInputs(cAvidaContext& ctx, Apto::Array<int>& input_array, bool random = true) const;
-  void SetSpecificInputs(const Apto::Array<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; }
-  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; }
+  void SetSpecificInputs(const Apto::Array<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; m_version++; }
+  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; m_version++; }
   void SwapInputs(cAvidaContext& ctx, Apto::Array<int>& src_input_array, Apto::Array<int>& dest_input_array) const;
 
 
@@ -110,11 +119,12 @@ public:
                   bool is_parasite=false, cContextPhenotype* context_phenotype = 0) const;
 
   // Accessors
+  const cTaskLib& GetTaskLib() const { return m_tasklib; }
   int GetNumTasks() const { return m_tasklib.GetSize(); }
   const cTaskEntry& GetTask(int id) const { return m_tasklib.GetTask(id); }
   bool UseNeighborInput() const { return m_tasklib.UseNeighborInput(); }
   bool UseNeighborOutput() const { return m_tasklib.UseNeighborOutput(); }
-  vector<cString> GetMatchStringsFromTask() { return m_tasklib.GetMatchStrings(); }
+  const vector<cMatchString>& GetMatchStringsFromTask() const { return m_tasklib.GetMatchStrings(); }
   cString GetMatchString(int x) { return m_tasklib.GetMatchString(x); }
   int GetNumberOfMatchStrings() { return m_tasklib.GetNumberOfMatchStrings(); }	
 
@@ -128,6 +138,8 @@ public:
   cReactionLib& GetReactionLib() { return reaction_lib; }
   cMutationRates& GetMutRates() { return mut_rates; }
   
+  int GetVersion() const { return m_version; }
+  
   int GetNumStateGrids() const { return m_state_grids.GetSize(); }
   const cStateGrid& GetStateGrid(int sg) const { return *m_state_grids[sg]; }  
 
@@ -147,6 +159,8 @@ public:
   bool SetReactionTask(const cString& name, const cString& task);
   bool SetResourceInflow(const cString& name, double _inflow );
   bool SetResourceOutflow(const cString& name, double _outflow );
+  void SetResourceInflow(int res_id, double _inflow);   // res_id is the resource library id
+  void SetResourceOutflow(int res_id, double _outflow);
   bool ChangeResource(cReaction* reaction, const cString& res, int process_num = 0);
 	
   void AddGroupID(int new_id) { possible_group_ids.insert(new_id); }
@@ -185,13 +199,13 @@ private:
   bool LoadGradientResource(cString desc, Feedback& feedback);
   double GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskctx,
 
-                            const tList<cReactionProcess>& req_proc, bool& force_mark_task) const;
+                            const tArrayList<cReactionProcess>& req_proc, bool& force_mark_task) const;
   
   bool TestRequisites(cTaskContext& taskctx, const cReaction* cur_reaction, int task_count,
                       const Apto::Array<int>& reaction_count, const bool on_divide = false, bool is_parasite=false) const;
   bool TestContextRequisites(const cReaction* cur_reaction, int task_count, 
                       const Apto::Array<int>& reaction_count, const bool on_divide = false) const;
-  void DoProcesses(cAvidaContext& ctx, const tList<cReactionProcess>& process_list, 
+  void DoProcesses(cAvidaContext& ctx, const tArrayList<cReactionProcess>& process_list, 
                    const Apto::Array<double>& resource_count, const Apto::Array<double>& rbin_count,
                    const double task_quality, const double task_probability,
                    const int task_count, const int reaction_id, 
@@ -23,13 +23,18 @@
 #include "cEventList.h"
 
 #include "avida/Avida.h"
+#include "avida/data/Manager.h"
 
 #include "cActionLibrary.h"
+#include "cAnalyze.h"
 #include "cInitFile.h"
+#include "cPopulation.h"
 #include "cStats.h"
 #include "cString.h"
 #include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
 
+#include <algorithm>
 #include <cfloat>           // for DBL_MIN
 #include <iostream>
 
@@ -59,7 +64,7 @@ bool cEventList::AddEvent(eTriggerType trigger, double start, double interval,
   cAction* action = cActionLibrary::GetInstance().Create((const char*)name, m_world, args, feedback);
   
   if (action != NULL) {
-    cEventListEntry* entry = new cEventListEntry(action, name, trigger, start, interval, stop);
+    cEventListEntry* entry = new cEventListEntry(action, name, m_next_id++, trigger, start, interval, stop);
     
     // If there are no events in the list yet.
     if (m_tail == NULL) {
@@ -73,7 +78,7 @@ bool cEventList::AddEvent(eTriggerType trigger, double start, double interval,
       m_tail = entry;
     }
     
-    SyncEvent(entry);
+    if (SyncEvent(entry)) enqueue(entry);
 		
 		if (trigger == BIRTHS_INTERRUPT)  //Operates outside of usual event processing
 			QueueBirthInterruptEvent(start);
@@ -151,53 +156,80 @@ double cEventList::GetTriggerValue(eTriggerType trigger) const
 
 void cEventList::Process(cAvidaContext& ctx)
 {
-  double t_val = 0; // trigger value
+  // Collect the events that may fire now: the due heads of the queues, and every event of the other triggers
+  Apto::Array<cEventListEntry*, Apto::Smart> candidates;
+  const eTriggerType queue_trigger[NUM_QUEUES] = { UPDATE, BIRTHS };
+  for (int q = 0; q < NUM_QUEUES; q++) {
+    Apto::Array<cEventListEntry*, Apto::Smart>& queue = m_queue[q];
+    const double t_val = GetTriggerValue(queue_trigger[q]);
+    while (queue.GetSize() && isDue(queue[0], t_val)) {
+      std::pop_heap(&queue[0], &queue[0] + queue.GetSize(), firesBefore);
+      candidates.Push(queue[queue.GetSize() - 1]);
+      queue.Resize(queue.GetSize() - 1);
+    }
+  }
+  for (int i = 0; i < m_scanned.GetSize(); i++) candidates.Push(m_scanned[i]);
+  m_scanned.Resize(0);
   
-  // Iterate through all entrys in event list
-  cEventListEntry* entry = m_head;
-  while (entry != NULL) {
-    cEventListEntry* next_entry = entry->GetNext();
+  // Process them in the order they were added, as a walk of the whole list would
+  if (candidates.GetSize() > 1) {
+    std::sort(&candidates[0], &candidates[0] + candidates.GetSize(), cEventListEntry::CompareID);
+  }
+  
+  const bool parallel_print = m_world->GetConfig().PARALLEL_PRINT.Get();
+  int prepared_end = 0;
+  bool recorders_done = false;
+  
+  for (int i = 0; i < candidates.GetSize(); i++) {
+    cEventListEntry* entry = candidates[i];
     
     // Check trigger condition
+    const bool fires = firesNow(entry);
+    
+    // Actions read (and may detach) recorders, so pipelined recording of the last update must be finished first
+    if ((fires || entry->GetTrigger() == IMMEDIATE) && !recorders_done) {
+      m_world->GetDataManager()->WaitForRecorders();
+      recorders_done = true;
+    }
+    
+    if (parallel_print && i >= prepared_end && fires && entry->GetAction()->IsReadOnly()) {
+      prepared_end = prepareReadOnly(candidates, i);
+    }
     
     // IMMEDIATE Events always happen and are always deleted
     if (entry->GetTrigger() == IMMEDIATE) {
       entry->GetAction()->Process(ctx);
       Delete(entry);
-    } else if (entry->GetTrigger() != BIRTHS_INTERRUPT) {
-      //BIRTHS_INTERRUPT occur outside of update boundaries
-	  //and should not alter the behavior of other events.
-	  
-	  // Get the value of the appropriate trigger varile
-      t_val = GetTriggerValue(entry->GetTrigger());
+      continue;
+    }
+    
+    if (fires) {
       
-      if (t_val != DBL_MAX &&
-          (t_val >= entry->GetStart() || entry->GetStart() == TRIGGER_BEGIN) &&
-          (t_val <= entry->GetStop() || entry->GetStop() == TRIGGER_END)) {
-
-        // Process the Action
-        entry->GetAction()->Process(ctx);
-        
-        // Handle Interval Adjustment
-        if (entry->GetInterval() == TRIGGER_ALL) {
-          // Do Nothing
-        } else if (entry->GetInterval() == TRIGGER_ONCE) {
-          // If it is a onetime thing, remove it...
-          Delete(entry);
-          entry = NULL;
-        } else {
-          // There is an interval.. so add it
-          entry->NextInterval();
-        }
-        
-        // If the event can never happen now... excize it
-        if (entry != NULL && entry->GetStop() != TRIGGER_END &&
-            ((entry->GetStart() > entry->GetStop() && entry->GetInterval() > 0) ||
-             (entry->GetStart() < entry->GetStop() && entry->GetInterval() < 0)))
-            Delete(entry);
+      // Process the Action
+      entry->GetAction()->Process(ctx);
+      
+      // Handle Interval Adjustment
+      if (entry->GetInterval() == TRIGGER_ALL) {
+        // Do Nothing
+      } else if (entry->GetInterval() == TRIGGER_ONCE) {
+        // If it is a onetime thing, remove it...
+        Delete(entry);
+        continue;
+      } else {
+        // There is an interval.. so add it
+        entry->NextInterval();
       }
-    } 
-    entry = next_entry;
+      
+      // If the event can never happen now... excize it
+      if (entry->GetStop() != TRIGGER_END &&
+          ((entry->GetStart() > entry->GetStop() && entry->GetInterval() > 0) ||
+           (entry->GetStart() < entry->GetStop() && entry->GetInterval() < 0))) {
+        Delete(entry);
+        continue;
+      }
+    }
+    
+    enqueue(entry);
   }
 }
 
@@ -230,6 +262,7 @@ void cEventList::ProcessInterrupt(cAvidaContext& ctx)
 			t_val = GetTriggerValue(entry->GetTrigger());
 			
 			if (t_val == entry->GetStart() ) {  //This event *must* happen at this value
+				m_world->GetDataManager()->WaitForRecorders();
 				
 				// Process the Action
 				entry->GetAction()->Process(ctx);
@@ -271,26 +304,30 @@ void cEventList::Sync()
     SyncEvent(entry);
     entry = next_entry;
   }
+  
+  // Start times may have moved in either direction
+  rebuildQueues();
 }
 
 
-void cEventList::SyncEvent(cEventListEntry* entry)
+// Returns false if the event was removed
+bool cEventList::SyncEvent(cEventListEntry* entry)
 {
   // Ignore events that are immdeiate
-  if (entry->GetTrigger() == IMMEDIATE) return;
+  if (entry->GetTrigger() == IMMEDIATE) return true;
   
   double t_val = GetTriggerValue(entry->GetTrigger());
   
   // If t_val has past the end, remove (even if it is TRIGGER_ALL)
   if (t_val > entry->GetStop()) {
     Delete(entry);
-    return;
+    return false;
   }
   
   // If it is a trigger once and has passed, remove
   if (t_val > entry->GetStart() && entry->GetInterval() == TRIGGER_ONCE) {
     Delete(entry);
-    return;
+    return false;
   }
   
   // If for some reason t_val has been reset or soemthing, rewind
@@ -299,10 +336,90 @@ void cEventList::SyncEvent(cEventListEntry* entry)
   }
   
   // Can't fast forward events that are Triger All
-  if (entry->GetInterval() == TRIGGER_ALL) return;
+  if (entry->GetInterval() == TRIGGER_ALL) return true;
   
   // Keep adding interval to start until we are caught up
   while (t_val > entry->GetStart()) entry->NextInterval();
+  return true;
+}
+
+
+bool cEventList::firesBefore(const cEventListEntry* lhs, const cEventListEntry* rhs)
+{
+  // std heaps keep the greatest element on top, so order by reversed (start, id)
+  if (lhs->GetStart() != rhs->GetStart()) return lhs->GetStart() > rhs->GetStart();
+  return lhs->GetID() > rhs->GetID();
+}
+
+
+bool cEventList::firesNow(const cEventListEntry* entry) const
+{
+  if (entry->GetTrigger() == IMMEDIATE) return true;
+  
+  // Get the value of the appropriate trigger varile
+  const double t_val = GetTriggerValue(entry->GetTrigger());
+  
+  return (t_val != DBL_MAX &&
+          (t_val >= entry->GetStart() || entry->GetStart() == TRIGGER_BEGIN) &&
+          (t_val <= entry->GetStop() || entry->GetStop() == TRIGGER_END));
+}
+
+
+// Read-only actions that fire back to back cannot see each other's effects, so the data gathering of the whole run
+// is handed to the analyze threads at once.  Returns the end of the run; Process() then writes each one in order.
+int cEventList::prepareReadOnly(const Apto::Array<cEventListEntry*, Apto::Smart>& candidates, int first)
+{
+  int end = first;
+  while (end < candidates.GetSize() && candidates[end]->GetAction()->IsReadOnly() && firesNow(candidates[end])) end++;
+  if (end - first < 2) return end; // a lone action does its own Prepare() in Process()
+  
+  // Build the shared population snapshot here, so the workers only ever read it
+  m_world->GetPopulation().GetSnapshot();
+  
+  tAnalyzeJobBatch<cAction> jobbatch(m_world->GetAnalyze().GetJobQueue());
+  for (int i = first; i < end; i++) jobbatch.AddJob(candidates[i]->GetAction(), &cAction::Prepare);
+  jobbatch.RunBatch();
+  
+  return end;
+}
+
+
+bool cEventList::isDue(const cEventListEntry* entry, double t_val)
+{
+  return (t_val >= entry->GetStart() || entry->GetStart() == TRIGGER_BEGIN);
+}
+
+
+// Place an event where the next Process will look for it
+void cEventList::enqueue(cEventListEntry* entry)
+{
+  int q = -1;
+  switch (entry->GetTrigger()) {
+    case UPDATE: q = QUEUE_UPDATE; break;
+    case BIRTHS: q = QUEUE_BIRTHS; break;
+    case BIRTHS_INTERRUPT: return; // processed by ProcessInterrupt, straight from the list
+    default: break;
+  }
+  
+  if (q == -1) {
+    m_scanned.Push(entry);
+    return;
+  }
+  
+  // Past its stop value the event can never fire again, since these triggers only grow; it stays in the list only
+  if (entry->GetStop() != TRIGGER_END && GetTriggerValue(entry->GetTrigger()) > entry->GetStop()) return;
+  
+  Apto::Array<cEventListEntry*, Apto::Smart>& queue = m_queue[q];
+  queue.Push(entry);
+  std::push_heap(&queue[0], &queue[0] + queue.GetSize(), firesBefore);
+}
+
+
+void cEventList::rebuildQueues()
+{
+  for (int q = 0; q < NUM_QUEUES; q++) m_queue[q].Resize(0);
+  m_scanned.Resize(0);
+  for (cEventListEntry* entry = m_head; entry != NULL; entry = entry->GetNext()) enqueue(entry);
 }
 
 
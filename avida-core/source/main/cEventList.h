@@ -29,6 +29,8 @@
 
 #include "tList.h"
 
+#include "apto/core/Array.h"
+
 
 namespace Avida {
   class Feedback;
@@ -75,13 +77,27 @@ private:
   cEventListEntry* m_head;
   cEventListEntry* m_tail;
   int m_num_events;
+  int m_next_id;
+  
+  // UPDATE and BIRTHS trigger values never decrease, so their events wait in a min-heap on the next value they fire
+  // at and Process only touches the ones that are due.  The other triggers are checked every time, as before.
+  enum { QUEUE_UPDATE = 0, QUEUE_BIRTHS, NUM_QUEUES };
+  Apto::Array<cEventListEntry*, Apto::Smart> m_queue[NUM_QUEUES];
+  Apto::Array<cEventListEntry*, Apto::Smart> m_scanned;
   
   tList<double> m_birth_interrupt_queue;
   
   void QueueBirthInterruptEvent(double t_val);
   void DequeueBirthInterruptEvent(double t_val);
   
-  void SyncEvent(cEventListEntry* event);
+  void enqueue(cEventListEntry* entry);
+  void rebuildQueues();
+  static bool firesBefore(const cEventListEntry* lhs, const cEventListEntry* rhs);
+  static bool isDue(const cEventListEntry* entry, double t_val);
+  bool firesNow(const cEventListEntry* entry) const;
+  int prepareReadOnly(const Apto::Array<cEventListEntry*, Apto::Smart>& candidates, int first);
+  
+  bool SyncEvent(cEventListEntry* event);
   double GetTriggerValue(eTriggerType trigger) const;
   void Delete(cEventListEntry* entry);
   
@@ -91,7 +107,7 @@ private:
   
   
 public:
-  cEventList(cWorld* world) : m_world(world), m_head(NULL), m_tail(NULL), m_num_events(0) { ; }
+  cEventList(cWorld* world) : m_world(world), m_head(NULL), m_tail(NULL), m_num_events(0), m_next_id(0) { ; }
   ~cEventList();
   
   
@@ -145,16 +161,17 @@ private:
     double m_interval;
     double m_stop;
     double m_original_start;
+    int m_id;                 // order of addition, which is also the order events due together are processed in
     
     cEventListEntry* m_prev;
     cEventListEntry* m_next;
     
   public:
-    cEventListEntry(cAction* action, const cString& name, eTriggerType trigger = UPDATE, double start = TRIGGER_BEGIN,
+    cEventListEntry(cAction* action, const cString& name, int id, eTriggerType trigger = UPDATE, double start = TRIGGER_BEGIN,
                     double interval = TRIGGER_ONCE, double stop = TRIGGER_END, cEventListEntry* prev = NULL,
                     cEventListEntry* next = NULL)
     : m_action(action), m_name(name), m_trigger(trigger), m_start(start), m_interval(interval), m_stop(stop)
-    , m_original_start(start), m_prev(prev), m_next(next)
+    , m_original_start(start), m_id(id), m_prev(prev), m_next(next)
     {
     }
     
@@ -176,9 +193,12 @@ private:
     double GetStart() const { return m_start; }
     double GetInterval() const { return m_interval; }
     double GetStop() const { return m_stop; }
+    int GetID() const { return m_id; }
     
     cEventListEntry* GetPrev() const { return m_prev; }
     cEventListEntry* GetNext() const { return m_next; }
+    
+    static bool CompareID(const cEventListEntry* lhs, const cEventListEntry* rhs) { return lhs->m_id < rhs->m_id; }
   };
   
 };
@@ -0,0 +1,142 @@
+/*
+ *  cFenwickScheduler.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cFenwickScheduler.h"
+
+#include <cassert>
+
+
+cFenwickScheduler::cFenwickScheduler(int entry_count, Apto::SmartPtr<Apto::Random> rng)
+  : m_size(entry_count), m_top_bit(1), m_rng(rng), m_tree(entry_count + 1), m_priority(entry_count)
+  , m_pending(entry_count), m_is_dirty(entry_count), m_total(0.0), m_adjusts_since_rebuild(0)
+{
+  while (m_top_bit * 2 <= m_size) m_top_bit *= 2;
+  m_tree.SetAll(0.0);
+  m_priority.SetAll(0.0);
+  m_pending.SetAll(0.0);
+  m_is_dirty.SetAll(false);
+}
+
+cFenwickScheduler::~cFenwickScheduler()
+{
+}
+
+
+void cFenwickScheduler::AdjustPriority(int entry_id, double priority)
+{
+  assert(entry_id >= 0 && entry_id < m_size);
+  assert(priority >= 0.0);
+
+  m_pending[entry_id] = priority;
+  if (!m_is_dirty[entry_id]) {
+    m_is_dirty[entry_id] = true;
+    m_dirty.Push(entry_id);
+  }
+}
+
+
+int cFenwickScheduler::Next()
+{
+  flush();
+  return draw();
+}
+
+void cFenwickScheduler::Next(int count, Apto::Array<int>& entry_ids)
+{
+  flush();
+  entry_ids.Resize(count);
+  for (int i = 0; i < count; i++) entry_ids[i] = draw();
+}
+
+
+void cFenwickScheduler::flush()
+{
+  const int num_dirty = m_dirty.GetSize();
+  if (!num_dirty) return;
+
+  // Each incremental update walks about log2(m_size) nodes, a rebuild touches every node twice
+  int depth = 1;
+  for (int bit = m_top_bit; bit > 1; bit >>= 1) depth++;
+  const bool bulk = (num_dirty * depth >= 2 * m_size) || (m_adjusts_since_rebuild + num_dirty > m_size);
+
+  for (int d = 0; d < num_dirty; d++) {
+    const int entry_id = m_dirty[d];
+    m_is_dirty[entry_id] = false;
+    const double delta = m_pending[entry_id] - m_priority[entry_id];
+    if (delta == 0.0) continue;
+    m_priority[entry_id] = m_pending[entry_id];
+    if (bulk) continue;
+
+    for (int node = entry_id + 1; node <= m_size; node += node & -node) m_tree[node] += delta;
+    m_total += delta;
+  }
+  m_dirty.Resize(0);
+
+  if (bulk) rebuild();
+  else m_adjusts_since_rebuild += num_dirty;
+}
+
+
+void cFenwickScheduler::rebuild()
+{
+  // Each node adds itself into its parent, with parents always after their children
+  m_tree[0] = 0.0;
+  for (int node = 1; node <= m_size; node++) m_tree[node] = m_priority[node - 1];
+  for (int node = 1; node <= m_size; node++) {
+    const int parent = node + (node & -node);
+    if (parent <= m_size) m_tree[parent] += m_tree[node];
+  }
+
+  m_total = 0.0;
+  for (int node = m_size; node > 0; node -= node & -node) m_total += m_tree[node];
+  m_adjusts_since_rebuild = 0;
+}
+
+
+// Index of the entry whose cumulative priority range holds position
+int cFenwickScheduler::find(double position) const
+{
+  int entry = 0;
+  for (int bit = m_top_bit; bit > 0; bit >>= 1) {
+    const int node = entry + bit;
+    if (node <= m_size && m_tree[node] <= position) {
+      entry = node;
+      position -= m_tree[node];
+    }
+  }
+  return entry;
+}
+
+
+int cFenwickScheduler::draw()
+{
+  if (m_total <= 0.0) return -1;
+
+  int entry_id = find(m_rng->GetDouble(m_total));
+  if (entry_id < m_size && m_priority[entry_id] > 0.0) return entry_id;
+
+  // Rounding in the incremental updates let the draw land on an empty entry, so start again from exact sums
+  rebuild();
+  if (m_total <= 0.0) return -1;
+  entry_id = find(m_rng->GetDouble(m_total));
+  while (entry_id > 0 && (entry_id >= m_size || m_priority[entry_id] <= 0.0)) entry_id--;
+  while (m_priority[entry_id] <= 0.0) entry_id++;
+  return entry_id;
+}
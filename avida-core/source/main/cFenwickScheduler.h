@@ -0,0 +1,71 @@
+/*
+ *  cFenwickScheduler.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cFenwickScheduler_h
+#define cFenwickScheduler_h
+
+#include "avida/core/Types.h"
+
+#include "apto/rng.h"
+
+
+// cFenwickScheduler hands out entries with probability proportional to their priority, like
+// Apto::Scheduler::Probabilistic, but keeps the priorities in a flat Fenwick (binary indexed) tree.  Priority changes
+// are only recorded when they arrive and applied before the next draw, so a cell that changes several times between
+// draws (a death followed by a birth, say) costs one tree update.  When many entries change at once, as after mixing
+// the population or replacing demes, the tree is rebuilt in a single linear pass instead.
+
+class cFenwickScheduler : public Apto::PriorityScheduler
+{
+private:
+  int m_size;
+  int m_top_bit;                           // largest power of two not above m_size
+  Apto::SmartPtr<Apto::Random> m_rng;
+  Apto::Array<double> m_tree;              // 1-based partial sums
+  Apto::Array<double> m_priority;          // priority of each entry as held in m_tree
+  Apto::Array<double> m_pending;           // latest priority handed in for each entry
+  Apto::Array<bool> m_is_dirty;
+  Apto::Array<int, Apto::Smart> m_dirty;   // entries whose pending priority is not in m_tree yet
+  double m_total;
+  int m_adjusts_since_rebuild;             // bounds the rounding error accumulated by incremental updates
+
+
+  cFenwickScheduler(const cFenwickScheduler&); // @not_implemented
+  cFenwickScheduler& operator=(const cFenwickScheduler&); // @not_implemented
+
+  void flush();
+  void rebuild();
+  int find(double position) const;
+  int draw();
+
+
+public:
+  cFenwickScheduler(int entry_count, Apto::SmartPtr<Apto::Random> rng);
+  ~cFenwickScheduler();
+
+  void AdjustPriority(int entry_id, double priority);
+  int Next();
+
+  // Draw count independent entries at once, all against the same set of priorities.  Entries are -1 if no entry has
+  // a positive priority.
+  void Next(int count, Apto::Array<int>& entry_ids);
+};
+
+#endif
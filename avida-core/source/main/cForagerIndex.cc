@@ -0,0 +1,144 @@
+/*
+ *  cForagerIndex.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cForagerIndex.h"
+
+#include <cassert>
+
+
+void cForagerIndex::Setup(int world_x, int world_y)
+{
+  m_world_x = world_x;
+  m_world_y = world_y;
+  const int num_cells = world_x * world_y;
+  m_occupied.Resize(num_cells);
+  m_pred.Resize(num_cells);
+  m_cell_kind.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_occupied[i] = 0;
+    m_pred[i] = 0;
+    m_cell_kind[i] = 0;
+  }
+}
+
+
+void cForagerIndex::Swap(int cell_id1, int cell_id2)
+{
+  const char kind1 = m_cell_kind[cell_id1];
+  const char kind2 = m_cell_kind[cell_id2];
+  if (kind1 == kind2) return;
+  setKind(cell_id1, kind2);
+  setKind(cell_id2, kind1);
+}
+
+
+int cForagerIndex::Count(int search_type, int min_x, int min_y, int max_x, int max_y) const
+{
+  if (min_x < 0) min_x = 0;
+  if (min_y < 0) min_y = 0;
+  if (max_x >= m_world_x) max_x = m_world_x - 1;
+  if (max_y >= m_world_y) max_y = m_world_y - 1;
+  if (min_x > max_x || min_y > max_y) return 0;
+
+  if (search_type > 0) return sumRect(m_pred, min_x, min_y, max_x, max_y);
+  const int occupied = sumRect(m_occupied, min_x, min_y, max_x, max_y);
+  if (search_type == 0) return occupied;
+  return occupied - sumRect(m_pred, min_x, min_y, max_x, max_y);
+}
+
+
+int cForagerIndex::CountTorus(int search_type, int min_x, int min_y, int max_x, int max_y) const
+{
+  if (min_x > max_x || min_y > max_y) return 0;
+
+  // Split each axis into at most two ranges inside the grid
+  int x_ranges[4] = { 0, m_world_x - 1, 0, -1 };
+  if (max_x - min_x + 1 < m_world_x) {
+    x_ranges[0] = ((min_x % m_world_x) + m_world_x) % m_world_x;
+    x_ranges[1] = x_ranges[0] + (max_x - min_x);
+    if (x_ranges[1] >= m_world_x) {
+      x_ranges[3] = x_ranges[1] - m_world_x;
+      x_ranges[1] = m_world_x - 1;
+    }
+  }
+  int y_ranges[4] = { 0, m_world_y - 1, 0, -1 };
+  if (max_y - min_y + 1 < m_world_y) {
+    y_ranges[0] = ((min_y % m_world_y) + m_world_y) % m_world_y;
+    y_ranges[1] = y_ranges[0] + (max_y - min_y);
+    if (y_ranges[1] >= m_world_y) {
+      y_ranges[3] = y_ranges[1] - m_world_y;
+      y_ranges[1] = m_world_y - 1;
+    }
+  }
+
+  int count = 0;
+  for (int i = 0; i < 4; i += 2) {
+    for (int j = 0; j < 4; j += 2) {
+      count += Count(search_type, x_ranges[i], y_ranges[j], x_ranges[i + 1], y_ranges[j + 1]);
+    }
+  }
+  return count;
+}
+
+
+void cForagerIndex::setKind(int cell_id, char kind)
+{
+  const char old_kind = m_cell_kind[cell_id];
+  if (old_kind == kind) return;
+
+  if (!old_kind) add(m_occupied, cell_id, 1);
+  else if (!kind) add(m_occupied, cell_id, -1);
+  if (old_kind == 2) add(m_pred, cell_id, -1);
+  else if (kind == 2) add(m_pred, cell_id, 1);
+  m_cell_kind[cell_id] = kind;
+}
+
+
+void cForagerIndex::add(Apto::Array<int>& tree, int cell_id, int delta)
+{
+  assert(cell_id >= 0 && cell_id < m_cell_kind.GetSize());
+
+  // Trees are stored row major with one based indices folded onto the zero based array
+  for (int y = cell_id / m_world_x + 1; y <= m_world_y; y += y & -y) {
+    for (int x = cell_id % m_world_x + 1; x <= m_world_x; x += x & -x) {
+      tree[(y - 1) * m_world_x + (x - 1)] += delta;
+    }
+  }
+}
+
+
+int cForagerIndex::prefix(const Apto::Array<int>& tree, int x, int y) const
+{
+  // Sum over the cells [0, x) by [0, y)
+  int sum = 0;
+  for (int j = y; j > 0; j -= j & -j) {
+    for (int i = x; i > 0; i -= i & -i) {
+      sum += tree[(j - 1) * m_world_x + (i - 1)];
+    }
+  }
+  return sum;
+}
+
+
+int cForagerIndex::sumRect(const Apto::Array<int>& tree, int min_x, int min_y, int max_x, int max_y) const
+{
+  return prefix(tree, max_x + 1, max_y + 1) - prefix(tree, min_x, max_y + 1)
+    - prefix(tree, max_x + 1, min_y) + prefix(tree, min_x, min_y);
+}
@@ -0,0 +1,72 @@
+/*
+ *  cForagerIndex.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cForagerIndex_h
+#define cForagerIndex_h
+
+#include "apto/core/Array.h"
+
+
+// cForagerIndex counts the occupied cells of the grid, and separately those holding a predator (forage target -2),
+// in two dimensional Fenwick trees.  Moving, adding or removing an organism and counting the organisms inside any
+// rectangle of cells all take O(log X * log Y), which lets the look instructions rule out empty parts of their
+// view without testing it cell by cell.
+//
+// Counts match the search types of cOrgSensor: 0 counts every organism, positive counts predators and negative
+// counts everything else.
+
+class cForagerIndex
+{
+private:
+  int m_world_x;
+  int m_world_y;
+  Apto::Array<int> m_occupied;    // Fenwick tree over all occupied cells
+  Apto::Array<int> m_pred;        // Fenwick tree over cells holding a predator
+  Apto::Array<char> m_cell_kind;  // 0 empty, 1 non-predator, 2 predator
+
+  void add(Apto::Array<int>& tree, int cell_id, int delta);
+  int prefix(const Apto::Array<int>& tree, int x, int y) const;
+  int sumRect(const Apto::Array<int>& tree, int min_x, int min_y, int max_x, int max_y) const;
+  void setKind(int cell_id, char kind);
+
+
+public:
+  cForagerIndex() : m_world_x(0), m_world_y(0) { ; }
+
+  // Start over with an empty world_x by world_y grid
+  void Setup(int world_x, int world_y);
+
+  void Insert(int cell_id, bool is_pred) { setKind(cell_id, is_pred ? 2 : 1); }
+  void Remove(int cell_id) { setKind(cell_id, 0); }
+
+  // The occupant of an occupied cell changed forage target
+  void Update(int cell_id, bool is_pred) { if (m_cell_kind[cell_id]) setKind(cell_id, is_pred ? 2 : 1); }
+
+  // The contents of two cells were exchanged
+  void Swap(int cell_id1, int cell_id2);
+
+  // Organisms matching search_type within the inclusive rectangle, which is clipped to the grid
+  int Count(int search_type, int min_x, int min_y, int max_x, int max_y) const;
+
+  // As Count, but the rectangle wraps around the edges of a torus
+  int CountTorus(int search_type, int min_x, int min_y, int max_x, int max_y) const;
+};
+
+#endif
@@ -44,6 +44,32 @@ using namespace AvidaTools;
 
 
 
+// Fill out with genome as rotated forward by rotate (see InstructionSequence::Rotate), starting at
+// position start of the rotated genome and wrapping around its end as often as needed.
+static void copyCircular(const InstructionSequence& genome, int rotate, int start, InstructionSequence& out) {
+	const int n = genome.GetSize();
+	int src = ((start - rotate) % n + n) % n;
+	for(int i=0; i<out.GetSize(); ++i) {
+		out[i] = genome[src];
+		if(++src == n) { src = 0; }
+	}
+}
+
+
+// The fragment sizes of a random split of a genome of the given size, drawn as RandomSplit always has.
+static void splitSizes(cAvidaContext& ctx, double mean, double variance, int genome_size, std::vector<int>& sizes) {
+	int remaining_size = genome_size;
+	do {
+		int fsize=0;
+		while(!fsize) {
+			fsize = std::min(remaining_size, static_cast<int>(floor(fabs(ctx.GetRandom().GetRandNormal(mean, variance)))));
+		}
+		sizes.push_back(fsize);
+		remaining_size -= fsize;
+	} while (remaining_size > 0);
+}
+
+
 /*! Distance between begin and end.
  */
 std::size_t cGenomeUtil::substring_match::distance() {
@@ -99,53 +125,128 @@ void cGenomeUtil::substring_match::rotate(int r, std::size_t n) {
 }
 
 
+namespace {
+	typedef unsigned long long MatchWord;
+	const int MATCH_WORD_BITS = 64;
+	
+	/*! Advance one 64 row block of a bit-parallel edit distance column (Myers, in Hyyro's blocked form).  pv and mv
+	 hold the +1 and -1 differences down the rows of the block, hin the difference along the row above it.  Returns
+	 the difference along the bottom row of the block.
+	 */
+	inline int advanceMatchBlock(MatchWord& pv, MatchWord& mv, MatchWord eq, int hin, int bottom_bit) {
+		const MatchWord hin_neg = (hin < 0) ? 1 : 0;
+		const MatchWord xv = eq | mv;
+		eq |= hin_neg;
+		const MatchWord xh = (((eq & pv) + pv) ^ pv) | eq;
+		MatchWord ph = mv | ~(xh | pv);
+		MatchWord mh = pv & xh;
+		
+		int hout = 0;
+		if((ph >> bottom_bit) & 1) { hout = 1; }
+		else if((mh >> bottom_bit) & 1) { hout = -1; }
+		
+		ph = (ph << 1) | ((hin > 0) ? 1 : 0);
+		mh = (mh << 1) | hin_neg;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+		return hout;
+	}
+}
+
+
 /*! Find (one of) the best substring matches of substring in base.
  
  The algorithm here is based on the well-known dynamic programming approach to
  finding a substring match.  Here, it has been extended to track the beginning and
  ending locations of that match.  Specifically, [begin,end) of the returned substring_match
  denotes the matched region in the base string.
+ 
+ The cost of the best match ending at every position of base is found first with a
+ bit-parallel pass, which keeps each column of the table as its row-to-row differences.
+ A match of cost c ending at end cannot begin before end - substring size - c, so the
+ table with begin tracking is only filled in over that window, with the same tie-breaking
+ as a pass over all of base (upper left, then above, then left).
  */
 cGenomeUtil::substring_match cGenomeUtil::FindSubstringMatch(const InstructionSequence& base, const InstructionSequence& substring) {
-	const int rows=substring.GetSize()+1;
-	const int cols=base.GetSize()+1;
-	substring_match* m[2];
-	m[0] = new substring_match[cols];
-	m[1] = new substring_match[cols];
-	substring_match* c=m[0];
-	substring_match* p=m[1];
-	
-	for(int j=1; j<cols; ++j) {
-		p[j].begin = j;
+	const int m = substring.GetSize();
+	const int n = base.GetSize();
+	if(m == 0) { return substring_match(0, 0, 0, n); }
+	
+	// match masks for the instructions of substring, with a final all-zero row for everything else
+	const int num_blocks = (m + MATCH_WORD_BITS - 1) / MATCH_WORD_BITS;
+	int sym_row[256];
+	for(int i=0; i<256; ++i) { sym_row[i] = -1; }
+	int num_syms = 0;
+	for(int i=0; i<m; ++i) {
+		if(sym_row[substring[i].GetOp()] == -1) { sym_row[substring[i].GetOp()] = num_syms++; }
 	}
+	std::vector<MatchWord> peq((num_syms + 1) * num_blocks, 0);
+	for(int i=0; i<m; ++i) {
+		peq[sym_row[substring[i].GetOp()] * num_blocks + i / MATCH_WORD_BITS] |= MatchWord(1) << (i % MATCH_WORD_BITS);
+	}
+	
+	// column 0 climbs by one down every row; the top row is all zero, since a match may begin anywhere.
+	std::vector<MatchWord> pv(num_blocks, ~MatchWord(0));
+	std::vector<MatchWord> mv(num_blocks, 0);
+	const int bottom_bit = (m - 1) % MATCH_WORD_BITS;
+	int score = m;
+	int best_cost = m;
+	int best_end = 0;
+	for(int j=1; j<=n; ++j) {
+		const int row = sym_row[base[j-1].GetOp()];
+		const MatchWord* eq = &peq[((row == -1) ? num_syms : row) * num_blocks];
+		int hout = 0;
+		for(int b=0; b<num_blocks; ++b) {
+			hout = advanceMatchBlock(pv[b], mv[b], eq[b], hout, (b == num_blocks - 1) ? bottom_bit : MATCH_WORD_BITS - 1);
+		}
+		score += hout;
+		if(score < best_cost) {
+			best_cost = score;
+			best_end = j;
+		}
+	}
+	if(best_end == 0) { return substring_match(0, 0, best_cost, n); }
+	
+	// fill in the window of columns [first, best_end] to find where the best match begins.
+	const int first = std::max(0, best_end - m - best_cost);
+	const int cols = best_end - first + 1;
+	std::vector<int> buf(4 * cols);
+	int* c_cost = &buf[0];
+	int* c_begin = &buf[cols];
+	int* p_cost = &buf[2 * cols];
+	int* p_begin = &buf[3 * cols];
+	for(int k=0; k<cols; ++k) {
+		p_cost[k] = 0;
+		p_begin[k] = first + k;
+	}
+	c_begin[0] = first;
 	
-	for(int i=1; i<rows; ++i) {
-		c[0].cost = i;
-		for(int j=1; j<cols; ++j) {
-			substring_match l[3] = {p[j-1], p[j], c[j-1]};
-			substring_match* s = &l[0]; // default match is to the upper left.
-			
-			if(substring[i-1] == base[j-1]) {
-				// if the characters match, take the default
-				c[j].cost = s->cost;
+	for(int i=1; i<=m; ++i) {
+		c_cost[0] = i;
+		const Instruction& inst = substring[i-1];
+		for(int k=1; k<cols; ++k) {
+			if(inst == base[first+k-1]) {
+				// if the characters match, take the upper left
+				c_cost[k] = p_cost[k-1];
+				c_begin[k] = p_begin[k-1];
+			} else if(p_cost[k-1] <= p_cost[k] && p_cost[k-1] <= c_cost[k-1]) {
+				// otherwise, the first of the minimum costs, plus 1.
+				c_cost[k] = p_cost[k-1] + 1;
+				c_begin[k] = p_begin[k-1];
+			} else if(p_cost[k] <= c_cost[k-1]) {
+				c_cost[k] = p_cost[k] + 1;
+				c_begin[k] = p_begin[k];
 			} else {
-				// otherwise, find the minimum cost, add 1.
-				s = std::min_element(l,l+3);
-				c[j].cost = s->cost + 1;				
+				c_cost[k] = c_cost[k-1] + 1;
+				c_begin[k] = c_begin[k-1];
 			}
-			
-			// update the beginning and end of the match.
-			c[j].begin = s->begin;
-			c[j].end = j;
 		}
-		std::swap(c,p);
+		std::swap(c_cost, p_cost);
+		std::swap(c_begin, p_begin);
 	}
 	
-	substring_match* min = std::min_element(p, p+cols);
-	min->size = base.GetSize();
-	delete [] m[0];
-	delete [] m[1];
-	return *min;
+	assert(p_cost[cols-1] == best_cost);
+	return substring_match(p_begin[cols-1], best_end, best_cost, n);
 }
 
 
@@ -164,17 +265,13 @@ cGenomeUtil::substring_match cGenomeUtil::FindSubstringMatch(const InstructionSe
  for the base string (note that, due to circularity, begin could be > end).
  */
 cGenomeUtil::substring_match cGenomeUtil::FindUnbiasedCircularMatch(cAvidaContext& ctx, const InstructionSequence& base, const InstructionSequence& substring) {
-	// create a copy of the genome:
-	InstructionSequence circ(base);
-	
-	// rotate it so that we remove bias for matching at the front of the genome:
-	const int rotate = ctx.GetRandom().GetInt(circ.GetSize());
-	circ.Rotate(rotate);
-	
-	// need to take circularity of the genome into account.
-	// we can do this by appending the genome with a copy of its first substring-size instructions.
-	InstructionSequence head = circ.Crop(0, substring.GetSize());
-	circ.Append(head);
+	// rotate the genome so that we remove bias for matching at the front of the genome, and take its
+	// circularity into account by continuing it for substring-size more instructions; both in one pass
+	// into the copy, rather than rotating, cropping and appending whole sequences.
+	const int n = base.GetSize();
+	const int rotate = ctx.GetRandom().GetInt(n);
+	InstructionSequence circ(n + substring.GetSize());
+	copyCircular(base, rotate, 0, circ);
 	
 	// find the location within the circular genome that best matches substring:
 	cGenomeUtil::substring_match location = FindSubstringMatch(circ, substring);	
@@ -190,22 +287,33 @@ cGenomeUtil::substring_match cGenomeUtil::FindUnbiasedCircularMatch(cAvidaContex
  */
 void cGenomeUtil::RandomSplit(cAvidaContext& ctx, double mean, double variance, const InstructionSequence& genome, fragment_list_type& fragments) {	
 	// rotate this genome to remove bais for the beginning and end of the genome:
-	InstructionSequence g(genome);
-	g.Rotate(ctx.GetRandom().GetInt(g.GetSize()));
+	const int rotate = ctx.GetRandom().GetInt(genome.GetSize());
+	std::vector<int> sizes;
+	splitSizes(ctx, mean, variance, genome.GetSize(), sizes);
 	
 	// chop this genome up into pieces, add each to the back of the fragment list.
-	int remaining_size = g.GetSize();
-	int i= 0;
-	do {
-		int fsize=0;
-		while(!fsize) {
-			fsize = std::min(remaining_size, static_cast<int>(floor(fabs(ctx.GetRandom().GetRandNormal(mean, variance)))));
-		}
-		
-		fragments.push_back(g.Crop(i, i + fsize));
-		i += fsize;
-		remaining_size -= fsize;
-	} while (remaining_size > 0);
+	int i = 0;
+	for(std::size_t f=0; f<sizes.size(); ++f) {
+		fragments.push_back(InstructionSequence(sizes[f]));
+		copyCircular(genome, rotate, i, fragments.back());
+		i += sizes[f];
+	}
+}
+
+
+/*! Pick one fragment of a random split of genome, drawing exactly what RandomSplit followed by a uniform
+ choice among its fragments would, but copying out only the fragment that is kept.
+ */
+InstructionSequence cGenomeUtil::RandomFragment(cAvidaContext& ctx, double mean, double variance, const InstructionSequence& genome) {
+	const int rotate = ctx.GetRandom().GetInt(genome.GetSize());
+	std::vector<int> sizes;
+	splitSizes(ctx, mean, variance, genome.GetSize(), sizes);
+	
+	const int selected = ctx.GetRandom().GetInt(sizes.size());
+	const int start = std::accumulate(sizes.begin(), sizes.begin() + selected, 0);
+	InstructionSequence fragment(sizes[selected]);
+	copyCircular(genome, rotate, start, fragment);
+	return fragment;
 }
 
 
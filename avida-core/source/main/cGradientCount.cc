@@ -119,6 +119,7 @@ cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height,
   , m_min_usedy(-1)
   , m_max_usedx(-1)
   , m_max_usedy(-1)
+  , m_kernel_radius(-1)
 {
   ResetGradRes(m_world->GetDefaultContext(), worldx, worldy);
 }
@@ -130,6 +131,21 @@ void cGradientCount::StateAll()
   return;
 }
 
+void cGradientCount::StepAll(cAvidaContext& ctx, double inflow, double decay)
+{
+  // Gradient resources never fold their deltas in StateAll, so the fused kernel of the base class does not apply.
+  // Keep the individual passes; pending deltas are still picked up whenever a single cell is modified.
+  UpdateCount(ctx);
+  Source(inflow);
+  Sink(decay);
+  if (GetCellListSize() > 0) {
+    CellInflow();
+    CellOutflow();
+  }
+  FlowAll();
+  StateAll();
+}
+
 void cGradientCount::UpdateCount(cAvidaContext& ctx)
 { 
   m_old_peakx = m_peakx;
@@ -153,7 +169,7 @@ void cGradientCount::updatePeakRes(cAvidaContext& ctx)
     int min_pos_x = max(m_peakx - m_spread - 1, 0);
     int max_pos_y = min(m_peaky + m_spread + 1, GetY() - 1);
     int min_pos_y = max(m_peaky - m_spread - 1, 0);
-    for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+    for (int ii = min_pos_x; ii < max_pos_x + 1 && !has_edible; ii++) {
       for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
         if (Element(jj * GetX() + ii).GetAmount() >= 1) {
           has_edible = true;
@@ -311,12 +327,16 @@ void cGradientCount::fillinResourceValues()
     m_current_height = m_height;
   }
 
+  // Cells beyond the spread are zeroed without a distance, those within it read theirs from the kernel
+  ensureDistanceKernel(m_spread);
   int plateau_cell = 0;
   for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
     for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
       double thisheight = 0.0;
-      double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
-      if (m_spread >= thisdist) {
+      const int dx = ii - m_peakx;
+      const int dy = jj - m_peaky;
+      if (abs(dx) <= m_spread && abs(dy) <= m_spread && m_spread >= peakDistance(dx, dy)) {
+        const double thisdist = peakDistance(dx, dy);
         // determine theoretical individual cells values and add one to distance from center 
         // (so that center point = radius 1, not 0)
         // also used to distinguish plateau cells
@@ -398,6 +418,20 @@ void cGradientCount::fillinResourceValues()
   m_just_reset = false;
 }
 
+void cGradientCount::ensureDistanceKernel(int radius)
+{
+  if (radius <= m_kernel_radius) return;
+  
+  const int width = 2 * radius + 1;
+  m_dist_kernel.Resize(width * width);
+  for (int dy = -radius; dy <= radius; dy++) {
+    for (int dx = -radius; dx <= radius; dx++) {
+      m_dist_kernel[(dy + radius) * width + dx + radius] = sqrt((double) dx * dx + (double) dy * dy);
+    }
+  }
+  m_kernel_radius = radius;
+}
+
 void cGradientCount::getCurrentPlatValues()
 { 
   int temp_height = 0;
@@ -409,9 +443,10 @@ void cGradientCount::getCurrentPlatValues()
   int plateau_box_max_y = m_peaky + temp_height + 1;
   int plateau_cell = 0;
   double amount_devoured = 0.0;
+  ensureDistanceKernel(temp_height + 1);
   for (int ii = plateau_box_min_x; ii < plateau_box_max_x + 1; ii++) {
     for (int jj = plateau_box_min_y; jj < plateau_box_max_y + 1; jj++) { 
-      double thisdist = sqrt((double) (m_peakx - ii) * (double) (m_peakx - ii) + (double) (m_peaky - jj) * (double) (m_peaky - jj));
+      double thisdist = peakDistance(ii - m_peakx, jj - m_peaky);
       double find_plat_dist = temp_height / (thisdist + 1);
       if ((find_plat_dist >= 1 && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize() > 0)) {
         double past_cell_height = m_plateau_array[plateau_cell];
@@ -874,10 +909,11 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
       int min_pos_y = max(m_peaky - rand_hill_radius - 1, 0);
 
       // look to place new cell values within a box around the hill center
+      ensureDistanceKernel(rand_hill_radius + 1);
       for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
         for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
           double thisheight = 0.0;
-          double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
+          double thisdist = peakDistance(ii - m_peakx, jj - m_peaky);
           // only plot values when within set config radius & if no larger amount has already been plotted for another overlapping hill
           if ((thisdist <= rand_hill_radius) && (Element(jj * GetX() + ii).GetAmount() <  m_plateau / (thisdist + 1))) {
           thisheight = m_plateau / (thisdist + 1);
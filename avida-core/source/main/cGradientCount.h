@@ -116,6 +116,11 @@ private:
   int m_min_usedy;
   int m_max_usedx;
   int m_max_usedy;
+  
+  // Distance to the peak of every offset up to m_kernel_radius away (row major, peak in the middle), so that cone and
+  // plateau profiles are stamped from a table instead of taking a square root per cell on each update
+  Apto::Array<double> m_dist_kernel;
+  int m_kernel_radius;
     
 public:
   cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay,              
@@ -129,6 +134,8 @@ public:
 
   void UpdateCount(cAvidaContext& ctx);
   void StateAll();
+  void StepAll(cAvidaContext& ctx, double inflow, double decay);
+  bool AffectsPopulation() const { return (m_predator || m_damage || m_deadly); }
   
   void SetGradInitialPlat(double plat_val) { m_initial_plat = plat_val; m_initial = true; }
   void SetGradPeakX(int peakx) { m_peakx = peakx; }
@@ -201,8 +208,17 @@ private:
   void updateBounds(int x, int y);
   void resetUsedBounds();
   void clearExistingProbRes();
+  void ensureDistanceKernel(int radius);
+  inline double peakDistance(int dx, int dy) const;
   
   inline void setHaloDirection(cAvidaContext& ctx);
 };
 
+
+inline double cGradientCount::peakDistance(int dx, int dy) const
+{
+  assert(dx >= -m_kernel_radius && dx <= m_kernel_radius && dy >= -m_kernel_radius && dy <= m_kernel_radius);
+  return m_dist_kernel[(dy + m_kernel_radius) * (2 * m_kernel_radius + 1) + dx + m_kernel_radius];
+}
+
 #endif
@@ -92,6 +92,7 @@ void cLandscape::Reset(const Genome& in_genome)
   neut_max = 0.0;
   
   m_num_found = 0;
+  m_chart_ready = false;
 }
 
 double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome)
@@ -99,7 +100,13 @@ double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome&
   testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
   
   double test_fitness = m_cpu_test_info.GetColonyFitness();
+  recordFitness(in_genome, test_fitness);
   
+  return test_fitness;
+}
+
+void cLandscape::recordFitness(const Genome& in_genome, double test_fitness)
+{
   total_fitness += test_fitness;
   total_sqr_fitness += test_fitness * test_fitness;
   total_count++;
@@ -118,8 +125,6 @@ double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome&
       peak_genome = in_genome;
     }
   }
-  
-  return test_fitness;
 }
 
 void cLandscape::ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu)
@@ -190,74 +195,79 @@ void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur
   mod_seq_p.DynamicCastFrom(mod_rep_p);
   InstructionSequence& mod_genome = *mod_seq_p;
   
+  Apto::Array<Genome> batch;
+  cTestCPU::sBatchResults results;
+  
   // Loop through all the lines of genome, testing trying all combinations.
   for (int line_num = start_line; line_num < max_line; line_num++) {
     int cur_inst = base_seq[line_num].GetOp();
     
+    // The final distance level tests all of the point mutants at this line as a single batch
+    if (cur_distance <= 1) batch.Resize(0);
+    
     // Loop through all instructions...
     for (int inst_num = 0; inst_num < inst_size; inst_num++) {
       if (cur_inst == inst_num) continue;
       
       mod_genome[line_num].SetOp(inst_num);
       if (cur_distance <= 1) {
-        ProcessGenome(ctx, testcpu, mg);
-        if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+        batch.Push(mg); // copies the sequence
       } else {
         Process_Body(ctx, testcpu, mg, cur_distance - 1, line_num + 1);
       }
     }
     
     mod_genome[line_num].SetOp(cur_inst);
+    
+    if (cur_distance <= 1) {
+      testcpu->TestGenomes(ctx, m_cpu_test_info, batch, results);
+      for (int i = 0; i < batch.GetSize(); i++) {
+        recordFitness(batch[i], results.colony_fitness[i]);
+        if (results.colony_fitness[i] >= neut_min) site_count[line_num]++;
+      }
+    }
   }
   
 }
 
 
 
-void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
+void cLandscape::prepareFitnessChart(cAvidaContext& ctx, bool require_viable_base)
 {
-  df.WriteComment("Detailed dump of the per-site, per-instruction fitness");
-  df.WriteComment("values for the entire single-step landscape.");
+  if (m_chart_ready) return;
   
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
+  if (base_fitness != 0.0 || !require_viable_base) BuildFitnessChart(ctx, testcpu);
+  m_chart_ready = true;
+  
+  delete testcpu;
+}
+
+void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
+{
+  df.WriteComment("Detailed dump of the per-site, per-instruction fitness");
+  df.WriteComment("values for the entire single-step landscape.");
+  
+  prepareFitnessChart(ctx, false);
+  
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
   const InstructionSequence& base_seq = *base_seq_p;
   const int max_line = base_seq.GetSize();
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
-  
-  Genome mg(base_genome);
-  InstructionSequencePtr mod_seq_p;
-  GeneticRepresentationPtr mod_rep_p = mg.Representation();
-  mod_seq_p.DynamicCastFrom(mod_rep_p);
-  InstructionSequence& mod_genome = *mod_seq_p;
+  const int inst_size = fitness_chart.GetNumCols();
   
-  // Loop through all the lines of genome, testing trying all combinations.
+  // Write out every line of the genome with all of its one-step mutants.
   for (int line_num = 0; line_num < max_line; line_num++) {
-    int cur_inst = base_seq[line_num].GetOp();
-    df.Write(cur_inst, "Original Instruction");
-
-    // Loop through all instructions...
-    double fitness = 0.0;
+    df.Write(base_seq[line_num].GetOp(), "Original Instruction");
     for (int inst_num = 0; inst_num < inst_size; inst_num++) {
-      if (cur_inst == inst_num) {
-        fitness = base_fitness;
-      } else {
-        mod_genome[line_num].SetOp(inst_num);
-        fitness = ProcessGenome(ctx, testcpu, mg);
-      }
-      df.Write(fitness, "Mutation Fitness (instruction = column_number - 2)");
+      df.Write(fitness_chart(line_num, inst_num), "Mutation Fitness (instruction = column_number - 2)");
     }
-
     df.Endl();
-    mod_genome[line_num].SetOp(cur_inst);
   }
-  
-  delete testcpu;
 }
 
 
@@ -332,15 +342,10 @@ void cLandscape::ProcessInsert(cAvidaContext& ctx)
 // Prediction for a landscape where n sites are _randomized_.
 void cLandscape::PredictWProcess(cAvidaContext& ctx, Avida::Output::File& df, int update)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-
-  distance = 1;
-  
-  // Get the info about the base creature.
-  ProcessBase(ctx, testcpu);
+  // Get the info about the base creature and its one-step mutants.
+  PreparePredict(ctx);
   if (base_fitness == 0.0) return;
   
-  BuildFitnessChart(ctx, testcpu);
   const int genome_size = fitness_chart.GetNumRows();
   const int inst_size = fitness_chart.GetNumCols();
   const double min_neut_fitness = 0.99;
@@ -447,23 +452,16 @@ void cLandscape::PredictWProcess(cAvidaContext& ctx, Avida::Output::File& df, in
     total_entropy += (log(static_cast<double>(site_count[i] + 1)) / max_ent);
   }
   complexity = base_seq.GetSize() - total_entropy;
-  
-  delete testcpu;
 }
 
 
 // Prediction for a landscape where n sites are _mutated_.
 void cLandscape::PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, int update)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-
-  distance = 1;
-  
-  // Get the info about the base creature.
-  ProcessBase(ctx, testcpu);
+  // Get the info about the base creature and its one-step mutants.
+  PreparePredict(ctx);
   if (base_fitness == 0.0) return;
   
-  BuildFitnessChart(ctx, testcpu);
   const int genome_size = fitness_chart.GetNumRows();
   const int inst_size = fitness_chart.GetNumCols();
   const double min_neut_fitness = 0.99;
@@ -594,8 +592,6 @@ void cLandscape::PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, i
     total_entropy += (log(static_cast<double>(site_count[i] + 1)) / max_ent);
   }
   complexity = base_seq.GetSize() - total_entropy;
-  
-  delete testcpu;
 }
 
 
@@ -827,6 +823,14 @@ void cLandscape::TestAllPairs(cAvidaContext& ctx)
 
 void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
 {
+  HillClimbProcess(ctx);
+  PrintHillClimb(df);
+}
+
+void cLandscape::HillClimbProcess(cAvidaContext& ctx)
+{
+  m_climb_steps.Resize(0);
+  
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   Genome cur_genome(base_genome);
   Genome mg(base_genome);
@@ -883,19 +887,20 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
     
     pos_frac = GetProbPos();
     
-    // Print the information on the current best.
+    // Record the information on the current best.
     testcpu->TestGenome(ctx, m_cpu_test_info, cur_genome);
     cPhenotype& colony_phenotype = m_cpu_test_info.GetColonyOrganism()->GetPhenotype();
-    df.Write(gen, "Generation");
-    df.Write(colony_phenotype.GetMerit().GetDouble(), "Merit");
-    df.Write(colony_phenotype.GetGestationTime(), "Gestation Time");
-    df.Write(colony_phenotype.GetFitness(), "Fitness");
-    df.Write(cur_seq.GetSize(), "Genome Length");
-    df.Write(GetProbDead(), "Probability Lethal");
-    df.Write(GetProbNeg(), "Probability Deleterious");
-    df.Write(GetProbNeut(), "Probability Neutral");
-    df.Write(GetProbPos(), "Probability Beneficial");
-    df.Endl();
+    sClimbStep step;
+    step.generation = gen;
+    step.merit = colony_phenotype.GetMerit().GetDouble();
+    step.gestation_time = colony_phenotype.GetGestationTime();
+    step.fitness = colony_phenotype.GetFitness();
+    step.genome_length = cur_seq.GetSize();
+    step.prob_dead = GetProbDead();
+    step.prob_neg = GetProbNeg();
+    step.prob_neut = GetProbNeut();
+    step.prob_pos = GetProbPos();
+    m_climb_steps.Push(step);
               
     // Move on to the peak genome found.
     cur_genome = GetPeakGenome();
@@ -906,6 +911,24 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
 }
 
 
+void cLandscape::PrintHillClimb(Avida::Output::File& df)
+{
+  for (int i = 0; i < m_climb_steps.GetSize(); i++) {
+    const sClimbStep& step = m_climb_steps[i];
+    df.Write(step.generation, "Generation");
+    df.Write(step.merit, "Merit");
+    df.Write(step.gestation_time, "Gestation Time");
+    df.Write(step.fitness, "Fitness");
+    df.Write(step.genome_length, "Genome Length");
+    df.Write(step.prob_dead, "Probability Lethal");
+    df.Write(step.prob_neg, "Probability Deleterious");
+    df.Write(step.prob_neut, "Probability Neutral");
+    df.Write(step.prob_pos, "Probability Beneficial");
+    df.Endl();
+  }
+}
+
+
 double cLandscape::TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mod_genome, int line1, int line2,
                                const Instruction& mut1, const Instruction& mut2)
 {
@@ -86,6 +86,22 @@ private:
   double neut_min;         // These two variables are a range around the base
   double neut_max;         //   fitness to be counted as neutral mutations.
   tMatrix<double> fitness_chart; // Chart of all one-step mutations.
+  bool m_chart_ready;            // fitness_chart (and base stats) already computed for base_genome
+  
+  // One row of hill climb output, collected by HillClimbProcess and written by PrintHillClimb
+  struct sClimbStep
+  {
+    int generation;
+    double merit;
+    int gestation_time;
+    double fitness;
+    int genome_length;
+    double prob_dead;
+    double prob_neg;
+    double prob_neut;
+    double prob_pos;
+  };
+  Apto::Array<sClimbStep> m_climb_steps;
   
   int m_num_found;
 
@@ -107,6 +123,11 @@ public:
   void PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, int update = -1);
   void ProcessDump(cAvidaContext& ctx, Avida::Output::File& df);
   
+  // Run the test CPU work of ProcessDump or PredictW/NuProcess ahead of time (e.g. from a job queue worker), so that
+  // the later call only writes output
+  void PrepareDump(cAvidaContext& ctx) { prepareFitnessChart(ctx, false); }
+  void PreparePredict(cAvidaContext& ctx) { distance = 1; prepareFitnessChart(ctx, true); }
+  
   inline void SetDistance(int in_distance) { distance = in_distance; }
   inline void SetTrials(int in_trials) { trials = in_trials; }
   inline void SetMinFound(int min_found) { m_min_found = min_found; }
@@ -125,6 +146,8 @@ public:
   void TestAllPairs(cAvidaContext& ctx);
 
   void HillClimb(cAvidaContext& ctx, Avida::Output::File& df);
+  void HillClimbProcess(cAvidaContext& ctx);
+  void PrintHillClimb(Avida::Output::File& df);
 
   void PrintStats(Avida::Output::File& df, int update = -1);
   void PrintEntropy(Avida::Output::File& fp);
@@ -168,7 +191,9 @@ public:
   
 private:
   void BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu);
+  void prepareFitnessChart(cAvidaContext& ctx, bool require_viable_base);
   double ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome);
+  void recordFitness(const Genome& in_genome, double test_fitness);
   void ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu);
   void Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome, int cur_distance, int start_line);
   
@@ -0,0 +1,123 @@
+/*
+ *  cMatchString.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMatchString_h
+#define cMatchString_h
+
+#include "apto/core/Array.h"
+
+#include "cString.h"
+#include "tBuffer.h"
+
+
+// cMatchString is the target string of the string matching tasks (MatchStr, MatchProdStr and the prod-string
+// instruction), pre-encoded as bit masks when the environment is loaded.  Every position that must be a 0 or a 1 has
+// its bit set in the zeros or ones mask; any other character, such as the '9' wildcard, never matches.
+//
+// CountMatches compares the string with the most recent outputs, position 0 being the last output, 64 positions per
+// mask and popcount.  CountValueMatches compares it with the bits of a single output, bit 0 against the last character.
+
+class cMatchString
+{
+private:
+  typedef unsigned long long tField;
+  static const int FIELD_BITS = 64;
+
+  cString m_string;
+  int m_num_real;                 // positions that are not the '9' wildcard
+  Apto::Array<tField> m_zeros;    // bit j of field j / FIELD_BITS for position j
+  Apto::Array<tField> m_ones;
+  unsigned int m_value_zeros;     // bit j for position size - 1 - j, for the 32 bits of an output value
+  unsigned int m_value_ones;
+
+  static inline int countField(tField field);
+
+public:
+  cMatchString() : m_num_real(0), m_value_zeros(0), m_value_ones(0) { ; }
+  explicit inline cMatchString(const cString& str);
+
+  const cString& GetString() const { return m_string; }
+  int GetSize() const { return m_string.GetSize(); }
+  int GetNumReal() const { return m_num_real; }
+
+  inline int CountMatches(const tBuffer<int>& outputs) const;
+  int CountValueMatches(int value) const
+  {
+    return countField(((~(unsigned int)value & m_value_zeros) | ((unsigned int)value & m_value_ones)));
+  }
+};
+
+
+inline cMatchString::cMatchString(const cString& str)
+  : m_string(str), m_num_real(0), m_zeros((str.GetSize() + FIELD_BITS - 1) / FIELD_BITS)
+  , m_ones((str.GetSize() + FIELD_BITS - 1) / FIELD_BITS), m_value_zeros(0), m_value_ones(0)
+{
+  m_zeros.SetAll(0);
+  m_ones.SetAll(0);
+  const int size = str.GetSize();
+  for (int j = 0; j < size; j++) {
+    if (str[j] != '9') m_num_real++;
+    if (str[j] != '0' && str[j] != '1') continue;
+
+    const tField bit = tField(1) << (j % FIELD_BITS);
+    if (str[j] == '0') m_zeros[j / FIELD_BITS] |= bit;
+    else m_ones[j / FIELD_BITS] |= bit;
+
+    const int value_bit = size - 1 - j;
+    if (value_bit >= 32) continue;
+    if (str[j] == '0') m_value_zeros |= (1u << value_bit);
+    else m_value_ones |= (1u << value_bit);
+  }
+}
+
+
+inline int cMatchString::CountMatches(const tBuffer<int>& outputs) const
+{
+  const int size = m_string.GetSize();
+  int num_matched = 0;
+  for (int f = 0; f < m_ones.GetSize(); f++) {
+    const int first = f * FIELD_BITS;
+    const int last = (first + FIELD_BITS < size) ? (first + FIELD_BITS) : size;
+    tField ones = 0;
+    tField zeros = 0;
+    for (int j = first; j < last; j++) {
+      const int output = outputs[j];
+      ones |= tField(output == 1) << (j - first);
+      zeros |= tField(output == 0) << (j - first);
+    }
+    num_matched += countField((ones & m_ones[f]) | (zeros & m_zeros[f]));
+  }
+  return num_matched;
+}
+
+
+inline int cMatchString::countField(tField field)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll(field);
+#else
+  field = field - ((field >> 1) & 0x5555555555555555ULL);
+  field = (field & 0x3333333333333333ULL) + ((field >> 2) & 0x3333333333333333ULL);
+  field = (field + (field >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int)((field * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+#endif
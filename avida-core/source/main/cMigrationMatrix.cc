@@ -35,11 +35,7 @@ int cMigrationMatrix::GetParasiteCountAt(int from_deme_id, int to_deme_id){
 
 bool cMigrationMatrix::AlterConnectionWeight(const int from_deme_id, const int to_deme_id, const double alter_amount){
   m_migration_matrix[from_deme_id][to_deme_id] += alter_amount;
-  m_row_connectivity_sums[from_deme_id] += alter_amount;
-  double row_sum = 0.0;
-  for(int col = 0; col < m_migration_matrix[from_deme_id].GetSize();col++){
-    row_sum += m_migration_matrix[from_deme_id][col];
-  }
+  double row_sum = rebuildRow(from_deme_id);
   if(m_migration_matrix[from_deme_id][to_deme_id] < 0.0 || row_sum <= 0.0){
     return false;
   }
@@ -49,21 +45,30 @@ bool cMigrationMatrix::AlterConnectionWeight(const int from_deme_id, const int t
 
 int cMigrationMatrix::GetProbabilisticDemeID(const int from_deme_id, Apto::Random& p_rng,bool p_is_parasite_migration){
     assert(0 <= from_deme_id && from_deme_id < m_migration_matrix.GetSize());
-    double rand_dbl_value_in_range = p_rng.GetDouble(m_row_connectivity_sums[from_deme_id]);
-    for(int col = 0; col < m_migration_matrix[from_deme_id].GetSize(); col++){
-        rand_dbl_value_in_range -= m_migration_matrix[from_deme_id][col];
-        if(rand_dbl_value_in_range <= 0.0){
-            if(p_is_parasite_migration)
-              m_parasite_migration_counts[from_deme_id][col] += 1;
-            else
-              m_offspring_migration_counts[from_deme_id][col] += 1;
-          
-            return col;
-        }
-    }    
-    // Should never get to this point
-    assert(false);
-  return -1;
+    const Apto::Array<int, Apto::Smart>& columns = m_row_columns[from_deme_id];
+    const Apto::Array<double, Apto::Smart>& cumulative = m_row_cumulative_weights[from_deme_id];
+    // Should never happen, rows without weight are rejected by Load and reported by AlterConnectionWeight
+    assert(columns.GetSize() > 0);
+    if(columns.GetSize() == 0) return -1;
+  
+    // First column whose cumulative weight reaches the drawn value
+    double rand_dbl_value_in_range = p_rng.GetDouble(cumulative[cumulative.GetSize() - 1]);
+    int lo = 0;
+    int hi = columns.GetSize() - 1;
+    while(lo < hi){
+        int mid = (lo + hi) / 2;
+        if(cumulative[mid] < rand_dbl_value_in_range)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+  
+    const int col = columns[lo];
+    if(p_is_parasite_migration)
+      m_parasite_migration_counts[from_deme_id][col] += 1;
+    else
+      m_offspring_migration_counts[from_deme_id][col] += 1;
+    return col;
 };
 
 bool cMigrationMatrix::Load(const int num_demes, const cString& filename, const cString& working_dir,bool p_count_parasites, bool p_count_offspring, bool p_is_reload, Feedback& feedback){
@@ -112,6 +117,12 @@ bool cMigrationMatrix::Load(const int num_demes, const cString& filename, const
     m_migration_matrix.Push(f_temp_row);
   }
   
+  m_row_columns.ResizeClear(m_migration_matrix.GetSize());
+  m_row_cumulative_weights.ResizeClear(m_migration_matrix.GetSize());
+  for(int f_row = 0; f_row < m_migration_matrix.GetSize(); f_row++){
+    rebuildRow(f_row);
+  }
+  
   if(num_demes != m_migration_matrix.GetSize()){
     feedback.Error("The number of demes in the migration matrix (%i) did not match the NUM_DEMES (%i) parameter in avida.cfg.",m_migration_matrix.GetSize(),num_demes);
     return false;
@@ -145,6 +156,28 @@ bool cMigrationMatrix::Load(const int num_demes, const cString& filename, const
   return true;
 }
 
+// Rebuild the sampling form of a row, returning the sum of its weights
+double cMigrationMatrix::rebuildRow(int row){
+  Apto::Array<int, Apto::Smart>& columns = m_row_columns[row];
+  Apto::Array<double, Apto::Smart>& cumulative = m_row_cumulative_weights[row];
+  columns.Resize(0);
+  cumulative.Resize(0);
+  
+  double row_sum = 0.0;
+  double positive_sum = 0.0;
+  for(int col = 0; col < m_migration_matrix[row].GetSize(); col++){
+    const double weight = m_migration_matrix[row][col];
+    row_sum += weight;
+    if(weight > 0.0){
+      positive_sum += weight;
+      columns.Push(col);
+      cumulative.Push(positive_sum);
+    }
+  }
+  m_row_connectivity_sums[row] = row_sum;
+  return row_sum;
+}
+
 void cMigrationMatrix::Print(){
     for(int row = 0; row < m_migration_matrix.GetSize(); row++){
         for(int col = 0; col < m_migration_matrix[row].GetSize(); col++){
@@ -50,6 +50,13 @@ public:
 private:
   Apto::Array< Apto::Array<double, Apto::Smart>, Apto::Smart > m_migration_matrix;
   Apto::Array<double> m_row_connectivity_sums;
+  
+  // Sparse sampling form of each row: the columns with a positive weight and the running sum of their weights, so
+  // that a destination is found by binary search.  Rebuilt whenever the row changes.
+  Apto::Array< Apto::Array<int, Apto::Smart>, Apto::Smart > m_row_columns;
+  Apto::Array< Apto::Array<double, Apto::Smart>, Apto::Smart > m_row_cumulative_weights;
+  
+  double rebuildRow(int row);
   Apto::Array< Apto::Array<int, Apto::Smart>, Apto::Smart > m_parasite_migration_counts;
   Apto::Array< Apto::Array<int, Apto::Smart>, Apto::Smart >  m_offspring_migration_counts;
 };
@@ -28,8 +28,10 @@
 #endif
 
 #if BOOST_IS_AVAILABLE
-#include "avida/core/Sequence.h"
+#include "avida/core/InstructionSequence.h"
+#include "avida/core/Properties.h"
 
+#include "cHardwareManager.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cMerit.h"
@@ -38,12 +40,11 @@
 #include "cPopulationCell.h"
 #include "cMultiProcessWorld.h"
 #include "nGeometry.h"
-#include <map>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <cmath>
-#include <boost/optional.hpp>
 
 using namespace Avida;
 
@@ -53,40 +54,99 @@ static const char* UPDATE="mean update time [ut]";
 static const char* POSTUPDATE="mean post-update time [post]";
 static const char* CALCUPDATE="mean calc-update time [calc]";
 
-/*! Message that is sent from one cMultiProcessWorld to another during organism
- migration.
- */
-struct migration_message {
-	//! Default constructor.
-	migration_message() { }
+// all migrant batches share one tag; MPI keeps messages between a pair of ranks in order.
+static const int MIGRANT_BATCH_TAG=1;
+
+
+namespace {
+	template<typename T> void pack_value(std::vector<char>& buf, const T& value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buf.insert(buf.end(), bytes, bytes + sizeof(T));
+	}
 	
-	//! Initializing constructor.
-	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
-	: _merit(merit), _lineage(lineage) {
-		_genome = org->GetGenome().AsString();
-		cell.GetPosition(_x, _y);
-		_generation = org->GetPhenotype().GetGeneration();
+	template<typename T> bool unpack_value(const std::vector<char>& buf, std::size_t& pos, T& value) {
+		if((buf.size() - pos) < sizeof(T)) {
+			return false;
+		}
+		memcpy(&value, &buf[pos], sizeof(T));
+		pos += sizeof(T);
+		return true;
 	}
+}
 
-	//! Finish unpacking an organism from this message.
-	void unpack(cOrganism* org) {
-		org->UpdateMerit(cAvidaContext& ctx, _merit);
-		org->GetPhenotype().SetGeneration(_generation);
-	}	
+
+/*! Pack a migrating organism onto the end of the batch.
+ */
+void migrant_batch::push(cOrganism* org, const cPopulationCell& cell, double merit, int lineage, bool relocated) {
+	const Genome& genome = org->GetGenome();
+	ConstInstructionSequencePtr seq;
+	seq.DynamicCastFrom(genome.Representation());
+	const Apto::String inst_set = genome.Properties().Get("instset").StringValue();
+	int x, y;
+	cell.GetPosition(x, y);
 	
-	//! Serializer, used to (de)marshal organisms for migration.
-	template<class Archive>
-	void serialize(Archive & ar, const unsigned int version) {
-		ar & _genome & _merit & _lineage & _x & _y & _generation;
+	pack_value(m_buf, merit);
+	pack_value(m_buf, lineage);
+	pack_value(m_buf, x);
+	pack_value(m_buf, y);
+	pack_value(m_buf, org->GetPhenotype().GetGeneration());
+	pack_value(m_buf, static_cast<int>(genome.HardwareType()));
+	pack_value(m_buf, static_cast<unsigned char>(relocated));
+	pack_value(m_buf, static_cast<unsigned short>(inst_set.GetSize()));
+	m_buf.insert(m_buf.end(), (const char*)inst_set, (const char*)inst_set + inst_set.GetSize());
+	pack_value(m_buf, seq->GetSize());
+	for(int i=0; i<seq->GetSize(); ++i) {
+		m_buf.push_back(static_cast<char>((*seq)[i].GetOp()));
+	}
+	++m_count;
+}
+
+
+/*! Unpack the next migrant, returns false once all have been read.
+ */
+bool migrant_batch::pop(migration_message& msg) {
+	unsigned char relocated = 0;
+	unsigned short inst_set_len = 0;
+	int genome_len = 0;
+	if(!unpack_value(m_buf, m_read_pos, msg._merit) || !unpack_value(m_buf, m_read_pos, msg._lineage)
+		 || !unpack_value(m_buf, m_read_pos, msg._x) || !unpack_value(m_buf, m_read_pos, msg._y)
+		 || !unpack_value(m_buf, m_read_pos, msg._generation) || !unpack_value(m_buf, m_read_pos, msg._hw_type)
+		 || !unpack_value(m_buf, m_read_pos, relocated) || !unpack_value(m_buf, m_read_pos, inst_set_len) || ((m_buf.size() - m_read_pos) < inst_set_len)) {
+		return false;
 	}
+	msg._relocated = (relocated != 0);
+	msg._inst_set.assign(&m_buf[0] + m_read_pos, inst_set_len);
+	m_read_pos += inst_set_len;
 	
-	std::string _genome; //!< Genome of the migrating organism.
-	double _merit; //!< Merit of this organism in its originating population.
-	int _lineage; //!< Lineage label of this organism in its orginating population.
-	int _x; //!< X-coordinate of the cell from which this migrant originated.
-	int _y; //!< Y-coordinate of the cell from which this migrant originated.
-	int _generation; //!< Generation of this organism.
-};
+	if(!unpack_value(m_buf, m_read_pos, genome_len) || (genome_len < 0)
+		 || ((m_buf.size() - m_read_pos) < static_cast<std::size_t>(genome_len))) {
+		return false;
+	}
+	msg._ops.assign(m_buf.begin() + m_read_pos, m_buf.begin() + m_read_pos + genome_len);
+	m_read_pos += genome_len;
+	return true;
+}
+
+
+/*! Rebuild the genome of the migrating organism.
+ */
+Genome migration_message::genome() const {
+	InstructionSequencePtr seq(new InstructionSequence(_ops.size()));
+	for(std::size_t i=0; i<_ops.size(); ++i) {
+		(*seq)[i].SetOp(_ops[i]);
+	}
+	HashPropertyMap props;
+	cHardwareManager::SetupPropertyMap(props, _inst_set.c_str());
+	return Genome(_hw_type, props, seq);
+}
+
+
+/*! Finish unpacking an organism from this message.
+ */
+void migration_message::unpack(cAvidaContext& ctx, cOrganism* org) {
+	org->UpdateMerit(ctx, _merit);
+	org->GetPhenotype().SetGeneration(_generation);
+}
 
 
 /*! Create and initialize a cMultiProcessWorld.
@@ -114,7 +174,15 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 , m_universe_dim(0)
 , m_universe_x(0)
 , m_universe_y(0)
-, m_universe_popsize(-1) {
+, m_universe_popsize(-1)
+, m_local_merit(0.0)
+, m_universe_merit(0.0)
+, m_reduced_update(-1)
+, m_update_size_update(-1)
+, m_update_size(0)
+, m_num_in_flight(0)
+, m_balance_time(0.0)
+, m_balance_updates(0) {
 	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
 		// there are a couple bugs in spatial that still need to be worked out:
 		// specifically, what to do about size(1) universes?
@@ -129,6 +197,67 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 		m_universe_x = m_mpi_world.rank() % m_universe_dim;
 		m_universe_y = m_mpi_world.rank() / m_universe_dim;
 	}
+	
+	SetupNeighbors();
+}
+
+
+/*! Destructor.
+ 
+ Every world runs the same number of updates, so the batches sent after the final
+ update are matched by receives that every neighbor has already posted.  Migrants in
+ those batches are dropped along with the rest of the population.
+ */
+cMultiProcessWorld::~cMultiProcessWorld() {
+	boost::mpi::wait_all(m_send_reqs.begin(), m_send_reqs.end());
+	boost::mpi::wait_all(m_recv_reqs.begin(), m_recv_reqs.end());
+}
+
+
+/*! Determine the worlds that this world can exchange migrants with.
+ 
+ This must cover every destination that MigrateOrganism can choose, and the relation
+ must be symmetric, since each world waits for one batch from each of its neighbors.
+ */
+void cMultiProcessWorld::SetupNeighbors() {
+	const int rank = m_mpi_world.rank();
+	const int size = m_mpi_world.size();
+	
+	std::vector<int> candidates;
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_RANDOM: { // spatial, the adjacent worlds
+			candidates.push_back(rank - 1);
+			candidates.push_back(rank + 1);
+			candidates.push_back(rank - m_universe_dim);
+			candidates.push_back(rank + m_universe_dim);
+			break;
+		}
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action, every other world
+			for(int i=0; i<size; ++i) {
+				if((i != rank) || (size == 1)) {
+					candidates.push_back(i);
+				}
+			}
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+	
+	m_neighbor_slot.assign(size, -1);
+	for(std::size_t i=0; i<candidates.size(); ++i) {
+		const int r = candidates[i];
+		if((r < 0) || (r >= size) || (m_neighbor_slot[r] != -1) || ((r == rank) && (size > 1))) {
+			continue;
+		}
+		m_neighbor_slot[r] = m_neighbors.size();
+		m_neighbors.push_back(r);
+	}
+	
+	m_outbox.resize(m_neighbors.size());
+	m_sent.resize(m_neighbors.size());
+	m_inbox.resize(m_neighbors.size());
 }
 
 
@@ -183,10 +312,11 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 
 	assert(dst_world < m_mpi_world.size());
 	assert(dst_world >= 0);
+	assert(m_neighbor_slot[dst_world] != -1);
 
-	// the tag is set to the number of messages previously sent; this is to allow
-	// the receiver to sort messages for consistency.
-	m_reqs.push_back(m_mpi_world.isend(dst_world, m_reqs.size(), migration_message(org, cell, merit.GetDouble(), lineage)));
+	// migrants are batched per neighbor and sent together in ProcessPostUpdate; the
+	// order within a batch keeps injection consistent on the receiver.
+	m_outbox[m_neighbor_slot[dst_world]].push(org, cell, merit.GetDouble(), lineage);
 	
 	// stats tracking:
 	GetStats().OutgoingMigrant(org);
@@ -259,92 +389,62 @@ bool cMultiProcessWorld::IsWorldBoundary(const cPopulationCell& cell) {
 /*! Process post-update events.
  
  This method is called after each update of the local population completes.  Here
- we check to see if this world has received any migrants from other worlds, and if
- so, we inject them into the local population.  Note that this is an unconditional
- injection -- that is, migrants are "pushed" to this world.
+ we inject the migrants that neighboring worlds sent at the end of the previous
+ update, and send this update's migrants on to the neighbors.  Note that this is an
+ unconditional injection -- that is, migrants are "pushed" to this world.
  
  Migrants are injected according to BIRTH_METHOD.
  
- \todo What to do about cross-world lineage labels?
+ Only neighbors are waited on, and their batches have had a full update to arrive,
+ so in the steady state no world blocks on the slowest world in the universe.
  
- \todo At the moment, this method forces synchronization on update boundaries across
- *all* worlds.  This could slow things down quite a bit, so we may need to consider a
- second mode that relaxes consistency in favor of speed.
+ \todo What to do about cross-world lineage labels?
  */
 void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 	namespace mpi = boost::mpi;
-	using namespace boost;
 	
 	// restart the timer for this method, and get the elapsed time for the past update:
 	m_pf[UPDATE] = m_update_timer.elapsed();
 	m_post_update_timer.restart();
 	
-	// wait until we're sure that this process has sent all its messages:
-	mpi::wait_all(m_reqs.begin(), m_reqs.end());
-	m_reqs.clear();
+	// complete the receives posted at the end of the previous update; each neighbor sends
+	// exactly one, so there is nothing left to probe for.
+	mpi::wait_all(m_recv_reqs.begin(), m_recv_reqs.end());
+	m_recv_reqs.clear();
 	
-	// at this point, we know that *this* process has sent everything.  but, we don't
-	// know if it's *received* everything.  so, we're going to put in a synchronization
-	// barrier, which means that every process must reach the barrier before any are allowed
-	// to proceed.  since we just finished waiting for all communication to complete,
-	// this means that all messages must have been received, too.
-	m_mpi_world.barrier();	
-	
-	// now, receive all the messages, but store them in order by source and tag:
-	typedef std::map<int,migration_message> rx_tag_t;
-	typedef std::map<int,rx_tag_t> rx_src_t;
-	rx_src_t recvd;
-	optional<mpi::status> s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);
-	while(s.is_initialized()) {
-		migration_message msg;
-		m_mpi_world.recv(s->source(), s->tag(), msg);
-		recvd[s->source()][s->tag()] = msg;		
-		// any others?
-		s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);		
-	}
-	
-	// iterate over received messages in-order, injecting genomes into our population:
-	for(rx_src_t::iterator i=recvd.begin(); i!=recvd.end(); ++i) {
-		for(rx_tag_t::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
-			//std::cerr << "**********  INJECTING *********** " << i->first << " " << j->first << std::endl;
-			// ok, add this migrant to the current population
-			migration_message& migrant = j->second;
-			int target_cell=-1;
-			
-			switch(GetConfig().BIRTH_METHOD.Get()) {
-				case POSITION_OFFSPRING_RANDOM: { // spatial
-					// invert the orginating cell
-					migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
-					migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
-					target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
-					break;
-				}
-				case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-					target_cell = GetRandom().GetInt(GetPopulation().GetSize());
-					break;
-				}
-				default: {
-					GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
-				}
-			}
-			
-			GetPopulation().InjectGenome(target_cell,
-																	 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
-																	 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
-																	 ctx, migrant._lineage); // lineage label
-			// unpack the rest from the message:
-			migrant.unpack(GetPopulation().GetCell(target_cell).GetOrganism());
-			GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
+	// inject in neighbor order, and in send order within each batch:
+	migration_message migrant;
+	for(std::size_t i=0; i<m_inbox.size(); ++i) {
+		while(m_inbox[i].pop(migrant)) {
+			InjectMigrant(ctx, migrant);
 		}
+		m_inbox[i].clear();
 	}
 	
-	// oh, sweet sanity; make sure that we actually processed all messages.
-	assert(!m_mpi_world.iprobe(mpi::any_source,mpi::any_tag).is_initialized());
+	// the previous batches have been received by now in all but the rarest cases:
+	mpi::wait_all(m_send_reqs.begin(), m_send_reqs.end());
+	m_send_reqs.clear();
+	
+	Rebalance(ctx);
+	
+	// send this update's batches, and post the receives for the neighbors' batches:
+	m_num_in_flight = 0;
+	for(std::size_t i=0; i<m_neighbors.size(); ++i) {
+		m_sent[i].swap(m_outbox[i]);
+		m_outbox[i].clear();
+		m_num_in_flight += m_sent[i].count();
+		m_send_reqs.push_back(m_mpi_world.isend(m_neighbors[i], MIGRANT_BATCH_TAG, m_sent[i]));
+	}
+	for(std::size_t i=0; i<m_neighbors.size(); ++i) {
+		m_recv_reqs.push_back(m_mpi_world.irecv(m_neighbors[i], MIGRANT_BATCH_TAG, m_inbox[i]));
+	}
 	
-	// finally, we need another barrier down here, in the off chance that one of the
-	// processes is really speedy and manages to migrate another org to this world
-	// before we finished the probe-loop.
-	m_mpi_world.barrier();
+	// size the next update by the totals as they stand now, reduced while this update's
+	// batches are in transit (changes made by events before the next update are not seen):
+	if(GetConfig().MP_SCHEDULING_STYLE.Get() == MP_SCHEDULING_INTEGRATED) {
+		ReduceUniverse();
+		m_reduced_update = GetStats().GetUpdate() + 1;
+	}
 
 	// record profiling stats:
 	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
@@ -356,6 +456,137 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 }
 
 
+/*! Inject a received migrant into the local population.
+ */
+void cMultiProcessWorld::InjectMigrant(cAvidaContext& ctx, migration_message& migrant) {
+	int target_cell=-1;
+	
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_RANDOM: { // spatial
+			// invert the orginating cell
+			migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
+			migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
+			target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
+			break;
+		}
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+			target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+			// relocated organisms only ever fill empty cells, this world advertised room for them:
+			if(migrant._relocated) {
+				for(int i=0; (i<GetPopulation().GetSize()) && GetPopulation().GetCell(target_cell).IsOccupied(); ++i) {
+					target_cell = (target_cell + 1) % GetPopulation().GetSize();
+				}
+			}
+			break;
+		}
+		default: {
+			GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
+		}
+	}
+	
+	GetPopulation().InjectGenome(target_cell,
+															 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
+															 migrant.genome(), // genome unpacked from message
+															 ctx, migrant._lineage); // lineage label
+	// unpack the rest from the message:
+	migrant.unpack(ctx, GetPopulation().GetCell(target_cell).GetOrganism());
+	if(!migrant._relocated) {
+		GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
+	}
+}
+
+
+/*! Relocate organisms from slow ranks to fast ones, every MP_BALANCE_INTERVAL updates.
+ 
+ Under mass action nearly every birth already lands in a random world, so which world
+ hosts an organism does not shape the global dynamics.  Moving organisms out of the
+ ranks whose updates take longest, into cells that are *empty* on faster ranks, evens
+ out the work without adding deaths anywhere.
+ 
+ Every rank gathers the same mean update times, population sizes and free cells, and
+ computes the same relocation plan from them; each then sends its own share through
+ the regular migrant batches.
+ */
+void cMultiProcessWorld::Rebalance(cAvidaContext& ctx) {
+	namespace mpi = boost::mpi;
+	
+	const int interval = GetConfig().MP_BALANCE_INTERVAL.Get();
+	if((interval <= 0) || (GetConfig().BIRTH_METHOD.Get() != POSITION_OFFSPRING_FULL_SOUP_RANDOM) || (m_mpi_world.size() < 2)) {
+		return;
+	}
+	
+	m_balance_time += m_pf[UPDATE];
+	if(++m_balance_updates < interval) {
+		return;
+	}
+	
+	const int num_orgs = GetPopulation().GetNumOrganisms();
+	std::vector<double> times;
+	std::vector<int> orgs;
+	std::vector<int> empty;
+	mpi::all_gather(m_mpi_world, m_balance_time / m_balance_updates, times);
+	mpi::all_gather(m_mpi_world, num_orgs, orgs);
+	mpi::all_gather(m_mpi_world, GetPopulation().GetSize() - num_orgs, empty);
+	m_balance_time = 0.0;
+	m_balance_updates = 0;
+	
+	const int size = m_mpi_world.size();
+	double mean_time = 0.0;
+	int total_orgs = 0;
+	for(int i=0; i<size; ++i) {
+		mean_time += times[i];
+		total_orgs += orgs[i];
+	}
+	mean_time /= size;
+	if((mean_time <= 0.0) || (total_orgs == 0)) {
+		return;
+	}
+	
+	// per organism cost of each rank; empty ranks are assumed to be of average cost
+	const double mean_cost = (mean_time * size) / total_orgs;
+	std::vector<int> excess(size, 0);
+	std::vector<int> room(size, 0);
+	for(int i=0; i<size; ++i) {
+		const double cost = (orgs[i] > 0) ? (times[i] / orgs[i]) : mean_cost;
+		if(times[i] > mean_time * (1.0 + GetConfig().MP_BALANCE_TOLERANCE.Get())) {
+			excess[i] = std::min(orgs[i] - 1, static_cast<int>((times[i] - mean_time) / cost));
+		} else if(times[i] < mean_time) {
+			room[i] = std::min(empty[i], static_cast<int>((mean_time - times[i]) / cost));
+		}
+	}
+	
+	// match the excess of the slow ranks against the room on the fast ranks, in rank order:
+	const int rank = m_mpi_world.rank();
+	int dst = 0;
+	for(int src=0; src<size; ++src) {
+		while((excess[src] > 0) && (dst < size)) {
+			if(room[dst] <= 0) {
+				++dst;
+				continue;
+			}
+			const int num_moved = std::min(excess[src], room[dst]);
+			excess[src] -= num_moved;
+			room[dst] -= num_moved;
+			if(src != rank) {
+				continue;
+			}
+			
+			migrant_batch& batch = m_outbox[m_neighbor_slot[dst]];
+			for(int k=0; (k<num_moved) && (GetPopulation().GetNumOrganisms() > 1); ++k) {
+				int cell_id = GetRandom().GetInt(GetPopulation().GetSize());
+				while(!GetPopulation().GetCell(cell_id).IsOccupied()) {
+					cell_id = (cell_id + 1) % GetPopulation().GetSize();
+				}
+				cPopulationCell& cell = GetPopulation().GetCell(cell_id);
+				cOrganism* org = cell.GetOrganism();
+				batch.push(org, cell, org->GetPhenotype().GetMerit().GetDouble(), org->GetLineageLabel(), true);
+				GetPopulation().KillOrganism(cell, ctx);
+			}
+		}
+	}
+}
+
+
 /*! Returns true if this world allows early exits, e.g., when the population reaches 0.
  */
 bool cMultiProcessWorld::AllowsEarlyExit() const
@@ -367,44 +598,52 @@ bool cMultiProcessWorld::AllowsEarlyExit() const
 }
 
 
+/*! Sum the population size and merit of all worlds in a single collective.
+ 
+ Migrants still in transit count toward their originating world.  The population keeps
+ the merit each cell was last scheduled with in a dense array, zero for empty cells.
+ */
+void cMultiProcessWorld::ReduceUniverse() {
+	double local[2] = { static_cast<double>(GetPopulation().GetNumOrganisms() + m_num_in_flight),
+		GetPopulation().GetOccupancy().GetTotalMerit() };
+	double total[2];
+	boost::mpi::all_reduce(m_mpi_world, local, 2, total, std::plus<double>());
+	
+	m_universe_popsize = static_cast<int>(total[0] + 0.5);
+	m_local_merit = local[1];
+	m_universe_merit = total[1];
+}
+
+
 /*! Calculate the size (in virtual CPU cycles) of the current update.
  
  This is a little challenging, because we need to scale the number of virtual CPU
  cycles allotted to each world based on the *total* (all populations) number of
- organisms, as well as by the total merit.  We do that here.
+ organisms, as well as by the total merit.  The totals are reduced at the end of the
+ previous update's post-update step, alongside the migrant exchange, so no collective is
+ needed here except on the first update.  The result is kept for the rest of the update.
  */
 int cMultiProcessWorld::CalculateUpdateSize()
 {
-	namespace mpi = boost::mpi;
-	using namespace boost;
+	if(m_update_size_update == GetStats().GetUpdate()) {
+		return m_update_size;
+	}
 	m_calc_update_timer.restart();
 	
-	int update_size=0;
 	switch(GetConfig().MP_SCHEDULING_STYLE.Get()) {
 		case MP_SCHEDULING_NULL: { // default, non-MP aware
-			update_size = cWorld::CalculateUpdateSize();
+			m_update_size = cWorld::CalculateUpdateSize();
 			break;
 		}
 		case MP_SCHEDULING_INTEGRATED: { // MP aware
-			// sum the total number of organisms in all populations, storing that value
-			// so that we know if we have to exit early:
-			all_reduce(m_mpi_world, GetPopulation().GetNumOrganisms(), m_universe_popsize, std::plus<int>());
-			
-			// sum the merits of organisms in all populations.
-			// there's no clean way to do this across the different schedulers in avida,
-			// so we'll take the O(n) hit and sum them (for now):
-			double local_merit=0.0;
-			for(int i=0; i<GetPopulation().GetSize(); ++i) {
-				cPopulationCell& cell=GetPopulation().GetCell(i);
-				if(cell.IsOccupied()) {
-					local_merit += cell.GetOrganism()->GetPhenotype().GetMerit().GetDouble();
-				}
+			// every world reaches the first update without a post-update reduction:
+			if(m_reduced_update != GetStats().GetUpdate()) {
+				ReduceUniverse();
+				m_reduced_update = GetStats().GetUpdate();
 			}
-			double total_merit;
-			all_reduce(m_mpi_world, local_merit, total_merit, std::plus<double>());
 			
 			// ok, calculate the total CPU cycles allotted to this population:
-			update_size = (local_merit/total_merit) * GetConfig().AVE_TIME_SLICE.Get() * m_universe_popsize;
+			m_update_size = (m_universe_merit > 0.0) ? static_cast<int>((m_local_merit/m_universe_merit) * GetConfig().AVE_TIME_SLICE.Get() * m_universe_popsize) : 0;
 			break;
 		}
 		default: {
@@ -412,8 +651,9 @@ int cMultiProcessWorld::CalculateUpdateSize()
 		}
 	}
 	
+	m_update_size_update = GetStats().GetUpdate();
 	m_pf[CALCUPDATE] = m_calc_update_timer.elapsed();
-	return update_size;
+	return m_update_size;
 }
 
 #endif // boost_is_available
@@ -25,13 +25,95 @@
 #include <boost/mpi.hpp>
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <boost/serialization/vector.hpp>
 #include <boost/timer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <string>
 #include <vector>
 
+#include "avida/core/Genome.h"
+
 #include "cWorld.h"
 #include "cAvidaConfig.h"
 #include "cStats.h"
 
+class cAvidaContext;
+class cMerit;
+class cOrganism;
+class cPopulationCell;
+
+
+/*! A migrant that one cMultiProcessWorld sends to another during organism
+ migration.
+ */
+struct migration_message {
+	//! Default constructor.
+	migration_message() { }
+	
+	//! Rebuild the genome of the migrating organism.
+	Avida::Genome genome() const;
+	
+	//! Finish unpacking an organism from this message.
+	void unpack(cAvidaContext& ctx, cOrganism* org);
+	
+	int _hw_type; //!< Hardware type of the migrating organism.
+	std::string _inst_set; //!< Instruction set name of the migrating organism.
+	std::vector<unsigned char> _ops; //!< Instruction opcodes of the migrating organism's genome.
+	double _merit; //!< Merit of this organism in its originating population.
+	int _lineage; //!< Lineage label of this organism in its orginating population.
+	int _x; //!< X-coordinate of the cell from which this migrant originated.
+	int _y; //!< Y-coordinate of the cell from which this migrant originated.
+	int _generation; //!< Generation of this organism.
+	bool _relocated; //!< True if moved by load balancing rather than born as a migrant.
+};
+
+
+/*! All migrants sent to one world during an update, packed into a single buffer.
+ 
+ Each migrant is stored as merit (double); lineage, x, y, generation and hardware
+ type (int); a relocation flag (byte); the instruction set name (uint16 length and
+ bytes); and the genome (int length and one opcode byte per instruction).  Values are in host byte order,
+ as every world of a run executes the same binary.  Migrants are read back in the
+ order they were added.
+ */
+class migrant_batch {
+public:
+	//! Constructor.
+	migrant_batch() : m_count(0), m_read_pos(0) { }
+	
+	//! Pack a migrating organism onto the end of the batch.
+	void push(cOrganism* org, const cPopulationCell& cell, double merit, int lineage, bool relocated = false);
+	
+	//! Unpack the next migrant, returns false once all have been read.
+	bool pop(migration_message& msg);
+	
+	//! Number of migrants packed into this batch by push.
+	int count() const { return m_count; }
+	
+	//! Empty the batch, keeping its storage.
+	void clear() { m_buf.clear(); m_count = 0; m_read_pos = 0; }
+	
+	//! Exchange contents with another batch.
+	void swap(migrant_batch& other) {
+		m_buf.swap(other.m_buf);
+		std::swap(m_count, other.m_count);
+		std::swap(m_read_pos, other.m_read_pos);
+	}
+	
+	//! Serializer, the buffer travels as one contiguous array of bytes.
+	template<class Archive>
+	void serialize(Archive & ar, const unsigned int version) {
+		ar & m_buf;
+	}
+	
+private:
+	std::vector<char> m_buf; //!< Packed migrants.
+	int m_count; //!< Migrants pushed since the last clear.
+	std::size_t m_read_pos; //!< Offset of the next migrant to pop.
+};
+
+
 /*! Multi-process Avida world.
  
  This class enables multi-process Avida, which provides a mechanism for much larger
@@ -39,6 +121,12 @@
  a single new technique, that of "cross-world migration," where an individual organism
  is transferred to a different Avida world and injected into a random location in that
  world's population.
+ 
+ Migrants are exchanged only with neighboring worlds, the worlds that MigrateOrganism
+ can target.  Every world sends exactly one batch (possibly empty) to each neighbor per
+ update, so receives can be posted in advance and no global barrier is needed.  A batch
+ sent at the end of one update is injected at the end of the next, which lets the
+ communication overlap with that update's execution.
  */
 class cMultiProcessWorld : public cWorld
 	{
@@ -50,11 +138,25 @@ class cMultiProcessWorld : public cWorld
 	protected:
 		boost::mpi::environment& m_mpi_env; //!< MPI environment.
 		boost::mpi::communicator& m_mpi_world; //!< World-wide MPI communicator.
-		std::vector<boost::mpi::request> m_reqs; //!< Requests outstanding since the last ProcessPostUpdate.
+		std::vector<int> m_neighbors; //!< Ranks of the worlds migrants are exchanged with.
+		std::vector<int> m_neighbor_slot; //!< Index into m_neighbors for each rank, -1 for non-neighbors.
+		std::vector<migrant_batch> m_outbox; //!< Migrants leaving during the current update, per neighbor.
+		std::vector<migrant_batch> m_sent; //!< Batches of the previous update, kept until their sends complete.
+		std::vector<migrant_batch> m_inbox; //!< Batches being received from each neighbor.
+		std::vector<boost::mpi::request> m_send_reqs; //!< Sends of the batches in m_sent.
+		std::vector<boost::mpi::request> m_recv_reqs; //!< Receives posted into m_inbox.
+		int m_num_in_flight; //!< Migrants sent by this world that have not yet been injected.
+		double m_balance_time; //!< Update time accumulated since the last rebalancing.
+		int m_balance_updates; //!< Updates accumulated since the last rebalancing.
 		int m_universe_dim; //!< Dimension (x & y) of the universe (number of worlds along the side of a grid of worlds).
 		int m_universe_x; //!< X coordinate of this world.
 		int m_universe_y; //!< Y coordinate of this world.
 		int m_universe_popsize; //!< Total size of the universe, delayed one update.
+		double m_local_merit; //!< Total merit of this world when the universe was last reduced.
+		double m_universe_merit; //!< Total merit of the universe when it was last reduced.
+		int m_reduced_update; //!< Update the last universe reduction was made for.
+		int m_update_size_update; //!< Update for which m_update_size was calculated.
+		int m_update_size; //!< Size of that update, reused if it is asked for again.
 		
 		boost::timer m_update_timer; //!< Tracks the clock-time of updates.
 		boost::timer m_post_update_timer; //!< Tracks the clock-time of post-update processing.
@@ -69,7 +171,7 @@ class cMultiProcessWorld : public cWorld
 		static cMultiProcessWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
 		
 		//! Destructor.
-		virtual ~cMultiProcessWorld() { }
+		virtual ~cMultiProcessWorld();
 		
 		//! Migrate this organism to a different world.
 		virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell,
@@ -89,6 +191,19 @@ class cMultiProcessWorld : public cWorld
 		
 		//! Calculate the size (in virtual CPU cycles) of the current update.
 		virtual int CalculateUpdateSize();
+		
+	protected:
+		//! Determine the worlds that this world can exchange migrants with.
+		void SetupNeighbors();
+		
+		//! Inject a received migrant into the local population.
+		void InjectMigrant(cAvidaContext& ctx, migration_message& migrant);
+		
+		//! Relocate organisms from slow ranks to fast ones, every MP_BALANCE_INTERVAL updates.
+		void Rebalance(cAvidaContext& ctx);
+		
+		//! Sum the population size and merit of all worlds in a single collective.
+		void ReduceUniverse();
 	};
 
 #endif
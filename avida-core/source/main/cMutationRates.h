@@ -27,6 +27,38 @@
 
 class cWorld;
 
+
+// Trials left before the next event of a per trial rate.  Paths that test the same rate once per copied site hold one of
+// these and draw once per event rather than once per site; a change of rate (e.g. a new mutation rate for the
+// organism) starts a fresh countdown.
+class cMutationCountdown
+{
+private:
+  int m_countdown;  // -1 = draw again
+  double m_prob;    // rate the countdown was drawn with
+  
+public:
+  cMutationCountdown() : m_countdown(-1), m_prob(0.0) { ; }
+  
+  void Reset() { m_countdown = -1; }
+  
+  bool Test(cAvidaContext& ctx, double prob)
+  {
+    if (prob <= 0.0) return false;
+    if (m_countdown < 0 || prob != m_prob) {
+      m_prob = prob;
+      m_countdown = ctx.GetTrialsToNextEvent(prob);
+    }
+    if (m_countdown > 0) {
+      m_countdown--;
+      return false;
+    }
+    m_countdown = -1;
+    return true;
+  }
+};
+
+
 class cMutationRates
 {
 private:
@@ -0,0 +1,129 @@
+/*
+ *  cNUMAPlacement.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cNUMAPlacement.h"
+
+#if defined(__linux__)
+# include <cstdlib>
+# include <fstream>
+# include <sstream>
+# include <string>
+# include <pthread.h>
+# include <sched.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+
+#if defined(__linux__)
+namespace {
+  // mbind(2) policy and flag values, so that the numa development headers are not required
+  static const int NUMA_MPOL_PREFERRED = 1;
+  static const unsigned int NUMA_MPOL_MF_MOVE = (1 << 1);
+
+  // Parses a sysfs list such as "0-3,8,10-11"
+  bool readSysList(const std::string& path, Apto::Array<int>& values)
+  {
+    values.Resize(0);
+    std::ifstream in(path.c_str());
+    std::string text;
+    if (!in.good() || !std::getline(in, text)) return false;
+
+    std::istringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+      if (range.empty() || range[0] < '0' || range[0] > '9') continue;
+      const size_t dash = range.find('-');
+      const int first = atoi(range.c_str());
+      const int last = (dash == std::string::npos) ? first : atoi(range.c_str() + dash + 1);
+      for (int i = first; i <= last; i++) values.Push(i);
+    }
+    return values.GetSize() > 0;
+  }
+}
+#endif
+
+
+cNUMAPlacement::cNUMAPlacement() : m_page_size(4096)
+{
+#if defined(__linux__)
+  const long page_size = sysconf(_SC_PAGESIZE);
+  if (page_size > 0) m_page_size = page_size;
+
+  Apto::Array<int> nodes;
+  if (readSysList("/sys/devices/system/node/online", nodes)) {
+    for (int i = 0; i < nodes.GetSize(); i++) {
+      std::ostringstream path;
+      path << "/sys/devices/system/node/node" << nodes[i] << "/cpulist";
+      Apto::Array<int> cpus;
+
+      // Memory only nodes have no CPUs to run workers on
+      if (!readSysList(path.str(), cpus)) continue;
+      m_node_ids.Push(nodes[i]);
+      m_node_cpus.Push(cpus);
+    }
+  }
+#endif
+
+  if (m_node_cpus.GetSize() == 0) {
+    m_node_ids.Push(0);
+    m_node_cpus.Resize(1);
+  }
+}
+
+
+bool cNUMAPlacement::PinCurrentThread(int node) const
+{
+#if defined(__linux__)
+  if (GetNumNodes() < 2 || node < 0 || node >= GetNumNodes()) return false;
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int i = 0; i < m_node_cpus[node].GetSize(); i++) {
+    if (m_node_cpus[node][i] < CPU_SETSIZE) CPU_SET(m_node_cpus[node][i], &cpus);
+  }
+  return (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0);
+#else
+  (void)node;
+  return false;
+#endif
+}
+
+
+void cNUMAPlacement::BindMemory(const void* start, size_t size, int node) const
+{
+#if defined(__linux__) && defined(SYS_mbind)
+  if (GetNumNodes() < 2 || node < 0 || node >= GetNumNodes()) return;
+  const int node_id = m_node_ids[node];
+  if (node_id >= (int)(sizeof(unsigned long) * 8 - 1)) return;
+
+  // Only pages wholly inside the range are moved, edge pages are shared with the neighboring range
+  const size_t first = ((size_t)start + m_page_size - 1) & ~(m_page_size - 1);
+  const size_t last = ((size_t)start + size) & ~(m_page_size - 1);
+  if (last <= first) return;
+
+  unsigned long node_mask = 1UL << node_id;
+  syscall(SYS_mbind, (void*)first, last - first, NUMA_MPOL_PREFERRED, &node_mask, sizeof(node_mask) * 8, NUMA_MPOL_MF_MOVE);
+#else
+  (void)start;
+  (void)size;
+  (void)node;
+#endif
+}
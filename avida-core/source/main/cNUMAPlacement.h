@@ -0,0 +1,73 @@
+/*
+ *  cNUMAPlacement.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cNUMAPlacement_h
+#define cNUMAPlacement_h
+
+#include "apto/core.h"
+
+#include <cstddef>
+
+
+// cNUMAPlacement describes the NUMA nodes of the machine (from /sys/devices/system/node on Linux; a single node
+// everywhere else) and places worker threads and memory on them.  The parallel engines split their partitions (tiles,
+// demes) and their workers into contiguous blocks per node, pin each worker to the CPUs of its node and move the pages
+// holding each partition's cells and spatial resource grids to that node, so workers mostly touch local memory.
+// Placement is only a hint: pages straddling two partitions stay where they are, and failures are ignored.
+
+class cNUMAPlacement
+{
+private:
+  Apto::Array<int> m_node_ids;                 // kernel node number of each node that has CPUs
+  Apto::Array<Apto::Array<int> > m_node_cpus;  // online CPUs of each node
+  size_t m_page_size;
+
+public:
+  cNUMAPlacement();
+
+  int GetNumNodes() const { return m_node_cpus.GetSize(); }
+
+  // Node of element i of n when the elements are split into contiguous blocks, one per node
+  int NodeOf(int i, int n) const { return (n > 0) ? (int)(((long long)i * GetNumNodes()) / n) : 0; }
+
+  // Restrict the calling thread to the CPUs of node
+  bool PinCurrentThread(int node) const;
+
+  // Move the whole pages inside [start, start + size) to node
+  void BindMemory(const void* start, size_t size, int node) const;
+
+  // Move each run of consecutive array elements that share a node (elem_node, one entry per element) to that node
+  template <typename T> void BindArray(const T* base, const Apto::Array<int>& elem_node) const;
+};
+
+
+template <typename T> void cNUMAPlacement::BindArray(const T* base, const Apto::Array<int>& elem_node) const
+{
+  if (GetNumNodes() < 2) return;
+
+  int run_start = 0;
+  for (int i = 1; i <= elem_node.GetSize(); i++) {
+    if (i < elem_node.GetSize() && elem_node[i] == elem_node[run_start]) continue;
+    BindMemory(base + run_start, (i - run_start) * sizeof(T), elem_node[run_start]);
+    run_start = i;
+  }
+}
+
+#endif
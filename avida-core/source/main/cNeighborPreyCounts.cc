@@ -0,0 +1,62 @@
+/*
+ *  cNeighborPreyCounts.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cNeighborPreyCounts.h"
+
+#include "cConnectionTable.h"
+
+
+void cNeighborPreyCounts::Setup(const cConnectionTable* connections, int num_cells)
+{
+  m_connections = connections;
+  m_is_prey.Resize(num_cells);
+  m_prey.Resize(num_cells);
+  m_prey_av.Resize(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    m_is_prey[i] = 0;
+    m_prey[i] = 0;
+    m_prey_av[i] = 0;
+  }
+}
+
+
+void cNeighborPreyCounts::SetPrey(int cell_id, bool is_prey)
+{
+  if (!m_connections || m_is_prey[cell_id] == (char)is_prey) return;
+  m_is_prey[cell_id] = is_prey;
+  addToNeighbors(m_prey, cell_id, is_prey ? 1 : -1);
+}
+
+
+void cNeighborPreyCounts::Swap(int cell_id1, int cell_id2)
+{
+  if (!m_connections) return;
+  const bool is_prey1 = m_is_prey[cell_id1];
+  const bool is_prey2 = m_is_prey[cell_id2];
+  SetPrey(cell_id1, is_prey2);
+  SetPrey(cell_id2, is_prey1);
+}
+
+
+void cNeighborPreyCounts::addToNeighbors(Apto::Array<int>& counts, int cell_id, int delta)
+{
+  const int degree = m_connections->GetSize(cell_id);
+  for (int pos = 0; pos < degree; pos++) counts[m_connections->GetNeighborID(cell_id, pos)] += delta;
+}
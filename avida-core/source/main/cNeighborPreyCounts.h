@@ -0,0 +1,69 @@
+/*
+ *  cNeighborPreyCounts.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cNeighborPreyCounts_h
+#define cNeighborPreyCounts_h
+
+#include "apto/core/Array.h"
+
+#include <cstddef>
+
+class cConnectionTable;
+
+
+// cNeighborPreyCounts keeps, for every cell, the number of prey organisms (forage target above -2) and of prey avatars
+// in the cells connected to it, for predator confusion (PRED_CONFUSION).  A change in one cell adjusts the counts of
+// its neighbors, so reading the density of prey around a cell takes constant time.
+//
+// Connections are taken to be symmetric, as every topology builder makes them.  The counts are only kept once Setup
+// has been called; until then every update is ignored.
+
+class cNeighborPreyCounts
+{
+private:
+  const cConnectionTable* m_connections;
+  Apto::Array<char> m_is_prey;     // whether the occupant of each cell is counted
+  Apto::Array<int> m_prey;         // prey organisms in the neighbors of each cell
+  Apto::Array<int> m_prey_av;      // prey avatars in the neighbors of each cell
+
+  void addToNeighbors(Apto::Array<int>& counts, int cell_id, int delta);
+
+
+public:
+  cNeighborPreyCounts() : m_connections(NULL) { ; }
+
+  // Start over with num_cells empty cells, connected as in connections
+  void Setup(const cConnectionTable* connections, int num_cells);
+  bool IsActive() const { return m_connections != NULL; }
+
+  // The occupant of cell_id was replaced, removed or changed forage target
+  void SetPrey(int cell_id, bool is_prey);
+
+  // The contents of two cells were exchanged
+  void Swap(int cell_id1, int cell_id2);
+
+  // A prey avatar entered (delta 1) or left (delta -1) cell_id
+  void AdjustPreyAV(int cell_id, int delta) { if (m_connections) addToNeighbors(m_prey_av, cell_id, delta); }
+
+  int GetNeighborPrey(int cell_id) const { return m_prey[cell_id]; }
+  int GetNeighborPreyAV(int cell_id) const { return m_prey_av[cell_id]; }
+};
+
+#endif
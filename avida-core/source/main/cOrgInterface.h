@@ -202,6 +202,7 @@ public:
   virtual void IncNumPreyOrganisms() = 0;
   virtual void IncNumPredOrganisms() = 0;
   virtual void IncNumTopPredOrganisms() = 0;
+  virtual void ForageTargetChanged() = 0;
   virtual void AttackFacedOrg(cAvidaContext& ctx, int loser) = 0;
   
   virtual void TryWriteBirthLocData(int org_idx) = 0;
@@ -247,7 +248,7 @@ public:
 
   virtual Apto::Array<cOrganism*> GetFacedAVs(int av_num = 0) = 0;
   virtual Apto::Array<cOrganism*> GetCellAVs(int av_cell_id, int av_num=0) =0;
-  virtual Apto::Array<cOrganism*> GetFacedPreyAVs(int av_num = 0) = 0;
+  virtual const Apto::Array<cOrganism*, Apto::Smart>& GetFacedPreyAVs(int av_num = 0) = 0;
   virtual const Apto::Array<double>& GetAVResources(cAvidaContext& ctx, int av_num = 0) = 0;
   virtual double GetAVResourceVal(cAvidaContext& ctx, int res_id, int av_num = 0) = 0;
   virtual const Apto::Array<double>& GetAVFacedResources(cAvidaContext& ctx, int av_num = 0) = 0;
@@ -50,3 +50,27 @@ void cOrgMessage::SetReceiver(cOrganism *recvr)
 		m_receiverCellID = -1;
 	}
 }
+
+
+cOrgMessagePool::~cOrgMessagePool()
+{
+  for (int i = 0; i < m_free.GetSize(); i++) delete m_free[i];
+}
+
+
+cOrgMessagePool::sBuffers* cOrgMessagePool::Acquire()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_free.GetSize()) return m_free.Pop();
+  return new sBuffers;
+}
+
+
+void cOrgMessagePool::Release(sBuffers* buffers)
+{
+  buffers->sent.clear();
+  buffers->received.clear();
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  m_free.Push(buffers);
+}
@@ -22,6 +22,11 @@
 #ifndef cOrgMessage_h
 #define cOrgMessage_h
 
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#include <deque>
+
 class cOrganism;
 
 /*! This class encapsulates two unsigned integers that are sent as a "message"
@@ -85,4 +90,39 @@ private:
 };
 
 
+/*! Recycles the message buffers of organisms that use messaging.  Buffers are handed out
+when an organism first sends or receives a message and returned, emptied, when it dies, so
+that the buffers (and the storage already held by their queues) of dead organisms are reused
+by their offspring rather than being freed and allocated again for every birth.  One pool is
+owned by each world.
+*/
+class cOrgMessagePool
+{
+public:
+  typedef std::deque<cOrgMessage> MessageList; //!< Container-type for cOrgMessages.
+
+  //! Message buffers of a single organism.
+  struct sBuffers
+  {
+    MessageList sent; //!< List of all messages sent by this organism.
+    MessageList received; //!< List of all messages received by this organism.
+  };
+
+  cOrgMessagePool() { ; }
+  ~cOrgMessagePool();
+
+  //! Returns an empty set of buffers, reusing a released one when available.
+  sBuffers* Acquire();
+  //! Empties the buffers and keeps them for a later Acquire().
+  void Release(sBuffers* buffers);
+
+private:
+  Apto::Mutex m_mutex; //!< Test CPUs may create and destroy organisms outside of the population's thread.
+  Apto::Array<sBuffers*> m_free; //!< Released buffers.
+
+  cOrgMessagePool(const cOrgMessagePool&); // @not_implemented
+  cOrgMessagePool& operator=(const cOrgMessagePool&); // @not_implemented
+};
+
+
 #endif
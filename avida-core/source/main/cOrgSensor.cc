@@ -24,6 +24,7 @@
 #include "cOrgSensor.h"
 
 #include "cEnvironment.h"
+#include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cResource.h"
 #include "cResourceCount.h"
@@ -467,6 +468,9 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
   
+  // organisms are counted in the forager index first, so empty stretches of the view need no cell tests
+  const bool use_index = (habitat_used == -2 && !m_use_avatar);
+  
   // START WALKING
   bool first_step = true;
   for (int dist = limits.start; dist <= limits.end; dist++) {
@@ -475,6 +479,12 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     // if looking l,r,u,d and center_cell is outside of the world -- we're done with both sides and center
     if (!diagonal && !count_center) break;
     
+    bool layer_empty = false;
+    if (use_index) {
+      if (!found && !ConeHasOrgs(in_defs, center_cell, left, right, ahead_dir, dist, limits.end, false)) break;
+      layer_empty = !ConeHasOrgs(in_defs, center_cell, left, right, ahead_dir, dist, dist, false);
+    }
+    
     // work on SIDE of center cells for this distance
     int num_cells_either_side = 0;
     if (dist > 0) num_cells_either_side = (dist % 2) ? (int) ((dist - 1) * 0.5) : (int) (dist * 0.5);
@@ -517,7 +527,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in the world.
-        if (valid_cell) {
+        if (valid_cell && !layer_empty) {
           cellResultInfo = TestCell(ctx, in_defs, this_cell, val_res, first_step, stop_at_first_found);
           first_step = false;
           
@@ -548,7 +558,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && !layer_empty) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -677,12 +687,20 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
   
+  const bool use_index = (habitat_used == -2 && !m_use_avatar);
+  
   // START WALKING
   bool first_step = true;
   for (int dist = limits.start; dist <= limits.end; dist++) {
     assert(TestBounds(center_cell, worldBounds));
     if (((habitat_used != -2 && habitat_used != 3) && !TestBounds(center_cell, tot_bounds))) count_center = false;
     
+    bool layer_empty = false;
+    if (use_index) {
+      if (!found && !ConeHasOrgs(in_defs, center_cell, left, right, ahead_dir, dist, limits.end, true)) break;
+      layer_empty = !ConeHasOrgs(in_defs, center_cell, left, right, ahead_dir, dist, dist, true);
+    }
+    
     // work on SIDE of center cells for this distance
     int num_cells_either_side = 0;
     if (dist > 0) num_cells_either_side = (dist % 2) ? (int) ((dist - 1) * 0.5) : (int) (dist * 0.5);
@@ -708,7 +726,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in bounds.
-        if (valid_cell) {
+        if (valid_cell && !layer_empty) {
           cellResultInfo = TestCell(ctx, in_defs, this_cell, val_res, first_step, stop_at_first_found);
           first_step = false;
           
@@ -739,7 +757,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && !layer_empty) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -1084,6 +1102,32 @@ cOrgSensor::sSearchInfo cOrgSensor::TestCell(cAvidaContext& ctx, sLookInit& in_d
   return returnInfo;
 }
 
+// Whether the forager index holds any organism matching in_defs within the bounding box of the cells walked from
+// first_dist through last_dist, with center_cell at first_dist.  A false result means none of those cells can match.
+bool cOrgSensor::ConeHasOrgs(const sLookInit& in_defs, const Apto::Coord<int>& center_cell, const Apto::Coord<int>& left,
+                             const Apto::Coord<int>& right, const Apto::Coord<int>& ahead_dir, int first_dist, int last_dist,
+                             bool torus)
+{
+  const Apto::Coord<int> last_center = center_cell + ahead_dir * (last_dist - first_dist);
+  const Apto::Coord<int> corners[4] = {
+    center_cell + left * (first_dist / 2), center_cell + right * (first_dist / 2),
+    last_center + left * (last_dist / 2), last_center + right * (last_dist / 2)
+  };
+  
+  int min_x = corners[0].X(), max_x = corners[0].X();
+  int min_y = corners[0].Y(), max_y = corners[0].Y();
+  for (int i = 1; i < 4; i++) {
+    min_x = min(min_x, corners[i].X());
+    max_x = max(max_x, corners[i].X());
+    min_y = min(min_y, corners[i].Y());
+    max_y = max(max_y, corners[i].Y());
+  }
+  
+  const cForagerIndex& index = m_world->GetPopulation().GetForagerIndex();
+  if (torus) return index.CountTorus(in_defs.search_type, min_x, min_y, max_x, max_y) > 0;
+  return index.Count(in_defs.search_type, min_x, min_y, max_x, max_y) > 0;
+}
+
 int cOrgSensor::GetMinDist(const int worldx, sBounds& bounds, const int cell_id, const int distance_sought, const int facing)
 {
   const int org_x = cell_id % worldx;
@@ -1295,25 +1339,32 @@ void cOrgSensor::TestConfusion(cAvidaContext& ctx, sLookOut& stuff_seen, cOrgani
 
 void cOrgSensor::GetConfusionOddsDensity(cAvidaContext& ctx, double& odds, cOrganism* first_org)
 {
+  // The neighborhood counts are kept by the population whenever PRED_CONFUSION is on
+  const cNeighborPreyCounts& prey_counts = m_world->GetPopulation().GetNeighborPreyCounts();
   int prey_count = 0;
-  Apto::Array<int> neighborhood;
   if (!m_use_avatar) {
     if (first_org->IsPreyFT()) {
       prey_count++;
-      first_org->GetOrgInterface().GetNeighborhoodCellIDs(neighborhood);
-      for (int j = 0; j < neighborhood.GetSize(); j++) {
-        if (first_org->GetOrgInterface().GetCell(neighborhood[j])->IsOccupied() &&
-            !first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsDead()) {
-          if (first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsPreyFT()) prey_count++;
+      const int cell_id = first_org->GetOrgInterface().GetCellID();
+      if (prey_counts.IsActive()) prey_count += prey_counts.GetNeighborPrey(cell_id);
+      else {
+        const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(cell_id)->ConnectionList();
+        for (int j = 0; j < neighbors.GetSize(); j++) {
+          cOrganism* neighbor = first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j))->GetOrganism();
+          if (neighbor != NULL && !neighbor->IsDead() && neighbor->IsPreyFT()) prey_count++;
         }
       }
     }
   }
   else {
-    prey_count += first_org->GetOrgInterface().GetCell(first_org->GetOrgInterface().GetAVCellID())->GetNumPreyAV(); // self cell
-    first_org->GetOrgInterface().GetAVNeighborhoodCellIDs(neighborhood);
-    for (int j = 0; j < neighborhood.GetSize(); j++) {
-      prey_count += first_org->GetOrgInterface().GetCell(neighborhood[j])->GetNumPreyAV();
+    const int av_cell_id = first_org->GetOrgInterface().GetAVCellID();
+    prey_count += first_org->GetOrgInterface().GetCell(av_cell_id)->GetNumPreyAV(); // self cell
+    if (prey_counts.IsActive()) prey_count += prey_counts.GetNeighborPreyAV(av_cell_id);
+    else {
+      const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(av_cell_id)->ConnectionList();
+      for (int j = 0; j < neighbors.GetSize(); j++) {
+        prey_count += first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j))->GetNumPreyAV();
+      }
     }
   }
   
@@ -1324,44 +1375,46 @@ void cOrgSensor::GetConfusionOddsDensity(cAvidaContext& ctx, double& odds, cOrga
 
 void cOrgSensor::GetConfusionOddsFacings(cAvidaContext& ctx, double& odds, cOrganism* first_org)
 {
-  Apto::Array<int> facings(8);
-  facings.SetAll(0);
+  int facings[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
   int num_used = 0;
   
-  Apto::Array<int> neighborhood;
+  // Neighborhoods without prey are skipped without visiting their cells
+  const cNeighborPreyCounts& prey_counts = m_world->GetPopulation().GetNeighborPreyCounts();
   if (!m_use_avatar) {
-    if (first_org->IsPreyFT()) {
-      first_org->GetOrgInterface().GetNeighborhoodCellIDs(neighborhood);
-      for (int j = 0; j < neighborhood.GetSize(); j++) {
-        if (first_org->GetOrgInterface().GetCell(neighborhood[j])->IsOccupied() &&
-            !first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsDead()) {
-          if (first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsPreyFT()) {
-             if (facings[first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->GetOrgInterface().GetFacedDir()] == 0) num_used++;
-            facings[first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->GetOrgInterface().GetFacedDir()]++;
-          }
+    const int cell_id = first_org->GetOrgInterface().GetCellID();
+    if (first_org->IsPreyFT() && (!prey_counts.IsActive() || prey_counts.GetNeighborPrey(cell_id) > 0)) {
+      const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(cell_id)->ConnectionList();
+      for (int j = 0; j < neighbors.GetSize(); j++) {
+        cOrganism* neighbor = first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j))->GetOrganism();
+        if (neighbor != NULL && !neighbor->IsDead() && neighbor->IsPreyFT()) {
+          const int faced_dir = neighbor->GetOrgInterface().GetFacedDir();
+          if (facings[faced_dir] == 0) num_used++;
+          facings[faced_dir]++;
         }
       }
     }
   }
   else {
     // self cell
-    Apto::Array<cOrganism*> prey_friends = first_org->GetOrgInterface().GetCell(first_org->GetOrgInterface().GetAVCellID())->GetCellOutputAVs();
-    for (int k = 0; k < prey_friends.GetSize(); k++) {
-      if (prey_friends[k] != first_org) {
-        if (facings[prey_friends[k]->GetOrgInterface().GetAVFacing()] == 0) num_used++;
-        facings[prey_friends[k]->GetOrgInterface().GetAVFacing()]++;
+    const int av_cell_id = first_org->GetOrgInterface().GetAVCellID();
+    const Apto::Array<cOrganism*, Apto::Smart>* prey_friends = &first_org->GetOrgInterface().GetCell(av_cell_id)->ReadCellOutputAVs();
+    for (int k = 0; k < prey_friends->GetSize(); k++) {
+      if ((*prey_friends)[k] != first_org) {
+        if (facings[(*prey_friends)[k]->GetOrgInterface().GetAVFacing()] == 0) num_used++;
+        facings[(*prey_friends)[k]->GetOrgInterface().GetAVFacing()]++;
       }
       if (num_used >= 8) break;
     }
     // neighbors
-    if (num_used < 8) {
-      first_org->GetOrgInterface().GetAVNeighborhoodCellIDs(neighborhood);
-      for (int j = 0; j < neighborhood.GetSize(); j++) {
-        if (first_org->GetOrgInterface().GetCell(neighborhood[j])->HasPreyAV()) {
-          prey_friends = first_org->GetOrgInterface().GetCell(neighborhood[j])->GetCellOutputAVs();
-          for (int k = 0; k < prey_friends.GetSize(); k++) {
-            if (facings[prey_friends[k]->GetOrgInterface().GetAVFacing()] == 0) num_used++;
-            facings[prey_friends[k]->GetOrgInterface().GetAVFacing()]++;
+    if (num_used < 8 && (!prey_counts.IsActive() || prey_counts.GetNeighborPreyAV(av_cell_id) > 0)) {
+      const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(av_cell_id)->ConnectionList();
+      for (int j = 0; j < neighbors.GetSize(); j++) {
+        const cPopulationCell* neighbor_cell = first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j));
+        if (neighbor_cell->HasPreyAV()) {
+          prey_friends = &neighbor_cell->ReadCellOutputAVs();
+          for (int k = 0; k < prey_friends->GetSize(); k++) {
+            if (facings[(*prey_friends)[k]->GetOrgInterface().GetAVFacing()] == 0) num_used++;
+            facings[(*prey_friends)[k]->GetOrgInterface().GetAVFacing()]++;
             if (num_used >= 8) break;
           }
         }
@@ -1382,45 +1435,47 @@ void cOrgSensor::GetConfusionOddsOpinions(cAvidaContext& ctx, double& odds, cOrg
   groups_used.Resize(num_groups);
   groups_used.SetAll(0);
   
-  Apto::Array<int> neighborhood;
+  // Neighborhoods without prey are skipped without visiting their cells
+  const cNeighborPreyCounts& prey_counts = m_world->GetPopulation().GetNeighborPreyCounts();
   if (!m_use_avatar) {
-    if (first_org->IsPreyFT()) {
-      first_org->GetOrgInterface().GetNeighborhoodCellIDs(neighborhood);
-      for (int j = 0; j < neighborhood.GetSize(); j++) {
-        if (first_org->GetOrgInterface().GetCell(neighborhood[j])->IsOccupied() &&
-            !first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsDead()) {
-          if (first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->IsPreyFT()) {
-            if (first_org->HasOpinion()) {
-            if (groups_used[GetGroupIdx(group_ids, first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->GetOpinion().first)] == 0) num_used++;
-            groups_used[GetGroupIdx(group_ids, first_org->GetOrgInterface().GetCell(neighborhood[j])->GetOrganism()->GetOpinion().first)]++;
-            }
-          }
+    const int cell_id = first_org->GetOrgInterface().GetCellID();
+    if (first_org->IsPreyFT() && (!prey_counts.IsActive() || prey_counts.GetNeighborPrey(cell_id) > 0) &&
+        first_org->HasOpinion()) {
+      const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(cell_id)->ConnectionList();
+      for (int j = 0; j < neighbors.GetSize(); j++) {
+        cOrganism* neighbor = first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j))->GetOrganism();
+        if (neighbor != NULL && !neighbor->IsDead() && neighbor->IsPreyFT()) {
+          const int group_idx = GetGroupIdx(group_ids, neighbor->GetOpinion().first);
+          if (groups_used[group_idx] == 0) num_used++;
+          groups_used[group_idx]++;
         }
       }
     }
   }
   else {
     // self cell
-    Apto::Array<cOrganism*> prey_friends = first_org->GetOrgInterface().GetCell(first_org->GetOrgInterface().GetAVCellID())->GetCellOutputAVs();
-    for (int k = 0; k < prey_friends.GetSize(); k++) {
-      if (prey_friends[k] != first_org) {
-        if (prey_friends[k]->HasOpinion()) {
-          if (groups_used[GetGroupIdx(group_ids, prey_friends[k]->GetOpinion().first)] == 0) num_used++;
-          groups_used[GetGroupIdx(group_ids, prey_friends[k]->GetOpinion().first)]++;
+    const int av_cell_id = first_org->GetOrgInterface().GetAVCellID();
+    const Apto::Array<cOrganism*, Apto::Smart>* prey_friends = &first_org->GetOrgInterface().GetCell(av_cell_id)->ReadCellOutputAVs();
+    for (int k = 0; k < prey_friends->GetSize(); k++) {
+      if ((*prey_friends)[k] != first_org) {
+        if ((*prey_friends)[k]->HasOpinion()) {
+          if (groups_used[GetGroupIdx(group_ids, (*prey_friends)[k]->GetOpinion().first)] == 0) num_used++;
+          groups_used[GetGroupIdx(group_ids, (*prey_friends)[k]->GetOpinion().first)]++;
         }
       }
       if (num_used >= num_groups) break;
     }
     // neighbors
-    if (num_used < num_groups) {
-      first_org->GetOrgInterface().GetAVNeighborhoodCellIDs(neighborhood);
-      for (int j = 0; j < neighborhood.GetSize(); j++) {
-        if (first_org->GetOrgInterface().GetCell(neighborhood[j])->HasPreyAV()) {
-          prey_friends = first_org->GetOrgInterface().GetCell(neighborhood[j])->GetCellOutputAVs();
-          for (int k = 0; k < prey_friends.GetSize(); k++) {
-            if (prey_friends[k]->HasOpinion()) {
-              if (groups_used[GetGroupIdx(group_ids, prey_friends[k]->GetOpinion().first)] == 0) num_used++;
-              groups_used[GetGroupIdx(group_ids, prey_friends[k]->GetOpinion().first)]++;
+    if (num_used < num_groups && (!prey_counts.IsActive() || prey_counts.GetNeighborPreyAV(av_cell_id) > 0)) {
+      const cConnectionList neighbors = first_org->GetOrgInterface().GetCell(av_cell_id)->ConnectionList();
+      for (int j = 0; j < neighbors.GetSize(); j++) {
+        const cPopulationCell* neighbor_cell = first_org->GetOrgInterface().GetCell(neighbors.GetIDAt(j));
+        if (neighbor_cell->HasPreyAV()) {
+          prey_friends = &neighbor_cell->ReadCellOutputAVs();
+          for (int k = 0; k < prey_friends->GetSize(); k++) {
+            if ((*prey_friends)[k]->HasOpinion()) {
+              if (groups_used[GetGroupIdx(group_ids, (*prey_friends)[k]->GetOpinion().first)] == 0) num_used++;
+              groups_used[GetGroupIdx(group_ids, (*prey_friends)[k]->GetOpinion().first)]++;
               if (num_used >= num_groups) break;
             }
           }
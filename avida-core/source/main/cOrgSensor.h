@@ -122,6 +122,8 @@ class cOrgSensor
   sSearchInfo TestCell(cAvidaContext& ctx, sLookInit& in_defs, const Apto::Coord<int>& target_cell_coords,
                       const Apto::Array<int, Apto::Smart>& val_res, bool first_step, bool stop_at_first_found);
   sLookOut PreWalk(cAvidaContext& ctx, sLookInit& in_defs, const int facing, const int cell_id);
+  bool ConeHasOrgs(const sLookInit& in_defs, const Apto::Coord<int>& center_cell, const Apto::Coord<int>& left,
+                   const Apto::Coord<int>& right, const Apto::Coord<int>& ahead_dir, int first_dist, int last_dist, bool torus);
   void SetWalkLimits(cAvidaContext& ctx, sLookInit& in_defs, sWalkLimits& limits, sBounds& worldBounds, sBounds& tot_bounds, Apto::Array<int, Apto::Smart>& val_res, int worldx, Apto::Coord<int>& this_cell, int facing, int cell, Apto::Coord<int>& center_cell, const Apto::Coord<int>& ahead_dir);
   void SetCoords(Apto::Coord<int>& left, Apto::Coord<int>& right, const int facing);
   
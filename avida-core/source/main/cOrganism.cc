@@ -25,6 +25,9 @@
 #include "avida/core/Feedback.h"
 #include "avida/core/WorldDriver.h"
 
+#include "avida/private/systematics/Genotype.h"
+#include "avida/private/util/MemoryStats.h"
+
 #include "cAvidaContext.h"
 #include "cContextPhenotype.h"
 #include "cDeme.h"
@@ -41,6 +44,8 @@
 #include "cStats.h"
 #include "nHardware.h"
 
+#include "apto/core/Mutex.h"
+
 #include <algorithm>
 #include <iomanip>
 #include <iterator>
@@ -145,12 +150,38 @@ void cOrganism::Initialize()
 // Creation Policies
 // --------------------------------------------------------------------------------------------------------------
 
+static const int MAX_POOLED_ORGANISMS = 16384;
+static Apto::Mutex s_org_pool_mutex;
+static Apto::Array<void*, Apto::Smart> s_org_pool;
+
+void* cOrganism::operator new(size_t size)
+{
+  if (size == sizeof(cOrganism)) {
+    Apto::MutexAutoLock lock(s_org_pool_mutex);
+    if (s_org_pool.GetSize()) {
+      void* ptr = s_org_pool[s_org_pool.GetSize() - 1];
+      s_org_pool.Resize(s_org_pool.GetSize() - 1);
+      return ptr;
+    }
+  }
+  return ::operator new(size);
+}
+
+void cOrganism::operator delete(void* ptr)
+{
+  if (!ptr) return;
+  Apto::MutexAutoLock lock(s_org_pool_mutex);
+  if (s_org_pool.GetSize() < MAX_POOLED_ORGANISMS) s_org_pool.Push(ptr);
+  else ::operator delete(ptr);
+}
+
 cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src)
   : m_world(world)
   , m_phenotype(world, parent_generation, world->GetHardwareManager().GetInstSet(genome.Properties().Get(s_ext_prop_name_instset).StringValue()).GetNumNops())
   , m_src(src)
   , m_initial_genome(genome)
   , m_interface(NULL)
+  , m_pop_interface(NULL)
   , m_lineage_label(-1)
   , m_lineage(NULL)
   , m_org_list_index(-1)
@@ -200,12 +231,13 @@ cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, in
   , m_num_guard(0)
   , m_num_deposits(0)
   , m_amount_deposited(0)
-  , m_string_map(NULL)
+  , m_string_support(world->GetEnvironment().GetNumberOfMatchStrings())
   , m_num_point_mut(0)
   , m_av_in_index(-1)
   , m_av_out_index(-1)
   , m_prop_map(this)
 {
+  Util::MemoryStats::Created(Util::MemoryStats::ORGANISMS);
 	// initializing this here because it may be needed during hardware creation:
 	m_id = m_world->GetStats().GetTotCreatures();
   
@@ -214,6 +246,15 @@ cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, in
   initialize(ctx);
 }
 
+void cOrganism::ShareGenotypeGenome()
+{
+  Systematics::GenotypePtr genotype;
+  genotype.DynamicCastFrom(SystematicsGroup("genotype"));
+  if (!genotype) return;
+  
+  const_cast<Genome&>(m_initial_genome).Share(genotype->GroupGenome());
+}
+
 void cOrganism::initialize(cAvidaContext& ctx)
 {
   m_phenotype.SetInstSetSize(m_hardware->GetInstSet().GetSize());
@@ -246,17 +287,17 @@ void cOrganism::initialize(cAvidaContext& ctx)
 }
 
 cOrganism::~cOrganism()
-{  
+{
+  Util::MemoryStats::Destroyed(Util::MemoryStats::ORGANISMS);
   assert(m_is_running == false);
-  delete m_hardware;
+  m_world->GetHardwareManager().Recycle(m_hardware);
   delete m_interface;
   
-  if(m_msg) delete m_msg;
+  if(m_msg) m_world->GetMessagePool().Release(m_msg);
   if(m_opinion) delete m_opinion;  
   if (m_neighborhood) delete m_neighborhood;
   delete m_org_display;
   delete m_queued_display_data;
-  if (m_string_map) delete m_string_map;
 }
 
 
@@ -266,6 +307,7 @@ void cOrganism::SetOrgInterface(cAvidaContext& ctx, cOrgInterface* org_interface
 {
   delete m_interface;
   m_interface = org_interface;
+  m_pop_interface = dynamic_cast<cPopulationInterface*>(org_interface);
   
   HardwareReset(ctx);
 }
@@ -378,28 +420,28 @@ void cOrganism::DoInput(tBuffer<int>& input_buffer, tBuffer<int>& output_buffer,
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const bool on_divide, cContextPhenotype* context_phenotype)
 {
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, on_divide, false, context_phenotype);
+  if (m_world->GetRuntimeConfig().use_avatars) doAVOutput(ctx, m_input_buf, m_output_buf, on_divide, false, context_phenotype);
   else doOutput(ctx, m_input_buf, m_output_buf, on_divide, false, context_phenotype);
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const int value)
 {
   m_output_buf.Add(value);
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, false, false);
+  if (m_world->GetRuntimeConfig().use_avatars) doAVOutput(ctx, m_input_buf, m_output_buf, false, false);
   else doOutput(ctx, m_input_buf, m_output_buf, false, false);
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const int value, bool is_parasite, cContextPhenotype* context_phenotype) 
 {
   m_output_buf.Add(value);
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, false, (bool)is_parasite, context_phenotype); 
+  if (m_world->GetRuntimeConfig().use_avatars) doAVOutput(ctx, m_input_buf, m_output_buf, false, (bool)is_parasite, context_phenotype); 
   else doOutput(ctx, m_input_buf, m_output_buf, false, (bool)is_parasite, context_phenotype); 
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const int value)
 {
   output_buffer.Add(value);
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, input_buffer, output_buffer, false, false);
+  if (m_world->GetRuntimeConfig().use_avatars) doAVOutput(ctx, input_buffer, output_buffer, false, false);
   else doOutput(ctx, input_buffer, output_buffer, false, false);
 }
 
@@ -453,7 +495,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   Apto::Array<cString> insts_triggered;
   
   tBuffer<int>* received_messages_point = &m_received_messages;
-  if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
+  if (!m_world->GetRuntimeConfig().save_received) received_messages_point = NULL;
   
   cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
                        m_hardware->GetExtendedMemory(), on_divide, received_messages_point);
@@ -487,7 +529,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
                                                insts_triggered, is_parasite, context_phenotype);
   
   // Handle merit increases that take the organism above it's current population merit
-  if (m_world->GetConfig().MERIT_INC_APPLY_IMMEDIATE.Get()) {
+  if (m_world->GetRuntimeConfig().merit_inc_apply_immediate) {
     double cur_merit = m_phenotype.CalcCurrentMerit();
     if (m_phenotype.GetMerit().GetDouble() < cur_merit) m_interface->UpdateMerit(ctx, cur_merit);
   }
@@ -496,7 +538,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   for (int i = 0; i < global_res_change.GetSize(); i++) global_res_change[i] = globalAndDeme_res_change[i];
   for (int i = 0; i < deme_res_change.GetSize(); i++) deme_res_change[i] = globalAndDeme_res_change[i + global_res_change.GetSize()];
   
-  if(m_world->GetConfig().ENERGY_ENABLED.Get() && m_world->GetConfig().APPLY_ENERGY_METHOD.Get() == 1 && task_completed) {
+  if(m_world->GetRuntimeConfig().energy_enabled && m_world->GetRuntimeConfig().apply_energy_method == 1 && task_completed) {
     m_phenotype.RefreshEnergy();
     m_phenotype.ApplyToEnergyStore();
     double newMerit = m_phenotype.ConvertEnergyToMerit(m_phenotype.GetStoredEnergy() * m_phenotype.GetEnergyUsageRatio());
@@ -571,7 +613,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
   Apto::Array<cString> insts_triggered;
   
   tBuffer<int>* received_messages_point = &m_received_messages;
-  if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
+  if (!m_world->GetRuntimeConfig().save_received) received_messages_point = NULL;
   
   cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
                        m_hardware->GetExtendedMemory(), on_divide, received_messages_point);
@@ -606,7 +648,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
                                                insts_triggered, is_parasite, context_phenotype);
   
   // Handle merit increases that take the organism above it's current population merit
-  if (m_world->GetConfig().MERIT_INC_APPLY_IMMEDIATE.Get()) {
+  if (m_world->GetRuntimeConfig().merit_inc_apply_immediate) {
     double cur_merit = m_phenotype.CalcCurrentMerit();
     if (m_phenotype.GetMerit().GetDouble() < cur_merit) m_interface->UpdateMerit(ctx, cur_merit);
   }
@@ -615,7 +657,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
   for (int i = 0; i < avatar_res_change.GetSize(); i++) avatar_res_change[i] = avatarAndDeme_res_change[i];
 //  deme_res_change = avatarAndDeme_res_change.Subset(avatar_res_change.GetSize(), avatarAndDeme_res_change.GetSize());
   
-  if(m_world->GetConfig().ENERGY_ENABLED.Get() && m_world->GetConfig().APPLY_ENERGY_METHOD.Get() == 1 && task_completed) {
+  if(m_world->GetRuntimeConfig().energy_enabled && m_world->GetRuntimeConfig().apply_energy_method == 1 && task_completed) {
     m_phenotype.RefreshEnergy();
     m_phenotype.ApplyToEnergyStore();
     double newMerit = m_phenotype.ConvertEnergyToMerit(m_phenotype.GetStoredEnergy() * m_phenotype.GetEnergyUsageRatio());
@@ -670,7 +712,7 @@ void cOrganism::NotifyDeath(cAvidaContext& ctx)
   
   // Return currently stored internal resources to the world
   if (m_world->GetConfig().USE_RESOURCE_BINS.Get() && m_world->GetConfig().RETURN_STORED_ON_DEATH.Get()) {
-  	if (m_world->GetConfig().USE_AVATARS.Get()) m_interface->UpdateAVResources(ctx, GetRBins());
+  	if (m_world->GetRuntimeConfig().use_avatars) m_interface->UpdateAVResources(ctx, GetRBins());
     else m_interface->UpdateResources(ctx, GetRBins());
   }
   
@@ -809,7 +851,7 @@ bool cOrganism::Divide_CheckViable(cAvidaContext& ctx)
       double resource_count = 0;
       for (int i = 0; i < resource_lib.GetSize(); i ++) {
         if (resource_lib.GetResource(i)->GetHabitat() == habitat_required) {
-          if (!m_world->GetConfig().USE_AVATARS.Get()) resource_count = m_interface->GetResourceVal(ctx, i);
+          if (!m_world->GetRuntimeConfig().use_avatars) resource_count = m_interface->GetResourceVal(ctx, i);
           else resource_count = m_interface->GetAVResourceVal(ctx, i);
           if (resource_count >= required_value) {
             has_req_res = true;
@@ -967,6 +1009,13 @@ void cOrganism::NewTrial()
 }
 
 
+/*! Takes this organism's message buffers from the world's pool.
+ */
+void cOrganism::AcquireMessaging() {
+	m_msg = m_world->GetMessagePool().Acquire();
+}
+
+
 /*! Called as the bottom-half of a successfully sent message.
  */
 void cOrganism::MessageSent(cAvidaContext&, cOrgMessage& msg) {
@@ -1264,6 +1313,7 @@ void cOrganism::SetForageTarget(cAvidaContext& ctx, int forage_target, bool inje
   }
   m_forage_target = forage_target;
   if (m_show_ft == -1) m_show_ft = m_forage_target;
+  if (m_interface) m_interface->ForageTargetChanged();
 }
 
 void cOrganism::CopyParentFT(cAvidaContext& ctx) {
@@ -1453,21 +1503,6 @@ void cOrganism::UpdateTag(int new_tag, int bits)
 }
 
 
-/* See if the output buffer matches the string */
-int cOrganism::MatchOutputBuffer(cString string_to_match)
-{
-	tBuffer<int> org_str (GetOutputBuf());
-	int num_matched =0; 
-	for (int j = 0; j < string_to_match.GetSize(); j++)
-	{
-		if ((string_to_match[j]=='0' && org_str[j]==0) ||
-				(string_to_match[j]=='1' && org_str[j]==1))
-			num_matched++;
-	}
-	return num_matched;
-}
-
-
 void cOrganism::SetOutputNegative1() 
 { 
 	for (int i=0; i<GetOutputBuf().GetCapacity(); i++) {
@@ -1476,29 +1511,14 @@ void cOrganism::SetOutputNegative1()
 	m_output_buf.Clear(); 
 }
 
-/* Initialize the string tracking map */
-void cOrganism::InitStringMap() 
-{
-	if (!m_string_map) {
-    m_string_map = new std::map < int, cStringSupport >;
-		// Get the strings from the task lib. 
-		std::vector < cString > temp_strings = m_world->GetEnvironment().GetMatchStringsFromTask(); 
-		// Create structure for each of them. 
-		for (unsigned int i=0; i < temp_strings.size(); i++){
-			(*m_string_map)[i].m_string = temp_strings[i];
-		}
-	}
-}
-
-
 bool cOrganism::ProduceString(int i)  
 { 
 	bool val = false; 
 	int cap = m_world->GetConfig().STRING_AMOUNT_CAP.Get(); 
-	if ((cap == -1) || ((*m_string_map)[i].on_hand < cap))
+	if (HasStringSupport(i) && ((cap == -1) || (m_string_support[i].on_hand < cap)))
 	{
-		(*m_string_map)[i].prod_string++; 
-		(*m_string_map)[i].on_hand++;
+		m_string_support[i].prod_string++; 
+		m_string_support[i].on_hand++;
 		val = true;
 	}
 	return val;
@@ -1508,9 +1528,9 @@ bool cOrganism::ProduceString(int i)
 bool cOrganism::DonateString(int string_tag, int amount)
 {
 	bool val = false; 
-	if ((*m_string_map)[string_tag].on_hand >= amount) {
+	if (HasStringSupport(string_tag) && (m_string_support[string_tag].on_hand >= amount)) {
 		val = true;
-		(*m_string_map)[string_tag].on_hand -= amount;
+		m_string_support[string_tag].on_hand -= amount;
 	}
 	return val;
 	
@@ -1521,10 +1541,10 @@ bool cOrganism::ReceiveString(int string_tag, int amount, int donor_id)
 {
 	bool val = false; 
 	int cap = m_world->GetConfig().STRING_AMOUNT_CAP.Get(); 
-	if ((cap == -1) || ((*m_string_map)[string_tag].on_hand < cap)) 
+	if (HasStringSupport(string_tag) && ((cap == -1) || (m_string_support[string_tag].on_hand < cap))) 
 	{
-		(*m_string_map)[string_tag].received_string++; 
-		(*m_string_map)[string_tag].on_hand++;
+		m_string_support[string_tag].received_string++; 
+		m_string_support[string_tag].on_hand++;
 		donor_list.insert(donor_id);	
 		m_num_donate_received += amount;
 		m_amount_donate_received++;
@@ -1538,7 +1558,7 @@ bool cOrganism::CanReceiveString(int string_tag, int)
 {
 	bool val = false; 
 	int cap = m_world->GetConfig().STRING_AMOUNT_CAP.Get(); 
-	if ((cap == -1) || ((*m_string_map)[string_tag].on_hand < cap))
+	if (HasStringSupport(string_tag) && ((cap == -1) || (m_string_support[string_tag].on_hand < cap)))
 	{
 		val = true;
 	}
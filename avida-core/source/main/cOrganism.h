@@ -29,10 +29,12 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 
 #include "cCPUMemory.h"
+#include "cMatchString.h"
 #include "cMutationRates.h"
 #include "cPhenotype.h"
 #include "cOrgInterface.h"
 #include "cOrgMessage.h"
+#include "cPopulationInterface.h"
 #include "tBuffer.h"
 #include "tList.h"
 
@@ -67,9 +69,10 @@ private:
   Systematics::Source m_src;
   
   const Genome m_initial_genome;         // Initial genome; can never be changed!
-  Apto::Array<Systematics::UnitPtr> m_parasites;   // List of all parasites associated with this organism.
+  Apto::Array<Systematics::UnitPtr, Apto::Smart> m_parasites;   // List of all parasites associated with this organism.
   cMutationRates m_mut_rates;             // Rate of all possible mutations.
   cOrgInterface* m_interface;             // Interface back to the population.
+  cPopulationInterface* m_pop_interface;  // m_interface when it is the population's (NULL on test CPUs), for direct calls
   int m_id;                               // unique id for each org, is just the number it was born
   int m_lineage_label;                    // a lineages tag; inherited unchanged in offspring
   cLineage* m_lineage;                    // A lineage descriptor... (different from label)
@@ -117,6 +120,10 @@ public:
   cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src);
   ~cOrganism();
   
+  // Organism storage is recycled through a free list, births and deaths being the most frequent allocations
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+  
   static void Initialize();
   
   
@@ -124,6 +131,10 @@ public:
   Systematics::Source UnitSource() const { return m_src; }
   const Genome& UnitGenome() const { return m_initial_genome; }
   
+  // Drop the private copy of the initial genome in favor of the (equal) representation held by the genotype the
+  // organism has been classified into, so the organisms of a genotype all reference a single sequence
+  void ShareGenotypeGenome();
+  
   const PropertyMap& Properties() const;
   
 
@@ -220,10 +231,11 @@ public:
   const cHardwareBase& GetHardware() const { return *m_hardware; }
   int GetID() { return m_id; }
 
-  int GetCellID() { return m_interface->GetCellID(); }
+  // The hottest lookups call the population interface directly, rather than through cOrgInterface
+  int GetCellID() { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetCellID() : m_interface->GetCellID(); }
   int GetAVCellID() { return m_interface->GetAVCellID(); }
-  int GetDemeID() { return m_interface->GetDemeID(); }
-  cDeme* GetDeme() { return m_interface->GetDeme(); }
+  int GetDemeID() { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetDemeID() : m_interface->GetDemeID(); }
+  cDeme* GetDeme() { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetDeme() : m_interface->GetDeme(); }
 
   int GetCellData() { return m_interface->GetCellData(); }
   int GetCellDataOrgID() { return m_interface->GetCellDataOrgID(); }
@@ -236,18 +248,23 @@ public:
   int GetFacedCellDataUpdate() { return m_interface->GetFacedCellDataUpdate(); }
   int GetFacedCellDataTerritory() { return m_interface->GetFacedCellDataTerritory(); }
   
-  cOrganism* GetNeighbor() { return m_interface->GetNeighbor(); }
-  bool IsNeighborCellOccupied() { return m_interface->IsNeighborCellOccupied(); }
-  int GetNeighborhoodSize() { return m_interface->GetNumNeighbors(); }
+  cOrganism* GetNeighbor()
+    { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetNeighbor() : m_interface->GetNeighbor(); }
+  bool IsNeighborCellOccupied()
+    { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::IsNeighborCellOccupied() : m_interface->IsNeighborCellOccupied(); }
+  int GetNeighborhoodSize()
+    { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetNumNeighbors() : m_interface->GetNumNeighbors(); }
   int GetFacing() { assert(m_interface); return m_interface->GetFacing(); }  // Returns the facing of this organism.
-  int GetFacedCellID() { assert(m_interface); return m_interface->GetFacedCellID(); }  // Returns the faced cell of this organism.
+  int GetFacedCellID()  // Returns the faced cell of this organism.
+    { assert(m_interface); return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetFacedCellID() : m_interface->GetFacedCellID(); }
   int GetFacedDir() { assert(m_interface); return m_interface->GetFacedDir(); }  // Returns the human interpretable facing of this org.
   int GetNeighborCellContents() const { return m_interface->GetNeighborCellContents(); }
   void Rotate(cAvidaContext& ctx, int direction) { m_interface->Rotate(ctx, direction); }
 
-  int GetInputAt(int i) { return m_interface->GetInputAt(i); }
-  int GetNextInput() { return m_interface->GetInputAt(m_input_pointer); }
-  int GetNextInput(int& in_input_pointer) { return m_interface->GetInputAt(in_input_pointer); }
+  int GetInputAt(int i) { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetInputAt(i) : m_interface->GetInputAt(i); }
+  int GetNextInput() { return GetNextInput(m_input_pointer); }
+  int GetNextInput(int& in_input_pointer)
+    { return (m_pop_interface) ? m_pop_interface->cPopulationInterface::GetInputAt(in_input_pointer) : m_interface->GetInputAt(in_input_pointer); }
   tBuffer<int>& GetInputBuf() { return m_input_buf; }
   tBuffer<int>& GetOutputBuf() { return m_output_buf; }
   void Die(cAvidaContext& ctx) { m_interface->Die(ctx); m_is_dead = true; } 
@@ -302,7 +319,7 @@ public:
   bool InjectParasite(Systematics::UnitPtr parent, const cString& label, const InstructionSequence& genome);
   bool ParasiteInfectHost(Systematics::UnitPtr parasite);
   int GetNumParasites() const { return m_parasites.GetSize(); }
-  const Apto::Array<Systematics::UnitPtr>& GetParasites() const { return m_parasites; }
+  const Apto::Array<Systematics::UnitPtr, Apto::Smart>& GetParasites() const { return m_parasites; }
   void ClearParasites();
 
   // --------  Mutation Rate Convenience Methods  --------
@@ -382,7 +399,7 @@ public:
 
   // -------- Messaging support --------
 public:
-  typedef std::deque<cOrgMessage> message_list_type; //!< Container-type for cOrgMessages.
+  typedef cOrgMessagePool::MessageList message_list_type; //!< Container-type for cOrgMessages.
 
   //! Called when this organism attempts to send a message.
   bool SendMessage(cAvidaContext& ctx, cOrgMessage& msg);
@@ -403,22 +420,14 @@ public:
 private:
   /*! Contains all the different data structures needed to support messaging within
   cOrganism.  Inspired by cNetSupport (above), the idea is to minimize impact on
-  organisms that DON'T use messaging. */
-  struct cMessagingSupport
-  {
-    cMessagingSupport() : retrieve_index(0) { }
-
-    message_list_type sent; //!< List of all messages sent by this organism.
-    message_list_type received; //!< List of all messages received by this organism.
-    message_list_type::size_type retrieve_index; //!< Index of next message that can be retrieved.
-  };
-
-  /*! This member variable is lazily initialized whenever any of the messaging
-  methods are used.  (My kingdom for boost::shared_ptr.) */
-  cMessagingSupport* m_msg;
+  organisms that DON'T use messaging.  Taken from (and returned to) the world's
+  message pool. */
+  cOrgMessagePool::sBuffers* m_msg;
 
   //! Called to check for (and initialize) messaging support within this organism.
-  inline void InitMessaging() { if(!m_msg) m_msg = new cMessagingSupport(); }	
+  inline void InitMessaging() { if(!m_msg) AcquireMessaging(); }
+  //! Takes this organism's message buffers from the world's pool.
+  void AcquireMessaging();
   //! Called as the bottom-half of a successfully sent message.
   void MessageSent(cAvidaContext& ctx, cOrgMessage& msg);
   // -------- End of messaging support --------
@@ -564,7 +573,7 @@ public:
   bool IsDonor(int neighbor_id); 
 
   // Check if buffer contains this string; return # bits correct
-  int MatchOutputBuffer(cString string_to_match);
+  int MatchOutputBuffer(const cMatchString& string_to_match) const { return string_to_match.CountMatches(m_output_buf); }
 
   // Add a donor
   void AddDonor(int org_id) { donor_list.insert(org_id); }
@@ -584,10 +593,9 @@ public:
   void SetOutputNegative1();
   void AddDonatedLineage(int lin) { donating_lineages.insert(lin); }
   int GetNumberOfDonatedLineages() { return donating_lineages.size(); }
-  void InitStringMap(); 
   bool ProduceString(int i);  
-  int GetNumberStringsProduced(int i) { return m_string_map ? (*m_string_map)[i].prod_string : 0; }
-  int GetNumberStringsOnHand(int i) { return m_string_map ? (*m_string_map)[i].on_hand : 0; }
+  int GetNumberStringsProduced(int i) const { return HasStringSupport(i) ? m_string_support[i].prod_string : 0; }
+  int GetNumberStringsOnHand(int i) const { return HasStringSupport(i) ? m_string_support[i].on_hand : 0; }
   bool DonateString(int string_tag, int amount); 
   bool ReceiveString(int string_tag, int amount, int donor_id); 
   bool CanReceiveString(int string_tag, int amount); 
@@ -695,16 +703,17 @@ protected:
   {
     cStringSupport() 
     { prod_string = 0; received_string = 0; on_hand = 0; }
-    cString m_string; //!< The string being tracked
     int prod_string; //!< The number of times this string has been produced. 
     int received_string; //!< The number of times this string has been received.
     int on_hand; //!< The number of copies of the string this organism has on hand
   };
 
-  /* This member variable is a map of tags to strings. It can
-  be used to track production, consumption, and donation of 
+  /* The string support of each match string of the environment, indexed
+  by tag. It is used to track production, consumption, and donation of 
   strings. */
-  std::map < int, cStringSupport >* m_string_map;
+  Apto::Array<cStringSupport> m_string_support;
+  
+  bool HasStringSupport(int string_tag) const { return (string_tag >= 0 && string_tag < m_string_support.GetSize()); }
 
 
   // -------- HGT conjugation support --------
@@ -21,16 +21,56 @@
 
 #include "cParasite.h"
 
+#include "avida/private/systematics/Genotype.h"
 #include "avida/systematics/Group.h"
 
 #include "cHardwareManager.h"
 #include "cInstSet.h"
 
+#include "apto/core/Mutex.h"
 
-cParasite::cParasite(cWorld* world, const Avida::Genome& genome, int parent_generation, Systematics::Source src)
-  : m_src(src), m_initial_genome(genome)
+
+static const int MAX_POOLED_PARASITES = 16384;
+static Apto::Mutex s_parasite_pool_mutex;
+static Apto::Array<void*, Apto::Smart> s_parasite_pool;
+
+void* cParasite::operator new(size_t size)
+{
+  if (size == sizeof(cParasite)) {
+    Apto::MutexAutoLock lock(s_parasite_pool_mutex);
+    if (s_parasite_pool.GetSize()) {
+      void* ptr = s_parasite_pool[s_parasite_pool.GetSize() - 1];
+      s_parasite_pool.Resize(s_parasite_pool.GetSize() - 1);
+      return ptr;
+    }
+  }
+  return ::operator new(size);
+}
+
+void cParasite::operator delete(void* ptr)
+{
+  if (!ptr) return;
+  Apto::MutexAutoLock lock(s_parasite_pool_mutex);
+  if (s_parasite_pool.GetSize() < MAX_POOLED_PARASITES) s_parasite_pool.Push(ptr);
+  else ::operator delete(ptr);
+}
+
+
+cParasite::cParasite(cWorld* world, Avida::Genome& genome, int parent_generation, Systematics::Source src)
+  : m_src(src)
   , m_phenotype(world, parent_generation, world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue()).GetNumNops())
 {
+  m_initial_genome.Adopt(genome);
+  
   // @TODO - properly construct cPhenotype
   // @TODO - construct parasite property map...
 }
+
+void cParasite::ShareGenotypeGenome()
+{
+  Systematics::GenotypePtr genotype;
+  genotype.DynamicCastFrom(SystematicsGroup("genotype"));
+  if (!genotype) return;
+  
+  m_initial_genome.Share(genotype->GroupGenome());
+}
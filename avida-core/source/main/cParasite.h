@@ -37,7 +37,7 @@ class cParasite : public Systematics::Unit
 private:
   Systematics::Source m_src;
   Apto::String m_src_args;
-  const Avida::Genome m_initial_genome;
+  Avida::Genome m_initial_genome;
   
   HashPropertyMap m_prop_map;
   
@@ -46,9 +46,14 @@ private:
   
   
 public:
-  cParasite(cWorld* world, const Avida::Genome& genome, int parent_generation, Systematics::Source src);
+  // Takes genome's representation rather than a clone of it, leaving genome without one (see Genome::Adopt)
+  cParasite(cWorld* world, Avida::Genome& genome, int parent_generation, Systematics::Source src);
   ~cParasite() { ; }
   
+  // Parasite storage is recycled through a free list, infections in coevolution runs being as frequent as births
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+  
   // --------  Systematics::Unit Methods  --------
   Systematics::Source UnitSource() const { return m_src; }
   const Avida::Genome& UnitGenome() const { return m_initial_genome; }  
@@ -59,6 +64,9 @@ public:
   cPhenotype& GetPhenotype() { return m_phenotype; }
   double GetVirulence() { return virulence; }
   void SetVirulence(double v) { virulence = v; }
+  
+  // Reference the genome held by this parasite's genotype in place of its own copy, once it has been classified
+  void ShareGenotypeGenome();
 
 private:
   cParasite(); // @not_implemented
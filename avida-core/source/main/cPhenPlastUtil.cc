@@ -23,8 +23,33 @@
 
 #include "avida/systematics/Group.h"
 
+#include "apto/core/Map.h"
+
+#include "cAnalyze.h"
 #include "cPhenPlastGenotype.h"
 #include "cPhenPlastSummary.h"
+#include "tAnalyzeJobBatch.h"
+
+
+class cPhenPlastJob
+{
+private:
+  cWorld* m_world;
+  Genome m_genome;
+  int m_num_trials;
+  
+public:
+  Apto::SmartPtr<cPhenPlastGenotype> m_result;
+  
+  cPhenPlastJob(cWorld* world, const Genome& genome, int num_trials)
+    : m_world(world), m_genome(genome), m_num_trials(num_trials) { ; }
+  
+  void Run(cAvidaContext& ctx)
+  {
+    cCPUTestInfo test_info;
+    m_result = Apto::SmartPtr<cPhenPlastGenotype>(new cPhenPlastGenotype(m_genome, m_num_trials, test_info, m_world, ctx));
+  }
+};
 
 
 int cPhenPlastUtil::GetNumPhenotypes(cAvidaContext& ctx, cWorld* world, Systematics::GroupPtr bg)
@@ -32,7 +57,7 @@ int cPhenPlastUtil::GetNumPhenotypes(cAvidaContext& ctx, cWorld* world, Systemat
   Apto::SmartPtr<cPhenPlastSummary> ps = bg->GetData<cPhenPlastSummary>();
   if (!ps) {
     
-    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->Properties().Get("genome"))));
+    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME))));
     bg->AttachData(ps);
   }
   
@@ -44,7 +69,7 @@ double cPhenPlastUtil::GetPhenotypicEntropy(cAvidaContext& ctx, cWorld* world, S
   Apto::SmartPtr<cPhenPlastSummary> ps = bg->GetData<cPhenPlastSummary>();
   if (!ps) {
     
-    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->Properties().Get("genome"))));
+    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME))));
     bg->AttachData(ps);
   }
   
@@ -56,7 +81,7 @@ double cPhenPlastUtil::GetTaskProbability(cAvidaContext& ctx, cWorld* world, Sys
   Apto::SmartPtr<cPhenPlastSummary> ps = bg->GetData<cPhenPlastSummary>();
   if (!ps) {
     
-    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->Properties().Get("genome"))));
+    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME))));
     bg->AttachData(ps);
   }
   
@@ -68,7 +93,7 @@ const Apto::Array<double>& cPhenPlastUtil::GetTaskProbabilities(cAvidaContext& c
   Apto::SmartPtr<cPhenPlastSummary> ps = bg->GetData<cPhenPlastSummary>();
   if (!ps) {
     
-    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->Properties().Get("genome"))));
+    ps = Apto::SmartPtr<cPhenPlastSummary>(TestPlasticity(ctx, world, Genome(bg->StringProperty(Systematics::GROUP_PROP_GENOME))));
     bg->AttachData(ps);
   }
   
@@ -82,3 +107,53 @@ cPhenPlastSummary* cPhenPlastUtil::TestPlasticity(cAvidaContext& ctx, cWorld* wo
   cPhenPlastGenotype pp(mg, world->GetConfig().GENOTYPE_PHENPLAST_CALC.Get(), test_info, world, ctx);
   return new cPhenPlastSummary(pp);
 }
+
+void cPhenPlastUtil::TestPlasticity(cAvidaContext& ctx, cWorld* world, const Apto::Array<Genome, Apto::Smart>& genomes,
+                                    int num_trials, Apto::Array<Apto::SmartPtr<cPhenPlastGenotype>, Apto::Smart>& results)
+{
+  // One job per distinct genome
+  Apto::Array<cPhenPlastJob*, Apto::Smart> jobs;
+  Apto::Array<int, Apto::Smart> job_of(genomes.GetSize());
+  Apto::Map<Apto::String, int> seen;
+  for (int i = 0; i < genomes.GetSize(); i++) {
+    const Apto::String key(genomes[i].AsString());
+    if (!seen.Get(key, job_of[i])) {
+      job_of[i] = jobs.GetSize();
+      seen.Set(key, job_of[i]);
+      jobs.Push(new cPhenPlastJob(world, genomes[i], num_trials));
+    }
+  }
+  
+  // Analyze workers cannot wait on the queue they are serving, so they (and analyze mode) just run the jobs in turn
+  if (ctx.GetAnalyzeMode() || jobs.GetSize() < 2) {
+    for (int j = 0; j < jobs.GetSize(); j++) jobs[j]->Run(ctx);
+  } else {
+    tAnalyzeJobBatch<cPhenPlastJob> jobbatch(world->GetAnalyze().GetJobQueue());
+    for (int j = 0; j < jobs.GetSize(); j++) jobbatch.AddJob(jobs[j], &cPhenPlastJob::Run);
+    jobbatch.RunBatch();
+  }
+  
+  results.Resize(genomes.GetSize());
+  for (int i = 0; i < genomes.GetSize(); i++) results[i] = jobs[job_of[i]]->m_result;
+  for (int j = 0; j < jobs.GetSize(); j++) delete jobs[j];
+}
+
+void cPhenPlastUtil::PrepareSummaries(cAvidaContext& ctx, cWorld* world, const Apto::Array<Systematics::GroupPtr, Apto::Smart>& groups)
+{
+  Apto::Array<Systematics::GroupPtr, Apto::Smart> pending;
+  Apto::Array<Genome, Apto::Smart> genomes;
+  for (int i = 0; i < groups.GetSize(); i++) {
+    if (groups[i]->GetData<cPhenPlastSummary>()) continue;
+    pending.Push(groups[i]);
+    genomes.Push(Genome(groups[i]->StringProperty(Systematics::GROUP_PROP_GENOME)));
+  }
+  if (!pending.GetSize()) return;
+  
+  Apto::Array<Apto::SmartPtr<cPhenPlastGenotype>, Apto::Smart> results;
+  TestPlasticity(ctx, world, genomes, world->GetConfig().GENOTYPE_PHENPLAST_CALC.Get(), results);
+  
+  // Attached here on the calling thread, never from the workers
+  for (int i = 0; i < pending.GetSize(); i++) {
+    pending[i]->AttachData(Apto::SmartPtr<cPhenPlastSummary>(new cPhenPlastSummary(*results[i])));
+  }
+}
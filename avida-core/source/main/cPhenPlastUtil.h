@@ -25,7 +25,11 @@
 #include "avida/core/Types.h"
 #include "avida/systematics/Types.h"
 
+#include "apto/core/Array.h"
+#include "apto/core/SmartPtr.h"
+
 class cAvidaContext;
+class cPhenPlastGenotype;
 class cPhenPlastSummary;
 class cWorld;
 
@@ -43,6 +47,12 @@ public:
   static double GetTaskProbability(cAvidaContext& ctx, cWorld* world, Systematics::GroupPtr bg, int task_id);
   static const Apto::Array<double>& GetTaskProbabilities(cAvidaContext& ctx, cWorld* world, Systematics::GroupPtr bg);
   static cPhenPlastSummary* TestPlasticity(cAvidaContext& ctx, cWorld* world, const Genome& mg);
+  
+  // Batched forms: every genome becomes one job on the analyze threads (identical genomes share a single job), each
+  // writing only its own result.  Run serially on ctx when ctx is already an analyze context.
+  static void TestPlasticity(cAvidaContext& ctx, cWorld* world, const Apto::Array<Genome, Apto::Smart>& genomes,
+                             int num_trials, Apto::Array<Apto::SmartPtr<cPhenPlastGenotype>, Apto::Smart>& results);
+  static void PrepareSummaries(cAvidaContext& ctx, cWorld* world, const Apto::Array<Systematics::GroupPtr, Apto::Smart>& groups);
 };  
 
 
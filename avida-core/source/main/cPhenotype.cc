@@ -67,9 +67,12 @@ cPhenotype::cPhenotype(cWorld* world, int parent_generation, int num_nops)
 , cur_mating_display_a(0)
 , cur_mating_display_b(0)
 , m_reaction_result(NULL)
+, m_inst_count_total(NULL)
 , last_task_count(m_world->GetEnvironment().GetNumTasks())
 , last_para_tasks(m_world->GetEnvironment().GetNumTasks())
 , last_host_tasks(m_world->GetEnvironment().GetNumTasks())
+, last_para_task_bits(m_world->GetEnvironment().GetNumTasks())
+, last_host_task_bits(m_world->GetEnvironment().GetNumTasks())
 , last_internal_task_count(m_world->GetEnvironment().GetNumTasks())
 , last_task_quality(m_world->GetEnvironment().GetNumTasks())
 , last_task_value(m_world->GetEnvironment().GetNumTasks())
@@ -93,7 +96,8 @@ cPhenotype::cPhenotype(cWorld* world, int parent_generation, int num_nops)
 , is_germ_cell(m_world->GetConfig().DEMES_ORGS_START_IN_GERM.Get())
 , last_task_time(0)
 
-{ 
+{
+  Avida::Util::MemoryStats::Created(Avida::Util::MemoryStats::PHENOTYPES);
   if (parent_generation >= 0) {
     generation = parent_generation;
     if (m_world->GetConfig().GENERATION_INC_METHOD.Get() != GENERATION_INC_BOTH) generation++;
@@ -107,14 +111,16 @@ cPhenotype::cPhenotype(cWorld* world, int parent_generation, int num_nops)
 
 cPhenotype::~cPhenotype()
 {
+  Avida::Util::MemoryStats::Destroyed(Avida::Util::MemoryStats::PHENOTYPES);
   // Remove Task States
   for (Apto::Map<void*, cTaskState*>::ValueIterator it = m_task_states.Values(); it.Next();) delete (*it.Get());
   delete m_reaction_result;
 }
 
 
-cPhenotype::cPhenotype(const cPhenotype& in_phen) : m_reaction_result(NULL)
+cPhenotype::cPhenotype(const cPhenotype& in_phen) : m_reaction_result(NULL), m_inst_count_total(NULL)
 {
+  Avida::Util::MemoryStats::Created(Avida::Util::MemoryStats::PHENOTYPES);
   *this = in_phen;
 }
 
@@ -203,6 +209,8 @@ cPhenotype& cPhenotype::operator=(const cPhenotype& in_phen)
   last_task_count          = in_phen.last_task_count;
   last_host_tasks          = in_phen.last_host_tasks;
   last_para_tasks          = in_phen.last_para_tasks;
+  last_host_task_bits      = in_phen.last_host_task_bits;
+  last_para_task_bits      = in_phen.last_para_task_bits;
   last_internal_task_count = in_phen.last_internal_task_count;
   last_task_quality        = in_phen.last_task_quality;
   last_internal_task_quality=in_phen.last_internal_task_quality;
@@ -212,7 +220,9 @@ cPhenotype& cPhenotype::operator=(const cPhenotype& in_phen)
   last_collect_spec_counts = in_phen.last_collect_spec_counts;
   last_reaction_count      = in_phen.last_reaction_count;
   last_reaction_add_reward = in_phen.last_reaction_add_reward; 
+  countInstTotal(-1);
   last_inst_count          = in_phen.last_inst_count;	  
+  countInstTotal(1);
   last_from_sensor_count   = in_phen.last_from_sensor_count;
   last_group_attack_count   = in_phen.last_group_attack_count;
   last_top_pred_group_attack_count   = in_phen.last_top_pred_group_attack_count;
@@ -447,6 +457,8 @@ void cPhenotype::SetupOffspring(const cPhenotype& parent_phenotype, const Instru
   last_task_count           = parent_phenotype.last_task_count;
   last_host_tasks           = parent_phenotype.last_host_tasks;
   last_para_tasks           = parent_phenotype.last_para_tasks;
+  last_host_task_bits       = parent_phenotype.last_host_task_bits;
+  last_para_task_bits       = parent_phenotype.last_para_task_bits;
   last_internal_task_count  = parent_phenotype.last_internal_task_count;
   last_task_quality         = parent_phenotype.last_task_quality;
   last_task_value           = parent_phenotype.last_task_value;
@@ -456,7 +468,9 @@ void cPhenotype::SetupOffspring(const cPhenotype& parent_phenotype, const Instru
   last_collect_spec_counts  = parent_phenotype.last_collect_spec_counts;
   last_reaction_count       = parent_phenotype.last_reaction_count;
   last_reaction_add_reward  = parent_phenotype.last_reaction_add_reward;
+  countInstTotal(-1);
   last_inst_count           = parent_phenotype.last_inst_count;
+  countInstTotal(1);
   last_from_sensor_count    = parent_phenotype.last_from_sensor_count;
   last_group_attack_count    = parent_phenotype.last_group_attack_count;
   last_top_pred_group_attack_count    = parent_phenotype.last_top_pred_group_attack_count;
@@ -673,6 +687,8 @@ void cPhenotype::SetupInject(const InstructionSequence& _genome)
   last_task_count.SetAll(0);
   last_host_tasks.SetAll(0);
   last_para_tasks.SetAll(0);
+  last_host_task_bits.Clear();
+  last_para_task_bits.Clear();
   last_internal_task_count.SetAll(0);
   last_task_quality.SetAll(0);
   last_task_value.SetAll(0);
@@ -682,6 +698,7 @@ void cPhenotype::SetupInject(const InstructionSequence& _genome)
   last_collect_spec_counts.SetAll(0);
   last_reaction_count.SetAll(0);
   last_reaction_add_reward.SetAll(0);
+  countInstTotal(-1);
   last_inst_count.SetAll(0);
   last_from_sensor_count.SetAll(0);
   last_from_message_count.SetAll(0);
@@ -818,6 +835,18 @@ void cPhenotype::ResetMerit()
 }
 
 
+// Copy a current count array into its last-divide counterpart and clear it, in a single pass
+template <class T> static inline void lockInCounts(Apto::Array<T>& last_counts, Apto::Array<T>& cur_counts)
+{
+  const int size = cur_counts.GetSize();
+  if (last_counts.GetSize() != size) last_counts.Resize(size);
+  for (int i = 0; i < size; i++) {
+    last_counts[i] = cur_counts[i];
+    cur_counts[i] = T(0);
+  }
+}
+
+
 /**
  * This function is run whenever an organism executes a successful divide.
  **/
@@ -861,27 +890,13 @@ void cPhenotype::DivideReset(const InstructionSequence& _genome)
   //TODO?  last_energy         = cur_energy_bonus;
   last_num_errors           = cur_num_errors;
   last_num_donates          = cur_num_donates;
-  last_task_count           = cur_task_count;
-  last_host_tasks           = cur_host_tasks;
   last_para_tasks           = cur_para_tasks;
-  last_internal_task_count  = cur_internal_task_count;
-  last_task_quality         = cur_task_quality;
-  last_task_value           = cur_task_value;
-  last_internal_task_quality= cur_internal_task_quality;
   last_rbins_total          = cur_rbins_total;
   last_rbins_avail          = cur_rbins_avail;
-  last_collect_spec_counts  = cur_collect_spec_counts;
-  last_reaction_count       = cur_reaction_count;
-  last_reaction_add_reward  = cur_reaction_add_reward;
-  last_inst_count           = cur_inst_count;
-  last_from_sensor_count    = cur_from_sensor_count;
-  last_from_message_count    = cur_from_message_count;
   last_group_attack_count   = cur_group_attack_count;
-  last_killed_targets       = cur_killed_targets;
   last_attacks              = cur_attacks;
   last_kills                = cur_kills;
   last_top_pred_group_attack_count    = cur_top_pred_group_attack_count;
-  last_sense_count          = cur_sense_count;
   last_child_germline_propensity = cur_child_germline_propensity;
   
   last_mating_display_a = cur_mating_display_a; //@CHC
@@ -893,8 +908,8 @@ void cPhenotype::DivideReset(const InstructionSequence& _genome)
   cur_energy_bonus = 0.0;
   cur_num_errors  = 0;
   cur_num_donates  = 0;
-  cur_task_count.SetAll(0);
-  cur_host_tasks.SetAll(0);
+  lockInCounts(last_task_count, cur_task_count);
+  lockInCounts(last_host_tasks, cur_host_tasks);
   
   cur_mating_display_a = 0; //@CHC
   cur_mating_display_b = 0;
@@ -905,11 +920,12 @@ void cPhenotype::DivideReset(const InstructionSequence& _genome)
     last_para_tasks = cur_para_tasks;
     cur_para_tasks.SetAll(0);
   }
-  cur_internal_task_count.SetAll(0);
+  refreshTaskBits();
+  lockInCounts(last_internal_task_count, cur_internal_task_count);
   eff_task_count.SetAll(0);
-  cur_task_quality.SetAll(0);
-  cur_task_value.SetAll(0);
-  cur_internal_task_quality.SetAll(0);
+  lockInCounts(last_task_quality, cur_task_quality);
+  lockInCounts(last_task_value, cur_task_value);
+  lockInCounts(last_internal_task_quality, cur_internal_task_quality);
   if (m_world->GetConfig().SPLIT_ON_DIVIDE.Get()) {
     // resources available are split in half -- the offspring gets the other half
     for (int i = 0; i < cur_rbins_avail.GetSize(); i++) {cur_rbins_avail[i] /= 2.0;}
@@ -922,23 +938,25 @@ void cPhenotype::DivideReset(const InstructionSequence& _genome)
       cur_rbins_avail[resource] += m_world->GetConfig().RESOURCE_GIVEN_AT_BIRTH.Get();
     }
   }
-  cur_collect_spec_counts.SetAll(0);
-  cur_reaction_count.SetAll(0);
+  lockInCounts(last_collect_spec_counts, cur_collect_spec_counts);
+  lockInCounts(last_reaction_count, cur_reaction_count);
   first_reaction_cycles.SetAll(-1);
   first_reaction_execs.SetAll(-1);
   cur_stolen_reaction_count.SetAll(0);
-  cur_reaction_add_reward.SetAll(0);
-  cur_inst_count.SetAll(0);
-  cur_from_sensor_count.SetAll(0);
-  cur_from_message_count.SetAll(0);
+  lockInCounts(last_reaction_add_reward, cur_reaction_add_reward);
+  countInstTotal(-1);
+  lockInCounts(last_inst_count, cur_inst_count);
+  countInstTotal(1);
+  lockInCounts(last_from_sensor_count, cur_from_sensor_count);
+  lockInCounts(last_from_message_count, cur_from_message_count);
   for (int r = 0; r < cur_group_attack_count.GetSize(); r++) {
     cur_group_attack_count[r].SetAll(0);
     cur_top_pred_group_attack_count[r].SetAll(0);
   }
-  cur_killed_targets.SetAll(0);
+  lockInCounts(last_killed_targets, cur_killed_targets);
   cur_attacks = 0;
   cur_kills = 0;
-  cur_sense_count.SetAll(0);
+  lockInCounts(last_sense_count, cur_sense_count);
   cur_task_time.SetAll(0.0);
   cur_child_germline_propensity = m_world->GetConfig().DEMES_DEFAULT_GERMLINE_PROPENSITY.Get();
   
@@ -1094,27 +1112,13 @@ void cPhenotype::TestDivideReset(const InstructionSequence& _genome)
   last_cpu_cycles_used      = cpu_cycles_used;
   last_num_errors           = cur_num_errors;
   last_num_donates          = cur_num_donates;
-  last_task_count           = cur_task_count;
-  last_host_tasks           = cur_host_tasks;
   last_para_tasks           = cur_para_tasks;
-  last_internal_task_count  = cur_internal_task_count;
-  last_task_quality         = cur_task_quality;
-  last_task_value			= cur_task_value;
-  last_internal_task_quality= cur_internal_task_quality;
   last_rbins_total          = cur_rbins_total;
   last_rbins_avail          = cur_rbins_avail;
-  last_collect_spec_counts  = cur_collect_spec_counts;
-  last_reaction_count       = cur_reaction_count;
-  last_reaction_add_reward  = cur_reaction_add_reward;
-  last_inst_count           = cur_inst_count;
-  last_from_sensor_count    = cur_from_sensor_count;
-  last_from_message_count    = cur_from_message_count;
   last_group_attack_count   = cur_group_attack_count;
-  last_killed_targets       = cur_killed_targets;
   last_attacks              = cur_attacks;
   last_kills                = cur_kills;
   last_top_pred_group_attack_count    = cur_top_pred_group_attack_count;
-  last_sense_count          = cur_sense_count;
   last_child_germline_propensity = cur_child_germline_propensity;
   
   // Reset cur values.
@@ -1122,42 +1126,45 @@ void cPhenotype::TestDivideReset(const InstructionSequence& _genome)
   cpu_cycles_used = 0;
   cur_num_errors  = 0;
   cur_num_donates  = 0;
-  cur_task_count.SetAll(0);
-  cur_host_tasks.SetAll(0);
+  lockInCounts(last_task_count, cur_task_count);
+  lockInCounts(last_host_tasks, cur_host_tasks);
   // @LZ: figure out when and where to reset cur_para_tasks, depending on the divide method, and
   //      resonable assumptions
   if (m_world->GetConfig().DIVIDE_METHOD.Get() == DIVIDE_METHOD_SPLIT) {
     last_para_tasks = cur_para_tasks;
     cur_para_tasks.SetAll(0);
   }
-  cur_internal_task_count.SetAll(0);
+  refreshTaskBits();
+  lockInCounts(last_internal_task_count, cur_internal_task_count);
   eff_task_count.SetAll(0);
-  cur_task_quality.SetAll(0);
-  cur_task_value.SetAll(0);
-  cur_internal_task_quality.SetAll(0);
+  lockInCounts(last_task_quality, cur_task_quality);
+  lockInCounts(last_task_value, cur_task_value);
+  lockInCounts(last_internal_task_quality, cur_internal_task_quality);
   cur_rbins_total.SetAll(0);  // total resources collected in lifetime
   if (m_world->GetConfig().RESOURCE_GIVEN_ON_INJECT.Get() > 0.0) {   
     const int resource = m_world->GetConfig().COLLECT_SPECIFIC_RESOURCE.Get();
     cur_rbins_avail[resource] = m_world->GetConfig().RESOURCE_GIVEN_ON_INJECT.Get();
   }
   else cur_rbins_avail.SetAll(0);
-  cur_collect_spec_counts.SetAll(0);
-  cur_reaction_count.SetAll(0);
+  lockInCounts(last_collect_spec_counts, cur_collect_spec_counts);
+  lockInCounts(last_reaction_count, cur_reaction_count);
   first_reaction_cycles.SetAll(-1);
   first_reaction_execs.SetAll(-1);
   cur_stolen_reaction_count.SetAll(0);
-  cur_reaction_add_reward.SetAll(0);
-  cur_inst_count.SetAll(0);
-  cur_from_sensor_count.SetAll(0);
-  cur_from_message_count.SetAll(0);
+  lockInCounts(last_reaction_add_reward, cur_reaction_add_reward);
+  countInstTotal(-1);
+  lockInCounts(last_inst_count, cur_inst_count);
+  countInstTotal(1);
+  lockInCounts(last_from_sensor_count, cur_from_sensor_count);
+  lockInCounts(last_from_message_count, cur_from_message_count);
   for (int r = 0; r < cur_group_attack_count.GetSize(); r++) {
     cur_group_attack_count[r].SetAll(0);
     cur_top_pred_group_attack_count[r].SetAll(0);
   }
-  cur_killed_targets.SetAll(0);
+  lockInCounts(last_killed_targets, cur_killed_targets);
   cur_attacks = 0;
   cur_kills = 0;
-  cur_sense_count.SetAll(0);
+  lockInCounts(last_sense_count, cur_sense_count);
   cur_task_time.SetAll(0.0);
   sensed_resources.SetAll(-1.0);
   cur_trial_fitnesses.Resize(0); 
@@ -1355,13 +1362,17 @@ void cPhenotype::SetupClone(const cPhenotype& clone_phenotype)
   last_task_count          = clone_phenotype.last_task_count;
   last_host_tasks          = clone_phenotype.last_host_tasks;
   last_para_tasks          = clone_phenotype.last_para_tasks;
+  last_host_task_bits      = clone_phenotype.last_host_task_bits;
+  last_para_task_bits      = clone_phenotype.last_para_task_bits;
   last_internal_task_count = clone_phenotype.last_internal_task_count;
   last_rbins_total         = clone_phenotype.last_rbins_total;
   last_rbins_avail         = clone_phenotype.last_rbins_avail;
   last_collect_spec_counts = clone_phenotype.last_collect_spec_counts;
   last_reaction_count      = clone_phenotype.last_reaction_count;
   last_reaction_add_reward = clone_phenotype.last_reaction_add_reward;
+  countInstTotal(-1);
   last_inst_count          = clone_phenotype.last_inst_count;
+  countInstTotal(1);
   last_from_sensor_count   = clone_phenotype.last_from_sensor_count;
   last_from_message_count   = clone_phenotype.last_from_message_count;
   last_group_attack_count   = clone_phenotype.last_group_attack_count;
@@ -1505,7 +1516,7 @@ bool cPhenotype::TestOutput(cAvidaContext& ctx, cTaskContext& taskctx,
   
   // For refractory period @WRE 03-20-07
   const int cur_update_time = m_world->GetStats().GetUpdate();
-  const double task_refractory_period = m_world->GetConfig().TASK_REFRACTORY_PERIOD.Get();
+  const double task_refractory_period = m_world->GetRuntimeConfig().task_refractory_period;
   double refract_factor;
   
   if (!m_reaction_result) m_reaction_result = new cReactionResult(num_resources, num_tasks, num_reactions);
@@ -1554,7 +1565,7 @@ bool cPhenotype::TestOutput(cAvidaContext& ctx, cTaskContext& taskctx,
       if (result.UsedEnvResource() == false) { cur_internal_task_count[i]++; }
       
       // if we want to generate an age-task histogram
-      if (m_world->GetConfig().AGE_POLY_TRACKING.Get()) {
+      if (m_world->GetRuntimeConfig().age_poly_tracking) {
         m_world->GetStats().AgeTaskEvent(taskctx.GetOrganism()->GetID(), i, time_used);
       }
     }
@@ -1595,14 +1606,14 @@ bool cPhenotype::TestOutput(cAvidaContext& ctx, cTaskContext& taskctx,
       // If the organism has not performed this task,
       // then consider it to be a task switch.
       // If applicable, add in the penalty.
-      switch (m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get()) {
+      switch (m_world->GetRuntimeConfig().task_switch_penalty_type) {
         case 0: { // no penalty
           break;
         }
         case 1: { // "learning" cost
           int n_react = cur_reaction_count[i] -1;
-          if (n_react < m_world->GetConfig().LEARNING_COUNT.Get()) {
-            num_new_unique_reactions += ( m_world->GetConfig().LEARNING_COUNT.Get() - n_react);
+          if (n_react < m_world->GetRuntimeConfig().learning_count) {
+            num_new_unique_reactions += ( m_world->GetRuntimeConfig().learning_count - n_react);
           }
           break;
         }
@@ -2148,6 +2159,7 @@ void cPhenotype::NewTrial()
   last_task_count           = cur_task_count;
   last_host_tasks           = cur_host_tasks;
   last_para_tasks           = cur_para_tasks;
+  refreshTaskBits();
   last_internal_task_count  = cur_internal_task_count;
   last_task_quality         = cur_task_quality;
   last_internal_task_quality= cur_internal_task_quality;
@@ -2157,7 +2169,9 @@ void cPhenotype::NewTrial()
   last_collect_spec_counts  = cur_collect_spec_counts;
   last_reaction_count       = cur_reaction_count;
   last_reaction_add_reward  = cur_reaction_add_reward;
+  countInstTotal(-1);
   last_inst_count           = cur_inst_count;
+  countInstTotal(1);
   last_from_sensor_count    = cur_from_sensor_count;
   last_from_message_count    = cur_from_message_count;
   last_group_attack_count   = cur_group_attack_count;
@@ -2428,6 +2442,14 @@ void cPhenotype::SetLastParasiteTaskCount(Apto::Array<int> oldParaPhenotype)
   {
     last_para_tasks[i] = oldParaPhenotype[i];
   }
+  refreshTaskBits();
+}
+
+// Rebuild the task performed bits from the last host and parasite task counts
+void cPhenotype::refreshTaskBits()
+{
+  for (int i = 0; i < last_host_tasks.GetSize(); i++) last_host_task_bits.Set(i, last_host_tasks[i] > 0);
+  for (int i = 0; i < last_para_tasks.GetSize(); i++) last_para_task_bits.Set(i, last_para_tasks[i] > 0);
 }
 
 /* Return the cumulative reaction count if we aren't resetting on divide. */
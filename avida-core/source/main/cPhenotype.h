@@ -24,9 +24,11 @@
 #define cPhenotype_h
 
 #include "avida/core/InstructionSequence.h"
+#include "avida/private/util/MemoryStats.h"
 
 #include <fstream>
 
+#include "cBitArray.h"
 #include "cMerit.h"
 #include "cString.h"
 #include "cCodeLabel.h"
@@ -79,6 +81,18 @@ private:
   cWorld* m_world;
   bool initialized;
 
+  // 0. State touched on every executed instruction, kept together at the front of the object so it shares a cache
+  //    line or two.  Logically these belong with the "in progress" values (2), the life records (4) and the
+  //    status flags (5) below, and are reset along with them.
+  int cpu_cycles_used;   // Total CPU cycles consumed. @JEB
+  int time_used;         // Total CPU cycles consumed, including additional time costs of some instructions.
+  int num_execs;         // Total number of instructions executions attempted...accounts for parallel executions in multi-threaded orgs & corrects for cpu-cost 'pauses'
+  int trial_time_used;                        // like time_used, but reset every trial; @JEB
+  int trial_cpu_cycles_used;                  // like cpu_cycles_used, but reset every trial; @JEB
+  Apto::Array<int> cur_inst_count;                 // Instruction exection counter
+  bool to_die;		 // Has organism has triggered something fatal?
+  bool to_delete;        // Should this organism be deleted when finished?
+
   // 1. These are values calculated at the last divide (of self or offspring)
   cMerit merit;             // Relative speed of CPU
   double executionRatio;    //  ratio of current execution merit over base execution merit
@@ -125,7 +139,6 @@ private:
   Apto::Array<int> first_reaction_execs;            // Execution count at first time reaction was triggered (will be > cycles in parallel exec multithreaded orgs).
   Apto::Array<int> cur_stolen_reaction_count;      // Total counts of reactions stolen by predators.
   Apto::Array<double> cur_reaction_add_reward;     // Bonus change from triggering each reaction.
-  Apto::Array<int> cur_inst_count;                 // Instruction exection counter
   Apto::Array<int> cur_from_sensor_count;           // Use of inputs that originated from sensory data were used in execution of this instruction.
   Apto::Array< Apto::Array<int> > cur_group_attack_count;
   Apto::Array< Apto::Array<int> > cur_top_pred_group_attack_count;
@@ -142,8 +155,6 @@ private:
   Apto::Array<int> cur_trial_times_used;           // Time used in of various trials.; @JEB
   Apto::Array<int> cur_from_message_count;           // Use of inputs that originated from messages were used in execution of this instruction.
 
-  int trial_time_used;                        // like time_used, but reset every trial; @JEB
-  int trial_cpu_cycles_used;                  // like cpu_cycles_used, but reset every trial; @JEB
   tList<int> m_tolerance_immigrants;           // record of previous updates tolerance has been decreased towards immigrants 
   tList<int> m_tolerance_offspring_own;        // record of previous updates tolerance has been decreased towards org's own offspring 
   tList<int> m_tolerance_offspring_others;     // record of previous updates tolerance has been decreased towards other offspring in group 
@@ -157,6 +168,7 @@ private:
   int cur_mating_display_b;                   // value of organism's current mating display B trait
 
   cReactionResult* m_reaction_result;
+  Apto::Array<int>* m_inst_count_total;   // Population total that last_inst_count is summed into, if any (see cPopulation)
   
 
 
@@ -170,6 +182,8 @@ private:
   Apto::Array<int> last_task_count;
   Apto::Array<int> last_para_tasks;
   Apto::Array<int> last_host_tasks;                // Last task counts from hosts only, before last divide @LZ
+  cBitArray last_para_task_bits;                   // Tasks with a nonzero count in last_para_tasks
+  cBitArray last_host_task_bits;                   // Tasks with a nonzero count in last_host_tasks
   Apto::Array<int> last_internal_task_count;
   Apto::Array<double> last_task_quality;
   Apto::Array<double> last_task_value;
@@ -202,9 +216,6 @@ private:
   int num_divides_failed; //Number of failed divide events @LZ
   int num_divides;       // Total successful divides organism has produced.
   int generation;        // Number of birth events to original ancestor.
-  int cpu_cycles_used;   // Total CPU cycles consumed. @JEB
-  int time_used;         // Total CPU cycles consumed, including additional time costs of some instructions.
-  int num_execs;         // Total number of instructions executions attempted...accounts for parallel executions in multi-threaded orgs & corrects for cpu-cost 'pauses'
   int age;               // Number of updates organism has survived for.
   cString fault_desc;    // A description of the most recent error.
   double neutral_metric; // Undergoes drift (gausian 0,1) per generation
@@ -228,8 +239,6 @@ private:
 
   
   // 5. Status Flags...  (updated at each divide)
-  bool to_die;		 // Has organism has triggered something fatal?
-  bool to_delete;        // Should this organism be deleted when finished?
   bool make_random_resource; // Is the resource the organism just produced to be placed randomly?
   bool is_injected;      // Was this organism injected into the population?
   bool is_clone;      // Was this organism created as a clone in the population?
@@ -313,9 +322,11 @@ private:
 
   inline void SetInstSetSize(int inst_set_size);
   inline void SetGroupAttackInstSetSize(int num_group_attack_inst);
+  void refreshTaskBits();
+  inline void countInstTotal(int sign);
   
 public:
-  cPhenotype() : m_world(NULL), m_reaction_result(NULL) { ; } // Will not construct a valid cPhenotype! Only exists to support incorrect cDeme Apto::Array usage.
+  cPhenotype() : m_world(NULL), m_reaction_result(NULL), m_inst_count_total(NULL) { Avida::Util::MemoryStats::Created(Avida::Util::MemoryStats::PHENOTYPES); } // Will not construct a valid cPhenotype! Only exists to support incorrect cDeme Apto::Array usage.
   cPhenotype(cWorld* world, int parent_generation, int num_nops);
 
 
@@ -477,6 +488,8 @@ public:
   void SetLastTaskCount(Apto::Array<int> tasks) { assert(initialized == true); last_task_count = tasks; }
   const Apto::Array<int>& GetLastHostTaskCount() const { assert(initialized == true); return last_host_tasks; }
   const Apto::Array<int>& GetLastParasiteTaskCount() const { assert(initialized == true); return last_para_tasks; }
+  const cBitArray& GetLastHostTaskBits() const { assert(initialized == true); return last_host_task_bits; }
+  const cBitArray& GetLastParasiteTaskBits() const { assert(initialized == true); return last_para_task_bits; }
   void  SetLastParasiteTaskCount(Apto::Array<int>  oldParaPhenotype);
   const Apto::Array<int>& GetLastInternalTaskCount() const { assert(initialized == true); return last_internal_task_count; }
   const Apto::Array<double>& GetLastTaskQuality() const { assert(initialized == true); return last_task_quality; }
@@ -487,6 +500,10 @@ public:
   const Apto::Array<int>& GetLastReactionCount() const { assert(initialized == true); return last_reaction_count; }
   const Apto::Array<double>& GetLastReactionAddReward() const { assert(initialized == true); return last_reaction_add_reward; }
   const Apto::Array<int>& GetLastInstCount() const { assert(initialized == true); return last_inst_count; }
+  
+  // While attached, every change to last_inst_count is applied to total as well
+  void AttachInstCountTotal(Apto::Array<int>* total) { m_inst_count_total = total; countInstTotal(1); }
+  void DetachInstCountTotal() { countInstTotal(-1); m_inst_count_total = NULL; }
   const Apto::Array<int>& GetLastFromSensorInstCount() const { assert(initialized == true); return last_from_sensor_count; }
   const Apto::Array<int>& GetLastSenseCount() const { assert(initialized == true); return last_sense_count; }
   const Apto::Array< Apto::Array<int> >& GetLastGroupAttackInstCount() const { assert(initialized == true); return last_group_attack_count; }
@@ -737,7 +754,7 @@ public:
 
   // @LZ - Parasite Etc. Helpers
   void DivideFailed();
-  void UpdateParasiteTasks() { last_para_tasks = cur_para_tasks; cur_para_tasks.SetAll(0); return; }
+  void UpdateParasiteTasks() { last_para_tasks = cur_para_tasks; cur_para_tasks.SetAll(0); refreshTaskBits(); return; }
   
 
   void RefreshEnergy();
@@ -757,12 +774,22 @@ public:
 };
 
 
+inline void cPhenotype::countInstTotal(int sign)
+{
+  if (!m_inst_count_total) return;
+  Apto::Array<int>& total = *m_inst_count_total;
+  const int size = (last_inst_count.GetSize() < total.GetSize()) ? last_inst_count.GetSize() : total.GetSize();
+  for (int i = 0; i < size; i++) total[i] += sign * last_inst_count[i];
+}
+
 inline void cPhenotype::SetInstSetSize(int inst_set_size)
 {
   cur_inst_count.Resize(inst_set_size, 0);
   cur_from_sensor_count.Resize(inst_set_size, 0);
   cur_from_message_count.Resize(inst_set_size, 0);
+  countInstTotal(-1);
   last_inst_count.Resize(inst_set_size, 0);
+  countInstTotal(1);
   last_from_sensor_count.Resize(inst_set_size, 0);
   last_from_message_count.Resize(inst_set_size, 0);
 }
@@ -22,6 +22,7 @@
 
 #include "cPopulation.h"
 
+#include "avida/core/BinaryArchive.h"
 #include "avida/core/Feedback.h"
 #include "avida/core/InstructionSequence.h"
 #include "avida/core/Properties.h"
@@ -29,6 +30,7 @@
 #include "avida/data/Package.h"
 #include "avida/data/Util.h"
 #include "avida/output/File.h"
+#include "avida/output/Manager.h"
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Group.h"
 #include "avida/systematics/Manager.h"
@@ -36,32 +38,43 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 #include "avida/private/systematics/Genotype.h"
 
+#include "apto/core/FileSystem.h"
 #include "apto/rng.h"
 #include "apto/scheduler.h"
 #include "apto/stat/Accumulator.h"
 
 #include "AvidaTools.h"
 
+#include "cAnalyze.h"
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cCodeLabel.h"
+#include "cDemeParallel.h"
 #include "cDemePlaceholderUnit.h"
+#include "cDemeScheduler.h"
 #include "cEnvironment.h"
+#include "cFenwickScheduler.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
 #include "cMigrationMatrix.h"   
+#include "cNUMAPlacement.h"
 #include "cOrganism.h"
 #include "cParasite.h"
 #include "cPhenotype.h"
 #include "cPopulationCell.h"
+#include "cPopulationTiles.h"
+#include "cResourceUpdatePool.h"
 #include "cResource.h"
 #include "cResourceCount.h"
 #include "cStats.h"
 #include "cTestCPU.h"
 #include "cTopology.h"
+#include "cUpdateProfiler.h"
+#include "cWeightedIndex.h"
 #include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
 
 #include "cHardwareCPU.h"
 
@@ -70,36 +83,50 @@
 #include <algorithm>
 #include <numeric>
 #include <set>
+#include <cstdio>
 #include <cfloat>
 #include <cmath>
 #include <climits>
 #include <limits>
 
+#if !APTO_PLATFORM(WINDOWS)
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
 using namespace std;
 using namespace AvidaTools;
 
 static const PropertyID s_prop_id_instset("instset");
 
+// Maximum number of instructions executed ahead of schedule for a single organism
+static const int SPECULATIVE_DEPTH = 32;
+
+// The genome of a genotype group, read directly instead of round tripping through its "genome" string property
+static inline const Genome& genotypeGenome(Systematics::GroupPtr bg)
+{
+  Systematics::GenotypePtr genotype;
+  genotype.DynamicCastFrom(bg);
+  assert(genotype);
+  return genotype->GroupGenome();
+}
+
 
 cPopulationOrgStatProvider::~cPopulationOrgStatProvider() { ; }
 
 
-class InstructionExecCountsProvider : public cPopulationOrgStatProvider
+// Reads the running totals cPopulation keeps once activated, rather than summing every organism at each update
+class InstructionExecCountsProvider : public Data::ArgumentedProvider
 {
 private:
   cWorld* m_world;
-  Apto::Map<Apto::String, Apto::Array<Apto::Stat::Accumulator<int> >, Apto::DefaultHashBTree, Apto::ImplicitDefault> m_is_exe_inst_map;
   Data::DataSetPtr m_provides;
 
 public:
   InstructionExecCountsProvider(cWorld* world) : m_world(world), m_provides(new Data::DataSet)
   {
     m_provides->Insert(Apto::String("core.population.inst_exec_counts[]"));
-
-    cHardwareManager& hwm = m_world->GetHardwareManager();
-    for (int i = 0; i < hwm.GetNumInstSets(); i++) {
-      m_is_exe_inst_map[Apto::String((const char*)hwm.GetInstSet(i).GetInstSetName())].Resize(hwm.GetInstSet(i).GetSize());
-    }
   }
   
   Data::ConstDataSetPtr Provides() const { return m_provides; }
@@ -137,38 +164,20 @@ public:
   {
     Apto::SmartPtr<Data::ArrayPackage, Apto::InternalRCObject> pkg(new Data::ArrayPackage);
     
-    const Apto::Array<Apto::Stat::Accumulator<int> >& inst_exe_counts = m_is_exe_inst_map[arg];
+    Apto::Array<int> inst_exe_counts;
+    m_world->GetPopulation().GetInstCountTotals(m_world->GetHardwareManager().GetInstSetID(arg), inst_exe_counts);
     for (int i = 0; i < inst_exe_counts.GetSize(); i++) {
-      pkg->AddComponent(Data::PackagePtr(new Data::Wrap<int>(inst_exe_counts[i].Sum())));
+      pkg->AddComponent(Data::PackagePtr(new Data::Wrap<int>(inst_exe_counts[i])));
     }
     
     return pkg;
   }
   
-  
-  void UpdateReset()
-  {
-    for (Apto::Map<Apto::String, Apto::Array<Apto::Stat::Accumulator<int> > >::ValueIterator it = m_is_exe_inst_map.Values(); it.Next();) {
-      Apto::Array<Apto::Stat::Accumulator<int> >& inst_counts = (*it.Get());
-      for (int i = 0; i < inst_counts.GetSize(); i++) inst_counts[i].Clear();
-    }
-  }
-  
-  void HandleOrganism(cOrganism* organism)
-  {
-    Apto::String inst_set = organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue();
-    Apto::Array<Apto::Stat::Accumulator<int> >& inst_exe_counts = m_is_exe_inst_map[inst_set];
-    for (int j = 0; j < organism->GetPhenotype().GetLastInstCount().GetSize(); j++) {
-      inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-    }
-  }
-  
   static Data::ArgumentedProviderPtr Activate(cWorld* world, World* new_world)
   {
     (void)new_world;
-    cPopulationOrgStatProviderPtr osp(new InstructionExecCountsProvider(world));
-    world->GetPopulation().AttachOrgStatProvider(osp);
-    return osp;
+    world->GetPopulation().EnableInstCountTotals();
+    return Data::ArgumentedProviderPtr(new InstructionExecCountsProvider(world));
   }
 };
 
@@ -265,6 +274,13 @@ public:
 cPopulation::cPopulation(cWorld* world)  
 : m_world(world)
 , m_scheduler(NULL)
+, m_prob_scheduler(NULL)
+, m_tiles(NULL)
+, m_deme_parallel(NULL)
+, m_res_pool(NULL)
+, m_schedule_batch(1)
+, m_schedule_defer(0)
+, m_age_clock(0)
 , birth_chamber(world)
 , print_mini_trace_genomes(false)
 , use_micro_traces(false)
@@ -275,6 +291,7 @@ cPopulation::cPopulation(cWorld* world)
 , num_prey_organisms(0)
 , num_pred_organisms(0)
 , num_top_pred_organisms(0)
+, m_step_time(0.0)
 , sync_events(false)
 , m_hgt_resid(-1)
 {
@@ -316,7 +333,11 @@ void cPopulation::ClearCellGrid()
 {
   delete sleep_log; sleep_log = NULL;
   reaper_queue.Clear();
-  delete m_scheduler; m_scheduler = NULL;
+  delete m_scheduler; m_scheduler = NULL; m_prob_scheduler = NULL;
+  delete m_tiles; m_tiles = NULL;
+  delete m_deme_parallel; m_deme_parallel = NULL;
+  resource_count.SetUpdatePool(NULL);
+  delete m_res_pool; m_res_pool = NULL;
 }
 
 
@@ -341,8 +362,10 @@ void cPopulation::SetupCellGrid()
   
   // Setup the cells.  Do things that are not dependent upon topology here.
   bool fill_reaper_queue = (m_world->GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_FULL_SOUP_ELDEST);
+  m_connections.Setup(&cell_array[0], num_cells);
   for (int i = 0; i < num_cells; i++) {
     cell_array[i].Setup(m_world, i, environment.GetMutRates(), i % world_x, i / world_x);    
+    cell_array[i].m_connections = &m_connections;
     if (fill_reaper_queue) reaper_queue.Push(&(cell_array[i]));
   }
   
@@ -351,6 +374,11 @@ void cPopulation::SetupCellGrid()
   const int deme_size_y = world_y / num_demes;
   const int deme_size = deme_size_x * deme_size_y;
   deme_array.ResizeClear(num_demes);
+  m_empty_cells.Setup(num_cells, deme_size);
+  m_age_order.Setup(num_cells);
+  m_forager_index.Setup(world_x, world_y);
+  m_occupancy.Setup(num_cells);
+  if (m_world->GetConfig().PRED_CONFUSION.Get()) m_neighbor_prey.Setup(&m_connections, num_cells);
   
   // Broken setting:
   assert(m_world->GetConfig().DEMES_REPLICATE_SIZE.Get() <= deme_size);
@@ -364,12 +392,14 @@ void cPopulation::SetupCellGrid()
       cell_array[cell_id].SetDemeID(deme_id);
     }
     deme_array[deme_id].Setup(deme_id, deme_cells, deme_size_x, m_world);
+    deme_array[deme_id].SetStepTimeSource(&m_step_time);
   }
   
   // Setup the topology.
   // What we're doing here is chopping the cell_array up into num_demes pieces.
   // Note that having 0 demes (one population) is the same as having 1 deme.  Then
   // we send the cells that comprise each deme into the topology builder.
+  Apto::Array<int, Apto::Smart> edges;
   for (int i = 0; i < num_cells; i += deme_size) {
     // We're cheating here; we're using the random access nature of an iterator to index beyond the end of the cell_array.
     switch(geometry) {
@@ -389,17 +419,19 @@ void cPopulation::SetupCellGrid()
         build_lattice(cell_array.Range(i, i + deme_size - 1), deme_size_x, deme_size_y, 1);
         break;
       case nGeometry::RANDOM_CONNECTED:
-        build_random_connected_network(cell_array.Range(i, i + deme_size - 1), deme_size_x, deme_size_y, m_world->GetRandom());
+        build_random_connected_network(deme_size, m_world->GetRandom(), edges);
+        m_connections.AddEdges(i, deme_size, edges);
         break;
       case nGeometry::SCALE_FREE:
-        build_scale_free(cell_array.Range(i, i + deme_size - 1), m_world->GetConfig().SCALE_FREE_M.Get(),
-                         m_world->GetConfig().SCALE_FREE_ALPHA.Get(), m_world->GetConfig().SCALE_FREE_ZERO_APPEAL.Get(),
-                         m_world->GetRandom());
+        build_scale_free(deme_size, m_world->GetConfig().SCALE_FREE_M.Get(), m_world->GetConfig().SCALE_FREE_ALPHA.Get(),
+                         m_world->GetConfig().SCALE_FREE_ZERO_APPEAL.Get(), m_world->GetRandom(), edges);
+        m_connections.AddEdges(i, deme_size, edges);
         break;
       default:
         assert(false);
     }
   }
+  m_connections.Compact();
   
   BuildTimeSlicer();
   
@@ -414,6 +446,7 @@ void cPopulation::SetupCellGrid()
   
   cResourceCount tmp_res_count(resource_lib.GetSize() - num_deme_res);
   resource_count = tmp_res_count;
+  resource_count.SetStepTimeSource(&m_step_time);
   resource_count.ResizeSpatialGrids(world_x, world_y);
   
   for(int i = 0; i < GetNumDemes(); i++) {
@@ -466,6 +499,7 @@ void cPopulation::SetupCellGrid()
                            res->GetMinSize(), res->GetMaxSize(), res->GetConfig(), res->GetCount(), res->GetResistance(), res->GetDamage(),
                            res->GetDeathOdds(), res->IsPath(), res->IsHammer(), res->GetInitialPlatVal(), res->GetThreshold(), res->GetRefuge(), res->GetGradient()
                            ); 
+      resource_count.SetSpatialInterval(global_res_index, res->GetSpatialInterval(), res->GetFlowTolerance());
       m_world->GetStats().SetResourceName(global_res_index, res->GetName());
     } else if (res->GetDemeResource()) {
       deme_res_index++;
@@ -483,6 +517,11 @@ void cPopulation::SetupCellGrid()
   if (m_world->GetConfig().ENABLE_HGT.Get() && (m_hgt_resid == -1)) {
     m_world->GetDriver().Feedback().Warning("HGT is enabled, but no HGT resource is defined; add hgt=1 to a single resource in the environment file.");
   }
+  
+  BuildDemeParallel();
+  BuildTiles();
+  BuildResourcePool();
+  BuildMoveResources();
 }
 
 
@@ -602,8 +641,13 @@ bool cPopulation::IsValidArgument(const Data::DataID& data_id, Data::Argument ar
 
 cPopulation::~cPopulation()
 {
+  ReapPopulationWriters(true);
+  
   for (int i = 0; i < cell_array.GetSize(); i++) delete cell_array[i].GetOrganism(); 
   delete m_scheduler;
+  delete m_tiles;
+  delete m_deme_parallel;
+  delete m_res_pool;
 }
 
 
@@ -611,7 +655,53 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
 {
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
-  m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  m_occupancy.SetMerit(cell.GetID(), merit.GetDouble());
+  
+  // Many paths reschedule a cell whose merit has not changed; the scheduler only needs to hear about real changes
+  const double priority = deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble();
+  const bool redundant = (m_cell_priority[cell.GetID()] == priority);
+  m_world->GetStats().AddScheduleAdjustment(redundant);
+  if (redundant) return;
+  m_cell_priority[cell.GetID()] = priority;
+  
+  // While demes are being replaced, only the final priority of each cell is handed on
+  if (m_schedule_defer) {
+    if (!m_schedule_is_deferred[cell.GetID()]) {
+      m_schedule_is_deferred[cell.GetID()] = true;
+      m_schedule_deferred.Push(cell.GetID());
+    }
+    return;
+  }
+  
+  m_scheduler->AdjustPriority(cell.GetID(), priority);
+  if (m_deme_parallel) m_deme_parallel->AdjustPriority(deme_id, cell.GetID(), priority);
+}
+
+
+void cPopulation::DeferScheduleAdjustments()
+{
+  m_schedule_defer++;
+}
+
+void cPopulation::FlushScheduleAdjustments()
+{
+  assert(m_schedule_defer > 0);
+  if (--m_schedule_defer > 0) return;
+  
+  for (int i = 0; i < m_schedule_deferred.GetSize(); i++) {
+    const int cell_id = m_schedule_deferred[i];
+    m_schedule_is_deferred[cell_id] = false;
+    m_scheduler->AdjustPriority(cell_id, m_cell_priority[cell_id]);
+    if (m_deme_parallel) m_deme_parallel->AdjustPriority(cell_array[cell_id].GetDemeID(), cell_id, m_cell_priority[cell_id]);
+  }
+  m_schedule_deferred.Resize(0);
+}
+
+
+inline cPopulation::sGroup* cPopulation::findGroup(int group_id)
+{
+  std::map<int, int>::iterator it = m_group_slots.find(group_id);
+  return (it == m_group_slots.end()) ? NULL : &m_group_array[it->second];
 }
 
 
@@ -629,21 +719,21 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
   // If divide method is split, parent will be reset to completely tolerant
   // must remove their intolerance from the group's cached total.
   if (m_world->GetConfig().DIVIDE_METHOD.Get() == DIVIDE_METHOD_SPLIT) {
-    if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
+    sGroup* group = findGroup(parent_organism->GetOpinion().first);
+    if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0 && group) {
       int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-      int group_id = parent_organism->GetOpinion().first;
       int org_imm_tolerance = parent_organism->GetPhenotype().CalcToleranceImmigrants();
-      m_group_intolerances[group_id][0].second -= tol_max - org_imm_tolerance; 
+      group->intolerances[0][0].second -= tol_max - org_imm_tolerance; 
       if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
         if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-          m_group_intolerances_females[group_id][0].second -= tol_max - org_imm_tolerance;
+          group->intolerances[1][0].second -= tol_max - org_imm_tolerance;
         } else if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-          m_group_intolerances_males[group_id][0].second -= tol_max - org_imm_tolerance;
+          group->intolerances[2][0].second -= tol_max - org_imm_tolerance;
         } else if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
-          m_group_intolerances_juvs[group_id][0].second -= tol_max - org_imm_tolerance;
+          group->intolerances[3][0].second -= tol_max - org_imm_tolerance;
         }
       }
-      m_group_intolerances[group_id][1].second -= tol_max - parent_organism->GetPhenotype().CalcToleranceOffspringOthers();
+      group->intolerances[0][1].second -= tol_max - parent_organism->GetPhenotype().CalcToleranceOffspringOthers();
     }
   }
   
@@ -654,7 +744,11 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
   cPhenotype& parent_phenotype = parent_organism->GetPhenotype();
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(parent_organism->GetGenome().Representation());
+  cDeme* parent_deme = (deme_array.GetSize() > 0) ? &GetDeme(GetCell(parent_organism->GetOrgInterface().GetCellID()).GetDemeID()) : NULL;
+  if (parent_deme) parent_deme->RemoveOrgTotals(parent_phenotype);
   parent_phenotype.DivideReset(*seq);
+  if (parent_deme) parent_deme->AddOrgTotals(parent_phenotype);
+  m_age_order.Insert(parent_organism->GetOrgInterface().GetCellID(), AgeStamp(parent_organism));
   
   GeneticRepresentationPtr tmpHostGenome;
   
@@ -784,7 +878,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
       if(ctx.GetRandom().P(m_world->GetConfig().FULL_VERTICAL_TRANS.Get()))
       {
         
-        Apto::Array<Systematics::UnitPtr> parasites_to_inject = parent_organism->GetParasites();
+        const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites_to_inject = parent_organism->GetParasites();
         cOrganism* target_organism = offspring_array[i];
         // target_organism-> target_organism->GetHardware().GetCurThread()
         for (int p=0; p<parasites_to_inject.GetSize(); ++p)
@@ -830,6 +924,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
         
           if (target_organism->ParasiteInfectHost(parasite)) {
             Systematics::Manager::Of(m_world->GetNewWorld())->ClassifyNewUnit(parasite);
+            if (!m_deme_parallel && !m_tiles) parasite->ShareGenotypeGenome();
           }
         }
       } //else cout << "vert trans failed!" << endl;
@@ -1030,8 +1125,27 @@ bool cPopulation::TestForParasiteInteraction(cOrganism* infected_host, cOrganism
   
   cPhenotype& parent_phenotype = infected_host->GetPhenotype();
   
-  Apto::Array<int> host_task_counts = target_host->GetPhenotype().GetLastHostTaskCount();
-  Apto::Array<int> parasite_task_counts = parent_phenotype.GetLastParasiteTaskCount();
+  const cBitArray& host_tasks = target_host->GetPhenotype().GetLastHostTaskBits();
+  const cBitArray& parasite_tasks = parent_phenotype.GetLastParasiteTaskBits();
+  
+  // Every mechanism only depends on how many tasks the host and the parasite perform alone and together
+  //handle skipping of first task
+  int start = 0;
+  if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
+    start += 1;
+  }
+  int num_host = host_tasks.CountBits2();
+  int num_parasite = parasite_tasks.CountBits2();
+  int num_both = host_tasks.CountAND(parasite_tasks);
+  if (start && host_tasks.GetSize() > 0) {
+    const bool host_first = host_tasks.Get(0);
+    const bool parasite_first = parasite_tasks.Get(0);
+    num_host -= host_first;
+    num_parasite -= parasite_first;
+    num_both -= (host_first && parasite_first);
+  }
+  const int num_host_only = num_host - num_both;
+  const int num_parasite_only = num_parasite - num_both;
   
   
   if (infection_mechanism == 0) {
@@ -1040,105 +1154,40 @@ bool cPopulation::TestForParasiteInteraction(cOrganism* infected_host, cOrganism
   
   // 1: Parasite must match at least 1 task the host does (Overlap)
   if (infection_mechanism == 1) {
-    //handle skipping of first task
-    int start = 0;
-    if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-      start += 1;
-    }
-    
-    //find if there is a matching task
-    for (int i = start; i < host_task_counts.GetSize(); i++) {
-      if (host_task_counts[i] > 0 && parasite_task_counts[i] > 0) {
-        //inject should succeed if there is a matching task
-        interaction_fails = false;
-      }
-    }
+    //inject should succeed if there is a matching task
+    if (num_both > 0) interaction_fails = false;
   }
   
   // 2: Parasite must perform at least one task the host does not (Inverse Overlap)
   if (infection_mechanism == 2) {
-    //handle skipping of first task
-    int start = 0;
-    if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-      start += 1;
-    }
-    
-    //find if there is a parasite task that the host isn't doing
-    for (int i = start; i < host_task_counts.GetSize(); i++) {
-      if (host_task_counts[i] == 0 && parasite_task_counts[i] > 0) {
-        //inject should succeed if there is a matching task
-        interaction_fails = false;
-      }
-    }
+    //inject should succeed if there is a parasite task that the host isn't doing
+    if (num_parasite_only > 0) interaction_fails = false;
   }
   
   // 3: Parasite tasks must match host tasks exactly. (Matching Alleles) 
   if (infection_mechanism == 3) {
-    //handle skipping of first task
-    int start = 0;
-    if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-      start += 1;
-    }
-    
-    //This time if we trigger the if statments we DO fail. 
-    interaction_fails = false;
-    for (int i = start; i < host_task_counts.GetSize(); i++) {
-      if ((host_task_counts[i] == 0 && parasite_task_counts[i] > 0) || 
-          (host_task_counts[i] > 0 && parasite_task_counts[i] == 0)) {
-        //inject should fail if either the host or parasite is doing a task the other isn't.
-        interaction_fails = true;
-      }
-    }
+    //inject should fail if either the host or parasite is doing a task the other isn't.
+    interaction_fails = (num_host_only > 0 || num_parasite_only > 0);
   }
   
   // 4: Parasite tasks must overcome hosts. (GFG) 
   if (infection_mechanism == 4) {
-    //handle skipping of first task
-    int start = 0;
-    if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-      start += 1;
-    }
-    
-    //This time if we trigger the if statments we DO fail. 
-    interaction_fails = false;
-    bool parasite_overcomes = false;
-    for (int i = start; i < host_task_counts.GetSize(); i++) {
-      if (host_task_counts[i] > 0 && parasite_task_counts[i] == 0 ) {
-        //inject should fail if the host overcomes the parasite.
-        interaction_fails = true;
-      }
-      
-      //check if parasite overcomes at least one task
-      if (parasite_task_counts[i] > 0 && host_task_counts[i] == 0) {
-        parasite_overcomes = true;
-      }
-    }
+    //inject should fail if the host overcomes the parasite.
+    interaction_fails = (num_host_only > 0);
     
-    //if host doesn't overcome, infection may still fail if the parasite doesn't overcome the host
-    if (interaction_fails == false && parasite_overcomes == false) {
+    //if host doesn't overcome, infection may still fail if the parasite doesn't overcome at least one host task
+    if (interaction_fails == false && num_parasite_only == 0) {
       interaction_fails = true;
     }
   }
   
   // 5: Quantitative Matching Allele -- probability of infection based on phenotype overlap
   if (infection_mechanism == 5) {
-    //handle skipping of first task
-    int start = 0;
-    if(m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-      start += 1;
-    }
-    
     //calculate how many tasks have the same binary phenotype (i.e. how much overlap)
-    int num_overlap = 0;
-    for (int i = start; i < host_task_counts.GetSize(); i++) {
-      if ((host_task_counts[i] > 0 && parasite_task_counts[i] > 0) ||
-          (host_task_counts[i] == 0 && parasite_task_counts[i] == 0)) {
-        num_overlap += 1;
-      }
-    }
+    int num_overlap = (host_tasks.GetSize() - start) - num_host_only - num_parasite_only;
     
     //turn number into proportion of available tasks that match
-    double prop_overlap = double(num_overlap) / (host_task_counts.GetSize() - start);
+    double prop_overlap = double(num_overlap) / (host_tasks.GetSize() - start);
     
     //use config exponent and calculate probability of infection
     double infection_exponent = m_world->GetConfig().INJECT_QMA_EXPONENT.Get();
@@ -1150,19 +1199,7 @@ bool cPopulation::TestForParasiteInteraction(cOrganism* infected_host, cOrganism
   }
   // 6: Parasite must perform at least one task (no specificity, but requires tasks performed).
   if (infection_mechanism == 6) {
-      //handle skipping of first task
-      int start = 0;
-      if (m_world->GetConfig().INJECT_SKIP_FIRST_TASK.Get()) {
-          start += 1;
-      }
-    
-      //find if there is a parasite task that the host isn't doing
-      for (int i = start; i < host_task_counts.GetSize(); i++) {
-          if (parasite_task_counts[i] > 0) {
-              //inject should succeed if there is a matching task
-              interaction_fails = false;
-          }
-      }
+    if (num_parasite > 0) interaction_fails = false;
   }
   
   // TODO: Add other infection mechanisms -LZ
@@ -1246,11 +1283,15 @@ bool cPopulation::ActivateParasite(cOrganism* host, Systematics::UnitPtr parent,
   // LZ - use parasige_genotype_list for the GenRepPtr instead IF Config says to
   // e.g., use predefined genotypes to hold the frequency constant, or "replay" parasite
   // from one run into another.
+  // The parasite adopts this representation, so predefined genotypes are shared rather than cloned per infection
+  // (cloned in parallel runs, where reference counts may not be touched from worker threads)
   GeneticRepresentationPtr tmpParasiteGenome;
+  const bool share_genomes = !m_deme_parallel && !m_tiles;
   
   if (m_world->GetConfig().PARASITE_USE_GENOTYPE_FILE.Get())
   {
     tmpParasiteGenome = parasite_genotype_list[m_world->GetRandom().GetInt(parasite_genotype_list.GetSize())];
+    if (!share_genomes) tmpParasiteGenome = tmpParasiteGenome->Clone();
   }
   else
   {
@@ -1301,6 +1342,7 @@ bool cPopulation::ActivateParasite(cOrganism* host, Systematics::UnitPtr parent,
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups(1));
   (*pgrps)[0] = parent->SystematicsGroupMembership();
   parasite->SelfClassify(pgrps);
+  if (share_genomes) parasite->ShareGenotypeGenome();
   
   // Handle post injection actions
   if (m_world->GetConfig().INJECT_STERILIZES_HOST.Get()) target_organism->GetPhenotype().Sterilize();
@@ -1312,12 +1354,20 @@ bool cPopulation::ActivateOrganism(cAvidaContext& ctx, cOrganism* in_organism, c
 {
   assert(in_organism != NULL);
   
+  // Worker threads take references to their organisms' genomes concurrently, so sharing is for serial runs only
+  if (!m_deme_parallel && !m_tiles) in_organism->ShareGenotypeGenome();
   in_organism->SetOrgInterface(ctx, new cPopulationInterface(m_world));
   
   // Update the contents of the target cell.
   KillOrganism(target_cell, ctx); 
   target_cell.InsertOrganism(in_organism, ctx); 
   AddLiveOrg(in_organism); 
+  m_empty_cells.Remove(target_cell.GetID());
+  m_age_order.Insert(target_cell.GetID(), AgeStamp(in_organism));
+  m_forager_index.Insert(target_cell.GetID(), in_organism->IsPredFT());
+  m_neighbor_prey.SetPrey(target_cell.GetID(), in_organism->IsPreyFT());
+  m_occupancy.Insert(target_cell.GetID(), in_organism);
+  if (m_inst_count_totals.GetSize()) attachInstCountTotal(in_organism, target_cell.GetDemeID());
   
   // Setup the inputs in the target cell.
   environment.SetupInputs(ctx, target_cell.m_inputs);
@@ -1369,6 +1419,7 @@ bool cPopulation::ActivateOrganism(cAvidaContext& ctx, cOrganism* in_organism, c
   }
   if (deme_array.GetSize() > 0) {
     deme_array[target_cell.GetDemeID()].IncOrgCount();
+    deme_array[target_cell.GetDemeID()].AddOrgTotals(in_organism->GetPhenotype());
   }
   
   // Statistics...
@@ -1522,7 +1573,7 @@ void cPopulation::PrintMiniTraceGenome(cOrganism* in_organism, cString& filename
   cAvidaContext ctx2(&m_world->GetDriver(), rng);
   
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx2);
-  testcpu->PrintGenome(ctx2, Genome(in_organism->SystematicsGroup("genotype")->Properties().Get("genome")), filename, m_world->GetStats().GetUpdate());
+  testcpu->PrintGenome(ctx2, Genome(in_organism->SystematicsGroup("genotype")->StringProperty(Systematics::GROUP_PROP_GENOME)), filename, m_world->GetStats().GetUpdate());
   delete testcpu;
 }
 
@@ -1763,10 +1814,10 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
     if (bg_id_list.GetSize() < max_bgs && (!doms_done || !fts_done || !grps_done)) {
       if (i == 0 && save_dominants && num_doms > 0) {
         for (int j = 0; j < num_doms; j++) {
-          if (bg && ((bool)Apto::StrAs(bg->Properties().Get("threshold")) || bg_id_list.GetSize() == 0)) {
+          if (bg && ((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD) || bg_id_list.GetSize() == 0)) {
             bg_id_list.Push(bg->ID());
             if (save_foragers) {
-              int ft = Apto::StrAs(bg->Properties().Get("last_forager_type")); 
+              int ft = bg->IntProperty(Systematics::GROUP_PROP_LAST_FORAGER_TYPE); 
               if (fts_left > 0) {
                 for (int k = 0; k < fts_to_use.GetSize(); k++) {
                   if (ft == fts_to_use[k]) {
@@ -1785,7 +1836,7 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
               }
             }
             if (save_groups) {
-              int grp = bg->Properties().Get("last_group_id"); 
+              int grp = bg->IntProperty(Systematics::GROUP_PROP_LAST_GROUP_ID); 
               if (groups_left > 0) {
                 for (int k = 0; k < groups_to_use.GetSize(); k++) {
                   if (grp == groups_to_use[k]) {
@@ -1809,7 +1860,7 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
             }
             else bg = it->Next();
           }
-          else if (bg && !((bool)Apto::StrAs(bg->Properties().Get("threshold")))) {      // no more above threshold
+          else if (bg && !((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD))) {      // no more above threshold
             doms_done = true; 
             break; 
           }
@@ -1819,8 +1870,8 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
       
       else if (i == 1 && save_foragers && fts_left > 0) {
         for (int j = 0; j < fts_left; j++) {
-          if (bg && ((bool)Apto::StrAs(bg->Properties().Get("threshold")) || bg_id_list.GetSize() == 0)) {
-            int ft = bg->Properties().Get("last_forager_type"); 
+          if (bg && ((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD) || bg_id_list.GetSize() == 0)) {
+            int ft = bg->IntProperty(Systematics::GROUP_PROP_LAST_FORAGER_TYPE); 
             bool found_one = false;
             for (int k = 0; k < fts_to_use.GetSize(); k++) {
               if (ft == fts_to_use[k]) {
@@ -1838,7 +1889,7 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
               }
             }
             if (save_groups) {
-              int grp = bg->Properties().Get("last_group_id"); 
+              int grp = bg->IntProperty(Systematics::GROUP_PROP_LAST_GROUP_ID); 
               if (groups_left > 0) {
                 for (int k = 0; k < groups_to_use.GetSize(); k++) {
                   if (grp == groups_to_use[k]) {
@@ -1863,7 +1914,7 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
             else bg = it->Next();
             if (!found_one) j--;
           }
-          else if (bg && !((bool)Apto::StrAs(bg->Properties().Get("threshold")))) {  // no more above threshold
+          else if (bg && !((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD))) {  // no more above threshold
             fts_done = true; 
             break; 
           }
@@ -1873,8 +1924,8 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
       
       else if (i == 2 && save_groups && groups_left > 0) {
         for (int j = 0; j < groups_left; j++) {
-          if (bg && ((bool)Apto::StrAs(bg->Properties().Get("threshold")) || bg_id_list.GetSize() == 0)) {
-            int grp = bg->Properties().Get("last_group_id"); 
+          if (bg && ((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD) || bg_id_list.GetSize() == 0)) {
+            int grp = bg->IntProperty(Systematics::GROUP_PROP_LAST_GROUP_ID); 
             bool found_one = false;
             for (int k = 0; k < groups_to_use.GetSize(); k++) {
               if (grp == groups_to_use[k]) {
@@ -1898,7 +1949,7 @@ Apto::Array<int, Apto::Smart> cPopulation::SetTraceQ(int save_dominants, int sav
             else bg = it->Next();
             if (!found_one) j--;
           }
-          else if (bg && !((bool)Apto::StrAs(bg->Properties().Get("threshold")))) {  // no more above threshold
+          else if (bg && !((bool)bg->IntProperty(Systematics::GROUP_PROP_THRESHOLD))) {  // no more above threshold
             grps_done = true; 
             break; 
           }
@@ -1914,15 +1965,21 @@ Apto::Array<int> cPopulation::GetFormedGroupArray()
 {
   Apto::Array<int> group_ids;
   group_ids.Resize(0);
-  map<int,int> groups_formed = m_world->GetPopulation().GetFormedGroups();
-  map <int,int>::iterator itr;    
-  for(itr = groups_formed.begin();itr!=groups_formed.end();itr++) {
-    double cur_size = itr->second;
-    if (cur_size > 0) group_ids.Push(itr->first);
+  for (std::map<int, int>::iterator itr = m_group_slots.begin(); itr != m_group_slots.end(); itr++) {
+    if (m_group_array[itr->second].num_orgs > 0) group_ids.Push(itr->first);
   }
   return group_ids;
 }
 
+map<int, int> cPopulation::GetFormedGroups()
+{
+  map<int, int> groups;
+  for (std::map<int, int>::iterator itr = m_group_slots.begin(); itr != m_group_slots.end(); itr++) {
+    groups[itr->first] = m_group_array[itr->second].num_orgs;
+  }
+  return groups;
+}
+
 void cPopulation::SetTopNavQ()
 {
   topnav_q.Resize(live_org_list.GetSize());
@@ -1965,17 +2022,21 @@ bool cPopulation::MoveOrganisms(cAvidaContext& ctx, int src_cell_id, int dest_ce
   
   // get the resource library
   const cResourceLib& resource_lib = environment.GetResourceLib();
+  const sMoveResources& move_res = m_move_res;
   
   bool has_path = false;
   bool has_hammer = false;
-  for (int i = 0; i < resource_lib.GetSize(); i++) {
-    if (environment.HasPath() && resource_lib.GetResource(i)->IsPath() && GetCellResVal(ctx, dest_cell_id, i) > 0) has_path = true;
-    if (environment.HasHammer() && resource_lib.GetResource(i)->IsHammer() && GetCellResVal(ctx, dest_cell_id, i) > 0) has_hammer = true;
+  for (int k = 0; k < move_res.path.GetSize() && !has_path; k++) {
+    if (GetCellResVal(ctx, dest_cell_id, move_res.path[k]) > 0) has_path = true;
+  }
+  for (int k = 0; k < move_res.hammer.GetSize() && !has_hammer; k++) {
+    if (GetCellResVal(ctx, dest_cell_id, move_res.hammer[k]) > 0) has_hammer = true;
   }
   
   if (!has_path || has_hammer) {
     // test for death by predatory resource or injury ... not mutually exclusive
-    for (int i = 0; i < resource_lib.GetSize(); i++) {
+    for (int k = 0; k < move_res.hazard.GetSize(); k++) {
+      const int i = move_res.hazard[k];
       if (resource_lib.GetResource(i)->IsPredatory() || resource_lib.GetResource(i)->IsDeadly()) {
         // get the destination cell resource levels
         double dest_cell_resources = GetCellResVal(ctx, dest_cell_id, i);
@@ -1999,8 +2060,9 @@ bool cPopulation::MoveOrganisms(cAvidaContext& ctx, int src_cell_id, int dest_ce
     // if any of the resources have resistance, find the id of the most resistant resource
     int steepest_hill = 0;
     double curr_resistance = 1.0;
-    for (int i = 0; i < resource_lib.GetSize(); i++) {
-      if (!resource_lib.GetResource(i)->IsPath() && resource_lib.GetResource(i)->GetResistance() > curr_resistance) {
+    for (int k = 0; k < move_res.resistant.GetSize(); k++) {
+      const int i = move_res.resistant[k];
+      if (resource_lib.GetResource(i)->GetResistance() > curr_resistance) {
         if (GetCellResVal(ctx, src_cell_id, i) != 0) {
           curr_resistance = resource_lib.GetResource(i)->GetResistance();
           steepest_hill = i;
@@ -2008,7 +2070,7 @@ bool cPopulation::MoveOrganisms(cAvidaContext& ctx, int src_cell_id, int dest_ce
       }
     }
     // apply the chance of move failing for the most resistant resource in this cell, if there is one
-    if (resource_lib.GetSize() && curr_resistance != 1) {
+    if (curr_resistance != 1) {
       if (GetCellResVal(ctx, src_cell_id, steepest_hill) > 0) {
         // we use resistance to determine chance of movement succeeding: 'resistance == # move instructions executed, on average, to move one step/cell'
         double chance_move_success = 1.0/curr_resistance;
@@ -2019,21 +2081,17 @@ bool cPopulation::MoveOrganisms(cAvidaContext& ctx, int src_cell_id, int dest_ce
     // movement fails if there are any barrier resources in the faced cell (unless the org is already on a barrier,
     // which would happen if we built a new barrier under an org and we need to let it get off)
     bool curr_is_barrier = false;
-    for (int i = 0; i < resource_lib.GetSize(); i++) {
+    for (int k = 0; k < move_res.barrier.GetSize(); k++) {
       // get the current cell resource levels
-      if (resource_lib.GetResource(i)->GetHabitat() == 2 && !resource_lib.GetResource(i)->IsPath()) {
-        if (GetCellResVal(ctx, src_cell_id, i) > 0) {
-          curr_is_barrier = true;
-          break;
-        }
+      if (GetCellResVal(ctx, src_cell_id, move_res.barrier[k]) > 0) {
+        curr_is_barrier = true;
+        break;
       }
     }
     if (!curr_is_barrier) {
-      for (int i = 0; i < resource_lib.GetSize(); i++) {
-        if (!resource_lib.GetResource(i)->IsPath() && resource_lib.GetResource(i)->GetHabitat() == 2 && resource_lib.GetResource(i)->GetResistance() != 0) {
-          // fail if faced cell has this wall resource
-          if (GetCellResVal(ctx, dest_cell_id, i) > 0) return false;
-        }
+      for (int k = 0; k < move_res.wall.GetSize(); k++) {
+        // fail if faced cell has this wall resource
+        if (GetCellResVal(ctx, dest_cell_id, move_res.wall[k]) > 0) return false;
       }
     }
   }
@@ -2127,16 +2185,17 @@ bool cPopulation::MoveOrganisms(cAvidaContext& ctx, int src_cell_id, int dest_ce
 void cPopulation::KillGroupMember(cAvidaContext& ctx, int group_id, cOrganism *org)
 {
   //Check to make sure we are not killing self!
-  if (m_group_list[group_id].GetSize() == 1 && m_group_list[group_id][0] == org) return;
-  if (m_group_list[group_id].GetSize() == 0) return;
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  if (members.GetSize() == 1 && members[0] == org) return;
+  if (members.GetSize() == 0) return;
   int index;
   while(true) {
-    index = ctx.GetRandom().GetUInt(0, m_group_list[group_id].GetSize());
-    if (m_group_list[group_id][index] == org) continue;
+    index = ctx.GetRandom().GetUInt(0, members.GetSize());
+    if (members[index] == org) continue;
     else break;
   }
   
-  int cell_id = m_group_list[group_id][index]->GetCellID();
+  int cell_id = members[index]->GetCellID();
   KillOrganism(cell_array[cell_id], ctx); 
 }
 
@@ -2228,6 +2287,7 @@ void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
 
   const int ft = organism->GetForageTarget();
 
+  organism->GetPhenotype().DetachInstCountTotal();
   RemoveLiveOrg(organism);
   UpdateQs(organism, false);
   
@@ -2257,6 +2317,7 @@ void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
   // Handle deme updates.
   if (deme_array.GetSize() > 0) {
     deme_array[in_cell.GetDemeID()].DecOrgCount();
+    deme_array[in_cell.GetDemeID()].RemoveOrgTotals(organism->GetPhenotype());
     deme_array[in_cell.GetDemeID()].OrganismDeath(in_cell);
   }
   
@@ -2273,6 +2334,11 @@ void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
   
   // And clear it!
   in_cell.RemoveOrganism(ctx); 
+  m_empty_cells.Insert(in_cell.GetID());
+  m_age_order.Remove(in_cell.GetID());
+  m_forager_index.Remove(in_cell.GetID());
+  m_neighbor_prey.SetPrey(in_cell.GetID(), false);
+  m_occupancy.Remove(in_cell.GetID());
   if (!organism->IsRunning()) delete organism;
   else organism->GetPhenotype().SetToDelete();
   
@@ -2280,6 +2346,15 @@ void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx)
   AdjustSchedule(in_cell, cMerit(0));
 }
 
+void cPopulation::KillOrganisms(const Apto::Array<int, Apto::Smart>& cell_ids, cAvidaContext& ctx)
+{
+  // Every other structure a death touches is updated in constant time per organism; the scheduler is the one that
+  // pays per adjustment, so it only hears about the emptied cells once the whole list has been processed
+  DeferScheduleAdjustments();
+  for (int i = 0; i < cell_ids.GetSize(); i++) KillOrganism(cell_array[cell_ids[i]], ctx);
+  FlushScheduleAdjustments();
+}
+
 void cPopulation::InjureOrg(cAvidaContext& ctx, cPopulationCell& in_cell, double injury, bool ding_reacs)
 {
   if (injury == 0) return;
@@ -2450,6 +2525,20 @@ void cPopulation::SwapCells(int cell_id1, int cell_id2, cAvidaContext& ctx)
   cOrganism* org1 = cell1.RemoveOrganism(ctx); 
   cOrganism* org2 = cell2.RemoveOrganism(ctx); 
   
+  // Organisms crossing a deme boundary take their share of the deme counts with them
+  if (deme_array.GetSize() > 0 && cell1.GetDemeID() != cell2.GetDemeID()) {
+    cDeme& deme1 = deme_array[cell1.GetDemeID()];
+    cDeme& deme2 = deme_array[cell2.GetDemeID()];
+    if (org1) { deme1.DecOrgCount(); deme1.RemoveOrgTotals(org1->GetPhenotype()); }
+    if (org2) { deme2.DecOrgCount(); deme2.RemoveOrgTotals(org2->GetPhenotype()); }
+    if (org2) { deme1.IncOrgCount(); deme1.AddOrgTotals(org2->GetPhenotype()); }
+    if (org1) { deme2.IncOrgCount(); deme2.AddOrgTotals(org1->GetPhenotype()); }
+    if (m_inst_count_totals.GetSize()) {
+      if (org1) { org1->GetPhenotype().DetachInstCountTotal(); attachInstCountTotal(org1, cell2.GetDemeID()); }
+      if (org2) { org2->GetPhenotype().DetachInstCountTotal(); attachInstCountTotal(org2, cell1.GetDemeID()); }
+    }
+  }
+  
   if (org2 != NULL) {
     cell1.InsertOrganism(org2, ctx); 
     AdjustSchedule(cell1, org2->GetPhenotype().GetMerit());
@@ -2465,6 +2554,12 @@ void cPopulation::SwapCells(int cell_id1, int cell_id2, cAvidaContext& ctx)
     AdjustSchedule(cell2, cMerit(0));
   }
   
+  m_empty_cells.Swap(cell_id1, cell_id2);
+  m_age_order.Swap(cell_id1, cell_id2);
+  m_forager_index.Swap(cell_id1, cell_id2);
+  m_neighbor_prey.Swap(cell_id1, cell_id2);
+  m_occupancy.Swap(cell_id1, cell_id2);
+  
   //LHZ: Take organism imputs from the PopulationCell along with the organisms
   environment.SwapInputs(ctx, cell1.m_inputs, cell2.m_inputs);
   
@@ -2623,16 +2718,10 @@ void cPopulation::CompeteDemes(cAvidaContext& ctx, int competition_type)
   
   // Pick which demes should be in the next generation.
   Apto::Array<int> new_demes(num_demes);
+  cWeightedIndex deme_choice(num_demes);
+  for (int deme_id = 0; deme_id < num_demes; deme_id++) deme_choice.SetWeight(deme_id, deme_fitness[deme_id]);
   for (int i = 0; i < num_demes; i++) {
-    double birth_choice = (double) ctx.GetRandom().GetDouble(total_fitness);
-    double test_total = 0;
-    for (int test_deme = 0; test_deme < num_demes; test_deme++) {
-      test_total += deme_fitness[test_deme];
-      if (birth_choice < test_total) {
-        new_demes[i] = test_deme;
-        break;
-      }
-    }
+    new_demes[i] = deme_choice.FindAliasPosition(ctx.GetRandom().GetDouble());
   }
   
   // Track how many of each deme we should have.
@@ -3147,6 +3236,9 @@ void cPopulation::ReplaceDeme(cDeme& source_deme, cDeme& target_deme, cAvidaCont
   // Stats tracking; pre-replication hook.
   m_world->GetStats().DemePreReplication(source_deme, target_deme);
   
+  // Every cell of both demes may be emptied and refilled, tell the scheduler once at the end
+  DeferScheduleAdjustments();
+  
   // used to pass energy to offspring demes (set to zero if energy model is not enabled)
   double source_deme_energy(0.0), deme_energy_decay(0.0), parent_deme_energy(0.0), offspring_deme_energy(0.0);
   if (m_world->GetConfig().ENERGY_ENABLED.Get()) {
@@ -3253,7 +3345,7 @@ void cPopulation::ReplaceDeme(cDeme& source_deme, cDeme& target_deme, cAvidaCont
     assert(germline_genotype);
     
     // create a new genome by mutation
-    Genome mg(germline_genotype->Properties().Get("genome"));
+    Genome mg(genotypeGenome(germline_genotype));
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
@@ -3345,6 +3437,8 @@ void cPopulation::ReplaceDeme(cDeme& source_deme, cDeme& target_deme, cAvidaCont
   source_deme.ClearShannonInformationStats();
   target_deme.ClearShannonInformationStats();
   
+  FlushScheduleAdjustments();
+  
   // do our post-replication stats tracking.
   m_world->GetStats().DemePostReplication(source_deme, target_deme);
 }
@@ -3391,6 +3485,7 @@ void cPopulation::ReplaceDemeFlaggedGermline(cDeme& source_deme, cDeme& target_d
   }
   // Stats tracking; pre-replication hook.
   m_world->GetStats().DemePreReplication(source_deme, target_deme);
+  DeferScheduleAdjustments();
   
   
   bool source_deme_resource_reset(true), target_deme_resource_reset(true);
@@ -3430,7 +3525,7 @@ void cPopulation::ReplaceDemeFlaggedGermline(cDeme& source_deme, cDeme& target_d
     // this is the genotype of the organism, which does not reflect any point mutations that have occurred. 
     // we need to use it to get the right length for the genome
     Systematics::GroupPtr parent_bg = target_founders[i]->SystematicsGroup("genotype");
-    Genome mg(parent_bg->Properties().Get("genome"));
+    Genome mg(parent_bg->StringProperty(Systematics::GROUP_PROP_GENOME));
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
@@ -3509,6 +3604,8 @@ void cPopulation::ReplaceDemeFlaggedGermline(cDeme& source_deme, cDeme& target_d
   source_deme.ClearShannonInformationStats();
   target_deme.ClearShannonInformationStats();
   
+  FlushScheduleAdjustments();
+  
   // do our post-replication stats tracking.
   m_world->GetStats().DemePostReplication(source_deme, target_deme);
   m_world->GetStats().TrackDemeGLSReplication(source_deme.GetID(), target_deme.GetID(), track_founders);
@@ -3540,10 +3637,14 @@ void cPopulation::SeedDeme(cDeme& _deme, Systematics::GroupPtr bg, Systematics::
   _deme.KillAll(ctx); 
   _deme.ClearFounders();
   
+  // Every founder is a clone of bg, so classification can go straight to it
+  Systematics::RoleClassificationHints hints;
+  hints["genotype"]["id"] = Apto::FormatStr("%d", bg->ID());
+  
   // Create the specified number of organisms in the deme.
   for(int i=0; i< m_world->GetConfig().DEMES_REPLICATE_SIZE.Get(); ++i) {
     int cellid = DemeSelectInjectionCell(_deme, i);
-    InjectGenome(cellid, src, Genome(bg->Properties().Get("genome")), ctx); 
+    InjectGenome(cellid, src, genotypeGenome(bg), ctx, 0, true, &hints); 
     DemePostInjection(_deme, cell_array[cellid]);
     _deme.AddFounder(bg);
   }
@@ -4062,7 +4163,7 @@ void cPopulation::SeedDeme_InjectDemeFounder(int _cell_id, Systematics::GroupPtr
     // MUTATE!
     
     // create a new genome by mutation
-    Genome mg(bg->Properties().Get("genome"));
+    Genome mg(genotypeGenome(bg));
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
@@ -4093,7 +4194,9 @@ void cPopulation::SeedDeme_InjectDemeFounder(int _cell_id, Systematics::GroupPtr
     
   } else {    
     // phenotype can be NULL
-    InjectGenome(_cell_id, Systematics::Source(Systematics::DUPLICATION, ""), Genome(bg->Properties().Get("genome")), ctx, lineage_label);
+    Systematics::RoleClassificationHints hints;
+    hints["genotype"]["id"] = Apto::FormatStr("%d", bg->ID());
+    InjectGenome(_cell_id, Systematics::Source(Systematics::DUPLICATION, ""), genotypeGenome(bg), ctx, lineage_label, true, &hints);
   }
   
   // At this point, the cell had better be occupied...
@@ -4343,10 +4446,9 @@ void cPopulation::PrintDonationStats()
   dn_donors->Write(stats.GetUpdate(), "update");
   
   
-  for (int i = 0; i < cell_array.GetSize(); i++)
+  // Only look at cells with organisms in them.
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1))
   {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
     cOrganism * organism = cell_array[i].GetOrganism();
     const cPhenotype & phenotype = organism->GetPhenotype();
     
@@ -5200,31 +5302,8 @@ cPopulationCell& cPopulation::PositionOffspring(cPopulationCell& parent_cell, cA
   // Handle Pop Cap Eldest (if enabled)  
   int pop_eldest = m_world->GetConfig().POP_CAP_ELDEST.Get();
   if (pop_eldest > 0 && num_organisms >= pop_eldest) {
-    int num_kills = 1;
-    
-    while (num_kills > 0) {
-      double max_age = 0.0;
-      double max_msr = 0.0;
-      int cell_id = 0;
-      for (int i = 0; i < live_org_list.GetSize(); i++) {
-        if (GetCell(live_org_list[i]->GetCellID()).IsOccupied() && live_org_list[i]->GetCellID() != parent_cell.GetID()) {       
-          double age = live_org_list[i]->GetPhenotype().GetAge();
-          if (age > max_age) {
-            max_age = age;
-            cell_id = live_org_list[i]->GetCellID();
-          }
-          else if (age == max_age) {
-            double msr = ctx.GetRandom().GetDouble();
-            if (msr > max_msr) {
-              max_msr = msr;
-              cell_id = live_org_list[i]->GetCellID();
-            }
-          }
-        }
-      }
-      KillOrganism(cell_array[cell_id], ctx);
-      num_kills--;
-    }
+    const int cell_id = FindEldestCell(parent_cell.GetID());
+    if (cell_id != -1) KillOrganism(cell_array[cell_id], ctx);
   }
   
   // for juvs with non-predatory parents...
@@ -5347,26 +5426,26 @@ cPopulationCell& cPopulation::PositionOffspring(cPopulationCell& parent_cell, cA
   tList<cPopulationCell> found_list;
   
   // First, check if there is an empty organism to work with (always preferred)
-  tList<cPopulationCell>& conn_list = parent_cell.ConnectionList();
+  const cConnectionList conn_list = parent_cell.ConnectionList();
   
   const bool prefer_empty = m_world->GetConfig().PREFER_EMPTY.Get();
   
   if (birth_method == POSITION_OFFSPRING_DISPERSAL && conn_list.GetSize() > 0) {
-    tList<cPopulationCell>* disp_list = &conn_list;
+    cConnectionList disp_list = conn_list;
     
     // hop through connection lists based on the dispersal rate
     int hops = ctx.GetRandom().GetRandPoisson(m_world->GetConfig().DISPERSAL_RATE.Get());
     for (int i = 0; i < hops; i++) {
-      disp_list = &(disp_list->GetPos(ctx.GetRandom().GetUInt(disp_list->GetSize()))->ConnectionList());
-      if (disp_list->GetSize() == 0) break;
+      disp_list = disp_list.GetPos(ctx.GetRandom().GetUInt(disp_list.GetSize()))->ConnectionList();
+      if (disp_list.GetSize() == 0) break;
     }
     
     // if prefer empty, select an empty cell from the final connection list
-    if (prefer_empty) FindEmptyCell(*disp_list, found_list);
+    if (prefer_empty) FindEmptyCell(disp_list, found_list);
     
     // if prefer empty is off, or there are no empty cells, use the whole connection list as possiblities
     if (found_list.GetSize() == 0) {
-      found_list = *disp_list;
+      for (int i = 0; i < disp_list.GetSize(); i++) found_list.PushRear(disp_list.GetPos(i));
       // if no hops were taken and ALLOW_PARENT is set, throw the parent cell into the hat for possible selection
       if (hops == 0 && parent_ok) found_list.Push(&parent_cell);
     }
@@ -5385,7 +5464,7 @@ cPopulationCell& cPopulation::PositionOffspring(cPopulationCell& parent_cell, cA
         PositionMerit(parent_cell, found_list, parent_ok);
         break;
       case POSITION_OFFSPRING_RANDOM:
-        found_list.Append(conn_list);
+        for (int i = 0; i < conn_list.GetSize(); i++) found_list.PushRear(conn_list.GetPos(i));
         if (parent_ok == true) found_list.Push(&parent_cell);
         break;
       case POSITION_OFFSPRING_NEIGHBORHOOD_ENERGY_USED:
@@ -5416,10 +5495,9 @@ void cPopulation::PositionAge(cPopulationCell & parent_cell,
   if (parent_ok == false) max_age = -1;
   
   // Now look at all of the neighbors.
-  tListIterator<cPopulationCell> conn_it( parent_cell.ConnectionList() );
-  
-  cPopulationCell * test_cell;
-  while ( (test_cell = conn_it.Next()) != NULL) {
+  const cConnectionList conn_list = parent_cell.ConnectionList();
+  for (int i = 0; i < conn_list.GetSize(); i++) {
+    cPopulationCell* test_cell = conn_list.GetPos(i);
     const int cur_age = test_cell->GetOrganism()->GetPhenotype().GetAge();
     if (cur_age > max_age) {
       max_age = cur_age;
@@ -5444,10 +5522,9 @@ void cPopulation::PositionMerit(cPopulationCell & parent_cell,
   if (parent_ok == false) max_ratio = -1;
   
   // Now look at all of the neighbors.
-  tListIterator<cPopulationCell> conn_it( parent_cell.ConnectionList() );
-  
-  cPopulationCell * test_cell;
-  while ( (test_cell = conn_it.Next()) != NULL) {
+  const cConnectionList conn_list = parent_cell.ConnectionList();
+  for (int i = 0; i < conn_list.GetSize(); i++) {
+    cPopulationCell* test_cell = conn_list.GetPos(i);
     const double cur_ratio = test_cell->GetOrganism()->CalcMeritRatio();
     if (cur_ratio > max_ratio) {
       max_ratio = cur_ratio;
@@ -5472,10 +5549,9 @@ void cPopulation::PositionEnergyUsed(cPopulationCell & parent_cell,
   if (parent_ok == false) max_energy_used = -1;
   
   // Now look at all of the neighbors.
-  tListIterator<cPopulationCell> conn_it( parent_cell.ConnectionList() );
-  
-  cPopulationCell * test_cell;
-  while ( (test_cell = conn_it.Next()) != NULL) {
+  const cConnectionList conn_list = parent_cell.ConnectionList();
+  for (int i = 0; i < conn_list.GetSize(); i++) {
+    cPopulationCell* test_cell = conn_list.GetPos(i);
     const int cur_energy_used = test_cell->GetOrganism()->GetPhenotype().GetTimeUsed();
     if (cur_energy_used > max_energy_used) {
       max_energy_used = cur_energy_used;
@@ -5619,12 +5695,8 @@ cPopulationCell& cPopulation::PositionDemeRandom(int deme_id, cPopulationCell& p
   
   // Look randomly within empty cells first, if requested
   if (m_world->GetConfig().PREFER_EMPTY.Get()) {
-    
-    int num_empty_cells = UpdateEmptyCellIDArray(deme_id);
-    if (num_empty_cells > 0) {
-      int out_pos = m_world->GetRandom().GetUInt(num_empty_cells);
-      return GetCell(empty_cell_id_array[out_pos]);
-    }
+    const int empty_cell_id = m_empty_cells.Pick(deme_id, m_world->GetRandom());
+    if (empty_cell_id != -1) return GetCell(empty_cell_id);
   }
   
   int out_pos = m_world->GetRandom().GetUInt(deme_size);
@@ -5640,49 +5712,40 @@ cPopulationCell& cPopulation::PositionDemeRandom(int deme_id, cPopulationCell& p
 
 int cPopulation::FindRandEmptyCell(cAvidaContext& ctx)
 {
-  int world_size = cell_array.GetSize();
-  // full world
-  if (num_organisms >= world_size) return -1;
-
-  Apto::Array<int>& cells = GetEmptyCellIDArray();
-  int cell_idx = ctx.GetRandom().GetUInt(world_size);
-  int cell_id = cells[cell_idx];
-  while (GetCell(cell_id).IsOccupied()) {
-    // no need to pop this cell off the array, just move it and don't check that far anymore
-    cells.Swap(cell_idx, --world_size);
-    // if ran out of cells to check (e.g. with birth chamber weirdness)
-    if (world_size == 1) return -1;
-    cell_idx = ctx.GetRandom().GetUInt(world_size); 
-    cell_id = cells[cell_idx];
-  }
-  return cell_id;
+  return m_empty_cells.Pick(ctx.GetRandom());
 }
 
-// This function updates the list of empty cell ids in the population
-// and returns the number of empty cells found. Used by global PREFER_EMPTY
-// PositionOffspring() methods with demes (only). 
-int cPopulation::UpdateEmptyCellIDArray(int deme_id)
+// Returns the cell of the eldest organism other than the one in excluded_cell_id, or -1 if there is none.
+// Ties go to the organism that has been in the age order longest.
+int cPopulation::FindEldestCell(int excluded_cell_id)
 {
-  int num_empty_cells = 0;
-  // Note: empty_cell_id_array was resized to be large enough to hold
-  // all cells in the cPopulation when it was created. Using functions
-  // that resize it (like Push) will slow this code down considerably.
-  // Instead, we keep track of how much of this memory we are using.
-  
-  // Look at all cells
-  if (deme_id == -1) {
-    for (int i=0; i<cell_array.GetSize(); i++) {
-      if (GetCell(i).IsOccupied() == false) empty_cell_id_array[num_empty_cells++] = i;
-    }
-  }
-  // Look at a specific deme
-  else {
-    cDeme& deme = deme_array[deme_id];
-    for (int i=0; i<deme.GetSize(); i++) {
-      if (GetCell(deme.GetCellID(i)).IsOccupied() == false) empty_cell_id_array[num_empty_cells++] = deme.GetCellID(i);
+  int cell_id = m_age_order.GetEldest();
+  while (cell_id != -1) {
+    // An age reset outside of a divide (e.g. a new trial) leaves a cell older in the order than it really is
+    const int stamp = AgeStamp(GetCell(cell_id).GetOrganism());
+    if (stamp != m_age_order.GetStamp(cell_id)) {
+      m_age_order.Insert(cell_id, stamp);
+      cell_id = m_age_order.GetEldest();
+      continue;
     }
+    if (cell_id != excluded_cell_id) return cell_id;
+    cell_id = m_age_order.GetNext(cell_id);
   }
-  return num_empty_cells;
+  return -1;
+}
+
+int cPopulation::AgeStamp(cOrganism* org) const
+{
+  return m_age_clock - org->GetPhenotype().GetAge();
+}
+
+// Brings the forager index and neighbor prey counts in line with the current forage target of the occupant of cell_id
+void cPopulation::UpdateForagerIndex(int cell_id)
+{
+  cOrganism* org = GetCell(cell_id).GetOrganism();
+  if (org == NULL) return;
+  m_forager_index.Update(cell_id, org->IsPredFT());
+  m_neighbor_prey.SetPrey(cell_id, org->IsPreyFT());
 }
 
 
@@ -5691,6 +5754,25 @@ int cPopulation::ScheduleOrganism()
   return m_scheduler->Next();
 }
 
+// Each scheduling decision is worth m_schedule_batch cycles.  For the probabilistic scheduler every draw is independent,
+// and for the integrated scheduler every entry in the deterministic sequence is scaled by the same factor, so in both
+// cases the expected allocation per organism is unchanged; only the granularity is coarser.
+int cPopulation::ScheduleOrganism(int& num_cycles)
+{
+  num_cycles = m_schedule_batch;
+  return m_scheduler->Next();
+}
+
+void cPopulation::ScheduleOrganisms(int count, Apto::Array<int>& cell_ids)
+{
+  if (m_prob_scheduler) {
+    m_prob_scheduler->Next(count, cell_ids);
+    return;
+  }
+  cell_ids.Resize(count);
+  for (int i = 0; i < count; i++) cell_ids[i] = m_scheduler->Next();
+}
+
 void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
 {
   assert(step_size > 0.0);
@@ -5712,22 +5794,66 @@ void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
   }
   
   m_world->GetStats().IncExecuted();
-  resource_count.Update(step_size);
   
-  // These must be done even if there is only one deme.
-  for(int i = 0; i < GetNumDemes(); i++) {
-    GetDeme(i).Update(step_size);
-  }
+  // Global and deme resources pick up the elapsed time lazily, the next time they are integrated.
+  m_step_time += step_size;
   
   cDeme & deme = GetDeme(GetCell(cell_id).GetDemeID());
   deme.IncTimeUsed(merit);
   
   if (GetNumDemes() >= 1) {
+    // A single deme check is too cheap to be worth two clock reads per executed instruction
+    cUpdateProfiler::cScope scope((GetNumDemes() > 1) ? m_world->GetProfiler() : NULL, cUpdateProfiler::DEME_CHECKS);
     CheckImplicitDemeRepro(deme, ctx); 
   }
 }
 
 
+// Execute up to num_cycles consecutive instructions of the organism in cell_id, stopping early if it dies or is
+// replaced.  Returns the number of cycles that were consumed.
+int cPopulation::ProcessSteps(cAvidaContext& ctx, double step_size, int cell_id, int num_cycles)
+{
+  assert(step_size > 0.0);
+  assert(cell_id < cell_array.GetSize());
+  
+  // If cell_id is negative, no cell could be found -- consume the batch and stop here.
+  if (cell_id < 0) return num_cycles;
+  
+  cPopulationCell& cell = GetCell(cell_id);
+  assert(cell.IsOccupied()); // Unoccupied cell getting processor time!
+  cOrganism* cur_org = cell.GetOrganism();
+  cHardwareBase* hw = cell.GetHardware();
+  cDeme& deme = GetDeme(cell.GetDemeID());
+  
+  int executed = 0;
+  while (executed < num_cycles) {
+    hw->SingleProcess(ctx);
+    executed++;
+    
+    deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
+    if (cur_org->GetPhenotype().GetToDelete() == true) {
+      cur_org->GetHardware().DeleteMiniTrace(print_mini_trace_reacs);
+      delete cur_org;
+      break;
+    }
+    
+    // Offspring may have been placed into this cell, the remainder of the batch belonged to the parent
+    if (cell.GetOrganism() != cur_org) break;
+  }
+  
+  const double elapsed = step_size * executed;
+  m_world->GetStats().IncExecuted(executed);
+  m_step_time += elapsed;
+  
+  if (GetNumDemes() >= 1) {
+    cUpdateProfiler::cScope scope((GetNumDemes() > 1) ? m_world->GetProfiler() : NULL, cUpdateProfiler::DEME_CHECKS);
+    CheckImplicitDemeRepro(deme, ctx);
+  }
+  
+  return executed;
+}
+
+
 void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id)
 {
   assert(step_size > 0.0);
@@ -5745,26 +5871,30 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   if (cell.GetSpeculativeState()) {
     // We have already executed this instruction, just decrement the counter
     cell.DecSpeculative();
+    m_world->GetStats().AddSpeculativeHit(hw->GetType());
   } else {
     // Execute the actual instruction
-    if (hw->SingleProcess(ctx)) {
+    const bool can_speculate = hw->CanSpeculate();
+    const int hw_type = hw->GetType();
+    if (hw->SingleProcess(ctx) && can_speculate) {
       // Speculatively execute additional instructions
       int spec_count = 0;
-      while (spec_count < 32) {
+      while (spec_count < SPECULATIVE_DEPTH) {
         if (hw->SingleProcess(ctx, true)) spec_count++;
         else break;
       }
       cell.SetSpeculativeState(spec_count);
-      m_world->GetStats().AddSpeculative(spec_count);
+      m_world->GetStats().AddSpeculative(spec_count, 1, hw_type);
     }
   }
   
+  m_step_time += step_size;
+  
   // Deme specific
   if (GetNumDemes() > 1) {
-    for(int i = 0; i < GetNumDemes(); i++) GetDeme(i).Update(step_size);
-    
     cDeme& deme = GetDeme(GetCell(cell_id).GetDemeID());
     deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
+    cUpdateProfiler::cScope scope(m_world->GetProfiler(), cUpdateProfiler::DEME_CHECKS);
     CheckImplicitDemeRepro(deme, ctx); 
   }
   
@@ -5775,7 +5905,18 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   }
   
   m_world->GetStats().IncExecuted();
-  resource_count.Update(step_size);
+}
+
+void cPopulation::PreExecuteTiles()
+{
+  if (m_tiles) m_tiles->PreExecute();
+}
+
+void cPopulation::ProcessDemesParallel(int update_size)
+{
+  const int parallel_steps = m_deme_parallel->Execute(update_size);
+  m_world->GetStats().IncExecuted(parallel_steps);
+  m_step_time += parallel_steps / (double)update_size;
 }
 
 // Loop through all the demes getting stats and doing calculations
@@ -5837,11 +5978,30 @@ void cPopulation::UpdateDemeStats(cAvidaContext& ctx) {
 
 void cPopulation::UpdateOrganismStats(cAvidaContext& ctx) 
 {
-  // Loop through all the cells getting stats and doing calculations
-  // which must be done on a creature by creature basis.
+  // A single pass over the living organisms feeds the general, forage target and mating type statistics.  Per
+  // instruction counts that no print action or data recorder has asked for are skipped.
   
   cStats& stats = m_world->GetStats();
   
+  const bool ft_stats = (m_world->GetConfig().PRED_PREY_SWITCH.Get() == -2 || m_world->GetConfig().PRED_PREY_SWITCH.Get() > -1);
+  const bool mt_stats = m_world->GetConfig().MATING_TYPES.Get();
+  const bool class_inst_stats = stats.ShouldCollectClassInstStats() && (ft_stats || mt_stats);
+  const bool message_inst_stats = stats.ShouldCollectFromMessageInstStats();
+  const bool env_test_stats = stats.ShouldCollectEnvTestStats();
+  const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+  const int num_reactions = m_world->GetEnvironment().GetNumReactions();
+  const int sense_size = stats.GetSenseSize();
+  
+  // Large populations may estimate the general statistics from a sample of the organisms, except on the exact
+  // interval.  Organism stat providers and the forage target and mating type sums always see every organism.
+  const int num_orgs = live_org_list.GetSize();
+  const int sample_size = m_world->GetConfig().STATS_SAMPLE_SIZE.Get();
+  const int exact_interval = m_world->GetConfig().STATS_EXACT_INTERVAL.Get();
+  const bool sampled = (sample_size > 0 && sample_size < num_orgs &&
+                        (exact_interval <= 0 || stats.GetUpdate() % exact_interval != 0));
+  if (sampled) SampleOrganismStats(ctx, sample_size);
+  int next_sample = 0;
+  
   // Clear out organism sums...
   stats.SumFitness().Clear();
   stats.SumGestation().Clear();
@@ -5859,6 +6019,9 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
   stats.ZeroTasks();
   stats.ZeroReactions();
   
+  if (ft_stats) ClearFTOrgStats();
+  if (mt_stats) ClearMaleFemaleOrgStats();
+  
   for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) m_org_stat_providers[osp_idx]->UpdateReset();
 
   // Counts...
@@ -5882,6 +6045,9 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
   int min_gestation_time = INT_MAX;
   int min_genome_length = INT_MAX;
   
+  // Every organism ages by one below, which leaves the birth stamps of the age order unchanged
+  m_age_clock++;
+  
   for (int i = 0; i < live_org_list.GetSize(); i++) {  
     cOrganism* organism = live_org_list[i];
     
@@ -5889,15 +6055,36 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
       m_org_stat_providers[osp_idx]->HandleOrganism(organism);
     }
     
+    if (sampled) {
+      if (next_sample < m_stats_sample.GetSize() && m_stats_sample[next_sample] == i) {
+        next_sample++;
+      } else {
+        organism->GetPhenotype().IncAge();
+        if (ft_stats || mt_stats) {
+          cString inst_set;
+          if (class_inst_stats) inst_set = (const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue();
+          if (ft_stats) UpdateFTOrgStats(organism, inst_set, class_inst_stats);
+          if (mt_stats) UpdateMaleFemaleOrgStats(organism, inst_set, class_inst_stats);
+        }
+        continue;
+      }
+    }
+    
     const cPhenotype& phenotype = organism->GetPhenotype();
     const cMerit cur_merit = phenotype.GetMerit();
     const double cur_fitness = phenotype.GetFitness();
     const int cur_gestation_time = phenotype.GetGestationTime();
     const int cur_genome_length = phenotype.GetGenomeLength();
     
-    Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-    for (int j = 0; j < phenotype.GetLastFromMessageInstCount().GetSize(); j++) {
-      from_message_exec_counts[j].Add(organism->GetPhenotype().GetLastFromMessageInstCount()[j]);
+    cString inst_set;
+    if (message_inst_stats || class_inst_stats) {
+      inst_set = (const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue();
+    }
+    
+    if (message_inst_stats) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet(inst_set);
+      const Apto::Array<int>& from_message_counts = phenotype.GetLastFromMessageInstCount();
+      for (int j = 0; j < from_message_counts.GetSize(); j++) from_message_exec_counts[j].Add(from_message_counts[j]);
     }
 
     stats.SumFitness().Add(cur_fitness);
@@ -5909,8 +6096,8 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
     stats.SumLineageLabel().Add(organism->GetLineageLabel());
     stats.SumCopyMutRate().Push(organism->MutationRates().GetCopyMutProb());
     stats.SumLogCopyMutRate().Push(log(organism->MutationRates().GetCopyMutProb()));
-    stats.SumDivMutRate().Push(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType());
-    stats.SumLogDivMutRate().Push(log(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType()));
+    stats.SumDivMutRate().Push(organism->MutationRates().GetDivMutProb() / phenotype.GetDivType());
+    stats.SumLogDivMutRate().Push(log(organism->MutationRates().GetDivMutProb() / phenotype.GetDivType()));
     stats.SumCopySize().Add(phenotype.GetCopiedSize());
     stats.SumExeSize().Add(phenotype.GetExecutedSize());
     
@@ -5925,7 +6112,7 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
     if (cur_genome_length < min_genome_length) min_genome_length = cur_genome_length;
     
     // Test what tasks this creatures has completed.
-    for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) {
+    for (int j = 0; j < num_tasks; j++) {
       if (phenotype.GetCurTaskCount()[j] > 0) {
         stats.AddCurTask(j);
         stats.AddCurTaskQuality(j, phenotype.GetCurTaskQuality()[j]);
@@ -5964,17 +6151,17 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
       }
     }
 
-    if (stats.ShouldCollectEnvTestStats()) {
+    if (env_test_stats) {
       Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
       Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
       const Apto::Array<int>& test_task_counts = metrics->GetTaskCounts();
       
-      for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) if (test_task_counts[j] > 0) stats.AddTestTask(j);
+      for (int j = 0; j < num_tasks; j++) if (test_task_counts[j] > 0) stats.AddTestTask(j);
     }
     
     
     // Record what add bonuses this organism garnered for different reactions
-    for (int j = 0; j < m_world->GetEnvironment().GetNumReactions(); j++) {
+    for (int j = 0; j < num_reactions; j++) {
       if (phenotype.GetCurReactionCount()[j] > 0) {
         stats.AddCurReaction(j);
         stats.AddCurReactionAddReward(j, phenotype.GetCurReactionAddReward()[j]);
@@ -5988,7 +6175,7 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
     }
     
     // Test what resource combinations this creature has sensed
-    for (int j = 0; j < stats.GetSenseSize(); j++) {
+    for (int j = 0; j < sense_size; j++) {
       if (phenotype.GetLastSenseCount()[j] > 0) {
         stats.AddLastSense(j);
         stats.IncLastSenseExeCount(j, phenotype.GetLastSenseCount()[j]);
@@ -6010,8 +6197,25 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
     
     // Increment the age of this organism.
     organism->GetPhenotype().IncAge();
+    
+    // Forage target and mating type sums see the incremented age
+    if (ft_stats) UpdateFTOrgStats(organism, inst_set, class_inst_stats);
+    if (mt_stats) UpdateMaleFemaleOrgStats(organism, inst_set, class_inst_stats);
   }
   
+  if (sampled) {
+    const double scale = double(num_orgs) / sample_size;
+    stats.ScaleSampledOrganismCounts(scale);
+    num_breed_true = int(num_breed_true * scale + 0.5);
+    num_parasites = int(num_parasites * scale + 0.5);
+    num_no_birth = int(num_no_birth * scale + 0.5);
+    num_single_thread = int(num_single_thread * scale + 0.5);
+    num_multi_thread = num_orgs - num_single_thread;
+    num_threads = int(num_threads * scale + 0.5);
+    num_modified = int(num_modified * scale + 0.5);
+  }
+  stats.SetOrganismStatsSample(sampled ? sample_size : num_orgs, num_orgs);
+  
   stats.SetBreedTrueCreatures(num_breed_true);
   stats.SetNumNoBirthCreatures(num_no_birth);
   stats.SetNumParasites(num_parasites);
@@ -6033,9 +6237,20 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
   resource_count.UpdateGlobalResources(ctx);   
 }
 
-void cPopulation::UpdateFTOrgStats(cAvidaContext&) 
+void cPopulation::SampleOrganismStats(cAvidaContext& ctx, int sample_size)
+{
+  // Reservoir sample of the live organism indices, sorted so the statistics pass can walk it alongside the list
+  m_stats_sample.Resize(sample_size);
+  for (int i = 0; i < sample_size; i++) m_stats_sample[i] = i;
+  for (int i = sample_size; i < live_org_list.GetSize(); i++) {
+    const int j = ctx.GetRandom().GetUInt(i + 1);
+    if (j < sample_size) m_stats_sample[j] = i;
+  }
+  std::sort(&m_stats_sample[0], &m_stats_sample[0] + sample_size);
+}
+
+void cPopulation::ClearFTOrgStats()
 {
-  // Get per-org stats seperately for pred and prey
   cStats& stats = m_world->GetStats();
   
   // Clear out organism sums...
@@ -6064,102 +6279,94 @@ void cPopulation::UpdateFTOrgStats(cAvidaContext&)
   
   stats.ZeroFTInst();
   stats.ZeroGroupAttackInst();
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {
-    cOrganism* organism = live_org_list[i];
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    
-    if (organism->IsPreyFT()) {
-      stats.SumPreyFitness().Add(cur_fitness);
-      stats.SumPreyGestation().Add(phenotype.GetGestationTime());
-      stats.SumPreyMerit().Add(cur_merit.GetDouble());
-      stats.SumPreyCreatureAge().Add(phenotype.GetAge());
-      stats.SumPreyGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+}
+
+void cPopulation::UpdateFTOrgStats(cOrganism* organism, const cString& inst_set, bool collect_inst)
+{
+  // Get per-org stats seperately for pred and prey
+  cStats& stats = m_world->GetStats();
+  const cPhenotype& phenotype = organism->GetPhenotype();
+  const cMerit cur_merit = phenotype.GetMerit();
+  const double cur_fitness = phenotype.GetFitness();
+  
+  if (organism->IsPreyFT()) {
+    stats.SumPreyFitness().Add(cur_fitness);
+    stats.SumPreyGestation().Add(phenotype.GetGestationTime());
+    stats.SumPreyMerit().Add(cur_merit.GetDouble());
+    stats.SumPreyCreatureAge().Add(phenotype.GetAge());
+    stats.SumPreyGeneration().Add(phenotype.GetGeneration());
+    
+    if (collect_inst) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        prey_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
+        prey_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
       }
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        prey_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
+        prey_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
       }
     }
-    else if (organism->IsPredFT()) {
-      stats.SumPredFitness().Add(cur_fitness);
-      stats.SumPredGestation().Add(phenotype.GetGestationTime());
-      stats.SumPredMerit().Add(cur_merit.GetDouble());
-      stats.SumPredCreatureAge().Add(phenotype.GetAge());
-      stats.SumPredGeneration().Add(phenotype.GetGeneration());
-      stats.SumAttacks().Add(phenotype.GetLastAttacks());
-      stats.SumKills().Add(phenotype.GetLastKills());
-
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+  }
+  else if (organism->IsPredFT()) {
+    stats.SumPredFitness().Add(cur_fitness);
+    stats.SumPredGestation().Add(phenotype.GetGestationTime());
+    stats.SumPredMerit().Add(cur_merit.GetDouble());
+    stats.SumPredCreatureAge().Add(phenotype.GetAge());
+    stats.SumPredGeneration().Add(phenotype.GetGeneration());
+    stats.SumAttacks().Add(phenotype.GetLastAttacks());
+    stats.SumKills().Add(phenotype.GetLastKills());
+    
+    if (collect_inst) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        pred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
+        pred_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
       }
-
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        pred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
+        pred_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
       }
-
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      
+      Apto::Array<cString>& att_inst = stats.GetGroupAttackInsts(inst_set);
       for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
         for (int j = 0; j < phenotype.GetLastGroupAttackInstCount()[k].GetSize(); j++) {
-          group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastGroupAttackInstCount()[k][j]);
+          group_attack_inst_exe_counts[j].Add(phenotype.GetLastGroupAttackInstCount()[k][j]);
         }
       }
     }
-    else {
-      stats.SumTopPredFitness().Add(cur_fitness);
-      stats.SumTopPredGestation().Add(phenotype.GetGestationTime());
-      stats.SumTopPredMerit().Add(cur_merit.GetDouble());
-      stats.SumTopPredCreatureAge().Add(phenotype.GetAge());
-      stats.SumTopPredGeneration().Add(phenotype.GetGeneration());
-      stats.SumAttacks().Add(phenotype.GetLastAttacks());
-      stats.SumKills().Add(phenotype.GetLastKills());
-     
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+  }
+  else {
+    stats.SumTopPredFitness().Add(cur_fitness);
+    stats.SumTopPredGestation().Add(phenotype.GetGestationTime());
+    stats.SumTopPredMerit().Add(cur_merit.GetDouble());
+    stats.SumTopPredCreatureAge().Add(phenotype.GetAge());
+    stats.SumTopPredGeneration().Add(phenotype.GetGeneration());
+    stats.SumAttacks().Add(phenotype.GetLastAttacks());
+    stats.SumKills().Add(phenotype.GetLastKills());
+    
+    if (collect_inst) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        tpred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
+        tpred_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
       }
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        tpred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
+        tpred_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
       }
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<cString>& att_inst = stats.GetGroupAttackInsts(inst_set);
       for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
         for (int j = 0; j < phenotype.GetLastTopPredGroupAttackInstCount()[k].GetSize(); j++) {
-          group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastTopPredGroupAttackInstCount()[k][j]);
+          group_attack_inst_exe_counts[j].Add(phenotype.GetLastTopPredGroupAttackInstCount()[k][j]);
         }
       }
     }
-    
-    // Record what add bonuses this organism garnered for different reactions
-    /*    for (int j = 0; j < m_world->GetEnvironment().GetNumReactions(); j++) {
-     if (phenotype.GetCurReactionCount()[j] > 0) {
-     stats.AddCurReaction(j);
-     stats.AddCurReactionAddReward(j, phenotype.GetCurReactionAddReward()[j]);
-     }
-     
-     if (phenotype.GetLastReactionCount()[j] > 0) {
-     stats.AddLastReaction(j);
-     stats.IncReactionExeCount(j, phenotype.GetLastReactionCount()[j]);
-     stats.AddLastReactionAddReward(j, phenotype.GetLastReactionAddReward()[j]);
-     }
-     }*/
-    
   }
 }
 
-void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
+void cPopulation::ClearMaleFemaleOrgStats()
 {
-  // Get per-org stats seperately for males and females
   cStats& stats = m_world->GetStats();
   
   // Clear out organism sums...
@@ -6176,35 +6383,41 @@ void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
   stats.SumFemaleGeneration().Clear();
   
   stats.ZeroMTInst();
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {  
-    cOrganism* organism = live_org_list[i];
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    
-    if(organism->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-      stats.SumMaleFitness().Add(cur_fitness);
-      stats.SumMaleGestation().Add(phenotype.GetGestationTime());
-      stats.SumMaleMerit().Add(cur_merit.GetDouble());
-      stats.SumMaleCreatureAge().Add(phenotype.GetAge());
-      stats.SumMaleGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+}
+
+void cPopulation::UpdateMaleFemaleOrgStats(cOrganism* organism, const cString& inst_set, bool collect_inst)
+{
+  // Get per-org stats seperately for males and females
+  cStats& stats = m_world->GetStats();
+  const cPhenotype& phenotype = organism->GetPhenotype();
+  const cMerit cur_merit = phenotype.GetMerit();
+  const double cur_fitness = phenotype.GetFitness();
+  
+  if (phenotype.GetMatingType() == MATING_TYPE_MALE) {
+    stats.SumMaleFitness().Add(cur_fitness);
+    stats.SumMaleGestation().Add(phenotype.GetGestationTime());
+    stats.SumMaleMerit().Add(cur_merit.GetDouble());
+    stats.SumMaleCreatureAge().Add(phenotype.GetAge());
+    stats.SumMaleGeneration().Add(phenotype.GetGeneration());
+    
+    if (collect_inst) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        male_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
+        male_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
       }
     }
-    else if (organism->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-      stats.SumFemaleFitness().Add(cur_fitness);
-      stats.SumFemaleGestation().Add(phenotype.GetGestationTime());
-      stats.SumFemaleMerit().Add(cur_merit.GetDouble());
-      stats.SumFemaleCreatureAge().Add(phenotype.GetAge());
-      stats.SumFemaleGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+  }
+  else if (phenotype.GetMatingType() == MATING_TYPE_FEMALE) {
+    stats.SumFemaleFitness().Add(cur_fitness);
+    stats.SumFemaleGestation().Add(phenotype.GetGestationTime());
+    stats.SumFemaleMerit().Add(cur_merit.GetDouble());
+    stats.SumFemaleCreatureAge().Add(phenotype.GetAge());
+    stats.SumFemaleGeneration().Add(phenotype.GetGeneration());
+    
+    if (collect_inst) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        female_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
+        female_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
       }
     }
   }
@@ -6226,28 +6439,107 @@ void cPopulation::ProcessPreUpdate()
 
 void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
 {
+  cUpdateProfiler* profiler = m_world->GetProfiler();
+  
+  // Bring all resources up to date with the step time of the finished update and restart the shared clock.
+  {
+    cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::RESOURCES);
+    resource_count.FlushStepTime();
+    for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].FlushStepTime();
+    m_step_time = 0.0;
+    if (m_deme_parallel) m_deme_parallel->ResetClocks();
+  }
+  
   ProcessUpdateCellActions(ctx);
   
   cStats& stats = m_world->GetStats();
   
   stats.SetNumCreatures(GetNumOrganisms());
   
-  UpdateDemeStats(ctx); 
-  UpdateOrganismStats(ctx);
-  if (m_world->GetConfig().PRED_PREY_SWITCH.Get() == -2 || m_world->GetConfig().PRED_PREY_SWITCH.Get() > -1) {
-    UpdateFTOrgStats(ctx);
-  }
-  if (m_world->GetConfig().MATING_TYPES.Get()) {
-    UpdateMaleFemaleOrgStats(ctx);
+  {
+    cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::DEMES);
+    UpdateDemeStats(ctx); 
   }
+  UpdateOrganismStats(ctx);
   
+  cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::DEMES);
   for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessUpdate(ctx);   
 }
 
 void cPopulation::ProcessUpdateCellActions(cAvidaContext& ctx)
 {
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    if (cell_array[i].MutationRates().TestDeath(ctx)) KillOrganism(cell_array[i], ctx); 
+  // Death in an empty cell would have no effect, so only occupied cells are tested.  Cells still at the configured
+  // death probability are pooled and their victims found by skipping geometrically distributed runs of survivors,
+  // taking one random draw per death; cells given a rate of their own are tested individually.
+  const double death_prob = m_world->GetConfig().DEATH_PROB.Get();
+  Apto::Array<int, Apto::Smart> pooled;
+  Apto::Array<int, Apto::Smart> victims;
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) {
+    const cMutationRates& rates = cell_array[i].MutationRates();
+    if (rates.GetDeathProb() == death_prob) {
+      if (death_prob > 0.0) pooled.Push(i);
+    } else if (rates.TestDeath(ctx)) {
+      victims.Push(i);
+    }
+  }
+  
+  if (pooled.GetSize()) {
+    if (death_prob >= 1.0) {
+      for (int i = 0; i < pooled.GetSize(); i++) victims.Push(pooled[i]);
+    } else {
+      const double log_survive = log(1.0 - death_prob);
+      double pos = -1.0;
+      while (true) {
+        pos += 1.0 + floor(log(1.0 - ctx.GetRandom().GetDouble()) / log_survive);
+        if (pos >= pooled.GetSize()) break;
+        victims.Push(pooled[(int)pos]);
+      }
+    }
+  }
+  
+  KillOrganisms(victims, ctx);
+}
+
+void cPopulation::ProcessPointMutations(cAvidaContext& ctx)
+{
+  // Organisms that only carry point substitutions at a shared rate are pooled: the number of substitutions over all
+  // of their sites is drawn once and each lands on a uniformly chosen site, so the pass costs one draw per mutation
+  // rather than a binomial per organism.  Anything else goes through the organism's own PointMutate.
+  Apto::Array<int, Apto::Smart> pooled;
+  Apto::Array<int, Apto::Smart> site_ends;
+  double pool_rate = 0.0;
+  int num_sites = 0;
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) {
+    cOrganism* org = m_occupancy.GetOrganism(i);
+    const double mut_prob = org->GetPointMutProb();
+    if (org->GetPointInsProb() == 0.0 && org->GetPointDelProb() == 0.0 && mut_prob > 0.0 &&
+        (pooled.GetSize() == 0 || mut_prob == pool_rate)) {
+      pool_rate = mut_prob;
+      num_sites += org->GetHardware().GetMemory().GetSize();
+      pooled.Push(i);
+      site_ends.Push(num_sites);
+    } else {
+      org->IncPointMutations(org->GetHardware().PointMutate(ctx));
+    }
+  }
+  if (!num_sites) return;
+  
+  const int num_mut = ctx.GetRandom().GetRandBinomial(num_sites, pool_rate);
+  for (int m = 0; m < num_mut; m++) {
+    const int site = ctx.GetRandom().GetUInt(num_sites);
+    
+    // Find the organism whose range of sites holds it
+    int lo = 0;
+    int hi = site_ends.GetSize() - 1;
+    while (lo < hi) {
+      const int mid = (lo + hi) / 2;
+      if (site_ends[mid] > site) hi = mid;
+      else lo = mid + 1;
+    }
+    
+    cOrganism* org = m_occupancy.GetOrganism(pooled[lo]);
+    org->GetHardware().PointMutateSite(ctx, site - ((lo > 0) ? site_ends[lo - 1] : 0));
+    org->IncPointMutations(1);
   }
 }
 
@@ -6298,7 +6590,7 @@ bool cPopulation::SavePopulation(const cString& filename, bool save_historic, bo
       cOrganism* org = cell_array[cell].GetOrganism();
       
       // Handle any parasites
-      const Apto::Array<Systematics::UnitPtr>& parasites = org->GetParasites();
+      const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites = org->GetParasites();
       for (int p = 0; p < parasites.GetSize(); p++) {
         Systematics::GroupPtr pg = parasites[p]->SystematicsGroup("genotype");
         if (pg == NULL) continue;
@@ -6486,6 +6778,166 @@ bool cPopulation::SavePopulation(const cString& filename, bool save_historic, bo
 }
 
 
+bool cPopulation::SavePopulationInBackground(const cString& filename, bool save_historic, bool save_groupings,
+                                             bool save_avatars, bool save_rebirth)
+{
+#if APTO_PLATFORM(WINDOWS)
+  return SavePopulation(filename, save_historic, save_groupings, save_avatars, save_rebirth);
+#else
+  ReapPopulationWriters(false);
+  
+  // The child process holds a copy-on-write image of the population as of this moment and writes the spop from it,
+  // so the update loop only pauses for the fork itself
+  pid_t pid = fork();
+  if (pid < 0) return SavePopulation(filename, save_historic, save_groupings, save_avatars, save_rebirth);
+  
+  if (pid == 0) {
+    Avida::Output::Manager::Of(m_world->GetNewWorld())->AbandonAsyncWriter();
+    bool success = SavePopulation(filename, save_historic, save_groupings, save_avatars, save_rebirth);
+    
+    // Skip destructors and exit handlers, which belong to the parent's copy of the world
+    _exit(success ? 0 : 1);
+  }
+  
+  m_population_writers.Push(pid);
+  return true;
+#endif
+}
+
+
+void cPopulation::ReapPopulationWriters(bool wait)
+{
+#if !APTO_PLATFORM(WINDOWS)
+  for (int i = 0; i < m_population_writers.GetSize();) {
+    int status = 0;
+    if (waitpid(m_population_writers[i], &status, (wait) ? 0 : WNOHANG) == 0) {
+      i++;
+      continue;
+    }
+    
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      cerr << "warning: background population save (process " << m_population_writers[i] << ") failed" << endl;
+    }
+    m_population_writers[i] = m_population_writers[m_population_writers.GetSize() - 1];
+    m_population_writers.Resize(m_population_writers.GetSize() - 1);
+  }
+#endif
+}
+
+
+void cPopulation::EnableInstCountTotals()
+{
+  if (m_inst_count_totals.GetSize()) return;
+  
+  // Allocated once, since the phenotypes hold pointers to the arrays
+  cHardwareManager& hwm = m_world->GetHardwareManager();
+  const int num_demes = (deme_array.GetSize() > 0) ? deme_array.GetSize() : 1;
+  m_inst_count_totals.Resize(num_demes * hwm.GetNumInstSets());
+  for (int d = 0; d < num_demes; d++) {
+    for (int i = 0; i < hwm.GetNumInstSets(); i++) {
+      m_inst_count_totals[d * hwm.GetNumInstSets() + i].Resize(hwm.GetInstSet(i).GetSize(), 0);
+    }
+  }
+  
+  for (int i = 0; i < live_org_list.GetSize(); i++) {
+    attachInstCountTotal(live_org_list[i], cell_array[live_org_list[i]->GetCellID()].GetDemeID());
+  }
+}
+
+
+void cPopulation::GetInstCountTotals(int inst_set_id, Apto::Array<int>& totals) const
+{
+  totals.Resize(0);
+  const int num_inst_sets = m_world->GetHardwareManager().GetNumInstSets();
+  if (inst_set_id < 0 || inst_set_id >= num_inst_sets || !m_inst_count_totals.GetSize()) return;
+  
+  totals.Resize(m_inst_count_totals[inst_set_id].GetSize(), 0);
+  for (int slot = inst_set_id; slot < m_inst_count_totals.GetSize(); slot += num_inst_sets) {
+    const Apto::Array<int>& deme_totals = m_inst_count_totals[slot];
+    for (int j = 0; j < deme_totals.GetSize(); j++) totals[j] += deme_totals[j];
+  }
+}
+
+
+// Each deme has its own totals, so organisms of demes running on separate threads never share an array
+void cPopulation::attachInstCountTotal(cOrganism* org, int deme_id)
+{
+  cHardwareManager& hwm = m_world->GetHardwareManager();
+  const int inst_set_id = hwm.GetInstSetID(org->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+  if (inst_set_id < 0) return;
+  if (deme_id < 0) deme_id = 0;
+  org->GetPhenotype().AttachInstCountTotal(&m_inst_count_totals[deme_id * hwm.GetNumInstSets() + inst_set_id]);
+}
+
+
+const cPopulationSnapshot& cPopulation::GetSnapshot()
+{
+  if (m_snapshot.GetVersion() == m_occupancy.GetVersion()) return m_snapshot;
+  
+  m_snapshot.Reset(m_occupancy.GetVersion());
+  for (int cell = m_occupancy.NextOccupied(0); cell != -1; cell = m_occupancy.NextOccupied(cell + 1)) {
+    cOrganism* org = m_occupancy.GetOrganism(cell);
+    cPopulationSnapshot::sEntry& entry = m_snapshot.Push();
+    entry.cell_id = cell;
+    entry.org = org;
+    entry.genotype = org->SystematicsGroup("genotype");
+    entry.seq.DynamicCastFrom(org->GetGenome().Representation());
+    entry.inst_set = org->GetGenome().Properties().Get("instset").StringValue();
+  }
+  
+  return m_snapshot;
+}
+
+
+// Columnar snapshot of the systematics groups of one role among the living population, parasites included.  Rows are
+// the groups in order of the first cell they occupy; the cells of row r are cells[cell_start[r]] up to (but not
+// including) cells[cell_start[r + 1]], in cell order.
+struct sGroupSnapshot
+{
+  Apto::Array<Systematics::GroupPtr> groups;
+  Apto::Array<int> cell_start;
+  Apto::Array<int> cells;
+};
+
+static void SnapshotGroups(const Apto::Array<cPopulationCell>& cell_array, const cCellOccupancy& occupancy,
+                           const Systematics::RoleID& role, sGroupSnapshot& snapshot)
+{
+  Apto::Map<int, int> row_of;
+  Apto::Array<int, Apto::Smart> entry_row;
+  Apto::Array<int, Apto::Smart> entry_cell;
+  Apto::Array<int> row_count;
+
+  for (int cell = occupancy.NextOccupied(0); cell != -1; cell = occupancy.NextOccupied(cell + 1)) {
+    cOrganism* org = cell_array[cell].GetOrganism();
+    const Apto::Array<Systematics::UnitPtr, Apto::Smart>& parasites = org->GetParasites();
+    for (int p = 0; p <= parasites.GetSize(); p++) {
+      Systematics::GroupPtr group = (p < parasites.GetSize()) ? parasites[p]->SystematicsGroup(role) : org->SystematicsGroup(role);
+      if (!group) continue;
+
+      int row = -1;
+      if (!row_of.Get(group->ID(), row)) {
+        row = snapshot.groups.GetSize();
+        snapshot.groups.Push(group);
+        row_count.Push(0);
+        row_of.Set(group->ID(), row);
+      }
+      row_count[row]++;
+      entry_row.Push(row);
+      entry_cell.Push(cell);
+    }
+  }
+
+  // Counting sort of the (row, cell) entries into contiguous per-row runs, stable so that each run stays in cell order
+  const int num_rows = snapshot.groups.GetSize();
+  snapshot.cell_start.Resize(num_rows + 1);
+  snapshot.cell_start[0] = 0;
+  for (int r = 0; r < num_rows; r++) snapshot.cell_start[r + 1] = snapshot.cell_start[r] + row_count[r];
+
+  snapshot.cells.Resize(entry_cell.GetSize());
+  for (int r = 0; r < num_rows; r++) row_count[r] = snapshot.cell_start[r];
+  for (int i = 0; i < entry_cell.GetSize(); i++) snapshot.cells[row_count[entry_row[i]]++] = entry_cell[i];
+}
+
 bool cPopulation::SaveStructuredSystematicsGroup(const Systematics::RoleID& role, const cString& filename)
 {
   Apto::String file_path((const char*)filename);
@@ -6494,61 +6946,26 @@ bool cPopulation::SaveStructuredSystematicsGroup(const Systematics::RoleID& role
   df->WriteComment("Structured Systematics Group Save");
   df->WriteTimeStamp();
   
-  // Build up hash table of all current genotypes and the cells in which the organisms reside
-  Apto::Map<int, sGroupInfo*> group_map;
+  sGroupSnapshot snapshot;
+  SnapshotGroups(cell_array, m_occupancy, role, snapshot);
   
-  for (int cell = 0; cell < cell_array.GetSize(); cell++) {
-    if (cell_array[cell].IsOccupied()) {
-      cOrganism* org = cell_array[cell].GetOrganism();
-      
-      // Handle any parasites
-      const Apto::Array<Systematics::UnitPtr>& parasites = org->GetParasites();
-      for (int p = 0; p < parasites.GetSize(); p++) {
-        Systematics::GroupPtr pg = parasites[p]->SystematicsGroup(role);
-        if (pg == NULL) continue;
-        
-        sGroupInfo* map_entry = NULL;
-        if (group_map.Get(pg->ID(), map_entry)) {
-          map_entry->orgs.Push(sOrgInfo(cell, 0, -1, -1, -1, 0, -1, -1, -1, 0, 1));
-        } else {
-          map_entry = new sGroupInfo(pg, true);
-          map_entry->orgs.Push(sOrgInfo(cell, 0, -1, -1, -1, 0, -1, -1, -1, 0, 1));
-          group_map.Set(pg->ID(), map_entry);
-        }
-      }
-      
-      
-      // Handle the organism itself
-      Systematics::GroupPtr group = org->SystematicsGroup(role);
-      if (!group) continue;
-      
-      int offset = org->GetPhenotype().GetCPUCyclesUsed();
-      sGroupInfo* map_entry = NULL;
-      if (group_map.Get(group->ID(), map_entry)) {
-        map_entry->orgs.Push(sOrgInfo(cell, offset, 0, -1, -1, 0, -1, -1, -1, 0, 1));
-      } else {
-        map_entry = new sGroupInfo(group);
-        map_entry->orgs.Push(sOrgInfo(cell, offset, 0, -1, -1, 0, -1, -1, -1, 0, 1));
-        group_map.Set(group->ID(), map_entry);
-      }
-    }
-  }
-  
-  // Output all current genotypes
-  for (Apto::Map<int, sGroupInfo*>::ValueIterator it = group_map.Values(); it.Next();) {
-    sGroupInfo* group_info = *it.Get();
-    Systematics::GroupPtr group = group_info->bg;
+  // Output all current groups, each occupied cell list formatted into a single reused buffer
+  Apto::Array<char> cellbuf;
+  for (int r = 0; r < snapshot.groups.GetSize(); r++) {
+    snapshot.groups[r]->LegacySave(Apto::GetInternalPtr(df));
     
-    group->LegacySave(Apto::GetInternalPtr(df));
+    const int begin = snapshot.cell_start[r];
+    const int end = snapshot.cell_start[r + 1];
+    const int needed = (end - begin) * 12 + 1;
+    if (cellbuf.GetSize() < needed) cellbuf.Resize(needed);
+    int len = 0;
+    for (int i = begin; i < end; i++) {
+      len += snprintf(&cellbuf[len], cellbuf.GetSize() - len, (i == begin) ? "%d" : ",%d", snapshot.cells[i]);
+    }
+    cellbuf[len] = '\0';
     
-    Apto::Array<sOrgInfo>& cells = group_info->orgs;
-    cString cellstr;
-    cellstr.Set("%d", cells[0].cell_id);
-    for (int cell_i = 1; cell_i < cells.GetSize(); cell_i++) cellstr += cStringUtil::Stringf(",%d", cells[cell_i].cell_id);
-    df->Write(cellstr, "Occupied Cell IDs", "cells");
+    df->Write(&cellbuf[0], "Occupied Cell IDs", "cells");
     df->Endl();
-    
-    delete group_info;
   }
   
   return true;
@@ -6594,57 +7011,38 @@ bool cPopulation::SaveFlameData(const cString& filename)
   df->WriteComment("Flame Data Save");
   df->WriteTimeStamp();
   
-  // Build up hash table of all current genotypes
-  Apto::Map<int, sGroupInfo*> genotype_map;
+  sGroupSnapshot snapshot;
+  SnapshotGroups(cell_array, m_occupancy, "genotype", snapshot);
+  const int num_rows = snapshot.groups.GetSize();
+  if (!num_rows) return true;
+  
+  Apto::Array<int> ids(num_rows);
+  Apto::Array<int> num_units(num_rows);
+  Apto::Array<int> depths(num_rows);
+  for (int r = 0; r < num_rows; r++) {
+    ids[r] = snapshot.groups[r]->ID();
+    num_units[r] = snapshot.groups[r]->NumUnits();
+    depths[r] = snapshot.groups[r]->Depth();
+  }
+  
+  // The first row goes through the column writers so that the header (or binary schema) is emitted.  Binary files
+  // keep using them for every row; text rows are formatted into one buffer and written without per row flushes.
+  const int text_from = (df->IsBinary()) ? num_rows : 1;
+  for (int r = 0; r < text_from; r++) {
+    df->Write(ids[r], "ID", "genotype_id");
+    df->Write(num_units[r], "Number of currently living organisms", "num_units");
+    df->Write(depths[r], "Phylogenetic Depth", "depth");
+    df->Endl();
+  }
   
-  for (int cell = 0; cell < cell_array.GetSize(); cell++) {
-    if (cell_array[cell].IsOccupied()) {
-      cOrganism* org = cell_array[cell].GetOrganism();
-      
-      // Handle any parasites
-      const Apto::Array<Systematics::UnitPtr>& parasites = org->GetParasites();
-      for (int p = 0; p < parasites.GetSize(); p++) {
-        Systematics::GroupPtr pg = parasites[p]->SystematicsGroup("genotype");
-        if (pg == NULL) continue;
-        
-        sGroupInfo* map_entry = NULL;
-        if (genotype_map.Get(pg->ID(), map_entry)) {
-          map_entry->orgs.Push(sOrgInfo(cell, 0, -1, -1, -1, 0, -1, -1, -1, 0, 1));
-        } else {
-          map_entry = new sGroupInfo(pg, true);
-          map_entry->orgs.Push(sOrgInfo(cell, 0, -1, -1, -1, 0, -1, -1, -1, 0, 1));
-          genotype_map.Set(pg->ID(), map_entry);
-        }
-      }
-      
-      
-      // Handle the organism itself
-      Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
-      if (genotype == NULL) continue;
-      
-      int offset = org->GetPhenotype().GetCPUCyclesUsed();
-      sGroupInfo* map_entry = NULL;
-      if (genotype_map.Get(genotype->ID(), map_entry)) {
-        map_entry->orgs.Push(sOrgInfo(cell, offset, org->GetLineageLabel(), -1, -1, 0, -1, -1, -1, 0, 1));
-      } else {
-        map_entry = new sGroupInfo(genotype);
-        map_entry->orgs.Push(sOrgInfo(cell, offset, org->GetLineageLabel(), -1, -1, 0, -1, -1, -1, 0, 1));
-        genotype_map.Set(genotype->ID(), map_entry);
-      }
+  if (text_from < num_rows) {
+    Apto::Array<char> rowbuf((num_rows - text_from) * 40 + 1);
+    int len = 0;
+    for (int r = text_from; r < num_rows; r++) {
+      len += snprintf(&rowbuf[len], rowbuf.GetSize() - len, "%d %d %d \n", ids[r], num_units[r], depths[r]);
     }
+    df->OFStream().write(&rowbuf[0], len);
   }
-  
-  // Output all current genotypes
-  for (Apto::Map<int, sGroupInfo*>::ValueIterator it = genotype_map.Values(); it.Next();) {
-    sGroupInfo* group_info = *it.Get();
-    Systematics::GroupPtr genotype = group_info->bg;
-    
-    df->Write(genotype->ID(), "ID", "genotype_id");
-    df->Write(genotype->NumUnits(), "Number of currently living organisms", "num_units");
-    df->Write(genotype->Depth(), "Phylogenetic Depth", "depth");
-    df->Endl();    
-    delete group_info;
-  }  
 
   return true;
 }
@@ -6711,28 +7109,43 @@ bool cPopulation::LoadHostGenotypeList(const cString& filename, cAvidaContext& c
 }
 
 
-bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset, int lineage_offset, bool load_groups, bool load_birth_cells, bool load_avatars, bool load_rebirth, bool load_parent_dat, int traceq)
+// Parses a contiguous range of spop lines into genotype records, so that large files can be split across the job queue
+class cLoadPopulationJob
 {
-  // @TODO - build in support for verifying population dimensions
+private:
+  const cInitFile& m_file;
+  Apto::Array<sTmpGenotype, Apto::ManagedPointer>& m_genotypes;
+  int m_first;
+  int m_last;
+  
+  bool m_load_groups;
+  bool m_load_birth_cells;
+  bool m_load_avatars;
+  bool m_load_rebirth;
+  bool m_load_parent_dat;
+  bool m_use_avatars;
   
-  cInitFile input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
-  if (!input_file.WasOpened()) return false;
+public:
+  bool m_structured;  // some line in the range lists resident cells
   
-  // Clear out the population, unless an offset is being used
-  if (cellid_offset == 0) {
-    for (int i = 0; i < cell_array.GetSize(); i++) KillOrganism(cell_array[i], ctx); 
-  }
+  cLoadPopulationJob(const cInitFile& file, Apto::Array<sTmpGenotype, Apto::ManagedPointer>& genotypes, int first, int last,
+                     bool load_groups, bool load_birth_cells, bool load_avatars, bool load_rebirth, bool load_parent_dat,
+                     bool use_avatars)
+    : m_file(file), m_genotypes(genotypes), m_first(first), m_last(last), m_load_groups(load_groups)
+    , m_load_birth_cells(load_birth_cells), m_load_avatars(load_avatars), m_load_rebirth(load_rebirth)
+    , m_load_parent_dat(load_parent_dat), m_use_avatars(use_avatars), m_structured(false) { ; }
   
-  // First, we read in all the genotypes and store them in an array
-  Apto::Array<sTmpGenotype, Apto::ManagedPointer> genotypes(input_file.GetNumLines());
+  void Run(cAvidaContext&)
+  {
+    for (int line_id = m_first; line_id < m_last; line_id++) parseLine(line_id);
+  }
   
-  bool structured = false;
-  for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
+private:
+  void parseLine(int line_id)
+  {
     // Setup the genotype for this line...
-    sTmpGenotype& tmp = genotypes[line_id];
-    tmp.props = input_file.GetLineAsDict(line_id);
+    sTmpGenotype& tmp = m_genotypes[line_id];
+    tmp.props = m_file.GetLineAsDict(line_id);
     tmp.id_num = Apto::StrAs(tmp.props->Get("id"));
 
     // Loads "num_units" preferrentially, but will fall back to "num_cpus" if present
@@ -6741,14 +7154,14 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     
     // Process resident cell ids
     cString cellstr(tmp.props->Get("cells"));
-    if (structured || cellstr.GetSize()) {
-      structured = true;
+    if (cellstr.GetSize()) {
+      m_structured = true;
       while (cellstr.GetSize()) tmp.cells.Push(cellstr.Pop(',').AsInt());
       assert(tmp.cells.GetSize() == tmp.num_cpus);
     }
     
     // Process gestation time offsets
-    if (!load_rebirth) {
+    if (!m_load_rebirth) {
       cString offsetstr(tmp.props->Get("gest_offset"));
       if (offsetstr.GetSize()) {
         while (offsetstr.GetSize()) tmp.offsets.Push(offsetstr.Pop(',').AsInt());
@@ -6762,13 +7175,13 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     assert(tmp.lineage_labels.GetSize() == 0 || tmp.lineage_labels.GetSize() == tmp.num_cpus);
     
     // Other org specs (if given in file)
-    if (load_rebirth) {
+    if (m_load_rebirth) {
       if (tmp.props->Has("birth_cell")) {
         cString birthstr(tmp.props->Get("birth_cell"));
         while (birthstr.GetSize()) tmp.birth_cells.Push(birthstr.Pop(',').AsInt());
         assert(tmp.birth_cells.GetSize() == 0 || tmp.birth_cells.GetSize() == tmp.num_cpus);      
       }
-      if (tmp.props->Has("av_bcell") && m_world->GetConfig().USE_AVATARS.Get()) {
+      if (tmp.props->Has("av_bcell") && m_use_avatars) {
         cString avatarstr(tmp.props->Get("av_bcell"));
         while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
         assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
@@ -6790,7 +7203,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
       }
     }
     else {
-      if (load_groups) {
+      if (m_load_groups) {
         if (tmp.props->Has("group_id")) {
           cString groupstr(tmp.props->Get("group_id"));
           while (groupstr.GetSize()) tmp.group_ids.Push(groupstr.Pop(',').AsInt());
@@ -6802,24 +7215,24 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
           assert(tmp.forager_types.GetSize() == 0 || tmp.forager_types.GetSize() == tmp.num_cpus);
         }
       }
-      if (load_birth_cells) {   
+      if (m_load_birth_cells) {   
         if (tmp.props->Has("birth_cell")) {
           cString birthstr(tmp.props->Get("birth_cell"));
           while (birthstr.GetSize()) tmp.birth_cells.Push(birthstr.Pop(',').AsInt());
           assert(tmp.birth_cells.GetSize() == 0 || tmp.birth_cells.GetSize() == tmp.num_cpus);
         }
-        if (tmp.props->Has("av_bcell") && m_world->GetConfig().USE_AVATARS.Get()) {
+        if (tmp.props->Has("av_bcell") && m_use_avatars) {
           cString avatarstr(tmp.props->Get("av_bcell"));
           while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
           assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
         }
       }
-      else if (!load_birth_cells && load_avatars && tmp.props->Has("avatar_cell")) {
+      else if (!m_load_birth_cells && m_load_avatars && tmp.props->Has("avatar_cell")) {
         cString avatarstr(tmp.props->Get("avatar_cell"));
         while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
         assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
       }
-    if (load_parent_dat) {
+    if (m_load_parent_dat) {
       if (tmp.props->Has("parent_is_teach")) {
         cString teachstr(tmp.props->Get("parent_is_teach"));
         while (teachstr.GetSize()) tmp.parent_teacher.Push((bool)(teachstr.Pop(',').AsInt()));
@@ -6837,12 +7250,52 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
       }
     }
     }
-    if (m_world->GetConfig().USE_AVATARS.Get() && !tmp.avatar_cells.GetSize()) {
+    if (m_use_avatars && !tmp.avatar_cells.GetSize()) {
       cString avatarstr(tmp.props->Get("avatar_cell"));
       while (avatarstr.GetSize()) tmp.avatar_cells.Push(avatarstr.Pop(',').AsInt());
       assert(tmp.avatar_cells.GetSize() == 0 || tmp.avatar_cells.GetSize() == tmp.num_cpus);
     }
   }
+};
+
+static const int LOAD_POPULATION_CHUNK_LINES = 256;
+
+bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset, int lineage_offset, bool load_groups, bool load_birth_cells, bool load_avatars, bool load_rebirth, bool load_parent_dat, int traceq)
+{
+  // @TODO - build in support for verifying population dimensions
+  
+  cInitFile input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
+  if (!input_file.WasOpened()) return false;
+  
+  // Clear out the population, unless an offset is being used
+  if (cellid_offset == 0) {
+    for (int i = 0; i < cell_array.GetSize(); i++) KillOrganism(cell_array[i], ctx); 
+  }
+  
+  // First, we read in all the genotypes and store them in an array, parsing chunks of lines on the job queue
+  Apto::Array<sTmpGenotype, Apto::ManagedPointer> genotypes(input_file.GetNumLines());
+  
+  Apto::Array<cLoadPopulationJob*, Apto::Smart> jobs;
+  for (int first = 0; first < input_file.GetNumLines(); first += LOAD_POPULATION_CHUNK_LINES) {
+    const int last = Apto::Min(first + LOAD_POPULATION_CHUNK_LINES, input_file.GetNumLines());
+    jobs.Push(new cLoadPopulationJob(input_file, genotypes, first, last, load_groups, load_birth_cells, load_avatars,
+                                     load_rebirth, load_parent_dat, m_world->GetConfig().USE_AVATARS.Get()));
+  }
+  
+  // Analyze workers cannot wait on the queue they are serving, so they (and analyze mode) just run the jobs in turn
+  if (ctx.GetAnalyzeMode() || jobs.GetSize() < 2) {
+    for (int j = 0; j < jobs.GetSize(); j++) jobs[j]->Run(ctx);
+  } else {
+    tAnalyzeJobBatch<cLoadPopulationJob> jobbatch(m_world->GetAnalyze().GetJobQueue());
+    for (int j = 0; j < jobs.GetSize(); j++) jobbatch.AddJob(jobs[j], &cLoadPopulationJob::Run);
+    jobbatch.RunBatch();
+  }
+  
+  bool structured = false;
+  for (int j = 0; j < jobs.GetSize(); j++) {
+    structured = structured || jobs[j]->m_structured;
+    delete jobs[j];
+  }
   
   // Sort genotypes in descending order according to their id_num
   Apto::QSort(genotypes);
@@ -6850,6 +7303,10 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
   Systematics::ArbiterPtr bgm = classmgr->ArbiterForRole("genotype");
   
+  // Genotypes loaded so far, by their id in the file, so that parents (which always precede their offspring) are found
+  // without scanning the whole list
+  Apto::Map<int, int> loaded_ids;
+  
   bool some_missing = false;
   for (int i = genotypes.GetSize() - 1; i >= 0; i--) {
     // Fix Parent IDs
@@ -6861,12 +7318,8 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     while (opidlist.GetSize()) {
       int opid = opidlist.Pop().AsInt();
       int npid = -1;
-      for (int j = i; j < genotypes.GetSize(); j++) {
-        if (genotypes[j].id_num == opid) {
-          npid = genotypes[j].bg->ID();
-          break;
-        }
-      }
+      int parent_i = -1;
+      if (loaded_ids.Get(opid, parent_i)) npid = genotypes[parent_i].bg->ID();
       // only for pop saves that include historic (i.e. parent id found):
       if (npid != -1) {
         if (pcount) nparentstr += ",";
@@ -6878,6 +7331,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     genotypes[i].props->Set("parents", (const char*)nparentstr);
     
     genotypes[i].bg = bgm->LegacyLoad(&genotypes[i].props);
+    loaded_ids.Set(genotypes[i].id_num, i);
   }  
 //  if (some_missing) m_world->GetDriver().Feedback().Warning("Some parents not found in loaded pop file. Defaulting to parent ID of '(none)' for those genomes.");
   
@@ -6885,6 +7339,31 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   int u_cell_id = 0;
   for (int gen_i = 0; gen_i < genotypes.GetSize(); gen_i++) {
     sTmpGenotype& tmp = genotypes[gen_i];
+    
+    // The genome is parsed once for the genotype, and all of its organisms are classified together
+    assert(tmp.bg->Properties().Has("genome"));
+    Genome mg(tmp.bg->StringProperty(Systematics::GROUP_PROP_GENOME));
+    InstructionSequencePtr seq;
+    seq.DynamicCastFrom(mg.Representation());
+    
+    Apto::Array<cOrganism*> new_organisms(tmp.num_cpus);
+    Apto::Array<Systematics::UnitPtr> units(tmp.num_cpus);
+    for (int cell_i = 0; cell_i < tmp.num_cpus; cell_i++) {
+      cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
+      
+      // Setup the phenotype...
+      new_organism->GetPhenotype().SetupInject(*seq);
+      
+      units[cell_i] = Systematics::UnitPtr(new_organism);
+      new_organism->AddReference(); // creating new smart pointer to org, explicitly add reference
+      new_organisms[cell_i] = new_organism;
+    }
+    
+    // Classify the new organisms
+    Systematics::RoleClassificationHints hints;
+    hints["genotype"]["id"] = Apto::FormatStr("%d", tmp.bg->ID());
+    classmgr->ClassifyNewUnits(units, &hints);
+    
     // otherwise, we insert as many organisms as we need
     for (int cell_i = 0; cell_i < tmp.num_cpus; cell_i++) {
       int cell_id = 0;
@@ -6897,23 +7376,8 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
         lineage_label = tmp.lineage_labels[cell_i] + lineage_offset;
       }
       
-      assert(tmp.bg->Properties().Has("genome"));
-      Genome mg(tmp.bg->Properties().Get("genome"));
-      cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
-      
-      // Setup the phenotype...
+      cOrganism* new_organism = new_organisms[cell_i];
       cPhenotype& phenotype = new_organism->GetPhenotype();
-      InstructionSequencePtr seq;
-      seq.DynamicCastFrom(mg.Representation());
-      
-      phenotype.SetupInject(*seq);
-      
-      // Classify this new organism
-      Systematics::RoleClassificationHints hints;
-      hints["genotype"]["id"] = Apto::FormatStr("%d", tmp.bg->ID());
-      Systematics::UnitPtr unit(new_organism);
-      new_organism->AddReference(); // creating new smart pointer to org, explicitly add reference      
-      classmgr->ClassifyNewUnit(unit, &hints);
       
       // Coalescense Clade Setup
       new_organism->SetCCladeLabel(-1);
@@ -7018,6 +7482,212 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   return true;
 }
 
+
+static void archivePropertiesToDict(ConstArchivePtr ar, Apto::Map<Apto::String, Apto::String>& dict)
+{
+  ConstPropertyIDSetPtr prop_ids = ar->Properties().PropertyIDs();
+  for (PropertyIDSet::ConstIterator it = prop_ids->Begin(); it.Next();) {
+    dict.Set(*it.Get(), ar->Properties().Get(*it.Get()).StringValue());
+  }
+}
+
+
+bool cPopulation::SaveCheckpoint(const cString& filename, cAvidaContext& ctx)
+{
+  Output::ManagerPtr omgr = Output::Manager::Of(m_world->GetNewWorld());
+  const Apto::String path = omgr->OutputIDFromPath((const char*)filename);
+  
+  BinaryArchivePtr ar(new BinaryArchive);
+  BuildCheckpoint(ar, ctx);
+  
+  if (!ar->Write(path)) {
+    ctx.Driver().Feedback().Error("unable to write checkpoint file '%s'", (const char*)path);
+    return false;
+  }
+  return true;
+}
+
+
+void cPopulation::BuildCheckpoint(BinaryArchivePtr ar, cAvidaContext& ctx)
+{
+  ar->SetObjectType("avida.checkpoint");
+  ar->SetVersion(1);
+  
+  // The generator state itself cannot be captured, so both this run and any run resumed from the checkpoint continue
+  // from a freshly drawn seed
+  const int seed = m_world->GetRandom().GetInt(INT_MAX - 1) + 1;
+  m_world->GetRandom().ResetSeed(seed);
+  
+  ar->AttachValue("update", m_world->GetStats().GetUpdate());
+  ar->AttachValue("random_seed", seed);
+  ar->AttachValue("world_size", cell_array.GetSize());
+  ar->AttachValue("num_resources", resource_count.GetSize());
+  
+  Systematics::Manager::Of(m_world->GetNewWorld())->Serialize(ar->DefineSubObject("systematics"));
+  
+  BinaryArchivePtr orgs_ar = ar->DefineSubArchive("organisms");
+  for (int cell_id = 0; cell_id < cell_array.GetSize(); cell_id++) {
+    if (!cell_array[cell_id].IsOccupied()) continue;
+    cOrganism* org = cell_array[cell_id].GetOrganism();
+    Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
+    if (!genotype) continue;
+    
+    BinaryArchivePtr org_ar = orgs_ar->DefineSubArchive(Apto::AsStr(cell_id));
+    org_ar->AttachValue("genotype", genotype->ID());
+    org_ar->AttachValue("lineage", org->GetLineageLabel());
+    org_ar->AttachValue("merit", org->GetPhenotype().GetMerit().GetDouble());
+  }
+  
+  BinaryArchivePtr res_ar = ar->DefineSubArchive("resources");
+  const Apto::Array<Apto::Array<double> >& spatial_res = resource_count.GetSpatialRes(ctx);
+  for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
+    if (!resource_count.IsSpatialResource(res_id)) {
+      res_ar->AttachValue(Apto::AsStr(res_id), resource_count.Get(ctx, res_id));
+      continue;
+    }
+    Apto::String levels;
+    for (int cell_id = 0; cell_id < spatial_res[res_id].GetSize(); cell_id++) {
+      if (cell_id) levels += ",";
+      levels += Apto::FormatStr("%.17g", spatial_res[res_id][cell_id]);
+    }
+    res_ar->AttachValue(Apto::AsStr(res_id), levels);
+  }
+}
+
+
+bool cPopulation::LoadCheckpoint(const cString& filename, cAvidaContext& ctx)
+{
+  Output::ManagerPtr omgr = Output::Manager::Of(m_world->GetNewWorld());
+  Apto::String path = omgr->OutputIDFromPath((const char*)filename);
+  
+  // Checkpoints shipped with a configuration (freezer bundles) sit in the working directory rather than the data one
+  if (!Apto::FileSystem::IsFile(path)) path = Apto::FileSystem::PathAppend((const char*)m_world->GetWorkingDir(), (const char*)filename);
+  
+  // A bundle carries the checkpoint as its "checkpoint" sub-object
+  ConstArchivePtr ar = BinaryArchive::Read(path);
+  if (ar && ar->ObjectType() != "avida.checkpoint" && ar->SubObject("checkpoint")) ar = ar->SubObject("checkpoint");
+  if (!ar || ar->ObjectType() != "avida.checkpoint" || ar->Version() != 1) {
+    ctx.Driver().Feedback().Error("unable to read checkpoint file '%s'", (const char*)path);
+    return false;
+  }
+  
+  const PropertyMap& props = ar->Properties();
+  if (props.Get("world_size").IntValue() != cell_array.GetSize() ||
+      props.Get("num_resources").IntValue() != resource_count.GetSize()) {
+    ctx.Driver().Feedback().Error("checkpoint '%s' does not match the configured world or resources", (const char*)path);
+    return false;
+  }
+  
+  for (int i = 0; i < cell_array.GetSize(); i++) KillOrganism(cell_array[i], ctx);
+  
+  // Rebuild the genotypes in ascending ID order, translating parent IDs to the newly assigned ones
+  Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
+  Systematics::ArbiterPtr bgm = classmgr->ArbiterForRole("genotype");
+  Apto::Map<int, Systematics::GroupPtr> genotypes;
+  
+  ConstArchivePtr sys_ar = ar->SubObject("systematics");
+  ConstArchivePtr gen_ar = (sys_ar) ? sys_ar->SubObject("genotype") : ConstArchivePtr(NULL);
+  if (gen_ar) {
+    Apto::Array<int> ids;
+    ConstArchiveObjectIDSetPtr sub_ids = gen_ar->SubObjectIDs();
+    for (ArchiveObjectIDSet::ConstIterator it = sub_ids->Begin(); it.Next();) ids.Push(Apto::StrAs(*it.Get()));
+    Apto::QSort(ids);
+    
+    for (int i = 0; i < ids.GetSize(); i++) {
+      ConstArchivePtr g_ar = gen_ar->SubObject(Apto::AsStr(ids[i]));
+      Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > gprops(new Apto::Map<Apto::String, Apto::String>);
+      archivePropertiesToDict(g_ar, *gprops);
+      if (g_ar->SubObject("genome")) archivePropertiesToDict(g_ar->SubObject("genome"), *gprops);
+      
+      cString nparentstr;
+      cString lparentstr = (const char*)gprops->Get("parents");
+      if (lparentstr == "(none)") lparentstr = "";
+      cStringList opidlist(lparentstr, ',');
+      while (opidlist.GetSize()) {
+        Systematics::GroupPtr parent;
+        if (!genotypes.Get(opidlist.Pop().AsInt(), parent)) continue;
+        if (nparentstr.GetSize()) nparentstr += ",";
+        nparentstr += cStringUtil::Convert(parent->ID());
+      }
+      gprops->Set("parents", (const char*)nparentstr);
+      
+      genotypes.Set(ids[i], bgm->LegacyLoad(&gprops));
+    }
+  }
+  
+  // Reactivate the organisms with their exact merit
+  ConstArchivePtr orgs_ar = ar->SubObject("organisms");
+  ConstArchiveObjectIDSetPtr org_ids = (orgs_ar) ? orgs_ar->SubObjectIDs() : ConstArchiveObjectIDSetPtr(new ArchiveObjectIDSet);
+  for (ArchiveObjectIDSet::ConstIterator it = org_ids->Begin(); it.Next();) {
+    const int cell_id = Apto::StrAs(*it.Get());
+    ConstArchivePtr org_ar = orgs_ar->SubObject(*it.Get());
+    
+    Systematics::GroupPtr genotype;
+    if (cell_id < 0 || cell_id >= cell_array.GetSize() ||
+        !genotypes.Get(org_ar->Properties().Get("genotype").IntValue(), genotype)) continue;
+    
+    Genome mg(genotype->StringProperty(Systematics::GROUP_PROP_GENOME));
+    cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
+    
+    cPhenotype& phenotype = new_organism->GetPhenotype();
+    InstructionSequencePtr seq;
+    seq.DynamicCastFrom(mg.Representation());
+    phenotype.SetupInject(*seq);
+    
+    Systematics::RoleClassificationHints hints;
+    hints["genotype"]["id"] = Apto::FormatStr("%d", genotype->ID());
+    Systematics::UnitPtr unit(new_organism);
+    new_organism->AddReference(); // creating new smart pointer to org, explicitly add reference
+    classmgr->ClassifyNewUnit(unit, &hints);
+    
+    new_organism->SetCCladeLabel(-1);
+    phenotype.SetMerit(cMerit(org_ar->Properties().Get("merit").DoubleValue()));
+    new_organism->SetLineageLabel(org_ar->Properties().Get("lineage").IntValue());
+    
+    if (m_world->GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_FULL_SOUP_ELDEST &&
+        cell_array[cell_id].IsOccupied() == true) {
+      reaper_queue.Remove(&(cell_array[cell_id]));
+    }
+    new_organism->MutationRates().Copy(cell_array[cell_id].MutationRates());
+    
+    ActivateOrganism(ctx, new_organism, cell_array[cell_id], true, true);
+  }
+  
+  // Resources, global levels directly and spatial ones cell by cell
+  ConstArchivePtr res_ar = ar->SubObject("resources");
+  if (res_ar) {
+    const int num_res = resource_count.GetSize();
+    Apto::Array<Apto::Array<double> > spatial_res(num_res);
+    for (int res_id = 0; res_id < num_res; res_id++) {
+      const Apto::String res_key = Apto::AsStr(res_id);
+      if (!res_ar->Properties().Has(res_key)) continue;
+      if (!resource_count.IsSpatialResource(res_id)) {
+        resource_count.Set(ctx, res_id, res_ar->Properties().Get(res_key).DoubleValue());
+        continue;
+      }
+      cString levels((const char*)res_ar->Properties().Get(res_key).StringValue());
+      while (levels.GetSize()) spatial_res[res_id].Push(levels.Pop(',').AsDouble());
+    }
+    
+    Apto::Array<double> cell_res(num_res);
+    for (int cell_id = 0; cell_id < cell_array.GetSize(); cell_id++) {
+      bool any_spatial = false;
+      for (int res_id = 0; res_id < num_res; res_id++) {
+        const bool has_level = (cell_id < spatial_res[res_id].GetSize());
+        cell_res[res_id] = (has_level) ? spatial_res[res_id][cell_id] : 0.0;
+        if (has_level) any_spatial = true;
+      }
+      if (any_spatial) resource_count.SetCellResources(cell_id, cell_res);
+    }
+  }
+  
+  m_world->GetStats().SetCurrentUpdate(props.Get("update").IntValue());
+  m_world->GetRandom().ResetSeed(props.Get("random_seed").IntValue());
+  
+  sync_events = true;
+  return true;
+}
+
 /**
  * This function loads a genome from a given file, and initializes
  * a cpu with it.
@@ -7150,6 +7820,7 @@ void cPopulation::InjectParasite(const cString& label, const InstructionSequence
   
   if (target_organism->ParasiteInfectHost(parasite)) {
     Systematics::Manager::Of(m_world->GetNewWorld())->ClassifyNewUnit(parasite);
+    if (!m_deme_parallel && !m_tiles) parasite->ShareGenotypeGenome();
   }
 }
 
@@ -7211,6 +7882,21 @@ void cPopulation::SetResourceOutflow(const cString res_name, double new_level)
   resource_count.SetDecay(res_name, 1 - new_level);
 }
 
+// As above, for a resource already looked up in the resource library.  Deme resources are not in the population count.
+void cPopulation::SetResourceInflow(int res_id, double new_level)
+{
+  environment.SetResourceInflow(res_id, new_level);
+  const cResource* res = environment.GetResourceLib().GetResource(res_id);
+  if (!res->GetDemeResource()) resource_count.SetInflow(res->GetIndex(), new_level);
+}
+
+void cPopulation::SetResourceOutflow(int res_id, double new_level)
+{
+  environment.SetResourceOutflow(res_id, new_level);
+  const cResource* res = environment.GetResourceLib().GetResource(res_id);
+  if (!res->GetDemeResource()) resource_count.SetDecay(res->GetIndex(), 1 - new_level);
+}
+
 /* This method sets a deme resource to the same level across
  * all demes.  If a resource by the given name does not exist,
  * it does nothing.
@@ -7310,47 +7996,189 @@ void cPopulation::ResetInputs(cAvidaContext& ctx)
 }
 
 void cPopulation::BuildTimeSlicer()
+{
+  m_schedule_batch = 1;
+  const int slicing_method = m_world->GetConfig().SLICING_METHOD.Get();
+  if (slicing_method == SLICE_INTEGRATED_MERIT || slicing_method == SLICE_PROB_MERIT) {
+    m_schedule_batch = m_world->GetConfig().SLICING_BATCH_SIZE.Get();
+    if (m_schedule_batch < 1) m_schedule_batch = 1;
+  }
+  
+  m_scheduler = CreateScheduler(cell_array.GetSize());
+  m_prob_scheduler = (slicing_method == SLICE_PROB_MERIT) ? static_cast<cFenwickScheduler*>(m_scheduler) : NULL;
+  
+  // No priority is negative, so the first adjustment of every cell reaches the new scheduler
+  m_cell_priority.Resize(cell_array.GetSize());
+  m_cell_priority.SetAll(-1.0);
+  m_schedule_is_deferred.Resize(cell_array.GetSize());
+  m_schedule_is_deferred.SetAll(false);
+  m_schedule_deferred.Resize(0);
+}
+
+
+Apto::PriorityScheduler* cPopulation::CreateScheduler(int num_entries)
 {
   switch (m_world->GetConfig().SLICING_METHOD.Get()) {
     case SLICE_CONSTANT:
-      m_scheduler = new Apto::Scheduler::RoundRobin(cell_array.GetSize());
-      break;
-//    case SLICE_DEME_PROB_MERIT:
-//      schedule = new cDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
-//      break;
-//    case SLICE_PROB_DEMESIZE_PROB_MERIT:
-//      schedule = new cProbDemeProbSchedule(cell_array.GetSize(), ctx.GetRandom().GetInt(0x7FFFFFFF), deme_array.GetSize());
-//      break;
+      return new Apto::Scheduler::RoundRobin(num_entries);
+    case SLICE_DEME_PROB_MERIT:
+    case SLICE_PROB_DEMESIZE_PROB_MERIT:
+    {
+      Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
+      
+      // Schedulers of a single deme (deme parallel execution) only award cycles among the deme's members
+      if (num_entries != cell_array.GetSize()) return new cFenwickScheduler(num_entries, rng);
+      const cDemeScheduler::eDemeWeight weight = (m_world->GetConfig().SLICING_METHOD.Get() == SLICE_DEME_PROB_MERIT) ?
+        cDemeScheduler::DEME_EQUAL : cDemeScheduler::DEME_BY_SIZE;
+      return new cDemeScheduler(deme_array.GetSize(), num_entries / deme_array.GetSize(), weight, rng);
+    }
     case SLICE_INTEGRATED_MERIT:
-      m_scheduler = new Apto::Scheduler::Integrated(cell_array.GetSize());
-      break;
+      return new Apto::Scheduler::Integrated(num_entries);
     case SLICE_PROB_MERIT:
     {
       Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
-      m_scheduler = new Apto::Scheduler::Probabilistic(cell_array.GetSize(), rng);
+      return new cFenwickScheduler(num_entries, rng);
     }
-      break;
     case SLICE_PROB_INTEGRATED_MERIT:
     {
       Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed())));
-      m_scheduler = new Apto::Scheduler::ProbabilisticIntegrated(cell_array.GetSize(), rng);
+      return new Apto::Scheduler::ProbabilisticIntegrated(num_entries, rng);
     }
-      break;
     default:
       cout << "error: requested time slicer not found." << endl;
       m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
       break;
   }
+  return NULL;
 }
 
 
-void cPopulation::FindEmptyCell(tList<cPopulationCell> & cell_list,
-                                tList<cPopulationCell> & found_list)
+void cPopulation::BuildTiles()
 {
-  tListIterator<cPopulationCell> cell_it(cell_list);
-  cPopulationCell * test_cell;
+  delete m_tiles;
+  m_tiles = NULL;
+  
+  const int num_threads = m_world->GetConfig().UPDATE_THREADS.Get();
+  if (num_threads == 0) return;
+  
+  // Deme parallel execution already covers every organism each update
+  if (m_deme_parallel) {
+    m_world->GetDriver().Feedback().Warning("UPDATE_THREADS is ignored when DEME_THREADS is in use.");
+    return;
+  }
+  
+  // Pre-execution is consumed by ProcessStepSpeculative, so it is only available where speculation is
+  if (!m_world->GetConfig().SPECULATIVE.Get()) {
+    m_world->GetDriver().Feedback().Warning("UPDATE_THREADS requires SPECULATIVE, running serially.");
+    return;
+  }
+  
+  m_tiles = new cPopulationTiles(m_world, this, num_threads, m_world->GetConfig().UPDATE_TILE_SIZE.Get(), SPECULATIVE_DEPTH);
+  PlaceOnNodes();
+}
+
+
+void cPopulation::BuildDemeParallel()
+{
+  delete m_deme_parallel;
+  m_deme_parallel = NULL;
+  
+  const int num_threads = m_world->GetConfig().DEME_THREADS.Get();
+  if (num_threads == 0) return;
+  
+  if (GetNumDemes() < 2) {
+    m_world->GetDriver().Feedback().Warning("DEME_THREADS requires NUM_DEMES > 1, running serially.");
+    return;
+  }
+  
+  // Global resources are shared by every deme, so demes are only independent when all resources are deme resources
+  if (resource_count.GetSize() > 0) {
+    m_world->GetDriver().Feedback().Warning("DEME_THREADS requires all resources to be deme resources, running serially.");
+    return;
+  }
   
-  while ( (test_cell = cell_it.Next()) != NULL) {
+  m_deme_parallel = new cDemeParallel(m_world, this, num_threads, &m_step_time);
+  
+  // Hand the current schedule to the new deme schedulers
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    if (m_cell_priority[i] > 0.0) m_deme_parallel->AdjustPriority(cell_array[i].GetDemeID(), i, m_cell_priority[i]);
+  }
+  PlaceOnNodes();
+}
+
+
+void cPopulation::PlaceOnNodes()
+{
+  const cNUMAPlacement* numa = NULL;
+  Apto::Array<int> cell_node;
+  if (m_deme_parallel && m_deme_parallel->GetNUMA()) {
+    numa = m_deme_parallel->GetNUMA();
+    m_deme_parallel->GetCellNodes(cell_node);
+  } else if (m_tiles && m_tiles->GetNUMA()) {
+    numa = m_tiles->GetNUMA();
+    m_tiles->GetCellNodes(cell_node);
+  }
+  if (!numa || cell_array.GetSize() == 0) return;
+  
+  numa->BindArray(&cell_array[0], cell_node);
+  resource_count.PlaceOnNodes(*numa, cell_node);
+  
+  // Deme resource grids are indexed by the cells of their deme, which all belong to one node
+  for (int deme_id = 0; deme_id < deme_array.GetSize(); deme_id++) {
+    cDeme& deme = deme_array[deme_id];
+    if (deme.GetSize() == 0) continue;
+    Apto::Array<int> deme_node(deme.GetSize());
+    deme_node.SetAll(cell_node[deme.GetCellID(0)]);
+    deme.GetDemeResources().PlaceOnNodes(*numa, deme_node);
+  }
+}
+
+
+/* Sort the resources by the part they play in MoveOrganisms */
+
+void cPopulation::BuildMoveResources()
+{
+  const cResourceLib& resource_lib = environment.GetResourceLib();
+  m_move_res.path.Resize(0);
+  m_move_res.hammer.Resize(0);
+  m_move_res.hazard.Resize(0);
+  m_move_res.resistant.Resize(0);
+  m_move_res.barrier.Resize(0);
+  m_move_res.wall.Resize(0);
+  
+  for (int i = 0; i < resource_lib.GetSize(); i++) {
+    cResource* res = resource_lib.GetResource(i);
+    if (environment.HasPath() && res->IsPath()) m_move_res.path.Push(i);
+    if (environment.HasHammer() && res->IsHammer()) m_move_res.hammer.Push(i);
+    if (res->IsPredatory() || res->IsDeadly() || res->GetDamage()) m_move_res.hazard.Push(i);
+    if (res->IsPath()) continue;
+    if (res->GetResistance() > 1.0) m_move_res.resistant.Push(i);
+    if (res->GetHabitat() == 2) {
+      m_move_res.barrier.Push(i);
+      if (res->GetResistance() != 0) m_move_res.wall.Push(i);
+    }
+  }
+}
+
+void cPopulation::BuildResourcePool()
+{
+  resource_count.SetUpdatePool(NULL);
+  delete m_res_pool;
+  m_res_pool = NULL;
+  
+  const int num_threads = m_world->GetConfig().RESOURCE_THREADS.Get();
+  if (num_threads == 0) return;
+  
+  m_res_pool = new cResourceUpdatePool(m_world, resource_count.GetSize(), num_threads);
+  resource_count.SetUpdatePool(m_res_pool);
+}
+
+
+void cPopulation::FindEmptyCell(const cConnectionList& cell_list,
+                                tList<cPopulationCell> & found_list)
+{
+  for (int i = 0; i < cell_list.GetSize(); i++) {
+    cPopulationCell* test_cell = cell_list.GetPos(i);
     // If this cell is empty, add it to the list...
     if (test_cell->IsOccupied() == false) found_list.Push(test_cell);
   }
@@ -7556,9 +8384,7 @@ void cPopulation::SerialTransfer(int transfer_size, bool ignore_deads, cAvidaCon
   // Collect a vector of the occupied cells...
   vector<int> transfer_pool;
   transfer_pool.reserve(num_organisms);
-  for (int i = 0; i < GetSize(); i++) {
-    if (cell_array[i].IsOccupied()) transfer_pool.push_back(i);
-  }
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) transfer_pool.push_back(i);
   
   // Remove the proper number of cells.
   const int removal_size = num_organisms - transfer_size;
@@ -7594,10 +8420,8 @@ void cPopulation::PrintPhenotypeData(const cString& filename)
   Apto::Array<int> phenotypes;
   Apto::Array<int> phenotype_counts;
   
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
-    
+  // Only look at cells with organisms in them.
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) {
     num_orgs++;
     const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
     
@@ -7670,10 +8494,9 @@ void cPopulation::PrintPhenotypeStatus(const cString& filename)
   
   cString comment;
   
-  for (int i = 0; i < cell_array.GetSize(); i++)
+  // Only look at cells with organisms in them.
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1))
   {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
     
     const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
     
@@ -7718,10 +8541,8 @@ void cPopulation::PrintHostPhenotypeData(const cString& filename)
   Apto::Array<int> phenotypes;
   Apto::Array<int> phenotype_counts;
   
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
-    
+  // Only look at cells with organisms in them.
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) {
     num_orgs++;
     const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
     
@@ -7796,10 +8617,8 @@ void cPopulation::PrintParasitePhenotypeData(const cString& filename)
   Apto::Array<int> phenotypes;
   Apto::Array<int> phenotype_counts;
   
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
-    
+  // Only look at cells with organisms in them.
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) {
     num_orgs++;
     const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
     
@@ -7906,7 +8725,9 @@ void cPopulation::NewTrial(cAvidaContext& ctx)
         p.SetTrialTimeUsed(p.GetTrialTimeUsed() - cell.GetSpeculativeState());
         p.SetTimeUsed(p.GetTimeUsed() - cell.GetSpeculativeState());
         
+        if (deme_array.GetSize() > 0) deme_array[cell.GetDemeID()].RemoveOrgTotals(p);
         cell.GetOrganism()->NewTrial();
+        if (deme_array.GetSize() > 0) deme_array[cell.GetDemeID()].AddOrgTotals(p);
         cell.GetOrganism()->GetHardware().Reset(ctx);
         
         cell.SetSpeculativeState(0);
@@ -7953,22 +8774,24 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
   if (competition_type==3) dynamic_scaling = 1;
   else if  (competition_type==4) dynamic_scaling = 2;
   
+  // The competing organisms, in cell order; every statistic below walks this list instead of the whole population
+  Apto::Array<int> competitors;
+  for (int i = m_occupancy.NextOccupied(0); i != -1; i = m_occupancy.NextOccupied(i + 1)) competitors.Push(i);
+  
   // How many trials were there? -- same for every organism
   // we just need to find one...
-  for (int i = 0; i < num_cells; i++) {
-    if (GetCell(i).IsOccupied()) {
-      cPhenotype& p = GetCell(i).GetOrganism()->GetPhenotype();
-      // We trigger a lot of asserts if the copied size is zero...
-      p.SetLinesCopied(p.GetGenomeLength());
-      
-      if ( (num_trials != -1) && (num_trials != p.GetTrialFitnesses().GetSize()) ) {
-        cout << "The number of trials is not the same for every organism in the population.\n";
-        cout << "You need to remove all normal ways of replicating for CompeteOrganisms to work correctly.\n";
-        exit(1);
-      }
-      
-      num_trials = p.GetTrialFitnesses().GetSize();
+  for (int c = 0; c < competitors.GetSize(); c++) {
+    cPhenotype& p = GetCell(competitors[c]).GetOrganism()->GetPhenotype();
+    // We trigger a lot of asserts if the copied size is zero...
+    p.SetLinesCopied(p.GetGenomeLength());
+    
+    if ( (num_trials != -1) && (num_trials != p.GetTrialFitnesses().GetSize()) ) {
+      cout << "The number of trials is not the same for every organism in the population.\n";
+      cout << "You need to remove all normal ways of replicating for CompeteOrganisms to work correctly.\n";
+      exit(1);
     }
+    
+    num_trials = p.GetTrialFitnesses().GetSize();
   }
   
   // If there weren't any trials then end here (but call new trial so things are set up for the next iteration)
@@ -7983,22 +8806,20 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
   
   bool init = false;
   // What is the min and max fitness in each trial
-  for (int i = 0; i < num_cells; i++) {
-    if (GetCell(i).IsOccupied()) {
-      num_competed_orgs++;
-      cPhenotype& p = GetCell(i).GetOrganism()->GetPhenotype();
-      Apto::Array<double> trial_fitnesses = p.GetTrialFitnesses();
-      for (int t=0; t < num_trials; t++) {
-        if ((!init) || (min_trial_fitnesses[t] > trial_fitnesses[t])) {
-          min_trial_fitnesses[t] = trial_fitnesses[t];
-        }
-        if ((!init) || (max_trial_fitnesses[t] < trial_fitnesses[t])) {
-          max_trial_fitnesses[t] = trial_fitnesses[t];
-        }
-        avg_trial_fitnesses[t] += trial_fitnesses[t];
+  for (int c = 0; c < competitors.GetSize(); c++) {
+    num_competed_orgs++;
+    cPhenotype& p = GetCell(competitors[c]).GetOrganism()->GetPhenotype();
+    const Apto::Array<double>& trial_fitnesses = p.GetTrialFitnesses();
+    for (int t=0; t < num_trials; t++) {
+      if ((!init) || (min_trial_fitnesses[t] > trial_fitnesses[t])) {
+        min_trial_fitnesses[t] = trial_fitnesses[t];
+      }
+      if ((!init) || (max_trial_fitnesses[t] < trial_fitnesses[t])) {
+        max_trial_fitnesses[t] = trial_fitnesses[t];
       }
-      init = true;
+      avg_trial_fitnesses[t] += trial_fitnesses[t];
     }
+    init = true;
   }
   
   //divide averages for each trial
@@ -8015,73 +8836,75 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
   }
   
   bool using_trials = true;
-  for (int i = 0; i < num_cells; i++) {
-    if (GetCell(i).IsOccupied()) {
-      double fitness = 0.0;
-      cPhenotype& p = GetCell(i).GetOrganism()->GetPhenotype();
-      //Don't need to reset trial_fitnesses because we will call cPhenotype::OffspringReset on the entire pop
-      Apto::Array<double> trial_fitnesses = p.GetTrialFitnesses();
-      
-      //If there are no trial fitnesses...use the actual fitness.
-      if (trial_fitnesses.GetSize() == 0) {
-        using_trials = false;
-        trial_fitnesses.Push(p.GetFitness());
-      }
-      switch (competition_type) {
-          //Geometric Mean
-        case 0:
-        case 3:
-        case 4:
-          //Treat as logs to avoid overflow when multiplying very large fitnesses
-          fitness = 0;
-          for (int t=0; t < trial_fitnesses.GetSize(); t++) {
-            fitness += log(trial_fitnesses[t]);
-          }
-          fitness /= (double)trial_fitnesses.GetSize();
-          fitness = exp( fitness );
-          break;
-          
-          //Product
-        case 5:
-          //Treat as logs to avoid overflow when multiplying very large fitnesses
-          fitness = 0;
-          for (int t=0; t < trial_fitnesses.GetSize(); t++) {
-            fitness += log(trial_fitnesses[t]);
-          }
-          fitness = exp( fitness );
-          break;
-          
-          //Geometric Mean of normalized values
-        case 1:
-          fitness = 1.0;
-          for (int t=0; t < trial_fitnesses.GetSize(); t++) {
-            fitness*=trial_fitnesses[t] / max_trial_fitnesses[t];
-          }
-          fitness = exp( (1.0/((double)trial_fitnesses.GetSize())) * log(fitness) );
-          break;
-          
-          //Arithmetic Mean
-        case 2:
-          fitness = 0;
-          for (int t=0; t < trial_fitnesses.GetSize(); t++) {
-            fitness+=trial_fitnesses[t];
-          }
-          fitness /= (double)trial_fitnesses.GetSize();
-          break;
-          
-        default:
-          ctx.Driver().Feedback().Error("Unknown CompeteOrganisms method");
-          ctx.Driver().Abort(Avida::INVALID_CONFIG);
-      }
-      if (m_world->GetVerbosity() >= VERBOSE_DETAILS) {
-        cout << "Trial fitness in cell " << i << " = " << fitness << endl;
-      }
-      org_fitness[i] = fitness;
-      total_fitness += fitness;
-      
-      if ((highest_fitness == -1.0) || (fitness > highest_fitness)) highest_fitness = fitness;
-      if ((lowest_fitness == -1.0) || (fitness < lowest_fitness)) lowest_fitness = fitness;
-    } // end if occupied
+  Apto::Array<double> actual_fitness(1);
+  for (int c = 0; c < competitors.GetSize(); c++) {
+    const int i = competitors[c];
+    double fitness = 0.0;
+    cPhenotype& p = GetCell(i).GetOrganism()->GetPhenotype();
+    //Don't need to reset trial_fitnesses because we will call cPhenotype::OffspringReset on the entire pop
+    const Apto::Array<double>* trial_list = &p.GetTrialFitnesses();
+    
+    //If there are no trial fitnesses...use the actual fitness.
+    if (trial_list->GetSize() == 0) {
+      using_trials = false;
+      actual_fitness[0] = p.GetFitness();
+      trial_list = &actual_fitness;
+    }
+    const Apto::Array<double>& trial_fitnesses = *trial_list;
+    switch (competition_type) {
+        //Geometric Mean
+      case 0:
+      case 3:
+      case 4:
+        //Treat as logs to avoid overflow when multiplying very large fitnesses
+        fitness = 0;
+        for (int t=0; t < trial_fitnesses.GetSize(); t++) {
+          fitness += log(trial_fitnesses[t]);
+        }
+        fitness /= (double)trial_fitnesses.GetSize();
+        fitness = exp( fitness );
+        break;
+        
+        //Product
+      case 5:
+        //Treat as logs to avoid overflow when multiplying very large fitnesses
+        fitness = 0;
+        for (int t=0; t < trial_fitnesses.GetSize(); t++) {
+          fitness += log(trial_fitnesses[t]);
+        }
+        fitness = exp( fitness );
+        break;
+        
+        //Geometric Mean of normalized values
+      case 1:
+        fitness = 1.0;
+        for (int t=0; t < trial_fitnesses.GetSize(); t++) {
+          fitness*=trial_fitnesses[t] / max_trial_fitnesses[t];
+        }
+        fitness = exp( (1.0/((double)trial_fitnesses.GetSize())) * log(fitness) );
+        break;
+        
+        //Arithmetic Mean
+      case 2:
+        fitness = 0;
+        for (int t=0; t < trial_fitnesses.GetSize(); t++) {
+          fitness+=trial_fitnesses[t];
+        }
+        fitness /= (double)trial_fitnesses.GetSize();
+        break;
+        
+      default:
+        ctx.Driver().Feedback().Error("Unknown CompeteOrganisms method");
+        ctx.Driver().Abort(Avida::INVALID_CONFIG);
+    }
+    if (m_world->GetVerbosity() >= VERBOSE_DETAILS) {
+      cout << "Trial fitness in cell " << i << " = " << fitness << endl;
+    }
+    org_fitness[i] = fitness;
+    total_fitness += fitness;
+    
+    if ((highest_fitness == -1.0) || (fitness > highest_fitness)) highest_fitness = fitness;
+    if ((lowest_fitness == -1.0) || (fitness < lowest_fitness)) lowest_fitness = fitness;
   }
   average_fitness = total_fitness / num_competed_orgs;
   
@@ -8093,11 +8916,9 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
     }
     
     total_fitness = 0;
-    for (int i = 0; i < num_cells; i++) {
-      if ( GetCell(i).IsOccupied() ) {
-        org_fitness[i] *= dynamic_factor;
-        total_fitness += org_fitness[i];
-      }
+    for (int c = 0; c < competitors.GetSize(); c++) {
+      org_fitness[competitors[c]] *= dynamic_factor;
+      total_fitness += org_fitness[competitors[c]];
     }
   }
   
@@ -8105,10 +8926,10 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
   else if ( dynamic_scaling == 2 ) {
     int num_org = 0;
     double dynamic_factor = 1.0;
-    for (int i = 0; i < num_cells; i++) {
-      if ( GetCell(i).IsOccupied() && (org_fitness[i] > 0.0)) {
+    for (int c = 0; c < competitors.GetSize(); c++) {
+      if (org_fitness[competitors[c]] > 0.0) {
         num_org++;
-        dynamic_factor += log(org_fitness[i]);
+        dynamic_factor += log(org_fitness[competitors[c]]);
       }
     }
     
@@ -8118,30 +8939,23 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
     
     total_fitness = 0;
     
-    for (int i = 0; i < num_cells; i++) {
-      if ( GetCell(i).IsOccupied() ) {
-        org_fitness[i] /= dynamic_factor;
-        total_fitness += org_fitness[i];
-      }
+    for (int c = 0; c < competitors.GetSize(); c++) {
+      org_fitness[competitors[c]] /= dynamic_factor;
+      total_fitness += org_fitness[competitors[c]];
     }
   }
   
   // Pick which orgs should be in the next generation. (Filling all cells)
   Apto::Array<int> new_orgs(num_cells);
+  cWeightedIndex org_choice(num_cells);
+  for (int i = 0; i < num_cells; i++) org_choice.SetWeight(i, GetCell(i).IsOccupied() ? org_fitness[i] : 0.0);
   for (int i = 0; i < num_cells; i++) {
-    double birth_choice = (double) ctx.GetRandom().GetDouble(total_fitness);
-    double test_total = 0;
-    for (int test_org = 0; test_org < num_cells; test_org++) {
-      test_total += org_fitness[test_org];
-      if (birth_choice < test_total) {
-        new_orgs[i] = test_org;
-        if (m_world->GetVerbosity() >= VERBOSE_DETAILS) cout << "Propagating from cell " << test_org << " to " << i << endl;
-        if ((highest_fitness_copied == -1.0) || (org_fitness[test_org] > highest_fitness_copied)) highest_fitness_copied = org_fitness[test_org];
-        if ((lowest_fitness_copied == -1.0) || (org_fitness[test_org] < lowest_fitness_copied)) lowest_fitness_copied = org_fitness[test_org];
-        average_fitness_copied += org_fitness[test_org];
-        break;
-      }
-    }
+    const int test_org = org_choice.FindAliasPosition(ctx.GetRandom().GetDouble());
+    new_orgs[i] = test_org;
+    if (m_world->GetVerbosity() >= VERBOSE_DETAILS) cout << "Propagating from cell " << test_org << " to " << i << endl;
+    if ((highest_fitness_copied == -1.0) || (org_fitness[test_org] > highest_fitness_copied)) highest_fitness_copied = org_fitness[test_org];
+    if ((lowest_fitness_copied == -1.0) || (org_fitness[test_org] < lowest_fitness_copied)) lowest_fitness_copied = org_fitness[test_org];
+    average_fitness_copied += org_fitness[test_org];
   }
   // average assumes we fill all cells.
   average_fitness_copied /= num_cells;
@@ -8164,6 +8978,7 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
       cPhenotype& p = GetCell(i).GetOrganism()->GetPhenotype();
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(GetCell(i).GetOrganism()->GetGenome().Representation());
+      if (deme_array.GetSize() > 0) deme_array[GetCell(i).GetDemeID()].RemoveOrgTotals(p);
       if (using_trials)
       {
         p.TrialDivideReset(*seq);
@@ -8173,6 +8988,7 @@ void cPopulation::CompeteOrganisms(cAvidaContext& ctx, int competition_type, int
         //TrialReset has never been called so we need the entire routine to make "last" of "cur" stats.
         p.DivideReset(*seq);
       }
+      if (deme_array.GetSize() > 0) deme_array[GetCell(i).GetDemeID()].AddOrgTotals(p);
     }
   }
   
@@ -8375,6 +9191,7 @@ void cPopulation::SetPredatoryResource(const cString res_name, const double odds
       resource_count.SetPredatoryResource(global_res_index, odds, juvsper);
     }
   }
+  BuildMoveResources();
 }
 
 void cPopulation::SetProbabilisticResource(cAvidaContext& ctx, const cString res_name, const double initial, const double inflow,
@@ -8600,6 +9417,7 @@ void cPopulation::UpdateResourceCount(const int Verbosity, cWorld* world) {
                            res->GetDeathOdds(), res->IsPath(), res->IsHammer(),
                            res->GetInitialPlatVal(), res->GetThreshold(), res->GetRefuge(), res->GetGradient()
                            ); 
+      resource_count.SetSpatialInterval(global_res_index, res->GetSpatialInterval(), res->GetFlowTolerance());
       
     } else if (res->GetDemeResource()) {
       deme_res_index++;
@@ -8613,6 +9431,11 @@ void cPopulation::UpdateResourceCount(const int Verbosity, cWorld* world) {
     }
   }
   
+  // The set of resources may have changed, give each one its own stream again (and recheck that demes are independent)
+  if (m_deme_parallel) BuildDemeParallel();
+  else PlaceOnNodes();
+  BuildResourcePool();
+  BuildMoveResources();
 }
 
 // Adds an organism to live org list  
@@ -8635,47 +9458,48 @@ void  cPopulation::RemoveLiveOrg(cOrganism* org)
 // Adds an organism to a group
 void  cPopulation::JoinGroup(cOrganism* org, int group_id)
 {
-  map<int,int>::iterator it;
-  it=m_groups.find(group_id);
-  if (it == m_groups.end()) {
-    // new group
-    m_groups[group_id] = 0;
-    Apto::Array<cOrganism*, Apto::Smart> temp;
-    m_group_list.Set(group_id, temp);
-    // If tolerance is on, create the new group's tolerance cache
-    if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
-      Apto::Array<pair<int,int> > temp_array(2);
-      temp_array[0] = make_pair(-1, -1);
-      temp_array[1] = make_pair(-1, -1);
-      m_group_intolerances.Set(group_id, temp_array);
-      if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-        m_group_intolerances_females.Set(group_id, temp_array);
-        m_group_intolerances_males.Set(group_id, temp_array);
-        m_group_intolerances_juvs.Set(group_id, temp_array);
-      }
+  sGroup* group = findGroup(group_id);
+  if (!group) {
+    // new group, reusing the slot of a removed one where possible
+    int slot = m_group_array.GetSize();
+    if (m_free_group_slots.GetSize()) {
+      slot = m_free_group_slots.Pop();
+    } else {
+      m_group_array.Resize(slot + 1);
+    }
+    m_group_slots[group_id] = slot;
+    group = &m_group_array[slot];
+    group->num_orgs = 0;
+    group->num_females = 0;
+    group->num_males = 0;
+    group->members.Resize(0);
+    // Tolerance caches start out of date
+    for (int i = 0; i < 4; i++) {
+      group->intolerances[i][0] = make_pair(-1, -1);
+      group->intolerances[i][1] = make_pair(-1, -1);
     }
   }
   // add to group
-  m_groups[group_id]++;
-  if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) m_group_females[group_id]++;
-  else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) m_group_males[group_id]++;
+  group->num_orgs++;
+  if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) group->num_females++;
+  else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) group->num_males++;
   
-  m_group_list[group_id].Push(org);
+  group->members.Push(org);
   // If tolerance is on, must add the organism's intolerance to the group cache
   if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
     int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
     int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-    m_group_intolerances[group_id][0].second += tol_max - immigrant_tol;
+    group->intolerances[0][0].second += tol_max - immigrant_tol;
     if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
       if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-        m_group_intolerances_females[group_id][0].second += tol_max - immigrant_tol;
+        group->intolerances[1][0].second += tol_max - immigrant_tol;
       } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-        m_group_intolerances_males[group_id][0].second += tol_max - immigrant_tol;
+        group->intolerances[2][0].second += tol_max - immigrant_tol;
       } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) { 
-        m_group_intolerances_juvs[group_id][0].second += tol_max - immigrant_tol;
+        group->intolerances[3][0].second += tol_max - immigrant_tol;
       }
     }
-    m_group_intolerances[group_id][1].second += tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
+    group->intolerances[0][1].second += tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
   }
 }
 
@@ -8685,8 +9509,8 @@ void cPopulation::MakeGroup(cOrganism* org)
   if (m_world->GetConfig().USE_FORM_GROUPS.Get() != 1) return;
   
   int highest_group;
-  if (m_groups.size() > 0) {
-    highest_group = m_groups.rbegin()->first;
+  if (m_group_slots.size() > 0) {
+    highest_group = m_group_slots.rbegin()->first;
   } else {
     highest_group = -1;
   }
@@ -8698,196 +9522,161 @@ void cPopulation::MakeGroup(cOrganism* org)
 // Removes an organism from a group
 void  cPopulation::LeaveGroup(cOrganism* org, int group_id)
 {
-  map<int,int>::iterator it = m_groups.find(group_id);
-  if (it != m_groups.end()) {
-    m_groups[group_id]--;
-    if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) m_group_females[group_id]--;
-    else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) m_group_males[group_id]--;
-    
-    // If no restrictions on group ids,
-    // removes empty groups so the number of total groups being tracked doesn't become excessive
-    // (Removes the highest group even if empty, causes misstep in marching groups). 
-    if (m_world->GetConfig().USE_FORM_GROUPS.Get() == 1) {
-      if (m_groups[group_id] <= 0) {
-        m_groups.erase(group_id);
-      }
-    }
-  }
+  sGroup* group = findGroup(group_id);
+  if (!group) return;
+  
+  group->num_orgs--;
+  if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) group->num_females--;
+  else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) group->num_males--;
 
   // If tolerance is on, remove the organim's intolerance from the group's cache
   if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) { 
     int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
     int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-    m_group_intolerances[group_id][0].second -= tol_max - immigrant_tol;
+    group->intolerances[0][0].second -= tol_max - immigrant_tol;
     if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
       if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-        m_group_intolerances_females[group_id][0].second -= tol_max - immigrant_tol;
+        group->intolerances[1][0].second -= tol_max - immigrant_tol;
       } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-        m_group_intolerances_males[group_id][0].second -= tol_max - immigrant_tol;
+        group->intolerances[2][0].second -= tol_max - immigrant_tol;
       } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) { 
-        m_group_intolerances_juvs[group_id][0].second -= tol_max - immigrant_tol; 
+        group->intolerances[3][0].second -= tol_max - immigrant_tol; 
       }
     }
-    m_group_intolerances[group_id][1].second -= tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
+    group->intolerances[0][1].second -= tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
   }
   
-  for (int i = 0; i < m_group_list[group_id].GetSize(); i++) {
-    if (m_group_list[group_id][i] == org) {
-      unsigned int last = m_group_list[group_id].GetSize() - 1;
-      m_group_list[group_id].Swap(i,last);
-      m_group_list[group_id].Pop();
-      // If no restrictions, removes empty groups. 
-      if (m_world->GetConfig().USE_FORM_GROUPS.Get() == 1) {
-        if (m_group_list[group_id].GetSize() <= 0) {
-          m_group_list.Remove(group_id);
-        }
-      }
+  Apto::Array<cOrganism*, Apto::Smart>& members = group->members;
+  for (int i = 0; i < members.GetSize(); i++) {
+    if (members[i] == org) {
+      members.Swap(i, members.GetSize() - 1);
+      members.Pop();
       break;
     }
   }
+  
+  // If no restrictions on group ids,
+  // removes empty groups so the number of total groups being tracked doesn't become excessive
+  // (Removes the highest group even if empty, causes misstep in marching groups). 
+  if (m_world->GetConfig().USE_FORM_GROUPS.Get() == 1 && group->num_orgs <= 0) {
+    std::map<int, int>::iterator it = m_group_slots.find(group_id);
+    group->members.Resize(0);
+    m_free_group_slots.Push(it->second);
+    m_group_slots.erase(it);
+  }
 }
 
 // Identifies the number of organisms in a group
 int  cPopulation::NumberOfOrganismsInGroup(int group_id)
 {
-  map<int,int>::iterator it;
-  it=m_groups.find(group_id);
-  int num_orgs = 0;
-  if (it != m_groups.end()) {
-    num_orgs = m_groups[group_id];
-  }
-  return num_orgs;
+  sGroup* group = findGroup(group_id);
+  return (group) ? group->num_orgs : 0;
 }
 
 int  cPopulation::NumberGroupFemales(int group_id)
 {
-  map<int,int>::iterator it;
-  it=m_groups.find(group_id);
-  int num_orgs = 0;
-  if (it != m_groups.end()) {
-    num_orgs = m_group_females[group_id];
-  }
-  return num_orgs;
+  sGroup* group = findGroup(group_id);
+  return (group) ? group->num_females : 0;
 }
 
 int  cPopulation::NumberGroupMales(int group_id)
 {
-  map<int,int>::iterator it;
-  it=m_groups.find(group_id);
-  int num_orgs = 0;
-  if (it != m_groups.end()) {
-    num_orgs = m_group_males[group_id];
-  }
-  return num_orgs;
+  sGroup* group = findGroup(group_id);
+  return (group) ? group->num_males : 0;
 }
 
 int  cPopulation::NumberGroupJuvs(int group_id)
 {
-  map<int,int>::iterator it;
-  it=m_groups.find(group_id);
-  int num_males = 0;
-  int num_females = 0;
-  int tot_orgs = 0;
-  if (it != m_groups.end()) {
-    num_males = m_group_males[group_id];
-    num_females = m_group_females[group_id];
-    tot_orgs = m_groups[group_id];
-  }
-  return tot_orgs - (num_males + num_females);
+  sGroup* group = findGroup(group_id);
+  return (group) ? group->num_orgs - (group->num_males + group->num_females) : 0;
 }
 
 void  cPopulation::ChangeGroupMatingTypes(cOrganism* org, int group_id, int old_type, int new_type)
 {
   if (old_type == new_type) return;
   
-  if (old_type == 0) m_group_females[group_id]--;
-  else if (old_type == 1) m_group_males[group_id]--;
+  sGroup* group = findGroup(group_id);
+  if (!group) return;
   
-  if (new_type == 0) m_group_females[group_id]++;
-  else if (new_type == 1) m_group_males[group_id]++;   
+  if (old_type == 0) group->num_females--;
+  else if (old_type == 1) group->num_males--;
+  
+  if (new_type == 0) group->num_females++;
+  else if (new_type == 1) group->num_males++;   
   
   if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) { 
     if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
       int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
       int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-      // remove from old
-      if (old_type == 0) {
-        m_group_intolerances_females[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (old_type == 1) {
-        m_group_intolerances_males[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (old_type == 2) {
-        m_group_intolerances_juvs[group_id][0].second -= tol_max - immigrant_tol;   
-      }
-      // add to new
-      if (new_type == 0) {
-        m_group_intolerances_females[group_id][0].second += tol_max - immigrant_tol;
-      } else if (new_type == 1) {
-        m_group_intolerances_males[group_id][0].second += tol_max - immigrant_tol;
-      } else if (new_type == 2) {
-        m_group_intolerances_juvs[group_id][0].second += tol_max - immigrant_tol;      
-      }
+      // remove from old, add to new
+      if (old_type >= 0 && old_type <= 2) group->intolerances[old_type + 1][0].second -= tol_max - immigrant_tol;
+      if (new_type >= 0 && new_type <= 2) group->intolerances[new_type + 1][0].second += tol_max - immigrant_tol;
     }
   }
 }
 
+// Members of a group, empty if the group has not been formed
+const Apto::Array<cOrganism*, Apto::Smart>& cPopulation::groupMembers(int group_id)
+{
+  static const Apto::Array<cOrganism*, Apto::Smart> no_members;
+  sGroup* group = findGroup(group_id);
+  return (group) ? group->members : no_members;
+}
+
+// Summed intolerance of the group members towards offspring, rebuilt from the members at most once per update
+int cPopulation::groupOffspringIntolerance(sGroup& group)
+{
+  int cur_update = m_world->GetStats().GetUpdate();
+  pair<int,int>& cache = group.intolerances[0][1];
+  if (cache.first == cur_update) return cache.second;
+  
+  const int tolerance_max = m_world->GetConfig().MAX_TOLERANCE.Get();
+  int group_intolerance = 0;
+  for (int index = 0; index < group.members.GetSize(); index++) {
+    group_intolerance += tolerance_max - group.members[index]->GetPhenotype().CalcToleranceOffspringOthers();
+  }
+  cache.first = cur_update;
+  cache.second = group_intolerance;
+  return group_intolerance;
+}
+
 // Calculates group tolerance towards immigrants 
 int cPopulation::CalcGroupToleranceImmigrants(int group_id, int mating_type)
 {
   const int tolerance_max = m_world->GetConfig().MAX_TOLERANCE.Get();
   
   if (group_id < 0) return tolerance_max;
-  if (m_group_list[group_id].GetSize() <= 0) return tolerance_max;
+  sGroup* group = findGroup(group_id);
+  if (!group || group->members.GetSize() <= 0) return tolerance_max;
   
   // use cache, if up to date
-  int tol_update = m_group_intolerances[group_id][0].first;
-  int group_intol = m_group_intolerances[group_id][0].second;
-  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-    if (mating_type == 0) { 
-      tol_update = m_group_intolerances_females[group_id][0].first;
-      group_intol = m_group_intolerances_females[group_id][0].second;
-    } else if (mating_type == 1) { 
-      tol_update = m_group_intolerances_males[group_id][0].first;
-      group_intol = m_group_intolerances_males[group_id][0].second;
-    } else if (mating_type == 2) { 
-      tol_update = m_group_intolerances_juvs[group_id][0].first;
-      group_intol = m_group_intolerances_juvs[group_id][0].second;
-    }
-  }  
+  const int cache_type = (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2 && mating_type >= 0 && mating_type <= 2) ? mating_type + 1 : 0;
+  pair<int,int>& cache = group->intolerances[cache_type][0];
   int cur_update = m_world->GetStats().GetUpdate();
-  if (tol_update == cur_update) return max(0, tolerance_max - group_intol);
+  if (cache.first == cur_update) return max(0, tolerance_max - cache.second);
 
   // If can't use cache, sum the total group intolerance
+  const Apto::Array<cOrganism*, Apto::Smart>& members = group->members;
   int group_intolerance = 0;  
   int single_member_intolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
+  for (int index = 0; index < members.GetSize(); index++) {
     bool use_org = true;
     // if using immigrant only tolerance + sex, only update the cache for this current mating type
     if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-      if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_FEMALE)  use_org = false;
-      else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_MALE)  use_org = false;
-      else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_JUVENILE)  use_org = false;
+      if (mating_type == 0 && members[index]->GetPhenotype().GetMatingType() != MATING_TYPE_FEMALE)  use_org = false;
+      else if (mating_type == 1 && members[index]->GetPhenotype().GetMatingType() != MATING_TYPE_MALE)  use_org = false;
+      else if (mating_type == 2 && members[index]->GetPhenotype().GetMatingType() != MATING_TYPE_JUVENILE)  use_org = false;
     }
-    if (use_org) single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
+    if (use_org) single_member_intolerance = tolerance_max - members[index]->GetPhenotype().CalcToleranceImmigrants();
     group_intolerance += single_member_intolerance;
   }
   
   // Save current update and current intolerance to group cache
   // this is the only time we can do this since this is the only 
   // time we ever look at the entire group (updated every individual) or sub-group (by sex)
-  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() != 2) {
-    m_group_intolerances[group_id][0].first = cur_update;
-    m_group_intolerances[group_id][0].second = group_intolerance;
-  } else {
-    if (mating_type == 0) {
-      m_group_intolerances_females[group_id][0].first = cur_update;
-      m_group_intolerances_females[group_id][0].second = group_intolerance;      
-    } else if (mating_type == 1) {
-      m_group_intolerances_males[group_id][0].first = cur_update;
-      m_group_intolerances_males[group_id][0].second = group_intolerance;      
-    } else if (mating_type == 2) {
-      m_group_intolerances_juvs[group_id][0].first = cur_update;
-      m_group_intolerances_juvs[group_id][0].second = group_intolerance;      
-    }
+  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() != 2 || cache_type > 0) {
+    cache.first = cur_update;
+    cache.second = group_intolerance;
   }
   
   int group_tolerance = tolerance_max - group_intolerance;
@@ -8902,25 +9691,11 @@ int cPopulation::CalcGroupToleranceOffspring(cOrganism* parent_organism)
   int group_id = parent_organism->GetOpinion().first;
   
   if ((group_id < 0) || (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() > 0)) return tolerance_max;
-  if (m_group_list[group_id].GetSize() <= 0) return tolerance_max;
+  sGroup* group = findGroup(group_id);
+  if (!group || group->members.GetSize() <= 0) return tolerance_max;
   
-  int cur_update = m_world->GetStats().GetUpdate();
   int parent_intolerance = tolerance_max - parent_organism->GetPhenotype().CalcToleranceOffspringOthers();
-  
-  int group_intolerance = 0;
-  if (m_group_intolerances[group_id][1].first == cur_update) {
-    group_intolerance = m_group_intolerances[group_id][1].second;
-  } else {
-    int single_member_intolerance = 0;
-    // Sum the total group intolerance
-    for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-      single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-      group_intolerance += single_member_intolerance;
-    }
-    // Save current update and current intolerance to cache
-    m_group_intolerances[group_id][1].first = cur_update;
-    m_group_intolerances[group_id][1].second = group_intolerance;
-  }
+  int group_intolerance = groupOffspringIntolerance(*group);
   
   // Remove the parent intolerance
   group_intolerance -= parent_intolerance;
@@ -9007,16 +9782,8 @@ double cPopulation::CalcGroupOddsOffspring(int group_id)
   
   const int tolerance_max = m_world->GetConfig().MAX_TOLERANCE.Get();
   
-  int group_intolerance = 0;
-  int single_member_intolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-    group_intolerance += single_member_intolerance;
-    if (group_intolerance >= tolerance_max) {
-      group_intolerance = tolerance_max;
-      break;
-    }
-  }
+  sGroup* group = findGroup(group_id);
+  int group_intolerance = (group) ? min(groupOffspringIntolerance(*group), tolerance_max) : 0;
   
   int group_tolerance = tolerance_max - group_intolerance;
   double offspring_odds = (double) group_tolerance / (double) tolerance_max;
@@ -9078,7 +9845,7 @@ bool cPopulation::AttemptOffspringParentGroup(cAvidaContext& ctx, cOrganism* par
       // If there is nobody else in the group, the offspring gets in
       join_parent_group = true;
       // If there are others in the group, it's their turn
-      if (m_group_list[parent_group].GetSize() > 1) {
+      if (groupMembers(parent_group).GetSize() > 1) {
         if (rand2 <= prob_group_allows) {
           // Offspring successfully joins parent's group
           join_parent_group = true;                       
@@ -9112,7 +9879,7 @@ bool cPopulation::AttemptOffspringParentGroup(cAvidaContext& ctx, cOrganism* par
       } while (target_group == parent_group);
       
       // If there are no members currently of the target group, offspring has 100% chance of immigrating
-      if (m_group_list[target_group].GetSize() == 0) {
+      if (groupMembers(target_group).GetSize() == 0) {
         offspring->SetOpinion(target_group);
         JoinGroup(offspring, target_group);
         return true;
@@ -9141,18 +9908,19 @@ double cPopulation::CalcGroupAveImmigrants(int group_id, int mating_type)
 {
   cDoubleSum immigrant_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
     bool count_org = false;
     if (mating_type == -1) count_org = true;
-    else if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
+    else if (mating_type == 0 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
       count_org = true;
-    } else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
+    } else if (mating_type == 1 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
       count_org = true;
-    } else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
+    } else if (mating_type == 2 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
       count_org = true;
     }
     if (count_org) {
-      single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
+      single_member_tolerance = members[index]->GetPhenotype().CalcToleranceImmigrants();
       immigrant_tolerance.Add(single_member_tolerance);
     }
   }
@@ -9165,18 +9933,19 @@ double cPopulation::CalcGroupSDevImmigrants(int group_id, int mating_type)
 {
   cDoubleSum immigrant_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
     bool count_org = false;
     if (mating_type == -1) count_org = true;
-    else if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
+    else if (mating_type == 0 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
       count_org = true;
-    } else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
+    } else if (mating_type == 1 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
       count_org = true;
-    } else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
+    } else if (mating_type == 2 && members[index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
       count_org = true;
     }
     if (count_org) {
-      single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
+      single_member_tolerance = members[index]->GetPhenotype().CalcToleranceImmigrants();
       immigrant_tolerance.Add(single_member_tolerance);
     }
   }
@@ -9189,8 +9958,9 @@ double cPopulation::CalcGroupAveOwn(int group_id)
 {
   cDoubleSum own_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOwn();
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
+    single_member_tolerance = members[index]->GetPhenotype().CalcToleranceOffspringOwn();
     own_tolerance.Add(single_member_tolerance);
   }
   double aveown = own_tolerance.Average();
@@ -9202,8 +9972,9 @@ double cPopulation::CalcGroupSDevOwn(int group_id)
 {
   cDoubleSum own_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOwn();
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
+    single_member_tolerance = members[index]->GetPhenotype().CalcToleranceOffspringOwn();
     own_tolerance.Add(single_member_tolerance);
   }
   double sdevown = own_tolerance.StdDeviation();
@@ -9215,8 +9986,9 @@ double cPopulation::CalcGroupAveOthers(int group_id)
 {
   cDoubleSum others_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
+    single_member_tolerance = members[index]->GetPhenotype().CalcToleranceOffspringOthers();
     others_tolerance.Add(single_member_tolerance);
   }
   double aveothers = others_tolerance.Average();
@@ -9228,8 +10000,9 @@ double cPopulation::CalcGroupSDevOthers(int group_id)
 {
   cDoubleSum others_tolerance;
   int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
+  const Apto::Array<cOrganism*, Apto::Smart>& members = groupMembers(group_id);
+  for (int index = 0; index < members.GetSize(); index++) {
+    single_member_tolerance = members[index]->GetPhenotype().CalcToleranceOffspringOthers();
     others_tolerance.Add(single_member_tolerance);
   }
   double sdevothers = others_tolerance.StdDeviation();
@@ -9238,11 +10011,12 @@ double cPopulation::CalcGroupSDevOthers(int group_id)
 
 int& cPopulation::GetGroupIntolerances(int group_id, int tol_num, int mating_type)
 {
-  int& intolerance = m_group_intolerances[group_id][tol_num].second;
-  if (mating_type == 0) intolerance = m_group_intolerances_females[group_id][tol_num].second;
-  else if (mating_type == 1) intolerance = m_group_intolerances_males[group_id][tol_num].second;
-  else if (mating_type == 2) intolerance = m_group_intolerances_juvs[group_id][tol_num].second;
-  return intolerance;
+  sGroup* group = findGroup(group_id);
+  // Organisms outside of any formed group adjust a scratch value
+  static int no_group_intolerance;
+  if (!group) return (no_group_intolerance = 0);
+  const int cache_type = (mating_type >= 0 && mating_type <= 2) ? mating_type + 1 : 0;
+  return group->intolerances[cache_type][tol_num].second;
 }
 
 /*!	Modify current level of the HGT resource.
@@ -9274,19 +10048,52 @@ void cPopulation::MixPopulation(cAvidaContext& ctx)
     population[i] = cell_array[i].GetOrganism();
   }
   
+  // Organisms keep their ages, so their order is rebuilt for the cells they land in
+  std::vector<cOrganism*> eldest_first;
+  for (int cell_id = m_age_order.GetEldest(); cell_id != -1; cell_id = m_age_order.GetNext(cell_id)) {
+    eldest_first.push_back(cell_array[cell_id].GetOrganism());
+  }
+  
   // Shuffle them:
   std::random_shuffle(population.begin(), population.end(), ctx.GetRandom());
   
   // Reset the organism pointers of all cells:
   for(int i=0; i<cell_array.GetSize(); ++i) {
+    if (deme_array.GetSize() > 0 && cell_array[i].IsOccupied()) {
+      cDeme& deme = deme_array[cell_array[i].GetDemeID()];
+      deme.DecOrgCount();
+      deme.RemoveOrgTotals(cell_array[i].GetOrganism()->GetPhenotype());
+    }
+    if (deme_array.GetSize() > 0 && population[i]) {
+      cDeme& deme = deme_array[cell_array[i].GetDemeID()];
+      deme.IncOrgCount();
+      deme.AddOrgTotals(population[i]->GetPhenotype());
+    }
     cell_array[i].RemoveOrganism(ctx);
     if (population[i] == 0) {
       AdjustSchedule(cell_array[i], cMerit(0));
+      m_empty_cells.Insert(i);
+      m_forager_index.Remove(i);
+      m_neighbor_prey.SetPrey(i, false);
+      m_occupancy.Remove(i);
     } else {
       cell_array[i].InsertOrganism(population[i], ctx); 
       AdjustSchedule(cell_array[i], cell_array[i].GetOrganism()->GetPhenotype().GetMerit());
+      m_empty_cells.Remove(i);
+      m_forager_index.Insert(i, population[i]->IsPredFT());
+      m_neighbor_prey.SetPrey(i, population[i]->IsPreyFT());
+      m_occupancy.Insert(i, population[i]);
+      if (m_inst_count_totals.GetSize()) {
+        population[i]->GetPhenotype().DetachInstCountTotal();
+        attachInstCountTotal(population[i], cell_array[i].GetDemeID());
+      }
     }
   }
+  
+  m_age_order.Setup(cell_array.GetSize());
+  for (std::size_t i = 0; i < eldest_first.size(); i++) {
+    m_age_order.Insert(eldest_first[i]->GetCellID(), AgeStamp(eldest_first[i]));
+  }
 }
 
 int cPopulation::PlaceAvatar(cAvidaContext& ctx, cOrganism* parent)
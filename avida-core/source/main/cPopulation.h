@@ -26,9 +26,16 @@
 #include "avida/data/Provider.h"
 
 #include "cBirthChamber.h"
+#include "cCellAgeOrder.h"
+#include "cCellOccupancy.h"
+#include "cConnectionTable.h"
 #include "cDeme.h"
+#include "cEmptyCellIndex.h"
+#include "cForagerIndex.h"
+#include "cNeighborPreyCounts.h"
 #include "cOrgInterface.h"
 #include "cPopulationInterface.h"
+#include "cPopulationSnapshot.h"
 #include "cResourceCount.h"
 #include "cString.h"
 #include "cWorld.h"
@@ -40,10 +47,14 @@
 
 class cAvidaContext;
 class cCodeLabel;
+class cDemeParallel;
 class cEnvironment;
+class cFenwickScheduler;
 class cLineage;
 class cOrganism;
 class cPopulationCell;
+class cPopulationTiles;
+class cResourceUpdatePool;
 
 using namespace Avida;
 
@@ -66,21 +77,35 @@ private:
   // Components...
   cWorld* m_world;
   Apto::PriorityScheduler* m_scheduler;                // Handles allocation of CPU cycles
+  cFenwickScheduler* m_prob_scheduler;                 // m_scheduler when it is the merit proportional one, else NULL
+  cPopulationTiles* m_tiles;                           // Parallel speculative pre-execution (NULL when disabled)
+  cDemeParallel* m_deme_parallel;                      // Deme parallel execution (NULL when disabled)
+  cResourceUpdatePool* m_res_pool;                     // Parallel spatial resource updates (NULL when disabled)
+  int m_schedule_batch;                                // Consecutive cycles handed out per scheduling decision
+  int m_schedule_defer;                                // Nesting depth of deferred schedule adjustments
+  Apto::Array<int, Apto::Smart> m_schedule_deferred;   // Cells whose priority has not reached the scheduler yet
+  Apto::Array<bool> m_schedule_is_deferred;
   Apto::Array<cPopulationCell> cell_array;  // Local cells composing the population
-  Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
+  cConnectionTable m_connections;           // Neighbors of every cell, built by the topology code
+  Apto::Array<int> empty_cell_id_array;     // Scratch list of empty deme ids for deme replication
+  cEmptyCellIndex m_empty_cells;            // Empty cells, updated as cells are occupied and vacated
+  cCellAgeOrder m_age_order;                // Occupied cells, eldest occupant first, used by POP_CAP_ELDEST
+  int m_age_clock;                          // Number of times the ages of all organisms have been advanced
+  cForagerIndex m_forager_index;            // Occupied cells by forager type, used by the look instructions
+  cNeighborPreyCounts m_neighbor_prey;      // Prey around every cell, kept for predator confusion
+  cCellOccupancy m_occupancy;               // Occupant and scheduled merit of every cell, for whole population scans
+  cPopulationSnapshot m_snapshot;           // Occupied cells for print actions, rebuilt when the occupancy changes
+  Apto::Array<Apto::Array<int> > m_inst_count_totals;  // Summed last_inst_count per deme and instruction set, once enabled
+  Apto::Array<double> m_cell_priority;      // Priority each cell last handed the scheduler, to skip redundant updates
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
-  //Keeps track of which organisms are in which group.
-  Apto::Map<int, Apto::Array<cOrganism*, Apto::Smart> > m_group_list;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_females;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_males;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_juvs;
   
   // Keep list of live organisms
   Apto::Array<cOrganism*, Apto::Smart> live_org_list;
   
   Apto::Array<cPopulationOrgStatProviderPtr> m_org_stat_providers;
+  Apto::Array<int> m_stats_sample;  // sorted live_org_list indices of the organism statistics sample
+  Apto::Array<int> m_population_writers;  // process ids of background population saves still running
   
   
   Apto::Array<pair<int,int>, Apto::Smart>* sleep_log;
@@ -112,16 +137,39 @@ private:
   int num_top_pred_organisms;
   
   Apto::Array<cDeme> deme_array;            // Deme structure of the population.
+  double m_step_time;                       // Step time elapsed this update, pulled lazily by all resource counts
  
   // Outside interactions...
   bool sync_events;   // Do we need to sync up the event list with population?
 	
   // Group formation information
-  std::map<int, int> m_groups; //<! Maps the group id to the number of orgs in the group
-  std::map<int, int> m_group_females; //<! Maps the group id to the number of females in the group
-  std::map<int, int> m_group_males; //<! Maps the group id to the number of males in the group
+  struct sGroup
+  {
+    int num_orgs;
+    int num_females;
+    int num_males;
+    Apto::Array<cOrganism*, Apto::Smart> members;
+    // Cached (update, summed member intolerance), indexed [mating type + 1][0 = immigrants, 1 = offspring]
+    pair<int,int> intolerances[4][2];
+  };
+  Apto::Array<sGroup, Apto::Smart> m_group_array; //<! State of every formed group, reached through m_group_slots
+  std::map<int, int> m_group_slots; //<! Maps the group id to its slot in m_group_array, ordered by group id
+  Apto::Array<int> m_free_group_slots; //<! Slots of removed groups, reused by new groups
 
   int m_hgt_resid; //!< HGT resource ID.
+  
+  // Resources that take part in movement, by role and in resource order, so that a move only looks at the resources
+  // that can affect it.  Rebuilt whenever the resources, or their roles, change.
+  struct sMoveResources
+  {
+    Apto::Array<int> path;        // paths (only if the environment has paths)
+    Apto::Array<int> hammer;      // hammers (only if the environment has hammers)
+    Apto::Array<int> hazard;      // predatory, deadly or damaging resources
+    Apto::Array<int> resistant;   // non-path resources with a resistance above 1
+    Apto::Array<int> barrier;     // non-path barrier habitats
+    Apto::Array<int> wall;        // barriers with a non-zero resistance
+  };
+  sMoveResources m_move_res;
 
   cPopulation(); // @not_implemented
   cPopulation(const cPopulation&); // @not_implemented
@@ -150,6 +198,11 @@ public:
   
   void AttachOrgStatProvider(cPopulationOrgStatProviderPtr provider) { m_org_stat_providers.Push(provider); }
   
+  // Running totals of the last gestation instruction counts of all living organisms, maintained by the phenotypes
+  // from the first EnableInstCountTotals() on
+  void EnableInstCountTotals();
+  void GetInstCountTotals(int inst_set_id, Apto::Array<int>& totals) const;
+  
   void ResizeCellGrid(int x, int y);
     
   void InjectGenome(int cell_id, Systematics::Source src, const Genome& genome, cAvidaContext& ctx, int lineage_label = 0, bool assign_group = true, Systematics::RoleClassificationHints* hints = NULL);
@@ -171,6 +224,9 @@ public:
   // Deactivate an organism in the population (required for deactivations)
   void KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx); 
   void KillOrganism(cAvidaContext& ctx, int in_cell) { KillOrganism(cell_array[in_cell], ctx); } 
+  // Deactivate the organisms in a gathered list of cells, in list order, with one scheduler pass at the end.  Cells
+  // that are empty by the time they are reached are skipped.
+  void KillOrganisms(const Apto::Array<int, Apto::Smart>& cell_ids, cAvidaContext& ctx);
   void InjureOrg(cAvidaContext& ctx, cPopulationCell& in_cell, double injury, bool ding_reacs = true);
   
   // @WRE 2007/07/05 Helper function to take care of side effects of Avidian 
@@ -257,14 +313,30 @@ public:
 
   // Process a single organism one instruction...
   int ScheduleOrganism();          // Determine next organism to be processed.
+  int ScheduleOrganism(int& num_cycles); // ...and how many consecutive cycles it should receive.
+  void ScheduleOrganisms(int count, Apto::Array<int>& cell_ids); // Several independent draws at once.
+  int GetScheduleBatchSize() const { return m_schedule_batch; }
   void ProcessStep(cAvidaContext& ctx, double step_size, int cell_id);
+  int ProcessSteps(cAvidaContext& ctx, double step_size, int cell_id, int num_cycles);
   void ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id);
+  
+  // Speculatively pre-execute all tiles on the UPDATE_THREADS workers (only valid with ProcessStepSpeculative)
+  bool HasParallelTiles() const { return (m_tiles != NULL); }
+  void PreExecuteTiles();
+
+  // Execute a whole update with each deme running independently on the DEME_THREADS workers
+  bool HasParallelDemes() const { return (m_deme_parallel != NULL); }
+  void ProcessDemesParallel(int update_size);
+
+  // A new, empty scheduler of the configured SLICING_METHOD over num_entries entries
+  Apto::PriorityScheduler* CreateScheduler(int num_entries);
 
   // Calculate the statistics from the most recent update.
   void ProcessPostUpdate(cAvidaContext& ctx);
   void ProcessPreUpdate();
   void UpdateResStats(cAvidaContext& ctx);
   void ProcessUpdateCellActions(cAvidaContext& ctx);
+  void ProcessPointMutations(cAvidaContext& ctx);
 
   // Clear all but a subset of cells...
   void SerialTransfer(int transfer_size, bool ignore_deads, cAvidaContext& ctx); 
@@ -275,10 +347,15 @@ public:
 
   bool SavePopulation(const cString& filename, bool save_historic, bool save_group_info = false, bool save_avatars = false,
                       bool save_rebirth = false);
+  bool SavePopulationInBackground(const cString& filename, bool save_historic, bool save_group_info = false,
+                                  bool save_avatars = false, bool save_rebirth = false);
   bool SaveStructuredSystematicsGroup(const Systematics::RoleID& role, const cString& filename);
   bool LoadStructuredSystematicsGroup(cAvidaContext& ctx, const Systematics::RoleID& role, const cString& filename);
   bool LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset=0, int lineage_offset=0,
                       bool load_groups = false, bool load_birth_cells = false, bool load_avatars = false, bool load_rebirth = false, bool load_parent_dat = false, int traceq = 0);
+  bool SaveCheckpoint(const cString& filename, cAvidaContext& ctx);
+  void BuildCheckpoint(BinaryArchivePtr ar, cAvidaContext& ctx);  // fills ar without writing it, e.g. into a bundle
+  bool LoadCheckpoint(const cString& filename, cAvidaContext& ctx);
   bool SaveFlameData(const cString& filename);
   
   void SetMiniTraceQueue(Apto::Array<int, Apto::Smart> new_queue, const bool print_genomes, const bool print_reacs, const bool use_micro = false);
@@ -302,6 +379,12 @@ public:
   cDeme& GetDeme(int i) { return deme_array[i]; }
 
   cPopulationCell& GetCell(int in_num) { assert(in_num >=0); assert(in_num < cell_array.GetSize()); return cell_array[in_num]; }
+  const cForagerIndex& GetForagerIndex() const { return m_forager_index; }
+  const cNeighborPreyCounts& GetNeighborPreyCounts() const { return m_neighbor_prey; }
+  void AdjustNeighborPreyAV(int cell_id, int delta) { m_neighbor_prey.AdjustPreyAV(cell_id, delta); }
+  const cCellOccupancy& GetOccupancy() const { return m_occupancy; }
+  const cPopulationSnapshot& GetSnapshot();
+  void UpdateForagerIndex(int cell_id);
   const Apto::Array<double>& GetResources(cAvidaContext& ctx) const { return resource_count.GetResources(ctx); }
   const Apto::Array<double>& GetCellResources(int cell_id, cAvidaContext& ctx) const { return resource_count.GetCellResources(cell_id, ctx); } 
   const Apto::Array<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id) const { return resource_count.GetFrozenResources(ctx, cell_id); }
@@ -332,6 +415,8 @@ public:
   cResourceCount& GetResourceCount() { return resource_count; }
   void SetResourceInflow(const cString res_name, double new_level);
   void SetResourceOutflow(const cString res_name, double new_level);
+  void SetResourceInflow(int res_id, double new_level);   // res_id is the resource library id
+  void SetResourceOutflow(int res_id, double new_level);
   
   void SetDemeResource(cAvidaContext& ctx, const cString res_name, double new_level);
   void SetSingleDemeResourceInflow(int deme_id, const cString res_name, double new_level);
@@ -421,7 +506,7 @@ public:
   int NumberGroupJuvs(int group_id);
   void ChangeGroupMatingTypes(cOrganism* org, int group_id, int old_type, int new_type);
   // Get the group information
-  map<int, int> GetFormedGroups() { return m_groups; }
+  map<int, int> GetFormedGroups();
   Apto::Array<int> GetFormedGroupArray();
 
   // -------- Tolerance support --------
@@ -452,6 +537,12 @@ private:
   void SetupCellGrid();
   void ClearCellGrid();
   void BuildTimeSlicer(); // Build the schedule object
+  void BuildTiles();
+  void BuildDemeParallel();
+  void PlaceOnNodes(); // Move cells and resource grids to the NUMA nodes of the parallel engine's partitions
+  void BuildResourcePool();
+  void BuildMoveResources();
+  void attachInstCountTotal(cOrganism* org, int deme_id);
   
   // Methods to place offspring in the population.
   cPopulationCell& PositionOffspring(cPopulationCell& parent_cell, cAvidaContext& ctx, bool parent_ok = true); 
@@ -460,16 +551,20 @@ private:
   void PositionEnergyUsed(cPopulationCell & parent_cell, tList<cPopulationCell>& found_list, bool parent_ok);
   cPopulationCell& PositionDemeMigration(cPopulationCell& parent_cell, bool parent_ok = true);
   cPopulationCell& PositionDemeRandom(int deme_id, cPopulationCell& parent_cell, bool parent_ok = true);
-  int UpdateEmptyCellIDArray(int deme_id = -1);
-  Apto::Array<int>& GetEmptyCellIDArray() { return empty_cell_id_array; }
-  void FindEmptyCell(tList<cPopulationCell>& cell_list, tList<cPopulationCell>& found_list);
+  void FindEmptyCell(const cConnectionList& cell_list, tList<cPopulationCell>& found_list);
   int FindRandEmptyCell(cAvidaContext& ctx);
+  int FindEldestCell(int excluded_cell_id);
+  int AgeStamp(cOrganism* org) const;
   
   // Update statistics collecting...
   void UpdateDemeStats(cAvidaContext& ctx); 
   void UpdateOrganismStats(cAvidaContext& ctx); 
-  void UpdateFTOrgStats(cAvidaContext& ctx); 
-  void UpdateMaleFemaleOrgStats(cAvidaContext& ctx);
+  void SampleOrganismStats(cAvidaContext& ctx, int sample_size);
+  void ReapPopulationWriters(bool wait);
+  void ClearFTOrgStats();
+  void UpdateFTOrgStats(cOrganism* organism, const cString& inst_set, bool collect_inst);
+  void ClearMaleFemaleOrgStats();
+  void UpdateMaleFemaleOrgStats(cOrganism* organism, const cString& inst_set, bool collect_inst);
   
   void InjectClone(int cell_id, cOrganism& orig_org, Systematics::Source src);
   void CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& parent);
@@ -490,8 +585,14 @@ private:
   int PlaceAvatar(cAvidaContext& ctx, cOrganism* parent);
   
   inline void AdjustSchedule(const cPopulationCell& cell, const cMerit& merit);
+  void DeferScheduleAdjustments();
+  void FlushScheduleAdjustments();
   
   bool LoadGenotypeList(const cString& filename, cAvidaContext& ctx, Apto::Array<GeneticRepresentationPtr>& list_obj);
+  
+  inline sGroup* findGroup(int group_id);
+  const Apto::Array<cOrganism*, Apto::Smart>& groupMembers(int group_id);
+  int groupOffspringIntolerance(sGroup& group);
 };
 
 #endif
@@ -41,6 +41,7 @@ cPopulationCell::cPopulationCell(const cPopulationCell& in_cell)
 : m_world(in_cell.m_world)
 , m_organism(in_cell.m_organism)
 , m_hardware(in_cell.m_hardware)
+, m_connections(in_cell.m_connections)
 , m_inputs(in_cell.m_inputs)
 , m_cell_id(in_cell.m_cell_id)
 , m_deme_id(in_cell.m_deme_id)
@@ -53,11 +54,6 @@ cPopulationCell::cPopulationCell(const cPopulationCell& in_cell)
   // Copy the mutation rates into a new structure
   m_mut_rates = new cMutationRates(*in_cell.m_mut_rates);
 	
-  // Copy the connection list
-  tConstListIterator<cPopulationCell> conn_it(in_cell.m_connections);
-  cPopulationCell* test_cell;
-  while ((test_cell = const_cast<cPopulationCell*>(conn_it.Next()))) m_connections.PushRear(test_cell);
-	
 	// copy the hgt information, if needed.
 	if(in_cell.m_hgt) {
 		InitHGTSupport();
@@ -71,6 +67,7 @@ void cPopulationCell::operator=(const cPopulationCell& in_cell)
 		m_world = in_cell.m_world;
 		m_organism = in_cell.m_organism;
 		m_hardware = in_cell.m_hardware;
+		m_connections = in_cell.m_connections;
 		m_inputs = in_cell.m_inputs;
 		m_cell_id = in_cell.m_cell_id;
 		m_deme_id = in_cell.m_deme_id;
@@ -85,11 +82,6 @@ void cPopulationCell::operator=(const cPopulationCell& in_cell)
 		else
 			m_mut_rates->Copy(*in_cell.m_mut_rates);
 		
-		// Copy the connection list
-		tConstListIterator<cPopulationCell> conn_it(in_cell.m_connections);
-		cPopulationCell* test_cell;
-		while ((test_cell = const_cast<cPopulationCell*>(conn_it.Next()))) m_connections.PushRear(test_cell);
-		
 		// copy hgt information, if needed.
 		delete m_hgt;
 		m_hgt = 0;
@@ -129,15 +121,9 @@ void cPopulationCell::Rotate(cPopulationCell& new_facing)
     return;
   }
 	
-#ifdef DEBUG
-  int scan_count = 0;
-#endif
-  while (m_connections.GetFirst() != &new_facing) {
-    m_connections.CircNext();
-#ifdef DEBUG
-    assert(++scan_count < m_connections.GetSize());
-#endif
-  }
+  const int pos = m_connections->Find(m_cell_id, new_facing.GetID());
+  assert(pos != -1);
+  m_connections->Rotate(m_cell_id, pos);
 }
 
 /*! This method recursively builds a set of cells that neighbor this cell, out to 
@@ -148,10 +134,10 @@ void cPopulationCell::GetNeighboringCells(std::set<cPopulationCell*>& cell_set,
 	typedef std::set<cPopulationCell*> cell_set_t;
   
   // For each cell in our connection list...
-  tConstListIterator<cPopulationCell> i(m_connections);
-  while(!i.AtEnd()) {
+  const cConnectionList conn_list = ConnectionList();
+  for (int i = 0; i < conn_list.GetSize(); i++) {
 		// store the cell pointer, and check to see if we've already visited that cell...
-    cPopulationCell* cell = i.Next();
+    cPopulationCell* cell = conn_list.GetPos(i);
 		assert(cell != 0); // cells should never be null.
 		std::pair<cell_set_t::iterator, bool> ins = cell_set.insert(cell);
 		// and if so, recurse to it...
@@ -176,13 +162,13 @@ void cPopulationCell::GetOccupiedNeighboringCells(std::set<cPopulationCell*>& oc
 
 void cPopulationCell::GetOccupiedNeighboringCells(Apto::Array<cPopulationCell*>& occupied_cells) const
 {
-  occupied_cells.Resize(m_connections.GetSize());
+  const cConnectionList conn_list = ConnectionList();
+  occupied_cells.Resize(conn_list.GetSize());
   int occupied_count = 0;
 
-  tLWConstListIterator<cPopulationCell> i(m_connections);
-  while(!i.AtEnd()) {
-    cPopulationCell* cell = i.Next();
-		assert(cell); // cells should never be null.
+  cPopulationCell* cells = m_connections ? m_connections->GetCells() : NULL;
+  for (int i = 0; i < conn_list.GetSize(); i++) {
+    cPopulationCell* cell = cells + conn_list.GetIDAt(i);
     if (cell->IsOccupied()) occupied_cells[occupied_count++] = cell;
   }
   
@@ -301,6 +287,13 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
 		 && m_world->GetConfig().FRAC_ENERGY_DECAY_AT_DEME_BIRTH.Get() != 1.0) { // hack
     m_world->GetPopulation().GetDeme(m_deme_id).GiveBackCellEnergy(m_cell_id, m_organism->GetPhenotype().GetStoredEnergy() * m_world->GetConfig().FRAC_ENERGY_TRANSFER.Get(), ctx);
   }
+  
+  // Cycles pre-executed for the departing organism will never be consumed
+  if (m_spec_state) {
+    m_world->GetStats().AddSpeculativeWaste(m_spec_state, m_hardware->GetType());
+    m_spec_state = 0;
+  }
+  
   m_organism = NULL;
   m_hardware = NULL;
   return out_organism;
@@ -348,6 +341,7 @@ void cPopulationCell::AddPreyAV(cAvidaContext& ctx, cOrganism* org)
   m_av_prey.Swap(loc, m_av_prey.GetSize() - 1);
   exist_org->SetAVOutIndex(m_av_prey.GetSize() - 1);
   org->SetAVOutIndex(loc);
+  m_world->GetPopulation().AdjustNeighborPreyAV(m_cell_id, 1);
 }
 
 // Removes the organism from the cell's input avatars (predator)
@@ -372,6 +366,7 @@ void cPopulationCell::RemovePreyAV(cOrganism* org)
   exist_org->SetAVOutIndex(org->GetAVOutIndex());
   m_av_prey.Swap(org->GetAVOutIndex(), last);
   m_av_prey.Pop();
+  m_world->GetPopulation().AdjustNeighborPreyAV(m_cell_id, -1);
 }
 
 // Returns whether a cell has an output AV that the org will be able to receive messages from.
@@ -29,6 +29,7 @@
 #include <set>
 #include <deque>
 
+#include "cConnectionTable.h"
 #include "cMutationRates.h"
 #include "tList.h"
 #include "cGenomeUtil.h"
@@ -52,7 +53,7 @@ private:
   cOrganism* m_organism;                    // The occupent of this cell.
   cHardwareBase* m_hardware;
 
-  tList<cPopulationCell> m_connections;  // A list of neighboring cells.
+  cConnectionTable* m_connections;       // Neighbors of every cell, owned by the population.
   cMutationRates* m_mut_rates;           // Mutation rates at this cell.
   Apto::Array<int> m_inputs;                 // Environmental Inputs...
 
@@ -86,7 +87,7 @@ private:
 public:
   typedef std::set<cPopulationCell*> neighborhood_type; //!< Type for cell neighborhoods.
 
-  cPopulationCell() : m_world(NULL), m_organism(NULL), m_hardware(NULL), m_mut_rates(NULL), m_migrant(false), m_can_input(false), m_can_output(false), m_hgt(0) { ; }
+  cPopulationCell() : m_world(NULL), m_organism(NULL), m_hardware(NULL), m_connections(NULL), m_mut_rates(NULL), m_migrant(false), m_can_input(false), m_can_output(false), m_hgt(0) { ; }
   cPopulationCell(const cPopulationCell& in_cell);
   ~cPopulationCell() { delete m_mut_rates; delete m_hgt; }
 
@@ -103,13 +104,13 @@ public:
 
   inline cOrganism* GetOrganism() const { return m_organism; }
   inline cHardwareBase* GetHardware() const { return m_hardware; }
-  inline tList<cPopulationCell>& ConnectionList() { return m_connections; }
+  inline cConnectionList ConnectionList() const { return cConnectionList(m_connections, m_cell_id); }
   //! Recursively build a set of cells that neighbor this one, out to the given depth.
   void GetNeighboringCells(std::set<cPopulationCell*>& cell_set, int depth) const;
   //! Recursively build a set of occupied cells that neighbor this one, out to the given depth.
   void GetOccupiedNeighboringCells(std::set<cPopulationCell*>& occupied_cell_set, int depth) const;
   void GetOccupiedNeighboringCells(Apto::Array<cPopulationCell*>& occupied_cells) const;
-  inline cPopulationCell& GetCellFaced() { return *(m_connections.GetFirst()); }
+  inline cPopulationCell& GetCellFaced() { return m_connections->GetCells()[m_connections->GetFacedID(m_cell_id)]; }
   int GetFacing();  // Returns the facing of this cell.
   int GetFacedDir(); // Returns the human interpretable facing of this org.
   inline void GetPosition(int& x, int& y) const { x = m_x; y = m_y; } // Retrieves the position (x,y) coordinates of this cell.
@@ -170,6 +171,9 @@ public:
   cOrganism* GetRandPreyAV() const;
   Apto::Array<cOrganism*> GetCellInputAVs();
   Apto::Array<cOrganism*> GetCellOutputAVs();
+  // The avatar lists themselves, without a copy.  Adding or removing an avatar in the cell reorders them.
+  const Apto::Array<cOrganism*, Apto::Smart>& ReadCellInputAVs() const { return m_av_pred; }
+  const Apto::Array<cOrganism*, Apto::Smart>& ReadCellOutputAVs() const { return m_av_prey; }
   Apto::Array<cOrganism*> GetCellAVs();
 
 // -------- Neural support -------- 
@@ -217,4 +221,27 @@ inline int cPopulationCell::GetInputAt(int& input_pointer)
   return m_inputs[input_pointer++];
 }
 
+
+inline cPopulationCell* cConnectionList::GetFirst() const
+{
+  const int neighbor_id = GetFirstID();
+  return (neighbor_id == -1) ? NULL : m_table->GetCells() + neighbor_id;
+}
+
+inline cPopulationCell* cConnectionList::GetPos(int pos) const
+{
+  if (pos >= GetSize()) return NULL;
+  return m_table->GetCells() + m_table->GetNeighborID(m_cell_id, pos);
+}
+
+inline cPopulationCell* cConnectionList::FindPtr(cPopulationCell* cell) const
+{
+  if (!m_table || m_table->Find(m_cell_id, cell->GetID()) == -1) return NULL;
+  return cell;
+}
+
+inline void cConnectionList::Push(cPopulationCell* cell) { m_table->InsertFront(m_cell_id, cell->GetID()); }
+inline void cConnectionList::PushRear(cPopulationCell* cell) { m_table->InsertRear(m_cell_id, cell->GetID()); }
+inline void cConnectionList::Remove(cPopulationCell* cell) { if (m_table) m_table->Remove(m_cell_id, cell->GetID()); }
+
 #endif
@@ -56,6 +56,8 @@ cPopulationInterface::cPopulationInterface(cWorld* world)
 : m_world(world)
 , m_cell_id(-1)
 , m_deme_id(-1)
+, m_cell(NULL)
+, m_deme(NULL)
 , m_prevseen_cell_id(-1)
 , m_prev_task_cell(-1)
 , m_num_task_cells(0)
@@ -69,18 +71,10 @@ cPopulationInterface::~cPopulationInterface() {
 	}
 }
 
-cOrganism* cPopulationInterface::GetOrganism() {
-	return GetCell()->GetOrganism();
-}
-
 const Apto::Array<cOrganism*, Apto::Smart>& cPopulationInterface::GetLiveOrgList() const {
   return m_world->GetPopulation().GetLiveOrgList();
 }
 
-cPopulationCell* cPopulationInterface::GetCell() { 
-	return &m_world->GetPopulation().GetCell(m_cell_id);
-}
-
 cPopulationCell* cPopulationInterface::GetCell(int cell_id) { 
 	return &m_world->GetPopulation().GetCell(cell_id);
 }
@@ -101,57 +95,61 @@ int cPopulationInterface::GetCellYPosition()
   return pos.second;
 }
 
-cPopulationCell* cPopulationInterface::GetCellFaced() {
-	return &GetCell()->GetCellFaced();
+void cPopulationInterface::SetCellID(int in_id)
+{
+  m_cell_id = in_id;
+  m_cell = (in_id >= 0) ? &m_world->GetPopulation().GetCell(in_id) : NULL;
 }
 
-cDeme* cPopulationInterface::GetDeme() {
-  return &m_world->GetPopulation().GetDeme(m_deme_id);
+void cPopulationInterface::SetDemeID(int in_id)
+{
+  m_deme_id = in_id;
+  m_deme = (in_id >= 0) ? &m_world->GetPopulation().GetDeme(in_id) : NULL;
 }
 
 int cPopulationInterface::GetCellData() {
-  m_world->GetPopulation().GetCell(m_cell_id).UpdateCellDataExpired();
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellData();
+  m_cell->UpdateCellDataExpired();
+  return m_cell->GetCellData();
 }
 
 int cPopulationInterface::GetCellDataOrgID() {
-  m_world->GetPopulation().GetCell(m_cell_id).UpdateCellDataExpired();
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellDataOrgID();
+  m_cell->UpdateCellDataExpired();
+  return m_cell->GetCellDataOrgID();
 }
 
 int cPopulationInterface::GetCellDataUpdate() {
-  m_world->GetPopulation().GetCell(m_cell_id).UpdateCellDataExpired();
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellDataUpdate();
+  m_cell->UpdateCellDataExpired();
+  return m_cell->GetCellDataUpdate();
 }
 
 int cPopulationInterface::GetCellDataTerritory() {
-  m_world->GetPopulation().GetCell(m_cell_id).UpdateCellDataExpired();
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellDataTerritory();
+  m_cell->UpdateCellDataExpired();
+  return m_cell->GetCellDataTerritory();
 }
 
 int cPopulationInterface::GetCellDataForagerType() {
-  m_world->GetPopulation().GetCell(m_cell_id).UpdateCellDataExpired();
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellDataForagerType();
+  m_cell->UpdateCellDataExpired();
+  return m_cell->GetCellDataForagerType();
 }
 
 int cPopulationInterface::GetFacedCellData() {
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellFaced().GetCellData();
+  return m_cell->GetCellFaced().GetCellData();
 }
 
 int cPopulationInterface::GetFacedCellDataOrgID() {
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellFaced().GetCellDataOrgID();
+  return m_cell->GetCellFaced().GetCellDataOrgID();
 }
 
 int cPopulationInterface::GetFacedCellDataUpdate() {
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellFaced().GetCellDataUpdate();
+  return m_cell->GetCellFaced().GetCellDataUpdate();
 }
 
 int cPopulationInterface::GetFacedCellDataTerritory() {
-  return m_world->GetPopulation().GetCell(m_cell_id).GetCellFaced().GetCellDataTerritory();
+  return m_cell->GetCellFaced().GetCellDataTerritory();
 }
 
 void cPopulationInterface::SetCellData(const int newData) {
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   cell.SetCellData(newData, cell.GetOrganism()->GetID());
 }
 
@@ -239,40 +237,18 @@ bool cPopulationInterface::GetLGTFragment(cAvidaContext& ctx, int region, const
 bool cPopulationInterface::Divide(cAvidaContext& ctx, cOrganism* parent, const Genome& offspring_genome)
 {
   assert(parent != NULL);
-  assert(m_world->GetPopulation().GetCell(m_cell_id).GetOrganism() == parent);
+  assert(m_cell->GetOrganism() == parent);
   return m_world->GetPopulation().ActivateOffspring(ctx, offspring_genome, parent);
 }
 
-cOrganism* cPopulationInterface::GetNeighbor()
-{
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
-  assert(cell.IsOccupied());
-  
-  return cell.ConnectionList().GetFirst()->GetOrganism();
-}
-
-bool cPopulationInterface::IsNeighborCellOccupied() {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
-  return cell.ConnectionList().GetFirst()->IsOccupied();
-}
-
-int cPopulationInterface::GetNumNeighbors()
-{
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
-  assert(cell.IsOccupied());
-  
-  return cell.ConnectionList().GetSize();
-}
-
 void cPopulationInterface::GetNeighborhoodCellIDs(Apto::Array<int>& list)
 {
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied());
   
-  list.Resize(cell.ConnectionList().GetSize());
-  tConstListIterator<cPopulationCell> it(cell.ConnectionList());
-  int i = 0;
-  while (it.Next() != NULL) list[i++] = it.Get()->GetID();
+  const cConnectionList conn_list = cell.ConnectionList();
+  list.Resize(conn_list.GetSize());
+  for (int i = 0; i < conn_list.GetSize(); i++) list[i] = conn_list.GetIDAt(i);
 }
 
 void cPopulationInterface::GetAVNeighborhoodCellIDs(Apto::Array<int>& list, int av_num)
@@ -280,40 +256,33 @@ void cPopulationInterface::GetAVNeighborhoodCellIDs(Apto::Array<int>& list, int
   cPopulationCell& cell = m_world->GetPopulation().GetCell(m_avatars[av_num].av_cell_id);
   assert(cell.HasAV());
   
-  list.Resize(cell.ConnectionList().GetSize());
-  tConstListIterator<cPopulationCell> it(cell.ConnectionList());
-  int i = 0;
-  while (it.Next() != NULL) list[i++] = it.Get()->GetID();
+  const cConnectionList conn_list = cell.ConnectionList();
+  list.Resize(conn_list.GetSize());
+  for (int i = 0; i < conn_list.GetSize(); i++) list[i] = conn_list.GetIDAt(i);
 }
 
 int cPopulationInterface::GetFacing()
 {
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+	cPopulationCell& cell = *m_cell;
 	assert(cell.IsOccupied());
 	return cell.GetFacing();
 }
 
-int cPopulationInterface::GetFacedCellID()
-{
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id).GetCellFaced();
-	return cell.GetID();
-}
-
 int cPopulationInterface::GetFacedDir()
 {
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+	cPopulationCell& cell = *m_cell;
 	assert(cell.IsOccupied());
 	return cell.GetFacedDir();
 }
 
 int cPopulationInterface::GetNeighborCellContents() {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   return cell.ConnectionList().GetFirst()->GetCellData();
 }
 
 void cPopulationInterface::Rotate(cAvidaContext& ctx, int direction)
 {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied());
 	
   if (m_world->GetConfig().USE_AVATARS.Get()) {
@@ -326,21 +295,9 @@ void cPopulationInterface::Rotate(cAvidaContext& ctx, int direction)
   }
 }
 
-int cPopulationInterface::GetInputAt(int& input_pointer)
-{
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
-  //assert(cell.IsOccupied());
-  return cell.GetInputAt(input_pointer);
-}
-
 void cPopulationInterface::ResetInputs(cAvidaContext& ctx) 
 { 
-  m_world->GetPopulation().GetCell(m_cell_id).ResetInputs(ctx); 
-}
-
-const Apto::Array<int>& cPopulationInterface::GetInputs() const
-{
-  return m_world->GetPopulation().GetCell(m_cell_id).GetInputs();
+  m_cell->ResetInputs(ctx); 
 }
 
 const Apto::Array<double>& cPopulationInterface::GetResources(cAvidaContext& ctx)
@@ -447,7 +404,7 @@ void cPopulationInterface::UpdateDemeResources(cAvidaContext& ctx, const Apto::A
 
 void cPopulationInterface::Die(cAvidaContext& ctx) 
 {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   m_world->GetPopulation().KillOrganism(cell, ctx);
 }
 
@@ -459,13 +416,13 @@ void cPopulationInterface::KillCellID(int target, cAvidaContext& ctx)
 
 void cPopulationInterface::Kaboom(int distance, cAvidaContext& ctx) 
 {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   m_world->GetPopulation().Kaboom(cell, ctx, distance); 
 }
 
 void cPopulationInterface::Kaboom(int distance, cAvidaContext& ctx, double effect)
 {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   m_world->GetPopulation().Kaboom(cell, ctx, distance, effect);
 }
 
@@ -474,14 +431,14 @@ void cPopulationInterface::SpawnDeme(cAvidaContext& ctx)
   // const int num_demes = m_world->GetPopulation().GetNumDemes();
 	
   // Spawn the current deme; no target ID will put it into a random deme.
-  const int deme_id = m_world->GetPopulation().GetCell(m_cell_id).GetDemeID();
+  const int deme_id = m_cell->GetDemeID();
 	
   m_world->GetPopulation().SpawnDeme(deme_id, ctx); 
 }
 
 int cPopulationInterface::ReceiveValue()
 {
-  cPopulationCell & cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied());
   
   const int num_neighbors = cell.ConnectionList().GetSize();
@@ -502,7 +459,7 @@ int cPopulationInterface::ReceiveValue()
 bool cPopulationInterface::InjectParasite(cOrganism* host, Systematics::UnitPtr parent, const cString& label, const InstructionSequence& injected_code)
 {
   assert(parent != NULL);
-  assert(m_world->GetPopulation().GetCell(m_cell_id).GetOrganism() == host);
+  assert(m_cell->GetOrganism() == host);
   
   return m_world->GetPopulation().ActivateParasite(host, parent, label, injected_code);
 }
@@ -544,8 +501,12 @@ bool cPopulationInterface::SendMessage(cOrgMessage& msg, cPopulationCell& rcell)
     else if (!m_world->GetConfig().SELF_COMMUNICATION.Get()) {
       lost = true;
       cOrganism* sender = GetOrganism();
-      for (int i = 0; i < rcell.GetNumAVInputs(); i++) {
-        if (sender != rcell.GetCellInputAVs()[i]) lost = false;
+      const Apto::Array<cOrganism*, Apto::Smart>& inputs = rcell.ReadCellInputAVs();
+      for (int i = 0; i < inputs.GetSize(); i++) {
+        if (sender != inputs[i]) {
+          lost = false;
+          break;
+        }
       }
     }
   }
@@ -567,8 +528,9 @@ bool cPopulationInterface::SendMessage(cOrgMessage& msg, cPopulationCell& rcell)
   } else {
     // If using neural networking avatars, message must be sent to all orgs with input avatars in the cell. @JJB
     cOrganism* sender = GetOrganism();
-    for (int i = 0; i < rcell.GetNumAVInputs(); i++) {
-      cOrganism* recvr = rcell.GetCellInputAVs()[i];
+    const Apto::Array<cOrganism*, Apto::Smart>& inputs = rcell.ReadCellInputAVs();
+    for (int i = 0; i < inputs.GetSize(); i++) {
+      cOrganism* recvr = inputs[i];
       assert(recvr != 0);
       if ((sender != recvr) || m_world->GetConfig().SELF_COMMUNICATION.Get()) {
         recvr->ReceiveMessage(msg);
@@ -592,7 +554,7 @@ bool cPopulationInterface::SendMessage(cOrgMessage& msg, int cellid) {
  neighbors or if the cell currently faced is not occupied.
  */
 bool cPopulationInterface::SendMessage(cOrgMessage& msg) {
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied()); // This organism; sanity.
 
   if (m_world->GetConfig().USE_AVATARS.Get() == 2 && m_world->GetConfig().NEURAL_NETWORKING.Get()) {
@@ -615,7 +577,7 @@ bool cPopulationInterface::SendMessage(cOrgMessage& msg) {
 /*! Send a message to the faced organism, failing if this cell does not have 
  neighbors or if the cell currently faced is not occupied. */
 bool cPopulationInterface::BroadcastMessage(cOrgMessage& msg, int depth) {
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied()); // This organism; sanity.
 	
 	// Get the set of cells that are within range.
@@ -635,13 +597,13 @@ bool cPopulationInterface::BroadcastMessage(cOrgMessage& msg, int depth) {
 
 bool cPopulationInterface::BcastAlarm(int jump_label, int bcast_range) {
   bool successfully_sent(false);
-  cPopulationCell& scell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& scell = *m_cell;
   assert(scell.IsOccupied()); // This organism; sanity.
 	
   const int ALARM_SELF = m_world->GetConfig().ALARM_SELF.Get(); // does an alarm affect the sender; 0=no  non-0=yes
   
   if(bcast_range > 1) { // multi-hop messaging
-    cDeme& deme = m_world->GetPopulation().GetDeme(GetDemeID());
+    cDeme& deme = *m_deme;
     for(int i = 0; i < deme.GetSize(); i++) {
       int possible_receiver_id = deme.GetCellID(i);
       cPopulationCell& rcell = m_world->GetPopulation().GetCell(possible_receiver_id);
@@ -695,7 +657,7 @@ void cPopulationInterface::DivideOrgTestamentAmongDeme(double value){
 
 /*! Send a flash to all neighboring organisms. */
 void cPopulationInterface::SendFlash() {
-  cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+  cPopulationCell& cell = *m_cell;
   assert(cell.IsOccupied());
 	
   for(int i=0; i<cell.ConnectionList().GetSize(); ++i) {
@@ -716,7 +678,7 @@ int cPopulationInterface::GetStateGridID(cAvidaContext& ctx)
 void cPopulationInterface::RotateToGreatestReputation() 
 {
 	
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(GetCellID());
+	cPopulationCell& cell = *m_cell;
 	int high_rep=-1; 
 	vector <int> high_rep_orgs;
 	
@@ -773,7 +735,7 @@ void cPopulationInterface::RotateToGreatestReputation()
 void cPopulationInterface::RotateToGreatestReputationWithDifferentTag(int tag) 
 {
 	
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(GetCellID());
+	cPopulationCell& cell = *m_cell;
 	int high_rep=-1; 
 	vector <int> high_rep_orgs;
 	
@@ -832,7 +794,7 @@ void cPopulationInterface::RotateToGreatestReputationWithDifferentTag(int tag)
 void cPopulationInterface::RotateToGreatestReputationWithDifferentLineage(int line) 
 {
 	
-	cPopulationCell& cell = m_world->GetPopulation().GetCell(GetCellID());
+	cPopulationCell& cell = *m_cell;
 	int high_rep=-1; 
 	vector <int> high_rep_orgs;
 	
@@ -963,7 +925,7 @@ bool cPopulationInterface::NetworkSelect(int x) {
 // If the cell is turned on for deme input, retrieves the deme's next input value. @JJB
 int cPopulationInterface::GetNextDemeInput(cAvidaContext& ctx)
 {
-  if (m_world->GetPopulation().GetCell(m_cell_id).GetCanInput()) {
+  if (m_cell->GetCanInput()) {
     return GetDeme()->GetNextDemeInput(ctx);
   }
   return -1;
@@ -972,7 +934,7 @@ int cPopulationInterface::GetNextDemeInput(cAvidaContext& ctx)
 // If the cell is turned on for deme input, adds the value to the deme's input buffer. @JJB
 void cPopulationInterface::DoDemeInput(int value)
 {
-  if (m_world->GetPopulation().GetCell(m_cell_id).GetCanInput()) {
+  if (m_cell->GetCanInput()) {
     GetDeme()->DoDemeInput(value);
   }
 }
@@ -980,7 +942,7 @@ void cPopulationInterface::DoDemeInput(int value)
 // If the cell is turned on for deme output, adds the value to the deme's output buffer. @JJB
 void cPopulationInterface::DoDemeOutput(cAvidaContext& ctx, int value)
 {
-  if (m_world->GetPopulation().GetCell(m_cell_id).GetCanOutput()) {
+  if (m_cell->GetCanOutput()) {
     GetDeme()->DoDemeOutput(ctx, value);
   }
 }
@@ -1022,15 +984,12 @@ void cPopulationInterface::DoHGTDonation(cAvidaContext& ctx) {
 		}
 	}
 	assert(target != 0);
-	fragment_list_type fragments;
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(GetOrganism()->GetGenome().Representation());
-	cGenomeUtil::RandomSplit(ctx, 
+	target->GetOrganism()->GetOrgInterface().ReceiveHGTDonation(cGenomeUtil::RandomFragment(ctx,
 													 m_world->GetConfig().HGT_FRAGMENT_SIZE_MEAN.Get(),
 													 m_world->GetConfig().HGT_FRAGMENT_SIZE_VARIANCE.Get(),
-													 *seq,
-													 fragments);
-	target->GetOrganism()->GetOrgInterface().ReceiveHGTDonation(fragments[ctx.GetRandom().GetInt(fragments.size())]);
+													 *seq));
 }
 
 
@@ -1075,15 +1034,12 @@ void cPopulationInterface::DoHGTConjugation(cAvidaContext& ctx) {
 		}
 	}
 	assert(source != 0);
-	fragment_list_type fragments;
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(source->GetOrganism()->GetGenome().Representation());
-	cGenomeUtil::RandomSplit(ctx, 
+	ReceiveHGTDonation(cGenomeUtil::RandomFragment(ctx,
 													 m_world->GetConfig().HGT_FRAGMENT_SIZE_MEAN.Get(),
 													 m_world->GetConfig().HGT_FRAGMENT_SIZE_VARIANCE.Get(),
-													 *seq,
-													 fragments);
-	ReceiveHGTDonation(fragments[ctx.GetRandom().GetInt(fragments.size())]);	
+													 *seq));
 }
 
 
@@ -1114,7 +1070,7 @@ void cPopulationInterface::DoHGTMutation(cAvidaContext& ctx, Genome& offspring)
 		 && (ctx.GetRandom().P(m_world->GetConfig().HGT_COMPETENCE_P.Get()))) {
 		
 		// get this organism's cell:
-		cPopulationCell& cell = m_world->GetPopulation().GetCell(m_cell_id);
+		cPopulationCell& cell = *m_cell;
 		
 		// the hgt source controls where the genetic material for HGT comes from.
 		switch(m_world->GetConfig().HGT_SOURCE.Get()) {
@@ -1603,6 +1559,11 @@ void cPopulationInterface::IncNumTopPredOrganisms()
   m_world->GetPopulation().IncNumTopPredOrganisms();
 }
 
+void cPopulationInterface::ForageTargetChanged()
+{
+  if (m_cell_id >= 0) m_world->GetPopulation().UpdateForagerIndex(m_cell_id);
+}
+
 void cPopulationInterface::AttackFacedOrg(cAvidaContext& ctx, int loser)
 {
   m_world->GetPopulation().AttackFacedOrg(ctx, loser);
@@ -2363,13 +2324,13 @@ Apto::Array<cOrganism*> cPopulationInterface::GetCellAVs(int cell_id, int av_num
 }
 
 // Returns an array of all prey avatars in the organism's avatar's faced cell
-Apto::Array<cOrganism*> cPopulationInterface::GetFacedPreyAVs(int av_num)
+const Apto::Array<cOrganism*, Apto::Smart>& cPopulationInterface::GetFacedPreyAVs(int av_num)
 {
   // If the avatar exists..
   if (av_num < GetNumAV()) {
-    return m_world->GetPopulation().GetCell(m_avatars[av_num].av_faced_cell).GetCellOutputAVs();
+    return m_world->GetPopulation().GetCell(m_avatars[av_num].av_faced_cell).ReadCellOutputAVs();
   }
-  Apto::Array<cOrganism*> null_array(0);
+  static const Apto::Array<cOrganism*, Apto::Smart> null_array;
   return null_array;
 }
 
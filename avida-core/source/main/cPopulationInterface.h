@@ -46,6 +46,8 @@ private:
   cWorld* m_world;
   int m_cell_id;
   int m_deme_id;
+  cPopulationCell* m_cell;   // cell m_cell_id, refreshed whenever the organism is placed in a cell
+  cDeme* m_deme;             // deme m_deme_id
   
   int m_prevseen_cell_id;	// Previously-seen cell's ID
   int m_prev_task_cell;		// Cell ID of previous task
@@ -61,19 +63,19 @@ public:
 
   const Apto::Array<cOrganism*, Apto::Smart>& GetLiveOrgList() const;
 	//! Retrieve this organism.
-	cOrganism* GetOrganism();
+	cOrganism* GetOrganism() { return m_cell->GetOrganism(); }
 	//! Retrieve the ID of this cell.
   int GetCellID() { return m_cell_id; }
   //! Retrieve the cell in which this organism lives.
-  cPopulationCell* GetCell();
+  cPopulationCell* GetCell() { return m_cell; }
   cPopulationCell* GetCell(int cell_id);
   //! Retrieve the cell currently faced by this organism.
-  cPopulationCell* GetCellFaced();
+  cPopulationCell* GetCellFaced() { return &m_cell->GetCellFaced(); }
   int GetDemeID() { return m_deme_id; }
   //! Retrieve the deme in which this organism lives.
-  cDeme* GetDeme();
-  void SetCellID(int in_id) { m_cell_id = in_id; }
-  void SetDemeID(int in_id) { m_deme_id = in_id; }
+  cDeme* GetDeme() { return m_deme; }
+  void SetCellID(int in_id);
+  void SetDemeID(int in_id);
   int GetCellXPosition();
   int GetCellYPosition();
   
@@ -98,19 +100,19 @@ public:
   bool GetLGTFragment(cAvidaContext& ctx, int region, const Genome& dest_genome, InstructionSequence& seq);
 
   bool Divide(cAvidaContext& ctx, cOrganism* parent, const Genome& offspring_genome);
-  cOrganism* GetNeighbor();
-  bool IsNeighborCellOccupied();
-  int GetNumNeighbors();
+  cOrganism* GetNeighbor() { assert(m_cell->IsOccupied()); return m_cell->ConnectionList().GetFirst()->GetOrganism(); }
+  bool IsNeighborCellOccupied() { return m_cell->ConnectionList().GetFirst()->IsOccupied(); }
+  int GetNumNeighbors() { assert(m_cell->IsOccupied()); return m_cell->ConnectionList().GetSize(); }
   void GetNeighborhoodCellIDs(Apto::Array<int>& list);
   void GetAVNeighborhoodCellIDs(Apto::Array<int>& list, int av_num = 0);
   int GetFacing(); // Returns the facing of this organism.
-  int GetFacedCellID();
+  int GetFacedCellID() { return m_cell->GetCellFaced().GetID(); }
   int GetFacedDir(); // Returns the human interpretable facing of this org.
   int GetNeighborCellContents();
   void Rotate(cAvidaContext& ctx, int direction = 1);
-  int GetInputAt(int& input_pointer);
+  int GetInputAt(int& input_pointer) { return m_cell->GetInputAt(input_pointer); }
   void ResetInputs(cAvidaContext& ctx);
-  const Apto::Array<int>& GetInputs() const;
+  const Apto::Array<int>& GetInputs() const { return m_cell->GetInputs(); }
   const Apto::Array<double>& GetResources(cAvidaContext& ctx); 
   double GetResourceVal(cAvidaContext& ctx, int res_id);
   const Apto::Array<double>& GetFacedCellResources(cAvidaContext& ctx);
@@ -257,6 +259,7 @@ public:
   void IncNumPreyOrganisms();
   void IncNumPredOrganisms();
   void IncNumTopPredOrganisms();
+  void ForageTargetChanged();
   void AttackFacedOrg(cAvidaContext& ctx, int loser);
   
   void TryWriteBirthLocData(int org_idx);
@@ -317,7 +320,7 @@ public:
   cOrganism* GetRandFacedPreyAV(int av_num = 0);
   Apto::Array<cOrganism*> GetFacedAVs(int av_num = 0);
   Apto::Array<cOrganism*> GetCellAVs(int cell_id, int av_num = 0);
-  Apto::Array<cOrganism*> GetFacedPreyAVs(int av_num = 0);
+  const Apto::Array<cOrganism*, Apto::Smart>& GetFacedPreyAVs(int av_num = 0);
   const Apto::Array<double>& GetAVResources(cAvidaContext& ctx, int av_num = 0);
   double GetAVResourceVal(cAvidaContext& ctx, int res_id, int av_num = 0);
   const Apto::Array<double>& GetAVFacedResources(cAvidaContext& ctx, int av_num = 0);
@@ -0,0 +1,69 @@
+/*
+ *  cPopulationSnapshot.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPopulationSnapshot_h
+#define cPopulationSnapshot_h
+
+#include "avida/core/InstructionSequence.h"
+#include "avida/systematics/Group.h"
+
+#include "apto/core/Array.h"
+
+class cOrganism;
+
+using namespace Avida;
+
+
+// cPopulationSnapshot lists every occupied cell in cell order, along with the fields that population scanning print
+// actions look up for each organism.  cPopulation::GetSnapshot() builds it in one pass on first use and hands the same
+// copy to every caller until a cell changes occupant, so actions firing on the same update share a single scan.
+// Entries point at live organisms: per organism state that changes as organisms run (memory, phenotype) is read
+// through the organism, never copied.
+
+class cPopulationSnapshot
+{
+public:
+  struct sEntry
+  {
+    int cell_id;
+    cOrganism* org;
+    Systematics::GroupPtr genotype;
+    ConstInstructionSequencePtr seq;
+    Apto::String inst_set;
+  };
+
+private:
+  Apto::Array<sEntry, Apto::Smart> m_entries;
+  int m_version;   // cCellOccupancy version the entries were collected at, -1 before the first build
+
+
+public:
+  cPopulationSnapshot() : m_version(-1) { ; }
+
+  inline int GetVersion() const { return m_version; }
+  inline int GetSize() const { return m_entries.GetSize(); }
+  inline const sEntry& operator[](int i) const { return m_entries[i]; }
+
+  // Start a new collection for the given occupancy version
+  void Reset(int version) { m_entries.Resize(0); m_version = version; }
+  inline sEntry& Push() { m_entries.Resize(m_entries.GetSize() + 1); return m_entries[m_entries.GetSize() - 1]; }
+};
+
+#endif
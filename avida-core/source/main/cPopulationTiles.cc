@@ -0,0 +1,262 @@
+/*
+ *  cPopulationTiles.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPopulationTiles.h"
+
+#include "apto/platform.h"
+#include "apto/rng.h"
+
+#include "cAvidaConfig.h"
+#include "cAvidaContext.h"
+#include "cDeme.h"
+#include "cHardwareBase.h"
+#include "cNUMAPlacement.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+#include "cWorld.h"
+
+
+cPopulationTiles::cPopulationTiles(cWorld* world, cPopulation* pop, int num_threads, int tile_size, int depth)
+: m_world(world), m_pop(pop), m_depth(depth), m_numa(NULL), m_pass(0), m_tiles_done(0), m_terminate(false)
+{
+  buildTiles(tile_size);
+  
+  // A single key drawn from the master RNG; the per-tile generators are rekeyed by (update, cell) as they run
+  const int counter_seed = m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed());
+  m_tile_rng.Resize(m_tile_cells.GetSize());
+  m_tile_counter_rng.Resize(m_tile_cells.GetSize());
+  for (int i = 0; i < m_tile_rng.GetSize(); i++) {
+    m_tile_rng[i] = new Apto::RNG::AvidaRNG(counter_seed);
+    m_tile_counter_rng[i].SetSeed(counter_seed);
+  }
+  m_tile_results.Resize(m_tile_cells.GetSize());
+  
+  if (num_threads < 0) num_threads = Apto::Platform::AvailableCPUs();
+  if (num_threads > m_tile_cells.GetSize()) num_threads = m_tile_cells.GetSize();
+  
+  if (num_threads > 1 && m_world->GetConfig().NUMA_PLACEMENT.Get()) {
+    m_numa = new cNUMAPlacement;
+    if (m_numa->GetNumNodes() < 2) {
+      delete m_numa;
+      m_numa = NULL;
+    }
+  }
+  
+  const int num_tiles = m_tile_cells.GetSize();
+  const int num_nodes = (m_numa) ? m_numa->GetNumNodes() : 1;
+  m_node_first.Resize(num_nodes + 1);
+  m_node_first.SetAll(num_tiles);
+  for (int i = num_tiles - 1; i >= 0; i--) m_node_first[(m_numa) ? m_numa->NodeOf(i, num_tiles) : 0] = i;
+  for (int node = num_nodes - 1; node >= 0; node--) {
+    if (m_node_first[node] > m_node_first[node + 1]) m_node_first[node] = m_node_first[node + 1];
+  }
+  m_node_next.Resize(num_nodes);
+  m_node_next.SetAll(num_tiles);
+  
+  if (num_threads > 1) {
+    m_workers.Resize(num_threads);
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i] = new cWorker(this, (m_numa) ? m_numa->NodeOf(i, num_threads) : 0);
+      m_workers[i]->Start();
+    }
+  }
+}
+
+cPopulationTiles::~cPopulationTiles()
+{
+  m_mutex.Lock();
+  m_terminate = true;
+  m_pass++;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+  
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+  
+  for (int i = 0; i < m_tile_rng.GetSize(); i++) delete m_tile_rng[i];
+  
+  delete m_numa;
+}
+
+
+void cPopulationTiles::GetCellNodes(Apto::Array<int>& cell_node) const
+{
+  cell_node.Resize(m_pop->GetSize());
+  cell_node.SetAll(0);
+  if (!m_numa) return;
+  
+  for (int tile_id = 0; tile_id < m_tile_cells.GetSize(); tile_id++) {
+    const int node = m_numa->NodeOf(tile_id, m_tile_cells.GetSize());
+    for (int i = 0; i < m_tile_cells[tile_id].GetSize(); i++) cell_node[m_tile_cells[tile_id][i]] = node;
+  }
+}
+
+
+void cPopulationTiles::buildTiles(int tile_size)
+{
+  // Demes are already isolated from one another, so use them directly as tiles
+  if (m_pop->GetNumDemes() > 1) {
+    m_tile_cells.Resize(m_pop->GetNumDemes());
+    for (int deme_id = 0; deme_id < m_pop->GetNumDemes(); deme_id++) {
+      cDeme& deme = m_pop->GetDeme(deme_id);
+      m_tile_cells[deme_id].Resize(deme.GetSize());
+      for (int i = 0; i < deme.GetSize(); i++) m_tile_cells[deme_id][i] = deme.GetCellID(i);
+    }
+    return;
+  }
+  
+  const int world_x = m_pop->GetWorldX();
+  const int world_y = m_pop->GetWorldY();
+  if (tile_size < 1) tile_size = 1;
+  const int tiles_x = (world_x + tile_size - 1) / tile_size;
+  const int tiles_y = (world_y + tile_size - 1) / tile_size;
+  
+  m_tile_cells.Resize(tiles_x * tiles_y);
+  for (int ty = 0; ty < tiles_y; ty++) {
+    for (int tx = 0; tx < tiles_x; tx++) {
+      Apto::Array<int>& cells = m_tile_cells[ty * tiles_x + tx];
+      cells.Resize(0);
+      for (int y = ty * tile_size; y < world_y && y < (ty + 1) * tile_size; y++) {
+        for (int x = tx * tile_size; x < world_x && x < (tx + 1) * tile_size; x++) {
+          cells.Push(y * world_x + x);
+        }
+      }
+    }
+  }
+}
+
+
+void cPopulationTiles::PreExecute()
+{
+  for (int i = 0; i < m_tile_results.GetSize(); i++) {
+    sTileResult& result = m_tile_results[i];
+    result.spec_total = 0;
+    result.spec_num = 0;
+    result.hw_spec_total.Resize(cStats::NUM_SPEC_HW_TYPES);
+    result.hw_spec_total.SetAll(0);
+    result.hw_spec_num.Resize(cStats::NUM_SPEC_HW_TYPES);
+    result.hw_spec_num.SetAll(0);
+  }
+  
+  if (m_workers.GetSize()) {
+    m_mutex.Lock();
+    for (int node = 0; node < m_node_next.GetSize(); node++) m_node_next[node] = m_node_first[node];
+    m_tiles_done = 0;
+    m_pass++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+    
+    // Barrier: wait for all tiles to complete before the serial pass touches any organism
+    m_mutex.Lock();
+    while (m_tiles_done < m_tile_cells.GetSize()) m_done_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  } else {
+    for (int i = 0; i < m_tile_cells.GetSize(); i++) processTile(i);
+  }
+  
+  // Merge the per-tile statistics in tile order
+  cStats& stats = m_world->GetStats();
+  for (int i = 0; i < m_tile_results.GetSize(); i++) {
+    const sTileResult& result = m_tile_results[i];
+    if (!result.spec_num) continue;
+    for (int hw_type = 0; hw_type < cStats::NUM_SPEC_HW_TYPES; hw_type++) {
+      if (result.hw_spec_num[hw_type]) {
+        stats.AddSpeculative(result.hw_spec_total[hw_type], result.hw_spec_num[hw_type], hw_type);
+      }
+    }
+  }
+}
+
+
+void cPopulationTiles::processTile(int tile_id)
+{
+  cAvidaContext ctx(&m_world->GetDriver(), m_tile_rng[tile_id]);
+  ctx.SetCounterRandom(&m_tile_counter_rng[tile_id]);
+  sTileResult& result = m_tile_results[tile_id];
+  const Apto::Array<int>& cells = m_tile_cells[tile_id];
+  const int update = m_world->GetStats().GetUpdate();
+  
+  for (int i = 0; i < cells.GetSize(); i++) {
+    cPopulationCell& cell = m_pop->GetCell(cells[i]);
+    if (!cell.IsOccupied() || cell.GetSpeculativeState()) continue;
+    
+    cHardwareBase* hw = cell.GetHardware();
+    if (!hw->SupportsConcurrentSpeculative()) continue;
+    
+    ctx.KeyRandom(update, cells[i]);
+    int spec_count = 0;
+    while (spec_count < m_depth && hw->SingleProcess(ctx, true)) spec_count++;
+    
+    if (spec_count) {
+      cell.SetSpeculativeState(spec_count);
+      result.spec_total += spec_count;
+      result.spec_num++;
+      result.hw_spec_total[hw->GetType()] += spec_count;
+      result.hw_spec_num[hw->GetType()]++;
+    }
+  }
+}
+
+
+// Claim the next tile of node, or of the other nodes once that one is exhausted; -1 when none is left (mutex held)
+int cPopulationTiles::claimTile(int node)
+{
+  for (int i = 0; i < m_node_next.GetSize(); i++) {
+    const int n = (node + i) % m_node_next.GetSize();
+    if (m_node_next[n] < m_node_first[n + 1]) return m_node_next[n]++;
+  }
+  return -1;
+}
+
+
+void cPopulationTiles::cWorker::Run()
+{
+  if (m_tiles->m_numa) m_tiles->m_numa->PinCurrentThread(m_node);
+  
+  int last_pass = 0;
+  
+  while (1) {
+    m_tiles->m_mutex.Lock();
+    while (m_tiles->m_pass == last_pass) m_tiles->m_cond.Wait(m_tiles->m_mutex);
+    last_pass = m_tiles->m_pass;
+    m_tiles->m_mutex.Unlock();
+    
+    if (m_tiles->m_terminate) break;
+    
+    while (1) {
+      m_tiles->m_mutex.Lock();
+      int tile_id = m_tiles->claimTile(m_node);
+      m_tiles->m_mutex.Unlock();
+      
+      if (tile_id < 0) break;
+      
+      m_tiles->processTile(tile_id);
+      
+      m_tiles->m_mutex.Lock();
+      bool all_done = (++m_tiles->m_tiles_done == m_tiles->m_tile_cells.GetSize());
+      m_tiles->m_mutex.Unlock();
+      if (all_done) m_tiles->m_done_cond.Signal();
+    }
+  }
+}
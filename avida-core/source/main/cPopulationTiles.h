@@ -0,0 +1,117 @@
+/*
+ *  cPopulationTiles.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPopulationTiles_h
+#define cPopulationTiles_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#include "cCounterRNG.h"
+
+class cNUMAPlacement;
+class cPopulation;
+class cWorld;
+
+
+// cPopulationTiles partitions the population cell grid into rectangular tiles (or one tile per deme) and speculatively
+// pre-executes every organism in each tile on a pool of worker threads at the start of an update.  Only instructions that
+// do not stall speculation are executed, so organisms never touch shared state while running concurrently.  All
+// instructions with cross-cell effects (births, kills, movement, resource use) are left for the serial scheduler pass,
+// which consumes the pre-executed cycles through cPopulation::ProcessStepSpeculative in the usual deterministic order.
+//
+// Each tile owns an RNG that is rekeyed from a counter RNG before every cell it runs, so the random draws an organism sees
+// depend only on the seed, the update and its cell.  Results are reproducible across tile sizes and thread counts.
+//
+// With NUMA_PLACEMENT the tiles (bands of rows, in tile order) and the workers are split into contiguous blocks per
+// NUMA node; workers pre-execute the tiles of their own node first and only then help with the tiles of other nodes.
+
+class cPopulationTiles
+{
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cPopulationTiles* m_tiles;
+    int m_node;
+    
+    void Run();
+    
+  public:
+    cWorker(cPopulationTiles* tiles, int node) : m_tiles(tiles), m_node(node) { ; }
+  };
+  
+  struct sTileResult
+  {
+    int spec_total;
+    int spec_num;
+    Apto::Array<int> hw_spec_total;  // spec_total broken down by hardware type
+    Apto::Array<int> hw_spec_num;
+    
+    sTileResult() : spec_total(0), spec_num(0) { ; }
+  };
+
+  cWorld* m_world;
+  cPopulation* m_pop;
+  int m_depth;
+  
+  Apto::Array<Apto::Array<int> > m_tile_cells;
+  Apto::Array<Apto::Random*> m_tile_rng;
+  Apto::Array<cCounterRNG> m_tile_counter_rng;  // identically seeded, one per tile since each keeps draw state
+  Apto::Array<sTileResult> m_tile_results;
+  Apto::Array<cWorker*> m_workers;
+  cNUMAPlacement* m_numa;             // NULL unless NUMA_PLACEMENT is on and there are several nodes
+  Apto::Array<int> m_node_first;      // first tile of each node, plus one past the last tile
+  Apto::Array<int> m_node_next;       // next tile of each node to be claimed during the current pass
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_done_cond;
+  
+  volatile int m_pass;        // incremented to release workers for a new pre-execution pass
+  volatile int m_tiles_done;  // number of tiles completed during the current pass
+  volatile bool m_terminate;
+  
+  
+  void buildTiles(int tile_size);
+  void processTile(int tile_id);
+  int claimTile(int node);
+  
+  cPopulationTiles(); // @not_implemented
+  cPopulationTiles(const cPopulationTiles&); // @not_implemented
+  cPopulationTiles& operator=(const cPopulationTiles&); // @not_implemented
+  
+public:
+  cPopulationTiles(cWorld* world, cPopulation* pop, int num_threads, int tile_size, int depth);
+  ~cPopulationTiles();
+  
+  int GetNumTiles() const { return m_tile_cells.GetSize(); }
+  int GetNumThreads() const { return (m_workers.GetSize()) ? m_workers.GetSize() : 1; }
+  const cNUMAPlacement* GetNUMA() const { return m_numa; }
+  
+  // Node of every population cell under the tile partitioning
+  void GetCellNodes(Apto::Array<int>& cell_node) const;
+  
+  // Speculatively pre-execute all tiles, blocking until every tile has finished
+  void PreExecute();
+};
+
+#endif
@@ -40,8 +40,8 @@ cReaction::cReaction(const cString & _name, int _id)
 
 cReaction::~cReaction()
 {
-  while (process_list.GetSize() != 0) delete process_list.Pop();
-  while (requisite_list.GetSize() != 0) delete requisite_list.Pop();
+  while (process_list.GetSize() != 0) delete process_list.PopRear();
+  while (requisite_list.GetSize() != 0) delete requisite_list.PopRear();
 }
 
 cReactionProcess * cReaction::AddProcess()
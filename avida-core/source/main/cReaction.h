@@ -26,9 +26,7 @@
 #ifndef cString_h
 #include "cString.h"
 #endif
-#ifndef tList_h
-#include "tList.h"
-#endif
+#include "tArrayList.h"
 
 class cTaskEntry;
 class cReactionProcess;
@@ -41,9 +39,9 @@ private:
   cString name;
   int id;
   cTaskEntry* task;
-  tList<cReactionProcess> process_list;
-  tList<cReactionRequisite> requisite_list;
-  tList<cContextReactionRequisite> context_requisite_list;
+  tArrayList<cReactionProcess> process_list;
+  tArrayList<cReactionRequisite> requisite_list;
+  tArrayList<cContextReactionRequisite> context_requisite_list;
   bool active;
   bool internal;
 
@@ -58,12 +56,12 @@ public:
   const cString & GetName() const { return name; }
   int GetID() const { return id; }
   cTaskEntry* GetTask() { return task; }
-  const tList<cReactionProcess>& GetProcesses() { return process_list; }
+  const tArrayList<cReactionProcess>& GetProcesses() { return process_list; }
   cReactionProcess* GetProcess(int process = 0) { return process_list.GetPos(process); }
-  const tList<cReactionRequisite>& GetRequisites() { return requisite_list; }
-  const tList<cReactionRequisite>& GetRequisites() const { return requisite_list; }
-  const tList<cContextReactionRequisite>& GetContextRequisites() { return context_requisite_list; }
-  const tList<cContextReactionRequisite>& GetContextRequisites() const { return context_requisite_list; }
+  const tArrayList<cReactionRequisite>& GetRequisites() { return requisite_list; }
+  const tArrayList<cReactionRequisite>& GetRequisites() const { return requisite_list; }
+  const tArrayList<cContextReactionRequisite>& GetContextRequisites() { return context_requisite_list; }
+  const tArrayList<cContextReactionRequisite>& GetContextRequisites() const { return context_requisite_list; }
   bool GetActive() const { return active; }
 
   void SetTask(cTaskEntry* _task) { task = _task; }
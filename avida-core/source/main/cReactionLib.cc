@@ -35,10 +35,8 @@ cReactionLib::~cReactionLib()
 
 cReaction * cReactionLib::GetReaction(const cString & name) const
 {
-  for (int i = 0; i < reaction_array.GetSize(); i++) {
-    if (reaction_array[i]->GetName() == name) return reaction_array[i];
-  }
-  return NULL;
+  const int id = m_names.Find(name);
+  return (id == -1) ? NULL : reaction_array[id];
 }
 
 cReaction * cReactionLib::GetReaction(int id) const
@@ -50,12 +48,11 @@ cReaction * cReactionLib::GetReaction(int id) const
 cReaction * cReactionLib::AddReaction(const cString & name)
 {
   // If this reaction already exists, just return it.
-  cReaction * found_reaction = GetReaction(name);
-  if (found_reaction != NULL) return found_reaction;
+  const int new_id = m_names.Intern(name);
+  if (new_id < reaction_array.GetSize()) return reaction_array[new_id];
 
   // Create a new reaction...
-  const int new_id = reaction_array.GetSize();
-  cReaction * new_reaction = new cReaction(name, new_id);
+  cReaction * new_reaction = new cReaction(m_names.GetName(new_id), new_id);
   reaction_array.Resize(new_id + 1);
   reaction_array[new_id] = new_reaction;
   return new_reaction;
@@ -25,14 +25,16 @@
 
 #include "avida/core/Types.h"
 
+#include "cStringIntern.h"
+
 class cReaction;
-class cString;
 
 
 class cReactionLib
 {
 private:
   Apto::Array<cReaction*> reaction_array;
+  cStringIntern m_names;                      // handle of each name is its reaction id
 
   cReactionLib(const cReactionLib&); // @not_implemented
   cReactionLib& operator=(const cReactionLib&); // @not_implemented
@@ -46,6 +48,7 @@ public:
   cReaction* AddReaction(const cString& name);
   cReaction* GetReaction(const cString& name) const;
   cReaction* GetReaction(int id) const;
+  int GetReactionID(const cString& name) const { return m_names.Find(name); }
 };
 
 #endif
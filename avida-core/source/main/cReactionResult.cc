@@ -37,15 +37,10 @@ cReactionResult::cReactionResult(const int num_resources,
   , reactions_triggered(num_reactions)
   , reaction_add_bonus(num_reactions)
   , active_reaction(false)
+  , resource_touched(num_resources)
+  , task_touched(num_tasks)
+  , reaction_touched(num_reactions)
 {
-}
-
-void cReactionResult::ActivateReaction()
-{
-  // If this reaction is already active, don't worry about it.
-  if (active_reaction == true) return;
-
-  // To activate the reaction, we must initialize all counter settings.
   resources_consumed.SetAll(0.0);
   resources_produced.SetAll(0.0);
   resources_detected.SetAll(-1.0);
@@ -56,6 +51,43 @@ void cReactionResult::ActivateReaction()
   tasks_value.SetAll(0.0);
   reactions_triggered.SetAll(false);
   reaction_add_bonus.SetAll(0.0);
+  resource_touched.SetAll(false);
+  task_touched.SetAll(false);
+  reaction_touched.SetAll(false);
+}
+
+void cReactionResult::ActivateReaction()
+{
+  // If this reaction is already active, don't worry about it.
+  if (active_reaction == true) return;
+
+  // To activate the reaction, we must initialize all counter settings.  Only the entries written while the result
+  // was last active can differ from their initial values.
+  for (int i = 0; i < touched_resources.GetSize(); i++) {
+    const int id = touched_resources[i];
+    resources_consumed[id] = 0.0;
+    resources_produced[id] = 0.0;
+    resources_detected[id] = -1.0;
+    internal_resources_consumed[id] = 0.0;
+    internal_resources_produced[id] = 0.0;
+    resource_touched[id] = false;
+  }
+  touched_resources.Resize(0);
+  for (int i = 0; i < touched_tasks.GetSize(); i++) {
+    const int id = touched_tasks[i];
+    tasks_done[id] = false;
+    tasks_quality[id] = 0.0;
+    tasks_value[id] = 0.0;
+    task_touched[id] = false;
+  }
+  touched_tasks.Resize(0);
+  for (int i = 0; i < touched_reactions.GetSize(); i++) {
+    const int id = touched_reactions[i];
+    reactions_triggered[id] = false;
+    reaction_add_bonus[id] = 0.0;
+    reaction_touched[id] = false;
+  }
+  touched_reactions.Resize(0);
   task_plasticity.SetAll(0.0);
   energy_add = 0.0;
   bonus_add = 0.0;
@@ -79,6 +111,7 @@ void cReactionResult::ActivateReaction()
 void cReactionResult::Consume(int id, double num, bool is_env_resource)
 {
   ActivateReaction();
+  TouchResource(id);
   if(is_env_resource) { resources_consumed[id] += num; }
   else {
     used_env_resource = false;
@@ -90,6 +123,7 @@ void cReactionResult::Consume(int id, double num, bool is_env_resource)
 void cReactionResult::Produce(int id, double num, bool is_env_resource)
 {
   ActivateReaction();
+  TouchResource(id);
 
   if(is_env_resource) { resources_produced[id] += num; }
   else {
@@ -102,6 +136,7 @@ void cReactionResult::Produce(int id, double num, bool is_env_resource)
 void cReactionResult::Detect(int id, double num)
 {
   ActivateReaction();
+  TouchResource(id);
   resources_detected[id] += num;
 }
 
@@ -127,6 +162,7 @@ void cReactionResult::Sterilize(bool flag)
 void cReactionResult::MarkTask(int id, const double quality, const double value)
 {
   ActivateReaction();
+  TouchTask(id);
   tasks_done[id] = true;
   tasks_quality[id] = quality;
   tasks_value[id] = value;
@@ -136,6 +172,7 @@ void cReactionResult::MarkTask(int id, const double quality, const double value)
 void cReactionResult::MarkReaction(int id)
 {
   ActivateReaction();
+  TouchReaction(id);
   reactions_triggered[id] = true;
 }
 
@@ -149,6 +186,7 @@ void cReactionResult::AddBonus(double value, int id)
 {
   ActivateReaction();
   bonus_add += value;
+  TouchReaction(id);
   reaction_add_bonus[id] += value;
 }
 
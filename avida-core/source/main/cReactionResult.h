@@ -55,7 +55,18 @@ private:
   double deme_mult_bonus; //!< Multiplicative bonus applied to the deme as a result of this reaction.
   bool active_deme_reaction; //!< Whether this reaction result includes a deme merit component.
 
+  // Entries written since the last reset, so that reactivating only has to clear those
+  Apto::Array<bool> resource_touched;
+  Apto::Array<bool> task_touched;
+  Apto::Array<bool> reaction_touched;
+  Apto::Array<int, Apto::Smart> touched_resources;
+  Apto::Array<int, Apto::Smart> touched_tasks;
+  Apto::Array<int, Apto::Smart> touched_reactions;
+
   inline void ActivateReaction();
+  inline void TouchResource(int id) { if (!resource_touched[id]) { resource_touched[id] = true; touched_resources.Push(id); } }
+  inline void TouchTask(int id) { if (!task_touched[id]) { task_touched[id] = true; touched_tasks.Push(id); } }
+  inline void TouchReaction(int id) { if (!reaction_touched[id]) { reaction_touched[id] = true; touched_reactions.Push(id); } }
 
   cReactionResult(); // @not_implemented
   cReactionResult(const cReactionResult&); // @not_implemented
@@ -61,6 +61,8 @@ cResource::cResource(const cString & _name, int _id)
   , xgravity(0.0)
   , ydiffuse(1.0)
   , ygravity(0.0)
+  , spatial_interval(1)
+  , flow_tolerance(0.0)
   , deme_resource(false)
   , energy_resource(false)
   , peaks(0) //JW
@@ -77,6 +77,8 @@ private:
   double xgravity;
   double ydiffuse;
   double ygravity;
+  int spatial_interval;   // updates per spatial integration step
+  double flow_tolerance;  // rows flatter than this skip diffusion
   bool deme_resource;
   bool org_resources;
   bool energy_resource;  // only implemented for spacial resource
@@ -173,6 +175,8 @@ public:
   double GetXGravity() const { return xgravity; }
   double GetYDiffuse() const { return ydiffuse; }
   double GetYGravity() const { return ygravity; }
+  int GetSpatialInterval() const { return spatial_interval; }
+  double GetFlowTolerance() const { return flow_tolerance; }
   bool GetDemeResource() const { return deme_resource; }
   bool GetEnergyResource() const { return energy_resource; }
   int GetPeaks() const { return peaks; } //JW
@@ -261,6 +265,8 @@ public:
   void SetXGravity(double _xgravity) { xgravity = _xgravity; }
   void SetYDiffuse(double _ydiffuse) { ydiffuse = _ydiffuse; }
   void SetYGravity(double _ygravity) { ygravity = _ygravity; }
+  void SetSpatialInterval(int _spatial_interval) { spatial_interval = _spatial_interval; }
+  void SetFlowTolerance(double _flow_tolerance) { flow_tolerance = _flow_tolerance; }
   void SetCollectable(int _collectable) { collectable = _collectable; }
   bool SetDemeResource(cString _deme_resource);
   bool SetOrgResource(cString _org_resource);  
@@ -23,6 +23,7 @@
 #include "cResourceCount.h"
 #include "cResource.h"
 #include "cGradientCount.h"
+#include "cNUMAPlacement.h"
 #include "cWorld.h"
 #include "cStats.h"
 
@@ -102,6 +103,10 @@ cResourceCount::cResourceCount(int num_resources)
   , spatial_update_time(0.0)
   , m_last_updated(0)
   , m_spatial_update(0)
+  , m_step_time(NULL)
+  , m_step_time_applied(0.0)
+  , m_steps_elapsed(0)
+  , m_update_pool(NULL)
 {
   if(num_resources > 0) {
     SetSize(num_resources);
@@ -110,7 +115,9 @@ cResourceCount::cResourceCount(int num_resources)
   return;
 }
 
-cResourceCount::cResourceCount(const cResourceCount &rc) {
+cResourceCount::cResourceCount(const cResourceCount &rc)
+  : m_step_time(NULL), m_step_time_applied(0.0), m_steps_elapsed(0), m_update_pool(NULL)
+{
   *this = rc;
 
   return;
@@ -133,9 +140,17 @@ const cResourceCount &cResourceCount::operator=(const cResourceCount &rc) {
   
   curr_grid_res_cnt = rc.curr_grid_res_cnt;
   curr_spatial_res_cnt = rc.curr_spatial_res_cnt;
+  rc.applyStepTime();
   update_time = rc.update_time;
+  m_steps_elapsed = rc.m_steps_elapsed;
+  m_steps_applied = rc.m_steps_applied;
   spatial_update_time = rc.spatial_update_time;
+  m_spatial_interval = rc.m_spatial_interval;
+  m_spatial_pending = rc.m_spatial_pending;
   cell_lists = rc.cell_lists;
+  
+  // The step clock belongs to the owner of this object, keep it and start counting from its current value
+  m_step_time_applied = (m_step_time) ? *m_step_time : 0.0;
 
   return *this;
 }
@@ -165,6 +180,12 @@ void cResourceCount::SetSize(int num_resources)
     
   curr_grid_res_cnt.ResizeClear(num_resources);
   curr_spatial_res_cnt.ResizeClear(num_resources);
+  m_steps_applied.ResizeClear(num_resources);
+  m_steps_applied.SetAll(m_steps_elapsed);
+  m_spatial_interval.ResizeClear(num_resources);
+  m_spatial_interval.SetAll(1);
+  m_spatial_pending.ResizeClear(num_resources);
+  m_spatial_pending.SetAll(0);
   cell_lists.ResizeClear(num_resources);
   resource_name.SetAll("");
   resource_initial.SetAll(0.0);
@@ -291,6 +312,7 @@ void cResourceCount::Setup(cWorld* world, const int& res_index, const cString& n
 
   resource_name[res_index] = name;
   resource_initial[res_index] = initial;
+  m_steps_applied[res_index] = m_steps_elapsed;
   if (in_geometry == nGeometry::GLOBAL) {
     resource_count[res_index] = initial;
     spatial_resource_count[res_index]->RateAll(0);
@@ -501,7 +523,13 @@ void cResourceCount::SetInflow(const cString& name, const double _inflow)
 {
   int id = GetResourceCountID(name);
   if (id == -1) return;
+  SetInflow(id, _inflow);
+}
 
+void cResourceCount::SetInflow(int id, const double _inflow)
+{
+  // Steps already on the clock were taken at the old rate
+  syncResource(id);
   inflow_rate[id] = _inflow;
   double step_inflow = _inflow * UPDATE_STEP;
   double step_decay = pow(decay_rate[id], UPDATE_STEP);
@@ -524,7 +552,12 @@ void cResourceCount::SetDecay(const cString& name, const double _decay)
 {
   int id = GetResourceCountID(name);
   if (id == -1) return;
+  SetDecay(id, _decay);
+}
 
+void cResourceCount::SetDecay(int id, const double _decay)
+{
+  syncResource(id);
   decay_rate[id] = _decay;
   double step_decay = pow(_decay, UPDATE_STEP);
   decay_precalc(id, 0) = 1.0;
@@ -533,12 +566,29 @@ void cResourceCount::SetDecay(const cString& name, const double _decay)
   }
 }
 
+void cResourceCount::SetSpatialInterval(int id, int interval, double flow_tolerance)
+{
+  assert(interval >= 1);
+  if (!IsSpatialResource(id)) return;
+  m_spatial_interval[id] = interval;
+  m_spatial_pending[id] = 0;
+  spatial_resource_count[id]->SetStepScale(interval);
+  spatial_resource_count[id]->SetFlowTolerance(flow_tolerance);
+}
+
 void cResourceCount::Update(double in_time) 
 { 
   update_time += in_time;
   spatial_update_time += in_time;
  }
 
+void cResourceCount::SetStepTimeSource(const double* step_time)
+{
+  applyStepTime();
+  m_step_time = step_time;
+  m_step_time_applied = (step_time) ? *step_time : 0.0;
+}
+
  
 const Apto::Array<double> & cResourceCount::GetResources(cAvidaContext& ctx) const
 {
@@ -575,6 +625,7 @@ const Apto::Array<double> & cResourceCount::GetFrozenResources(cAvidaContext&, i
   
   for (int i = 0; i < num_resources; i++) {
     if (!IsSpatialResource(i)) {
+      syncResource(i);
       curr_grid_res_cnt[i] = resource_count[i];
     } else {
       curr_grid_res_cnt[i] = spatial_resource_count[i]->GetAmount(cell_id);
@@ -586,24 +637,30 @@ const Apto::Array<double> & cResourceCount::GetFrozenResources(cAvidaContext&, i
 double cResourceCount::GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const
 // This differs from GetFrozenCellResources by only pulling for res of interest.
 {
-  if (!IsSpatialResource(res_id)) 
+  if (!IsSpatialResource(res_id)) {
+    syncResource(res_id);
     return resource_count[res_id];
-  else 
-    return spatial_resource_count[res_id]->GetAmount(cell_id);
+  }
+  return spatial_resource_count[res_id]->GetAmount(cell_id);
 }
 
 double cResourceCount::GetCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const
 // This differs from GetCellResources by only pulling for res of interest.
+// Spatial integration is owed once per update and runs for every resource
+// in order, as a full DoUpdates.  Otherwise only res_id is brought up to
+// the step clock.
 {
-  DoUpdates(ctx);
+  if (m_spatial_update != m_last_updated) {
+    DoUpdates(ctx);
+  } else {
+    advanceSteps();
+  }
 
-  double res_val = 0;
   if (!IsSpatialResource(res_id)) {
-    res_val = resource_count[res_id];
-  } else {
-    res_val = spatial_resource_count[res_id]->GetAmount(cell_id);
+    syncResource(res_id);
+    return resource_count[res_id];
   }
-  return res_val;
+  return spatial_resource_count[res_id]->GetAmount(cell_id);
 }
 
 const Apto::Array<int> & cResourceCount::GetResourcesGeometry() const
@@ -674,6 +731,27 @@ void cResourceCount::ModifyCell(cAvidaContext& ctx, const Apto::Array<double> &
   }
 }
 
+void cResourceCount::ModifyCell(cAvidaContext& ctx, int res_id, double change, int cell_id)
+// Single resource form of ModifyCell, for callers that only ever touch a few
+// resources and would otherwise build a full change vector.
+{
+  assert(res_id < resource_count.GetSize());
+
+  DoUpdates(ctx);
+  if (!IsSpatialResource(res_id)) {
+    resource_count[res_id] += change;
+    assert(resource_count[res_id] >= 0.0);
+  } else {
+    double temp = spatial_resource_count[res_id]->Element(cell_id).GetAmount();
+    spatial_resource_count[res_id]->Rate(cell_id, change);
+    spatial_resource_count[res_id]->State(cell_id);
+    if (spatial_resource_count[res_id]->Element(cell_id).GetAmount() != temp) {
+      spatial_resource_count[res_id]->SetModified(true);
+    }
+    assert(spatial_resource_count[res_id]->Element(cell_id).GetAmount() >= 0.0);
+  }
+}
+
 double cResourceCount::Get(cAvidaContext& ctx, int res_id) const
 {
   assert(res_id < resource_count.GetSize());
@@ -705,6 +783,17 @@ void cResourceCount::ResizeSpatialGrids(int in_x, int in_y)
   }
 }
 
+// Only grids with one element per cell of cell_node are placed, global resources keep a single element
+void cResourceCount::PlaceOnNodes(const cNUMAPlacement& numa, const Apto::Array<int>& cell_node) const
+{
+  for (int i = 0; i < resource_count.GetSize(); i++) {
+    spatial_resource_count[i]->PlaceOnNodes(numa, cell_node);
+    if (curr_spatial_res_cnt[i].GetSize() == cell_node.GetSize() && cell_node.GetSize()) {
+      numa.BindArray(&curr_spatial_res_cnt[i][0], cell_node);
+    }
+  }
+}
+
 int cResourceCount::GetCurrPeakX(cAvidaContext& ctx, int res_id) const
 { 
   DoUpdates(ctx);
@@ -756,8 +845,6 @@ int cResourceCount::GetMaxUsedY(int res_id)
 
 void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
 { 
-
-  
   // GLOBAL AND PARTIAL CALCULATION VALUES ======================================
   /*
      UPDATE_STEP is the fraction of an update per calculation step
@@ -765,23 +852,15 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
      EPSILON is the tolerance for roundoff errors
      
      update_time is the portion of an update remaining.  It's remainder will
-     get used in the next round of updating.
+     get used in the next round of updating.  advanceSteps moves the whole
+     steps onto the clock, syncResource below integrates them.
      
      Keep in mind that regardless of the type of resource, all resources
      will have an inflow, outflow, initial, geometry, resource_count,
      and spatial_resource_count (the latter even for global or partial resources,
      it just is not used.)
    */
-  
-  // Make sure that our fraction of an update remaining is greater than twice
-  // the roundoff error.
-  assert(update_time >= -EPSILON);
-  // Determine how many resource steps we wish to process
-  const int num_steps = (int) (update_time / UPDATE_STEP);
-  
-  // Preserve remainder of update_time for use on the next DoUpdates as
-  // we may not get around to calculating them this round
-  update_time -=  num_steps * UPDATE_STEP;
+  advanceSteps();
   
   
   // SPATIAL CALCULATION VALUES ==================================
@@ -798,11 +877,29 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   
   
   // DO UPDATE FOR EACH RESOURCE ================================================
-  for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
-    if (!IsSpatialResource(res_id)) {
-      DoNonSpatialUpdates(ctx, res_id, num_steps);
-    } else if (!global_only){
-      DoSpatialUpdates(ctx, res_id, num_spatial_updates);
+  if (m_update_pool && !global_only && num_spatial_updates > 0) {
+    // Spatial resources that only touch their own grid are independent of one another, hand them to the pool.  The
+    // remaining ones may affect the population and are processed afterwards, in order, with the caller's context.
+    Apto::Array<int> pooled_res;
+    Apto::Array<int> serial_res;
+    for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
+      if (!IsSpatialResource(res_id)) {
+        syncResource(res_id);
+      } else if (spatial_resource_count[res_id]->AffectsPopulation()) {
+        serial_res.Push(res_id);
+      } else {
+        pooled_res.Push(res_id);
+      }
+    }
+    m_update_pool->UpdateResources(this, pooled_res, num_spatial_updates);
+    for (int i = 0; i < serial_res.GetSize(); i++) DoSpatialUpdates(ctx, serial_res[i], num_spatial_updates);
+  } else {
+    for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
+      if (!IsSpatialResource(res_id)) {
+        syncResource(res_id);
+      } else if (!global_only){
+        DoSpatialUpdates(ctx, res_id, num_spatial_updates);
+      }
     }
   }
   
@@ -811,7 +908,7 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   }
 }
 
-void cResourceCount::DoNonSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_steps) const
+void cResourceCount::DoNonSpatialUpdates(const int res_id, int num_steps) const
 {
   // Calculate our entire PRECALC_DISTANCE intervals
   while (num_steps > PRECALC_DISTANCE) {
@@ -827,18 +924,30 @@ void cResourceCount::DoNonSpatialUpdates(cAvidaContext& ctx, const int res_id, i
 
 
 
+void cResourceCount::syncResources() const
+{
+  for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
+    if (!IsSpatialResource(res_id)) syncResource(res_id);
+  }
+}
+
 void cResourceCount::DoSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_updates) const
 {
+  const int interval = m_spatial_interval[res_id];
+  if (interval > 1) {
+    // Wait for a whole interval to accumulate, then take one step standing for all of it
+    m_spatial_pending[res_id] += num_updates;
+    num_updates = m_spatial_pending[res_id] / interval;
+    m_spatial_pending[res_id] -= num_updates * interval;
+    const double inflow = inflow_rate[res_id] * interval;
+    const double decay = pow(decay_rate[res_id], interval);
+    for (int kk = 0; kk < num_updates; kk++) spatial_resource_count[res_id]->StepAll(ctx, inflow, decay);
+    return;
+  }
+  
   for (int kk=0; kk < num_updates; kk++){
-    spatial_resource_count[res_id]->UpdateCount(ctx);  //Only for Gradient Resources
-    spatial_resource_count[res_id]->Source(inflow_rate[res_id]);  
-    spatial_resource_count[res_id]->Sink(decay_rate[res_id]);   
-    if (spatial_resource_count[res_id]->GetCellListSize() > 0) {  // Only for CELL resources?
-      spatial_resource_count[res_id]->CellInflow();
-      spatial_resource_count[res_id]->CellOutflow();
-    }
-    spatial_resource_count[res_id]->FlowAll();
-    spatial_resource_count[res_id]->StateAll();
+    // Inflow, outflow, diffusion and state folding in a single fused pass over the grid
+    spatial_resource_count[res_id]->StepAll(ctx, inflow_rate[res_id], decay_rate[res_id]);
     // BDB: resource_count[res_ndx] = spatial_resource_count[i]->SumAll();
   }
 }
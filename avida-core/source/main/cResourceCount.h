@@ -31,6 +31,7 @@
 #include "tMatrix.h"
 #include "nGeometry.h"
 
+class cResourceUpdatePool;
 class cWorld;
 
 
@@ -60,6 +61,7 @@ class cWorld;
 
 class cResourceCount
 {
+  friend class cResourceUpdatePool;
 private:
   mutable Apto::Array<cString> resource_name;    // The name of each resource
   mutable Apto::Array<double> resource_initial;  // Initial quantity of each resource
@@ -80,10 +82,34 @@ private:
   mutable double spatial_update_time;
   mutable int m_last_updated;
   mutable int m_spatial_update;
+  
+  // Step time is not pushed in on every executed instruction, instead it is pulled from a clock owned by the population
+  // the next time resources are integrated.
+  const double* m_step_time;         // Step time elapsed this update, NULL if only driven through Update()
+  mutable double m_step_time_applied; // Portion of *m_step_time already folded into update_time
+
+  inline void applyStepTime() const;
+  
+  // Non-spatial resources are integrated lazily: the step clock only counts the steps that have elapsed, and each
+  // resource catches up on its own when it is read or changed, so a single resource query costs the same however many
+  // resources the environment defines.
+  mutable long long m_steps_elapsed;               // Steps the clock has advanced in total
+  mutable Apto::Array<long long> m_steps_applied;  // Portion of m_steps_elapsed already folded into each resource_count
+  
+  inline void advanceSteps() const;
+  inline void syncResource(int res_id) const;
+  void syncResources() const;
+  
+  // Slow spatial resources may be integrated only every few updates, with a single step whose rates cover the whole
+  // interval (see update_interval in the environment file)
+  Apto::Array<int> m_spatial_interval;
+  mutable Apto::Array<int> m_spatial_pending;      // Updates accumulated towards the next step of each resource
+  
+  cResourceUpdatePool* m_update_pool; // Threads used for independent spatial resources, NULL to update serially
 
   void DoUpdates(cAvidaContext& ctx, bool global_only = false) const;         // Update resource count based on update time
   
-  void DoNonSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_steps) const;
+  void DoNonSpatialUpdates(const int res_id, int num_steps) const;
   void DoSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_updates) const;
 
   // A few constants to describe update process...
@@ -152,16 +178,24 @@ public:
   void SetInflow(const cString& name, const double _inflow);
   double GetDecay(const cString& name);
   void SetDecay(const cString& name, const double _decay);
+  double GetInflow(int id) const { return inflow_rate[id]; }
+  void SetInflow(int id, const double _inflow);
+  double GetDecay(int id) const { return decay_rate[id]; }
+  void SetDecay(int id, const double _decay);
+  void SetSpatialInterval(int id, int interval, double flow_tolerance);
   
   void Update(double in_time);
+  void SetStepTimeSource(const double* step_time);
+  void FlushStepTime() const { applyStepTime(); m_step_time_applied = 0.0; }
+  void SetUpdatePool(cResourceUpdatePool* pool) { m_update_pool = pool; }
 
   int GetSize(void) const { return resource_count.GetSize(); }
-  const Apto::Array<double>& ReadResources(void) const { return resource_count; }
+  const Apto::Array<double>& ReadResources(void) const { syncResources(); return resource_count; }
   const Apto::Array<double>& GetResources(cAvidaContext& ctx) const; 
   const Apto::Array<double>& GetCellResources(int cell_id, cAvidaContext& ctx) const;
   const Apto::Array<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id) const;
   double GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;
-  double GetCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;
+  double GetCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;  // Integrates res_id alone when it can
   const Apto::Array<int>& GetResourcesGeometry() const;
   int GetResourceGeometry(int res_id) const { return geometry[res_id]; }
   const Apto::Array<Apto::Array<double> >& GetSpatialRes(cAvidaContext& ctx);
@@ -169,9 +203,11 @@ public:
   void Modify(cAvidaContext& ctx, const Apto::Array<double>& res_change);
   void Modify(cAvidaContext& ctx, int id, double change);
   void ModifyCell(cAvidaContext& ctx, const Apto::Array<double> & res_change, int cell_id);
+  void ModifyCell(cAvidaContext& ctx, int res_id, double change, int cell_id);
   void Set(cAvidaContext& ctx, int id, double new_level);
   double Get(cAvidaContext& ctx, int id) const;
   void ResizeSpatialGrids(int in_x, int in_y);
+  void PlaceOnNodes(const cNUMAPlacement& numa, const Apto::Array<int>& cell_node) const;
   cSpatialResCount GetSpatialResource(int id) { return *(spatial_resource_count[id]); }
   const cSpatialResCount& GetSpatialResource(int id) const { return *(spatial_resource_count[id]); }
   void ReinitializeResources(cAvidaContext& ctx, double additional_resource);
@@ -199,4 +235,35 @@ public:
   void UpdateResources(cAvidaContext& ctx) { DoUpdates(ctx, false); }
 };
 
+
+inline void cResourceCount::applyStepTime() const
+{
+  if (m_step_time && *m_step_time != m_step_time_applied) {
+    const double elapsed = *m_step_time - m_step_time_applied;
+    update_time += elapsed;
+    spatial_update_time += elapsed;
+    m_step_time_applied = *m_step_time;
+  }
+}
+
+inline void cResourceCount::advanceSteps() const
+{
+  // Pull in any step time that has elapsed since the last integration
+  applyStepTime();
+  
+  // Make sure that our fraction of an update remaining is greater than twice the roundoff error, then move whole
+  // steps onto the clock, preserving the remainder of update_time for next time
+  assert(update_time >= -EPSILON);
+  const int num_steps = (int) (update_time / UPDATE_STEP);
+  update_time -= num_steps * UPDATE_STEP;
+  m_steps_elapsed += num_steps;
+}
+
+inline void cResourceCount::syncResource(int res_id) const
+{
+  if (m_steps_applied[res_id] == m_steps_elapsed) return;
+  DoNonSpatialUpdates(res_id, (int)(m_steps_elapsed - m_steps_applied[res_id]));
+  m_steps_applied[res_id] = m_steps_elapsed;
+}
+
 #endif
@@ -28,23 +28,37 @@
 
 int cResourceHistory::getEntryForUpdate(int update, bool exact) const
 {
-  int entry = -1;
+  // Entries are kept in update order, so find the first entry past the requested update by binary search
+  int lo = 0;
+  int hi = m_entries.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_entries[mid].update > update) hi = mid;
+    else lo = mid + 1;
+  }
   
   if (exact) {
-    for (int i = 0; i < m_entries.GetSize(); i++) {
-      if (update == m_entries[i].update) {
-        entry = i;
-        break;
-      }
-    }
-  } else {
-    // Find the update that is closest to the born update, round down
-    entry = 0;
-    for (; entry < m_entries.GetSize(); entry++) if (m_entries[entry].update > update) break;
-    if (entry > 0) entry--;
+    // Of several entries for the same update, the first one recorded is used
+    int entry = lo - 1;
+    if (entry < 0 || m_entries[entry].update != update) return -1;
+    while (entry > 0 && m_entries[entry - 1].update == update) entry--;
+    return entry;
   }
+  
+  // Find the update that is closest to the born update, round down
+  return (lo > 0) ? lo - 1 : 0;
+}
 
-  return entry;
+
+void cResourceHistory::insertSorted(int entry)
+{
+  // Move the entry back past any later updates, keeping entries for equal updates in the order they were added
+  while (entry > 0 && m_entries[entry - 1].update > m_entries[entry].update) {
+    sResourceHistoryEntry tmp = m_entries[entry - 1];
+    m_entries[entry - 1] = m_entries[entry];
+    m_entries[entry] = tmp;
+    entry--;
+  }
 }
 
 bool cResourceHistory::GetResourceCountForUpdate(cAvidaContext& ctx, int update, cResourceCount& rc, bool exact) const
@@ -87,6 +101,7 @@ void cResourceHistory::AddEntry(int update, const Apto::Array<double>& values)
   m_entries.Resize(new_entry + 1);
   m_entries[new_entry].update = update;
   m_entries[new_entry].values = values;
+  insertSorted(new_entry);
 }
 
 bool cResourceHistory::LoadFile(const cString& filename, const cString& working_dir)
@@ -111,6 +126,7 @@ bool cResourceHistory::LoadFile(const cString& filename, const cString& working_
     int num_values = cur_line.GetSize();
     m_entries[line].values.Resize(num_values);
     for (int i = 0; i < num_values; i++) m_entries[line].values[i] = cur_line.Pop().AsDouble();
+    insertSorted(line);
   }
   
   return true;
@@ -41,6 +41,7 @@ private:
   
   
   int getEntryForUpdate(int update, bool exact) const;
+  void insertSorted(int entry);
   
   
   cResourceHistory(const cResourceHistory&); // @not_implemented
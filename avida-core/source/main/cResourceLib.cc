@@ -38,8 +38,11 @@ cResource* cResourceLib::AddResource(const cString& res_name)
 {
   if (m_initial_levels) return NULL; // Initial levels calculated, cannot add more resources
   
-  const int new_id = m_resource_array.GetSize();
-  cResource* new_resource = new cResource(res_name, new_id);
+  // If this resource already exists, just return it.
+  const int new_id = m_names.Intern(res_name);
+  if (new_id < m_resource_array.GetSize()) return m_resource_array[new_id];
+  
+  cResource* new_resource = new cResource(m_names.GetName(new_id), new_id);
   m_resource_array.Resize(new_id + 1);
   m_resource_array[new_id] = new_resource;
   
@@ -48,9 +51,8 @@ cResource* cResourceLib::AddResource(const cString& res_name)
 
 cResource* cResourceLib::GetResource(const cString& res_name) const
 {
-  for (int i = 0; i < m_resource_array.GetSize(); i++) {
-    if (m_resource_array[i]->GetName() == res_name) return m_resource_array[i];
-  }
+  const int res_id = m_names.Find(res_name);
+  if (res_id != -1) return m_resource_array[res_id];
   cerr << "Error: Unknown resource '" << res_name << "'." << endl;
   return NULL;
 }
@@ -71,8 +73,7 @@ const cResourceHistory& cResourceLib::GetInitialResourceLevels() const
 
 bool cResourceLib::DoesResourceExist(const cString& res_name) 
 {
-  for (int i = 0; i < m_resource_array.GetSize(); i++) if (m_resource_array[i]->GetName() == res_name) return true;
-  return false;
+  return (m_names.Find(res_name) != -1);
 }
 
 /* This assigns an index to a resource within its own type (deme vs. non-deme)
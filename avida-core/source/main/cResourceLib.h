@@ -25,15 +25,17 @@
 
 #include "avida/core/Types.h"
 
+#include "cStringIntern.h"
+
 class cResource;
 class cResourceHistory;
-class cString;
 
 
 class cResourceLib
 {
 private:
   Apto::Array<cResource*> m_resource_array;
+  cStringIntern m_names;                      // handle of each name is its resource id
   mutable cResourceHistory* m_initial_levels;
   int m_num_deme_resources;
   
@@ -49,6 +51,7 @@ public:
   cResource* AddResource(const cString& res_name);
   cResource* GetResource(const cString& res_name) const;
   inline cResource* GetResource(int id) const { return m_resource_array[id]; }
+  inline int GetResourceID(const cString& res_name) const { return m_names.Find(res_name); }
   const cResourceHistory& GetInitialResourceLevels() const;
   bool DoesResourceExist(const cString& res_name);
   void SetResourceIndex(cResource* res);
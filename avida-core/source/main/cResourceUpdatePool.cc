@@ -0,0 +1,135 @@
+/*
+ *  cResourceUpdatePool.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cResourceUpdatePool.h"
+
+#include "apto/platform.h"
+#include "apto/rng.h"
+
+#include "cAvidaContext.h"
+#include "cResourceCount.h"
+#include "cWorld.h"
+
+
+cResourceUpdatePool::cResourceUpdatePool(cWorld* world, int num_resources, int num_threads)
+: m_world(world), m_res_count(NULL), m_res_ids(NULL), m_num_updates(0)
+, m_pass(0), m_num_jobs(0), m_next_job(0), m_jobs_done(0), m_terminate(false)
+{
+  // Seed the per-resource streams from the master RNG, in resource order
+  m_res_rng.Resize(num_resources);
+  for (int i = 0; i < m_res_rng.GetSize(); i++) {
+    m_res_rng[i] = new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed()));
+  }
+  
+  if (num_threads < 0) num_threads = Apto::Platform::AvailableCPUs();
+  if (num_threads > num_resources) num_threads = num_resources;
+  
+  if (num_threads > 1) {
+    m_workers.Resize(num_threads);
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i] = new cWorker(this);
+      m_workers[i]->Start();
+    }
+  }
+}
+
+cResourceUpdatePool::~cResourceUpdatePool()
+{
+  m_mutex.Lock();
+  m_terminate = true;
+  m_pass++;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+  
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+  
+  for (int i = 0; i < m_res_rng.GetSize(); i++) delete m_res_rng[i];
+}
+
+
+void cResourceUpdatePool::UpdateResources(const cResourceCount* res_count, const Apto::Array<int>& res_ids, int num_updates)
+{
+  m_res_count = res_count;
+  m_res_ids = &res_ids;
+  m_num_updates = num_updates;
+  
+  if (m_workers.GetSize() && res_ids.GetSize() > 1) {
+    m_mutex.Lock();
+    m_next_job = 0;
+    m_jobs_done = 0;
+    m_num_jobs = res_ids.GetSize();
+    m_pass++;
+    m_mutex.Unlock();
+    m_cond.Broadcast();
+    
+    // Barrier: wait for all resources to complete before anything else reads them
+    m_mutex.Lock();
+    while (m_jobs_done < m_num_jobs) m_done_cond.Wait(m_mutex);
+    m_mutex.Unlock();
+  } else {
+    for (int i = 0; i < res_ids.GetSize(); i++) processResource(i);
+  }
+}
+
+
+void cResourceUpdatePool::processResource(int job_id)
+{
+  const int res_id = (*m_res_ids)[job_id];
+  assert(res_id < m_res_rng.GetSize());
+  
+  cAvidaContext ctx(&m_world->GetDriver(), m_res_rng[res_id]);
+  m_res_count->DoSpatialUpdates(ctx, res_id, m_num_updates);
+}
+
+
+void cResourceUpdatePool::cWorker::Run()
+{
+  int last_pass = 0;
+  
+  while (1) {
+    m_pool->m_mutex.Lock();
+    while (m_pool->m_pass == last_pass) m_pool->m_cond.Wait(m_pool->m_mutex);
+    last_pass = m_pool->m_pass;
+    m_pool->m_mutex.Unlock();
+    
+    if (m_pool->m_terminate) break;
+    
+    while (1) {
+      m_pool->m_mutex.Lock();
+      const int num_jobs = m_pool->m_num_jobs;
+      int job_id = m_pool->m_next_job;
+      if (job_id < num_jobs) m_pool->m_next_job++;
+      m_pool->m_mutex.Unlock();
+      
+      if (job_id >= num_jobs) break;
+      
+      m_pool->processResource(job_id);
+      
+      m_pool->m_mutex.Lock();
+      bool all_done = (++m_pool->m_jobs_done == num_jobs);
+      m_pool->m_mutex.Unlock();
+      if (all_done) m_pool->m_done_cond.Signal();
+    }
+  }
+}
@@ -0,0 +1,89 @@
+/*
+ *  cResourceUpdatePool.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cResourceUpdatePool_h
+#define cResourceUpdatePool_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+class cResourceCount;
+class cWorld;
+
+
+// cResourceUpdatePool runs the spatial updates of independent resources of a cResourceCount on a set of worker threads.
+// Only resources whose update touches nothing but their own grid are handed to the pool (see
+// cSpatialResCount::AffectsPopulation); the caller processes everything else serially once the pool has finished.
+//
+// Each resource draws from its own RNG stream, seeded from the master RNG when the pool is built, so gradient peak
+// movement is reproducible regardless of the number of threads or how resources are distributed across them.
+
+class cResourceUpdatePool
+{
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cResourceUpdatePool* m_pool;
+    
+    void Run();
+    
+  public:
+    cWorker(cResourceUpdatePool* pool) : m_pool(pool) { ; }
+  };
+  
+  cWorld* m_world;
+  
+  Apto::Array<Apto::Random*> m_res_rng;
+  Apto::Array<cWorker*> m_workers;
+  
+  // Current batch
+  const cResourceCount* m_res_count;
+  const Apto::Array<int>* m_res_ids;
+  int m_num_updates;
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_done_cond;
+  
+  volatile int m_pass;        // incremented to release workers for a new batch
+  volatile int m_num_jobs;    // number of resources in the current batch
+  volatile int m_next_job;    // next entry of m_res_ids to be claimed by a worker during the current batch
+  volatile int m_jobs_done;   // number of resources completed during the current batch
+  volatile bool m_terminate;
+  
+  void processResource(int job_id);
+  
+  cResourceUpdatePool(); // @not_implemented
+  cResourceUpdatePool(const cResourceUpdatePool&); // @not_implemented
+  cResourceUpdatePool& operator=(const cResourceUpdatePool&); // @not_implemented
+  
+public:
+  cResourceUpdatePool(cWorld* world, int num_resources, int num_threads);
+  ~cResourceUpdatePool();
+  
+  int GetNumThreads() const { return (m_workers.GetSize()) ? m_workers.GetSize() : 1; }
+  
+  // Perform num_updates spatial updates of each resource in res_ids, blocking until all of them have finished
+  void UpdateResources(const cResourceCount* res_count, const Apto::Array<int>& res_ids, int num_updates);
+};
+
+#endif
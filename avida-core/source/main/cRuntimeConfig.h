@@ -0,0 +1,64 @@
+/*
+ *  cRuntimeConfig.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cRuntimeConfig_h
+#define cRuntimeConfig_h
+
+
+// cRuntimeConfig is a compact copy of the configuration settings read on per cycle, per output and per divide paths, so
+// that those paths read a single flat struct instead of chasing into the cAvidaConfig entries.  The world owns the
+// copy and rebuilds it in place whenever settings may have changed (after each round of events, after birth interrupt
+// events and after an analyze SET), so readers may hold a reference to it for their whole lifetime.
+
+struct cRuntimeConfig
+{
+  // Per cycle
+  bool energy_enabled;
+  int task_switch_penalty_type;
+  int task_switch_penalty;
+  int implicit_repro_time;
+  int implicit_repro_cpu_cycles;
+  int implicit_repro_bonus;
+  int implicit_repro_end;
+  double implicit_repro_energy;
+  
+  // Per input/output
+  int use_avatars;
+  bool save_received;
+  bool merit_inc_apply_immediate;
+  int apply_energy_method;
+  double task_refractory_period;
+  bool age_poly_tracking;
+  int learning_count;
+  
+  // Per divide
+  int juv_period;
+  int min_cycles;
+  double offspring_size_range;
+  int max_genome_size;
+  int min_genome_size;
+  double min_exe_lines;
+  double min_copied_lines;
+  int use_form_groups;
+  int default_group;
+  int divide_failure_resets;
+};
+
+#endif
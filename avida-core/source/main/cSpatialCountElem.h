@@ -30,8 +30,6 @@ class cSpatialCountElem
 {
 private:
   mutable double amount, delta, initial;
-  Apto::Array<int> elempt, xdist, ydist;
-  Apto::Array<double> dist;
   
 public:
   cSpatialCountElem();
@@ -40,12 +38,9 @@ public:
   void Rate(double ratein) const { delta += ratein; }
   void State() { amount += delta; delta = 0.0; }
   double GetAmount() const { return amount; }
+  double GetDelta() const { return delta; }
+  void ClearDelta() const { delta = 0.0; }
   void SetAmount(double res) const { amount = res; }
-  void SetPtr(int innum, int inelempt, int inxdist, int  inydist, double indist);
-  int GetElemPtr(int innum) { return elempt[innum]; }
-  int GetPtrXdist(int innum) { return xdist[innum]; }
-  int GetPtrYdist(int innum) { return ydist[innum]; }
-  double GetPtrDist(int innum) { return dist[innum]; }
   friend void FlowMatter(cSpatialCountElem&, cSpatialCountElem&, double, double, double, double,
                          int, int, double);
   void SetInitial(double init) { initial = init; }
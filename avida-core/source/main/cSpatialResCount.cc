@@ -22,6 +22,7 @@
 #include "cSpatialResCount.h"
 
 #include "AvidaTools.h"
+#include "cNUMAPlacement.h"
 #include "nGeometry.h"
 
 #include <cmath>
@@ -33,7 +34,7 @@ using namespace AvidaTools;
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry, double inxdiffuse, double inydiffuse,
                                    double inxgravity, double inygravity)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false), m_step_scale(1), m_flow_tolerance(0.0)
 {
   int i;
  
@@ -55,7 +56,7 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry,
 /* Setup a single spatial resource using default flow amounts  */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
-: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+: grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false), m_step_scale(1), m_flow_tolerance(0.0)
 {
   int i;
  
@@ -75,6 +76,7 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
 }
 
 cSpatialResCount::cSpatialResCount() : m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0), m_modified(false)
+  , m_step_scale(1), m_flow_tolerance(0.0)
 {
   geometry = nGeometry::GLOBAL;
 }
@@ -98,55 +100,42 @@ void cSpatialResCount::ResizeClear(int inworld_x, int inworld_y, int ingeometry)
    SetPointers();
 }
 
-void cSpatialResCount::SetPointers()
-{
-  /* Pointer 0 will point to the cell above and to the left the current cell
-     and will go clockwise around the cell.                               */
+/* The forward flow directions: right, below right, below and below left.  Flow between two cells is computed once,
+   from the cell above (or to the left), so these are the only links a cell needs. */
 
-  int     i,ii;
-  double  SQRT2 = sqrt(2.0);
+static const int FLOW_XDIST[] = { +1, +1, 0, -1 };
+static const int FLOW_YDIST[] = { 0, +1, +1, +1 };
+static const double FLOW_DIST[] = { 1.0, sqrt(2.0), 1.0, sqrt(2.0) };
 
+void cSpatialResCount::SetPointers()
+{
   /* First treat all cells like they are in a torus */
 
-  for (i = 0; i < GetSize(); i++) {
-    grid[i].SetPtr(0 ,GridNeighbor(i, world_x, world_y, -1, -1), -1, -1, SQRT2);
-    grid[i].SetPtr(1 ,GridNeighbor(i, world_x, world_y,  0, -1),  0, -1, 1.0);
-    grid[i].SetPtr(2 ,GridNeighbor(i, world_x, world_y, +1, -1), +1, -1, SQRT2);
-    grid[i].SetPtr(3 ,GridNeighbor(i, world_x, world_y, +1,  0), +1,  0, 1.0);
-    grid[i].SetPtr(4 ,GridNeighbor(i, world_x, world_y, +1, +1), +1, +1, SQRT2);
-    grid[i].SetPtr(5 ,GridNeighbor(i, world_x, world_y,  0, +1),  0, +1, 1.0);
-    grid[i].SetPtr(6 ,GridNeighbor(i, world_x, world_y, -1, +1), -1, +1, SQRT2);
-    grid[i].SetPtr(7 ,GridNeighbor(i, world_x, world_y, -1,  0), -1,  0, 1.0);
+  for (int k = 0; k < NUM_FLOW_DIRS; k++) {
+    m_flow_nbr[k].ResizeClear(num_cells);
+    for (int i = 0; i < num_cells; i++) {
+      m_flow_nbr[k][i] = GridNeighbor(i, world_x, world_y, FLOW_XDIST[k], FLOW_YDIST[k]);
+    }
   }
  
-  /* Fix links for top, bottom and sides for non-torus */
+  /* Fix links for bottom and sides for non-torus */
   
   if (geometry == nGeometry::GRID) {
-    /* Top and bottom */
-
-    for (i = 0; i < world_x; i++) {
-      grid[i].SetPtr(0, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[i].SetPtr(1, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[i].SetPtr(2, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      ii = num_cells-1-i;
-      grid[ii].SetPtr(4, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(5, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(6, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
+    for (int i = num_cells - world_x; i < num_cells; i++) {
+      m_flow_nbr[1][i] = cResource::NONE;
+      m_flow_nbr[2][i] = cResource::NONE;
+      m_flow_nbr[3][i] = cResource::NONE;
     }
-
-    /* fix links for right and left sides */
-
-    for (i = 0; i < world_y; i++) {
-      ii = i * world_x;    
-      grid[ii].SetPtr(0, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(7, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(6, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      ii = ((i + 1) * world_x) - 1;
-      grid[ii].SetPtr(2, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(3, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(4, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
+    for (int i = 0; i < world_y; i++) {
+      m_flow_nbr[3][i * world_x] = cResource::NONE;
+      m_flow_nbr[0][(i + 1) * world_x - 1] = cResource::NONE;
+      m_flow_nbr[1][(i + 1) * world_x - 1] = cResource::NONE;
     }
   }
+  
+  m_amount_buf.ResizeClear(num_cells);
+  m_delta_buf.ResizeClear(num_cells);
+  m_flow_buf.ResizeClear(NUM_FLOW_DIRS * world_x);
 }
 
 
@@ -212,22 +201,50 @@ void cSpatialResCount::CheckRanges()
 
 }
 
+/* Move the grid elements of each cell to the NUMA node that cell_node assigns it */
+void cSpatialResCount::PlaceOnNodes(const cNUMAPlacement& numa, const Apto::Array<int>& cell_node) const
+{
+  if (grid.GetSize() != cell_node.GetSize() || grid.GetSize() == 0) return;
+  numa.BindArray(&grid[0], cell_node);
+}
+
 /* Set all the individual cells to their initial values */
 void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
 {
   cell_list_ptr = in_cell_list_ptr;
+  m_cell_ids.Resize(0);
+  m_cell_inflow.Resize(0);
+  m_cell_outflow.Resize(0);
   for (int i = 0; i < cell_list_ptr->GetSize(); i++) {
-    int cell_id = (*cell_list_ptr)[i].GetId();
+    const cCellResource& cell_res = (*cell_list_ptr)[i];
+    const int cell_id = cell_res.GetId();
     
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id <= grid.GetSize()) {
-      Rate((*cell_list_ptr)[i].GetId(), (*cell_list_ptr)[i].GetInitial());
-      State((*cell_list_ptr)[i].GetId());
-      Element(cell_id).SetInitial((*cell_list_ptr)[i].GetInitial());
+    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+      Rate(cell_id, cell_res.GetInitial());
+      State(cell_id);
+      Element(cell_id).SetInitial(cell_res.GetInitial());
+      
+      m_cell_ids.Push(cell_id);
+      m_cell_inflow.Push(cell_res.GetInflow());
+      m_cell_outflow.Push(cell_res.GetOutflow());
     }
   }
+  scaleCellOutflow();
+}
+
+/* Compound the cell outflow fractions over the step scale, so that one scaled step removes what m_step_scale
+   individual steps would have */
+
+void cSpatialResCount::scaleCellOutflow()
+{
+  m_cell_outflow_step = m_cell_outflow;
+  if (m_step_scale == 1) return;
+  for (int i = 0; i < m_cell_outflow_step.GetSize(); i++) {
+    m_cell_outflow_step[i] = 1.0 - pow(1.0 - m_cell_outflow[i], m_step_scale);
+  }
 }
 
 /* Set the rate variable for one element using the array index */
@@ -318,27 +335,156 @@ void cSpatialResCount::FlowAll() {
   // @JEB save time if diffusion and gravity off...
   if ((xdiffuse == 0.0) && (ydiffuse == 0.0) && (xgravity == 0.0) && (ygravity == 0.0)) return;
 
-  int     i,k,ii,xdist,ydist;
-  double  dist;
- 
-  for (i = 0; i < num_cells; i++) {
+  for (int i = 0; i < num_cells; i++) {
       
     /* because flow is two way we must check only half the neighbors to 
        prevent double flow calculations */
 
-    for (k = 3; k <= 6; k++) {
-      ii = grid[i].GetElemPtr(k);
-      xdist = grid[i].GetPtrXdist(k);
-      ydist = grid[i].GetPtrYdist(k);
-      dist = grid[i].GetPtrDist(k);
+    for (int k = 0; k < NUM_FLOW_DIRS; k++) {
+      const int ii = m_flow_nbr[k][i];
       if (ii >= 0) {
         FlowMatter(grid[i],grid[ii],xdiffuse,ydiffuse,xgravity,ygravity,
-                   xdist, ydist, dist);
+                   FLOW_XDIST[k], FLOW_YDIST[k], FLOW_DIST[k]);
       }
     }
   }
 }
 
+/* Same calculation as FlowMatter, for amounts pulled out of the grid.  The expression is kept term for term so that
+   StepAll() produces the same values as FlowAll(). */
+
+inline double cSpatialResCount::flowAmount(double amount1, double amount2, int xdist, int ydist, double dist) const
+{
+  const double diff = amount1 - amount2;
+  double xflow = 0.0, yflow = 0.0, xgrav = 0.0, ygrav = 0.0;
+  
+  if (xdist != 0) {
+    if (((xdist > 0) && (xgravity > 0.0)) || ((xdist < 0) && (xgravity < 0.0))) {
+      xgrav = amount1 * fabs(xgravity) / 3.0;
+    } else {
+      xgrav = -amount2 * fabs(xgravity) / 3.0;
+    }
+    xflow = xdiffuse * diff / 16.0;
+  }
+  if (ydist != 0) {
+    if (((ydist > 0) && (ygravity > 0.0)) || ((ydist < 0) && (ygravity < 0.0))) {
+      ygrav = amount1 * fabs(ygravity) / 3.0;
+    } else {
+      ygrav = -amount2 * fabs(ygravity) / 3.0;
+    }
+    yflow = ydiffuse * diff / 16.0;
+  }
+  
+  return ((xflow + yflow + xgrav + ygrav) / (fabs(xdist * 1.0) + fabs(ydist * 1.0))) / dist;
+}
+
+/* Does the row starting at row_start differ from its flow neighbors by less than the flow tolerance? */
+
+inline bool cSpatialResCount::rowIsFlat(int row_start) const
+{
+  double lo = m_amount_buf[row_start];
+  double hi = lo;
+  for (int x = 0; x < world_x; x++) {
+    const double amount = m_amount_buf[row_start + x];
+    lo = Apto::Min(lo, amount);
+    hi = Apto::Max(hi, amount);
+    for (int k = 0; k < NUM_FLOW_DIRS; k++) {
+      const int ii = m_flow_nbr[k][row_start + x];
+      if (ii >= 0) {
+        lo = Apto::Min(lo, m_amount_buf[ii]);
+        hi = Apto::Max(hi, m_amount_buf[ii]);
+      }
+    }
+  }
+  return (hi - lo) < m_flow_tolerance;
+}
+
+/* Perform one full time step of the resource: inflow, outflow, diffusion/gravity and folding the deltas into the
+   amounts.  This is equivalent to calling UpdateCount, Source, Sink, CellInflow, CellOutflow, FlowAll and StateAll in
+   turn, but works on contiguous amount and delta buffers so the whole grid is touched only on the way in and out.
+   Contributions are accumulated in the same order as the individual passes, keeping results bit for bit identical.
+   With a step scale above one, or a flow tolerance, the step approximates several updates at once instead. */
+
+void cSpatialResCount::StepAll(cAvidaContext& ctx, double inflow, double decay)
+{
+  UpdateCount(ctx);
+  
+  // Gather
+  for (int i = 0; i < num_cells; i++) {
+    m_amount_buf[i] = grid[i].GetAmount();
+    m_delta_buf[i] = grid[i].GetDelta();
+  }
+  
+  // Source
+  const double totalcells = (inflowY2 - inflowY1 + 1) * (inflowX2 - inflowX1 + 1) * 1.0;
+  const double cell_inflow = inflow / totalcells;
+  for (int i = inflowY1; i <= inflowY2; i++) {
+    for (int j = inflowX1; j <= inflowX2; j++) {
+      m_delta_buf[(Mod(i, world_y) * world_x) + Mod(j, world_x)] += cell_inflow;
+    }
+  }
+  
+  // Sink
+  if (outflowX1 != cResource::NONE && outflowY1 != cResource::NONE &&
+      outflowX2 != cResource::NONE && outflowY2 != cResource::NONE) {
+    for (int i = outflowY1; i <= outflowY2; i++) {
+      for (int j = outflowX1; j <= outflowX2; j++) {
+        const int elem = (Mod(i, world_y) * world_x) + Mod(j, world_x);
+        m_delta_buf[elem] += -Apto::Max((m_amount_buf[elem] * (1.0 - decay)), 0.0);
+      }
+    }
+  }
+  
+  // Individual cell inflow and outflow
+  const double step_scale = m_step_scale;
+  const int num_cell_res = m_cell_ids.GetSize();
+  for (int i = 0; i < num_cell_res; i++) m_delta_buf[m_cell_ids[i]] += m_cell_inflow[i] * step_scale;
+  for (int i = 0; i < num_cell_res; i++) {
+    const int cell_id = m_cell_ids[i];
+    m_delta_buf[cell_id] += -Apto::Max((m_amount_buf[cell_id] * m_cell_outflow_step[i]), 0.0);
+  }
+  
+  // Diffusion and gravity, one row at a time.  The flows of a row only depend on the amounts, so they are computed
+  // first in a tight loop per direction (amenable to vectorization) and then scattered in the original order.
+  // Gravity moves matter whatever the gradient, so flat rows are only skipped for pure diffusion.
+  if ((xdiffuse != 0.0) || (ydiffuse != 0.0) || (xgravity != 0.0) || (ygravity != 0.0)) {
+    const bool skip_flat = (m_flow_tolerance > 0.0) && (xgravity == 0.0) && (ygravity == 0.0);
+    
+    for (int row_start = 0; row_start < num_cells; row_start += world_x) {
+      if (skip_flat && rowIsFlat(row_start)) continue;
+      
+      for (int k = 0; k < NUM_FLOW_DIRS; k++) {
+        const Apto::Array<int>& nbr = m_flow_nbr[k];
+        const int offset = k * world_x;
+        for (int x = 0; x < world_x; x++) {
+          const int ii = nbr[row_start + x];
+          m_flow_buf[offset + x] = (ii >= 0) ?
+            flowAmount(m_amount_buf[row_start + x], m_amount_buf[ii], FLOW_XDIST[k], FLOW_YDIST[k], FLOW_DIST[k]) * step_scale :
+            0.0;
+        }
+      }
+      
+      for (int x = 0; x < world_x; x++) {
+        const int i = row_start + x;
+        for (int k = 0; k < NUM_FLOW_DIRS; k++) {
+          const int ii = m_flow_nbr[k][i];
+          if (ii >= 0) {
+            const double flowamt = m_flow_buf[k * world_x + x];
+            m_delta_buf[i] -= flowamt;
+            m_delta_buf[ii] += flowamt;
+          }
+        }
+      }
+    }
+  }
+  
+  // Fold the deltas into the amounts and scatter back into the grid
+  for (int i = 0; i < num_cells; i++) {
+    grid[i].SetAmount(m_amount_buf[i] + m_delta_buf[i]);
+    grid[i].ClearDelta();
+  }
+}
+
 /* Total up all the resources in each cell */
 
 double cSpatialResCount::SumAll() const{
@@ -373,16 +519,7 @@ void cSpatialResCount::Source(double amount) const {
 /* Handle the inflow for a list of individual cells */
 
 void cSpatialResCount::CellInflow() const {
-  for (int i=0; i < cell_list_ptr->GetSize(); i++) {
-    const int cell_id = (*cell_list_ptr)[i].GetId();
-    
-    /* Be sure the user entered a valid cell id or if the the program is loading
-       the resource for the testCPU that does not have a grid set up */
-       
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
-      Rate(cell_id, (*cell_list_ptr)[i].GetInflow());
-    }
-  }
+  for (int i = 0; i < m_cell_ids.GetSize(); i++) grid[m_cell_ids[i]].Rate(m_cell_inflow[i]);
 }
 
 /* Take away a give percentage of a resource from outflow rectangle */
@@ -406,19 +543,9 @@ void cSpatialResCount::Sink(double decay) const {
 /* Take away a give percentage of a resource from individual cells */
 
 void cSpatialResCount::CellOutflow() const {
-
-  double deltaamount = 0.0;
-
-  for (int i=0; i < cell_list_ptr->GetSize(); i++) {
-    const int cell_id = (*cell_list_ptr)[i].GetId();
-    
-    /* Be sure the user entered a valid cell id or if the the program is loading
-       the resource for the testCPU that does not have a grid set up */
-       
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
-      deltaamount = Apto::Max((GetAmount(cell_id) * (*cell_list_ptr)[i].GetOutflow()), 0.0);
-    }                     
-    Rate((*cell_list_ptr)[i].GetId(), -deltaamount); 
+  for (int i = 0; i < m_cell_ids.GetSize(); i++) {
+    const int cell_id = m_cell_ids[i];
+    grid[cell_id].Rate(-Apto::Max((grid[cell_id].GetAmount() * m_cell_outflow[i]), 0.0));
   }
 }
 
@@ -29,6 +29,8 @@
 #include "cSpatialCountElem.h"
 #include "cResource.h"
 
+class cNUMAPlacement;
+
 
 class cSpatialResCount
 {
@@ -50,6 +52,30 @@ private:
   Apto::Array<cCellResource> *cell_list_ptr;
   bool m_modified;
   
+  // The grid elements only hold amounts, the four forward flow neighbors of every cell are kept in flat per direction
+  // tables (NONE past the edges of a bounded grid).  StepAll() works on contiguous copies of the amounts and deltas.
+  static const int NUM_FLOW_DIRS = 4;
+  Apto::Array<int> m_flow_nbr[NUM_FLOW_DIRS];
+  mutable Apto::Array<double> m_amount_buf;
+  mutable Apto::Array<double> m_delta_buf;
+  mutable Apto::Array<double> m_flow_buf;
+  
+  // Flat copy of the valid entries of the cell list, built by SetCellList(), so that the individual cell inflow and
+  // outflow are plain gather/scatter loops over contiguous index and rate arrays.
+  Apto::Array<int> m_cell_ids;
+  Apto::Array<double> m_cell_inflow;
+  Apto::Array<double> m_cell_outflow;
+  Apto::Array<double> m_cell_outflow_step;  // m_cell_outflow compounded over m_step_scale updates
+  
+  // Slow resources may take a single StepAll() per several updates, with the inflows, outflows and flows scaled to
+  // the whole interval.  Rows whose neighborhood varies by less than m_flow_tolerance skip diffusion altogether.
+  int m_step_scale;
+  double m_flow_tolerance;
+
+  void scaleCellOutflow();
+  inline bool rowIsFlat(int row_start) const;
+  inline double flowAmount(double amount1, double amount2, int xdist, int ydist, double dist) const;
+  
 public:
   cSpatialResCount();
   cSpatialResCount(int inworld_x, int inworld_y, int ingeometry);
@@ -62,6 +88,7 @@ public:
   void SetPointers();
   void CheckRanges();
   void SetCellList(Apto::Array<cCellResource> *in_cell_list_ptr);
+  void PlaceOnNodes(const cNUMAPlacement& numa, const Apto::Array<int>& cell_node) const;
   int GetSize() const { return grid.GetSize(); }
   int GetX() const { return world_x; }
   int GetY() const { return world_y; }
@@ -76,12 +103,16 @@ public:
   void RateAll(double ratein); 
   virtual void StateAll();
   void FlowAll(); 
+  virtual void StepAll(cAvidaContext& ctx, double inflow, double decay);
   double SumAll() const;
   void Source(double amount) const;
   void CellInflow() const;
   void Sink(double percent) const;
   void CellOutflow() const;
   void SetCellAmount(int cell_id, double res);
+  void SetStepScale(int scale) { m_step_scale = scale; scaleCellOutflow(); }
+  int GetStepScale() const { return m_step_scale; }
+  void SetFlowTolerance(double tolerance) { m_flow_tolerance = tolerance; }
   void SetInitial(double initial) { m_initial = initial; }
   double GetInitial() const { return m_initial; }
   void SetGeometry(int in_geometry) { geometry = in_geometry; }
@@ -98,6 +129,8 @@ public:
   void SetOutflowY1(int in_outflowY1) { outflowY1 = in_outflowY1; }
   void SetOutflowY2(int in_outflowY2) { outflowY2 = in_outflowY2; }
   virtual void UpdateCount(cAvidaContext&) { ; }
+  // Does updating this resource reach outside of its own grid (e.g. kill or damage organisms)?
+  virtual bool AffectsPopulation() const { return false; }
   void ResetResourceCounts();
   void SetModified(bool in_modified) { m_modified = in_modified; }
   bool GetModified() { return m_modified; }
@@ -29,6 +29,8 @@
 #include "avida/data/Util.h"
 #include "avida/output/File.h"
 
+#include "avida/private/util/MemoryStats.h"
+
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
@@ -38,6 +40,7 @@
 #include "cDeme.h"
 #include "cMigrationMatrix.h"
 #include "cStringUtil.h"
+#include "cUpdateProfiler.h"
 #include "cWorld.h"
 #include "tDataEntry.h"
 #include "cOrgMessage.h"
@@ -80,6 +83,8 @@ cStats::cStats(cWorld* world)
 , num_breed_true(0)
 , num_breed_true_creatures(0)
 , num_creatures(0)
+, m_org_stats_sample_size(0)
+, m_org_stats_population(0)
 , num_executed(0)
 , num_parasites(0)
 , num_no_birth_creatures(0)
@@ -107,6 +112,8 @@ cStats::cStats(cWorld* world)
 , m_spec_total(0)
 , m_spec_num(0)
 , m_spec_waste(0)
+, m_sched_adjustments(0)
+, m_sched_adjustments_redundant(0)
 , num_migrations(0)
 , m_num_successful_mates(0)
 , prey_entropy(0.0)
@@ -123,10 +130,18 @@ cStats::cStats(cWorld* world)
   const cEnvironment& env = m_world->GetEnvironment();
   const int num_tasks = env.GetNumTasks();
   
+  for (int i = 0; i < NUM_SPEC_HW_TYPES; i++) {
+    m_spec_hw_total[i] = 0;
+    m_spec_hw_hits[i] = 0;
+    m_spec_hw_waste[i] = 0;
+  }
+  
   task_cur_count.Resize(num_tasks);
   task_last_count.Resize(num_tasks);
   task_test_count.Resize(num_tasks);
   m_collect_env_test_stats = false;
+  m_collect_class_inst_stats = false;
+  m_collect_from_message_inst_stats = false;
   
   tasks_host_current.Resize(num_tasks);
   tasks_host_last.Resize(num_tasks);
@@ -284,9 +299,6 @@ Data::PackagePtr cStats::GetProvidedValueForArgument(const Apto::String& data_id
   
   if (Data::IsStandardID(data_id)) {
     ProvidedData data_entry;
-    if (data_id.GetSize() > 16 && data_id.Substring(0, 16) == "core.environment") {
-      m_collect_env_test_stats = true;
-    }
     if (m_provided_data.Get(data_id, data_entry)) {
       rtn = data_entry.GetData();
     }
@@ -348,6 +360,31 @@ template <class T, class U> Data::PackagePtr cStats::packageArgData(T (cStats::*
 }
 
 
+int cStats::GetTestCPUCacheHits() const { return m_world->GetHardwareManager().GetTestCPUCache().GetHits(); }
+int cStats::GetTestCPUCacheMisses() const { return m_world->GetHardwareManager().GetTestCPUCache().GetMisses(); }
+double cStats::GetTestCPUCacheHitRate() const { return m_world->GetHardwareManager().GetTestCPUCache().GetHitRate(); }
+
+template <int PHASE> double cStats::GetProfileTime() const
+{
+  return (m_world->GetProfiler()) ? m_world->GetProfiler()->GetLastTime(PHASE) : 0.0;
+}
+
+static double allocatorProperty(const char* name)
+{
+  double value = -1.0;
+  Util::MemoryStats::AllocatorProperty(name, value);
+  return value;
+}
+
+double cStats::GetAllocatedBytes() const { return allocatorProperty("generic.current_allocated_bytes"); }
+double cStats::GetHeapBytes() const { return allocatorProperty("generic.heap_size"); }
+double cStats::GetThreadCacheBytes() const { return allocatorProperty("tcmalloc.current_total_thread_cache_bytes"); }
+double cStats::GetAllocatorSlackBytes() const { return allocatorProperty("tcmalloc.slack_bytes"); }
+
+template <int SUBSYSTEM> int cStats::GetLiveObjects() const { return Util::MemoryStats::Live(SUBSYSTEM); }
+template <int SUBSYSTEM> double cStats::GetCreatedObjects() const { return Util::MemoryStats::TotalCreated(SUBSYSTEM); }
+
+
 void cStats::setupProvidedData()
 {
   // Load in all the keywords, descriptions, and associated functions for
@@ -410,12 +447,47 @@ mgr->Register(name, activate); \
   
   m_data_manager.Add("ave_speculative","Averate Speculative Instructions", &cStats::GetAveSpeculative);
   m_data_manager.Add("speculative_waste", "Speculative Execution Waste",   &cStats::GetSpeculativeWaste);
+  m_data_manager.Add("schedule_adjustments", "Schedule Adjustments",       &cStats::GetScheduleAdjustments);
+  m_data_manager.Add("redundant_schedule_adjustments", "Redundant Schedule Adjustments", &cStats::GetRedundantScheduleAdjustments);
   
   PROVIDE("core.world.ave_metabolic_rate", "Average Metabolic Rate",               double, GetAveMerit);
   PROVIDE("core.world.ave_age",            "Average Organism Age (in updates)",    double, GetAveCreatureAge);
   PROVIDE("core.world.ave_gestation_time", "Average Gestation Time",               double, GetAveGestation);
   PROVIDE("core.world.ave_fitness",        "Average Fitness",                      double, GetAveFitness);
   
+  PROVIDE("core.testcpu.cache_hits",       "Test CPU Cache Hits",                  int,    GetTestCPUCacheHits);
+  PROVIDE("core.testcpu.cache_misses",     "Test CPU Cache Misses",                int,    GetTestCPUCacheMisses);
+  PROVIDE("core.testcpu.cache_hit_rate",   "Test CPU Cache Hit Rate",              double, GetTestCPUCacheHitRate);
+  
+  // Update profile (PROFILE_UPDATES), seconds spent in each phase of the last update
+  PROVIDE("core.profile.events",           "Event Processing Time",                double, GetProfileTime<cUpdateProfiler::EVENTS>);
+  PROVIDE("core.profile.pre_update",       "Pre-Update Time",                      double, GetProfileTime<cUpdateProfiler::PRE_UPDATE>);
+  PROVIDE("core.profile.stats",            "Stats Update Time",                    double, GetProfileTime<cUpdateProfiler::STATS>);
+  PROVIDE("core.profile.tiles",            "Tile Pre-Execution Time",              double, GetProfileTime<cUpdateProfiler::TILES>);
+  PROVIDE("core.profile.execute",          "Organism Execution Time",              double, GetProfileTime<cUpdateProfiler::EXECUTE>);
+  PROVIDE("core.profile.deme_checks",      "Deme Replication Check Time",          double, GetProfileTime<cUpdateProfiler::DEME_CHECKS>);
+  PROVIDE("core.profile.resources",        "Resource Update Time",                 double, GetProfileTime<cUpdateProfiler::RESOURCES>);
+  PROVIDE("core.profile.demes",            "Deme Update Time",                     double, GetProfileTime<cUpdateProfiler::DEMES>);
+  PROVIDE("core.profile.post_update",      "Post-Update Time",                     double, GetProfileTime<cUpdateProfiler::POST_UPDATE>);
+  PROVIDE("core.profile.point_mutations",  "Point Mutation Time",                  double, GetProfileTime<cUpdateProfiler::POINT_MUTATIONS>);
+  PROVIDE("core.profile.world_update",     "World Update Time",                    double, GetProfileTime<cUpdateProfiler::WORLD_UPDATE>);
+  
+  // Memory, allocator bytes from the bundled tcmalloc and TRACK_ALLOCATIONS object counts
+  PROVIDE("core.memory.allocated_bytes",   "Bytes Allocated",                      double, GetAllocatedBytes);
+  PROVIDE("core.memory.heap_bytes",        "Allocator Heap Size",                  double, GetHeapBytes);
+  PROVIDE("core.memory.thread_cache_bytes","Allocator Thread Cache Bytes",         double, GetThreadCacheBytes);
+  PROVIDE("core.memory.slack_bytes",       "Allocator Free Bytes",                 double, GetAllocatorSlackBytes);
+  PROVIDE("core.memory.live_organisms",    "Live Organism Objects",                int,    GetLiveObjects<Util::MemoryStats::ORGANISMS>);
+  PROVIDE("core.memory.live_genotypes",    "Live Genotype Objects",                int,    GetLiveObjects<Util::MemoryStats::GENOTYPES>);
+  PROVIDE("core.memory.live_genomes",      "Live Genome Objects",                  int,    GetLiveObjects<Util::MemoryStats::GENOMES>);
+  PROVIDE("core.memory.live_phenotypes",   "Live Phenotype Objects",               int,    GetLiveObjects<Util::MemoryStats::PHENOTYPES>);
+  PROVIDE("core.memory.live_packages",     "Live Data Package Objects",            int,    GetLiveObjects<Util::MemoryStats::DATA_PACKAGES>);
+  PROVIDE("core.memory.created_organisms", "Organism Objects Created",             double, GetCreatedObjects<Util::MemoryStats::ORGANISMS>);
+  PROVIDE("core.memory.created_genotypes", "Genotype Objects Created",             double, GetCreatedObjects<Util::MemoryStats::GENOTYPES>);
+  PROVIDE("core.memory.created_genomes",   "Genome Objects Created",               double, GetCreatedObjects<Util::MemoryStats::GENOMES>);
+  PROVIDE("core.memory.created_phenotypes","Phenotype Objects Created",            double, GetCreatedObjects<Util::MemoryStats::PHENOTYPES>);
+  PROVIDE("core.memory.created_packages",  "Data Package Objects Created",         double, GetCreatedObjects<Util::MemoryStats::DATA_PACKAGES>);
+  
   
   // Maximums
   m_data_manager.Add("max_fitness", "Maximum Fitness in Population", &cStats::GetMaxFitness);
@@ -442,6 +514,7 @@ mgr->Register(name, activate); \
     
     m_provided_data[task_id] = ProvidedData(task_desc, Apto::BindFirst(taskLastCount, i));
     mgr->Register(task_id, activate);
+    m_env_test_data_ids.Push(task_id);
 	}
   
   
@@ -491,6 +564,36 @@ void cStats::ZeroTasks()
   task_internal_last_max_quality.SetAll(0);
 }
 
+void cStats::ScaleSampledOrganismCounts(double factor)
+{
+  // Per update organism counts were tallied over the sample only, scale them up to population estimates
+  for (int i = 0; i < task_cur_count.GetSize(); i++) {
+    task_cur_count[i] = int(task_cur_count[i] * factor + 0.5);
+    task_last_count[i] = int(task_last_count[i] * factor + 0.5);
+    task_test_count[i] = int(task_test_count[i] * factor + 0.5);
+    task_exe_count[i] = int(task_exe_count[i] * factor + 0.5);
+    tasks_host_current[i] = int(tasks_host_current[i] * factor + 0.5);
+    tasks_host_last[i] = int(tasks_host_last[i] * factor + 0.5);
+    tasks_parasite_current[i] = int(tasks_parasite_current[i] * factor + 0.5);
+    tasks_parasite_last[i] = int(tasks_parasite_last[i] * factor + 0.5);
+    task_internal_cur_count[i] = int(task_internal_cur_count[i] * factor + 0.5);
+    task_internal_last_count[i] = int(task_internal_last_count[i] * factor + 0.5);
+    
+    task_cur_quality[i] *= factor;
+    task_last_quality[i] *= factor;
+    task_internal_cur_quality[i] *= factor;
+    task_internal_last_quality[i] *= factor;
+  }
+  
+  for (int i = 0; i < m_reaction_cur_count.GetSize(); i++) {
+    m_reaction_cur_count[i] = int(m_reaction_cur_count[i] * factor + 0.5);
+    m_reaction_last_count[i] = int(m_reaction_last_count[i] * factor + 0.5);
+    m_reaction_exe_count[i] = int(m_reaction_exe_count[i] * factor + 0.5);
+    m_reaction_cur_add_reward[i] *= factor;
+    m_reaction_last_add_reward[i] *= factor;
+  }
+}
+
 void cStats::ZeroReactions()
 {
   m_reaction_cur_count.SetAll(0);
@@ -557,7 +660,10 @@ void cStats::ZeroMTInst()
 void cStats::RecordBirth(bool breed_true)
 {
 	if (m_world->GetEventsList()->CheckBirthInterruptQueue(tot_organisms) == true)
+	{
 		m_world->GetEventsList()->ProcessInterrupt(m_world->GetDefaultContext());
+		m_world->RefreshRuntimeConfig();
+	}
   
   tot_organisms++;
   num_births++;
@@ -567,6 +673,17 @@ void cStats::RecordBirth(bool breed_true)
   else num_breed_in++;
 }
 
+void cStats::refreshRequestedStats()
+{
+  // Environment test counts require test CPU runs on every organism, so only collect them while some recorder has
+  // requested one of the values that depend on them
+  Data::ManagerPtr mgr = m_world->GetDataManager();
+  m_collect_env_test_stats = false;
+  for (int i = 0; i < m_env_test_data_ids.GetSize() && !m_collect_env_test_stats; i++) {
+    m_collect_env_test_stats = mgr->IsRequested(m_env_test_data_ids[i]);
+  }
+}
+
 void cStats::ProcessUpdate()
 {
   // Increment the "avida_time"
@@ -580,6 +697,8 @@ void cStats::ProcessUpdate()
   }
   last_update = m_update;
   
+  refreshRequestedStats();
+  
   // Zero-out any variables which need to be cleared at end of update.
   
   num_births = 0;
@@ -622,6 +741,13 @@ void cStats::ProcessUpdate()
   m_spec_total = 0;
   m_spec_num = 0;
   m_spec_waste = 0;
+  m_sched_adjustments = 0;
+  m_sched_adjustments_redundant = 0;
+  for (int i = 0; i < NUM_SPEC_HW_TYPES; i++) {
+    m_spec_hw_total[i] = 0;
+    m_spec_hw_hits[i] = 0;
+    m_spec_hw_waste[i] = 0;
+  }
   
   num_migrations = 0;
   
@@ -1199,6 +1325,24 @@ void cStats::PrintThreadsData(const cString& filename)
 }
 
 
+void cStats::PrintSpeculativeData(const cString& filename)
+{
+  static const char* hw_names[NUM_SPEC_HW_TYPES] = { "Original", "SMT", "TransSMT", "Experimental", "GP8", "BCR" };
+  
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  df->WriteComment("Speculative execution statistics for the last update, per hardware type");
+  df->Write(m_update, "Update");
+  df->Write(GetAveSpeculative(), "Average Pre-executed Cycles per Speculation");
+  df->Write(m_spec_waste, "Total Wasted Cycles");
+  for (int i = 0; i < NUM_SPEC_HW_TYPES; i++) {
+    df->Write(m_spec_hw_total[i], cStringUtil::Stringf("%s Pre-executed", hw_names[i]));
+    df->Write(m_spec_hw_hits[i], cStringUtil::Stringf("%s Hits", hw_names[i]));
+    df->Write(m_spec_hw_waste[i], cStringUtil::Stringf("%s Wasted", hw_names[i]));
+  }
+  df->Endl();
+}
+
+
 void cStats::PrintTasksData(const cString& filename)
 {
 	cString file = filename;
@@ -1224,6 +1368,54 @@ void cStats::PrintTasksData(const cString& filename)
 	df->Endl();
 }
 
+double cStats::sampleConfidence(const cDoubleSum& sum) const
+{
+  if (!OrganismStatsSampled()) return 0.0;
+  
+  // 95% confidence half-width of the sample mean, with the finite population correction
+  const double n = m_org_stats_sample_size;
+  const double N = m_org_stats_population;
+  return 1.96 * sum.StdError() * sqrt((N - n) / (N - 1.0));
+}
+
+double cStats::sampleCountConfidence(double count) const
+{
+  if (!OrganismStatsSampled()) return 0.0;
+  
+  // count is a scaled up estimate, its sample proportion gives the binomial standard error
+  const double n = m_org_stats_sample_size;
+  const double N = m_org_stats_population;
+  const double p = count / N;
+  return 1.96 * N * sqrt(p * (1.0 - p) / n * (N - n) / (N - 1.0));
+}
+
+void cStats::PrintSampleData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  
+  df->WriteComment("Avida organism statistics sample data");
+  df->WriteTimeStamp();
+  df->WriteComment("Estimates are followed by their 95% confidence half-width, which is zero on updates with exact statistics");
+  
+  df->Write(m_update,                            "Update");
+  df->Write(OrganismStatsSampled() ? 0 : 1,      "Exact");
+  df->Write(m_org_stats_sample_size,             "Sample Size");
+  df->Write(m_org_stats_population,              "Population Size");
+  df->Write(sum_merit.Average(),                 "Merit");
+  df->Write(sampleConfidence(sum_merit),         "Merit CI");
+  df->Write(sum_gestation.Average(),             "Gestation Time");
+  df->Write(sampleConfidence(sum_gestation),     "Gestation Time CI");
+  df->Write(sum_fitness.Average(),               "Fitness");
+  df->Write(sampleConfidence(sum_fitness),       "Fitness CI");
+  df->Write(sum_generation.Average(),            "Generation");
+  df->Write(sampleConfidence(sum_generation),    "Generation CI");
+  for (int i = 0; i < task_last_count.GetSize(); i++) {
+    df->Write(task_last_count[i], task_names[i]);
+    df->Write(sampleCountConfidence(task_last_count[i]), cString(task_names[i]) + " CI");
+  }
+  df->Endl();
+}
+
 void cStats::PrintSoloTaskSnapshot(const cString& filename, cAvidaContext& ctx)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
@@ -4806,6 +4998,26 @@ void cStats::PrintProfilingData(const cString& filename) {
 	m_profiling.clear();
 }
 
+void cStats::PrintMemoryData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  
+  df->WriteComment("Memory statistics");
+  df->WriteComment("Allocator bytes are -1 when avida is not linked against tcmalloc, object counts need TRACK_ALLOCATIONS");
+  df->WriteTimeStamp();
+  df->Write(GetUpdate(), "Update [update]");
+  df->Write(GetAllocatedBytes(), "Bytes allocated [allocated_bytes]");
+  df->Write(GetHeapBytes(), "Allocator heap size [heap_bytes]");
+  df->Write(GetThreadCacheBytes(), "Bytes in thread caches [thread_cache_bytes]");
+  df->Write(GetAllocatorSlackBytes(), "Allocator free bytes [slack_bytes]");
+  for (int i = 0; i < Util::MemoryStats::NUM_SUBSYSTEMS; i++) {
+    const char* name = Util::MemoryStats::SubsystemName(i);
+    df->Write(Util::MemoryStats::Live(i), cStringUtil::Stringf("Live %s [live_%s]", name, name));
+    df->Write(Util::MemoryStats::TotalCreated(i), cStringUtil::Stringf("Created %s [created_%s]", name, name));
+  }
+  df->Endl();
+}
+
 /*! Print organism location.
  */
 void cStats::PrintOrganismLocation(const cString& filename) {
@@ -5095,7 +5307,7 @@ void cStats::UpdateTopNavTrace(cOrganism* org, bool force_update)
     topid = org->GetID();
     topbirthud = org->GetPhenotype().GetUpdateBorn();
     toprepro = org->GetPhenotype().GetNumExecs();
-    topgenome = Genome(org->SystematicsGroup("genotype")->Properties().Get("genome"));
+    topgenome = Genome(org->SystematicsGroup("genotype")->StringProperty(Systematics::GROUP_PROP_GENOME));
     
     Apto::Array<char, Apto::Smart> trace = org->GetHardware().GetMicroTrace();
     Apto::Array<int, Apto::Smart> traceloc = org->GetHardware().GetNavTraceLoc();
@@ -137,6 +137,8 @@ private:
 
 
   // --------  Genotype Sums  ---------  (Cleared and resummed by population each update)
+  int m_org_stats_sample_size;  // organisms the sums were taken over, fewer than num_creatures when sampled
+  int m_org_stats_population;
   cDoubleSum sum_gestation;
   cDoubleSum sum_fitness;
   cDoubleSum sum_repro_rate;
@@ -151,6 +153,9 @@ private:
 
 
   // --------  Instruction Counts  ---------
+  // Per organism class and from-message counts are only accumulated once something that reads them has asked
+  bool m_collect_class_inst_stats;
+  bool m_collect_from_message_inst_stats;
   Apto::Map<cString, Apto::Array<cString> > m_is_inst_names_map;
   Apto::Map<cString, Apto::Array<Apto::Stat::Accumulator<int> > > m_is_from_message_inst_map;
 
@@ -240,7 +245,8 @@ private:
 
 
   // --------  Organism Task Stats  ---------
-  mutable bool m_collect_env_test_stats;
+  bool m_collect_env_test_stats;
+  Apto::Array<Apto::String> m_env_test_data_ids;
   Apto::Array<int> task_cur_count;
   Apto::Array<int> task_last_count;
   Apto::Array<int> task_test_count;
@@ -332,6 +338,16 @@ private:
   int m_spec_total;
   int m_spec_num;
   int m_spec_waste;
+public:
+  static const int NUM_SPEC_HW_TYPES = HARDWARE_TYPE_CPU_BCR + 1;
+private:
+  int m_spec_hw_total[NUM_SPEC_HW_TYPES];  // Cycles pre-executed, per hardware type
+  int m_spec_hw_hits[NUM_SPEC_HW_TYPES];   // Pre-executed cycles later consumed by the scheduler
+  int m_spec_hw_waste[NUM_SPEC_HW_TYPES];  // Pre-executed cycles discarded because the organism left its cell
+
+  // --------  Scheduler Stats  ---------
+  int m_sched_adjustments;            // Schedule adjustments requested this update
+  int m_sched_adjustments_redundant;  // ...of which left the cell's priority unchanged, and so were skipped
 
 
   // --------  Organism Kill Stats  ---------
@@ -650,6 +666,8 @@ public:
   void RecordDeath() { num_deaths++; }
 
   void IncExecuted() { num_executed++; }
+  void IncExecuted(int count) { num_executed += count; }
+  int GetNumExecuted() const { return num_executed; }
 
   void AddNumOrgsKilled(long num) { sum_orgs_killed.Add(num); }
 	void AddNumUnoccupiedCellAttemptedToKill(long num) { sum_unoccupied_cell_kill_attempts.Add(num); }
@@ -671,6 +689,11 @@ public:
   void AddLastParasiteTask(int task_num) { tasks_parasite_last[task_num]++; }
   
   bool ShouldCollectEnvTestStats() const { return m_collect_env_test_stats; }
+  
+  void RequestClassInstStats() { m_collect_class_inst_stats = true; }
+  bool ShouldCollectClassInstStats() const { return m_collect_class_inst_stats; }
+  void RequestFromMessageInstStats() { m_collect_from_message_inst_stats = true; }
+  bool ShouldCollectFromMessageInstStats() const { return m_collect_from_message_inst_stats; }
 
   void AddLastTaskQuality(int task_num, double quality)
   {
@@ -685,6 +708,15 @@ public:
   void AddNewReactionCount(int reaction_num) {new_reaction_count[reaction_num]++; }
   void IncTaskExeCount(int task_num, int task_count) { task_exe_count[task_num] += task_count; }
   void ZeroTasks();
+  
+  void SetOrganismStatsSample(int sample_size, int population)
+  {
+    m_org_stats_sample_size = sample_size;
+    m_org_stats_population = population;
+  }
+  bool OrganismStatsSampled() const { return m_org_stats_sample_size < m_org_stats_population; }
+  int GetOrganismStatsSampleSize() const { return m_org_stats_sample_size; }
+  void ScaleSampledOrganismCounts(double factor);
 
   void AddLastSense(int) { /*sense_last_count[res_comb_index]++;*/ }
   void IncLastSenseExeCount(int, int) { /*sense_last_exe_count[res_comb_index]+= count;*/ }
@@ -725,7 +757,15 @@ public:
   void SetCompetitionOrgsReplicated(int _in) { num_orgs_replicated = _in; }
 
   void AddSpeculative(int spec) { m_spec_total += spec; m_spec_num++; }
+  void AddSpeculative(int spec, int num) { m_spec_total += spec; m_spec_num += num; }
+  void AddSpeculative(int spec, int num, int hw_type)
+    { AddSpeculative(spec, num); assert(hw_type < NUM_SPEC_HW_TYPES); m_spec_hw_total[hw_type] += spec; }
+  void AddSpeculativeHit(int hw_type) { assert(hw_type < NUM_SPEC_HW_TYPES); m_spec_hw_hits[hw_type]++; }
   void AddSpeculativeWaste(int waste) { m_spec_waste += waste; }
+  void AddSpeculativeWaste(int waste, int hw_type)
+    { AddSpeculativeWaste(waste); assert(hw_type < NUM_SPEC_HW_TYPES); m_spec_hw_waste[hw_type] += waste; }
+  
+  void AddScheduleAdjustment(bool redundant) { m_sched_adjustments++; if (redundant) m_sched_adjustments_redundant++; }
 
   // Sexual selection recording
   void RecordSuccessfulMate(cBirthEntry& successful_mate, cBirthEntry& chooser);
@@ -814,6 +854,24 @@ public:
 
   double GetAveSpeculative() const { return (m_spec_num) ? ((double)m_spec_total / (double)m_spec_num) : 0.0; }
   int GetSpeculativeWaste() const { return m_spec_waste; }
+  int GetScheduleAdjustments() const { return m_sched_adjustments; }
+  int GetRedundantScheduleAdjustments() const { return m_sched_adjustments_redundant; }
+  
+  int GetTestCPUCacheHits() const;
+  int GetTestCPUCacheMisses() const;
+  double GetTestCPUCacheHitRate() const;
+  
+  // Wall clock seconds spent in a cUpdateProfiler phase during the last update (0 when profiling is off)
+  template <int PHASE> double GetProfileTime() const;
+  
+  // Bundled tcmalloc statistics in bytes (-1 when the executable is not linked against it), and the TRACK_ALLOCATIONS
+  // object counts of a Util::MemoryStats subsystem
+  double GetAllocatedBytes() const;
+  double GetHeapBytes() const;
+  double GetThreadCacheBytes() const;
+  double GetAllocatorSlackBytes() const;
+  template <int SUBSYSTEM> int GetLiveObjects() const;
+  template <int SUBSYSTEM> double GetCreatedObjects() const;
 
   double GetAvgNumOrgsKilled() const { return sum_orgs_killed.Mean(); }
   double GetAvgNumCellsScannedAtKill() const { return sum_cells_scanned_at_kill.Mean(); }
@@ -871,10 +929,12 @@ public:
 
   void PrintCountData(const cString& filename);
   void PrintThreadsData(const cString& filename);
+  void PrintSpeculativeData(const cString& filename);
   void PrintMessageData(const cString& filename);
   void PrintInterruptData(const cString& filename);
   void PrintTotalsData(const cString& filename);
   void PrintTasksData(const cString& filename);
+  void PrintSampleData(const cString& filename);
   void PrintSoloTaskSnapshot(const cString& filename, cAvidaContext& ctx);
   void PrintHostTasksData(const cString& filename);
   void PrintParasiteTasksData(const cString& filename);
@@ -1313,6 +1373,7 @@ public:
 
 	//! Print profiling data.
 	void PrintProfilingData(const cString& filename);
+  void PrintMemoryData(const cString& filename);
 
 protected:
 	avg_profiling_stats_t m_profiling; //!< Profiling statistics.
@@ -1325,6 +1386,9 @@ public:
 private:
   // Initialization
   void setupProvidedData();
+  void refreshRequestedStats();
+  double sampleConfidence(const cDoubleSum& sum) const;
+  double sampleCountConfidence(double count) const;
   
   // Helper Methods
   template <class T> Data::PackagePtr packageData(T (cStats::*)() const) const;
@@ -26,6 +26,7 @@
 #include "apto/core.h"
 
 #include "cArgContainer.h"
+#include "cMatchString.h"
 #include "cString.h"
 
 class cTaskLib;
@@ -44,6 +45,8 @@ private:
   cArgContainer* m_args;
   Apto::String m_prop_id_ave;
   Apto::String m_prop_id_count;
+  Apto::Array<bool> m_logic_ids;   // for tasks that depend only on the logic id, the ids that perform them
+  cMatchString m_match_string;     // target of the string matching tasks
 
 public:
   cTaskEntry(const cString& name, const cString& desc, int in_id, tTaskTest fun, cArgContainer* args)
@@ -66,6 +69,13 @@ public:
   const Apto::String& CountPropertyID() const { return m_prop_id_count; }
   
   
+  bool IsLogicOnly() const { return (m_logic_ids.GetSize() != 0); }
+  bool PerformedByLogicId(int logic_id) const { return (logic_id >= 0 && m_logic_ids[logic_id]); }
+  void SetLogicIds(const Apto::Array<bool>& logic_ids) { m_logic_ids = logic_ids; }
+  
+  const cMatchString& GetMatchString() const { return m_match_string; }
+  void SetMatchString(const cMatchString& match_string) { m_match_string = match_string; }
+  
   bool HasArguments() const { return (m_args != NULL); }
   cArgContainer& GetArguments() const { return *m_args; }
 };
@@ -93,24 +93,24 @@ cTaskEntry* cTaskLib::AddTask(const cString& name, const cString& info, cEnvReqs
   else if (name == "dontcare")  NewTask(name, "DontCare", &cTaskLib::Task_DontCare);
   
   // All 1- and 2-Input Logic Functions
-  if (name == "not") NewTask(name, "Not", &cTaskLib::Task_Not);
-  else if (name == "not_dup") NewTask(name, "Not_dup", &cTaskLib::Task_Not);
-  else if (name == "nand") NewTask(name, "Nand", &cTaskLib::Task_Nand);
-  else if (name == "nand_dup") NewTask(name, "Nand_dup", &cTaskLib::Task_Nand);
-  else if (name == "and") NewTask(name, "And", &cTaskLib::Task_And);
-  else if (name == "and_dup") NewTask(name, "And_dup", &cTaskLib::Task_And);
-  else if (name == "orn") NewTask(name, "OrNot", &cTaskLib::Task_OrNot);
-  else if (name == "orn_dup") NewTask(name, "OrNot_dup", &cTaskLib::Task_OrNot);
-  else if (name == "or") NewTask(name, "Or", &cTaskLib::Task_Or);
-  else if (name == "or_dup") NewTask(name, "Or_dup", &cTaskLib::Task_Or);
-  else if (name == "andn") NewTask(name, "AndNot", &cTaskLib::Task_AndNot);
-  else if (name == "andn_dup") NewTask(name, "AndNot_dup", &cTaskLib::Task_AndNot);
-  else if (name == "nor") NewTask(name, "Nor", &cTaskLib::Task_Nor);
-  else if (name == "nor_dup") NewTask(name, "Nor_dup", &cTaskLib::Task_Nor);
-  else if (name == "xor") NewTask(name, "Xor", &cTaskLib::Task_Xor);
-  else if (name == "xor_dup") NewTask(name, "Xor_dup", &cTaskLib::Task_Xor);
-  else if (name == "equ") NewTask(name, "Equals", &cTaskLib::Task_Equ);
-  else if (name == "equ_dup") NewTask(name, "Equals_dup", &cTaskLib::Task_Equ);
+  if (name == "not") NewTask(name, "Not", &cTaskLib::Task_Not, REQ_LOGIC_ONLY);
+  else if (name == "not_dup") NewTask(name, "Not_dup", &cTaskLib::Task_Not, REQ_LOGIC_ONLY);
+  else if (name == "nand") NewTask(name, "Nand", &cTaskLib::Task_Nand, REQ_LOGIC_ONLY);
+  else if (name == "nand_dup") NewTask(name, "Nand_dup", &cTaskLib::Task_Nand, REQ_LOGIC_ONLY);
+  else if (name == "and") NewTask(name, "And", &cTaskLib::Task_And, REQ_LOGIC_ONLY);
+  else if (name == "and_dup") NewTask(name, "And_dup", &cTaskLib::Task_And, REQ_LOGIC_ONLY);
+  else if (name == "orn") NewTask(name, "OrNot", &cTaskLib::Task_OrNot, REQ_LOGIC_ONLY);
+  else if (name == "orn_dup") NewTask(name, "OrNot_dup", &cTaskLib::Task_OrNot, REQ_LOGIC_ONLY);
+  else if (name == "or") NewTask(name, "Or", &cTaskLib::Task_Or, REQ_LOGIC_ONLY);
+  else if (name == "or_dup") NewTask(name, "Or_dup", &cTaskLib::Task_Or, REQ_LOGIC_ONLY);
+  else if (name == "andn") NewTask(name, "AndNot", &cTaskLib::Task_AndNot, REQ_LOGIC_ONLY);
+  else if (name == "andn_dup") NewTask(name, "AndNot_dup", &cTaskLib::Task_AndNot, REQ_LOGIC_ONLY);
+  else if (name == "nor") NewTask(name, "Nor", &cTaskLib::Task_Nor, REQ_LOGIC_ONLY);
+  else if (name == "nor_dup") NewTask(name, "Nor_dup", &cTaskLib::Task_Nor, REQ_LOGIC_ONLY);
+  else if (name == "xor") NewTask(name, "Xor", &cTaskLib::Task_Xor, REQ_LOGIC_ONLY);
+  else if (name == "xor_dup") NewTask(name, "Xor_dup", &cTaskLib::Task_Xor, REQ_LOGIC_ONLY);
+  else if (name == "equ") NewTask(name, "Equals", &cTaskLib::Task_Equ, REQ_LOGIC_ONLY);
+  else if (name == "equ_dup") NewTask(name, "Equals_dup", &cTaskLib::Task_Equ, REQ_LOGIC_ONLY);
   
   else if (name == "xor-max") NewTask(name, "Xor-max", &cTaskLib::Task_XorMax);
 	// resoruce dependent version
@@ -118,74 +118,74 @@ cTaskEntry* cTaskLib::AddTask(const cString& name, const cString& info, cEnvReqs
   else if (name == "nor-resourceDependent") NewTask(name, "Nor-resourceDependent", &cTaskLib::Task_Nor_ResourceDependent);
 	
   // All 3-Input Logic Functions
-  if (name == "logic_3AA")      NewTask(name, "Logic 3AA (A+B+C == 0)", &cTaskLib::Task_Logic3in_AA);
-  else if (name == "logic_3AB") NewTask(name, "Logic 3AB (A+B+C == 1)", &cTaskLib::Task_Logic3in_AB);
-  else if (name == "logic_3AC") NewTask(name, "Logic 3AC (A+B+C <= 1)", &cTaskLib::Task_Logic3in_AC);
-  else if (name == "logic_3AD") NewTask(name, "Logic 3AD (A+B+C == 2)", &cTaskLib::Task_Logic3in_AD);
-  else if (name == "logic_3AE") NewTask(name, "Logic 3AE (A+B+C == 0,2)", &cTaskLib::Task_Logic3in_AE);
-  else if (name == "logic_3AF") NewTask(name, "Logic 3AF (A+B+C == 1,2)", &cTaskLib::Task_Logic3in_AF);
-  else if (name == "logic_3AG") NewTask(name, "Logic 3AG (A+B+C <= 2)", &cTaskLib::Task_Logic3in_AG);
-  else if (name == "logic_3AH") NewTask(name, "Logic 3AH (A+B+C == 3)", &cTaskLib::Task_Logic3in_AH);
-  else if (name == "logic_3AI") NewTask(name, "Logic 3AI (A+B+C == 0,3)", &cTaskLib::Task_Logic3in_AI);
-  else if (name == "logic_3AJ") NewTask(name, "Logic 3AJ (A+B+C == 1,3) XOR", &cTaskLib::Task_Logic3in_AJ);
-  else if (name == "logic_3AK") NewTask(name, "Logic 3AK (A+B+C != 2)", &cTaskLib::Task_Logic3in_AK);
-  else if (name == "logic_3AL") NewTask(name, "Logic 3AL (A+B+C >= 2)", &cTaskLib::Task_Logic3in_AL);
-  else if (name == "logic_3AM") NewTask(name, "Logic 3AM (A+B+C != 1)", &cTaskLib::Task_Logic3in_AM);
-  else if (name == "logic_3AN") NewTask(name, "Logic 3AN (A+B+C != 0)", &cTaskLib::Task_Logic3in_AN);
-  else if (name == "logic_3AO") NewTask(name, "Logic 3AO (A & ~B & ~C) [3]", &cTaskLib::Task_Logic3in_AO);
-  else if (name == "logic_3AP") NewTask(name, "Logic 3AP (A^B & ~C)  [3]", &cTaskLib::Task_Logic3in_AP);
-  else if (name == "logic_3AQ") NewTask(name, "Logic 3AQ (A==B & ~C) [3]", &cTaskLib::Task_Logic3in_AQ);
-  else if (name == "logic_3AR") NewTask(name, "Logic 3AR (A & B & ~C) [3]", &cTaskLib::Task_Logic3in_AR);
-  else if (name == "logic_3AS") NewTask(name, "Logic 3AS", &cTaskLib::Task_Logic3in_AS);
-  else if (name == "logic_3AT") NewTask(name, "Logic 3AT", &cTaskLib::Task_Logic3in_AT);
-  else if (name == "logic_3AU") NewTask(name, "Logic 3AU", &cTaskLib::Task_Logic3in_AU);
-  else if (name == "logic_3AV") NewTask(name, "Logic 3AV", &cTaskLib::Task_Logic3in_AV);
-  else if (name == "logic_3AW") NewTask(name, "Logic 3AW", &cTaskLib::Task_Logic3in_AW);
-  else if (name == "logic_3AX") NewTask(name, "Logic 3AX", &cTaskLib::Task_Logic3in_AX);
-  else if (name == "logic_3AY") NewTask(name, "Logic 3AY", &cTaskLib::Task_Logic3in_AY);
-  else if (name == "logic_3AZ") NewTask(name, "Logic 3AZ", &cTaskLib::Task_Logic3in_AZ);
-  else if (name == "logic_3BA") NewTask(name, "Logic 3BA", &cTaskLib::Task_Logic3in_BA);
-  else if (name == "logic_3BB") NewTask(name, "Logic 3BB", &cTaskLib::Task_Logic3in_BB);
-  else if (name == "logic_3BC") NewTask(name, "Logic 3BC", &cTaskLib::Task_Logic3in_BC);
-  else if (name == "logic_3BD") NewTask(name, "Logic 3BD", &cTaskLib::Task_Logic3in_BD);
-  else if (name == "logic_3BE") NewTask(name, "Logic 3BE", &cTaskLib::Task_Logic3in_BE);
-  else if (name == "logic_3BF") NewTask(name, "Logic 3BF", &cTaskLib::Task_Logic3in_BF);
-  else if (name == "logic_3BG") NewTask(name, "Logic 3BG", &cTaskLib::Task_Logic3in_BG);
-  else if (name == "logic_3BH") NewTask(name, "Logic 3BH", &cTaskLib::Task_Logic3in_BH);
-  else if (name == "logic_3BI") NewTask(name, "Logic 3BI", &cTaskLib::Task_Logic3in_BI);
-  else if (name == "logic_3BJ") NewTask(name, "Logic 3BJ", &cTaskLib::Task_Logic3in_BJ);
-  else if (name == "logic_3BK") NewTask(name, "Logic 3BK", &cTaskLib::Task_Logic3in_BK);
-  else if (name == "logic_3BL") NewTask(name, "Logic 3BL", &cTaskLib::Task_Logic3in_BL);
-  else if (name == "logic_3BM") NewTask(name, "Logic 3BM", &cTaskLib::Task_Logic3in_BM);
-  else if (name == "logic_3BN") NewTask(name, "Logic 3BN", &cTaskLib::Task_Logic3in_BN);
-  else if (name == "logic_3BO") NewTask(name, "Logic 3BO", &cTaskLib::Task_Logic3in_BO);
-  else if (name == "logic_3BP") NewTask(name, "Logic 3BP", &cTaskLib::Task_Logic3in_BP);
-  else if (name == "logic_3BQ") NewTask(name, "Logic 3BQ", &cTaskLib::Task_Logic3in_BQ);
-  else if (name == "logic_3BR") NewTask(name, "Logic 3BR", &cTaskLib::Task_Logic3in_BR);
-  else if (name == "logic_3BS") NewTask(name, "Logic 3BS", &cTaskLib::Task_Logic3in_BS);
-  else if (name == "logic_3BT") NewTask(name, "Logic 3BT", &cTaskLib::Task_Logic3in_BT);
-  else if (name == "logic_3BU") NewTask(name, "Logic 3BU", &cTaskLib::Task_Logic3in_BU);
-  else if (name == "logic_3BV") NewTask(name, "Logic 3BV", &cTaskLib::Task_Logic3in_BV);
-  else if (name == "logic_3BW") NewTask(name, "Logic 3BW", &cTaskLib::Task_Logic3in_BW);
-  else if (name == "logic_3BX") NewTask(name, "Logic 3BX", &cTaskLib::Task_Logic3in_BX);
-  else if (name == "logic_3BY") NewTask(name, "Logic 3BY", &cTaskLib::Task_Logic3in_BY);
-  else if (name == "logic_3BZ") NewTask(name, "Logic 3BZ", &cTaskLib::Task_Logic3in_BZ);
-  else if (name == "logic_3CA") NewTask(name, "Logic 3CA", &cTaskLib::Task_Logic3in_CA);
-  else if (name == "logic_3CB") NewTask(name, "Logic 3CB", &cTaskLib::Task_Logic3in_CB);
-  else if (name == "logic_3CC") NewTask(name, "Logic 3CC", &cTaskLib::Task_Logic3in_CC);
-  else if (name == "logic_3CD") NewTask(name, "Logic 3CD", &cTaskLib::Task_Logic3in_CD);
-  else if (name == "logic_3CE") NewTask(name, "Logic 3CE", &cTaskLib::Task_Logic3in_CE);
-  else if (name == "logic_3CF") NewTask(name, "Logic 3CF", &cTaskLib::Task_Logic3in_CF);
-  else if (name == "logic_3CG") NewTask(name, "Logic 3CG", &cTaskLib::Task_Logic3in_CG);
-  else if (name == "logic_3CH") NewTask(name, "Logic 3CH", &cTaskLib::Task_Logic3in_CH);
-  else if (name == "logic_3CI") NewTask(name, "Logic 3CI", &cTaskLib::Task_Logic3in_CI);
-  else if (name == "logic_3CJ") NewTask(name, "Logic 3CJ", &cTaskLib::Task_Logic3in_CJ);
-  else if (name == "logic_3CK") NewTask(name, "Logic 3CK", &cTaskLib::Task_Logic3in_CK);
-  else if (name == "logic_3CL") NewTask(name, "Logic 3CL", &cTaskLib::Task_Logic3in_CL);
-  else if (name == "logic_3CM") NewTask(name, "Logic 3CM", &cTaskLib::Task_Logic3in_CM);
-  else if (name == "logic_3CN") NewTask(name, "Logic 3CN", &cTaskLib::Task_Logic3in_CN);
-  else if (name == "logic_3CO") NewTask(name, "Logic 3CO", &cTaskLib::Task_Logic3in_CO);
-  else if (name == "logic_3CP") NewTask(name, "Logic 3CP", &cTaskLib::Task_Logic3in_CP);
+  if (name == "logic_3AA")      NewTask(name, "Logic 3AA (A+B+C == 0)", &cTaskLib::Task_Logic3in_AA, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AB") NewTask(name, "Logic 3AB (A+B+C == 1)", &cTaskLib::Task_Logic3in_AB, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AC") NewTask(name, "Logic 3AC (A+B+C <= 1)", &cTaskLib::Task_Logic3in_AC, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AD") NewTask(name, "Logic 3AD (A+B+C == 2)", &cTaskLib::Task_Logic3in_AD, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AE") NewTask(name, "Logic 3AE (A+B+C == 0,2)", &cTaskLib::Task_Logic3in_AE, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AF") NewTask(name, "Logic 3AF (A+B+C == 1,2)", &cTaskLib::Task_Logic3in_AF, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AG") NewTask(name, "Logic 3AG (A+B+C <= 2)", &cTaskLib::Task_Logic3in_AG, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AH") NewTask(name, "Logic 3AH (A+B+C == 3)", &cTaskLib::Task_Logic3in_AH, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AI") NewTask(name, "Logic 3AI (A+B+C == 0,3)", &cTaskLib::Task_Logic3in_AI, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AJ") NewTask(name, "Logic 3AJ (A+B+C == 1,3) XOR", &cTaskLib::Task_Logic3in_AJ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AK") NewTask(name, "Logic 3AK (A+B+C != 2)", &cTaskLib::Task_Logic3in_AK, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AL") NewTask(name, "Logic 3AL (A+B+C >= 2)", &cTaskLib::Task_Logic3in_AL, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AM") NewTask(name, "Logic 3AM (A+B+C != 1)", &cTaskLib::Task_Logic3in_AM, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AN") NewTask(name, "Logic 3AN (A+B+C != 0)", &cTaskLib::Task_Logic3in_AN, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AO") NewTask(name, "Logic 3AO (A & ~B & ~C) [3]", &cTaskLib::Task_Logic3in_AO, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AP") NewTask(name, "Logic 3AP (A^B & ~C)  [3]", &cTaskLib::Task_Logic3in_AP, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AQ") NewTask(name, "Logic 3AQ (A==B & ~C) [3]", &cTaskLib::Task_Logic3in_AQ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AR") NewTask(name, "Logic 3AR (A & B & ~C) [3]", &cTaskLib::Task_Logic3in_AR, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AS") NewTask(name, "Logic 3AS", &cTaskLib::Task_Logic3in_AS, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AT") NewTask(name, "Logic 3AT", &cTaskLib::Task_Logic3in_AT, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AU") NewTask(name, "Logic 3AU", &cTaskLib::Task_Logic3in_AU, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AV") NewTask(name, "Logic 3AV", &cTaskLib::Task_Logic3in_AV, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AW") NewTask(name, "Logic 3AW", &cTaskLib::Task_Logic3in_AW, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AX") NewTask(name, "Logic 3AX", &cTaskLib::Task_Logic3in_AX, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AY") NewTask(name, "Logic 3AY", &cTaskLib::Task_Logic3in_AY, REQ_LOGIC_ONLY);
+  else if (name == "logic_3AZ") NewTask(name, "Logic 3AZ", &cTaskLib::Task_Logic3in_AZ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BA") NewTask(name, "Logic 3BA", &cTaskLib::Task_Logic3in_BA, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BB") NewTask(name, "Logic 3BB", &cTaskLib::Task_Logic3in_BB, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BC") NewTask(name, "Logic 3BC", &cTaskLib::Task_Logic3in_BC, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BD") NewTask(name, "Logic 3BD", &cTaskLib::Task_Logic3in_BD, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BE") NewTask(name, "Logic 3BE", &cTaskLib::Task_Logic3in_BE, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BF") NewTask(name, "Logic 3BF", &cTaskLib::Task_Logic3in_BF, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BG") NewTask(name, "Logic 3BG", &cTaskLib::Task_Logic3in_BG, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BH") NewTask(name, "Logic 3BH", &cTaskLib::Task_Logic3in_BH, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BI") NewTask(name, "Logic 3BI", &cTaskLib::Task_Logic3in_BI, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BJ") NewTask(name, "Logic 3BJ", &cTaskLib::Task_Logic3in_BJ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BK") NewTask(name, "Logic 3BK", &cTaskLib::Task_Logic3in_BK, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BL") NewTask(name, "Logic 3BL", &cTaskLib::Task_Logic3in_BL, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BM") NewTask(name, "Logic 3BM", &cTaskLib::Task_Logic3in_BM, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BN") NewTask(name, "Logic 3BN", &cTaskLib::Task_Logic3in_BN, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BO") NewTask(name, "Logic 3BO", &cTaskLib::Task_Logic3in_BO, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BP") NewTask(name, "Logic 3BP", &cTaskLib::Task_Logic3in_BP, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BQ") NewTask(name, "Logic 3BQ", &cTaskLib::Task_Logic3in_BQ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BR") NewTask(name, "Logic 3BR", &cTaskLib::Task_Logic3in_BR, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BS") NewTask(name, "Logic 3BS", &cTaskLib::Task_Logic3in_BS, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BT") NewTask(name, "Logic 3BT", &cTaskLib::Task_Logic3in_BT, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BU") NewTask(name, "Logic 3BU", &cTaskLib::Task_Logic3in_BU, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BV") NewTask(name, "Logic 3BV", &cTaskLib::Task_Logic3in_BV, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BW") NewTask(name, "Logic 3BW", &cTaskLib::Task_Logic3in_BW, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BX") NewTask(name, "Logic 3BX", &cTaskLib::Task_Logic3in_BX, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BY") NewTask(name, "Logic 3BY", &cTaskLib::Task_Logic3in_BY, REQ_LOGIC_ONLY);
+  else if (name == "logic_3BZ") NewTask(name, "Logic 3BZ", &cTaskLib::Task_Logic3in_BZ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CA") NewTask(name, "Logic 3CA", &cTaskLib::Task_Logic3in_CA, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CB") NewTask(name, "Logic 3CB", &cTaskLib::Task_Logic3in_CB, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CC") NewTask(name, "Logic 3CC", &cTaskLib::Task_Logic3in_CC, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CD") NewTask(name, "Logic 3CD", &cTaskLib::Task_Logic3in_CD, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CE") NewTask(name, "Logic 3CE", &cTaskLib::Task_Logic3in_CE, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CF") NewTask(name, "Logic 3CF", &cTaskLib::Task_Logic3in_CF, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CG") NewTask(name, "Logic 3CG", &cTaskLib::Task_Logic3in_CG, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CH") NewTask(name, "Logic 3CH", &cTaskLib::Task_Logic3in_CH, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CI") NewTask(name, "Logic 3CI", &cTaskLib::Task_Logic3in_CI, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CJ") NewTask(name, "Logic 3CJ", &cTaskLib::Task_Logic3in_CJ, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CK") NewTask(name, "Logic 3CK", &cTaskLib::Task_Logic3in_CK, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CL") NewTask(name, "Logic 3CL", &cTaskLib::Task_Logic3in_CL, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CM") NewTask(name, "Logic 3CM", &cTaskLib::Task_Logic3in_CM, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CN") NewTask(name, "Logic 3CN", &cTaskLib::Task_Logic3in_CN, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CO") NewTask(name, "Logic 3CO", &cTaskLib::Task_Logic3in_CO, REQ_LOGIC_ONLY);
+  else if (name == "logic_3CP") NewTask(name, "Logic 3CP", &cTaskLib::Task_Logic3in_CP, REQ_LOGIC_ONLY);
   
   // Arbitrary 1-Input Math Tasks
   else if (name == "math_1AA") NewTask(name, "Math 1AA (2X)", &cTaskLib::Task_Math1in_AA);
@@ -363,6 +363,21 @@ void cTaskLib::NewTask(const cString& name, const cString& desc, tTaskTest task_
   const int id = task_array.GetSize();
   task_array.Resize(id + 1);
   task_array[id] = new cTaskEntry(name, desc, id, task_fun, args);
+  
+  if (reqs & REQ_LOGIC_ONLY) {
+    // Record which logic ids perform the task, so that the environment can skip it for any other output
+    tBuffer<int> no_buffer(0);
+    tList<tBuffer<int> > no_buffers;
+    Apto::Array<int, Apto::Smart> no_mem;
+    cTaskContext ctx(NULL, no_buffer, no_buffer, no_buffers, no_buffers, no_mem);
+    ctx.SetTaskEntry(task_array[id]);
+    Apto::Array<bool> logic_ids(256);
+    for (int logic_id = 0; logic_id < 256; logic_id++) {
+      ctx.SetLogicId(logic_id);
+      logic_ids[logic_id] = ((this->*task_fun)(ctx) > 0.0);
+    }
+    task_array[id]->SetLogicIds(logic_ids);
+  }
 }
 
 
@@ -388,32 +403,29 @@ void cTaskLib::SetupTests(cTaskContext& ctx) const
   //       Input B: 1 1 0 0 1 1 0 0
   //       Input A: 1 0 1 0 1 0 1 0
   
-  int logic_out[8];
-  for (int i = 0; i < 8; i++) logic_out[i] = -1;
+  // All 32 bit positions are tested at once: for each input combination, mask the positions where the inputs take
+  // it, and the output must then be all ones or all zeros under that mask.
+  const unsigned int in_a = test_inputs[0];
+  const unsigned int in_b = test_inputs[1];
+  const unsigned int in_c = test_inputs[2];
+  const unsigned int out = test_output;
   
-  // Test all input combos!
-  bool func_OK = true;  // Have all outputs been consistant?
-  for (int test_pos = 0; test_pos < 32; test_pos++) {
-    int logic_pos = 0;
-    for (int i = 0; i < 3; i++)  logic_pos += (test_inputs[i] & 1) << i;
-    
-    if ( logic_out[logic_pos] != -1 &&
-        logic_out[logic_pos] != (test_output & 1) ) {
-      func_OK = false;
-      break;
-    }
-    else {
-      logic_out[logic_pos] = test_output & 1;
+  int logic_out[8];
+  for (int logic_pos = 0; logic_pos < 8; logic_pos++) {
+    const unsigned int mask = ((logic_pos & 1) ? in_a : ~in_a) & ((logic_pos & 2) ? in_b : ~in_b) &
+                              ((logic_pos & 4) ? in_c : ~in_c);
+    const unsigned int out_bits = out & mask;
+    if (!mask) {
+      logic_out[logic_pos] = -1;
+    } else if (out_bits == 0) {
+      logic_out[logic_pos] = 0;
+    } else if (out_bits == mask) {
+      logic_out[logic_pos] = 1;
+    } else {
+      // The output is inconsistant with any logic function of the inputs
+      ctx.SetLogicId(-1);
+      return;
     }
-    
-    test_output >>= 1;
-    for (int i = 0; i < 3; i++) test_inputs[i] >>= 1;
-  }
-  
-  // If there were any inconsistancies, deal with them.
-  if (func_OK == false) {
-    ctx.SetLogicId(-1);
-    return;
   }
   
   // Determine the logic ID number of this task.
@@ -2120,67 +2132,38 @@ void cTaskLib::Load_MatchStr(const cString& name, const cString& argstr, cEnvReq
   schema.AddEntry("pow",0,2.0);
   cArgContainer* args = cArgContainer::Load(argstr, schema, feedback);
   envreqs.SetMinOutputs(args->GetString(0).GetSize());
-  if (args) NewTask(name, "MatchStr", &cTaskLib::Task_MatchStr, 0, args);
+  if (args) {
+    NewTask(name, "MatchStr", &cTaskLib::Task_MatchStr, 0, args);
+    task_array[task_array.GetSize() - 1]->SetMatchString(cMatchString(args->GetString(0)));
+  }
 }
 
 double cTaskLib::Task_MatchStr(cTaskContext& ctx) const
 {
-  tBuffer<int> temp_buf(ctx.GetOutputBuffer());
+  const tBuffer<int>& temp_buf = ctx.GetOutputBuffer();
   //  if (temp_buf[0] != 357913941) return 0;
   
-  //  temp_buf.Pop(); // pop the signal value off of the buffer
-  
-  const cString& string_to_match = ctx.GetTaskEntry()->GetArguments().GetString(0);
+  const cMatchString& string_to_match = ctx.GetTaskEntry()->GetMatchString();
   int partial = ctx.GetTaskEntry()->GetArguments().GetInt(0);
   int binary = ctx.GetTaskEntry()->GetArguments().GetInt(1);
 //  double mypow = ctx.GetTaskEntry()->GetArguments().GetDouble(0);
-  int string_index;
   int num_matched = 0;
-  int test_output;
   int max_num_matched = 0;
   int num_real=0;
 
   if (!binary) {
-    if (temp_buf.GetNumStored() > 0) {
-      test_output = temp_buf[0];
-      
-      for (int j = 0; j < string_to_match.GetSize(); j++) {  
-	string_index = string_to_match.GetSize() - j - 1; // start with last char in string
-	int k = 1 << j;
-	if ((string_to_match[string_index] == '0' && !(test_output & k)) ||
-	    (string_to_match[string_index] == '1' && (test_output & k))) num_matched++;
-      }
-      max_num_matched = num_matched;
-    }
+    if (temp_buf.GetNumStored() > 0) max_num_matched = string_to_match.CountValueMatches(temp_buf[0]);
   }
   else {
-    for (int j = 0; j < string_to_match.GetSize(); j++) {
-      if (string_to_match[j] != '9') {
-	num_real++;
-      }
-      if ((string_to_match[j] == '0' && temp_buf[j]==0) ||
-	  (string_to_match[j] == '1' && temp_buf[j]==1)) {
-          num_matched++;
-      }
-    }
-    max_num_matched = num_matched;
+    num_real = string_to_match.GetNumReal();
+    max_num_matched = string_to_match.CountMatches(temp_buf);
   }
 
   bool used_received = false;
   if (ctx.GetReceivedMessages()) {
-    tBuffer<int> received(*(ctx.GetReceivedMessages()));
+    const tBuffer<int>& received = *(ctx.GetReceivedMessages());
     for (int i = 0; i < received.GetNumStored(); i++) {
-      test_output = received[i];
-      num_matched = 0;
-      
-      for (int j = 0; j < string_to_match.GetSize(); j++) {
-        string_index = string_to_match.GetSize() - j - 1; // start with last char in string
-        int k = 1 << j;
-        if ((string_to_match[string_index]=='0' && !(test_output & k)) ||
-            (string_to_match[string_index]=='1' && (test_output & k))) {
-	  num_matched++;
-	}
-      }
+      num_matched = string_to_match.CountValueMatches(received[i]);
       
       if (num_matched > max_num_matched) {
         max_num_matched = num_matched;
@@ -2205,16 +2188,11 @@ double cTaskLib::Task_MatchStr(cTaskContext& ctx) const
   return bonus;
 }
 
-vector<cString> cTaskLib::GetMatchStrings()
-{
-  return m_strings;
-}
-
 cString cTaskLib::GetMatchString(int x)
 { 
   cString s; 
   if (x >= 0 && x < (int)m_strings.size()){
-    s = m_strings[x]; 
+    s = m_strings[x].GetString(); 
   } else { 
     s = cString("");
   }
@@ -2233,8 +2211,11 @@ void cTaskLib::Load_MatchProdStr(const cString& name, const cString& argstr, cEn
 	schema.AddEntry("tag",2,-1);
   cArgContainer* args = cArgContainer::Load(argstr, schema, feedback);	
   envreqs.SetMinOutputs(args->GetString(0).GetSize());
-	m_strings.push_back(args->GetString(0));
-  if (args) NewTask(name, "MatchProdStr", &cTaskLib::Task_MatchStr, 0, args);
+	m_strings.push_back(cMatchString(args->GetString(0)));
+  if (args) {
+    NewTask(name, "MatchProdStr", &cTaskLib::Task_MatchStr, 0, args);
+    task_array[task_array.GetSize() - 1]->SetMatchString(m_strings.back());
+  }
 }
 
 
@@ -2244,39 +2225,21 @@ double cTaskLib::Task_MatchProdStr(cTaskContext& ctx) const
   m_world->GetStats().AddTag(ctx.GetTaskEntry()->GetArguments().GetInt(2), 0);
   m_world->GetStats().AddTag(-1, 0);
 	
-  tBuffer<int> temp_buf(ctx.GetOutputBuffer());
+  const tBuffer<int>& temp_buf = ctx.GetOutputBuffer();
   
-  const cString& string_to_match = ctx.GetTaskEntry()->GetArguments().GetString(0);
+  const cMatchString& string_to_match = ctx.GetTaskEntry()->GetMatchString();
   int partial = ctx.GetTaskEntry()->GetArguments().GetInt(0);
   int binary = ctx.GetTaskEntry()->GetArguments().GetInt(1);
   double mypow = ctx.GetTaskEntry()->GetArguments().GetDouble(0);
-  int string_index;
-  int num_matched = 0;
-  int test_output;
   int max_num_matched = 0;
   int num_real=0;
 	
   if (!binary) {
-    if (temp_buf.GetNumStored() > 0) {
-      test_output = temp_buf[0];
-			
-      for (int j = 0; j < string_to_match.GetSize(); j++) {  
-	string_index = string_to_match.GetSize() - j - 1; // start with last char in string
-	int k = 1 << j;
-	if ((string_to_match[string_index] == '0' && !(test_output & k)) ||
-	    (string_to_match[string_index] == '1' && (test_output & k))) num_matched++;
-      }
-      max_num_matched = num_matched;
-    }
+    if (temp_buf.GetNumStored() > 0) max_num_matched = string_to_match.CountValueMatches(temp_buf[0]);
   }
   else {
-    for (int j = 0; j < string_to_match.GetSize(); j++) {
-      if (string_to_match[j]!='9') num_real++;
-      if ((string_to_match[j]=='0' && temp_buf[j]==0) ||
-	  (string_to_match[j]=='1' && temp_buf[j]==1))
-	num_matched++;
-    }
-    max_num_matched = num_matched;
+    num_real = string_to_match.GetNumReal();
+    max_num_matched = string_to_match.CountMatches(temp_buf);
   }
   
   // Check if the organism already produced this string. 
@@ -2299,7 +2262,7 @@ double cTaskLib::Task_MatchProdStr(cTaskContext& ctx) const
   // Update stats
   cString name;
   name = "[produced"; 
-  name += string_to_match;
+  name += string_to_match.GetString();
   name += "]";
   m_world->GetStats().AddStringBitsMatchedValue(name, max_num_matched);
   
@@ -2872,6 +2835,67 @@ double cTaskLib::Task_Optimize(cTaskContext& ctx) const
 }
 
 
+// Shared evaluation for the argumented math tasks.  Each task supplies its operation as a functor, so the loops
+// below are instantiated, and the operation inlined, once per task.  Both stop early on an exact match.
+
+namespace {
+  struct cMultOp { bool Skip(int) const { return false; } long long operator()(int a, int b) const { return (long long)(a * b); } };
+  struct cDivOp { bool Skip(int b) const { return (b == 0); } long long operator()(int a, int b) const { return (long long)(a / b); } };
+  
+  struct cLogOp { long long operator()(int input) const { return (long long)(log(fabs(double(input ? input : 1)))); } };
+  struct cLog2Op { long long operator()(int input) const { return (long long)(log2(fabs(double(input ? input : 1)))); } };
+  struct cLog10Op { long long operator()(int input) const { return (long long)(log10(fabs(double(input ? input : 1)))); } };
+  struct cSqrtOp { long long operator()(int input) const { return (long long)(sqrt(fabs(double(input)))); } };
+  struct cSineOp { long long operator()(int input) const { return (long long)(sin(double(input) / dCastPrecision) * dCastPrecision); } };
+  struct cCosineOp { long long operator()(int input) const { return (long long)(cos(double(input) / dCastPrecision) * dCastPrecision); } };
+  
+  // Smallest distance between the output and the operation applied to any input
+  template <class UnaryOp> inline long long closestUnary(cTaskContext& ctx, const UnaryOp& op)
+  {
+    const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
+    const long long test_output = ctx.GetOutputBuffer()[0];
+    const int input_size = input_buffer.GetNumStored();
+    
+    long long diff = ((long long)INT_MAX + 1) * 2;
+    for (int i = 0; i < input_size && diff; i++) {
+      const long long cur_diff = ::llabs(op(input_buffer[i]) - test_output);
+      if (cur_diff < diff) diff = cur_diff;
+    }
+    return diff;
+  }
+  
+  // Smallest distance between the output and the operation applied to any ordered pair of distinct inputs
+  template <class BinaryOp> inline long long closestPair(cTaskContext& ctx, const BinaryOp& op)
+  {
+    const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
+    const long long test_output = ctx.GetOutputBuffer()[0];
+    const int input_size = input_buffer.GetNumStored();
+    
+    long long diff = ((long long)INT_MAX + 1) * 2;
+    for (int i = 0; i < input_size && diff; i++) {
+      const int input_i = input_buffer[i];
+      for (int j = 0; j < input_size && diff; j++) {
+        const int input_j = input_buffer[j];
+        if (i == j || op.Skip(input_j)) continue;
+        const long long cur_diff = ::llabs(op(input_i, input_j) - test_output);
+        if (cur_diff < diff) diff = cur_diff;
+      }
+    }
+    return diff;
+  }
+  
+  inline double halflifeQuality(const cArgContainer& args, long long diff)
+  {
+    const int threshold = args.GetInt(0);
+    if (threshold >= 0 && diff > threshold) return 0.0; // Negative threshold == infinite
+    
+    // If within threshold range, quality decays based on absolute difference
+    const double halflife = -1.0 * fabs(args.GetDouble(0));
+    return pow(2.0, static_cast<double>(diff) / halflife);
+  }
+}
+
+
 void cTaskLib::Load_Mult(const cString& name, const cString& argstr, cEnvReqs&, Feedback& feedback)
 {
   cArgSchema schema;
@@ -2888,32 +2912,7 @@ void cTaskLib::Load_Mult(const cString& name, const cString& argstr, cEnvReqs&,
 
 double cTaskLib::Task_Mult(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    for (int j = 0; j < input_size; j ++) {
-      if (i == j) continue;
-      long long cur_diff = ::llabs((long long)(input_buffer[i] * input_buffer[j]) - test_output);
-      if (cur_diff < diff) diff = cur_diff;
-    }
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestPair(ctx, cMultOp()));
 }
 
 
@@ -2933,32 +2932,7 @@ void cTaskLib::Load_Div(const cString& name, const cString& argstr, cEnvReqs&, F
 
 double cTaskLib::Task_Div(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    for (int j = 0; j < input_size; j ++) {
-      if (i == j || input_buffer[j] == 0) continue;
-      long long cur_diff = ::llabs((long long)(input_buffer[i] / input_buffer[j]) - test_output);
-      if (cur_diff < diff) diff = cur_diff;
-    }
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestPair(ctx, cDivOp()));
 }
 
 
@@ -2978,29 +2952,7 @@ void cTaskLib::Load_Log(const cString& name, const cString& argstr, cEnvReqs&, F
 
 double cTaskLib::Task_Log(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(log(fabs(double(input_buffer[i] ? input_buffer[i] : 1)))) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cLogOp()));
 }
 
 
@@ -3019,29 +2971,7 @@ void cTaskLib::Load_Log2(const cString& name, const cString& argstr, cEnvReqs&,
 
 double cTaskLib::Task_Log2(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(log2(fabs(double(input_buffer[i] ? input_buffer[i] : 1)))) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cLog2Op()));
 }
 
 
@@ -3061,29 +2991,7 @@ void cTaskLib::Load_Log10(const cString& name, const cString& argstr, cEnvReqs&,
 
 double cTaskLib::Task_Log10(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(log10(fabs(double(input_buffer[i] ? input_buffer[i] : 1)))) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cLog10Op()));
 }
 
 
@@ -3103,29 +3011,7 @@ void cTaskLib::Load_Sqrt(const cString& name, const cString& argstr, cEnvReqs&,
 
 double cTaskLib::Task_Sqrt(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(sqrt(fabs(double(input_buffer[i])))) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cSqrtOp()));
 }
 
 
@@ -3145,29 +3031,7 @@ void cTaskLib::Load_Sine(const cString& name, const cString& argstr, cEnvReqs&,
 
 double cTaskLib::Task_Sine(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(sin(double(input_buffer[i]) / dCastPrecision) * dCastPrecision) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cSineOp()));
 }
 
 
@@ -3187,29 +3051,7 @@ void cTaskLib::Load_Cosine(const cString& name, const cString& argstr, cEnvReqs&
 
 double cTaskLib::Task_Cosine(cTaskContext& ctx) const
 {
-  double quality = 0.0;
-  const cArgContainer& args = ctx.GetTaskEntry()->GetArguments();
-  
-  const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
-  const long long test_output = ctx.GetOutputBuffer()[0];
-  const int input_size = input_buffer.GetNumStored();
-  
-  long long diff = ((long long)INT_MAX + 1) * 2;
-  
-  for (int i = 0; i < input_size; i ++) {
-    long long cur_diff = ::llabs((long long)(cos(double(input_buffer[i]) / dCastPrecision) * dCastPrecision) - test_output);
-    if (cur_diff < diff) diff = cur_diff;
-  }
-  
-  int threshold = args.GetInt(0);
-  
-  if (threshold < 0 || diff <= threshold) { // Negative threshold == infinite
-    // If within threshold range, quality decays based on absolute difference
-    double halflife = -1.0 * fabs(args.GetDouble(0));
-    quality = pow(2.0, static_cast<double>(diff) / halflife);
-  }
-  
-  return quality;
+  return halflifeQuality(ctx.GetTaskEntry()->GetArguments(), closestUnary(ctx, cCosineOp()));
 }
 
 
@@ -48,7 +48,7 @@ private:
   {
     REQ_NEIGHBOR_INPUT=1,
     REQ_NEIGHBOR_OUTPUT=2, 
-    UNUSED_REQ_C=4,
+    REQ_LOGIC_ONLY=4,    // depends only on the logic id of the output
     UNUSED_REQ_D=8
   };
   
@@ -73,13 +73,13 @@ public:
   bool UseNeighborOutput() const { return use_neighbor_output; }
 	
 	// Get the strings that parameterize the MatchString tasks
-	vector<cString> GetMatchStrings(); 
+	const vector<cMatchString>& GetMatchStrings() const { return m_strings; }
 	cString GetMatchString(int x);
 	int GetNumberOfMatchStrings() { return m_strings.size(); } 
 
 private: 
 	// Store the strings used by the MatchString tasks
-	vector<cString> m_strings; 
+	vector<cMatchString> m_strings; 
   
   
 private:
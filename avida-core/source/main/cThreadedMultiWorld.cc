@@ -0,0 +1,565 @@
+/*
+ *  cThreadedMultiWorld.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cThreadedMultiWorld.h"
+
+#include "avida/core/Genome.h"
+#include "avida/core/InstructionSequence.h"
+#include "avida/core/Properties.h"
+
+#include "cHardwareManager.h"
+#include "cMerit.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+#include "cUserFeedback.h"
+#include "nGeometry.h"
+
+#include <cmath>
+
+
+/*! Destructor, frees any migrants that were never taken.
+ */
+cMigrantQueue::~cMigrantQueue() {
+	sThreadedMigrant* migrant = TakeAll();
+	while(migrant) {
+		sThreadedMigrant* next = migrant->next;
+		delete migrant;
+		migrant = next;
+	}
+}
+
+
+/*! Add a migrant; may be called from any thread.
+
+ The compare-and-swap is a full barrier, so the migrant is completely written before
+ the receiver can see it.
+ */
+void cMigrantQueue::Push(sThreadedMigrant* migrant) {
+	sThreadedMigrant* head;
+	do {
+		head = m_head;
+		migrant->next = head;
+	} while(!__sync_bool_compare_and_swap(&m_head, head, migrant));
+}
+
+
+/*! Remove every queued migrant, returned in the order they were pushed; receiver only.
+ */
+sThreadedMigrant* cMigrantQueue::TakeAll() {
+	sThreadedMigrant* migrant = __sync_lock_test_and_set(&m_head, static_cast<sThreadedMigrant*>(NULL));
+
+	// the stack holds the most recent push first:
+	sThreadedMigrant* ordered = NULL;
+	while(migrant) {
+		sThreadedMigrant* next = migrant->next;
+		migrant->next = ordered;
+		ordered = migrant;
+		migrant = next;
+	}
+	return ordered;
+}
+
+
+/*! Constructor.
+ */
+cThreadedUniverse::cThreadedUniverse(int num_worlds)
+: m_queues(num_worlds)
+, m_num_posted(num_worlds)
+, m_finished(num_worlds)
+, m_in_flight(0)
+, m_num_running(num_worlds)
+, m_reduce_arrived(0)
+, m_reduce_generation(0)
+, m_reduce_orgs(0)
+, m_reduce_merit(0.0)
+, m_result_orgs(0)
+, m_result_merit(0.0) {
+	for(int i=0; i<num_worlds; ++i) {
+		m_queues[i] = new cMigrantQueue;
+		m_num_posted[i] = 0;
+		m_finished[i] = false;
+	}
+}
+
+
+/*! Destructor.
+ */
+cThreadedUniverse::~cThreadedUniverse() {
+	for(int i=0; i<m_queues.GetSize(); ++i) {
+		delete m_queues[i];
+	}
+}
+
+
+/*! Record that a world has completed another post-update step.
+ */
+void cThreadedUniverse::Posted(int idx, int num_posted) {
+	m_mutex.Lock();
+	m_num_posted[idx] = num_posted;
+	m_mutex.Unlock();
+	m_progress_cond.Broadcast();
+}
+
+
+/*! Record that a world has stopped running; it is never again waited for.
+
+ A reduction that was only waiting on this world completes without it.
+ */
+void cThreadedUniverse::Finished(int idx) {
+	m_mutex.Lock();
+	m_finished[idx] = true;
+	m_num_running--;
+	if((m_reduce_arrived > 0) && (m_reduce_arrived >= m_num_running)) {
+		m_result_orgs = m_reduce_orgs + m_in_flight;
+		m_result_merit = m_reduce_merit;
+		m_reduce_arrived = 0;
+		m_reduce_orgs = 0;
+		m_reduce_merit = 0.0;
+		m_reduce_generation++;
+		m_reduce_cond.Broadcast();
+	}
+	m_mutex.Unlock();
+	m_progress_cond.Broadcast();
+}
+
+
+/*! Block until every given world has completed at least the given number of post-update steps, or finished.
+ */
+void cThreadedUniverse::WaitForWorlds(const Apto::Array<int>& worlds, int num_posted) {
+	m_mutex.Lock();
+	for(int i=0; i<worlds.GetSize(); ++i) {
+		const int idx = worlds[i];
+		while((m_num_posted[idx] < num_posted) && !m_finished[idx]) {
+			m_progress_cond.Wait(m_mutex);
+		}
+	}
+	m_mutex.Unlock();
+}
+
+
+/*! Sum organisms (plus migrants in flight) and merits across all running worlds.
+
+ Every running world must call this once per update.  No migrant is sent or injected
+ while the worlds are gathered here, so the in flight count is stable when it is read.
+ */
+void cThreadedUniverse::AllReduce(int num_orgs, double merit, int& total_orgs, double& total_merit) {
+	m_mutex.Lock();
+	const int generation = m_reduce_generation;
+	m_reduce_orgs += num_orgs;
+	m_reduce_merit += merit;
+	if(++m_reduce_arrived >= m_num_running) {
+		m_result_orgs = m_reduce_orgs + m_in_flight;
+		m_result_merit = m_reduce_merit;
+		m_reduce_arrived = 0;
+		m_reduce_orgs = 0;
+		m_reduce_merit = 0.0;
+		m_reduce_generation++;
+		m_reduce_cond.Broadcast();
+	} else {
+		while(generation == m_reduce_generation) {
+			m_reduce_cond.Wait(m_mutex);
+		}
+	}
+	total_orgs = m_result_orgs;
+	total_merit = m_result_merit;
+	m_mutex.Unlock();
+}
+
+
+/*! Create and initialize a cThreadedMultiWorld.
+ */
+cThreadedMultiWorld* cThreadedMultiWorld::Initialize(cAvidaConfig* cfg, const cString& cwd, World* new_world,
+																										 cThreadedUniverse& universe, int index, cUserFeedback* feedback,
+																										 const Apto::Map<Apto::String, Apto::String>* mappings) {
+	cThreadedMultiWorld* world = new cThreadedMultiWorld(cfg, cwd, universe, index);
+	if(!world->CheckConfig(feedback) || !world->setup(new_world, feedback, mappings)) {
+		delete world;
+		world = NULL;
+	}
+	return world;
+}
+
+
+/*! Constructor.
+ */
+cThreadedMultiWorld::cThreadedMultiWorld(cAvidaConfig* cfg, const cString& cwd, cThreadedUniverse& universe, int index)
+: cWorld(cfg, cwd)
+, m_universe(universe)
+, m_index(index)
+, m_universe_dim(0)
+, m_universe_x(0)
+, m_universe_y(0)
+, m_universe_popsize(-1)
+, m_update_size_update(-1)
+, m_update_size(0)
+, m_num_posted(0) {
+	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
+		m_universe_dim = static_cast<int>(sqrt(static_cast<double>(m_universe.GetSize())) + 0.5);
+		m_universe_x = m_index % m_universe_dim;
+		m_universe_y = m_index / m_universe_dim;
+	}
+	SetupNeighbors();
+}
+
+
+/*! Destructor.
+
+ Migrants that were received but never came due are dropped along with the rest of
+ the population.
+ */
+cThreadedMultiWorld::~cThreadedMultiWorld() {
+	for(int i=0; i<m_pending.GetSize(); ++i) {
+		delete m_pending[i];
+	}
+}
+
+
+/*! Returns true if the configuration permits this world to take part in a universe.
+
+ Errors are only reported by the first world, as every world shares the same settings.
+ */
+bool cThreadedMultiWorld::CheckConfig(cUserFeedback* feedback) {
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_RANDOM: {
+			if((m_universe_dim * m_universe_dim) != m_universe.GetSize()) {
+				if(feedback && (m_index == 0)) feedback->Error("spatial avida-mt universes must have a square number of worlds");
+				return false;
+			}
+			const int geometry = GetConfig().WORLD_GEOMETRY.Get();
+			if((geometry != nGeometry::GRID) && (geometry != nGeometry::TORUS)) {
+				if(feedback && (m_index == 0)) feedback->Error("only bounded grid and toroidal geometries are supported for cell migration");
+				return false;
+			}
+			return true;
+		}
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: {
+			return true;
+		}
+		default: {
+			if(feedback && (m_index == 0)) {
+				feedback->Error("avida-mt only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM)");
+			}
+			return false;
+		}
+	}
+}
+
+
+/*! Determine the worlds that can send migrants to this one.
+
+ Migration between adjacent spatial worlds is symmetric, so these are also the worlds
+ that this one can send to.
+ */
+void cThreadedMultiWorld::SetupNeighbors() {
+	const int size = m_universe.GetSize();
+
+	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
+		const int candidates[4] = {
+			WorldAt(m_universe_x - 1, m_universe_y), WorldAt(m_universe_x + 1, m_universe_y),
+			WorldAt(m_universe_x, m_universe_y - 1), WorldAt(m_universe_x, m_universe_y + 1)
+		};
+		for(int i=0; i<4; ++i) {
+			bool seen = (candidates[i] == -1);
+			for(int j=0; !seen && (j<m_neighbors.GetSize()); ++j) {
+				seen = (m_neighbors[j] == candidates[i]);
+			}
+			if(!seen) {
+				m_neighbors.Push(candidates[i]);
+			}
+		}
+		return;
+	}
+
+	for(int i=0; i<size; ++i) {
+		if((i != m_index) || (size == 1)) {
+			m_neighbors.Push(i);
+		}
+	}
+}
+
+
+/*! Index of the world at the given universe coordinates, or -1 if there is none.
+
+ Coordinates off the edge of the universe wrap around on a torus.
+ */
+int cThreadedMultiWorld::WorldAt(int uni_x, int uni_y) const {
+	if(m_universe_dim <= 0) {
+		return -1;
+	}
+	if(GetConfig().WORLD_GEOMETRY.Get() == nGeometry::TORUS) {
+		uni_x = (uni_x + m_universe_dim) % m_universe_dim;
+		uni_y = (uni_y + m_universe_dim) % m_universe_dim;
+	} else if((uni_x < 0) || (uni_x >= m_universe_dim) || (uni_y < 0) || (uni_y >= m_universe_dim)) {
+		return -1;
+	}
+	return uni_y * m_universe_dim + uni_x;
+}
+
+
+/*! World that an organism born in the given boundary cell migrates to, or -1 if there is none (spatial only).
+
+ As in avida-mp, the left and right edges take precedence over the bottom and top.
+ */
+int cThreadedMultiWorld::SpatialDestination(const cPopulationCell& cell) const {
+	int x, y;
+	cell.GetPosition(x,y);
+	if(x == 0) {
+		return WorldAt(m_universe_x - 1, m_universe_y);
+	} else if(x == (GetConfig().WORLD_X.Get()-1)) {
+		return WorldAt(m_universe_x + 1, m_universe_y);
+	} else if(y == 0) {
+		return WorldAt(m_universe_x, m_universe_y - 1);
+	} else if(y == (GetConfig().WORLD_Y.Get()-1)) {
+		return WorldAt(m_universe_x, m_universe_y + 1);
+	}
+	return -1;
+}
+
+
+/*! Migrate this organism to a different world.
+
+ The migrant is copied directly into the destination's inbound queue; it becomes due
+ once this world completes the current update.
+ */
+void cThreadedMultiWorld::MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage) {
+	assert(org!=0);
+	int dst_world=-1;
+
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_RANDOM: { // spatial, the adjacent world across this boundary
+			dst_world = SpatialDestination(cell);
+			break;
+		}
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+			// prevent a migration back to this same world, unless this is the only world:
+			if(m_universe.GetSize() == 1) {
+				dst_world = 0;
+			} else {
+				dst_world = GetRandom().GetInt(m_universe.GetSize()-1);
+				if(dst_world >= m_index) {
+					++dst_world;
+				}
+			}
+			break;
+		}
+		default: {
+			GetDriver().RaiseFatalException(-1, "avida-mt only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
+		}
+	}
+
+	// IsWorldBoundary() rules out spatial cells without a world beyond them:
+	if(dst_world < 0) {
+		return;
+	}
+	assert(dst_world < m_universe.GetSize());
+
+	const Genome& genome = org->GetGenome();
+	ConstInstructionSequencePtr seq;
+	seq.DynamicCastFrom(genome.Representation());
+	int x, y;
+	cell.GetPosition(x, y);
+
+	sThreadedMigrant* migrant = new sThreadedMigrant;
+	migrant->src = m_index;
+	migrant->tag = m_num_posted;
+	migrant->hw_type = genome.HardwareType();
+	migrant->inst_set = (const char*)genome.Properties().Get("instset").StringValue();
+	migrant->ops.resize(seq->GetSize());
+	for(int i=0; i<seq->GetSize(); ++i) {
+		migrant->ops[i] = static_cast<unsigned char>((*seq)[i].GetOp());
+	}
+	migrant->merit = merit.GetDouble();
+	migrant->lineage = lineage;
+	migrant->x = x;
+	migrant->y = y;
+	migrant->generation = org->GetPhenotype().GetGeneration();
+
+	m_universe.AdjustInFlight(1);
+	m_universe.GetQueue(dst_world).Push(migrant);
+
+	// stats tracking:
+	GetStats().OutgoingMigrant(org);
+}
+
+
+/*! Returns true if an organism should be migrated to a different world.
+
+ Under mass action, the probability of migrating is (number of worlds-1)/(number of
+ worlds), and a single world always migrates back into itself, exactly as avida-mp.
+ */
+bool cThreadedMultiWorld::TestForMigration() {
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+			const int size = m_universe.GetSize();
+			if(size == 1) {
+				return true; // 1 world == always migrate
+			}
+			return GetRandom().P(static_cast<double>(size - 1) / size);
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+
+/*! Returns true if the given cell is on the boundary of the world, false otherwise.
+
+ Boundary cells of a bounded grid universe do not cause migrations, while on a torus
+ every boundary cell has a world beyond it.
+ */
+bool cThreadedMultiWorld::IsWorldBoundary(const cPopulationCell& cell) {
+	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
+		return (SpatialDestination(cell) != -1);
+	}
+	return false;
+}
+
+
+/*! Process post-update events.
+
+ Waits for the neighbors to complete the previous update, so that everything they sent
+ during it has been queued, then injects those migrants.  Migrants from neighbors that
+ have already moved on to this update stay pending until the next call.
+ */
+void cThreadedMultiWorld::ProcessPostUpdate(cAvidaContext& ctx) {
+	m_universe.WaitForWorlds(m_neighbors, m_num_posted);
+
+	for(sThreadedMigrant* migrant = m_universe.GetQueue(m_index).TakeAll(); migrant; migrant = migrant->next) {
+		m_pending.Push(migrant);
+	}
+
+	// inject in sender order, and in send order within each sender:
+	Apto::Array<sThreadedMigrant*> deferred;
+	for(int src=0; src<m_universe.GetSize(); ++src) {
+		for(int i=0; i<m_pending.GetSize(); ++i) {
+			sThreadedMigrant* migrant = m_pending[i];
+			if(migrant->src != src) {
+				continue;
+			}
+			if(migrant->tag < m_num_posted) {
+				InjectMigrant(ctx, migrant);
+				m_universe.AdjustInFlight(-1);
+				delete migrant;
+			} else {
+				deferred.Push(migrant);
+			}
+		}
+	}
+	m_pending = deferred;
+
+	m_universe.Posted(m_index, ++m_num_posted);
+}
+
+
+/*! Inject a received migrant into the local population.
+
+ Spatial migrants arrive at the opposite edge from the one they crossed, mass action
+ migrants at a random cell.
+ */
+void cThreadedMultiWorld::InjectMigrant(cAvidaContext& ctx, sThreadedMigrant* migrant) {
+	int target_cell=-1;
+
+	switch(GetConfig().BIRTH_METHOD.Get()) {
+		case POSITION_OFFSPRING_RANDOM: { // spatial
+			const int world_x = GetConfig().WORLD_X.Get();
+			const int world_y = GetConfig().WORLD_Y.Get();
+			int x = migrant->x;
+			int y = migrant->y;
+			if((x == 0) || (x == (world_x-1))) {
+				x = world_x - x - 1;
+			} else {
+				y = world_y - y - 1;
+			}
+			target_cell = world_x * y + x;
+			break;
+		}
+		case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+			target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+			break;
+		}
+		default: {
+			GetDriver().RaiseFatalException(-1, "avida-mt only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
+		}
+	}
+
+	InstructionSequencePtr seq(new InstructionSequence(migrant->ops.size()));
+	for(std::size_t i=0; i<migrant->ops.size(); ++i) {
+		(*seq)[i].SetOp(migrant->ops[i]);
+	}
+	HashPropertyMap props;
+	cHardwareManager::SetupPropertyMap(props, migrant->inst_set.c_str());
+
+	GetPopulation().InjectGenome(target_cell,
+															 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
+															 Genome(migrant->hw_type, props, seq),
+															 ctx, migrant->lineage); // lineage label
+
+	cOrganism* org = GetPopulation().GetCell(target_cell).GetOrganism();
+	org->UpdateMerit(ctx, migrant->merit);
+	org->GetPhenotype().SetGeneration(migrant->generation);
+	GetStats().IncomingMigrant(org);
+}
+
+
+/*! Returns true if this world allows early exits, e.g., when the population reaches 0.
+
+ Only the integrated scheduling style knows the size of the whole universe.
+ */
+bool cThreadedMultiWorld::AllowsEarlyExit() const {
+	return (m_universe_popsize == 0);
+}
+
+
+/*! Calculate the size (in virtual CPU cycles) of the current update.
+
+ With integrated scheduling, cycles are allotted according to this world's share of
+ the total merit across the universe, as in avida-mp.  The result is kept for the rest
+ of the update, since every world must join each reduction exactly once.
+ */
+int cThreadedMultiWorld::CalculateUpdateSize() {
+	if(m_update_size_update == GetStats().GetUpdate()) {
+		return m_update_size;
+	}
+
+	switch(GetConfig().MP_SCHEDULING_STYLE.Get()) {
+		case MP_SCHEDULING_NULL: { // default, non-MP aware
+			m_update_size = cWorld::CalculateUpdateSize();
+			break;
+		}
+		case MP_SCHEDULING_INTEGRATED: { // MP aware
+			const double local_merit = GetPopulation().GetOccupancy().GetTotalMerit();
+			double total_merit = 0.0;
+			m_universe.AllReduce(GetPopulation().GetNumOrganisms(), local_merit, m_universe_popsize, total_merit);
+
+			m_update_size = (total_merit > 0.0) ? static_cast<int>((local_merit/total_merit) * GetConfig().AVE_TIME_SLICE.Get() * m_universe_popsize) : 0;
+			break;
+		}
+		default: {
+			GetDriver().RaiseFatalException(-1, "Unrecognized MP_SCHEDULING_STYLE.");
+		}
+	}
+
+	m_update_size_update = GetStats().GetUpdate();
+	return m_update_size;
+}
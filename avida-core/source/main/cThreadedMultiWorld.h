@@ -0,0 +1,227 @@
+/*
+ *  cThreadedMultiWorld.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cThreadedMultiWorld_h
+#define cThreadedMultiWorld_h
+
+#include "apto/core.h"
+#include "apto/core/Mutex.h"
+
+#include "cWorld.h"
+
+#include <string>
+#include <vector>
+
+class cAvidaContext;
+class cMerit;
+class cOrganism;
+class cPopulationCell;
+class cUserFeedback;
+
+
+/*! A migrant travelling between two worlds of the same process.
+
+ The genome is carried as plain opcodes rather than as a Genome object, so that the
+ receiving thread rebuilds it without sharing any reference counted data with the
+ sender.
+ */
+struct sThreadedMigrant {
+	sThreadedMigrant* next; //!< Next migrant in the inbound queue.
+	int src; //!< Index of the world that sent this migrant.
+	int tag; //!< Number of post-update steps the sender had completed when it was sent.
+	int hw_type; //!< Hardware type of the migrating organism.
+	std::string inst_set; //!< Instruction set name of the migrating organism.
+	std::vector<unsigned char> ops; //!< Instruction opcodes of the migrating organism's genome.
+	double merit; //!< Merit of this organism in its originating population.
+	int lineage; //!< Lineage label of this organism in its orginating population.
+	int x; //!< X-coordinate of the cell from which this migrant originated.
+	int y; //!< Y-coordinate of the cell from which this migrant originated.
+	int generation; //!< Generation of this organism.
+};
+
+
+/*! Lock-free inbound queue of migrants, with any number of senders and one receiver.
+
+ Senders push onto an intrusive stack with compare-and-swap; the receiving world
+ takes the whole stack at once, so there is no ABA hazard and no sender ever waits.
+ */
+class cMigrantQueue {
+public:
+	//! Constructor.
+	cMigrantQueue() : m_head(NULL) { }
+
+	//! Destructor, frees any migrants that were never taken.
+	~cMigrantQueue();
+
+	//! Add a migrant; may be called from any thread.
+	void Push(sThreadedMigrant* migrant);
+
+	//! Remove every queued migrant, returned in the order they were pushed; receiver only.
+	sThreadedMigrant* TakeAll();
+
+private:
+	sThreadedMigrant* volatile m_head; //!< Most recently pushed migrant.
+
+	cMigrantQueue(const cMigrantQueue&); // @not_implemented
+	cMigrantQueue& operator=(const cMigrantQueue&); // @not_implemented
+};
+
+
+/*! The set of worlds that one avida-mt process runs, one per thread.
+
+ The universe owns the inbound queue of every world and tracks how far each world has
+ progressed, which is all the coordination that migration needs.  Worlds only ever
+ wait on their neighbors, except when MP_SCHEDULING_STYLE integrates the update size
+ across all worlds.
+ */
+class cThreadedUniverse {
+public:
+	//! Constructor.
+	cThreadedUniverse(int num_worlds);
+
+	//! Destructor.
+	~cThreadedUniverse();
+
+	//! Number of worlds in this universe.
+	int GetSize() const { return m_queues.GetSize(); }
+
+	//! Inbound queue of the world at the given index.
+	cMigrantQueue& GetQueue(int idx) { return *m_queues[idx]; }
+
+	//! Count a migrant as sent (delta 1) or injected or dropped (delta -1).
+	void AdjustInFlight(int delta) { __sync_add_and_fetch(&m_in_flight, delta); }
+
+	//! Record that a world has completed another post-update step.
+	void Posted(int idx, int num_posted);
+
+	//! Record that a world has stopped running; it is never again waited for.
+	void Finished(int idx);
+
+	//! Block until every given world has completed at least the given number of post-update steps, or finished.
+	void WaitForWorlds(const Apto::Array<int>& worlds, int num_posted);
+
+	//! Sum organisms (plus migrants in flight) and merits across all running worlds.
+	void AllReduce(int num_orgs, double merit, int& total_orgs, double& total_merit);
+
+private:
+	Apto::Array<cMigrantQueue*> m_queues; //!< Inbound migrant queue of each world.
+	Apto::Array<int> m_num_posted; //!< Post-update steps completed by each world.
+	Apto::Array<bool> m_finished; //!< True once a world has stopped running.
+	volatile int m_in_flight; //!< Migrants sent but not yet injected.
+
+	Apto::Mutex m_mutex; //!< Guards progress and the reduction.
+	Apto::ConditionVariable m_progress_cond; //!< Signalled whenever any world posts or finishes.
+	Apto::ConditionVariable m_reduce_cond; //!< Signalled when a reduction completes.
+	int m_num_running; //!< Worlds that have not finished.
+	int m_reduce_arrived; //!< Worlds that have joined the current reduction.
+	int m_reduce_generation; //!< Incremented as each reduction completes.
+	int m_reduce_orgs; //!< Partial organism sum of the current reduction.
+	double m_reduce_merit; //!< Partial merit sum of the current reduction.
+	int m_result_orgs; //!< Result of the last completed reduction.
+	double m_result_merit; //!< Result of the last completed reduction.
+
+	cThreadedUniverse(); // @not_implemented
+	cThreadedUniverse(const cThreadedUniverse&); // @not_implemented
+	cThreadedUniverse& operator=(const cThreadedUniverse&); // @not_implemented
+};
+
+
+/*! Multi-threaded Avida world.
+
+ This is the shared-memory counterpart of cMultiProcessWorld: several worlds run on
+ separate threads of one process and exchange organisms through cross-world
+ migration.  Migrants are copied straight into the inbound queue of the destination
+ world, so no serialization or message passing is involved.
+
+ As in avida-mp, a migrant sent during one update is injected at the end of the next,
+ in sender order and in send order within each sender.  Each world waits only for its
+ neighbors to finish the preceding update, which makes runs reproducible regardless of
+ how the threads are scheduled.
+ */
+class cThreadedMultiWorld : public cWorld
+	{
+	private:
+		cThreadedMultiWorld(); // @not_implemented
+		cThreadedMultiWorld(const cThreadedMultiWorld&); // @not_implemented
+		cThreadedMultiWorld& operator=(const cThreadedMultiWorld&); // @not_implemented
+
+	protected:
+		cThreadedUniverse& m_universe; //!< Shared universe of all worlds in this process.
+		int m_index; //!< Index of this world in the universe.
+		int m_universe_dim; //!< Dimension of the (square) universe, spatial worlds only.
+		int m_universe_x; //!< X-coordinate of this world in the universe.
+		int m_universe_y; //!< Y-coordinate of this world in the universe.
+		int m_universe_popsize; //!< Population size of the universe, or -1 if unknown.
+		int m_update_size_update; //!< Update for which m_update_size was calculated.
+		int m_update_size; //!< Size of that update, reused if it is asked for again.
+		Apto::Array<int> m_neighbors; //!< Worlds that can send migrants to this one.
+		int m_num_posted; //!< Post-update steps completed by this world.
+		Apto::Array<sThreadedMigrant*> m_pending; //!< Received migrants, in arrival order, not yet due.
+
+		//! Constructor.
+		cThreadedMultiWorld(cAvidaConfig* cfg, const cString& cwd, cThreadedUniverse& universe, int index);
+
+		//! Determine the worlds that can send migrants to this one.
+		void SetupNeighbors();
+
+		//! Index of the world at the given universe coordinates, or -1 if there is none.
+		int WorldAt(int uni_x, int uni_y) const;
+
+		//! World that an organism born in the given boundary cell migrates to, or -1 if there is none (spatial only).
+		int SpatialDestination(const cPopulationCell& cell) const;
+
+		//! Returns true if the configuration permits this world to take part in a universe.
+		bool CheckConfig(cUserFeedback* feedback);
+
+		//! Inject a received migrant into the local population.
+		void InjectMigrant(cAvidaContext& ctx, sThreadedMigrant* migrant);
+
+	public:
+		//! Create and initialize a cThreadedMultiWorld.
+		static cThreadedMultiWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, World* new_world,
+																					 cThreadedUniverse& universe, int index, cUserFeedback* feedback = NULL,
+																					 const Apto::Map<Apto::String, Apto::String>* mappings = NULL);
+
+		//! Destructor.
+		virtual ~cThreadedMultiWorld();
+
+		//! Index of this world in the universe.
+		int GetIndex() const { return m_index; }
+
+		//! Migrate this organism to a different world.
+		virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage);
+
+		//! Returns true if an organism should be migrated to a different world.
+		virtual bool TestForMigration();
+
+		//! Returns true if the given cell is on the boundary of the world, false otherwise.
+		virtual bool IsWorldBoundary(const cPopulationCell& cell);
+
+		//! Process post-update events.
+		virtual void ProcessPostUpdate(cAvidaContext& ctx);
+
+		//! Returns true if this world allows early exits, e.g., when the population reaches 0.
+		virtual bool AllowsEarlyExit() const;
+
+		//! Calculate the size (in virtual CPU cycles) of the current update.
+		virtual int CalculateUpdateSize();
+	};
+
+#endif
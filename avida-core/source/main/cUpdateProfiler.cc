@@ -0,0 +1,106 @@
+/*
+ *  cUpdateProfiler.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cUpdateProfiler.h"
+
+#include "cStats.h"
+
+#include <ctime>
+#include <iomanip>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <sys/time.h>
+#endif
+
+
+static const char* PHASE_NAMES[cUpdateProfiler::NUM_PHASES] = {
+  "events", "pre_update", "stats", "tiles", "execute", "deme_checks", "resources", "demes", "post_update",
+  "point_mutations", "world_update"
+};
+
+static const char* PHASE_DESCRIPTIONS[cUpdateProfiler::NUM_PHASES] = {
+  "mean event processing time [events]",
+  "mean pre-update time [pre_update]",
+  "mean stats update time [stats]",
+  "mean tile pre-execution time [tiles]",
+  "mean organism execution time [execute]",
+  "mean deme replication check time [deme_checks]",
+  "mean resource update time [resources]",
+  "mean deme update time [demes]",
+  "mean post-update time [post_update]",
+  "mean point mutation time [point_mutations]",
+  "mean world update time [world_update]"
+};
+
+
+cUpdateProfiler::cUpdateProfiler() : m_num_updates(0), m_num_insts(0.0), m_active(NULL)
+{
+  for (int i = 0; i < NUM_PHASES; i++) m_current[i] = m_last[i] = m_total[i] = 0.0;
+}
+
+
+double cUpdateProfiler::Now()
+{
+#if APTO_PLATFORM(WINDOWS)
+  return (double)clock() / CLOCKS_PER_SEC;
+#else
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+#endif
+}
+
+
+const char* cUpdateProfiler::GetPhaseName(int phase)
+{
+  return PHASE_NAMES[phase];
+}
+
+
+void cUpdateProfiler::FinishUpdate(cStats& stats)
+{
+  cStats::profiling_stats_t pf;
+  for (int i = 0; i < NUM_PHASES; i++) {
+    m_last[i] = m_current[i];
+    m_total[i] += m_current[i];
+    m_current[i] = 0.0;
+    pf[PHASE_DESCRIPTIONS[i]] = m_last[i];
+  }
+  stats.ProfilingData(pf);
+  
+  m_num_updates++;
+  m_num_insts += stats.GetNumExecuted();
+}
+
+
+void cUpdateProfiler::PrintSummary(std::ostream& out, double wall) const
+{
+  const std::ios::fmtflags flags = out.flags();
+  const std::streamsize precision = out.precision();
+  
+  out << std::noshowpoint << "timing: updates=" << m_num_updates << std::fixed << std::setprecision(0) << " insts=" << m_num_insts
+      << std::setprecision(6) << " wall=" << wall;
+  for (int i = 0; i < NUM_PHASES; i++) out << " " << PHASE_NAMES[i] << "=" << m_total[i];
+  out << std::endl;
+  
+  out.flags(flags);
+  out.precision(precision);
+}
@@ -0,0 +1,117 @@
+/*
+ *  cUpdateProfiler.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cUpdateProfiler_h
+#define cUpdateProfiler_h
+
+#include <iostream>
+
+class cStats;
+
+
+// cUpdateProfiler accumulates the wall clock time spent in each phase of an update.  Phases are timed by placing a
+// cScope on the stack; scopes nest, and each phase is charged only for time not spent in the scopes nested inside it.
+// The world owns a profiler only when PROFILE_UPDATES or PRINT_RUN_TIMINGS is set, scopes given a NULL profiler do
+// nothing.
+
+class cUpdateProfiler
+{
+public:
+  enum ePhase {
+    EVENTS = 0,
+    PRE_UPDATE,
+    STATS,
+    TILES,            // speculative pre-execution of population tiles on the worker threads
+    EXECUTE,          // organism hardware, in the ProcessStep loop
+    DEME_CHECKS,      // implicit deme replication checks, in the ProcessStep loop
+    RESOURCES,        // bringing resources up to date at the end of the update
+    DEMES,            // deme statistics and per deme update processing
+    POST_UPDATE,      // everything else in the population and world post-update processing
+    POINT_MUTATIONS,
+    WORLD_UPDATE,     // Avida::World::PerformUpdate, data recording and output
+    NUM_PHASES
+  };
+  
+  class cScope
+  {
+  private:
+    cUpdateProfiler* m_profiler;
+    ePhase m_phase;
+    double m_start;
+    double m_nested;
+    cScope* m_parent;
+    
+    cScope(); // @not_implemented
+    cScope(const cScope&); // @not_implemented
+    cScope& operator=(const cScope&); // @not_implemented
+    
+  public:
+    inline cScope(cUpdateProfiler* profiler, ePhase phase);
+    inline ~cScope();
+  };
+  
+private:
+  double m_current[NUM_PHASES];   // this update, so far
+  double m_last[NUM_PHASES];      // the last completed update
+  double m_total[NUM_PHASES];     // all completed updates
+  int m_num_updates;
+  double m_num_insts;
+  cScope* m_active;
+  
+  cUpdateProfiler(const cUpdateProfiler&); // @not_implemented
+  cUpdateProfiler& operator=(const cUpdateProfiler&); // @not_implemented
+  
+public:
+  cUpdateProfiler();
+  
+  static double Now();
+  static const char* GetPhaseName(int phase);
+  
+  // Close out the current update, handing its phase times to stats for PrintProfilingData
+  void FinishUpdate(cStats& stats);
+  
+  double GetLastTime(int phase) const { return m_last[phase]; }
+  
+  // Single line summary of the completed updates, "timing: updates=... insts=... wall=... <phase>=...", read by the
+  // test runner's benchmark mode
+  void PrintSummary(std::ostream& out, double wall) const;
+};
+
+
+inline cUpdateProfiler::cScope::cScope(cUpdateProfiler* profiler, ePhase phase)
+  : m_profiler(profiler), m_phase(phase), m_start(0.0), m_nested(0.0), m_parent(NULL)
+{
+  if (!m_profiler) return;
+  m_parent = m_profiler->m_active;
+  m_profiler->m_active = this;
+  m_start = Now();
+}
+
+inline cUpdateProfiler::cScope::~cScope()
+{
+  if (!m_profiler) return;
+  const double elapsed = Now() - m_start;
+  m_profiler->m_current[m_phase] += elapsed - m_nested;
+  if (m_parent) m_parent->m_nested += elapsed;
+  m_profiler->m_active = m_parent;
+}
+
+#endif
@@ -30,7 +30,10 @@
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Manager.h"
 
+#include "avida/private/systematics/GenomeTestQueue.h"
 #include "avida/private/systematics/GenotypeArbiter.h"
+#include "avida/private/systematics/PhylogenyLog.h"
+#include "avida/private/util/MemoryStats.h"
 
 #include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
@@ -38,10 +41,12 @@
 #include "cEventList.h"
 #include "cHardwareManager.h"
 #include "cMigrationMatrix.h"  
+#include "cOrgMessage.h"
 #include "cInstSet.h"
 #include "cPopulation.h"
 #include "cStats.h"
 #include "cTestCPU.h"
+#include "cUpdateProfiler.h"
 #include "cUserFeedback.h"
 
 #include <cassert>
@@ -51,7 +56,7 @@ using namespace AvidaTools;
 
 cWorld::cWorld(cAvidaConfig* cfg, const cString& wd)
   : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL)
-  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
+  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_profiler(NULL), m_msg_pool(NULL), m_phylo_log(NULL), m_test_queue(NULL), m_data_mgr(NULL)
   , m_own_driver(false)
 {
 }
@@ -73,6 +78,10 @@ cWorld::~cWorld()
   // These must be deleted first
   delete m_analyze; m_analyze = NULL;
   
+  // Stop logging before the population is torn down, so the remaining genotypes are not reported extinct
+  delete m_phylo_log; m_phylo_log = NULL;
+  delete m_test_queue; m_test_queue = NULL;
+  
   // Forcefully clean up population before classification manager
   m_pop = Apto::SmartPtr<cPopulation, Apto::InternalRCObject>();
   
@@ -81,6 +90,8 @@ cWorld::~cWorld()
   delete m_hw_mgr; m_hw_mgr = NULL;
 
   delete m_mig_mat; 
+  delete m_profiler; m_profiler = NULL;
+  delete m_msg_pool; m_msg_pool = NULL;
   
   // Delete Last
   delete m_conf; m_conf = NULL;
@@ -99,6 +110,9 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   
   bool success = true;
   
+  // Before anything is allocated, so that the live object counts start from zero
+  if (m_conf->TRACK_ALLOCATIONS.Get()) Util::MemoryStats::Enable();
+  
   // Setup Random Number Generator
   m_rng.ResetSeed(m_conf->RANDOM_SEED.Get());
   m_ctx = new cAvidaContext(NULL, m_rng);
@@ -114,13 +128,21 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
     
     // Output Manager
     Apto::String opath = Apto::FileSystem::GetAbsolutePath(Apto::String(m_conf->DATA_DIR.Get()), Apto::String(m_working_dir));
-    Output::ManagerPtr(new Output::Manager(opath))->AttachTo(new_world);
+    Output::ManagerPtr output_mgr(new Output::Manager(opath));
+    output_mgr->AttachTo(new_world);
+    if (m_conf->ASYNC_OUTPUT.Get() > 0) output_mgr->EnableAsyncWriter(m_conf->ASYNC_OUTPUT.Get() * 1024);
+    switch (m_conf->DATA_FILE_FORMAT.Get()) {
+      case 1: output_mgr->SetDefaultFileFormat(Output::BINARY_FORMAT); break;
+      case 2: output_mgr->SetDefaultFileFormat(Output::BINARY_COMPRESSED_FORMAT); break;
+      default: output_mgr->SetDefaultFileFormat(Output::TEXT_FORMAT); break;
+    }
   }
   
 
   m_env = new cEnvironment(this);
     
   m_mig_mat = new cMigrationMatrix(); 
+  m_msg_pool = new cOrgMessagePool;
   
   
   // Initialize the default environment...
@@ -146,8 +168,24 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   Systematics::ManagerPtr systematics(new Systematics::Manager);
   systematics->AttachTo(new_world);
   systematics->RegisterArbiter(Systematics::ArbiterPtr(new Systematics::GenotypeArbiter(new_world, "genotype", m_conf->THRESHOLD.Get(), m_conf->DISABLE_GENOTYPE_CLASSIFICATION.Get())));
+  if (m_conf->PHYLOGENY_LOG.Get() != "") {
+    Apto::String path = Output::Manager::Of(new_world)->OutputIDFromPath(Apto::String(m_conf->PHYLOGENY_LOG.Get()));
+    m_phylo_log = new Systematics::PhylogenyLog(systematics->ArbiterForRole("genotype"), path, m_conf->PHYLOGENY_LOG_PRUNE.Get());
+    if (!m_phylo_log->IsOpen()) {
+      if (feedback) feedback->Error("unable to open phylogeny log '%s'", (const char*)path);
+      success = false;
+    }
+  }
+  if (m_conf->BACKGROUND_GENOME_TESTS.Get()) {
+    m_test_queue = new Systematics::GenomeTestQueue(this, systematics->ArbiterForRole("genotype"));
+  }
+  
+  // Every facet is attached by now, so the update waves are final
+  new_world->SetUpdateThreads(m_conf->FACET_THREADS.Get());
 
   
+  if (m_conf->PROFILE_UPDATES.Get() || m_conf->PRINT_RUN_TIMINGS.Get()) m_profiler = new cUpdateProfiler;
+  
   // Setup Stats Object
   m_stats = Apto::SmartPtr<cStats, Apto::InternalRCObject>(new cStats(this));
   Data::Manager::Of(m_new_world)->AttachRecorder(m_stats);
@@ -193,7 +231,9 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   const bool sterilize_taskloss = m_conf->STERILIZE_TASKLOSS.Get() > 0.0;
   m_test_sterilize = (sterilize_fatal || sterilize_neg || sterilize_neut || sterilize_pos || sterilize_taskloss);
 
+  RefreshRuntimeConfig();
   m_pop = Apto::SmartPtr<cPopulation, Apto::InternalRCObject>(new cPopulation(this));
+  RefreshRuntimeConfig();  // population setup may adjust settings (e.g. ENERGY_CAP)
   
   // Setup Event List
   m_event_list = new cEventList(this);
@@ -222,6 +262,40 @@ void cWorld::GetEvents(cAvidaContext& ctx)
     m_pop->SetSyncEvents(false);
   }
   m_event_list->Process(ctx);
+  
+  // Events (SetConfig, SetMutProb, ...) are the run time source of setting changes
+  RefreshRuntimeConfig();
+}
+
+void cWorld::RefreshRuntimeConfig()
+{
+  m_rt_conf.energy_enabled = m_conf->ENERGY_ENABLED.Get();
+  m_rt_conf.task_switch_penalty_type = m_conf->TASK_SWITCH_PENALTY_TYPE.Get();
+  m_rt_conf.task_switch_penalty = m_conf->TASK_SWITCH_PENALTY.Get();
+  m_rt_conf.implicit_repro_time = m_conf->IMPLICIT_REPRO_TIME.Get();
+  m_rt_conf.implicit_repro_cpu_cycles = m_conf->IMPLICIT_REPRO_CPU_CYCLES.Get();
+  m_rt_conf.implicit_repro_bonus = m_conf->IMPLICIT_REPRO_BONUS.Get();
+  m_rt_conf.implicit_repro_end = m_conf->IMPLICIT_REPRO_END.Get();
+  m_rt_conf.implicit_repro_energy = m_conf->IMPLICIT_REPRO_ENERGY.Get();
+  
+  m_rt_conf.use_avatars = m_conf->USE_AVATARS.Get();
+  m_rt_conf.save_received = m_conf->SAVE_RECEIVED.Get();
+  m_rt_conf.merit_inc_apply_immediate = m_conf->MERIT_INC_APPLY_IMMEDIATE.Get();
+  m_rt_conf.apply_energy_method = m_conf->APPLY_ENERGY_METHOD.Get();
+  m_rt_conf.task_refractory_period = m_conf->TASK_REFRACTORY_PERIOD.Get();
+  m_rt_conf.age_poly_tracking = m_conf->AGE_POLY_TRACKING.Get();
+  m_rt_conf.learning_count = m_conf->LEARNING_COUNT.Get();
+  
+  m_rt_conf.juv_period = m_conf->JUV_PERIOD.Get();
+  m_rt_conf.min_cycles = m_conf->MIN_CYCLES.Get();
+  m_rt_conf.offspring_size_range = m_conf->OFFSPRING_SIZE_RANGE.Get();
+  m_rt_conf.max_genome_size = m_conf->MAX_GENOME_SIZE.Get();
+  m_rt_conf.min_genome_size = m_conf->MIN_GENOME_SIZE.Get();
+  m_rt_conf.min_exe_lines = m_conf->MIN_EXE_LINES.Get();
+  m_rt_conf.min_copied_lines = m_conf->MIN_COPIED_LINES.Get();
+  m_rt_conf.use_form_groups = m_conf->USE_FORM_GROUPS.Get();
+  m_rt_conf.default_group = m_conf->DEFAULT_GROUP.Get();
+  m_rt_conf.divide_failure_resets = m_conf->DIVIDE_FAILURE_RESETS.Get();
 }
 
 int cWorld::GetNumResources()
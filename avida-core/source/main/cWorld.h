@@ -29,6 +29,7 @@
 
 #include "cAvidaConfig.h"
 #include "cAvidaContext.h"
+#include "cRuntimeConfig.h"
 
 #include <cassert>
 
@@ -39,13 +40,16 @@ class cEventList;
 class cHardwareManager;
 class cMigrationMatrix; 
 class cOrganism;
+class cOrgMessagePool;
 class cPopulation;
 class cMerit;
 class cPopulationCell;
 class cStats;
 class cTestCPU;
+class cUpdateProfiler;
 class cUserFeedback;
 template<class T> class tDataEntry;
+namespace Avida { namespace Systematics { class GenomeTestQueue; class PhylogenyLog; }; };
 
 using namespace Avida;
 
@@ -66,6 +70,10 @@ protected:
   Apto::SmartPtr<cStats, Apto::InternalRCObject> m_stats;
   cMigrationMatrix* m_mig_mat;  
   WorldDriver* m_driver;
+  cUpdateProfiler* m_profiler;
+  cOrgMessagePool* m_msg_pool;
+  Systematics::PhylogenyLog* m_phylo_log;
+  Systematics::GenomeTestQueue* m_test_queue;
   
   Data::ManagerPtr m_data_mgr;
 
@@ -73,6 +81,7 @@ protected:
   
   bool m_test_on_div;     // flag derived from a collection of configuration settings
   bool m_test_sterilize;  // flag derived from a collection of configuration settings
+  cRuntimeConfig m_rt_conf;  // flat copy of the settings read on hot paths, see RefreshRuntimeConfig()
   
   bool m_own_driver;      // specifies whether this world object should manage its driver object
 
@@ -90,15 +99,19 @@ public:
   // General Object Accessors
   cAnalyze& GetAnalyze();
   cAvidaConfig& GetConfig() { return *m_conf; }
+  const cRuntimeConfig& GetRuntimeConfig() const { return m_rt_conf; }
   cAvidaContext& GetDefaultContext() { return *m_ctx; }
   cEnvironment& GetEnvironment() { return *m_env; }
   cHardwareManager& GetHardwareManager() { return *m_hw_mgr; }
   cMigrationMatrix& GetMigrationMatrix(){ return *m_mig_mat; };
+  cOrgMessagePool& GetMessagePool() { return *m_msg_pool; }
+  Systematics::GenomeTestQueue* GetGenomeTestQueue() { return m_test_queue; }
   cPopulation& GetPopulation() { return *m_pop; }
   Apto::Random& GetRandom() { return m_rng; }
   cStats& GetStats() { return *m_stats; }
   WorldDriver& GetDriver() { return *m_driver; }
   World* GetNewWorld() { return m_new_world; }
+  cUpdateProfiler* GetProfiler() { return m_profiler; }  // NULL unless update profiling is enabled
   
   Data::ManagerPtr& GetDataManager() { return m_data_mgr; }
   
@@ -109,6 +122,9 @@ public:
   bool GetTestOnDivide() const { return m_test_on_div; }
   bool GetTestSterilize() const { return m_test_sterilize; }
   
+  // Rebuild the runtime config from the current settings; needed only after settings change outside of events
+  void RefreshRuntimeConfig();
+  
   // Convenience Accessors
   int GetNumResources();
   inline int GetVerbosity() { return m_conf->VERBOSITY.Get(); }
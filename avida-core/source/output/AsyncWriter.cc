@@ -0,0 +1,150 @@
+/*
+ *  output/AsyncWriter.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/output/AsyncWriter.h"
+
+
+Avida::Output::AsyncWriter::AsyncWriter(int max_bytes)
+  : m_queued_bytes(0), m_max_bytes(max_bytes), m_writing(false), m_stopped(false)
+{
+  Start();
+}
+
+Avida::Output::AsyncWriter::~AsyncWriter()
+{
+  Stop();
+}
+
+
+void Avida::Output::AsyncWriter::Submit(std::streambuf* target, const char* data, int size)
+{
+  if (size <= 0) return;
+
+  Apto::MutexAutoLock lock(m_mutex);
+
+  // Once stopped, fall back to writing on the calling thread
+  if (m_stopped) {
+    target->sputn(data, size);
+    target->pubsync();
+    return;
+  }
+
+  // Bound the amount of buffered output, always admitting at least one block so oversized blocks cannot stall
+  while (m_queue.size() && m_queued_bytes + size > m_max_bytes) m_space_cond.Wait(m_mutex);
+
+  Block* block = new Block;
+  block->target = target;
+  block->data.assign(data, size);
+  m_queue.push_back(block);
+  m_queued_bytes += size;
+
+  m_pending_cond.Signal();
+}
+
+
+void Avida::Output::AsyncWriter::WaitIdle()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  while (m_queue.size() || m_writing) m_space_cond.Wait(m_mutex);
+}
+
+
+void Avida::Output::AsyncWriter::Stop()
+{
+  m_mutex.Lock();
+  if (m_stopped) {
+    m_mutex.Unlock();
+    return;
+  }
+  m_stopped = true;
+  m_pending_cond.Signal();
+  m_mutex.Unlock();
+
+  // The writer drains everything queued before it exits
+  Join();
+}
+
+
+void Avida::Output::AsyncWriter::Run()
+{
+  m_mutex.Lock();
+  while (true) {
+    while (m_queue.empty() && !m_stopped) m_pending_cond.Wait(m_mutex);
+    if (m_queue.empty()) break;
+
+    Block* block = m_queue.front();
+    m_queue.pop_front();
+    m_writing = true;
+    m_mutex.Unlock();
+
+    block->target->sputn(block->data.data(), block->data.size());
+    block->target->pubsync();
+
+    m_mutex.Lock();
+    m_writing = false;
+    m_queued_bytes -= block->data.size();
+    m_space_cond.Broadcast();
+    delete block;
+  }
+  m_mutex.Unlock();
+}
+
+
+
+Avida::Output::AsyncFileBuffer::AsyncFileBuffer(AsyncWriterPtr writer, std::streambuf* target)
+  : m_writer(writer), m_target(target)
+{
+  setp(m_block, m_block + BLOCK_SIZE);
+}
+
+Avida::Output::AsyncFileBuffer::~AsyncFileBuffer()
+{
+  Drain();
+}
+
+
+void Avida::Output::AsyncFileBuffer::Drain()
+{
+  submit();
+  m_writer->WaitIdle();
+}
+
+
+Avida::Output::AsyncFileBuffer::int_type Avida::Output::AsyncFileBuffer::overflow(int_type c)
+{
+  submit();
+  if (!traits_type::eq_int_type(c, traits_type::eof())) sputc(traits_type::to_char_type(c));
+  return traits_type::not_eof(c);
+}
+
+
+int Avida::Output::AsyncFileBuffer::sync()
+{
+  submit();
+  return 0;
+}
+
+
+void Avida::Output::AsyncFileBuffer::submit()
+{
+  m_writer->Submit(m_target, pbase(), pptr() - pbase());
+  setp(m_block, m_block + BLOCK_SIZE);
+}
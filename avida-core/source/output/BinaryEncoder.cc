@@ -0,0 +1,334 @@
+/*
+ *  output/BinaryEncoder.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/output/BinaryEncoder.h"
+
+#include <cassert>
+#include <cstring>
+
+
+namespace {
+  static const unsigned int BINARY_FORMAT_VERSION = 2;
+  static const unsigned int BINARY_ENDIAN_MARKER = 0x01020304;
+
+  template <typename T> inline void appendValue(std::string& buf, const T& value)
+  {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T> inline T readValue(const std::string& buf, size_t& pos)
+  {
+    T value;
+    memcpy(&value, buf.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+
+  inline void appendString(std::string& buf, const char* str, unsigned int len)
+  {
+    appendValue(buf, len);
+    buf.append(str, len);
+  }
+
+  inline void appendVarint(std::string& buf, unsigned long long value)
+  {
+    while (value >= 0x80) {
+      buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buf.push_back(static_cast<char>(value));
+  }
+
+  // Similar values share their sign, exponent and high mantissa bits, leaving only the low bytes significant
+  inline void appendXorBytes(std::string& buf, unsigned long long diff)
+  {
+    unsigned char num_bytes = 0;
+    for (unsigned long long rest = diff; rest; rest >>= 8) num_bytes++;
+    buf.push_back(static_cast<char>(num_bytes));
+    for (unsigned char b = 0; b < num_bytes; b++) buf.push_back(static_cast<char>((diff >> (8 * b)) & 0xFF));
+  }
+
+  inline unsigned long long zigzag(long long value)
+  {
+    return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+  }
+
+  inline void writeString(std::ostream& out, const Apto::String& str)
+  {
+    unsigned int len = str.GetSize();
+    out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.write((const char*)str, len);
+  }
+}
+
+
+Avida::Output::BinaryEncoder::BinaryEncoder(bool compress, int block_rows)
+  : m_compress(compress), m_block_rows(block_rows), m_schema_done(false), m_cur_col(0), m_rows(0)
+{
+  assert(m_block_rows > 0);
+}
+
+
+void Avida::Output::BinaryEncoder::Write(double x, const char* descr)
+{
+  Column* col = nextColumn(COL_DOUBLE, descr);
+  if (col) appendValue(col->values, x);
+}
+
+void Avida::Output::BinaryEncoder::Write(int i, const char* descr)
+{
+  Column* col = nextColumn(COL_INT32, descr);
+  if (col) appendValue(col->values, i);
+}
+
+void Avida::Output::BinaryEncoder::Write(long i, const char* descr)
+{
+  Column* col = nextColumn(COL_INT64, descr);
+  if (col) appendValue(col->values, static_cast<long long>(i));
+}
+
+void Avida::Output::BinaryEncoder::Write(unsigned int i, const char* descr)
+{
+  Column* col = nextColumn(COL_UINT32, descr);
+  if (col) appendValue(col->values, i);
+}
+
+void Avida::Output::BinaryEncoder::Write(const char* data_str, const char* descr)
+{
+  Column* col = nextColumn(COL_STRING, descr);
+  if (col) appendString(col->values, data_str, strlen(data_str));
+}
+
+void Avida::Output::BinaryEncoder::Write(const Apto::Array<int>& list, const char* descr)
+{
+  Column* col = nextColumn(COL_INT_ARRAY, descr);
+  if (!col) return;
+
+  appendValue(col->values, static_cast<unsigned int>(list.GetSize()));
+  for (int i = 0; i < list.GetSize(); i++) appendValue(col->values, list[i]);
+}
+
+void Avida::Output::BinaryEncoder::Write(const Apto::Array<double>& list, const char* descr)
+{
+  Column* col = nextColumn(COL_DOUBLE_ARRAY, descr);
+  if (!col) return;
+  
+  appendValue(col->values, static_cast<unsigned int>(list.GetSize()));
+  if (list.GetSize()) col->values.append(reinterpret_cast<const char*>(&list[0]), sizeof(double) * list.GetSize());
+}
+
+
+void Avida::Output::BinaryEncoder::WriteHeader(std::ostream& out, const Apto::String& filetype,
+                                               const Apto::String& format, const Apto::String& comments)
+{
+  assert(!m_schema_done);
+
+  out.write("AVIDABIN", 8);
+  out.write(reinterpret_cast<const char*>(&BINARY_FORMAT_VERSION), sizeof(BINARY_FORMAT_VERSION));
+  out.write(reinterpret_cast<const char*>(&BINARY_ENDIAN_MARKER), sizeof(BINARY_ENDIAN_MARKER));
+
+  writeString(out, filetype);
+  writeString(out, format);
+  writeString(out, comments);
+
+  unsigned int num_cols = m_columns.GetSize();
+  out.write(reinterpret_cast<const char*>(&num_cols), sizeof(num_cols));
+  for (int i = 0; i < m_columns.GetSize(); i++) {
+    unsigned char type = m_columns[i].type;
+    out.write(reinterpret_cast<const char*>(&type), 1);
+    writeString(out, m_columns[i].descr);
+  }
+
+  m_schema_done = true;
+}
+
+
+void Avida::Output::BinaryEncoder::EndRow(std::ostream& out)
+{
+  assert(m_schema_done);
+
+  // Rows that wrote fewer columns than the schema are padded, so every column keeps one value per row
+  for (; m_cur_col < m_columns.GetSize(); m_cur_col++) appendDefault(m_columns[m_cur_col]);
+
+  m_cur_col = 0;
+  if (++m_rows == m_block_rows) writeBlock(out);
+}
+
+
+void Avida::Output::BinaryEncoder::Flush(std::ostream& out)
+{
+  if (m_schema_done && m_rows) writeBlock(out);
+}
+
+
+Avida::Output::BinaryEncoder::Column* Avida::Output::BinaryEncoder::nextColumn(ColumnType type, const char* descr)
+{
+  if (!m_schema_done) {
+    // Still collecting the first row; each write defines the next column
+    m_columns.Resize(m_columns.GetSize() + 1);
+    Column& col = m_columns[m_columns.GetSize() - 1];
+    col.type = type;
+    col.descr = descr;
+    m_cur_col++;
+    return &col;
+  }
+
+  // Values beyond the schema, or whose type does not match it, cannot be stored
+  assert(m_cur_col < m_columns.GetSize() && m_columns[m_cur_col].type == type);
+  if (m_cur_col >= m_columns.GetSize()) return NULL;
+
+  Column& col = m_columns[m_cur_col++];
+  if (col.type != type) {
+    appendDefault(col);
+    return NULL;
+  }
+  return &col;
+}
+
+
+void Avida::Output::BinaryEncoder::appendDefault(Column& col)
+{
+  switch (col.type) {
+    case COL_DOUBLE:    appendValue(col.values, 0.0); break;
+    case COL_INT32:     appendValue(col.values, 0); break;
+    case COL_INT64:     appendValue(col.values, 0LL); break;
+    case COL_UINT32:    appendValue(col.values, 0u); break;
+    case COL_STRING:    appendValue(col.values, 0u); break;
+    case COL_INT_ARRAY: appendValue(col.values, 0u); break;
+    case COL_DOUBLE_ARRAY: appendValue(col.values, 0u); break;
+  }
+}
+
+
+void Avida::Output::BinaryEncoder::writeBlock(std::ostream& out)
+{
+  unsigned int rows = m_rows;
+  out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+
+  std::string payload;
+  for (int i = 0; i < m_columns.GetSize(); i++) {
+    Column& col = m_columns[i];
+
+    // Keep the compressed form only when it is actually smaller than the raw values
+    unsigned char encoding = ENCODE_RAW;
+    const std::string* data = &col.values;
+    if (m_compress) {
+      payload.clear();
+      bool encoded = false;
+      if (col.type == COL_INT_ARRAY) {
+        encodeArrayDelta(col, payload);
+        encoded = true;
+        encoding = ENCODE_DELTA;
+      } else if (col.type == COL_DOUBLE_ARRAY) {
+        encodeArrayXor(col, payload);
+        encoded = true;
+        encoding = ENCODE_XOR;
+      } else if (col.type == COL_DOUBLE) {
+        encoded = encodeXor(col, payload);
+        if (encoded) encoding = ENCODE_XOR;
+      } else {
+        encoded = encodeDelta(col, payload);
+        if (encoded) encoding = ENCODE_DELTA;
+      }
+      if (encoded && payload.size() < col.values.size()) data = &payload;
+      else encoding = ENCODE_RAW;
+    }
+
+    unsigned int size = data->size();
+    out.write(reinterpret_cast<const char*>(&encoding), 1);
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(data->data(), size);
+
+    col.values.clear();
+  }
+
+  m_rows = 0;
+}
+
+
+bool Avida::Output::BinaryEncoder::encodeDelta(const Column& col, std::string& payload) const
+{
+  size_t pos = 0;
+  long long prev = 0;
+  while (pos < col.values.size()) {
+    long long value = 0;
+    switch (col.type) {
+      case COL_INT32:  value = readValue<int>(col.values, pos); break;
+      case COL_INT64:  value = readValue<long long>(col.values, pos); break;
+      case COL_UINT32: value = readValue<unsigned int>(col.values, pos); break;
+      default: return false;
+    }
+    appendVarint(payload, zigzag(value - prev));
+    prev = value;
+  }
+  return true;
+}
+
+
+bool Avida::Output::BinaryEncoder::encodeXor(const Column& col, std::string& payload) const
+{
+  size_t pos = 0;
+  unsigned long long prev = 0;
+  while (pos < col.values.size()) {
+    unsigned long long bits = readValue<unsigned long long>(col.values, pos);
+    appendXorBytes(payload, bits ^ prev);
+    prev = bits;
+  }
+  return true;
+}
+
+
+void Avida::Output::BinaryEncoder::encodeArrayDelta(const Column& col, std::string& payload) const
+{
+  size_t pos = 0;
+  Apto::Array<int> prev;
+  while (pos < col.values.size()) {
+    const unsigned int count = readValue<unsigned int>(col.values, pos);
+    appendVarint(payload, count);
+    for (unsigned int i = 0; i < count; i++) {
+      const int value = readValue<int>(col.values, pos);
+      const long long last = (static_cast<int>(i) < prev.GetSize()) ? prev[i] : 0;
+      appendVarint(payload, zigzag(value - last));
+      if (static_cast<int>(i) < prev.GetSize()) prev[i] = value;
+      else prev.Push(value);
+    }
+    prev.Resize(count);
+  }
+}
+
+
+void Avida::Output::BinaryEncoder::encodeArrayXor(const Column& col, std::string& payload) const
+{
+  size_t pos = 0;
+  Apto::Array<unsigned long long> prev;
+  while (pos < col.values.size()) {
+    const unsigned int count = readValue<unsigned int>(col.values, pos);
+    appendVarint(payload, count);
+    for (unsigned int i = 0; i < count; i++) {
+      const unsigned long long bits = readValue<unsigned long long>(col.values, pos);
+      const unsigned long long last = (static_cast<int>(i) < prev.GetSize()) ? prev[i] : 0;
+      appendXorBytes(payload, bits ^ last);
+      if (static_cast<int>(i) < prev.GetSize()) prev[i] = bits;
+      else prev.Push(bits);
+    }
+    prev.Resize(count);
+  }
+}
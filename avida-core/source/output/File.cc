@@ -27,7 +27,43 @@
 #include "avida/core/Feedback.h"
 #include "avida/output/Manager.h"
 
+#include "avida/private/output/AsyncWriter.h"
+#include "avida/private/output/BinaryEncoder.h"
+
+#include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <string>
+
+
+namespace {
+  inline void appendInt(std::string& buf, long long value)
+  {
+    char digits[24];
+    int len = 0;
+    const bool negative = (value < 0);
+    unsigned long long rest = negative ? (0ULL - static_cast<unsigned long long>(value)) : value;
+    do {
+      digits[len++] = static_cast<char>('0' + rest % 10);
+      rest /= 10;
+    } while (rest);
+    if (negative) buf.push_back('-');
+    while (len) buf.push_back(digits[--len]);
+  }
+  
+  // Matches the default ostream form of a double (%g, 6 significant digits); whole numbers below a million print as
+  // integers in that form, and spatial grids are mostly made of them, so they skip the printf machinery
+  inline void appendDouble(std::string& buf, double value)
+  {
+    if (value > -1e6 && value < 1e6 && value == std::floor(value) && !(value == 0.0 && std::signbit(value))) {
+      appendInt(buf, static_cast<long long>(value));
+      return;
+    }
+    char text[32];
+    const int len = snprintf(text, sizeof(text), "%g", value);
+    buf.append(text, len);
+  }
+}
 
 
 Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::String path, bool append, Feedback* feedback)
@@ -45,7 +81,14 @@ Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::S
     return FilePtr(NULL);
   }
   
-  FilePtr rtn(new File(world, oid, append));
+  // Appended files may already hold text, so only fresh files are written in binary
+  FileFormat format = TEXT_FORMAT;
+  if (!append) {
+    format = mgr->DefaultFileFormat();
+    if (oid.GetSize() > 5 && oid.Substring(oid.GetSize() - 5, 5) == ".bdat") format = BINARY_COMPRESSED_FORMAT;
+  }
+  
+  FilePtr rtn(new File(world, oid, append, format));
   
   if (!rtn->Good() || rtn->Fail()) {
     if (feedback) feedback->Error("unable to open file '%s' for writing", (const char*)oid);
@@ -88,19 +131,48 @@ Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::S
 
 
 
-Avida::Output::File::File(World* world, const OutputID& name, bool append)
-  : Socket(world, name), m_descr_written(false), m_num_cols(0)
+Avida::Output::File::File(World* world, const OutputID& name, bool append, FileFormat format)
+  : Socket(world, name), m_descr_written(false), m_num_cols(0), m_async_buffer(NULL), m_binary(NULL)
 {
-  m_fp.open(name, (append) ? (std::ios::out | std::ios::app) : std::ios::out);
+  if (format != TEXT_FORMAT) m_binary = new BinaryEncoder(format == BINARY_COMPRESSED_FORMAT);
+  
+  std::ios::openmode mode = (append) ? (std::ios::out | std::ios::app) : std::ios::out;
+  if (m_binary) mode |= std::ios::binary;
+  m_fp.open(name, mode);
   assert(m_fp.good());
+  
+  // When asynchronous, the stream formats into the async buffer and the file's own filebuf is written by the writer thread
+  AsyncWriterPtr writer = Manager::Of(world)->AsyncOutputWriter();
+  if (writer && m_fp.good()) {
+    m_async_buffer = new AsyncFileBuffer(writer, m_fp.rdbuf());
+    static_cast<std::ostream&>(m_fp).rdbuf(m_async_buffer);
+  }
 }
 
-Avida::Output::File::~File() { ; }
+Avida::Output::File::~File()
+{
+  if (m_binary) {
+    m_binary->Flush(m_fp);
+    delete m_binary;
+  }
+  
+  if (m_async_buffer) {
+    // Wait for queued rows to reach the file before the filebuf is closed
+    m_async_buffer->Drain();
+    static_cast<std::ostream&>(m_fp).rdbuf(m_fp.rdbuf());
+    delete m_async_buffer;
+  }
+}
 
 
 
 void Avida::Output::File::Write(double x, const char* descr, const char* format)
 {
+  if (m_binary) {
+    m_binary->Write(x, descr);
+    if (m_descr_written) return;
+  }
+  
   if (!m_descr_written) {
     m_data << x << " ";
     WriteColumnDesc(descr, format);
@@ -112,6 +184,11 @@ void Avida::Output::File::Write(double x, const char* descr, const char* format)
 
 void Avida::Output::File::Write(int i, const char* descr, const char* format)
 {
+  if (m_binary) {
+    m_binary->Write(i, descr);
+    if (m_descr_written) return;
+  }
+  
   if (!m_descr_written) {
     m_data << i << " ";
     WriteColumnDesc(descr, format);
@@ -123,6 +200,11 @@ void Avida::Output::File::Write(int i, const char* descr, const char* format)
 
 void Avida::Output::File::Write(long i, const char* descr, const char* format)
 {
+  if (m_binary) {
+    m_binary->Write(i, descr);
+    if (m_descr_written) return;
+  }
+  
   if (!m_descr_written) {
     m_data << i << " ";
     WriteColumnDesc(descr, format);
@@ -133,6 +215,11 @@ void Avida::Output::File::Write(long i, const char* descr, const char* format)
 
 void Avida::Output::File::Write(unsigned int i, const char* descr, const char*)
 {
+  if (m_binary) {
+    m_binary->Write(i, descr);
+    if (m_descr_written) return;
+  }
+  
   if (!m_descr_written) {
     m_data << i << " ";
     WriteColumnDesc(descr);
@@ -144,6 +231,11 @@ void Avida::Output::File::Write(unsigned int i, const char* descr, const char*)
 
 void Avida::Output::File::Write(const char* data_str, const char* descr, const char* format)
 {
+  if (m_binary) {
+    m_binary->Write(data_str, descr);
+    if (m_descr_written) return;
+  }
+  
   if (!m_descr_written) {
     m_data << data_str << " ";
     WriteColumnDesc(descr, format);
@@ -154,6 +246,11 @@ void Avida::Output::File::Write(const char* data_str, const char* descr, const c
 
 void Avida::Output::File::Write(Apto::Array<int> list, const char* descr, const char* format)
 {
+  if (m_binary) {
+    m_binary->Write(list, descr);
+    if (m_descr_written) return;
+  }
+  
   //Anya is trying to make a commant to write vectors for Kaboom data
   if (!m_descr_written) {
     for (int i=0; i< (int)list.GetSize();i++) {
@@ -170,16 +267,62 @@ void Avida::Output::File::Write(Apto::Array<int> list, const char* descr, const
 
 void Avida::Output::File::WriteBlockElement(double x, int element, int x_size)
 {
+  if (m_binary) demoteToText();
   m_fp << x << " ";
   if (((element + 1) % x_size) == 0) m_fp << "\n";
 }
 
 void Avida::Output::File::WriteBlockElement(int i, int element, int x_size)
 {
+  if (m_binary) demoteToText();
   m_fp << i << " ";
   if (((element + 1) % x_size) == 0) m_fp << "\n";
 }
 
+void Avida::Output::File::WriteBlock(const Apto::Array<double>& values, const char* descr)
+{
+  if (m_binary) {
+    m_binary->Write(values, descr);
+    if (m_descr_written) return;
+  }
+  
+  std::string row;
+  row.reserve(values.GetSize() * 8);
+  for (int i = 0; i < values.GetSize(); i++) {
+    if (i) row.push_back(' ');
+    appendDouble(row, values[i]);
+  }
+  
+  if (!m_descr_written) {
+    m_data << row;
+    WriteColumnDesc(descr);
+  } else {
+    m_fp.write(row.data(), row.size());
+  }
+}
+
+void Avida::Output::File::WriteBlock(const Apto::Array<int>& values, const char* descr)
+{
+  if (m_binary) {
+    m_binary->Write(values, descr);
+    if (m_descr_written) return;
+  }
+  
+  std::string row;
+  row.reserve(values.GetSize() * 4);
+  for (int i = 0; i < values.GetSize(); i++) {
+    if (i) row.push_back(' ');
+    appendInt(row, values[i]);
+  }
+  
+  if (!m_descr_written) {
+    m_data << row;
+    WriteColumnDesc(descr);
+  } else {
+    m_fp.write(row.data(), row.size());
+  }
+}
+
 void Avida::Output::File::WriteColumnDesc(const char* descr, const char* format)
 {
   if (!m_descr_written) {
@@ -203,6 +346,7 @@ void Avida::Output::File::WriteRawComment(const char* comment)
 
 void Avida::Output::File::WriteRaw(const char* str)
 {
+  if (m_binary) demoteToText();
   m_fp << str << "\n";
 }
 
@@ -219,6 +363,7 @@ void Avida::Output::File::WriteTimeStamp()
 
 void Avida::Output::File::FlushComments()
 {
+  if (m_binary) demoteToText();
   if (!m_descr_written) {
     m_fp << m_descr;
     m_descr = "";
@@ -231,6 +376,19 @@ void Avida::Output::File::FlushComments()
 
 void Avida::Output::File::Endl()
 {
+  if (m_binary) {
+    if (!m_descr_written) {
+      // The first row fixes the schema; the text form collected alongside it is no longer needed
+      m_binary->WriteHeader(m_fp, m_filetype, m_format, m_descr);
+      m_descr = "";
+      m_data.clear();
+      m_data.str("");
+      m_descr_written = true;
+    }
+    m_binary->EndRow(m_fp);
+    return;
+  }
+  
   if (!m_descr_written) {
     // Handle filetype and format first
     if (m_filetype != "") m_fp << "#filetype " << m_filetype << std::endl;
@@ -254,5 +412,17 @@ void Avida::Output::File::Endl()
 
 void Avida::Output::File::Flush()
 {
+  if (m_binary) m_binary->Flush(m_fp);
   m_fp.flush();
 }
+
+
+void Avida::Output::File::demoteToText()
+{
+  // Once the binary header is out the file cannot change format; mixing raw and columnar writes is unsupported
+  assert(!m_descr_written);
+  if (m_descr_written) return;
+  
+  delete m_binary;
+  m_binary = NULL;
+}
@@ -26,7 +26,9 @@
 
 #include "avida/output/Socket.h"
 
-Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
+#include "avida/private/output/AsyncWriter.h"
+
+Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL), m_default_format(TEXT_FORMAT)
 {
   m_output_path = output_path;
   m_output_path.Trim();
@@ -40,7 +42,11 @@ Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
   }
 }
 
-Avida::Output::Manager::~Manager() { ; }
+Avida::Output::Manager::~Manager()
+{
+  // Write out everything still queued before the manager goes away
+  if (m_async_writer) m_async_writer->Stop();
+}
 
 
 Avida::Output::OutputID Avida::Output::Manager::OutputIDFromPath(Apto::String path) const
@@ -112,6 +118,29 @@ void Avida::Output::Manager::FlushAll()
     (*it.Get())->Flush();
   }
   m_mutex.Unlock();
+  
+  if (m_async_writer) m_async_writer->WaitIdle();
+}
+
+
+bool Avida::Output::Manager::EnableAsyncWriter(int max_bytes)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  
+  if (m_async_writer || max_bytes <= 0) return false;
+  
+  m_async_writer = AsyncWriterPtr(new AsyncWriter(max_bytes));
+  return true;
+}
+
+
+void Avida::Output::Manager::AbandonAsyncWriter()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  
+  // The thread to stop and join does not exist here, so the writer is deliberately leaked instead of destroyed
+  if (m_async_writer) m_async_writer->AddReference();
+  m_async_writer = AsyncWriterPtr(NULL);
 }
 
 
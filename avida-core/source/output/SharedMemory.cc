@@ -0,0 +1,147 @@
+/*
+ *  output/SharedMemory.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/output/SharedMemory.h"
+
+#include "avida/core/Feedback.h"
+#include "avida/output/Manager.h"
+
+#include <cstring>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+
+struct Avida::Output::SharedMemory::Header
+{
+  char magic[8];
+  unsigned int version;
+  unsigned int num_slots;
+  volatile unsigned int sequence;
+  volatile int update;
+};
+
+struct Avida::Output::SharedMemory::Slot
+{
+  char name[SLOT_NAME_SIZE];
+  volatile double value;
+};
+
+
+Avida::Output::SharedMemoryPtr Avida::Output::SharedMemory::CreateWithPath(World* world, Apto::String path,
+                                                                         const Apto::Array<Apto::String>& slot_names,
+                                                                         Feedback* feedback)
+{
+  Output::ManagerPtr mgr = Output::Manager::Of(world);
+  OutputID oid = mgr->OutputIDFromPath(path);
+
+  if (oid.GetSize() == 0) {
+    if (feedback) feedback->Error("unable to translate path '%s' to output id", (const char*)path);
+    return SharedMemoryPtr(NULL);
+  }
+
+  if (mgr->IsOpen(oid)) {
+    if (feedback) feedback->Error("file '%s' already open", (const char*)oid);
+    return SharedMemoryPtr(NULL);
+  }
+
+  SharedMemoryPtr rtn(new SharedMemory(world, oid, slot_names));
+
+  if (rtn->Fail()) {
+    if (feedback) feedback->Error("unable to map shared memory file '%s'", (const char*)oid);
+    return SharedMemoryPtr(NULL);
+  }
+
+  return rtn;
+}
+
+
+Avida::Output::SharedMemory::SharedMemory(World* world, const OutputID& output_id,
+                                          const Apto::Array<Apto::String>& slot_names)
+  : Socket(world, output_id), m_header(NULL), m_slots(NULL), m_size(0), m_num_slots(slot_names.GetSize())
+{
+#if !APTO_PLATFORM(WINDOWS)
+  m_size = sizeof(Header) + m_num_slots * sizeof(Slot);
+
+  int fd = open((const char*)output_id, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return;
+
+  void* region = MAP_FAILED;
+  if (ftruncate(fd, m_size) == 0) region = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) return;
+
+  m_header = static_cast<Header*>(region);
+  m_slots = reinterpret_cast<Slot*>(static_cast<char*>(region) + sizeof(Header));
+
+  for (int i = 0; i < m_num_slots; i++) {
+    strncpy(m_slots[i].name, (const char*)slot_names[i], SLOT_NAME_SIZE - 1);
+    m_slots[i].name[SLOT_NAME_SIZE - 1] = '\0';
+    m_slots[i].value = 0.0;
+  }
+  m_header->version = 1;
+  m_header->num_slots = m_num_slots;
+  m_header->sequence = 0;
+  m_header->update = -1;
+
+  // The magic is written last, so a monitor that sees it also sees a complete header
+  __sync_synchronize();
+  memcpy(m_header->magic, "AVIDASHM", 8);
+#endif
+}
+
+
+Avida::Output::SharedMemory::~SharedMemory()
+{
+#if !APTO_PLATFORM(WINDOWS)
+  if (m_header) munmap(m_header, m_size);
+#endif
+}
+
+
+void Avida::Output::SharedMemory::Publish(Update update, const Apto::Array<double>& values)
+{
+  if (!m_header) return;
+
+#if !APTO_PLATFORM(WINDOWS)
+  m_header->sequence = m_header->sequence + 1;
+  __sync_synchronize();
+
+  m_header->update = update;
+  const int num_values = (values.GetSize() < m_num_slots) ? values.GetSize() : m_num_slots;
+  for (int i = 0; i < num_values; i++) m_slots[i].value = values[i];
+
+  __sync_synchronize();
+  m_header->sequence = m_header->sequence + 1;
+#endif
+}
+
+
+void Avida::Output::SharedMemory::Flush()
+{
+  // Monitors map the same pages, this only schedules write back for anyone reading the file itself
+#if !APTO_PLATFORM(WINDOWS)
+  if (m_header) msync(m_header, m_size, MS_ASYNC);
+#endif
+}
@@ -30,7 +30,9 @@
 
 #include "avida/core/InstructionSequence.h"
 
+#include "cAnalyze.h"
 #include "cAnalyzeGenotype.h"
+#include "cCPUTestInfo.h"
 #include "cGenomeUtil.h"
 #include "cGenotypeBatch.h"
 #include "cHardwareManager.h"
@@ -152,6 +154,13 @@ namespace ASAnalyzeLib {
   }
   
   
+  // Genotypes are run through the test CPUs on the analyze job queue when PARALLEL_ANALYZE is set
+  void RecalculateBatch(cWorld* world, cGenotypeBatch* batch)
+  {
+    world->GetAnalyze().RecalculateBatch(*batch, cCPUTestInfo());
+  }
+  
+  
   cResourceHistory* LoadResourceHistory(const cString& filename)
   {
 //    conduit.NotifyComment(cString("Loading: ") + filename);
@@ -178,6 +187,7 @@ void RegisterASAnalyzeLib(cASLibrary* lib)
   BIND_FUNCTION(cWorld, "LoadSequenceWithInstSet", LoadSequenceWithInstSet, cAnalyzeGenotype* (const cString&, cInstSet*));
   BIND_FUNCTION(cWorld, "LoadBatch", LoadBatch, cGenotypeBatch* (const cString&));
   BIND_FUNCTION(cWorld, "LoadBatchWithInstSet", LoadBatchWithInstSet, cGenotypeBatch* (const cString&, cInstSet*));
+  BIND_FUNCTION(cWorld, "RecalculateBatch", RecalculateBatch, void (cGenotypeBatch*));
 
   REGISTER_FUNCTION(LoadResourceHistory, cResourceHistory* (const cString&));
 
@@ -57,6 +57,19 @@ void cASTVariableReference::Accept(cASTVisitor& visitor) { visitor.VisitVariable
 void cASTUnpackTarget::Accept(cASTVisitor& visitor) { visitor.VisitUnpackTarget(*this); }
 
 
+cASTLiteral::cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v)
+  : cASTNode(fp), m_type(t), m_value(v), m_as_float(0.0)
+{
+  switch (m_type.type) {
+    case AS_TYPE_BOOL:  m_as_bool = (m_value == "true"); break;
+    case AS_TYPE_CHAR:  m_as_char = m_value[0]; break;
+    case AS_TYPE_INT:   m_as_int = m_value.AsInt(); break;
+    case AS_TYPE_FLOAT: m_as_float = m_value.AsDouble(); break;
+    default: break;
+  }
+}
+
+
 cASTStatementList::~cASTStatementList()
 {
   cASTNode* node = NULL;
@@ -526,12 +526,25 @@ private:
   sASTypeInfo m_type;
   cString m_value;
   
+  // Scalar value decoded from m_value once, when the literal is created
+  union {
+    bool m_as_bool;
+    char m_as_char;
+    int m_as_int;
+    double m_as_float;
+  };
+  
 public:
-  cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v) : cASTNode(fp), m_type(t), m_value(v) { ; }
+  cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v);
   
   const sASTypeInfo& GetType() const { return m_type; }
   inline const cString& GetValue() { return m_value; }
   
+  inline bool GetBool() const { return m_as_bool; }
+  inline char GetChar() const { return m_as_char; }
+  inline int GetInt() const { return m_as_int; }
+  inline double GetFloat() const { return m_as_float; }
+  
   void Accept(cASTVisitor& visitor);
 };
 
@@ -1155,7 +1155,8 @@ void cDirectInterpretASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
     const cASFunction* func = node.GetASFunction();
     
     // Setup arguments
-    cASCPPParameter* args = new cASCPPParameter[func->GetArity()];
+    cASCPPParameter arg_buf[ARG_BUFFER_SIZE];
+    cASCPPParameter* args = (func->GetArity() <= ARG_BUFFER_SIZE) ? arg_buf : new cASCPPParameter[func->GetArity()];
     if (func->GetArity()) {
       tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
       cASTNode* an = NULL;
@@ -1210,7 +1211,7 @@ void cDirectInterpretASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
           INTERPRET_ERROR(INTERNAL);
       }
     }
-    delete [] args;
+    if (args != arg_buf) delete [] args;
     
   } else {
     // Save previous scope information
@@ -1330,20 +1331,19 @@ void cDirectInterpretASTVisitor::VisitLiteral(cASTLiteral& node)
 {
   switch (node.GetType().type) {
     case TYPE(BOOL):
-      if (node.GetValue() == "true") m_rvalue.as_bool = true;
-      else m_rvalue.as_bool = false;
+      m_rvalue.as_bool = node.GetBool();
       m_rtype = TYPE(BOOL);
       break;
     case TYPE(CHAR):
-      m_rvalue.as_char = node.GetValue()[0];
+      m_rvalue.as_char = node.GetChar();
       m_rtype = TYPE(CHAR);
       break;
-      case TYPE(INT):
-      m_rvalue.as_int = node.GetValue().AsInt();
+    case TYPE(INT):
+      m_rvalue.as_int = node.GetInt();
       m_rtype = TYPE(INT);
       break;
     case TYPE(FLOAT):
-      m_rvalue.as_float = node.GetValue().AsDouble();
+      m_rvalue.as_float = node.GetFloat();
       m_rtype = TYPE(FLOAT);
       break;
     case TYPE(STRING):
@@ -1444,7 +1444,8 @@ void cDirectInterpretASTVisitor::VisitObjectCall(cASTObjectCall& node)
     
   int arity = nobj->GetArity(mid);
   // Setup arguments
-  cASCPPParameter* args = new cASCPPParameter[arity];
+  cASCPPParameter arg_buf[ARG_BUFFER_SIZE];
+  cASCPPParameter* args = (arity <= ARG_BUFFER_SIZE) ? arg_buf : new cASCPPParameter[arity];
   if (arity) {
     tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
     cASTNode* an = NULL;
@@ -1458,6 +1459,8 @@ void cDirectInterpretASTVisitor::VisitObjectCall(cASTObjectCall& node)
         case TYPE(FLOAT):       args[i].Set(asFloat(m_rtype, m_rvalue, node)); break;
         case TYPE(INT):         args[i].Set(asInt(m_rtype, m_rvalue, node)); break;
         case TYPE(STRING):      args[i].Set(asString(m_rtype, m_rvalue, node)); break;
+        case TYPE(OBJECT_REF):
+          args[i].Set(asNativeObject(nobj->GetArgumentType(mid, i).info, m_rtype, m_rvalue, node)); break;
           
         default:
           INTERPRET_ERROR(INTERNAL);
@@ -1491,12 +1494,14 @@ void cDirectInterpretASTVisitor::VisitObjectCall(cASTObjectCall& node)
       case TYPE(FLOAT):   break;
       case TYPE(INT):     break;
       case TYPE(STRING):  delete args[i].Get<cString*>(); break;
+      case TYPE(OBJECT_REF):
+        args[i].Get<cASNativeObject*>()->RemoveReference(); break;
         
       default:
         INTERPRET_ERROR(INTERNAL);
     }
   }
-  delete [] args;
+  if (args != arg_buf) delete [] args;
   
 }
 
@@ -65,6 +65,10 @@ private:
   template<typename HASH_TYPE> friend inline int nHashTable::HashKey(const HASH_TYPE& key, int table_size);
     
 
+  // Native calls with up to this many arguments pass them in a buffer on the C++ stack
+  enum { ARG_BUFFER_SIZE = 8 };
+  
+  
   // --------  Internal Variables  --------
   cSymbolTable* m_global_symtbl;
   cSymbolTable* m_cur_symtbl;
@@ -31,6 +31,13 @@
 
 Avida::Systematics::Arbiter::~Arbiter() { ; }
 
+void Avida::Systematics::Arbiter::ClassifyNewUnits(const Apto::Array<UnitPtr>& units, const ClassificationHints* hints,
+                                                   Apto::Array<GroupPtr>& groups)
+{
+  groups.Resize(units.GetSize());
+  for (int i = 0; i < units.GetSize(); i++) groups[i] = ClassifyNewUnit(units[i], hints);
+}
+
 void Avida::Systematics::Arbiter::notifyListeners(GroupPtr g, EventType t, UnitPtr u)
 {
   for (Apto::Set<Listener*>::Iterator it = m_listeners.Begin(); (it.Next()); ) (*it.Get())->Notify(g, t, u);
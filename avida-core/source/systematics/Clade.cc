@@ -120,6 +120,18 @@ const Avida::PropertyMap& Avida::Systematics::Clade::Properties() const
   return *m_prop_map;
 }
 
+int Avida::Systematics::Clade::IntProperty(GroupProperty prop) const
+{
+  if (prop == GROUP_PROP_TOTAL_ORGANISMS) return m_total_organisms;
+  return Group::IntProperty(prop);
+}
+
+Apto::String Avida::Systematics::Clade::StringProperty(GroupProperty prop) const
+{
+  if (prop == GROUP_PROP_NAME) return m_name;
+  return Group::StringProperty(prop);
+}
+
 int Avida::Systematics::Clade::Depth() const
 {
   return 0;
@@ -24,6 +24,7 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 
 #include "avida/core/Genome.h"
+#include "avida/private/systematics/GenomeTestQueue.h"
 
 #include "cAvidaContext.h"
 #include "cHardwareManager.h"
@@ -37,27 +38,36 @@ const Apto::String Avida::Systematics::GenomeTestMetrics::ObjectKey("Avida::Syst
 
 Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr g)
 {
-  Apto::SmartPtr<cTestCPU> testcpu(world->GetHardwareManager().CreateTestCPU(ctx));
-  
-  cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()));
-  
-  m_is_viable = test_info.IsViable();
-  
-  cPhenotype& phenotype = test_info.GetTestPhenotype();
-  m_fitness = test_info.GetGenotypeFitness();
-  m_colony_fitness = test_info.GetColonyFitness();
-  m_merit = phenotype.GetMerit().GetDouble();
-  m_executed_size = phenotype.GetExecutedSize();
-  m_copied_size = phenotype.GetCopiedSize();
-  m_gestation_time = phenotype.GetGestationTime();
-  m_task_counts = phenotype.GetLastTaskCount();
+  evaluate(world, ctx, Genome(g->StringProperty(GROUP_PROP_GENOME)));
+}
+
+Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, const Genome& genome)
+{
+  evaluate(world, ctx, genome);
 }
 
 
 Avida::Systematics::GenomeTestMetrics::~GenomeTestMetrics() { ; }
 
 
+void Avida::Systematics::GenomeTestMetrics::evaluate(cWorld* world, cAvidaContext& ctx, const Genome& genome)
+{
+  Apto::SmartPtr<cTestCPU> testcpu(world->GetHardwareManager().CreateTestCPU(ctx));
+  
+  cTestCPUCache::sTestResult result;
+  testcpu->TestGenomeCached(ctx, genome, result);
+  
+  m_is_viable = result.is_viable;
+  m_fitness = result.fitness;
+  m_colony_fitness = result.colony_fitness;
+  m_merit = result.merit;
+  m_executed_size = result.executed_size;
+  m_copied_size = result.copied_size;
+  m_gestation_time = result.gestation_time;
+  m_task_counts = result.task_counts;
+}
+
+
 bool Avida::Systematics::GenomeTestMetrics::Serialize(ArchivePtr) const
 {
   // @TODO
@@ -66,9 +76,13 @@ bool Avida::Systematics::GenomeTestMetrics::Serialize(ArchivePtr) const
 
 
 Avida::Systematics::GenomeTestMetricsPtr Avida::Systematics::GenomeTestMetrics::GetMetrics(cWorld* world, cAvidaContext& ctx,
-                                                                                           GroupPtr g)
+                                                                                           GroupPtr g, bool wait)
 {
   GenomeTestMetricsPtr metrics = g->GetData<GenomeTestMetrics>();
+  
+  GenomeTestQueue* queue = world->GetGenomeTestQueue();
+  if (!metrics && queue && queue->IsPending(g)) return queue->Collect(g, wait);
+  
   if (!metrics && g->Properties().Has("genome")) {
     metrics = GenomeTestMetricsPtr(new GenomeTestMetrics(world, ctx, g));
     assert(metrics);
@@ -77,3 +91,9 @@ Avida::Systematics::GenomeTestMetricsPtr Avida::Systematics::GenomeTestMetrics::
 
   return metrics;
 }
+
+bool Avida::Systematics::GenomeTestMetrics::IsPending(cWorld* world, GroupPtr g)
+{
+  GenomeTestQueue* queue = world->GetGenomeTestQueue();
+  return (queue && queue->IsPending(g));
+}
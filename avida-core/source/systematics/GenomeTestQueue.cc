@@ -0,0 +1,126 @@
+/*
+ *  systematics/GenomeTestQueue.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/systematics/GenomeTestQueue.h"
+
+#include "avida/core/Genome.h"
+#include "avida/private/systematics/GenotypeArbiter.h"
+
+#include "cAnalyzeJob.h"
+#include "cAnalyzeJobQueue.h"
+
+
+class Avida::Systematics::GenomeTestQueue::TestJob : public cAnalyzeJob
+{
+private:
+  GenomeTestQueue* m_owner;
+  PendingTest* m_test;
+  Genome m_genome;
+  
+public:
+  TestJob(GenomeTestQueue* owner, PendingTest* test, const Genome& genome)
+    : m_owner(owner), m_test(test), m_genome(genome) { ; }
+  
+  void Run(cAvidaContext& ctx)
+  {
+    GenomeTestMetricsPtr metrics(new GenomeTestMetrics(m_owner->m_world, ctx, m_genome));
+    
+    m_owner->m_mutex.Lock();
+    m_test->metrics = metrics;
+    m_test->done = true;
+    m_owner->m_mutex.Unlock();
+    m_owner->m_cond.Broadcast();
+  }
+};
+
+
+Avida::Systematics::GenomeTestQueue::GenomeTestQueue(cWorld* world, ArbiterPtr arbiter)
+  : m_world(world), m_arbiter(arbiter), m_queue(NULL)
+{
+  m_arbiter->AttachListener(this);
+}
+
+Avida::Systematics::GenomeTestQueue::~GenomeTestQueue()
+{
+  m_arbiter->DetachListener(this);
+  
+  // Stop the workers before releasing the tests they may still be writing to
+  delete m_queue;
+  
+  for (Apto::Map<GroupID, PendingTest*>::ValueIterator it = m_pending.Values(); it.Next();) delete *it.Get();
+}
+
+
+void Avida::Systematics::GenomeTestQueue::Notify(GroupPtr g, EventType t, UnitPtr)
+{
+  if (t != GenotypeArbiter::EVENT_ADD_THRESHOLD) return;
+  
+  attachCompleted();
+  
+  if (m_pending.Has(g->ID()) || g->GetData<GenomeTestMetrics>()) return;
+  
+  PendingTest* test = new PendingTest;
+  test->group = g;
+  test->done = false;
+  m_pending.Set(g->ID(), test);
+  
+  // Workers are started on first use, once the world driver their contexts refer to is in place
+  if (!m_queue) m_queue = new cAnalyzeJobQueue(m_world);
+  m_queue->AddJobImmediate(new TestJob(this, test, Genome(g->StringProperty(GROUP_PROP_GENOME))));
+}
+
+
+Avida::Systematics::GenomeTestMetricsPtr Avida::Systematics::GenomeTestQueue::Collect(GroupPtr g, bool wait)
+{
+  PendingTest* test = NULL;
+  if (!m_pending.Get(g->ID(), test)) return GenomeTestMetricsPtr(NULL);
+  
+  m_mutex.Lock();
+  if (wait) while (!test->done) m_cond.Wait(m_mutex);
+  const bool done = test->done;
+  m_mutex.Unlock();
+  if (!done) return GenomeTestMetricsPtr(NULL);
+  
+  GenomeTestMetricsPtr metrics = test->metrics;
+  g->AttachData(metrics);
+  m_pending.Remove(g->ID());
+  delete test;
+  
+  return metrics;
+}
+
+
+void Avida::Systematics::GenomeTestQueue::attachCompleted()
+{
+  Apto::Array<GroupID> completed;
+  
+  m_mutex.Lock();
+  for (Apto::Map<GroupID, PendingTest*>::KeyIterator it = m_pending.Keys(); it.Next();) {
+    if (m_pending.Get(*it.Get())->done) completed.Push(*it.Get());
+  }
+  m_mutex.Unlock();
+  
+  for (int i = 0; i < completed.GetSize(); i++) {
+    PendingTest* test = m_pending.Get(completed[i]);
+    test->group->AttachData(test->metrics);
+    m_pending.Remove(completed[i]);
+    delete test;
+  }
+}
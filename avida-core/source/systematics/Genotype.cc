@@ -28,6 +28,7 @@
 #include "avida/output/File.h"
 
 #include "avida/private/systematics/GenotypeArbiter.h"
+#include "avida/private/util/MemoryStats.h"
 
 #include "cHardwareManager.h"
 #include "cStringList.h"
@@ -125,12 +126,14 @@ void Avida::Systematics::Genotype::Initialize()
 
 
 Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, UnitPtr founder, Update update,
-                             ConstGroupMembershipPtr parents)
+                             ConstGroupMembershipPtr parents, bool link_parents)
   : Group(in_id)
   , m_mgr(mgr)
   , m_handle(NULL)
+  , m_threshold_handle(NULL)
   , m_src(founder->UnitSource())
   , m_genome(founder->UnitGenome())
+  , m_hash(0)
   , m_name("001-no_name")
   , m_threshold(false)
   , m_active(true)
@@ -148,8 +151,13 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, Un
   , m_task_counts(mgr->NumEnvironmentActionTriggers())
   , m_prop_map(NULL)
 {
+  Util::MemoryStats::Created(Util::MemoryStats::GENOTYPES);
   AddActiveReference();
   if (parents) {
+    m_parent_ids.Resize(parents->GetSize());
+    for (int i = 0; i < m_parent_ids.GetSize(); i++) m_parent_ids[i] = (*parents)[i]->ID();
+  }
+  if (parents && link_parents) {
     m_parents.Resize(parents->GetSize());
     for (int i = 0; i < m_parents.GetSize(); i++) {
       GenotypePtr p;
@@ -187,6 +195,8 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, vo
 : Group(in_id)
 , m_mgr(mgr)
 , m_handle(NULL)
+, m_threshold_handle(NULL)
+, m_hash(0)
 , m_name("001-no_name")
 , m_threshold(false)
 , m_active(false)
@@ -203,6 +213,7 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, vo
 , m_task_counts(mgr->NumEnvironmentActionTriggers())
 , m_prop_map(NULL)
 {
+  Util::MemoryStats::Created(Util::MemoryStats::GENOTYPES);
   Apto::Map<Apto::String, Apto::String>& props = *(*static_cast<Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> >*>(prop_p));
   
   m_src.transmission_type = DIVISION;
@@ -252,7 +263,8 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, vo
 
 
 Avida::Systematics::Genotype::~Genotype()
-{  
+{
+  Util::MemoryStats::Destroyed(Util::MemoryStats::GENOTYPES);
   delete m_prop_map;
 }
 
@@ -325,6 +337,49 @@ const Avida::PropertyMap& Avida::Systematics::Genotype::Properties() const
   return *m_prop_map;
 }
 
+int Avida::Systematics::Genotype::IntProperty(GroupProperty prop) const
+{
+  switch (prop) {
+    case GROUP_PROP_THRESHOLD:              return m_threshold;
+    case GROUP_PROP_UPDATE_BORN:            return m_update_born;
+    case GROUP_PROP_SRC_TRANSMISSION_TYPE:  return m_src.transmission_type;
+    case GROUP_PROP_TOTAL_ORGANISMS:        return m_total_organisms;
+    case GROUP_PROP_LAST_BIRTHS:            return m_births.GetLast();
+    case GROUP_PROP_LAST_DEATHS:            return m_deaths.GetLast();
+    case GROUP_PROP_LAST_BREED_TRUE:        return m_breed_true.GetLast();
+    case GROUP_PROP_LAST_BREED_IN:          return m_breed_in.GetLast();
+    case GROUP_PROP_LAST_BREED_OUT:         return m_breed_out.GetLast();
+    case GROUP_PROP_LAST_BIRTH_CELL:        return m_last_birth_cell;
+    case GROUP_PROP_LAST_GROUP_ID:          return m_last_group_id;
+    case GROUP_PROP_LAST_FORAGER_TYPE:      return m_last_forager_type;
+    default:                                return Group::IntProperty(prop);
+  }
+}
+
+double Avida::Systematics::Genotype::DoubleProperty(GroupProperty prop) const
+{
+  switch (prop) {
+    case GROUP_PROP_AVE_COPY_SIZE:          return m_copied_size.Average();
+    case GROUP_PROP_AVE_EXE_SIZE:           return m_exe_size.Average();
+    case GROUP_PROP_AVE_GESTATION_TIME:     return m_gestation_time.Average();
+    case GROUP_PROP_AVE_REPRO_RATE:         return m_repro_rate.Average();
+    case GROUP_PROP_AVE_METABOLIC_RATE:     return m_merit.Average();
+    case GROUP_PROP_AVE_FITNESS:            return m_fitness.Average();
+    case GROUP_PROP_MAX_FITNESS:            return m_fitness.Max();
+    default:                                return Group::DoubleProperty(prop);
+  }
+}
+
+Apto::String Avida::Systematics::Genotype::StringProperty(GroupProperty prop) const
+{
+  switch (prop) {
+    case GROUP_PROP_NAME:                   return m_name;
+    case GROUP_PROP_GENOME:                 return m_genome.AsString();
+    case GROUP_PROP_PARENTS:                return m_parent_str;
+    default:                                return Group::StringProperty(prop);
+  }
+}
+
 int Avida::Systematics::Genotype::Depth() const
 {
   return m_depth;
@@ -335,10 +390,35 @@ int Avida::Systematics::Genotype::NumUnits() const
   return m_num_organisms;
 }
 
-bool Avida::Systematics::Genotype::Serialize(ArchivePtr) const
+bool Avida::Systematics::Genotype::Serialize(ArchivePtr ar) const
 {
-  // @TODO - serialize genotype
-  return false;
+  ar->SetObjectType("systematics.genotype");
+  ar->SetVersion(1);
+  
+  // Property names match LegacySave, so an archived genotype loads through the same constructor
+  ar->AttachProperty(StringProperty("id", s_prop_desc_map, m_id));
+  ar->AttachProperty(StringProperty("name", s_prop_desc_map, m_name));
+  ar->AttachProperty(StringProperty("src", s_prop_desc_map, m_src.AsString()));
+  ar->AttachProperty(StringProperty("src_args", s_prop_desc_map, (m_src.arguments.GetSize()) ? m_src.arguments : Apto::String("(none)")));
+  
+  Apto::String parents;
+  for (int i = 0; i < m_parents.GetSize(); i++) {
+    if (i) parents += ",";
+    parents += Apto::AsStr(m_parents[i]->ID());
+  }
+  ar->AttachProperty(StringProperty("parents", s_prop_desc_map, (parents.GetSize()) ? parents : Apto::String("(none)")));
+  
+  ar->AttachProperty(StringProperty("num_units", s_prop_desc_map, m_num_organisms));
+  ar->AttachProperty(StringProperty("total_units", s_prop_desc_map, m_total_organisms));
+  ar->AttachProperty(StringProperty("merit", s_prop_desc_map, m_merit.Average()));
+  ar->AttachProperty(StringProperty("gest_time", s_prop_desc_map, m_gestation_time.Average()));
+  ar->AttachProperty(StringProperty("fitness", s_prop_desc_map, m_fitness.Average()));
+  ar->AttachProperty(StringProperty("gen_born", s_prop_desc_map, m_generation_born));
+  ar->AttachProperty(StringProperty("update_born", s_prop_desc_map, m_update_born));
+  ar->AttachProperty(StringProperty("update_deactivated", s_prop_desc_map, m_update_deactivated));
+  ar->AttachProperty(StringProperty("depth", s_prop_desc_map, m_depth));
+  
+  return m_genome.Serialize(ar->DefineSubObject("genome"));
 }
 
 bool Avida::Systematics::Genotype::LegacySave(void* dfp) const
@@ -389,6 +469,16 @@ void Avida::Systematics::Genotype::RemoveActiveReference() const
   if (!m_a_refs) m_mgr->AdjustGenotype(nc_this->thisPtr(), m_num_organisms, 0);
 }
 
+void Avida::Systematics::Genotype::RemovePassiveReference() const
+{
+  m_p_refs--;
+  assert(m_p_refs >= 0);
+  
+  // Unreferenced historic genotypes are pruned by the arbiter at the end of the update
+  Genotype* nc_this = const_cast<Genotype*>(this);
+  if (!m_p_refs && !m_a_refs && !m_active) m_mgr->ScheduleRemoval(nc_this->thisPtr());
+}
+
 
 
 bool Avida::Systematics::Genotype::Matches(UnitPtr u)
@@ -465,6 +555,31 @@ void Avida::Systematics::Genotype::NotifyNewUnit(UnitPtr u)
   AddActiveReference();
 }
 
+void Avida::Systematics::Genotype::NotifyNewUnits(const Apto::Array<UnitPtr>& units, int begin, int end)
+{
+  m_active = true;
+  for (int i = begin; i < end; i++) {
+    if (units[i]->UnitSource().external) continue;
+    switch (units[i]->UnitSource().transmission_type) {
+      case DIVISION:
+      case HORIZONTAL:
+      case VERTICAL:
+        m_breed_in.Inc();
+        break;
+        
+      default:
+        break;
+    }
+  }
+  
+  const int count = end - begin;
+  m_total_organisms += count;
+  m_num_organisms += count;
+  
+  m_mgr->AdjustGenotype(thisPtr(), m_num_organisms - count, m_num_organisms);
+  m_a_refs += count;
+}
+
 
 void Avida::Systematics::Genotype::UpdateReset()
 {
@@ -40,6 +40,9 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   : Arbiter(role)
   , m_threshold(threshold)
   , m_disable_class(disable_class)
+  , m_active_index(INITIAL_INDEX_SIZE)
+  , m_active_index_count(0)
+  , m_active_index_filled(0)
   , m_active_sz(1)
   , m_coalescent(NULL)
   , m_best(0)
@@ -50,14 +53,14 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   , m_tot_genotypes(0)
   , m_coalescent_depth(-1)
 {
-  Avida::Environment::ManagerPtr env = Avida::Environment::Manager::Of(world);
-  Avida::Environment::ConstActionTriggerIDSetPtr trigger_ids = env->GetActionTriggerIDs();
-  m_env_action_average.Resize(trigger_ids->GetSize());
-  m_env_action_count.Resize(trigger_ids->GetSize());
-  int idx = 0;
-  for (Avida::Environment::ConstActionTriggerIDSetIterator it = trigger_ids->Begin(); it.Next(); idx++) {
-    m_env_action_average[idx] = Apto::FormatStr("environment.triggers.%s.average", (const char*)*it.Get());
-    m_env_action_count[idx] = Apto::FormatStr("environment.triggers.%s.count", (const char*)*it.Get());
+  // Trigger properties are numbered as in the environment's reaction graph
+  Avida::Environment::ConstReactionGraphPtr graph = Avida::Environment::Manager::Of(world)->GetReactionGraph();
+  m_env_action_average.Resize(graph->NumActionTriggers());
+  m_env_action_count.Resize(graph->NumActionTriggers());
+  for (int idx = 0; idx < graph->NumActionTriggers(); idx++) {
+    const char* trigger_id = graph->GetActionTrigger(idx).GetID();
+    m_env_action_average[idx] = Apto::FormatStr("environment.triggers.%s.average", trigger_id);
+    m_env_action_count[idx] = Apto::FormatStr("environment.triggers.%s.count", trigger_id);
   }
   setupProvidedData(world);
 }
@@ -81,25 +84,42 @@ Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::ClassifyNewUni
   return ClassifyNewUnit(u, ConstGroupMembershipPtr(NULL), hints);
 }
 
+void Avida::Systematics::GenotypeArbiter::ClassifyNewUnits(const Apto::Array<UnitPtr>& units,
+                                                           const ClassificationHints* hints, Apto::Array<GroupPtr>& groups)
+{
+  groups.Resize(units.GetSize());
+  
+  int i = 0;
+  while (i < units.GetSize()) {
+    GenotypePtr found = ClassifyNewUnit(units[i], ConstGroupMembershipPtr(NULL), hints);
+    groups[i] = found;
+    
+    // Units following with the same genome (the founders of a seeded deme) join in a single size adjustment, without
+    // hashing their genomes or resolving the hints again
+    int end = i + 1;
+    while (end < units.GetSize() && found->Matches(units[end])) end++;
+    if (end > i + 1) {
+      found->NotifyNewUnits(units, i + 1, end);
+      for (int j = i + 1; j < end; j++) groups[j] = found;
+    }
+    i = end;
+  }
+}
+
 
 void Avida::Systematics::GenotypeArbiter::PerformUpdate(Context&, Update current_update)
 {
   m_cur_update = current_update + 1; // +1 since PerformUpdate happens at end of updates, but m_cur_update is used during
   
-  if (m_active_sz.GetSize() < HASH_SIZE) {
-    for (int i = 0; i < m_active_sz.GetSize(); i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-      while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
-    }
-  } else {
-    for (int i = 0; i < HASH_SIZE; i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[i].Begin());
-      while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
-    }    
-  }
+  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_threshold_list.Begin());
+  while (list_it.Next() != NULL) (*list_it.Get())->UpdateReset();
 
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if (!(*list_it.Get())->ReferenceCount()) removeGenotype(*list_it.Get());
+  // Historic genotypes whose last reference went away during the update; entries may meanwhile have been removed
+  // (m_handle cleared), reactivated, or referenced again
+  while (m_pending_removal.GetSize()) {
+    GenotypePtr genotype = m_pending_removal.Pop();
+    if (genotype->m_handle && !genotype->IsActive() && !genotype->ReferenceCount()) removeGenotype(genotype);
+  }
 }
 
 void Avida::Systematics::GenotypeArbiter::PrintListStatus()
@@ -113,11 +133,24 @@ void Avida::Systematics::GenotypeArbiter::PrintListStatus()
 
 }
 
-bool Avida::Systematics::GenotypeArbiter::Serialize(ArchivePtr) const
+bool Avida::Systematics::GenotypeArbiter::Serialize(ArchivePtr ar) const
 {
-  // @TOOD - serialize genotype arbiter
-  assert(false);
-  return false;
+  ar->SetObjectType("systematics.genotype_arbiter");
+  ar->SetVersion(1);
+  
+  // Every tracked genotype in ascending ID order, so parents always precede their offspring
+  Apto::Array<GroupID> ids;
+  for (Apto::Map<GroupID, GenotypePtr>::KeyIterator it = m_id_index.Keys(); it.Next();) ids.Push(*it.Get());
+  Apto::QSort(ids);
+  
+  bool success = true;
+  for (int i = 0; i < ids.GetSize(); i++) {
+    GenotypePtr genotype;
+    m_id_index.Get(ids[i], genotype);
+    if (!genotype->Serialize(ar->DefineSubObject(Apto::AsStr(ids[i])))) success = false;
+  }
+  
+  return success;
 }
 
 bool Avida::Systematics::GenotypeArbiter::LegacySave(void* dfp) const
@@ -133,7 +166,12 @@ bool Avida::Systematics::GenotypeArbiter::LegacySave(void* dfp) const
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(void* props)
 {
   GenotypePtr g(new Genotype(thisPtr(), m_next_id++, props));
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(g->GroupGenome().Representation());
+  if (seq) g->m_hash = seq->Hash();
   m_historic.Push(g, &g->m_handle);
+  m_id_index.Set(g->ID(), g);
+  ScheduleRemoval(g); // dropped at the next update unless the rest of the load references it
   return g;
 }
 
@@ -141,13 +179,8 @@ Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(voi
 
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::Group(GroupID g_id)
 {
-  for (int i = m_best; i >= 0; i--) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-    while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
-  }
-  
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
+  GenotypePtr found;
+  if (m_id_index.Get(g_id, found)) return found;
   
   return GroupPtr(NULL);
 }
@@ -176,6 +209,23 @@ Avida::Data::ConstDataSetPtr Avida::Systematics::GenotypeArbiter::Provides() con
 
 void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_update)
 {
+  // The counts are cheap, the distribution statistics need a pass over every active genotype.  Only take that pass
+  // while some recorder has requested one of them.
+  m_num_historic_genotypes = m_historic.GetSize();
+  m_dom_id = (getBest()) ? getBest()->ID() : -1;
+  
+  Data::ManagerPtr mgr = Data::Manager::Of(m_world);
+  bool distribution_requested = false;
+  for (int i = 0; i < m_distribution_ids.GetSize() && !distribution_requested; i++) {
+    distribution_requested = mgr->IsRequested(m_distribution_ids[i]);
+  }
+  if (!distribution_requested) {
+    int active_count = 0;
+    for (int i = 1; i < m_active_sz.GetSize(); i++) active_count += m_active_sz[i].GetSize();
+    m_num_genotypes = active_count;
+    return;
+  }
+  
   cDoubleSum sum_age;
   cDoubleSum sum_abundance;
   cDoubleSum sum_depth;
@@ -225,7 +275,6 @@ void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_up
   
   // Stash all stats so that the can be retrieved using the provider mechanisms
   m_num_genotypes = active_count;
-  m_num_historic_genotypes = m_historic.GetSize();
   
   m_ave_age = sum_age.Average();
   m_ave_abundance = sum_abundance.Average();
@@ -244,8 +293,6 @@ void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_up
   m_var_depth = sum_depth.Variance();
   m_var_size = sum_size.Variance();
   m_var_threshold_age = sum_threshold_age.Variance();
-  
-  m_dom_id = (getBest()) ? getBest()->ID() : -1;  
 }
 
 
@@ -283,7 +330,7 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(u->UnitGenome().Representation());
   assert(seq);
-  int list_num = hashGenome(*seq);
+  const unsigned long long hash = seq->Hash();
   
   GenotypePtr found;
 
@@ -291,41 +338,31 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   if (hints && hints->Get("id", gid_str)) {
     int gid = Apto::StrAs(gid_str);
     
-    // Search all lists attempting to locate the referenced genotype by ID
-    for (int i = 0; i < m_active_sz.GetSize() && !found; i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
-          found->NotifyNewUnit(u);
-          break;
-        }
-      }
-    }
-    
-    if (!found) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
-          seq.DynamicCastFrom(found->GroupGenome().Representation());
-          assert(seq);
-          
-          m_active_hash[hashGenome(*seq)].Push(found);
-          found->m_handle->Remove(); // Remove from historic list
-          resizeActiveList(found->NumUnits());
-          m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
-          found->Reactivate();
-          found->NotifyNewUnit(u);
-          m_tot_genotypes++;
-          if (found->NumUnits() > m_best) {
-            m_best = found->NumUnits();
-            found->SetThreshold();
-            found->SetName(nameGenotype(seq->GetSize()));
-            m_num_threshold++;
-            m_tot_threshold++;
-            notifyListeners(found, EVENT_ADD_THRESHOLD);
-          }          
+    // Locate the referenced genotype by ID
+    GenotypePtr hinted;
+    if (m_id_index.Get(gid, hinted)) {
+      found = hinted;
+      if (found->IsActive()) {
+        found->NotifyNewUnit(u);
+      } else {
+        seq.DynamicCastFrom(found->GroupGenome().Representation());
+        assert(seq);
+        
+        found->m_hash = seq->Hash();
+        indexInsert(found);
+        found->m_handle->Remove(); // Remove from historic list
+        resizeActiveList(found->NumUnits());
+        m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
+        found->Reactivate();
+        found->NotifyNewUnit(u);
+        m_tot_genotypes++;
+        if (found->NumUnits() > m_best) {
+          m_best = found->NumUnits();
+          setThreshold(found);
+          found->SetName(nameGenotype(seq->GetSize()));
+          m_num_threshold++;
+          m_tot_threshold++;
+          notifyListeners(found, EVENT_ADD_THRESHOLD);
         }
       }
     }
@@ -333,30 +370,24 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   
   // No hints or unable to locate hinted genome, search for a matching genotype
   if (!found) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[list_num].Begin());
-    while (list_it.Next() != NULL) {
-      if ((*list_it.Get())->Matches(u)) {
-        found = *list_it.Get();
-        found->NotifyNewUnit(u);
-        break;
-      }
-    }
+    found = indexFind(hash, u);
+    if (found) found->NotifyNewUnit(u);
   }
   
   // No matching genotype (hinted or otherwise), so create a new one
   if (!found) {
-    if (!m_disable_class) { // It's not enabled, so keep the parents
-      found = GenotypePtr(new Genotype(thisPtr(), m_next_id++, u, m_cur_update, parents));
-    } else {
-      found = GenotypePtr(new Genotype(thisPtr(), m_next_id++, u, m_cur_update, ConstGroupMembershipPtr(NULL)));
-    }
-    m_active_hash[list_num].Push(found);
+    // Only keep the parents (and with them every ancestor) when classification is enabled
+    found = GenotypePtr(new Genotype(thisPtr(), m_next_id++, u, m_cur_update, parents, !m_disable_class));
+    found->m_hash = hash;
+    indexInsert(found);
+    m_id_index.Set(found->ID(), found);
+    notifyListeners(found, EVENT_ADD_GENOTYPE, u);
     resizeActiveList(found->NumUnits());
     m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
     m_tot_genotypes++;
     if (found->NumUnits() > m_best) {
       m_best = found->NumUnits();
-      found->SetThreshold();
+      setThreshold(found);
       seq.DynamicCastFrom(found->GroupGenome().Representation());
       assert(seq);
       found->SetName(nameGenotype(seq->GetSize()));
@@ -373,12 +404,13 @@ void Avida::Systematics::GenotypeArbiter::AdjustGenotype(GenotypePtr genotype, i
 {
   // Remove from old size list
   genotype->m_handle->Remove();
-  if (m_coalescent == genotype) m_coalescent = GenotypePtr(NULL);
 
-  // Handle best genotype pointer
+  // Handle best genotype pointer.  When the best size list empties, the next best is searched for among the sizes
+  // between the old and the new size only; anything at or below the new size loses to the genotype itself.  A genotype
+  // shrinking by a unit from being the lone best never scans, however far behind the runner up is.
   bool was_best = (old_size && old_size == m_best);
   if (was_best && m_active_sz[old_size].GetSize() == 0) {
-    for (m_best--; m_best > 0; m_best--) if (m_active_sz[m_best].GetSize()) break;
+    for (m_best--; m_best > new_size; m_best--) if (m_active_sz[m_best].GetSize()) break;
   }
   
   // Handle defunct genotypes
@@ -398,7 +430,7 @@ void Avida::Systematics::GenotypeArbiter::AdjustGenotype(GenotypePtr genotype, i
   }
   
   if (!genotype->IsThreshold() && (new_size >= m_threshold || genotype == getBest())) {
-    genotype->SetThreshold();
+    setThreshold(genotype);
     ConstInstructionSequencePtr seq;
     seq.DynamicCastFrom(genotype->GroupGenome().Representation());
     assert(seq);
@@ -425,6 +457,7 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
   // Setup functors and references for use in the PROVIDE macro
   Data::ProviderActivateFunctor activate(this, &GenotypeArbiter::activateProvider);
   Data::ManagerPtr mgr = Data::Manager::Of(world);
+  m_world = world;
   Apto::Functor<Data::PackagePtr, Apto::TL::Create<const int&> > intStat(this, &GenotypeArbiter::packageData<int>);
   Apto::Functor<Data::PackagePtr, Apto::TL::Create<const double&> > doubleStat(this, &GenotypeArbiter::packageData<double>);
 
@@ -464,19 +497,78 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
   PROVIDE("entropy", "Genotypic Entropy", double, m_entropy);
   
   PROVIDE("dominant_id", "Dominant Genotype ID", int, m_dom_id);
+  
+  const char* distribution_stats[] = { "ave_age", "ave_abundance", "ave_depth", "ave_size", "ave_threshold_age",
+    "stderr_age", "stderr_abundance", "stderr_depth", "stderr_size", "stderr_threshold_age",
+    "var_age", "var_abundance", "var_depth", "var_size", "var_threshold_age", "entropy" };
+  for (unsigned int i = 0; i < sizeof(distribution_stats) / sizeof(const char*); i++) {
+    m_distribution_ids.Push(Apto::String("systematics.") + Role() + "." + distribution_stats[i]);
+  }
 }
 
 
 
-unsigned int Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome) const
+void Avida::Systematics::GenotypeArbiter::indexInsert(GenotypePtr genotype)
 {
-  unsigned int total = 0;
-  
-  for (int i = 0; i < genome.GetSize(); i++) {
-    total += (genome[i].GetOp() + 3) * i;
+  // Keep the load (including removal markers) at or below one half, doubling only when live entries call for it
+  if ((m_active_index_filled + 1) * 2 > m_active_index.GetSize()) {
+    const int size = m_active_index.GetSize();
+    rebuildIndex(((m_active_index_count + 1) * 4 > size) ? size * 2 : size);
   }
   
-  return total % HASH_SIZE;
+  const int mask = m_active_index.GetSize() - 1;
+  int slot = (int)(genotype->m_hash & (unsigned long long)mask);
+  while (m_active_index[slot].state == INDEX_USED) slot = (slot + 1) & mask;
+  
+  if (m_active_index[slot].state == INDEX_EMPTY) m_active_index_filled++;
+  m_active_index[slot].hash = genotype->m_hash;
+  m_active_index[slot].genotype = genotype;
+  m_active_index[slot].state = INDEX_USED;
+  m_active_index_count++;
+}
+
+void Avida::Systematics::GenotypeArbiter::indexRemove(GenotypePtr genotype)
+{
+  const int mask = m_active_index.GetSize() - 1;
+  for (int slot = (int)(genotype->m_hash & (unsigned long long)mask); m_active_index[slot].state != INDEX_EMPTY;
+       slot = (slot + 1) & mask) {
+    if (m_active_index[slot].state == INDEX_USED && m_active_index[slot].genotype == genotype) {
+      m_active_index[slot].genotype = GenotypePtr(NULL);
+      m_active_index[slot].state = INDEX_REMOVED;
+      m_active_index_count--;
+      return;
+    }
+  }
+  assert(false);
+}
+
+Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::indexFind(unsigned long long hash, UnitPtr u)
+{
+  const int mask = m_active_index.GetSize() - 1;
+  for (int slot = (int)(hash & (unsigned long long)mask); m_active_index[slot].state != INDEX_EMPTY;
+       slot = (slot + 1) & mask) {
+    IndexEntry& entry = m_active_index[slot];
+    if (entry.state == INDEX_USED && entry.hash == hash && entry.genotype->Matches(u)) return entry.genotype;
+  }
+  return GenotypePtr(NULL);
+}
+
+void Avida::Systematics::GenotypeArbiter::rebuildIndex(int size)
+{
+  Apto::Array<IndexEntry> old_index(m_active_index);
+  m_active_index.ResizeClear(size);
+  m_active_index.SetAll(IndexEntry());
+
+  const int mask = size - 1;
+  m_active_index_count = 0;
+  for (int i = 0; i < old_index.GetSize(); i++) {
+    if (old_index[i].state != INDEX_USED) continue;
+    int slot = (int)(old_index[i].hash & (unsigned long long)mask);
+    while (m_active_index[slot].state == INDEX_USED) slot = (slot + 1) & mask;
+    m_active_index[slot] = old_index[i];
+    m_active_index_count++;
+  }
+  m_active_index_filled = m_active_index_count;
 }
 
 Apto::String Avida::Systematics::GenotypeArbiter::nameGenotype(int size)
@@ -495,23 +587,31 @@ Apto::String Avida::Systematics::GenotypeArbiter::nameGenotype(int size)
   return Apto::FormatStr("%03d-%s", size, alpha);
 }
 
+void Avida::Systematics::GenotypeArbiter::setThreshold(GenotypePtr genotype)
+{
+  assert(!genotype->IsThreshold());
+  genotype->SetThreshold();
+  m_threshold_list.Push(genotype, &genotype->m_threshold_handle);
+}
+
 void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
 {
   if (genotype->ActiveReferenceCount()) return;    
   
   if (genotype->IsActive()) {
-    ConstInstructionSequencePtr seq;
-    seq.DynamicCastFrom(genotype->GroupGenome().Representation());
-    int list_num = hashGenome(*seq);
-    m_active_hash[list_num].Remove(genotype);
+    indexRemove(genotype);
     genotype->Deactivate(m_cur_update);
     m_historic.Push(genotype, &genotype->m_handle);
+    notifyListeners(genotype, EVENT_DEACTIVATE_GENOTYPE);
   }
 
   if (genotype->IsThreshold()) {
     m_num_threshold--;
     notifyListeners(genotype, EVENT_REMOVE_THRESHOLD);
     genotype->ClearThreshold();
+    genotype->m_threshold_handle->Remove();
+    delete genotype->m_threshold_handle;
+    genotype->m_threshold_handle = NULL;
   }
   
   if (genotype->PassiveReferenceCount()) return;
@@ -530,6 +630,8 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   
   delete genotype->m_handle;
   genotype->m_handle = NULL;
+  m_id_index.Remove(genotype->ID());
+  notifyListeners(genotype, EVENT_REMOVE_GENOTYPE);
 }
 
 void Avida::Systematics::GenotypeArbiter::updateCoalescent()
@@ -543,12 +645,18 @@ void Avida::Systematics::GenotypeArbiter::updateCoalescent()
   }
   
   // @note - update coalescent assumes asexual population
+  //
+  // Genotypes can only lose branches and living organisms once they have turned into ancestors, so none of the
+  // ancestors of the previous coalescent can have become interesting since it was found.  When the previous coalescent
+  // is on the lineage of the best genotype, the walk can stop there rather than going all the way back to the root.
+  GenotypePtr stop_gen = m_coalescent;
   GenotypePtr test_gen = getBest();
   GenotypePtr found_gen = test_gen;
   GenotypePtr parent_gen = (found_gen->Parents().GetSize()) ? (found_gen->Parents()[0]) : GenotypePtr(NULL);
 
   while (parent_gen) {
     if (test_gen->ActiveReferenceCount() > 0 || test_gen->PassiveReferenceCount() > 1) found_gen = test_gen;
+    if (test_gen == stop_gen) break;
     
     test_gen = parent_gen;
     parent_gen = (test_gen->Parents().GetSize()) ? (test_gen->Parents()[0]) : GenotypePtr(NULL);
@@ -24,9 +24,37 @@
 
 #include "avida/systematics/Group.h"
 
+#include "avida/core/Properties.h"
+
 #include <cassert>
 
 
+static const Avida::PropertyID s_group_prop_ids[Avida::Systematics::NUM_GROUP_PROPS] = {
+  "name",
+  "genome",
+  "parents",
+  "threshold",
+  "update_born",
+  "src_transmission_type",
+  "total_organisms",
+  "ave_copy_size",
+  "ave_exe_size",
+  "ave_gestation_time",
+  "ave_repro_rate",
+  "ave_metabolic_rate",
+  "ave_fitness",
+  "max_fitness",
+  "last_births",
+  "last_deaths",
+  "last_breed_true",
+  "last_breed_in",
+  "last_breed_out",
+  "last_birth_cell",
+  "last_group_id",
+  "last_forager_type"
+};
+
+
 Avida::Systematics::Group::~Group() { ; }
 Avida::Systematics::GroupData::~GroupData() { ; }
 
@@ -43,6 +71,28 @@ bool Avida::Systematics::Group::LegacySave(void*) const
 }
 
 
+int Avida::Systematics::Group::IntProperty(GroupProperty prop) const
+{
+  return Properties().Get(PropertyIDOf(prop)).IntValue();
+}
+
+double Avida::Systematics::Group::DoubleProperty(GroupProperty prop) const
+{
+  return Properties().Get(PropertyIDOf(prop)).DoubleValue();
+}
+
+Apto::String Avida::Systematics::Group::StringProperty(GroupProperty prop) const
+{
+  return Properties().Get(PropertyIDOf(prop)).StringValue();
+}
+
+const Avida::PropertyID& Avida::Systematics::Group::PropertyIDOf(GroupProperty prop)
+{
+  assert(prop >= 0 && prop < NUM_GROUP_PROPS);
+  return s_group_prop_ids[prop];
+}
+
+
 void Avida::Systematics::Group::AddActiveReference() const { m_a_refs++; assert(m_a_refs >= 0); }
 void Avida::Systematics::Group::RemoveActiveReference() const { m_a_refs--; assert(m_a_refs >= 0); }
 void Avida::Systematics::Group::AddPassiveReference() const { m_p_refs++; assert(m_p_refs >= 0); }
@@ -55,6 +55,18 @@ void Avida::Systematics::Manager::ClassifyNewUnit(UnitPtr u, const RoleClassific
     if (g) u->AddClassification(g);
   }
 }
+
+void Avida::Systematics::Manager::ClassifyNewUnits(const Apto::Array<UnitPtr>& units, const RoleClassificationHints* role_hints)
+{
+  // Each arbiter sees the whole batch at once, so the hints are resolved once per role rather than once per unit
+  Apto::Array<GroupPtr> groups;
+  for (int i = 0; i < m_arbiters.GetSize(); i++) {
+    const ClassificationHints* hints = NULL;
+    if (role_hints && role_hints->Has(m_arbiters[i]->Role())) hints = &(role_hints->Get(m_arbiters[i]->Role()));
+    m_arbiters[i]->ClassifyNewUnits(units, hints, groups);
+    for (int u = 0; u < units.GetSize(); u++) if (groups[u]) units[u]->AddClassification(groups[u]);
+  }
+}
 bool Avida::Systematics::Manager::AttachTo(World* world)
 {
   WorldFacetPtr ptr(this);
@@ -75,10 +87,18 @@ Avida::Systematics::ManagerPtr Avida::Systematics::Manager::Of(World* world)
 }
 
 
-bool Avida::Systematics::Manager::Serialize(ArchivePtr) const
+bool Avida::Systematics::Manager::Serialize(ArchivePtr ar) const
 {
-  // @TODO
-  return false;
+  ar->SetObjectType("systematics.manager");
+  ar->SetVersion(1);
+  
+  // Arbiters that do not support archiving yet are still listed, with an empty sub-object
+  bool success = true;
+  for (int i = 0; i < m_arbiters.GetSize(); i++) {
+    if (!m_arbiters[i]->Serialize(ar->DefineSubObject(m_arbiters[i]->Role()))) success = false;
+  }
+  
+  return success;
 }
 
 
@@ -0,0 +1,138 @@
+/*
+ *  systematics/PhylogenyLog.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/systematics/PhylogenyLog.h"
+
+#include "avida/core/InstructionSequence.h"
+#include "avida/private/systematics/Genotype.h"
+#include "avida/private/systematics/GenotypeArbiter.h"
+
+
+namespace {
+  static const unsigned int PHYLOGENY_LOG_VERSION = 1;
+  static const unsigned int PHYLOGENY_ENDIAN_MARKER = 0x01020304;
+}
+
+
+Avida::Systematics::PhylogenyLog::PhylogenyLog(ArbiterPtr arbiter, const Apto::String& path, bool prune)
+  : m_arbiter(arbiter), m_prune(prune), m_out((const char*)path, std::ios::out | std::ios::trunc | std::ios::binary)
+{
+  if (!m_out.is_open()) return;
+
+  m_buf.append("AVIDAPHY", 8);
+  m_buf.append(reinterpret_cast<const char*>(&PHYLOGENY_LOG_VERSION), sizeof(PHYLOGENY_LOG_VERSION));
+  m_buf.append(reinterpret_cast<const char*>(&PHYLOGENY_ENDIAN_MARKER), sizeof(PHYLOGENY_ENDIAN_MARKER));
+
+  m_arbiter->AttachListener(this);
+}
+
+Avida::Systematics::PhylogenyLog::~PhylogenyLog()
+{
+  if (!m_out.is_open()) return;
+
+  m_arbiter->DetachListener(this);
+  Flush();
+}
+
+
+void Avida::Systematics::PhylogenyLog::Notify(GroupPtr g, EventType t, UnitPtr)
+{
+  GenotypePtr genotype;
+  genotype.DynamicCastFrom(g);
+  if (!genotype) return;
+
+  switch (t) {
+    case GenotypeArbiter::EVENT_ADD_GENOTYPE:
+    {
+      const Genome& genome = genotype->GroupGenome();
+      int instset = instSetIndex(genome.Properties().Get("instset").StringValue());
+      const Apto::Array<GroupID>& parents = genotype->ParentIDs();
+
+      m_buf.push_back(static_cast<char>(RECORD_BIRTH));
+      appendVarint(genotype->ID());
+      appendSigned(genotype->GetUpdateBorn());
+      appendVarint(parents.GetSize());
+      for (int i = 0; i < parents.GetSize(); i++) appendVarint(parents[i]);
+      appendVarint(genome.HardwareType());
+      appendVarint(instset);
+
+      ConstInstructionSequencePtr seq;
+      seq.DynamicCastFrom(genome.Representation());
+      const int length = (seq) ? seq->GetSize() : 0;
+      appendVarint(length);
+      for (int i = 0; i < length; i++) m_buf.push_back(static_cast<char>((*seq)[i].GetOp()));
+      break;
+    }
+
+    case GenotypeArbiter::EVENT_DEACTIVATE_GENOTYPE:
+      m_buf.push_back(static_cast<char>(RECORD_EXTINCT));
+      appendVarint(genotype->ID());
+      appendSigned(genotype->m_update_deactivated);
+      break;
+
+    case GenotypeArbiter::EVENT_REMOVE_GENOTYPE:
+      if (!m_prune) return;
+      m_buf.push_back(static_cast<char>(RECORD_PRUNE));
+      appendVarint(genotype->ID());
+      break;
+
+    default:
+      return;
+  }
+
+  if (static_cast<int>(m_buf.size()) >= FLUSH_BYTES) Flush();
+}
+
+
+void Avida::Systematics::PhylogenyLog::Flush()
+{
+  if (m_buf.size()) m_out.write(m_buf.data(), m_buf.size());
+  m_buf.clear();
+  m_out.flush();
+}
+
+
+int Avida::Systematics::PhylogenyLog::instSetIndex(const Apto::String& name)
+{
+  for (int i = 0; i < m_instsets.GetSize(); i++) if (m_instsets[i] == name) return i;
+
+  const int idx = m_instsets.GetSize();
+  m_instsets.Push(name);
+  m_buf.push_back(static_cast<char>(RECORD_INSTSET));
+  appendVarint(idx);
+  appendVarint(name.GetSize());
+  m_buf.append((const char*)name, name.GetSize());
+  return idx;
+}
+
+
+inline void Avida::Systematics::PhylogenyLog::appendVarint(unsigned long long value)
+{
+  while (value >= 0x80) {
+    m_buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  m_buf.push_back(static_cast<char>(value));
+}
+
+inline void Avida::Systematics::PhylogenyLog::appendSigned(long long value)
+{
+  appendVarint((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+}
@@ -32,48 +32,26 @@ const Apto::String Avida::Systematics::SexualAncestry::ObjectKey("Avida::Systema
 Avida::Systematics::SexualAncestry::SexualAncestry(GroupPtr g)
 {
   m_id = g->ID();
-  m_ancestor_ids[0] = -1;
-  m_ancestor_ids[1] = -1;
-  m_ancestor_ids[2] = -1;
-  m_ancestor_ids[3] = -1;
-  m_ancestor_ids[4] = -1;
-  m_ancestor_ids[5] = -1;
   
   if (!g->Properties().Has("parents")) return;
   
   ArbiterPtr arbiter = g->Arbiter();
-  Apto::Array<GroupPtr> parents;
-  Apto::String parent_str(g->Properties().Get("parents").StringValue());
-  while (parent_str.GetSize()) {
-    parents.Push(arbiter->Group(Apto::StrAs(parent_str.Pop(','))));
-  }
-  
-  
-  if (parents.GetSize() > 0) {
-    GroupPtr p1 = parents[0];
-    SexualAncestryPtr p1sa = p1->GetData<SexualAncestry>();
-    if (!p1sa) {
-      p1sa = SexualAncestryPtr(new SexualAncestry(p1));
-      p1->AttachData(p1sa);
-    }
-    
-    m_ancestor_ids[0] = p1->ID();
-    m_ancestor_ids[2] = p1sa->GetAncestorID(0);
-    m_ancestor_ids[3] = p1sa->GetAncestorID(1);
+  Apto::String parent_str(g->StringProperty(GROUP_PROP_PARENTS));
+  for (int i = 0; i < 2 && parent_str.GetSize(); i++) {
+    GroupPtr parent = arbiter->Group(Apto::StrAs(parent_str.Pop(',')));
+    if (parent) m_parents[i] = Of(parent);
   }
+}
 
-  if (parents.GetSize() > 1) {
-    GroupPtr p2 = parents[1];
-    SexualAncestryPtr p2sa = p2->GetData<SexualAncestry>();
-    if (!p2sa) {
-      p2sa = SexualAncestryPtr(new SexualAncestry(p2));
-      p2->AttachData(p2sa);
-    }
-    
-    m_ancestor_ids[1] = p2->ID();
-    m_ancestor_ids[4] = p2sa->GetAncestorID(0);
-    m_ancestor_ids[5] = p2sa->GetAncestorID(1);
+
+Avida::Systematics::SexualAncestryPtr Avida::Systematics::SexualAncestry::Of(GroupPtr g)
+{
+  SexualAncestryPtr sa = g->GetData<SexualAncestry>();
+  if (!sa) {
+    sa = SexualAncestryPtr(new SexualAncestry(g));
+    g->AttachData(sa);
   }
+  return sa;
 }
 
 
@@ -86,77 +64,91 @@ bool Avida::Systematics::SexualAncestry::Serialize(ArchivePtr) const
 
 int Avida::Systematics::SexualAncestry::GetPhyloDistance(GroupPtr g) const
 {
-  SexualAncestryPtr tsa = g->GetData<SexualAncestry>();
-  if (!tsa) {
-    tsa = SexualAncestryPtr(new SexualAncestry(g));
-    g->AttachData(tsa);
-  }
-  
-
+  SexualAncestryPtr tsa = Of(g);
   if (m_id == tsa->GetID()) return 0;
+  
+  // Flatten both ancestries once rather than walking the nodes for every comparison
+  int mine[6];
+  int theirs[6];
+  getAncestorIDs(mine);
+  tsa->getAncestorIDs(theirs);
 
-  if (m_id == tsa->GetAncestorID(0) ||  // Parent of test
-      m_id == tsa->GetAncestorID(1) ||  // Parent of test
-      tsa->GetID() == GetAncestorID(0) ||  // Child of test
-      tsa->GetID() == GetAncestorID(1)     // Child of test
+  if (m_id == theirs[0] ||  // Parent of test
+      m_id == theirs[1] ||  // Parent of test
+      tsa->GetID() == mine[0] ||  // Child of test
+      tsa->GetID() == mine[1]     // Child of test
       ) {
     return 1;
   }
   
-  if (m_id == tsa->GetAncestorID(2) ||  // Grandparent of test
-      m_id == tsa->GetAncestorID(3) ||  // Grandparent of test
-      m_id == tsa->GetAncestorID(4) ||  // Grandparent of test
-      m_id == tsa->GetAncestorID(5) ||  // Grandparent of test
-      tsa->GetID() == GetAncestorID(2) ||  // Grandchild of test
-      tsa->GetID() == GetAncestorID(3) ||  // Grandchild of test
-      tsa->GetID() == GetAncestorID(4) ||  // Grandchild of test
-      tsa->GetID() == GetAncestorID(5) ||  // Grandchild of test
-      GetAncestorID(0) == tsa->GetAncestorID(0) || // Sibling of test
-      GetAncestorID(0) == tsa->GetAncestorID(1) || // Sibling of test
-      GetAncestorID(1) == tsa->GetAncestorID(0) || // Sibling of test
-      GetAncestorID(1) == tsa->GetAncestorID(1)    // Sibling of test
+  if (m_id == theirs[2] ||  // Grandparent of test
+      m_id == theirs[3] ||  // Grandparent of test
+      m_id == theirs[4] ||  // Grandparent of test
+      m_id == theirs[5] ||  // Grandparent of test
+      tsa->GetID() == mine[2] ||  // Grandchild of test
+      tsa->GetID() == mine[3] ||  // Grandchild of test
+      tsa->GetID() == mine[4] ||  // Grandchild of test
+      tsa->GetID() == mine[5] ||  // Grandchild of test
+      mine[0] == theirs[0] || // Sibling of test
+      mine[0] == theirs[1] || // Sibling of test
+      mine[1] == theirs[0] || // Sibling of test
+      mine[1] == theirs[1]    // Sibling of test
       ) {
     return 2;
   }
-  if (GetAncestorID(0) == tsa->GetAncestorID(2) || // Uncle of test
-      GetAncestorID(0) == tsa->GetAncestorID(3) || // Uncle of test
-      GetAncestorID(0) == tsa->GetAncestorID(4) || // Uncle of test
-      GetAncestorID(0) == tsa->GetAncestorID(5) || // Uncle of test
-      GetAncestorID(1) == tsa->GetAncestorID(2) || // Uncle of test
-      GetAncestorID(1) == tsa->GetAncestorID(3) || // Uncle of test
-      GetAncestorID(1) == tsa->GetAncestorID(4) || // Uncle of test
-      GetAncestorID(1) == tsa->GetAncestorID(5) || // Uncle of test
-      tsa->GetAncestorID(0) == GetAncestorID(2) || // Nephew of test
-      tsa->GetAncestorID(0) == GetAncestorID(3) || // Nephew of test
-      tsa->GetAncestorID(0) == GetAncestorID(4) || // Nephew of test
-      tsa->GetAncestorID(0) == GetAncestorID(5) || // Nephew of test
-      tsa->GetAncestorID(1) == GetAncestorID(2) || // Nephew of test
-      tsa->GetAncestorID(1) == GetAncestorID(3) || // Nephew of test
-      tsa->GetAncestorID(1) == GetAncestorID(4) || // Nephew of test
-      tsa->GetAncestorID(1) == GetAncestorID(5)    // Nephew of test
+  if (mine[0] == theirs[2] || // Uncle of test
+      mine[0] == theirs[3] || // Uncle of test
+      mine[0] == theirs[4] || // Uncle of test
+      mine[0] == theirs[5] || // Uncle of test
+      mine[1] == theirs[2] || // Uncle of test
+      mine[1] == theirs[3] || // Uncle of test
+      mine[1] == theirs[4] || // Uncle of test
+      mine[1] == theirs[5] || // Uncle of test
+      theirs[0] == mine[2] || // Nephew of test
+      theirs[0] == mine[3] || // Nephew of test
+      theirs[0] == mine[4] || // Nephew of test
+      theirs[0] == mine[5] || // Nephew of test
+      theirs[1] == mine[2] || // Nephew of test
+      theirs[1] == mine[3] || // Nephew of test
+      theirs[1] == mine[4] || // Nephew of test
+      theirs[1] == mine[5]    // Nephew of test
       ) {
     return 3;
   }
   
-  if (GetAncestorID(2) == tsa->GetAncestorID(2) || // First Cousins
-      GetAncestorID(2) == tsa->GetAncestorID(3) ||
-      GetAncestorID(2) == tsa->GetAncestorID(4) ||
-      GetAncestorID(2) == tsa->GetAncestorID(5) ||
-      GetAncestorID(3) == tsa->GetAncestorID(2) ||
-      GetAncestorID(3) == tsa->GetAncestorID(3) ||
-      GetAncestorID(3) == tsa->GetAncestorID(4) ||
-      GetAncestorID(3) == tsa->GetAncestorID(5) ||
-      GetAncestorID(4) == tsa->GetAncestorID(2) ||
-      GetAncestorID(4) == tsa->GetAncestorID(3) ||
-      GetAncestorID(4) == tsa->GetAncestorID(4) ||
-      GetAncestorID(4) == tsa->GetAncestorID(5) ||
-      GetAncestorID(5) == tsa->GetAncestorID(2) ||
-      GetAncestorID(5) == tsa->GetAncestorID(3) ||
-      GetAncestorID(5) == tsa->GetAncestorID(4) ||
-      GetAncestorID(5) == tsa->GetAncestorID(5)
+  if (mine[2] == theirs[2] || // First Cousins
+      mine[2] == theirs[3] ||
+      mine[2] == theirs[4] ||
+      mine[2] == theirs[5] ||
+      mine[3] == theirs[2] ||
+      mine[3] == theirs[3] ||
+      mine[3] == theirs[4] ||
+      mine[3] == theirs[5] ||
+      mine[4] == theirs[2] ||
+      mine[4] == theirs[3] ||
+      mine[4] == theirs[4] ||
+      mine[4] == theirs[5] ||
+      mine[5] == theirs[2] ||
+      mine[5] == theirs[3] ||
+      mine[5] == theirs[4] ||
+      mine[5] == theirs[5]
       ) {
     return 4;
   }
   
   return 5;
 }
+
+
+void Avida::Systematics::SexualAncestry::getAncestorIDs(int ids[6]) const
+{
+  for (int i = 0; i < 2; i++) {
+    if (m_parents[i]) {
+      ids[i] = m_parents[i]->m_id;
+      ids[2 + 2 * i] = m_parents[i]->GetAncestorID(0);
+      ids[3 + 2 * i] = m_parents[i]->GetAncestorID(1);
+    } else {
+      ids[i] = ids[2 + 2 * i] = ids[3 + 2 * i] = -1;
+    }
+  }
+}
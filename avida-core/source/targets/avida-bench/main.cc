@@ -0,0 +1,384 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "apto/core/FileSystem.h"
+#include "avida/Avida.h"
+#include "avida/core/Genome.h"
+#include "avida/core/InstructionSequence.h"
+#include "avida/core/World.h"
+#include "avida/systematics/Arbiter.h"
+#include "avida/systematics/Group.h"
+#include "avida/systematics/Manager.h"
+#include "avida/util/CmdLine.h"
+
+#include "avida/private/util/GenomeLoader.h"
+
+#include "cAvidaConfig.h"
+#include "cAvidaContext.h"
+#include "cCPUTestInfo.h"
+#include "cDemePlaceholderUnit.h"
+#include "cEnvironment.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cReactionLib.h"
+#include "cReactionResult.h"
+#include "cResourceLib.h"
+#include "cSpatialResCount.h"
+#include "cTaskContext.h"
+#include "cTestCPU.h"
+#include "cUpdateProfiler.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+#include "nGeometry.h"
+
+#include "Avida2Driver.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+
+// avida-bench [-bench-scale <factor>] [-bench-only <name prefix>] [avida options]
+//
+// Microbenchmarks organism execution on each hardware type and a handful of core data structures.  Every benchmark
+// prints one line, "bench: name=<name> iterations=<n> total=<seconds> per_iter_us=<microseconds> [<unit>_per_s=<rate>]",
+// or "bench: name=<name> skipped=<reason>".  Hardware benchmarks run the standard ancestor of each type from the working
+// directory, configured with the normal avida options and the instruction set file of the type.  The remaining
+// benchmarks run in the heads world.  -bench-scale multiplies every iteration count.
+
+
+struct sHardwareCase
+{
+  const char* name;
+  const char* inst_set_file;
+  const char* ancestor_file;
+};
+
+static const sHardwareCase HARDWARE_CASES[] = {
+  { "cpu", "instset-heads.cfg", "default-heads.org" },
+  { "transsmt", "instset-transsmt.cfg", "default-transsmt.org" },
+  { "experimental", "instset-experimental.cfg", "experimental.org" },
+  { "gp8", "instset-gp8.cfg", "default-gp8.org" },
+  { "bcr", "instset-bcr.cfg", "default-bcr.org" }
+};
+static const int NUM_HARDWARE_CASES = sizeof(HARDWARE_CASES) / sizeof(sHardwareCase);
+
+
+static double s_scale = 1.0;
+static const char* s_only = NULL;
+
+static bool IsSelected(const char* name)
+{
+  return (s_only == NULL || strncmp(name, s_only, strlen(s_only)) == 0);
+}
+
+static int Iterations(int base)
+{
+  const int iterations = (int)(base * s_scale);
+  return (iterations > 0) ? iterations : 1;
+}
+
+static void ReportSkipped(const char* name, const char* reason)
+{
+  cout << "bench: name=" << name << " skipped=" << reason << endl;
+}
+
+static void ReportResult(const char* name, int iterations, double elapsed, const char* unit = NULL, double units = 0.0)
+{
+  printf("bench: name=%s iterations=%d total=%.6f per_iter_us=%.3f", name, iterations, elapsed,
+         elapsed * 1000000.0 / iterations);
+  if (unit) printf(" %s_per_s=%.1f", unit, (elapsed > 0.0) ? units / elapsed : 0.0);
+  printf("\n");
+  fflush(stdout);
+}
+
+
+// Builds a silent world from the command line configuration with the given instruction set file.  Returns NULL, after
+// printing the configuration errors, if the world could not be set up.
+static cWorld* SetupWorld(int argc, char* argv[], const char* inst_set_file)
+{
+  Apto::Map<Apto::String, Apto::String> defs;
+  defs.Set("INST_SET", inst_set_file);
+  cAvidaConfig* cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(argc, argv, cfg, defs);
+  cfg->VERBOSITY.Set(VERBOSE_SILENT);
+  // Mutants and inputs are drawn from the world's random number generator, keep them the same from run to run
+  if (cfg->RANDOM_SEED.Get() <= 0) cfg->RANDOM_SEED.Set(1);
+
+  cUserFeedback feedback;
+  Avida::World* new_world = new Avida::World();
+  cWorld* world = cWorld::Initialize(cfg, cString(Apto::FileSystem::GetCWD()), new_world, &feedback, &defs);
+  for (int i = 0; i < feedback.GetNumMessages(); i++) {
+    if (feedback.GetMessageType(i) == cUserFeedback::UF_ERROR) cerr << "error: " << feedback.GetMessage(i) << endl;
+  }
+  return world;
+}
+
+
+static void MakeMutants(cWorld* world, const Genome& genome, int num_mutants, Apto::Array<Genome>& mutants)
+{
+  const cInstSet& is = world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue());
+  mutants.Resize(num_mutants);
+  for (int i = 0; i < num_mutants; i++) {
+    mutants[i] = genome;
+    InstructionSequencePtr seq;
+    seq.DynamicCastFrom(mutants[i].Representation());
+    (*seq)[world->GetRandom().GetUInt(seq->GetSize())] = is.GetRandomInst(world->GetDefaultContext());
+  }
+}
+
+
+// Execution of the ancestor of one hardware type, from birth to divide, in a test CPU
+static void BenchHardware(cWorld* world, const char* name, const Genome& genome)
+{
+  cAvidaContext& ctx = world->GetDefaultContext();
+  cTestCPU* test_cpu = world->GetHardwareManager().CreateTestCPU(ctx);
+
+  const int iterations = Iterations(200);
+  double cycles = 0.0;
+  const double start = cUpdateProfiler::Now();
+  for (int i = 0; i < iterations; i++) {
+    cCPUTestInfo test_info;
+    test_cpu->TestGenome(ctx, test_info, genome);
+    cycles += test_info.GetTestOrganism()->GetPhenotype().GetCPUCyclesUsed();
+  }
+  ReportResult(name, iterations, cUpdateProfiler::Now() - start, "insts", cycles);
+
+  delete test_cpu;
+}
+
+
+// Whole genome test throughput, every test a different single point mutant of the ancestor
+static void BenchTestCPU(cWorld* world, const Genome& genome)
+{
+  cAvidaContext& ctx = world->GetDefaultContext();
+  cTestCPU* test_cpu = world->GetHardwareManager().CreateTestCPU(ctx);
+
+  const int iterations = Iterations(1000);
+  Apto::Array<Genome> mutants;
+  MakeMutants(world, genome, iterations, mutants);
+
+  const double start = cUpdateProfiler::Now();
+  for (int i = 0; i < iterations; i++) {
+    cCPUTestInfo test_info;
+    test_cpu->TestGenome(ctx, test_info, mutants[i]);
+  }
+  ReportResult("testcpu.test_genome", iterations, cUpdateProfiler::Now() - start, "genomes", iterations);
+
+  delete test_cpu;
+}
+
+
+// Genotype classification of offspring whose genotype already exists, the common case during a run
+static void BenchClassify(cWorld* world, const Genome& genome)
+{
+  Systematics::ArbiterPtr arbiter = Systematics::Manager::Of(world->GetNewWorld())->ArbiterForRole("genotype");
+
+  const int num_genotypes = 256;
+  Apto::Array<Genome> mutants;
+  MakeMutants(world, genome, num_genotypes, mutants);
+
+  // One resident unit per genotype keeps it alive across the timed loop
+  Apto::Array<Systematics::GroupPtr> residents(num_genotypes);
+  for (int i = 0; i < num_genotypes; i++) {
+    Systematics::UnitPtr unit(new cDemePlaceholderUnit(Systematics::Source(Systematics::DIVISION, ""), mutants[i]));
+    residents[i] = arbiter->ClassifyNewUnit(unit);
+  }
+
+  const int iterations = Iterations(100000);
+  const double start = cUpdateProfiler::Now();
+  for (int i = 0; i < iterations; i++) {
+    Systematics::UnitPtr unit(new cDemePlaceholderUnit(Systematics::Source(Systematics::DIVISION, ""),
+                                                       mutants[i % num_genotypes]));
+    arbiter->ClassifyNewUnit(unit)->RemoveUnit();
+  }
+  ReportResult("systematics.genotype_classify", iterations, cUpdateProfiler::Now() - start, "units", iterations);
+
+  // Batches of clones, as classified when a deme is seeded
+  const int batch_size = 25;
+  Apto::Array<Systematics::UnitPtr> batch(batch_size);
+  Apto::Array<Systematics::GroupPtr> groups;
+  const int batches = iterations / batch_size;
+  const double batch_start = cUpdateProfiler::Now();
+  for (int i = 0; i < batches; i++) {
+    for (int j = 0; j < batch_size; j++) {
+      batch[j] = Systematics::UnitPtr(new cDemePlaceholderUnit(Systematics::Source(Systematics::DIVISION, ""),
+                                                               mutants[i % num_genotypes]));
+    }
+    arbiter->ClassifyNewUnits(batch, NULL, groups);
+    for (int j = 0; j < batch_size; j++) groups[j]->RemoveUnit();
+  }
+  ReportResult("systematics.genotype_classify_batch", batches * batch_size, cUpdateProfiler::Now() - batch_start, "units",
+               batches * batch_size);
+
+  for (int i = 0; i < num_genotypes; i++) residents[i]->RemoveUnit();
+}
+
+
+// Diffusion, inflow and outflow of one spatial resource over a 60x60 torus
+static void BenchDiffusion(cWorld* world)
+{
+  const int world_x = 60;
+  const int world_y = 60;
+  cSpatialResCount res(world_x, world_y, nGeometry::TORUS, 0.5, 0.5, 0.0, 0.0);
+  res.SetInflowX1(0);
+  res.SetInflowX2(9);
+  res.SetInflowY1(0);
+  res.SetInflowY2(9);
+  res.SetOutflowX1(30);
+  res.SetOutflowX2(39);
+  res.SetOutflowY1(30);
+  res.SetOutflowY2(39);
+  res.SetInitial(1.0);
+  res.RateAll(res.GetInitial());
+  res.StateAll();
+  res.SetPointers();
+
+  const int iterations = Iterations(2000);
+  const double start = cUpdateProfiler::Now();
+  for (int i = 0; i < iterations; i++) res.StepAll(world->GetDefaultContext(), 100.0, 0.99);
+  ReportResult("resource.spatial_step", iterations, cUpdateProfiler::Now() - start, "cells", (double)iterations * world_x * world_y);
+}
+
+
+// Task checking of organism outputs, both the logic setup alone and the full reaction test in the environment
+static void BenchTasks(cWorld* world)
+{
+  cAvidaContext& ctx = world->GetDefaultContext();
+  const cEnvironment& env = world->GetEnvironment();
+
+  Apto::Array<int> input_array;
+  env.SetupInputs(ctx, input_array);
+  tBuffer<int> inputs(3);
+  for (int i = 0; i < input_array.GetSize() && i < 3; i++) inputs.Add(input_array[i]);
+
+  // A rotating set of logic functions of the inputs, so task tests both pass and fail
+  const int num_outputs = 8;
+  const int a = input_array[0];
+  const int b = input_array[1];
+  const int values[num_outputs] = { ~(a & b), ~a, a & b, a | b, a & ~b, a | ~b, a ^ b, ~(a ^ b) };
+  tBuffer<int> output(1);
+
+  tList<tBuffer<int> > other_inputs;
+  tList<tBuffer<int> > other_outputs;
+  Apto::Array<int, Apto::Smart> ext_mem;
+
+  if (IsSelected("tasklib")) {
+    const int iterations = Iterations(1000000);
+    const double start = cUpdateProfiler::Now();
+    for (int i = 0; i < iterations; i++) {
+      output.Add(values[i % num_outputs]);
+      cTaskContext taskctx(NULL, inputs, output, other_inputs, other_outputs, ext_mem);
+      env.GetTaskLib().SetupTests(taskctx);
+    }
+    ReportResult("tasklib.setup_tests", iterations, cUpdateProfiler::Now() - start, "outputs", iterations);
+  }
+  if (!IsSelected("environment")) return;
+
+  const int num_resources = env.GetResourceLib().GetSize();
+  const int num_tasks = env.GetNumTasks();
+  const int num_reactions = env.GetReactionLib().GetSize();
+  cReactionResult result(num_resources, num_tasks, num_reactions);
+  Apto::Array<int> task_count(num_tasks);
+  Apto::Array<int> reaction_count(num_reactions);
+  Apto::Array<double> resource_count(num_resources);
+  Apto::Array<double> rbins_count(num_resources);
+  task_count.SetAll(0);
+  reaction_count.SetAll(0);
+  resource_count.SetAll(0.0);
+  rbins_count.SetAll(0.0);
+
+  const int iterations = Iterations(200000);
+  const double start = cUpdateProfiler::Now();
+  for (int i = 0; i < iterations; i++) {
+    output.Add(values[i % num_outputs]);
+    cTaskContext taskctx(NULL, inputs, output, other_inputs, other_outputs, ext_mem);
+    env.TestOutput(ctx, result, taskctx, task_count, reaction_count, resource_count, rbins_count);
+    result.Invalidate();
+  }
+  ReportResult("environment.test_output", iterations, cUpdateProfiler::Now() - start, "outputs", iterations);
+}
+
+
+int main(int argc, char * argv[])
+{
+  // Pull out the benchmark options, everything else is handed to the normal command line processing
+  int out_argc = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-bench-scale") == 0 && i + 1 < argc) s_scale = cString(argv[++i]).AsDouble();
+    else if (strcmp(argv[i], "-bench-only") == 0 && i + 1 < argc) s_only = argv[++i];
+    else argv[out_argc++] = argv[i];
+  }
+  argc = out_argc;
+
+  Avida::Initialize();
+
+  bool failed = false;
+  for (int case_id = 0; case_id < NUM_HARDWARE_CASES; case_id++) {
+    const sHardwareCase& hw_case = HARDWARE_CASES[case_id];
+    const cString name = cString("hardware.") + hw_case.name;
+    // The data structure benchmarks only need a world with the default environment, they run in the heads one
+    const bool core_benches = (case_id == 0 && (IsSelected("testcpu") || IsSelected("systematics") ||
+                                                IsSelected("resource") || IsSelected("tasklib") ||
+                                                IsSelected("environment")));
+    if (!IsSelected(name) && !core_benches) continue;
+
+    if (!Apto::FileSystem::IsFile(Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), hw_case.inst_set_file))) {
+      ReportSkipped(name, cString("no_") + hw_case.inst_set_file);
+      continue;
+    }
+    if (!Apto::FileSystem::IsFile(Apto::FileSystem::PathAppend(Apto::FileSystem::GetCWD(), hw_case.ancestor_file))) {
+      ReportSkipped(name, cString("no_") + hw_case.ancestor_file);
+      continue;
+    }
+
+    cWorld* world = SetupWorld(argc, argv, hw_case.inst_set_file);
+    if (!world) {
+      ReportSkipped(name, "world_setup_failed");
+      failed = true;
+      continue;
+    }
+    // Owns the world from here on, and provides the feedback for loading the ancestor
+    Avida2Driver* driver = new Avida2Driver(world, world->GetNewWorld());
+
+    GenomePtr genome = Util::LoadGenomeDetailFile(hw_case.ancestor_file, world->GetWorkingDir(),
+                                                  world->GetHardwareManager(), driver->Feedback());
+    if (!genome) {
+      ReportSkipped(name, "ancestor_load_failed");
+      failed = true;
+    } else {
+      if (IsSelected(name)) BenchHardware(world, name, *genome);
+      if (core_benches) {
+        if (IsSelected("testcpu")) BenchTestCPU(world, *genome);
+        if (IsSelected("systematics")) BenchClassify(world, *genome);
+        if (IsSelected("resource")) BenchDiffusion(world);
+        if (IsSelected("tasklib") || IsSelected("environment")) BenchTasks(world);
+      }
+    }
+
+    delete driver;
+  }
+
+  return (failed) ? 1 : 0;
+}
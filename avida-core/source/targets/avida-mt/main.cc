@@ -0,0 +1,133 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "apto/core/FileSystem.h"
+#include "apto/core/Thread.h"
+#include "avida/Avida.h"
+#include "avida/core/World.h"
+#include "avida/util/CmdLine.h"
+
+#include "cAvidaConfig.h"
+#include "cThreadedMultiWorld.h"
+#include "cUserFeedback.h"
+
+#include "Avida2Driver.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+
+// Runs one world of the universe to completion, then releases any neighbors waiting on it
+class cWorldThread : public Apto::Thread
+{
+private:
+  Avida2Driver* m_driver;
+  cThreadedUniverse& m_universe;
+  int m_index;
+
+  void Run()
+  {
+    m_driver->Run();
+    m_universe.Finished(m_index);
+  }
+
+public:
+  cWorldThread(Avida2Driver* driver, cThreadedUniverse& universe, int index)
+    : m_driver(driver), m_universe(universe), m_index(index) { ; }
+};
+
+
+int main(int argc, char * argv[])
+{
+  Avida::Initialize();
+
+  cout << Avida::Version::Banner() << endl;
+
+  // The first configuration determines the size of the universe, each world then parses its own copy
+  Apto::Map<Apto::String, Apto::String> defs;
+  cAvidaConfig* first_cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(argc, argv, first_cfg, defs);
+
+  const int num_worlds = first_cfg->MP_NUM_WORLDS.Get();
+  if (num_worlds < 1) {
+    cerr << "error: MP_NUM_WORLDS must be at least 1" << endl;
+    return -1;
+  }
+  if (first_cfg->ANALYZE_MODE.Get() > 0) {
+    cerr << "error: analyze mode is not supported by avida-mt, use avida" << endl;
+    return -1;
+  }
+
+  cThreadedUniverse universe(num_worlds);
+  Apto::Array<Avida2Driver*> drivers(num_worlds);
+
+  for (int i = 0; i < num_worlds; i++) {
+    cAvidaConfig* cfg = first_cfg;
+    if (i > 0) {
+      cfg = new cAvidaConfig();
+      Apto::Map<Apto::String, Apto::String> world_defs;
+      Avida::Util::ProcessCmdLineArgs(argc, argv, cfg, world_defs);
+
+      // Only the first world reports progress, the others would interleave on the same console
+      cfg->VERBOSITY.Set(VERBOSE_SILENT);
+    }
+
+    cfg->RANDOM_SEED.Set(i + cfg->RANDOM_SEED.Get());
+    ostringstream dirname;
+    dirname << cfg->DATA_DIR.Get() << "_" << i;
+    cfg->DATA_DIR.Set(dirname.str().c_str());
+
+    cUserFeedback feedback;
+    Avida::World* new_world = new Avida::World();
+    cWorld* world = cThreadedMultiWorld::Initialize(cfg, cString(Apto::FileSystem::GetCWD()), new_world, universe, i,
+                                                    &feedback, &defs);
+
+    for (int m = 0; m < feedback.GetNumMessages(); m++) {
+      switch (feedback.GetMessageType(m)) {
+        case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+        case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+        default: break;
+      };
+      cerr << feedback.GetMessage(m) << endl;
+    }
+
+    if (!world) return -1;
+
+    cout << "World " << i << ": Random Seed " << cfg->RANDOM_SEED.Get() << ", Data Directory " << cfg->DATA_DIR.Get() << endl;
+
+    drivers[i] = new Avida2Driver(world, new_world);
+  }
+
+  cout << endl;
+
+  Apto::Array<cWorldThread*> threads(num_worlds);
+  for (int i = 0; i < num_worlds; i++) {
+    threads[i] = new cWorldThread(drivers[i], universe, i);
+    threads[i]->Start();
+  }
+  for (int i = 0; i < num_worlds; i++) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+
+  return 0;
+}
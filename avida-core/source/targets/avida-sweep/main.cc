@@ -0,0 +1,194 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "apto/core/FileSystem.h"
+#include "avida/Avida.h"
+#include "avida/core/World.h"
+#include "avida/util/CmdLine.h"
+
+#include "cAvidaConfig.h"
+#include "cHardwareManager.h"
+#include "cInitFile.h"
+#include "cStringUtil.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+
+#include "Avida2Driver.h"
+
+#include <ctime>
+#include <iostream>
+#include <sstream>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+// avida-sweep <job file> <max processes> [avida options]
+//
+// Each line of the job file is one run, given as pairs of avida.cfg settings (NAME VALUE ...) applied on top of the
+// configuration from the command line.  The configuration is parsed and the instruction libraries are built once, then
+// every run is a forked copy of this process.  Unless a job sets them, RANDOM_SEED is offset by the job number and
+// DATA_DIR gets a _<job> suffix.
+
+
+// Child side: apply the job's settings, then run the world to completion.  Never returns.
+static void RunJob(cAvidaConfig* cfg, Apto::Map<Apto::String, Apto::String>& defs, int job_id, cString settings)
+{
+  cfg->VERBOSITY.Set(VERBOSE_SILENT);
+  cfg->RANDOM_SEED.Set(job_id + cfg->RANDOM_SEED.Get());
+  ostringstream dirname;
+  dirname << cfg->DATA_DIR.Get() << "_" << job_id;
+  cfg->DATA_DIR.Set(dirname.str().c_str());
+
+  while (settings.GetSize()) {
+    cString name = settings.PopWord();
+    cString value = settings.PopWord();
+    if (!cfg->Set(name, value)) {
+      cerr << "error: job " << job_id << ": unknown setting '" << name << "'" << endl;
+      _exit(-1);
+    }
+  }
+
+  cUserFeedback feedback;
+  Avida::World* new_world = new Avida::World();
+  cWorld* world = cWorld::Initialize(cfg, cString(Apto::FileSystem::GetCWD()), new_world, &feedback, &defs);
+
+  for (int i = 0; i < feedback.GetNumMessages(); i++) {
+    if (feedback.GetMessageType(i) != cUserFeedback::UF_ERROR) continue;
+    cerr << "error: job " << job_id << ": " << feedback.GetMessage(i) << endl;
+  }
+  if (!world) _exit(-1);
+
+  // Exits the process when the run ends
+  (new Avida2Driver(world, new_world))->Run();
+  _exit(0);
+}
+
+
+// Parent side: wait for any running job to finish and report it.  Returns false if the job failed.
+static bool ReapJob(Apto::Array<pid_t>& pids, const Apto::Array<cString>& data_dirs)
+{
+  int status = 0;
+  const pid_t pid = wait(&status);
+  if (pid < 0) return false;
+
+  for (int job_id = 0; job_id < pids.GetSize(); job_id++) {
+    if (pids[job_id] != pid) continue;
+    pids[job_id] = 0;
+    cout << "job " << job_id << " (" << data_dirs[job_id] << "): ";
+    break;
+  }
+  if (WIFEXITED(status)) cout << "exit " << WEXITSTATUS(status) << endl;
+  else if (WIFSIGNALED(status)) cout << "signal " << WTERMSIG(status) << endl;
+  else cout << "unknown status" << endl;
+
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+
+int main(int argc, char * argv[])
+{
+  if (argc < 3) {
+    cerr << "usage: " << argv[0] << " <job file> <max processes> [avida options]" << endl;
+    return -1;
+  }
+  const cString job_filename(argv[1]);
+  const int max_procs = cString(argv[2]).AsInt();
+  if (max_procs < 1) {
+    cerr << "error: max processes must be at least 1" << endl;
+    return -1;
+  }
+
+  // Everything after the sweep arguments is handed to the normal command line processing
+  argv[2] = argv[0];
+  argc -= 2;
+  argv += 2;
+
+  Avida::Initialize();
+
+  cout << Avida::Version::Banner() << endl;
+
+  Apto::Map<Apto::String, Apto::String> defs;
+  cAvidaConfig* cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(argc, argv, cfg, defs);
+  if (cfg->ANALYZE_MODE.Get() > 0) {
+    cerr << "error: analyze mode is not supported by avida-sweep, use avida" << endl;
+    return -1;
+  }
+
+  cInitFile job_file(job_filename, cString(Apto::FileSystem::GetCWD()));
+  if (!job_file.WasOpened()) {
+    cerr << "error: unable to open job file '" << job_filename << "'" << endl;
+    return -1;
+  }
+
+  // Time based seeds would be drawn in the same second by many children, so pick the base seed once here
+  if (cfg->RANDOM_SEED.Get() <= 0) cfg->RANDOM_SEED.Set((int)time(NULL));
+
+  // Shared by every child through copy-on-write
+  cHardwareManager::SetupInstLibs();
+
+  const int num_jobs = job_file.GetNumLines();
+  Apto::Array<pid_t> pids(num_jobs);
+  pids.SetAll(0);
+  Apto::Array<cString> data_dirs(num_jobs);
+  int running = 0;
+  int failed = 0;
+
+  for (int job_id = 0; job_id < num_jobs; job_id++) {
+    // Wait for a slot
+    for (; running >= max_procs; running--) {
+      if (!ReapJob(pids, data_dirs)) failed++;
+    }
+
+    const cString settings = job_file.GetLine(job_id);
+    data_dirs[job_id] = cStringUtil::Stringf("%s_%d", (const char*)cfg->DATA_DIR.Get(), job_id);
+    cString dir_setting = settings;
+    while (dir_setting.GetSize()) {
+      cString name = dir_setting.PopWord();
+      cString value = dir_setting.PopWord();
+      if (name == "DATA_DIR") data_dirs[job_id] = value;
+    }
+
+    // Anything still buffered would otherwise be written again by the child
+    cout.flush();
+    cerr.flush();
+    const pid_t pid = fork();
+    if (pid == 0) RunJob(cfg, defs, job_id, settings);
+    if (pid < 0) {
+      cerr << "error: unable to start job " << job_id << endl;
+      failed++;
+      continue;
+    }
+    pids[job_id] = pid;
+    running++;
+  }
+
+  for (; running > 0; running--) {
+    if (!ReapJob(pids, data_dirs)) failed++;
+  }
+
+  cout << num_jobs - failed << " of " << num_jobs << " jobs completed" << endl;
+
+  return (failed) ? 1 : 0;
+}
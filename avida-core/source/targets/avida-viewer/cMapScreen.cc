@@ -19,7 +19,8 @@ cMapScreen::cMapScreen(int _y_size, int _x_size, int _y_start,
   cScreen(_y_size, _x_size, _y_start, _x_start, in_info),
   x_size(in_pop.GetWorldX()),
   y_size(in_pop.GetWorldY()),
-  population(in_pop)
+  population(in_pop),
+  m_drawn_cols(0)
 {
   info.SetActiveCell( &(population.GetCell(0)) );
   CenterActiveCPU();
@@ -32,6 +33,7 @@ cMapScreen::~cMapScreen()
 void cMapScreen::Draw(cAvidaContext& ctx)
 {
   CenterActiveCPU();
+  m_drawn.SetAll(-1);
   Update(ctx);
  
 }
@@ -78,16 +80,37 @@ void cMapScreen::Update(cAvidaContext& ctx)
 
   info.SetupSymbolMaps(info.GetMapMode(), HasColors());
 
-  for (int y = 0; y < Height() - 1 && y < y_size; y++) {
-    Move(y, 0);
+  int num_rows = Height() - 1;
+  if (num_rows > y_size) num_rows = y_size;
+  int num_cols = (Width() - 2) / AVIDA_MAP_X_SPACING + 1;
+  if (num_cols > x_size) num_cols = x_size;
+  if (num_rows < 0 || num_cols < 0) num_rows = num_cols = 0;
+  if (m_drawn.GetSize() != num_rows * num_cols || m_drawn_cols != num_cols) {
+    m_drawn.Resize(num_rows * num_cols);
+    m_drawn.SetAll(-1);
+    m_drawn_cols = num_cols;
+  }
+
+  for (int y = 0; y < num_rows; y++) {
     int cur_y = (y + virtual_y) % y_size;
-    for (int x=0; (AVIDA_MAP_X_SPACING * x) < Width() - 1 && x < x_size; x++){
+    bool at_position = false;  // whether the cursor already sits where the next glyph goes
+    for (int x = 0; x < num_cols; x++) {
       int cur_x = (x + virtual_x) % x_size;
       int index = cur_y * x_size + cur_x;
 
+      const char symbol = (info.MapSymbol(index) > 0) ? info.MapSymbol(index) : CHAR_BULLET;
+      const int glyph = (static_cast<unsigned char>(symbol)) | (static_cast<unsigned char>(info.ColorSymbol(index)) << 8);
+      int& drawn = m_drawn[y * num_cols + x];
+      if (drawn == glyph) {
+        at_position = false;
+        continue;
+      }
+      drawn = glyph;
+
+      if (!at_position) Move(y, x * AVIDA_MAP_X_SPACING);
+      at_position = true;
       SetSymbolColor(info.ColorSymbol(index));
-      if (info.MapSymbol(index) > 0) Print(info.MapSymbol(index));
-      else Print(CHAR_BULLET);
+      Print(symbol);
 
       // Skip spaces before the next map symbol
       for (int i = 0; i < AVIDA_MAP_X_SPACING - 1; i++)  Print(' ');
@@ -23,6 +23,10 @@ private:
   int corner_id;
   cPopulation & population;
 
+  // Glyph (symbol and color) last written to each map position, -1 where unknown; unchanged positions are skipped
+  Apto::Array<int> m_drawn;
+  int m_drawn_cols;
+
   // Private Methods...
   void CenterActiveCPU();
   void CenterXCoord();
@@ -38,6 +42,7 @@ public:
   void Draw(cAvidaContext& ctx);
   void Update(cAvidaContext& ctx);
   void DoInput(cAvidaContext& ctx, int in_char);
+  void ClearMain() { m_drawn.SetAll(-1); cScreen::ClearMain(); }
 
   // Virtual in map screen.
   void Navigate(cAvidaContext& ctx);
@@ -20,6 +20,8 @@
 
 #include "cTextViewerDriver_Base.h"
 
+#include "avida/output/Manager.h"
+
 #include "cAnalyze.h"
 #include "cString.h"
 #include "cStringList.h"
@@ -40,6 +42,8 @@ cTextViewerDriver_Base::~cTextViewerDriver_Base()
 
 void cTextViewerDriver_Base::Abort(AbortCondition condition)
 {
+  // exit() skips the world teardown, so push any asynchronously buffered output to disk first
+  Avida::Output::Manager::Of(m_world->GetNewWorld())->FlushAll();
   exit(condition);
 }
 
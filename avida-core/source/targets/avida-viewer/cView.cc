@@ -37,13 +37,28 @@
 # include <process.h>
 # define kill(x, y)
 #else
+# include <sys/time.h>
 # include <unistd.h>
 #endif
 
 using namespace std;
 
 
-cView::cView(cWorld* world, cTextViewerDriver_Base* driver) : info(world, this)
+// Wall clock milliseconds; redraws are never rate limited where no clock is available
+static double CurrentTimeMS()
+{
+#if APTO_PLATFORM(WINDOWS)
+  return 0.0;
+#else
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+
+cView::cView(cWorld* world, cTextViewerDriver_Base* driver)
+  : info(world, this), m_refresh_ms(world->GetConfig().VIEW_REFRESH_MS.Get()), m_last_refresh_ms(0.0)
 {
   Setup(world->GetDefaultContext(), "Avida");
 
@@ -129,6 +144,16 @@ void cView::NewUpdate(cAvidaContext& ctx)
 
 void cView::NotifyUpdate(cAvidaContext& ctx)
 {
+  // Between redraws, keep the run responsive to keypresses without repainting
+  if (m_refresh_ms > 0 && info.GetPauseLevel() == PAUSE_OFF) {
+    const double now = CurrentTimeMS();
+    if (now >= m_last_refresh_ms && now - m_last_refresh_ms < m_refresh_ms) {
+      DoInputs(ctx);
+      return;
+    }
+    m_last_refresh_ms = now;
+  }
+
   bar_screen->Update(ctx);
   info.UpdateSymbols();
 
@@ -54,6 +54,10 @@ private:
   cEnvironmentScreen * environment_screen;
   cAnalyzeScreen * analyze_screen;
 
+  // Redraw rate limiting (VIEW_REFRESH_MS)
+  int m_refresh_ms;
+  double m_last_refresh_ms;
+
   // Window managing functions...
 
   void TogglePause(cAvidaContext& ctx);
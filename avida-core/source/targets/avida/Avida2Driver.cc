@@ -26,6 +26,8 @@
 
 #include "avida/core/Context.h"
 #include "avida/core/World.h"
+#include "avida/data/Manager.h"
+#include "avida/output/Manager.h"
 #include "avida/systematics/Group.h"
 
 #include "cAnalyze.h"
@@ -36,6 +38,7 @@
 #include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cStats.h"
+#include "cUpdateProfiler.h"
 #include "cWorld.h"
 
 #include <cstdio>
@@ -80,26 +83,38 @@ void Avida2Driver::Run()
                                 m_world->GetConfig().DIV_LGT_PROB.Get();
   
   void (cPopulation::*ActiveProcessStep)(cAvidaContext& ctx, double step_size, int cell_id) = &cPopulation::ProcessStep;
-  if (m_world->GetConfig().SPECULATIVE.Get() &&
-      m_world->GetConfig().THREAD_SLICING_METHOD.Get() != 1 && !m_world->GetConfig().IMPLICIT_REPRO_END.Get() && point_mut_prob == 0.0) {
-    ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
-  }
+  // Hardware that cannot speculate safely in the current configuration (implicit reproduction, multiple threads under
+  // parallel slicing) declines per organism, so speculation does not have to be switched off for the whole run.
+  if (m_world->GetConfig().SPECULATIVE.Get()) ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
   
   cAvidaContext& ctx = m_world->GetDefaultContext();
   Avida::Context new_ctx(this, &m_world->GetRandom());
   
+  // NULL unless PROFILE_UPDATES or PRINT_RUN_TIMINGS is set, in which case the scopes below time each phase
+  cUpdateProfiler* profiler = m_world->GetProfiler();
+  const double run_start = (profiler) ? cUpdateProfiler::Now() : 0.0;
+  
+  if (m_world->GetConfig().PIPELINED_RECORDING.Get()) m_world->GetDataManager()->SetPipelinedRecording(true);
+  
   while (!m_done) {
-    m_world->GetEvents(ctx);
+    {
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::EVENTS);
+      m_world->GetEvents(ctx);
+    }
     if(m_done == true) break;
     
     // Increment the Update.
     stats.IncCurrentUpdate();
     
-    population.ProcessPreUpdate();
+    {
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::PRE_UPDATE);
+      population.ProcessPreUpdate();
+    }
 
     // Handle all data collection for previous update.
     if (stats.GetUpdate() > 0) {
       // Tell the stats object to do update calculations and printing.
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::STATS);
       stats.ProcessUpdate();
     }
     
@@ -108,17 +123,43 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
-    for (int i = 0; i < UD_size; i++) {
-      if(population.GetNumOrganisms() == 0) {
-        break;
+    if (population.HasParallelDemes()) {
+      // Every deme runs its own share of the update; the CompeteDemes/ReplicateDemes events run between updates
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::EXECUTE);
+      population.ProcessDemesParallel(UD_size);
+    } else if (population.GetScheduleBatchSize() > 1) {
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::EXECUTE);
+      
+      // Batched scheduling, each decision runs several consecutive cycles of a single organism
+      for (int i = 0; i < UD_size;) {
+        if (population.GetNumOrganisms() == 0) break;
+        int num_cycles = 1;
+        const int cell_id = population.ScheduleOrganism(num_cycles);
+        if (num_cycles > UD_size - i) num_cycles = UD_size - i;
+        i += population.ProcessSteps(ctx, step_size, cell_id, num_cycles);
+      }
+    } else {
+      // Pre-execute the tiles on the worker threads; the serial pass below consumes the speculated cycles
+      if (ActiveProcessStep == &cPopulation::ProcessStepSpeculative && population.HasParallelTiles()) {
+        cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::TILES);
+        population.PreExecuteTiles();
+      }
+      
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::EXECUTE);
+      for (int i = 0; i < UD_size; i++) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
       }
-      (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
     }
     
     // end of update stats...
-    population.ProcessPostUpdate(ctx);
-    
-		m_world->ProcessPostUpdate(ctx);
+    {
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::POST_UPDATE);
+      population.ProcessPostUpdate(ctx);
+      m_world->ProcessPostUpdate(ctx);
+    }
         
     // No viewer; print out status for this update....
     if (m_world->GetVerbosity() > VERBOSE_SILENT) {
@@ -145,25 +186,32 @@ void Avida2Driver::Run()
     
     // Do Point Mutations
     if (point_mut_prob > 0 ) {
-      for (int i = 0; i < population.GetSize(); i++) {
-        if (population.GetCell(i).IsOccupied()) {
-          int num_mut = population.GetCell(i).GetOrganism()->GetHardware().PointMutate(ctx);
-          population.GetCell(i).GetOrganism()->IncPointMutations(num_mut);
-        }
-      }
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::POINT_MUTATIONS);
+      population.ProcessPointMutations(ctx);
     }
     
-    m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
+    {
+      cUpdateProfiler::cScope scope(profiler, cUpdateProfiler::WORLD_UPDATE);
+      m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
+    }
+    if (profiler) profiler->FinishUpdate(stats);
     
     // Exit conditons...
     if((population.GetNumOrganisms()==0) && m_world->AllowsEarlyExit()) {
 			m_done = true;
 		}
   }
+  
+  // Let the recorders of the final update finish before the world is torn down
+  m_world->GetDataManager()->WaitForRecorders();
+  
+  if (m_world->GetConfig().PRINT_RUN_TIMINGS.Get()) profiler->PrintSummary(cout, cUpdateProfiler::Now() - run_start);
 }
 
 void Avida2Driver::Abort(Avida::AbortCondition condition)
 {
+  // exit() skips the world teardown, so push any asynchronously buffered output to disk first
+  Output::Manager::Of(m_new_world)->FlushAll();
   exit(condition);
 }
 
@@ -308,6 +308,12 @@ protected:
     ReportTestResult("Chained Bitwise Operations", ((~ba & ~ba2).CountBits() == 31));
     ReportTestResult("++operator", ((++(~ba & ~ba2)).CountBits() == 30));
     ReportTestResult("operator++", (((~ba & ~ba2)++).CountBits() == 31));
+    ReportTestResult("CountAND", (ba.CountAND(ba2) == 8));
+    ReportTestResult("CountOR", (ba.CountOR(ba2) == 43));
+    ReportTestResult("HammingDistance", (ba.HammingDistance(ba2) == 35));
+    ReportTestResult("IsSubsetOf", ((ba & ba2).IsSubsetOf(ba) && !ba.IsSubsetOf(ba2)));
+    ReportTestResult("FindBit1 (across bit fields)", (ba.FindBit1(69) == 73 && ba.FindBit1(74) == -1));
+    ReportTestResult("GetOnes", (ba.GetOnes().GetSize() == 15 && ba.GetOnes()[14] == 73));
   }
 };
 
@@ -6,7 +6,7 @@ void cRawBitArray::Copy(const cRawBitArray & in_array, const int num_bits)
   if (bit_fields != NULL) {
     delete [] bit_fields;
   }
-  bit_fields = new unsigned int[num_fields];
+  bit_fields = new tField[num_fields];
   for (int i = 0; i < num_fields; i++) {
     bit_fields[i] = in_array.bit_fields[i];
   }
@@ -29,30 +29,17 @@ void cRawBitArray::Resize(const int old_bits, const int new_bits)
   const int num_new_fields = GetNumFields(new_bits);
   if (num_old_fields == num_new_fields) {
     // Clear all bits past the new end and stop.
-    unsigned int & last_field = bit_fields[num_new_fields - 1];
-    for (int i = new_bits; i < old_bits; i++) {
-      const unsigned int clear_bit = i & 31;
-      last_field &= ~(1 << clear_bit);
-    }
+    if (new_bits < old_bits) ClearExcess(new_bits);
     return;
   }
 
   // If we made it this far, we have to change the number of fields.
   // Create the new bit array and copy the old one into it.
-  unsigned int * new_bit_fields = new unsigned int[ num_new_fields ];
+  tField * new_bit_fields = new tField[ num_new_fields ];
   for (int i = 0; i < num_new_fields && i < num_old_fields; i++) {
     new_bit_fields[i] = bit_fields[i];
   }
   
-  // If the old bits are longer, we need to clear the end of the last
-  // bit field.
-  if (num_old_fields > num_new_fields) {
-    unsigned int & last_field = new_bit_fields[num_new_fields - 1];
-    for (int clear_bit=GetFieldPos(new_bits); clear_bit < 32; clear_bit++) {
-      last_field &= ~(1 << clear_bit);
-    }
-  }
-  
   // If the new bits are longer, clear everything past the end of the old
   // bits.
   for (int i = num_old_fields; i < num_new_fields; i++) {
@@ -63,6 +50,10 @@ void cRawBitArray::Resize(const int old_bits, const int new_bits)
     delete [] bit_fields;
   }
   bit_fields = new_bit_fields;
+
+  // If the old bits are longer, we need to clear the end of the last
+  // bit field.
+  if (num_old_fields > num_new_fields) ClearExcess(new_bits);
 }
 
 
@@ -72,7 +63,7 @@ void cRawBitArray::ResizeSloppy(const int new_bits)
   if (bit_fields != NULL) {
     delete [] bit_fields;
   }
-  bit_fields = new unsigned int[ new_fields ];
+  bit_fields = new tField[ new_fields ];
 }
 
 void cRawBitArray::ResizeClear(const int new_bits)
@@ -82,56 +73,56 @@ void cRawBitArray::ResizeClear(const int new_bits)
 }
 
 
-// This technique counts the number of bits; it loops through once for each
-// bit equal to 1.  This is reasonably fast for sparse arrays.
+// Both counting techniques now reduce to one population count per field; CountBits2 is kept for existing callers.
 int cRawBitArray::CountBits(const int num_bits) const
 {
   const int num_fields = GetNumFields(num_bits);
   int bit_count = 0;
   
   for (int i = 0; i < num_fields; i++) {
-    int temp = bit_fields[i];
-    while (temp != 0) {
-      temp = temp & (temp - 1);
-      bit_count++;
-    }
+    if (bit_fields[i] != 0) bit_count += CountField(bit_fields[i]);
   }
   return bit_count;
 }
 
-// This technique is another way of counting bits; It does a bunch of
-// clever bit tricks to do it in parallel in each int.
 int cRawBitArray::CountBits2(const int num_bits) const
 {
   const int num_fields = GetNumFields(num_bits);
   int bit_count = 0;
   
   for (int i = 0; i < num_fields; i++) {
-    const int  v = bit_fields[i];
-    unsigned int const t1 = v - ((v >> 1) & 0x55555555);
-    unsigned int const t2 = (t1 & 0x33333333) + ((t1 >> 2) & 0x33333333);
-    bit_count += ((t2 + (t2 >> 4) & 0xF0F0F0F) * 0x1010101) >> 24;
+    bit_count += CountField(bit_fields[i]);
   }
   return bit_count;
 }
 
 int cRawBitArray::FindBit1(const int num_bits, const int start_pos) const
 {
-  // @CAO -- There are probably better ways to do this with bit tricks.
-  for (int i = start_pos; i < num_bits; i++) {
-    if (GetBit(i) == true) return i;
+  if (start_pos >= num_bits) return -1;
+  const int num_fields = GetNumFields(num_bits);
+  int field_id = GetField(start_pos);
+
+  // Mask off the bits before start_pos in the first field, then skip empty fields a word at a time
+  tField field = bit_fields[field_id] & (~tField(0) << GetFieldPos(start_pos));
+  while (field == 0) {
+    if (++field_id >= num_fields) return -1;
+    field = bit_fields[field_id];
   }
 
-  return -1;
+  return (field_id << 6) + LowestBit(field);
 }
 
 Apto::Array<int> cRawBitArray::GetOnes(const int num_bits) const
 {
-  // @CAO -- There are probably better ways to do this with bit tricks.
   Apto::Array<int> out_array(CountBits2(num_bits));
+  const int num_fields = GetNumFields(num_bits);
   int cur_pos = 0;
-  for (int i = 0; i < num_bits; i++) {
-    if (GetBit(i) == true) out_array[cur_pos++] = i;
+  for (int i = 0; i < num_fields; i++) {
+    tField field = bit_fields[i];
+    while (field != 0) {
+      out_array[cur_pos++] = (i << 6) + LowestBit(field);
+      field &= field - 1;
+    }
   }
 
   return out_array;
@@ -140,12 +131,12 @@ Apto::Array<int> cRawBitArray::GetOnes(const int num_bits) const
 void cRawBitArray::ShiftLeft(const int num_bits, const int shift_size)
 {
   assert(shift_size > 0);
-  int num_fields = GetNumFields(num_bits);
-  int field_shift = shift_size / 32;
-  int bit_shift = shift_size % 32;
-  
+  if (shift_size >= num_bits) { Zero(num_bits); return; }
+  const int num_fields = GetNumFields(num_bits);
+  const int field_shift = shift_size >> 6;
+  const int bit_shift = shift_size & 63;
   
-  // acount for field_shift
+  // account for field_shift
   if (field_shift) {
     for (int i = num_fields - 1; i >= field_shift; i--) {
       bit_fields[i] = bit_fields[i - field_shift];
@@ -155,29 +146,26 @@ void cRawBitArray::ShiftLeft(const int num_bits, const int shift_size)
     }
   }
   
-  
-  // account for bit_shift
-  int temp = 0;
-  for (int i = 0; i < num_fields; i++) {
-    temp = bit_fields[i] >> (32 - bit_shift);
-    bit_fields[i] <<= bit_shift;
-    if (i > 0) bit_fields[i - 1] |= temp;  // same as += in this case since lower bit_shift bits of bit_fields[i - 1] are all 0 at this point -- any advantage?  
-    //could also check for temp != 0 here before assignment -- would that save any time for sparse arrays, or is it always going to be useless?
+  // account for bit_shift, carrying the high bits of each field into the next one up
+  if (bit_shift) {
+    for (int i = num_fields - 1; i > 0; i--) {
+      bit_fields[i] = (bit_fields[i] << bit_shift) | (bit_fields[i - 1] >> (64 - bit_shift));
+    }
+    bit_fields[0] <<= bit_shift;
   }
   
   // mask out any bits that have left-shifted away, allowing CountBits and CountBits2 to work
-  // blw: if CountBits/CountBits2 are fixed, this code should be removed as it will be redundant
-  unsigned int shift_mask = 0xFFFFFFFF >> ((32 - (num_bits % 32)) & 0x1F);
-  bit_fields[num_fields - 1] &= shift_mask;
+  ClearExcess(num_bits);
 }
 
 // ALWAYS shifts in zeroes, irrespective of sign bit (since fields are unsigned)
 void cRawBitArray::ShiftRight(const int num_bits, const int shift_size)
 {
   assert(shift_size > 0);
-  int num_fields = GetNumFields(num_bits);
-  int field_shift = shift_size / 32;
-  int bit_shift = shift_size % 32;
+  if (shift_size >= num_bits) { Zero(num_bits); return; }
+  const int num_fields = GetNumFields(num_bits);
+  const int field_shift = shift_size >> 6;
+  const int bit_shift = shift_size & 63;
   
   // account for field_shift
   if (field_shift) {
@@ -189,13 +177,81 @@ void cRawBitArray::ShiftRight(const int num_bits, const int shift_size)
     }
   }
   
-  // account for bit_shift
-  bit_fields[num_fields - 1] >>= bit_shift;  // drops off right end, may shift in ones if sign bit was set
-  int temp = 0;
-  for (int i = num_fields - 2; i >= 0; i--) {
-    temp = bit_fields[i] << (32 - bit_shift);
-    bit_fields[i] >>= bit_shift;
-    bit_fields[i + 1] |= temp;
+  // account for bit_shift, carrying the low bits of each field into the next one down
+  if (bit_shift) {
+    for (int i = 0; i < num_fields - 1; i++) {
+      bit_fields[i] = (bit_fields[i] >> bit_shift) | (bit_fields[i + 1] << (64 - bit_shift));
+    }
+    bit_fields[num_fields - 1] >>= bit_shift;
+  }
+}
+
+int cRawBitArray::CountAND(const cRawBitArray & array2, const int num_bits) const
+{
+  const int num_fields = GetNumFields(num_bits);
+  int bit_count = 0;
+  for (int i = 0; i < num_fields; i++) {
+    bit_count += CountField(bit_fields[i] & array2.bit_fields[i]);
+  }
+  return bit_count;
+}
+
+int cRawBitArray::CountOR(const cRawBitArray & array2, const int num_bits) const
+{
+  const int num_fields = GetNumFields(num_bits);
+  int bit_count = 0;
+  for (int i = 0; i < num_fields; i++) {
+    bit_count += CountField(bit_fields[i] | array2.bit_fields[i]);
+  }
+  return bit_count;
+}
+
+int cRawBitArray::CountXOR(const cRawBitArray & array2, const int num_bits) const
+{
+  const int num_fields = GetNumFields(num_bits);
+  int bit_count = 0;
+  for (int i = 0; i < num_fields; i++) {
+    bit_count += CountField(bit_fields[i] ^ array2.bit_fields[i]);
+  }
+  return bit_count;
+}
+
+bool cRawBitArray::IsSubsetOf(const cRawBitArray & array2, const int num_bits) const
+{
+  const int num_fields = GetNumFields(num_bits);
+  for (int i = 0; i < num_fields; i++) {
+    if (bit_fields[i] & ~array2.bit_fields[i]) return false;
+  }
+  return true;
+}
+
+void cRawBitArray::ANDNOT(const cRawBitArray & array2, const int num_bits)
+{
+  const int num_fields = GetNumFields(num_bits);
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] &= ~array2.bit_fields[i];
+  }
+}
+
+void cRawBitArray::AND(const cRawBitArray & array1, const cRawBitArray & array2, const cRawBitArray & array3,
+                       const int num_bits)
+{
+  ResizeSloppy(num_bits);
+
+  const int num_fields = GetNumFields(num_bits);
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] = array1.bit_fields[i] & array2.bit_fields[i] & array3.bit_fields[i];
+  }
+}
+
+void cRawBitArray::OR(const cRawBitArray & array1, const cRawBitArray & array2, const cRawBitArray & array3,
+                      const int num_bits)
+{
+  ResizeSloppy(num_bits);
+
+  const int num_fields = GetNumFields(num_bits);
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] = array1.bit_fields[i] | array2.bit_fields[i] | array3.bit_fields[i];
   }
 }
 
@@ -206,10 +262,7 @@ void cRawBitArray::NOT(const int num_bits)
     bit_fields[i] = ~bit_fields[i];
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::AND(const cRawBitArray & array2, const int num_bits)
@@ -235,10 +288,7 @@ void cRawBitArray::NAND(const cRawBitArray & array2, const int num_bits)
     bit_fields[i] = ~(bit_fields[i] & array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::NOR(const cRawBitArray & array2, const int num_bits)
@@ -248,10 +298,7 @@ void cRawBitArray::NOR(const cRawBitArray & array2, const int num_bits)
     bit_fields[i] = ~(bit_fields[i] | array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::XOR(const cRawBitArray & array2, const int num_bits)
@@ -270,10 +317,7 @@ void cRawBitArray::EQU(const cRawBitArray & array2, const int num_bits)
     bit_fields[i] = ~(bit_fields[i] ^ array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::SHIFT(const int num_bits, const int shift_size)
@@ -294,10 +338,7 @@ void cRawBitArray::INCREMENT(const int num_bits)
   }
   
   // if highest bit field was incremented, mask out any unused portions of the field so as not to confuse CountBits
-  if (i == num_fields - 1) {
-    unsigned int shift_mask = 0xffffffff >> (32 - (num_bits % 32));
-    bit_fields[num_fields - 1] &= shift_mask;
-  }
+  if (i == num_fields - 1) ClearExcess(num_bits);
 }
 
 
@@ -313,10 +354,7 @@ void cRawBitArray::NOT(const cRawBitArray & array1, const int num_bits)
     bit_fields[i] = ~array1.bit_fields[i];
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::AND(const cRawBitArray & array1,
@@ -351,10 +389,7 @@ void cRawBitArray::NAND(const cRawBitArray & array1,
     bit_fields[i] = ~(array1.bit_fields[i] & array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::NOR(const cRawBitArray & array1,
@@ -367,10 +402,7 @@ void cRawBitArray::NOR(const cRawBitArray & array1,
     bit_fields[i] = ~(array1.bit_fields[i] | array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::XOR(const cRawBitArray & array1,
@@ -394,10 +426,7 @@ void cRawBitArray::EQU(const cRawBitArray & array1, const cRawBitArray & array2,
     bit_fields[i] = ~(array1.bit_fields[i] ^ array2.bit_fields[i]);
   }
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearExcess(num_bits);
 }
 
 void cRawBitArray::SHIFT(const cRawBitArray & array1, const int num_bits, const int shift_size)
@@ -92,16 +92,28 @@ using namespace std;
 
 class cRawBitArray {
 private:
-  unsigned int * bit_fields;
+  // Bits are kept in 64-bit fields so that the whole-array operations below touch half as many words, and the simple
+  // per-field loops are left in a form the compiler can vectorize.  Bits past num_bits in the last field are kept 0.
+  typedef unsigned long long tField;
+  tField * bit_fields;
   
   // Disallow default copy constructor and operator=
   // (we need to know the number of bits we're working with!)
   cRawBitArray(const cRawBitArray&);
   const cRawBitArray & operator=(const cRawBitArray&);
 
-  inline int GetNumFields(const int num_bits) const { return 1 + ((num_bits - 1) >> 5); }
-  inline int GetField(const int index) const { return index >> 5; }
-  inline int GetFieldPos(const int index) const { return index & 31; }
+  inline int GetNumFields(const int num_bits) const { return 1 + ((num_bits - 1) >> 6); }
+  inline int GetField(const int index) const { return index >> 6; }
+  inline int GetFieldPos(const int index) const { return index & 63; }
+
+  // Mask of the bits of the last field that are in use
+  inline tField LastFieldMask(const int num_bits) const
+    { const int last_bit = GetFieldPos(num_bits); return (last_bit > 0) ? ((tField(1) << last_bit) - 1) : ~tField(0); }
+  inline void ClearExcess(const int num_bits) { if (num_bits > 0) bit_fields[GetNumFields(num_bits) - 1] &= LastFieldMask(num_bits); }
+
+  static inline int CountField(tField field);
+  static inline int LowestBit(tField field);
+
 public:
   cRawBitArray() : bit_fields(NULL) { ; }
   ~cRawBitArray() {
@@ -120,17 +132,14 @@ public:
   void Ones(const int num_bits) {
     const int num_fields = GetNumFields(num_bits);
     for (int i = 0; i < num_fields; i++) {
-      bit_fields[i] = ~0;
+      bit_fields[i] = ~tField(0);
     }    
-    const int last_bit = GetFieldPos(num_bits);
-    if (last_bit > 0) {
-      bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-    }
+    ClearExcess(num_bits);
   }
 
   cRawBitArray(const int num_bits) {
     const int num_fields = GetNumFields(num_bits);
-    bit_fields = new unsigned int[ num_fields ];
+    bit_fields = new tField[ num_fields ];
     Zero(num_bits);
   }
 
@@ -150,13 +159,13 @@ public:
   bool GetBit(const int index) const{
     const int field_id = GetField(index);
     const int pos_id = GetFieldPos(index);
-    return (bit_fields[field_id] & (1 << pos_id)) != 0;
+    return (bit_fields[field_id] & (tField(1) << pos_id)) != 0;
   }
 
   void SetBit(const int index, const bool value) {
     const int field_id = GetField(index);
     const int pos_id = GetFieldPos(index);
-    const int pos_mask = 1 << pos_id;
+    const tField pos_mask = tField(1) << pos_id;
 
     if (value == false) {
       bit_fields[field_id] &= ~pos_mask;
@@ -171,7 +180,7 @@ public:
   void ResizeSloppy(const int new_bits);
   void ResizeClear(const int new_bits);
 
-  // Two different technique of bit counting...
+  // Two different technique of bit counting... (both now use the hardware population count where available)
   int CountBits(const int num_bits) const; // Better for sparse arrays
   int CountBits2(const int num_bits) const; // Better for dense arrays
 
@@ -181,6 +190,15 @@ public:
   void ShiftLeft(const int num_bits, const int shift_size); // Helper: call SHIFT with positive number instead
   void ShiftRight(const int num_bits, const int shift_size); // Helper: call SHIFT with negative number instead
 
+  // Fused operations, combining this array with another without building the intermediate array
+  int CountAND(const cRawBitArray & array2, const int num_bits) const;
+  int CountOR(const cRawBitArray & array2, const int num_bits) const;
+  int CountXOR(const cRawBitArray & array2, const int num_bits) const;  // Hamming distance
+  bool IsSubsetOf(const cRawBitArray & array2, const int num_bits) const;
+  void ANDNOT(const cRawBitArray & array2, const int num_bits);       // this = this & ~array2
+  void AND(const cRawBitArray & array1, const cRawBitArray & array2, const cRawBitArray & array3, const int num_bits);
+  void OR(const cRawBitArray & array1, const cRawBitArray & array2, const cRawBitArray & array3, const int num_bits);
+
   void Print(const int num_bits, ostream & out=cout) const {
     for (int i = 0; i < num_bits; i++) {
       out << GetBit(i);
@@ -233,6 +251,31 @@ public:
   void INCREMENT(const cRawBitArray & array1, const int num_bits);  // implemented for completeness, but unused by cBitArray
 };
 
+
+inline int cRawBitArray::CountField(tField field)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll(field);
+#else
+  field = field - ((field >> 1) & 0x5555555555555555ULL);
+  field = (field & 0x3333333333333333ULL) + ((field >> 2) & 0x3333333333333333ULL);
+  field = (field + (field >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int)((field * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int cRawBitArray::LowestBit(tField field)
+{
+  assert(field);
+#ifdef __GNUC__
+  return __builtin_ctzll(field);
+#else
+  int bit = 0;
+  while (!(field & 1)) { field >>= 1; bit++; }
+  return bit;
+#endif
+}
+
 class cBitArray {
 private:
   cRawBitArray bit_array;
@@ -309,6 +352,39 @@ public:
     { return bit_array.FindBit1(array_size, start_bit); }
   Apto::Array<int> GetOnes() const { return bit_array.GetOnes(array_size); }
 
+  // Fused operations; counts are taken directly without building the combined array
+  int CountAND(const cBitArray & array2) const
+    { assert(array_size == array2.array_size); return bit_array.CountAND(array2.bit_array, array_size); }
+  int CountOR(const cBitArray & array2) const
+    { assert(array_size == array2.array_size); return bit_array.CountOR(array2.bit_array, array_size); }
+  int CountXOR(const cBitArray & array2) const
+    { assert(array_size == array2.array_size); return bit_array.CountXOR(array2.bit_array, array_size); }
+  int HammingDistance(const cBitArray & array2) const { return CountXOR(array2); }
+  bool IsSubsetOf(const cBitArray & array2) const
+    { assert(array_size == array2.array_size); return bit_array.IsSubsetOf(array2.bit_array, array_size); }
+
+  cBitArray AND(const cBitArray & array2, const cBitArray & array3) const {
+    assert(array_size == array2.array_size && array_size == array3.array_size);
+    cBitArray out_array;
+    out_array.bit_array.AND(bit_array, array2.bit_array, array3.bit_array, array_size);
+    out_array.array_size = array_size;
+    return out_array;
+  }
+
+  cBitArray OR(const cBitArray & array2, const cBitArray & array3) const {
+    assert(array_size == array2.array_size && array_size == array3.array_size);
+    cBitArray out_array;
+    out_array.bit_array.OR(bit_array, array2.bit_array, array3.bit_array, array_size);
+    out_array.array_size = array_size;
+    return out_array;
+  }
+
+  const cBitArray & ANDNOTSELF(const cBitArray & array2) {
+    assert(array_size == array2.array_size);
+    bit_array.ANDNOT(array2.bit_array, array_size);
+    return *this;
+  }
+
   // Boolean math functions...
   cBitArray NOT() const {
     cBitArray out_array;
@@ -477,8 +553,8 @@ namespace Apto {
     static int Hash(const cBitArray& key)
     {
       unsigned int out_hash = 0;
-      for (int i = 0; i < key.GetSize(); i++) {
-        if (key.Get(i)) { out_hash += i*i; }
+      for (int i = key.FindBit1(0); i >= 0; i = key.FindBit1(i + 1)) {
+        out_hash += i*i;
       }
       return out_hash % HashFactor;
     }
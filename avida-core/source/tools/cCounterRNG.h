@@ -0,0 +1,119 @@
+/*
+ *  cCounterRNG.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCounterRNG_h
+#define cCounterRNG_h
+
+#include <cassert>
+
+
+// cCounterRNG - counter based random number generator (Philox4x32-10)
+// --------------------------------------------------------------------------------------------------------------
+//
+// Every draw is a pure function of (seed, update, cell, draw index), so a stream can be positioned anywhere without
+// replaying earlier draws.  Work that is split across threads can key each unit of work by its update and cell and
+// get the same numbers no matter which thread runs it or how many threads there are.
+
+class cCounterRNG
+{
+private:
+  unsigned int m_key[2];
+  unsigned int m_ctr[4];   // draw block, cell, update, unused
+  unsigned int m_buf[4];
+  int m_buf_pos;
+
+
+  static inline unsigned int mulhilo(unsigned int a, unsigned int b, unsigned int& hi)
+  {
+    const unsigned long long product = static_cast<unsigned long long>(a) * b;
+    hi = static_cast<unsigned int>(product >> 32);
+    return static_cast<unsigned int>(product);
+  }
+
+  inline void refill()
+  {
+    unsigned int c[4] = { m_ctr[0], m_ctr[1], m_ctr[2], m_ctr[3] };
+    unsigned int k0 = m_key[0];
+    unsigned int k1 = m_key[1];
+    for (int round = 0; round < 10; round++) {
+      unsigned int hi0, hi1;
+      const unsigned int lo0 = mulhilo(0xD2511F53u, c[0], hi0);
+      const unsigned int lo1 = mulhilo(0xCD9E8D57u, c[2], hi1);
+      c[0] = hi1 ^ c[1] ^ k0;
+      c[1] = lo1;
+      c[2] = hi0 ^ c[3] ^ k1;
+      c[3] = lo0;
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+    for (int i = 0; i < 4; i++) m_buf[i] = c[i];
+    m_buf_pos = 0;
+    m_ctr[0]++;
+  }
+
+
+public:
+  cCounterRNG(int seed = 0) { SetSeed(seed); }
+
+  void SetSeed(int seed)
+  {
+    m_key[0] = static_cast<unsigned int>(seed);
+    m_key[1] = 0x41564944u; // "AVID", keeps a zero seed away from the all zero key
+    SetStream(0, 0);
+  }
+
+  // Position the generator at the first draw of the (update, cell) stream
+  void SetStream(int update, int cell)
+  {
+    m_ctr[0] = 0;
+    m_ctr[1] = static_cast<unsigned int>(cell);
+    m_ctr[2] = static_cast<unsigned int>(update);
+    m_ctr[3] = 0;
+    m_buf_pos = 4;
+  }
+
+  // Number of draws taken from the current stream
+  unsigned int GetDrawIndex() const { return m_ctr[0] * 4 - (4 - m_buf_pos); }
+
+  unsigned int GetUInt32()
+  {
+    if (m_buf_pos == 4) refill();
+    return m_buf[m_buf_pos++];
+  }
+
+  // Uniform in [0, max) and [min, max)
+  unsigned int GetUInt(unsigned int max)
+  {
+    return static_cast<unsigned int>((static_cast<unsigned long long>(GetUInt32()) * max) >> 32);
+  }
+  unsigned int GetUInt(unsigned int min, unsigned int max) { assert(max > min); return min + GetUInt(max - min); }
+
+  // Uniform in [0, 1), with 53 bits of resolution
+  double GetDouble()
+  {
+    const unsigned long long hi = GetUInt32() >> 5;
+    const unsigned long long lo = GetUInt32() >> 6;
+    return static_cast<double>((hi << 26) | lo) * (1.0 / 9007199254740992.0);
+  }
+
+  bool P(double p) { return GetDouble() < p; }
+};
+
+#endif
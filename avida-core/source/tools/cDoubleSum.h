@@ -27,25 +27,40 @@
 #include <climits>
 #include <limits>
 
+// Sums are Kahan compensated, so that per thread partial sums merged at the end (Merge) agree with a single serial
+// accumulation to rounding.  Merging in a fixed order gives the same result on every run.
+
 class cDoubleSum {
 private:
+  static const int BULK_LANES = 4;
+
   double s1;  // Sum (x)
   double s2;  // Sum of squared x (x^2)
+  double c1;  // Compensation (lost low order bits) of s1
+  double c2;  // Compensation of s2
   double n;
   double max;
 
+  static inline void addCompensated(double& sum, double& comp, double value)
+  {
+    const double y = value - comp;
+    const double t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+  }
+
 public:
   cDoubleSum() { Clear(); }
 
-  void Clear() { s1 = s2 = n = 0; max = std::numeric_limits<double>::min();}
+  void Clear() { s1 = s2 = c1 = c2 = n = 0; max = std::numeric_limits<double>::min();}
 
   double Count()        const { return n; }
   double N()            const { return n; }
-  double Sum()          const { return s1; }
+  double Sum()          const { return s1 - c1; }
   double Max()          const { return max; }
 
-  double Average() const { return (n > 0.0) ? (s1 / n) : 0.0; }
-  double Variance() const { return (n > 1.0) ? (s2 - s1 * s1 / n) / (n - 1.0) : 0.0; }
+  double Average() const { return (n > 0.0) ? (Sum() / n) : 0.0; }
+  double Variance() const { return (n > 1.0) ? ((s2 - c2) - Sum() * Sum() / n) / (n - 1.0) : 0.0; }
   double StdDeviation() const { return sqrt(Variance()); }
   double StdError()  const { return (n > 1) ? sqrt(Variance() / n) : 0.0; }
   
@@ -57,18 +72,62 @@ public:
   {
     double w_val = value * weight;
     n += weight;
-    s1 += w_val;
-    s2 += w_val * w_val;
+    addCompensated(s1, c1, w_val);
+    addCompensated(s2, c2, w_val * w_val);
     if (value > max) max = value;
   }
 
+  // Add count unweighted values; independent lanes let the compiler vectorize the loop
+  inline void Add(const double* values, int count);
+
   void Subtract(double value, double weight = 1.0)
   {
     double w_val = value * weight;
     n -= weight;
-    s1 -= w_val;
-    s2 -= w_val * w_val;
+    addCompensated(s1, c1, -w_val);
+    addCompensated(s2, c2, -(w_val * w_val));
+  }
+
+  // Fold in the values accumulated by another sum
+  void Merge(const cDoubleSum& other)
+  {
+    n += other.n;
+    addCompensated(s1, c1, other.s1);
+    addCompensated(s2, c2, other.s2);
+    c1 += other.c1;
+    c2 += other.c2;
+    if (other.max > max) max = other.max;
   }
 };
 
+
+inline void cDoubleSum::Add(const double* values, int count)
+{
+  double l_s1[BULK_LANES] = { 0.0 }, l_c1[BULK_LANES] = { 0.0 };
+  double l_s2[BULK_LANES] = { 0.0 }, l_c2[BULK_LANES] = { 0.0 };
+  double l_max[BULK_LANES];
+  for (int j = 0; j < BULK_LANES; j++) l_max[j] = max;
+
+  int i = 0;
+  for (; i + BULK_LANES <= count; i += BULK_LANES) {
+    for (int j = 0; j < BULK_LANES; j++) {
+      const double value = values[i + j];
+      addCompensated(l_s1[j], l_c1[j], value);
+      addCompensated(l_s2[j], l_c2[j], value * value);
+      l_max[j] = (value > l_max[j]) ? value : l_max[j];
+    }
+  }
+
+  // Lanes are folded in lane order, then the tail, so the result only depends on the order of the values
+  for (int j = 0; j < BULK_LANES; j++) {
+    addCompensated(s1, c1, l_s1[j]);
+    addCompensated(s2, c2, l_s2[j]);
+    c1 += l_c1[j];
+    c2 += l_c2[j];
+    if (l_max[j] > max) max = l_max[j];
+  }
+  n += i;
+  for (; i < count; i++) Add(values[i]);
+}
+
 #endif
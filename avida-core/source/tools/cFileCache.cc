@@ -0,0 +1,140 @@
+/*
+ *  cFileCache.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cFileCache.h"
+
+#include "apto/core/Mutex.h"
+
+#include <fstream>
+
+
+static Apto::Mutex s_cache_mutex;
+static Apto::Map<Apto::String, cFileCache::sEntry*> s_cache_entries;
+static bool s_cache_recording = false;
+static Apto::Array<Apto::String, Apto::Smart> s_cache_recorded;
+
+
+static void freeEntry(cFileCache::sEntry* entry)
+{
+  delete [] entry->data;
+  delete entry;
+}
+
+
+cFileCache::sEntry* cFileCache::Acquire(const Apto::String& path)
+{
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  sEntry* entry = NULL;
+  if (!s_cache_entries.Get(path, entry)) return NULL;
+  entry->refs++;
+  return entry;
+}
+
+
+void cFileCache::Release(sEntry* entry)
+{
+  if (!entry) return;
+
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  if (--entry->refs == 0) freeEntry(entry);
+}
+
+
+bool cFileCache::Share(const Apto::String& path)
+{
+  {
+    Apto::MutexAutoLock lock(s_cache_mutex);
+    sEntry* entry = NULL;
+    if (s_cache_entries.Get(path, entry)) {
+      entry->refs++;
+      entry->shares++;
+      return true;
+    }
+  }
+
+  // Read outside of the lock, so that readers of other files are not held up
+  std::ifstream in((const char*)path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) return false;
+  in.seekg(0, std::ios::end);
+  const std::streamoff size = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  sEntry* entry = new sEntry;
+  entry->path = path;
+  entry->data = NULL;
+  entry->size = 0;
+  entry->refs = 1;
+  entry->shares = 1;
+  if (size > 0) {
+    entry->data = new char[size];
+    in.read(entry->data, size);
+    entry->size = in.gcount();
+  }
+
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  sEntry* existing = NULL;
+  if (s_cache_entries.Get(path, existing)) {
+    // Shared by another thread while this one was reading
+    freeEntry(entry);
+    existing->refs++;
+    existing->shares++;
+    return true;
+  }
+  s_cache_entries.Set(path, entry);
+  return true;
+}
+
+
+void cFileCache::Unshare(const Apto::String& path)
+{
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  sEntry* entry = NULL;
+  if (!s_cache_entries.Get(path, entry)) return;
+
+  if (--entry->shares == 0) s_cache_entries.Remove(path);
+  if (--entry->refs == 0) freeEntry(entry);
+}
+
+
+void cFileCache::StartRecording()
+{
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  s_cache_recording = true;
+  s_cache_recorded.Resize(0);
+}
+
+
+void cFileCache::StopRecording(Apto::Array<Apto::String>& paths)
+{
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  s_cache_recording = false;
+  paths.Resize(s_cache_recorded.GetSize());
+  for (int i = 0; i < s_cache_recorded.GetSize(); i++) paths[i] = s_cache_recorded[i];
+  s_cache_recorded.Resize(0);
+}
+
+
+void cFileCache::Record(const Apto::String& path)
+{
+  Apto::MutexAutoLock lock(s_cache_mutex);
+  if (!s_cache_recording) return;
+  for (int i = 0; i < s_cache_recorded.GetSize(); i++) if (s_cache_recorded[i] == path) return;
+  s_cache_recorded.Push(path);
+}
@@ -0,0 +1,64 @@
+/*
+ *  cFileCache.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cFileCache_h
+#define cFileCache_h
+
+#include "apto/core.h"
+
+#include <cstddef>
+
+
+// cFileCache holds the contents of input files shared by every world of the process (see Avida::Util::WorldTemplate).
+// Readers ask for a file by absolute path before going to disk; a shared file is handed out as one read-only buffer
+// that stays valid until the reader releases it, even if the file is unshared in the meantime.  While recording,
+// every path that a reader had to load from disk is noted, so that the files a world setup needs can be shared after
+// the fact.  All methods may be called from any thread.
+
+class cFileCache
+{
+public:
+  struct sEntry
+  {
+    Apto::String path;
+    char* data;       // read-only once shared, NULL for an empty file
+    size_t size;
+    int refs;         // readers plus one while the file is shared
+    int shares;
+  };
+
+  // Shared contents of the file at path, or NULL when it is not shared; a returned entry must be released
+  static sEntry* Acquire(const Apto::String& path);
+  static void Release(sEntry* entry);
+
+  // Read the file at path into the cache, or add another share to it; each successful share must be unshared
+  static bool Share(const Apto::String& path);
+  static void Unshare(const Apto::String& path);
+
+  // Note the paths that readers load from disk until StopRecording, which returns them in the order first loaded
+  static void StartRecording();
+  static void StopRecording(Apto::Array<Apto::String>& paths);
+  static void Record(const Apto::String& path);
+
+private:
+  cFileCache(); // @not_implemented
+};
+
+#endif
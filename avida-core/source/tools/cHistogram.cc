@@ -83,6 +83,33 @@ void cHistogram::Resize(int new_max, int new_min)
   min_bin = new_min;
 }
 
+void cHistogram::Insert(const int* values, int count)
+{
+  int total = 0;
+  for (int i = 0; i < count; i++) {
+    if (values[i] > max_bin || values[i] < min_bin) {
+      cerr << "Trying to insert " << values[i] << " into Histogram of range [" << min_bin << "," << max_bin << "]" << endl;
+    }
+    bins[values[i] - min_bin]++;
+    total += values[i];
+  }
+  entry_count += count;
+  entry_total += total;
+}
+
+void cHistogram::Merge(const cHistogram& other)
+{
+  if (other.min_bin < min_bin || other.max_bin > max_bin) {
+    Resize(Apto::Max(max_bin, other.max_bin), Apto::Min(min_bin, other.min_bin));
+  }
+
+  const int offset = other.min_bin - min_bin;
+  const int other_bins = other.max_bin - other.min_bin + 1;
+  for (int i = 0; i < other_bins; i++) bins[i + offset] += other.bins[i];
+  entry_count += other.entry_count;
+  entry_total += other.entry_total;
+}
+
 void cHistogram::Print()
 {
   FILE * fp = fopen("test.dat", "w");
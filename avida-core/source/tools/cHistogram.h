@@ -42,6 +42,8 @@ public:
   void Print();
   inline void Clear();
   inline void Insert(int value, int count=1);
+  void Insert(const int* values, int count);
+  void Merge(const cHistogram& other);  // Add other's entries, widening the range to cover both as needed
   inline void Remove(int value);
   inline void RemoveBin(int value);
 
@@ -25,19 +25,58 @@
 #include "apto/core/FileSystem.h"
 
 #include "AvidaTools.h"
-#include "cFile.h"
 #include "cStringIterator.h"
 
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 
 using namespace std;
 
 
+const cString& cInitFile::sLine::GetText() const
+{
+  if (start && line.GetSize() != size) line = cString(start, size);
+  return line;
+}
+
+cString& cInitFile::sLine::Edit()
+{
+  GetText();
+  start = NULL;
+  return line;
+}
+
+
+// True if postProcess would leave the text unchanged: no comment or continuation mark, and whitespace already reduced
+// to single spaces between words
+static bool isCleanLine(const char* text, int size)
+{
+  if (size == 0) return true;
+  if (text[0] == ' ' || text[size - 1] == ' ' || text[size - 1] == '\\') return false;
+  for (int i = 0; i < size; i++) {
+    const char c = text[i];
+    if (c == '#' || c == '\t' || c == '\r' || c == '\n') return false;
+    if (c == ' ' && text[i + 1] == ' ') return false;
+  }
+  return true;
+}
+
+
 cInitFile::cInitFile(const cString& filename, const cString& working_dir, Feedback& feedback,
                      const Apto::Set<Apto::String>* custom_directives, const Apto::Map<Apto::String, Apto::String>* mappings)
 : m_filename(filename), m_found(false), m_opened(false), m_ftype("unknown")
 {
   if (mappings) initMappings(*mappings);
-  Apto::Array<sLine*, Apto::Smart> lines;
+  Apto::Array<sLine, Apto::Smart> lines;
   m_opened = loadFile(filename, lines, working_dir, custom_directives, feedback);
   postProcess(lines);
 }
@@ -46,7 +85,7 @@ cInitFile::cInitFile(const cString& filename, const cString& working_dir, const
   : m_filename(filename), m_found(false), m_opened(false), m_ftype("unknown")
 {
   if (mappings) initMappings(*mappings);
-  Apto::Array<sLine*, Apto::Smart> lines;
+  Apto::Array<sLine, Apto::Smart> lines;
   m_opened = loadFile(filename, lines, working_dir, custom_directives, m_feedback);
   postProcess(lines);
 }
@@ -55,7 +94,7 @@ cInitFile::cInitFile(const cString& filename, const Apto::Map<Apto::String, Apto
   : m_filename(filename), m_found(false), m_opened(false), m_ftype("unknown")
 {
   initMappings(mappings);
-  Apto::Array<sLine*, Apto::Smart> lines;
+  Apto::Array<sLine, Apto::Smart> lines;
   m_opened = loadFile(filename, lines, working_dir, NULL, m_feedback);
   postProcess(lines);
 }
@@ -70,14 +109,14 @@ cInitFile::cInitFile(istream& in_stream, const cString& working_dir)
     return;
   }
   
-  Apto::Array<sLine*, Apto::Smart> lines;
+  Apto::Array<sLine, Apto::Smart> lines;
   
   int linenum = 1;
   std::string linebuf;
   while (std::getline(in_stream, linebuf)) {
     cString cur_line(linebuf.c_str());
     if (cur_line[0] == '#') processCommand(cur_line, lines, m_filename, linenum, working_dir, NULL, m_feedback);
-    else lines.Push(new sLine(cur_line, m_filename, linenum));    
+    else lines.Push(sLine(cur_line, m_filename, linenum));    
     linenum++;
   }
   
@@ -87,7 +126,19 @@ cInitFile::cInitFile(istream& in_stream, const cString& working_dir)
 
 cInitFile::~cInitFile()
 {
-  for (int i = 0; i < m_lines.GetSize(); i++) delete m_lines[i];
+  for (int i = 0; i < m_buffers.GetSize(); i++) {
+    if (m_buffers[i].shared) {
+      cFileCache::Release(m_buffers[i].shared);
+      continue;
+    }
+#if !APTO_PLATFORM(WINDOWS)
+    if (m_buffers[i].mapped) {
+      munmap(m_buffers[i].data, m_buffers[i].size);
+      continue;
+    }
+#endif
+    delete [] m_buffers[i].data;
+  }
 }
 
 
@@ -99,45 +150,106 @@ void cInitFile::initMappings(const Apto::Map<Apto::String, Apto::String>& mappin
 }
 
 
-bool cInitFile::loadFile(const cString& filename, Apto::Array<sLine*, Apto::Smart>& lines, const cString& working_dir,
+// Use the shared copy of the file when there is one.  Otherwise map the file into memory where the platform allows,
+// and read it into a heap buffer where it does not.
+bool cInitFile::readBuffer(const cString& path, sBuffer& buffer)
+{
+  buffer.data = NULL;
+  buffer.size = 0;
+  buffer.mapped = false;
+  buffer.shared = cFileCache::Acquire(Apto::String(path));
+  if (buffer.shared) {
+    buffer.data = buffer.shared->data;
+    buffer.size = buffer.shared->size;
+    return true;
+  }
+  
+#if !APTO_PLATFORM(WINDOWS)
+  int fd = open((const char*)path, O_RDONLY);
+  if (fd < 0) return false;
+  
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    return true;
+  }
+  
+  void* region = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (region != MAP_FAILED) {
+    buffer.data = static_cast<char*>(region);
+    buffer.size = st.st_size;
+    buffer.mapped = true;
+    return true;
+  }
+#endif
+  
+  std::ifstream in((const char*)path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) return false;
+  in.seekg(0, std::ios::end);
+  const std::streamoff size = in.tellg();
+  in.seekg(0, std::ios::beg);
+  if (size <= 0) return true;
+  
+  buffer.data = new char[size];
+  buffer.size = size;
+  in.read(buffer.data, size);
+  buffer.size = in.gcount();
+  return true;
+}
+
+
+bool cInitFile::loadFile(const cString& filename, Apto::Array<sLine, Apto::Smart>& lines, const cString& working_dir,
                          const Apto::Set<Apto::String>* custom_directives, Feedback& feedback)
 {
   cString path = cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(working_dir))); 
-  cFile file(path);
-  if (!file.IsOpen()) {
+  sBuffer buffer;
+  if (!readBuffer(path, buffer)) {
     feedback.Error("unable to open file '%s'.", (const char*)filename);
     return false;   // The file must be opened!
   }
+  if (!buffer.shared) cFileCache::Record(Apto::String(path));
+  if (buffer.data || buffer.shared) m_buffers.Push(buffer);
   
   m_found = true;
   
-  cStringList line_list;   // Create a list to load all of the lines into.
-
   int linenum = 0;
-  cString buf;
-  while (!file.Eof() && file.ReadLine(buf)) {
+  const char* cur = buffer.data;
+  const char* end = buffer.data + buffer.size;
+  while (cur < end) {
+    const char* eol = static_cast<const char*>(memchr(cur, '\n', end - cur));
+    if (!eol) eol = end;
     linenum++;
     
+    sLine line(cur, eol - cur, filename, linenum);
+    cur = eol + 1;
+    
     // Perform variable substitution
-    for (Apto::Map<Apto::String, Apto::String>::Iterator it = m_mappings.Begin(); it.Next() != NULL;) {
-      Apto::String varname = Apto::FormatStr("$%s", (const char*)it.Get()->Value1());
-      buf.Replace((const char*)varname, (const char*)*it.Get()->Value2());
-    } 
+    if (m_mappings.GetSize() && memchr(line.start, '$', line.size)) {
+      cString& buf = line.Edit();
+      for (Apto::Map<Apto::String, Apto::String>::Iterator it = m_mappings.Begin(); it.Next() != NULL;) {
+        Apto::String varname = Apto::FormatStr("$%s", (const char*)it.Get()->Value1());
+        buf.Replace((const char*)varname, (const char*)*it.Get()->Value2());
+      }
+    }
     
     // Process the line
-    if (buf.GetSize() && buf[0] == '#') {
-      if (!processCommand(buf, lines, filename, linenum, working_dir, custom_directives, feedback)) return false;
+    if (line.GetSize() && ((line.start) ? line.start[0] : line.line[0]) == '#') {
+      if (!processCommand(line.GetText(), lines, filename, linenum, working_dir, custom_directives, feedback)) return false;
     } else {
-      lines.Push(new sLine(buf, filename, linenum));
+      lines.Push(line);
     }
   }
-  file.Close();
   
   return true;
 }
 
 
-bool cInitFile::processCommand(cString cmdstr, Apto::Array<sLine*, Apto::Smart>& lines, const cString& filename, int linenum,
+bool cInitFile::processCommand(cString cmdstr, Apto::Array<sLine, Apto::Smart>& lines, const cString& filename, int linenum,
                                const cString& working_dir, const Apto::Set<Apto::String>* custom_directives, Feedback& feedback)
 {
   cString cmd = cmdstr.PopWord();
@@ -185,6 +297,7 @@ bool cInitFile::processCommand(cString cmdstr, Apto::Array<sLine*, Apto::Smart>&
       return false;
     }
     m_format.Load(cmdstr);
+    for (int i = 0; i < m_format.GetSize(); i++) m_format_names.Push((const char*)m_format.GetLine(i));
   } else if (cmd == "#define") {
     cString mapping = cmdstr.PopWord();
     if (mapping.GetSize()) {
@@ -214,7 +327,7 @@ bool cInitFile::processCommand(cString cmdstr, Apto::Array<sLine*, Apto::Smart>&
 }
 
 
-void cInitFile::postProcess(Apto::Array<sLine*, Apto::Smart>& lines)
+void cInitFile::postProcess(Apto::Array<sLine, Apto::Smart>& lines)
 {
   m_mappings.Clear();
   m_imported_files.Clear();
@@ -225,9 +338,12 @@ void cInitFile::postProcess(Apto::Array<sLine*, Apto::Smart>& lines)
   const int num_lines = lines.GetSize();
 
   // PASS 1: Remove all comments -- everything after a '#' sign -- and
-  // compress all whitespace into a single space.
+  // compress all whitespace into a single space.  Lines already in that
+  // form are left as slices of the file.
   for (int i = 0; i < num_lines; i++) {
-    cString& cur_line = lines[i]->line;
+    if (lines[i].start && isCleanLine(lines[i].start, lines[i].size)) continue;
+    
+    cString& cur_line = lines[i].Edit();
 
     // Remove all characters past a comment mark and reduce whitespace.
     int comment_pos = cur_line.Find('#');
@@ -243,39 +359,28 @@ void cInitFile::postProcess(Apto::Array<sLine*, Apto::Smart>& lines)
   for (int i = 0; i < num_lines; i++) {
     // If the current line is a continuation, append it to the previous line.
     if (continued == true) {
-      lines[prev_line_id]->line += lines[i]->line;
-      lines[i]->line = "";
+      lines[prev_line_id].Edit() += lines[i].GetText();
+      lines[i].Edit() = "";
     }
     else prev_line_id = i;
 
     // See if the prev_line is continued, and if it is, take care of it.
-    cString& prev_line = lines[prev_line_id]->line;
-    if (prev_line.GetSize() > 0 && prev_line[prev_line.GetSize() - 1] == '\\') {
-      prev_line.ClipEnd(1);  // Remove continuation mark.
+    // (a clean line never ends with the marker, so only edited lines need checking)
+    sLine& prev_line = lines[prev_line_id];
+    if (!prev_line.start && prev_line.line.GetSize() > 0 && prev_line.line[prev_line.line.GetSize() - 1] == '\\') {
+      prev_line.line.ClipEnd(1);  // Remove continuation mark.
       continued = true;
     }
     else continued = false;
   }
 
-  // PASS 3: Remove now-empty lines.
+  // PASS 3: Remove now-empty lines, and move the rest to the internal line structure.
 
   int next_id = 0;
-  for (int i = 0; i < num_lines; i++) {
-    // If we should keep this line, compact it.
-    if (lines[i]->line.GetSize() > 0) {
-      if (next_id != i) {
-        delete lines[next_id];
-        lines[next_id] = lines[i];
-        lines[i] = NULL;
-      }
-      next_id++;
-    }
-  }
-
-  // Resize the internal line structure and move the line structs to it
+  for (int i = 0; i < num_lines; i++) if (lines[i].GetSize() > 0) next_id++;
   m_lines.Resize(next_id);
-  for (int i = 0; i < next_id; i++) m_lines[i] = lines[i];
-  for (int i = next_id; i < num_lines; i++) delete lines[i];  
+  next_id = 0;
+  for (int i = 0; i < num_lines; i++) if (lines[i].GetSize() > 0) m_lines[next_id++] = lines[i];
 }
 
 
@@ -288,7 +393,7 @@ void cInitFile::Save(const cString& in_filename)
   
   // Go through the lines saving them...
   for (int i = 0; i < m_lines.GetSize(); i++) {
-    fp_save << m_lines[i]->line << endl;
+    fp_save << m_lines[i].GetText() << endl;
   }
   
   fp_save.close();
@@ -299,18 +404,26 @@ void cInitFile::Save(const cString& in_filename)
 cString cInitFile::GetLine(int line_num)
 {
   if (line_num < 0 || line_num >= m_lines.GetSize()) return "";
-  return m_lines[line_num]->line;
+  return m_lines[line_num].GetText();
 }
 
-Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > cInitFile::GetLineAsDict(int line_num)
+// Tokenizes the line without filling in the text of slices, so that threads may share a loaded file
+Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > cInitFile::GetLineAsDict(int line_num) const
 {
   Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > dict(new Apto::Map<Apto::String, Apto::String>);
+  if (line_num < 0 || line_num >= m_lines.GetSize()) return dict;
   
-  cStringList fmt = m_format;
-  cStringList line;
-  if (line_num >= 0 && line_num < m_lines.GetSize()) line.Load(m_lines[line_num]->line);  
+  // Processed lines hold single space separated words, with no leading or trailing whitespace, so splitting a single
+  // copy of the line at its spaces yields the words
+  const sLine& line = m_lines[line_num];
+  std::string buf((line.start) ? line.start : (const char*)line.line, line.GetSize());
+  for (size_t i = 0; i < buf.size(); i++) if (buf[i] == ' ') buf[i] = '\0';
   
-  while (fmt.GetSize() && line.GetSize()) dict->Set((const char*)fmt.Pop(), (const char*)line.Pop());
+  size_t word = 0;
+  for (int fmt_i = 0; fmt_i < m_format_names.GetSize() && word < buf.size(); fmt_i++) {
+    dict->Set(m_format_names[fmt_i], &buf[word]);
+    word += strlen(&buf[word]) + 1;
+  }
   
   return dict;
 }
@@ -323,11 +436,11 @@ bool cInitFile::Find(cString& in_string, const cString& keyword, int col) const
   // Loop through all of the lines looking for this keyword.  Start with
   // the actual file...
   for (int line_id = 0; line_id < m_lines.GetSize(); line_id++) {
-    cString cur_string = m_lines[line_id]->line;
+    const cString& cur_string = m_lines[line_id].GetText();
 
     // If we found the keyword, return it and stop.    
     if (cur_string.GetWord(col) == keyword) {
-      m_lines[line_id]->used = true;
+      m_lines[line_id].used = true;
       in_string = cur_string;
       found = true;
     }
@@ -391,12 +504,12 @@ bool cInitFile::WarnUnused() const
   bool found = false;
 
   for (int i = 0; i < m_lines.GetSize(); i++) {
-    if (m_lines[i]->used == false) {
+    if (m_lines[i].used == false) {
       if (found == false) {
         found = true;
         m_feedback.Warning("unknown lines in input file '%s'.", (const char*)m_filename);
       }
-      m_feedback.Notify("  %s:%d: %s", (const char*)m_lines[i]->file, m_lines[i]->line_num, (const char*)m_lines[i]->line);
+      m_feedback.Notify("  %s:%d: %s", (const char*)m_lines[i].file, m_lines[i].line_num, (const char*)m_lines[i].GetText());
     }
   }
   
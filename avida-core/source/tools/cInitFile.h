@@ -25,6 +25,7 @@
 
 #include "apto/core.h"
 
+#include "cFileCache.h"
 #include "cString.h"
 #include "cStringList.h"
 #include "cUserFeedback.h"
@@ -41,19 +42,39 @@ private:
   bool m_opened;
   mutable cUserFeedback m_feedback;
   
+  // Lines that need no substitution or clean up stay slices of the loaded file buffer, and only become strings when
+  // the text is asked for as a whole
   struct sLine {
-    cString line;
+    const char* start;      // the line within a loaded buffer, NULL once the line has its own text
+    int size;
+    mutable cString line;   // for slices, filled on first use
     cString file;
     int line_num;
     mutable bool used;
     
+    sLine() : start(NULL), size(0), line_num(0), used(false) { ; }
+    sLine(const char* in_start, int in_size, const cString& in_file, int in_line_num)
+      : start(in_start), size(in_size), file(in_file), line_num(in_line_num), used(false) { ; }
     sLine(const cString& in_line, const cString& in_file, int in_line_num)
-      : line(in_line), file(in_file), line_num(in_line_num), used(false) { ; }
+      : start(NULL), size(0), line(in_line), file(in_file), line_num(in_line_num), used(false) { ; }
+    
+    inline int GetSize() const { return (start) ? size : line.GetSize(); }
+    const cString& GetText() const;
+    cString& Edit();        // detach a slice from the buffer, so that the line may be modified
+  };
+  
+  struct sBuffer {
+    char* data;
+    size_t size;
+    bool mapped;
+    cFileCache::sEntry* shared;   // set when data belongs to the process wide cache
   };
 
-  Apto::Array<sLine*> m_lines;
+  Apto::Array<sLine> m_lines;
+  Apto::Array<sBuffer, Apto::Smart> m_buffers;   // file contents the line slices point into, released on destruction
   cString m_ftype;
   cStringList m_format;
+  Apto::Array<Apto::String, Apto::Smart> m_format_names;   // m_format, for lookup by column
   cStringList m_imported_files;
   
   Apto::Map<Apto::String, Apto::String> m_mappings;
@@ -87,7 +108,7 @@ public:
    **/
   cString GetLine(int line_num = 0);
   
-  Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > GetLineAsDict(int line_num = 0);
+  Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > GetLineAsDict(int line_num = 0) const;
   
 
   /**
@@ -134,7 +155,7 @@ public:
    **/
   bool WarnUnused() const;
 
-  void MarkLineUsed(int line_id) { m_lines[line_id]->used = true; }
+  void MarkLineUsed(int line_id) { m_lines[line_id].used = true; }
 
   int GetNumLines() const { return m_lines.GetSize(); }
 
@@ -144,11 +165,12 @@ public:
 
 private:
   void initMappings(const Apto::Map<Apto::String, Apto::String>& mappings);
-  bool loadFile(const cString& filename, Apto::Array<sLine*, Apto::Smart>& lines, const cString& working_dir,
+  bool readBuffer(const cString& path, sBuffer& buffer);
+  bool loadFile(const cString& filename, Apto::Array<sLine, Apto::Smart>& lines, const cString& working_dir,
                 const Apto::Set<Apto::String>* custom_directives, Feedback& feedback);
-  bool processCommand(cString cmdstr, Apto::Array<sLine*, Apto::Smart>& lines, const cString& filename, int linenum,
+  bool processCommand(cString cmdstr, Apto::Array<sLine, Apto::Smart>& lines, const cString& filename, int linenum,
                       const cString& working_dir, const Apto::Set<Apto::String>* custom_directives, Feedback& feedback);
-  void postProcess(Apto::Array<sLine*, Apto::Smart>& lines);
+  void postProcess(Apto::Array<sLine, Apto::Smart>& lines);
 };
 
 #endif
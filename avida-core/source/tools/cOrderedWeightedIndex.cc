@@ -42,15 +42,23 @@ cOrderedWeightedIndex::~cOrderedWeightedIndex()
  
 void cOrderedWeightedIndex::SetWeight(int value, double in_weight)
 {
-  int cur_size = item_value.GetSize();
-  item_weight.Resize(cur_size + 1);
-  cum_weight.Resize(cur_size + 1);
-  item_value.Resize(cur_size + 1);
-
-  item_value[cur_size] = value;
-  item_weight[cur_size] = in_weight;
-  cum_weight[cur_size] = (cur_size == 0) ? in_weight : cum_weight[cur_size-1] + in_weight;
- }
+  // Update the existing entry for value, if there is one; otherwise append it
+  int pos = 0;
+  while (pos < item_value.GetSize() && item_value[pos] != value) pos++;
+  if (pos == item_value.GetSize()) {
+    item_weight.Resize(pos + 1);
+    cum_weight.Resize(pos + 1);
+    item_value.Resize(pos + 1);
+    item_value[pos] = value;
+  }
+
+  item_weight[pos] = in_weight;
+  for (int i = pos; i < item_weight.GetSize(); i++) {
+    cum_weight[i] = (i == 0) ? item_weight[i] : cum_weight[i - 1] + item_weight[i];
+  }
+
+  cWeightedIndex::BuildAliasTable(item_weight, alias_prob, alias_index);
+}
 
 int cOrderedWeightedIndex::FindPosition(double position){
   return Lookup(position, 0, GetSize()-1);
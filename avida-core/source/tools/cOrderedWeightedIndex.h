@@ -25,6 +25,8 @@
 
 #include "avida/core/Types.h"
 
+#include "cWeightedIndex.h"
+
 #ifndef NULL
 #define NULL 0
 #endif
@@ -45,6 +47,8 @@ protected:
   Apto::Array<double> item_weight;
   Apto::Array<double> cum_weight;
   Apto::Array<int>    item_value;
+  Apto::Array<double> alias_prob;
+  Apto::Array<int>    alias_index;
 
   int Lookup(double weight, int ndxA, int ndxE);
 
@@ -62,6 +66,11 @@ public:
   
   int FindPosition(double position);
 
+  // Constant time draw given a uniform deviate in [0, 1).  The alias table is rebuilt by SetWeight, so concurrent
+  // draws are safe as long as weights are not changing.
+  int FindAliasPosition(double unit) const
+    { return item_value[cWeightedIndex::AliasLookup(alias_prob, alias_index, unit)]; }
+
 };
 #endif
 
@@ -55,6 +55,17 @@ void cRunningAverage::Add( double value ) {
 }
 
 
+void cRunningAverage::Add(const double* values, int count) {
+  // Only the last window_size values can remain in the window
+  int first = 0;
+  if (count > m_window_size) {
+    first = count - m_window_size;
+    Clear();
+  }
+  for (int i = first; i < count; i++) Add(values[i]);
+}
+
+
 void cRunningAverage::Clear() {
   m_s1 = 0;
   m_s2 = 0;
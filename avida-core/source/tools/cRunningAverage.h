@@ -47,8 +47,12 @@ public:
   
   //manipulators
   void Add(double value);
+  void Add(const double* values, int count);
   void Clear();
   
+  // Windows are ordered, so unlike cDoubleSum and cRunningStats a running average cannot be merged; partial results
+  // must be added to it in sample order.
+  
   
   //accessors
   double Sum()          const { return m_s1; }
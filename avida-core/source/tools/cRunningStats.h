@@ -23,26 +23,48 @@
 #define cRunningStats_h
 
 #include <cmath>
+#include <limits>
 
 
+// Mean and central moments are updated incrementally; two sets of statistics over disjoint samples combine exactly
+// (Merge, after Chan et al. and Pebay), so per thread partial statistics can be reduced at a barrier.  Reducing in a
+// fixed order gives the same result on every run.
+
 class cRunningStats
 {
 private:
+  static const int BULK_LANES = 4;
+
   double m_n;  // count
   double m_m1; // mean
   double m_m2; // second moment
   double m_m3; // third moment
   double m_m4; // fourth moment
+  double m_min;
+  double m_max;
   
 public:
-  inline cRunningStats() : m_n(0.0), m_m1(0.0), m_m2(0.0), m_m3(0.0), m_m4(0.0) { ; }
+  inline cRunningStats() { Clear(); }
 
-  inline void Clear() { m_n = 0.0; m_m1 = 0.0; m_m2 = 0.0; m_m3 = 0.0; m_m4 = 0.0; }
+  inline void Clear()
+  {
+    m_n = 0.0; m_m1 = 0.0; m_m2 = 0.0; m_m3 = 0.0; m_m4 = 0.0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+  }
   
   inline void Push(double x);
+  
+  // Push count values; the block's moments are gathered in independent lanes the compiler can vectorize, then merged
+  inline void Push(const double* values, int count);
+  
+  // Combine with the statistics of another, disjoint, sample
+  inline void Merge(const cRunningStats& other);
 
   inline double N() const { return m_n; }
   inline double Mean() const { return m_m1; }
+  inline double Min() const { return (m_n > 0.0) ? m_min : 0.0; }
+  inline double Max() const { return (m_n > 0.0) ? m_max : 0.0; }
   inline double StdDeviation() const { return sqrt(Variance()); }
   inline double StdError() const { return (m_n > 1.0) ? sqrt(Variance() / m_n) : 0.0; }
   inline double Variance() const { return (m_n > 1.0) ? (m_m2 / (m_n - 1.0)) : 0.0; }
@@ -62,6 +84,90 @@ inline void cRunningStats::Push(double x)
   m_m3 += d * d_n2 * ((m_n - 1) * (m_n - 2)) - 3 * d_n * m_m2;
   m_m2 += d * d_n * (m_n - 1);
   m_m1 += d_n;
+  
+  if (x < m_min) m_min = x;
+  if (x > m_max) m_max = x;
+}
+
+
+inline void cRunningStats::Push(const double* values, int count)
+{
+  if (count <= 0) return;
+  
+  // First pass: block mean
+  double l_sum[BULK_LANES] = { 0.0 };
+  int i = 0;
+  for (; i + BULK_LANES <= count; i += BULK_LANES) {
+    for (int j = 0; j < BULK_LANES; j++) l_sum[j] += values[i + j];
+  }
+  double sum = 0.0;
+  for (int j = 0; j < BULK_LANES; j++) sum += l_sum[j];
+  for (; i < count; i++) sum += values[i];
+  
+  cRunningStats block;
+  block.m_n = count;
+  block.m_m1 = sum / count;
+  
+  // Second pass: central moments about the block mean
+  double l_m2[BULK_LANES] = { 0.0 }, l_m3[BULK_LANES] = { 0.0 }, l_m4[BULK_LANES] = { 0.0 };
+  double l_min[BULK_LANES], l_max[BULK_LANES];
+  for (int j = 0; j < BULK_LANES; j++) { l_min[j] = block.m_min; l_max[j] = block.m_max; }
+  for (i = 0; i + BULK_LANES <= count; i += BULK_LANES) {
+    for (int j = 0; j < BULK_LANES; j++) {
+      const double d = values[i + j] - block.m_m1;
+      const double d2 = d * d;
+      l_m2[j] += d2;
+      l_m3[j] += d2 * d;
+      l_m4[j] += d2 * d2;
+      l_min[j] = (values[i + j] < l_min[j]) ? values[i + j] : l_min[j];
+      l_max[j] = (values[i + j] > l_max[j]) ? values[i + j] : l_max[j];
+    }
+  }
+  for (int j = 0; j < BULK_LANES; j++) {
+    block.m_m2 += l_m2[j];
+    block.m_m3 += l_m3[j];
+    block.m_m4 += l_m4[j];
+    if (l_min[j] < block.m_min) block.m_min = l_min[j];
+    if (l_max[j] > block.m_max) block.m_max = l_max[j];
+  }
+  for (; i < count; i++) {
+    const double d = values[i] - block.m_m1;
+    const double d2 = d * d;
+    block.m_m2 += d2;
+    block.m_m3 += d2 * d;
+    block.m_m4 += d2 * d2;
+    if (values[i] < block.m_min) block.m_min = values[i];
+    if (values[i] > block.m_max) block.m_max = values[i];
+  }
+  
+  Merge(block);
+}
+
+
+inline void cRunningStats::Merge(const cRunningStats& other)
+{
+  if (other.m_n == 0.0) return;
+  if (m_n == 0.0) {
+    *this = other;
+    return;
+  }
+  
+  const double n_a = m_n;
+  const double n_b = other.m_n;
+  const double n = n_a + n_b;
+  const double d = other.m_m1 - m_m1;
+  const double d_n = d / n;
+  const double d_n2 = d_n * d_n;
+  
+  m_m4 += other.m_m4 + d * d_n2 * d_n * n_a * n_b * (n_a * n_a - n_a * n_b + n_b * n_b) +
+          6.0 * d_n2 * (n_a * n_a * other.m_m2 + n_b * n_b * m_m2) + 4.0 * d_n * (n_a * other.m_m3 - n_b * m_m3);
+  m_m3 += other.m_m3 + d * d_n2 * n_a * n_b * (n_a - n_b) + 3.0 * d_n * (n_a * other.m_m2 - n_b * m_m2);
+  m_m2 += other.m_m2 + d * d_n * n_a * n_b;
+  m_m1 += d_n * n_b;
+  m_n = n;
+  
+  if (other.m_min < m_min) m_min = other.m_min;
+  if (other.m_max > m_max) m_max = other.m_max;
 }
 
 #endif
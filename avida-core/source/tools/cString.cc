@@ -30,21 +30,21 @@ using namespace std;
 
 // ** class cStringData **
 // -- Constructors --
-cString::cStringData::cStringData(int in_size) : m_size(in_size), m_data(new char[m_size + 1])
+cString::cStringData::cStringData(int in_size) : m_size(in_size), m_data(allocate(m_size))
 {
   assert(m_data != NULL); // Memory Allocation Error: Out of Memory
   m_data[0] = '\0';
   m_data[m_size] = '\0';
 }
 
-cString::cStringData::cStringData(int in_size, const char* in) : m_size(in_size), m_data(new char[m_size + 1])
+cString::cStringData::cStringData(int in_size, const char* in) : m_size(in_size), m_data(allocate(m_size))
 {
   assert(m_data != NULL); // Memory Allocation Error: Out of Memory
   for (int i = 0; i < m_size; i++) m_data[i] = in[i];
   m_data[m_size] = '\0';
 }
 
-cString::cStringData::cStringData(const cStringData& in) : Apto::RefCountObject<Apto::ThreadSafe>(*this), m_size(in.GetSize()), m_data(new char[m_size + 1])
+cString::cStringData::cStringData(const cStringData& in) : Apto::RefCountObject<Apto::ThreadSafe>(*this), m_size(in.GetSize()), m_data(allocate(m_size))
 {
   assert(m_data != NULL); // Memory Allocation Error: Out of Memory
   for (int i = 0; i < m_size; i++)  m_data[i] = in[i];
@@ -55,10 +55,19 @@ cString::cStringData::cStringData(const cStringData& in) : Apto::RefCountObject<
 
 // ** class cString **
 
+Apto::SmartPtr<cString::cStringData, Apto::InternalRCObject> cString::emptyData()
+{
+  static Apto::SmartPtr<cStringData, Apto::InternalRCObject> s_empty(new cStringData(0, ""));
+  return s_empty;
+}
+
 
 // -- Comparisons --
 
 bool cString::operator==(const cString& in) const {
+  // Copies (including interned names) share their data
+  if (&*value == &*in.value) return true;
+
   // Compares sizes first since we have that info anyway
   int i = -1;
   if (GetSize() == in.GetSize()) {
@@ -33,6 +33,7 @@
 #include <cassert>
 
 #define MAX_STRING_LENGTH 4096
+#define SMALL_STRING_SIZE 16
 #define CONTINUE_LINE_CHAR '\\'
 
 /**
@@ -78,9 +79,13 @@ private:
   private:
     int m_size;   // size of data (NOT INCLUDING TRAILING NULL)
     char* m_data;
+    char m_small[SMALL_STRING_SIZE];  // short strings live here rather than in a second allocation
     
     cStringData(); // @not_implemented
 
+    inline char* allocate(int size) { return (size < SMALL_STRING_SIZE) ? m_small : new char [size + 1]; }
+    inline void release() { if (m_data != m_small) delete [] m_data; }
+
   public:
     explicit cStringData(int in_size);
     cStringData(int in_size, const char* in);
@@ -88,14 +93,14 @@ private:
 
     ~cStringData()
     {
-      delete [] m_data;
+      release();
     }
 
     cStringData& operator=(const cStringData& in)
     {
-      delete [] m_data;
+      release();
       m_size = in.GetSize();
-      m_data = new char [m_size + 1];
+      m_data = allocate(m_size);
       assert(m_data != NULL);   // Memory Allocation Error: Out of Memory
       for(int i = 0; i < m_size; ++i)  m_data[i] = in[i];
       m_data[m_size] = '\0';
@@ -124,10 +129,10 @@ private:
 public:
   cString(const char* in_str = "")
   {
-    if (in_str) {
+    if (in_str && *in_str) {
       value = Apto::SmartPtr<cStringData, Apto::InternalRCObject>(new cStringData((int)strlen(in_str), in_str));
     } else {
-      value = Apto::SmartPtr<cStringData, Apto::InternalRCObject>(new cStringData(0, ""));
+      value = emptyData();
     }
     assert( value );  // Memory Allocation Error: Out of Memory
   }
@@ -550,6 +555,9 @@ protected:
   cString& InsertStr(const int in_size, const char* in, int pos, int excise=0);
   int FindStr(const char* in_string, const int in_size, int pos) const;
 
+  // All empty strings share a single representation until one of them is modified
+  static Apto::SmartPtr<cStringData, Apto::InternalRCObject> emptyData();
+
   // -- Internal Data --
 protected:
   Apto::SmartPtr<cStringData, Apto::InternalRCObject> value;
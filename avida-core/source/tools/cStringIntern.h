@@ -0,0 +1,72 @@
+/*
+ *  cStringIntern.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cStringIntern_h
+#define cStringIntern_h
+
+#include "avida/core/Types.h"
+
+#include "cString.h"
+
+
+// cStringIntern hands out dense integer handles (0, 1, 2, ...) for names, in the order they are first seen.  Names
+// are looked up by hash rather than by scanning, and every handle keeps a single shared copy of its name, so copies
+// taken through GetName() compare equal without looking at their characters.
+
+class cStringIntern
+{
+private:
+  Apto::Map<cString, int> m_handles;
+  Apto::Array<cString, Apto::Smart> m_names;
+
+public:
+  cStringIntern() { ; }
+
+  inline int GetSize() const { return m_names.GetSize(); }
+
+  // Handle of name, adding it if it is not yet known
+  inline int Intern(const cString& name);
+
+  // Handle of name, or -1 if it has not been interned
+  inline int Find(const cString& name) const;
+
+  inline const cString& GetName(int handle) const { return m_names[handle]; }
+};
+
+
+inline int cStringIntern::Intern(const cString& name)
+{
+  int handle = -1;
+  if (m_handles.Get(name, handle)) return handle;
+
+  handle = m_names.GetSize();
+  m_names.Push(name);
+  m_handles.Set(m_names[handle], handle);
+  return handle;
+}
+
+inline int cStringIntern::Find(const cString& name) const
+{
+  int handle = -1;
+  if (!m_handles.Get(name, handle)) return -1;
+  return handle;
+}
+
+#endif
@@ -26,10 +26,19 @@
  This file contains templated algorithms that create a particular cell
  topology out of a given range of cells.  In every case, the range of cells is
  specified by a begin/end iterator pair.
+ 
+ The random networks are instead generated as lists of edges between vertex
+ indices, which cConnectionTable::AddEdges then lays out in one pass; that keeps
+ building them linear in the size of the network.
  */
 
+#include "apto/core/Array.h"
+#include "apto/rng.h"
+
 #include "AvidaTools.h"
 
+#include <algorithm>
+
 using namespace AvidaTools;
 
 /*! Builds a torus topology out of the cells betwen the iterators.
@@ -224,134 +233,132 @@ void build_lattice(ArraySlice slice, unsigned int x_size, unsigned int y_size, u
 }
 
 
-/*
- Builds a random connected network topology for organisms to communicate through.
- 
+/*! The set of undirected edges between vertices 0..n-1, as an open addressing hash table.  Lets the network builders
+ reject duplicate edges in constant time instead of searching connection lists.
  */
-template< typename ArraySlice >
-void build_random_connected_network(ArraySlice slice, unsigned int x_size, unsigned int y_size, Apto::Random& rng) {
-	
-	// keep track of boundaries for this deme:
-	int offset = slice[0].GetID();
-	int demeSize = x_size * y_size;
-	
-	// keep track of cells that have been connected already:
-	std::set<int> connected_Cells;
-		
-	
-	for (int i = 0; i < slice.GetSize(); ++i) {
-		// select a random cell in this deme to connect to:
-		int targetCellID;
-		do {
-			targetCellID = rng.GetInt(0, demeSize);
-		} while((targetCellID + offset) == slice[i].GetID());
-		
-		int j = targetCellID;
-		
-		// verify no connection exists between i and j:
-		if (slice[i].ConnectionList().FindPtr(&slice[j]) == NULL) {
-			// create bidirectional connections:
-			slice[i].ConnectionList().Push(&slice[j]);
-			slice[j].ConnectionList().Push(&slice[i]);
-			
-			// check if either i or j is connected to the
-			// main graph:
-			if(connected_Cells.count(slice[i].GetID()) == 0 && connected_Cells.count(slice[j].GetID()) == 0) {
-				// neither i nor j is connected to the main graph
-				
-				// check if main network is empty:
-				if(connected_Cells.empty()) {
-					connected_Cells.insert(slice[i].GetID());
-					connected_Cells.insert(slice[j].GetID());
-				} else {
-					// pick some random cell that is connected:
-					int randomIndex = rng.GetInt(0, connected_Cells.size());
-					int counter = 0;
-					int idValue = 0;
-					set<int>::iterator pos;
-					for(pos = connected_Cells.begin(); pos != connected_Cells.end(); ++pos) {
-						if(counter == randomIndex) {
-							idValue = *pos;
-							break;
-						} else {
-							counter++;
-						}
-					}
-					
-					// retrieve the actual cell:
-					int random_Connected_Cell = idValue - offset;
-					
-					// randomly select i or j to connect with main network:
-					int zeroOrOne = rng.GetInt(0,2);
-					
-					if(zeroOrOne) {
-						// connect i to main network:
-						slice[i].ConnectionList().Push(&slice[random_Connected_Cell]);
-						slice[random_Connected_Cell].ConnectionList().Push(&slice[i]);
-					} else {
-						// connect j to main network:
-						slice[j].ConnectionList().Push(&slice[random_Connected_Cell]);
-						slice[random_Connected_Cell].ConnectionList().Push(&slice[j]);
-					}
-					
-					// add both cells to the main network:
-					// don't care about duplicates...
-					connected_Cells.insert(slice[i].GetID());
-					connected_Cells.insert(slice[j].GetID());
-				}
-				
-			} else {
-				connected_Cells.insert(slice[i].GetID());
-				connected_Cells.insert(slice[j].GetID());
-			}
-		}
-	}
-	
-	
-	// the code above ensures that we have *at the least* a random connected
-	// bidirectional network.
-	// sprinkle additional edges between the cells:
-	
-	// we are going to add random extra edges... note demeSize bound is arbitrary.
-	int extraEdges = rng.GetInt(0, demeSize);
-	int a, b;
-	
-	for(int n = 0; n < extraEdges; ++n) {
-		// must select two random cells from the network:
-		a = rng.GetInt(0,demeSize);
-		b = rng.GetInt(0,demeSize);
-		
-		while (a == b) b = rng.GetInt(0,demeSize);
-		
-		int i = a;
-		int j = b;
-		
-		// check for existing connection between the two:
-		if (slice[i].ConnectionList().FindPtr(&slice[j]) == NULL) {
-			slice[i].ConnectionList().Push(&slice[j]);
-			slice[j].ConnectionList().Push(&slice[i]);
-		}
-	}
-}
-
+class cEdgeSet {
+private:
+  long long m_num_vertices;
+  Apto::Array<long long> m_keys;  // -1 marks an empty slot
+  int m_count;
+  
+  inline long long key(int u, int v) const { return (u < v) ? (u * m_num_vertices + v) : (v * m_num_vertices + u); }
+  inline int slot(long long k) const {
+    return (int)(((unsigned long long)k * 0x9E3779B97F4A7C15ULL) >> 32) & (m_keys.GetSize() - 1);
+  }
+  
+  void place(long long k) {
+    int i = slot(k);
+    while (m_keys[i] != -1) i = (i + 1) & (m_keys.GetSize() - 1);
+    m_keys[i] = k;
+  }
+  
+public:
+  explicit cEdgeSet(int num_vertices) : m_num_vertices(num_vertices), m_keys(1024), m_count(0) { m_keys.SetAll(-1); }
+  
+  bool Contains(int u, int v) const {
+    const long long k = key(u, v);
+    for (int i = slot(k); m_keys[i] != -1; i = (i + 1) & (m_keys.GetSize() - 1)) {
+      if (m_keys[i] == k) return true;
+    }
+    return false;
+  }
+  
+  //! Adds the edge u-v, returning false if it was already present.
+  bool Insert(int u, int v) {
+    if (Contains(u, v)) return false;
+    
+    // Stay at most half full, so that probe runs remain short
+    if (2 * (m_count + 1) > m_keys.GetSize()) {
+      Apto::Array<long long> keys(m_keys);
+      m_keys.Resize(m_keys.GetSize() * 2);
+      m_keys.SetAll(-1);
+      for (int i = 0; i < keys.GetSize(); i++) if (keys[i] != -1) place(keys[i]);
+    }
+    place(key(u, v));
+    m_count++;
+    return true;
+  }
+};
 
-//! Helper function to connect two cells.
-template <typename InputIterator>
-void connect(InputIterator u, InputIterator v) {
-	assert(u != v);
-	u->ConnectionList().Push(v);
-	v->ConnectionList().Push(u);
-}
 
-//! Helper function to test if two cells are already connected.
-template <typename InputIterator>
-bool edge(InputIterator u, InputIterator v) {
-	assert(u != v);
-	return u->ConnectionList().FindPtr(v) || v->ConnectionList().FindPtr(u);
+/*! Builds a random connected network out of num_vertices vertices, for organisms to communicate through.  Each edge is
+ appended to edges as a pair of vertex indices (see cConnectionTable::AddEdges).
+ 
+ Each vertex in turn is joined to a random other vertex; when neither end of that edge is part of the network built so
+ far, one of them is also joined to a random vertex of the network.  A random number of extra edges, up to
+ num_vertices, are then sprinkled in.  Duplicate edges are skipped.
+ 
+ The vertices of the network are counted in a Fenwick tree by index, so the k-th of them in index order (the order the
+ network was originally kept in, as a std::set) is found in O(log n), leaving the random draws and resulting network
+ unchanged.
+ */
+inline void build_random_connected_network(int num_vertices, Apto::Random& rng, Apto::Array<int, Apto::Smart>& edges) {
+  edges.Resize(0);
+  cEdgeSet edge_set(num_vertices);
+  
+  Apto::Array<bool> in_network(num_vertices);
+  in_network.SetAll(false);
+  Apto::Array<int> network_tree(num_vertices + 1);
+  network_tree.SetAll(0);
+  int network_size = 0;
+  int top_bit = 1;
+  while (top_bit * 2 <= num_vertices) top_bit *= 2;
+  
+  for (int i = 0; i < num_vertices; ++i) {
+    // select a random other vertex to connect to:
+    int j;
+    do {
+      j = rng.GetInt(0, num_vertices);
+    } while (j == i);
+    if (!edge_set.Insert(i, j)) continue;
+    edges.Push(i);
+    edges.Push(j);
+    
+    // neither i nor j is connected to the main network yet, so link one of them to a random vertex that is:
+    if (!in_network[i] && !in_network[j] && network_size > 0) {
+      int rank = rng.GetInt(0, network_size);
+      int target = 0;
+      for (int bit = top_bit; bit > 0; bit >>= 1) {
+        if (target + bit <= num_vertices && network_tree[target + bit] <= rank) {
+          target += bit;
+          rank -= network_tree[target];
+        }
+      }
+      
+      const int linked = rng.GetInt(0, 2) ? i : j;
+      edge_set.Insert(linked, target);
+      edges.Push(linked);
+      edges.Push(target);
+    }
+    
+    // add both vertices to the main network:
+    const int ends[2] = { i, j };
+    for (int e = 0; e < 2; e++) {
+      if (in_network[ends[e]]) continue;
+      in_network[ends[e]] = true;
+      network_size++;
+      for (int node = ends[e] + 1; node <= num_vertices; node += node & -node) network_tree[node]++;
+    }
+  }
+  
+  // sprinkle additional edges between the vertices; note the num_vertices bound is arbitrary.
+  const int extra_edges = rng.GetInt(0, num_vertices);
+  for (int n = 0; n < extra_edges; ++n) {
+    const int a = rng.GetInt(0, num_vertices);
+    int b = rng.GetInt(0, num_vertices);
+    while (a == b) b = rng.GetInt(0, num_vertices);
+    
+    if (edge_set.Insert(a, b)) {
+      edges.Push(a);
+      edges.Push(b);
+    }
+  }
 }
 
 
-/*! Builds a scale-free network from the given range of cells.
+/*! Builds a scale-free network out of num_vertices vertices, appending each edge to edges as a pair of vertex indices
+ (see cConnectionTable::AddEdges).
  
  This function is an implementation of the Barab\'asi-Albert "preferential attachment"
  algorithm for iteratively constructing a scale-free network.
@@ -366,50 +373,75 @@ bool edge(InputIterator u, InputIterator v) {
  zero_appeal = offset to prefer vertices with 0 edges
  
  Initialization:
- G = a graph, where all nodes have degree >= 1
+ G = vertices 0 and 1, connected
  
  foreach vertex u to be added to G:
- foreach vertex v \in G != u, where !e(u,v), and until m edges are added:
- connect u-v with probability: (d(v)/|E(G)|)^alpha + zero_appeal
+ connect u to min(m, |V(G)|) distinct vertices v \in G, each drawn with weight (d(v)/|E(G)|)^alpha + zero_appeal
+ 
+ Up to a common factor the weight is d(v)^alpha + zero_appeal * |E(G)|^alpha, so a draw either picks a vertex of G
+ uniformly (with the zero appeal share of the total weight) or picks one in proportion to d(v)^alpha.  For linear
+ attachment (alpha = 1) the latter is a random entry of edges, which holds both ends of every edge; otherwise the
+ degree weights are kept in a Fenwick tree.  Building takes O(|E(G)|) draws, each O(1) for linear attachment and
+ O(log |V(G)|) otherwise.
  */
-template <typename ArraySlice>
-void build_scale_free(ArraySlice slice, int m, double alpha, double zero_appeal, Apto::Random& rng) {
-	assert(slice.GetSize() > 1); // at least two vertices.
-	// Connect the first and second cells:
-	connect(&slice[0], &slice[1]);
-	// And initialize the edge and vertex counts:
-	int edge_count=1;
-	int vertex_count=2;
-	
-	// Now, for each new vertex (that is, vertices 2+):
-	for(int u = 2; u < slice.GetSize(); ++u, ++vertex_count) {
-		// Figure out how many edges we can add:
-		int to_add = std::min(vertex_count, m);
-		int added=0;
-		// Loop through all the vertices currently in the graph:
-		int v = 0;
-		while(added < to_add) {
-			// If we haven't already connected u and v:
-			if(!edge(&slice[u], &slice[v])) {
-				// Connect them with P = (d(v)/|E(G)|)^alpha + zero_appeal:
-				double p_edge = (double)slice[v].ConnectionList().GetSize() / edge_count;
-				p_edge = pow(p_edge, alpha) + zero_appeal;
-				// Protect against negative and over-large probabilities:
-				assert(p_edge >= 0.0);
-				p_edge = std::min(p_edge, 1.0);
-				// Probabilistically connect u and v:
-				if(rng.P(p_edge)) {
-					connect(&slice[u], &slice[v]);
-					++edge_count;
-					++added;
-				}
-			}
-			// Loop back around to the beginning - note that u is the current end, 'cause
-			// building this graph is an iterative process.
-			if(++v == u) { v = 0; }
-		}		
-	}
+inline void build_scale_free(int num_vertices, int m, double alpha, double zero_appeal, Apto::Random& rng,
+                             Apto::Array<int, Apto::Smart>& edges) {
+  assert(num_vertices > 1); // at least two vertices.
+  const bool linear = (alpha == 1.0);
+  
+  edges.Resize(0);
+  Apto::Array<int> degree(num_vertices);
+  degree.SetAll(0);
+  Apto::Array<int> chosen_by(num_vertices);  // the vertex that last drew each vertex as a target
+  chosen_by.SetAll(-1);
+  
+  // Fenwick tree of d(v)^alpha, for non-linear attachment
+  Apto::Array<double> weight_tree(linear ? 0 : num_vertices + 1);
+  weight_tree.SetAll(0.0);
+  double total_weight = 0.0;
+  int top_bit = 1;
+  while (top_bit * 2 <= num_vertices) top_bit *= 2;
+  
+  for (int u = 1; u < num_vertices; ++u) {
+    // Vertex 1 is connected to vertex 0, every later vertex to up to m of the vertices before it
+    const int to_add = (u == 1) ? 1 : std::min(u, m);
+    int added = 0;
+    while (added < to_add) {
+      int v = 0;
+      if (u > 1) {
+        const double degree_weight = (linear) ? edges.GetSize() : total_weight;
+        const double uniform_weight = (zero_appeal > 0.0) ? zero_appeal * pow(edges.GetSize() / 2.0, alpha) * u : 0.0;
+        if (uniform_weight > 0.0 && rng.GetDouble(degree_weight + uniform_weight) < uniform_weight) {
+          v = rng.GetUInt(u);
+        } else if (linear) {
+          v = edges[rng.GetUInt(edges.GetSize())];
+        } else {
+          double position = rng.GetDouble(total_weight);
+          for (int bit = top_bit; bit > 0; bit >>= 1) {
+            if (v + bit <= num_vertices && weight_tree[v + bit] <= position) {
+              v += bit;
+              position -= weight_tree[v];
+            }
+          }
+        }
+        // u itself, later vertices (reached only by rounding) and repeated targets are drawn again
+        if (v >= u || chosen_by[v] == u) continue;
+      }
+      chosen_by[v] = u;
+      
+      edges.Push(u);
+      edges.Push(v);
+      const int ends[2] = { u, v };
+      for (int e = 0; e < 2; e++) {
+        const int d = degree[ends[e]]++;
+        if (linear) continue;
+        const double delta = pow(d + 1.0, alpha) - ((d) ? pow((double)d, alpha) : 0.0);
+        total_weight += delta;
+        for (int node = ends[e] + 1; node <= num_vertices; node += node & -node) weight_tree[node] += delta;
+      }
+      ++added;
+    }
+  }
 }
 
-
 #endif
@@ -31,6 +31,7 @@ cWeightedIndex::cWeightedIndex(int in_size)
   : size(in_size)
   , item_weight(size)
   , subtree_weight(size)
+  , alias_valid(false)
 {
   item_weight.SetAll(0);
   subtree_weight.SetAll(0);
@@ -64,6 +65,7 @@ cWeightedIndex::~cWeightedIndex()
 void cWeightedIndex::SetWeight(int id, double in_weight)
 {
   item_weight[id] = in_weight;
+  alias_valid = false;
   
   while (true) {
     const int left_id = GetLeftChild(id);
@@ -126,3 +128,52 @@ int cWeightedIndex::FindPosition(double position, int root_id)
   return FindPosition(position, right_id);
 }
 
+
+int cWeightedIndex::FindAliasPosition(double unit)
+{
+  assert(GetTotalWeight() > 0.0);
+  if (!alias_valid) {
+    BuildAliasTable(item_weight, alias_prob, alias_index);
+    alias_valid = true;
+  }
+  return AliasLookup(alias_prob, alias_index, unit);
+}
+
+
+void cWeightedIndex::BuildAliasTable(const Apto::Array<double>& weights, Apto::Array<double>& prob, Apto::Array<int>& alias)
+{
+  const int n = weights.GetSize();
+  prob.Resize(n);
+  alias.Resize(n);
+  if (n == 0) return;
+
+  double total = 0.0;
+  for (int i = 0; i < n; i++) total += weights[i];
+
+  // Scale so the average column holds exactly 1.0, then pair each under-full column with an over-full one
+  Apto::Array<int> small(n);
+  Apto::Array<int> large(n);
+  int num_small = 0;
+  int num_large = 0;
+  for (int i = 0; i < n; i++) {
+    prob[i] = (total > 0.0) ? weights[i] * n / total : 1.0;
+    alias[i] = i;
+    if (prob[i] < 1.0) small[num_small++] = i;
+    else large[num_large++] = i;
+  }
+
+  while (num_small > 0 && num_large > 0) {
+    const int s = small[--num_small];
+    const int l = large[num_large - 1];
+    alias[s] = l;
+    prob[l] -= 1.0 - prob[s];
+    if (prob[l] < 1.0) {
+      num_large--;
+      small[num_small++] = l;
+    }
+  }
+
+  // Whatever remains is full up to rounding error
+  while (num_large > 0) prob[large[--num_large]] = 1.0;
+  while (num_small > 0) prob[small[--num_small]] = 1.0;
+}
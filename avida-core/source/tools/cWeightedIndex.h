@@ -41,6 +41,11 @@ protected:
   Apto::Array<double> item_weight;
   Apto::Array<double> subtree_weight;
 
+  // Alias table (Walker/Vose) for constant time draws, rebuilt lazily after any weight change
+  Apto::Array<double> alias_prob;
+  Apto::Array<int> alias_index;
+  bool alias_valid;
+
   
   cWeightedIndex(); // @not_implemented
   
@@ -55,9 +60,25 @@ public:
   int GetSize() const {return size;}
   int FindPosition(double position, int root_id=0);
 
+  // Draw an index with probability proportional to its weight, given a uniform deviate in [0, 1).  The alias table
+  // costs O(n) to rebuild, so this only pays off when draws far outnumber weight changes.
+  int FindAliasPosition(double unit);
+
+  static void BuildAliasTable(const Apto::Array<double>& weights, Apto::Array<double>& prob, Apto::Array<int>& alias);
+  static inline int AliasLookup(const Apto::Array<double>& prob, const Apto::Array<int>& alias, double unit);
+
   int GetParent(int id)     { return (id-1) / 2; }
   int GetLeftChild(int id)  { return 2*id + 1; }
   int GetRightChild(int id) { return 2*id + 2; }
 };
 
+
+inline int cWeightedIndex::AliasLookup(const Apto::Array<double>& prob, const Apto::Array<int>& alias, double unit)
+{
+  const double scaled = unit * prob.GetSize();
+  int col = (int)scaled;
+  if (col >= prob.GetSize()) col = prob.GetSize() - 1;
+  return (scaled - col < prob[col]) ? col : alias[col];
+}
+
 #endif
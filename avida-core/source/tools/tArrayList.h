@@ -0,0 +1,77 @@
+/*
+ *  tArrayList.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef tArrayList_h
+#define tArrayList_h
+
+#include "avida/core/Types.h"
+
+#ifndef NULL
+#define NULL 0
+#endif
+
+template<class T> class tArrayListIterator;
+
+
+// tArrayList is a list of pointers kept in one contiguous array, for lists that are built once and then walked
+// over and over.  It offers the parts of the tList interface those lists need, and tArrayListIterator walks it the way
+// tLWConstListIterator walks a tList.  As with tList, the list does not own what it points to.
+
+template <class T> class tArrayList
+{
+  friend class tArrayListIterator<T>;
+
+private:
+  Apto::Array<T*, Apto::Smart> m_items;
+
+public:
+  tArrayList() { ; }
+
+  inline int GetSize() const { return m_items.GetSize(); }
+
+  inline void PushRear(T* in) { m_items.Push(in); }
+  inline T* PopRear() { if (!m_items.GetSize()) return NULL; T* out = m_items[m_items.GetSize() - 1]; m_items.Pop(); return out; }
+  inline void Clear() { m_items.Resize(0); }
+
+  inline T* GetPos(int pos) const { return (pos >= 0 && pos < m_items.GetSize()) ? m_items[pos] : NULL; }
+  inline T* GetFirst() const { return GetPos(0); }
+  inline T* GetLast() const { return GetPos(m_items.GetSize() - 1); }
+};
+
+
+template <class T> class tArrayListIterator
+{
+private:
+  const tArrayList<T>& m_list;
+  int m_pos;   // -1 before the first item, as a tList iterator sits on the root node
+
+public:
+  explicit tArrayListIterator(const tArrayList<T>& list) : m_list(list), m_pos(-1) { ; }
+
+  void Reset() { m_pos = -1; }
+
+  T* Get() { return m_list.GetPos(m_pos); }
+  T* Next() { if (m_pos < m_list.m_items.GetSize()) m_pos++; return Get(); }
+
+  bool AtRoot() const { return (m_pos == -1); }
+  bool AtEnd() const { return (m_pos >= m_list.m_items.GetSize() - 1); }
+};
+
+#endif
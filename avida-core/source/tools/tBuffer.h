@@ -57,8 +57,7 @@ public:
   {
     data[offset] = in_value;
     total++;
-    offset++;
-    offset %= data.GetSize();
+    if (++offset == data.GetSize()) offset = 0;
   }
 
   void Pop()
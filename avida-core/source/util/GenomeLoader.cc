@@ -23,76 +23,212 @@
 
 #include "avida/private/util/GenomeLoader.h"
 
+#include "apto/core/FileSystem.h"
+
 #include "avida/core/Genome.h"
 
+#include "cFileCache.h"
 #include "cHardwareManager.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
 #include "cString.h"
 
+#include <cctype>
+#include <cstring>
 
-Avida::GenomePtr Avida::Util::LoadGenomeDetailFile(const cString& fname, const cString& wdir, cHardwareManager& hwm,
-                                                   Feedback& feedback, Apto::String specified_instset)
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+
+// Pick the instruction set named by the caller or the file's inst_set directive, and check the file's hw_type against it
+static const cInstSet* resolveInstSet(const cString& fname, cHardwareManager& hwm, Avida::Feedback& feedback,
+                                      Apto::String specified_instset,
+                                      const Apto::Map<Apto::String, Apto::String>& directives)
 {
-  bool success = true;
-  
-  Apto::Set<Apto::String> custom_directives;
-  custom_directives.Insert("inst_set");
-  custom_directives.Insert("hw_type");
-  
-  cInitFile input_file(fname, wdir, feedback, &custom_directives);
-  if (!input_file.WasOpened()) return GenomePtr();
-  
-  
   const cInstSet* is = &hwm.GetDefaultInstSet();
   
-  if (specified_instset.GetSize() || input_file.GetCustomDirectives().Has("inst_set")) {
-    if (!specified_instset.GetSize()) specified_instset = input_file.GetCustomDirectives().GetWithDefault("inst_set", "");
+  if (specified_instset.GetSize() || directives.Has("inst_set")) {
+    if (!specified_instset.GetSize()) specified_instset = directives.GetWithDefault("inst_set", "");
     
     specified_instset.Trim();
     if (hwm.IsInstSet(specified_instset)) {
       is = &hwm.GetInstSet(specified_instset);
     } else {
       feedback.Error("invalid instruction set '%s' defined in organism '%s'", (const char*)specified_instset, (const char*)fname);
-      return GenomePtr();
+      return NULL;
     }
   }
   
-  int hw_type = -1;
-  cString inst_set;
-  
-  if (input_file.GetCustomDirectives().Has("hw_type")) {
-    hw_type = Apto::StrAs(input_file.GetCustomDirectives().GetWithDefault("hw_type", "0"));
+  if (directives.Has("hw_type")) {
+    int hw_type = Apto::StrAs(directives.GetWithDefault("hw_type", "0"));
     if (is->GetHardwareType() != hw_type) {
       feedback.Error("hardware type mismatch in organism '%s': is = %d, org = %d",
                      (const char*)fname, is->GetHardwareType(), hw_type);
-      return GenomePtr();
+      return NULL;
     }
   }
   
-  hw_type = is->GetHardwareType();
-  inst_set = is->GetInstSetName();
-  InstructionSequencePtr new_seq(new InstructionSequence(input_file.GetNumLines()));
+  return is;
+}
+
+
+static void reportUnknownInst(const cString& fname, const cInstSet& is, const cString& name, bool& success, Avida::Feedback& feedback)
+{
+  if (success) {
+    feedback.Error("unable to load organism '%s'", (const char*)fname);
+    success = false;
+  }
+  feedback.Error("  unknown instruction: %s (best match: %s)", (const char*)name, (const char*)is.FindBestMatch(name));
+}
+
+
+static Avida::GenomePtr buildGenome(const cInstSet& is, Avida::InstructionSequencePtr seq)
+{
+  Avida::HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
+  return Avida::GenomePtr(new Avida::Genome(is.GetHardwareType(), props, seq));
+}
+
+
+// Decode a detail file held in memory, one instruction name per line.  Returns false, leaving genome untouched, if the
+// file uses anything beyond comments and the inst_set/hw_type directives, so that cInitFile can handle it instead.
+static bool decodeGenomeText(const char* text, size_t size, const cString& fname, cHardwareManager& hwm,
+                             Avida::Feedback& feedback, const Apto::String& specified_instset, Avida::GenomePtr& genome)
+{
+  const int MAX_NAME_SIZE = 128;
   
-  for (int line_num = 0; line_num < new_seq->GetSize(); line_num++) {
-    cString cur_line = input_file.GetLine(line_num);
-    (*new_seq)[line_num] = is->GetInst(cur_line);
+  struct sName {
+    const char* start;
+    int size;
+  };
+  Apto::Array<sName, Apto::Smart> names;
+  Apto::Map<Apto::String, Apto::String> directives;
+  
+  const char* end = text + size;
+  for (const char* line = text; line < end;) {
+    const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+    if (!eol) eol = end;
+    const char* next = (eol < end) ? eol + 1 : end;
     
-    if ((*new_seq)[line_num] == is->GetInstError()) {
-      if (success) {
-        feedback.Error("unable to load organism '%s'", (const char*)fname);
-        success = false;
-      } else {
-        feedback.Error("  unknown instruction: %s (best match: %s)",
-                       (const char*)cur_line, (const char*)is->FindBestMatch(cur_line));
+    if (*line == '#') {
+      const char* cmd_end = line;
+      while (cmd_end < eol && !isspace(*cmd_end)) cmd_end++;
+      const cString cmd(line, cmd_end - line);
+      if (cmd == "#include" || cmd == "#import" || cmd == "#define") return false;
+      if (cmd == "#inst_set" || cmd == "#hw_type") {
+        cString value(cmd_end, eol - cmd_end);
+        value.Trim();
+        directives.Set((const char*)cmd + 1, (const char*)value);
       }
-    }    
+      line = next;
+      continue;
+    }
+    
+    // Strip comments and surrounding whitespace
+    const char* comment = static_cast<const char*>(memchr(line, '#', eol - line));
+    const char* name_end = (comment) ? comment : eol;
+    while (line < name_end && isspace(*line)) line++;
+    while (name_end > line && isspace(*(name_end - 1))) name_end--;
+    
+    if (name_end > line) {
+      const int name_size = name_end - line;
+      if (name_size >= MAX_NAME_SIZE || line[name_size - 1] == '\\') return false;
+      for (const char* c = line; c < name_end; c++) if (isspace(*c)) return false;
+      
+      names.Resize(names.GetSize() + 1);
+      names[names.GetSize() - 1].start = line;
+      names[names.GetSize() - 1].size = name_size;
+    }
+    line = next;
+  }
+  
+  genome = Avida::GenomePtr();
+  const cInstSet* is = resolveInstSet(fname, hwm, feedback, specified_instset, directives);
+  if (!is) return true;
+  
+  bool success = true;
+  Avida::InstructionSequencePtr new_seq(new Avida::InstructionSequence(names.GetSize()));
+  char name[MAX_NAME_SIZE];
+  for (int i = 0; i < names.GetSize(); i++) {
+    memcpy(name, names[i].start, names[i].size);
+    name[names[i].size] = '\0';
+    if (!is->FindInst(name, (*new_seq)[i])) reportUnknownInst(fname, *is, name, success, feedback);
+  }
+  
+  if (success) genome = buildGenome(*is, new_seq);
+  return true;
+}
+
+
+// Decode the shared copy of the file, or map the file into memory and decode it in place.  Returns false if the file
+// could not be mapped or needs cInitFile.
+static bool loadGenomeMapped(const cString& fname, const cString& wdir, cHardwareManager& hwm, Avida::Feedback& feedback,
+                             const Apto::String& specified_instset, Avida::GenomePtr& genome)
+{
+  const Apto::String path = Apto::FileSystem::GetAbsolutePath(Apto::String(fname), Apto::String(wdir));
+  cFileCache::sEntry* shared = cFileCache::Acquire(path);
+  if (shared) {
+    const bool handled = shared->size > 0 &&
+      decodeGenomeText(shared->data, shared->size, fname, hwm, feedback, specified_instset, genome);
+    cFileCache::Release(shared);
+    return handled;
+  }
+  
+#if APTO_PLATFORM(WINDOWS)
+  (void)hwm; (void)feedback; (void)specified_instset; (void)genome;
+  return false;
+#else
+  int fd = open((const char*)path, O_RDONLY);
+  if (fd < 0) return false;
+  
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
   }
   
+  const size_t size = st.st_size;
+  void* region = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) return false;
+  
+  cFileCache::Record(path);
+  const bool handled = decodeGenomeText(static_cast<const char*>(region), size, fname, hwm, feedback, specified_instset, genome);
+  munmap(region, size);
+  return handled;
+#endif
+}
+
+
+Avida::GenomePtr Avida::Util::LoadGenomeDetailFile(const cString& fname, const cString& wdir, cHardwareManager& hwm,
+                                                   Feedback& feedback, Apto::String specified_instset)
+{
+  GenomePtr genome;
+  if (loadGenomeMapped(fname, wdir, hwm, feedback, specified_instset, genome)) return genome;
+  
+  // Files using includes, defines, or continued lines go through the full initialization file reader
+  Apto::Set<Apto::String> custom_directives;
+  custom_directives.Insert("inst_set");
+  custom_directives.Insert("hw_type");
+  
+  cInitFile input_file(fname, wdir, feedback, &custom_directives);
+  if (!input_file.WasOpened()) return GenomePtr();
+  
+  const cInstSet* is = resolveInstSet(fname, hwm, feedback, specified_instset, input_file.GetCustomDirectives());
+  if (!is) return GenomePtr();
+  
+  bool success = true;
+  InstructionSequencePtr new_seq(new InstructionSequence(input_file.GetNumLines()));
+  for (int line_num = 0; line_num < new_seq->GetSize(); line_num++) {
+    cString cur_line = input_file.GetLine(line_num);
+    if (!is->FindInst((const char*)cur_line, (*new_seq)[line_num])) reportUnknownInst(fname, *is, cur_line, success, feedback);
+  }
   
   if (!success) return GenomePtr();
   
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)inst_set);
-  return GenomePtr(new Genome(hw_type, props, new_seq));
+  return buildGenome(*is, new_seq);
 }
@@ -0,0 +1,58 @@
+/*
+ *  util/MemoryStats.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/util/MemoryStats.h"
+
+#include <cstddef>
+
+
+// tcmalloc is linked into the executables, not into this library, so its C interface is only weakly referenced and is
+// NULL when the executable was built without it.  Undefined weak symbols are only dependable with ELF linkers.
+#if defined(__ELF__)
+extern "C" bool MallocExtension_GetNumericProperty(const char* property, size_t* value) __attribute__((weak));
+#endif
+
+
+bool Avida::Util::MemoryStats::s_enabled = false;
+volatile int Avida::Util::MemoryStats::s_live[NUM_SUBSYSTEMS] = { 0 };
+volatile long long Avida::Util::MemoryStats::s_created[NUM_SUBSYSTEMS] = { 0 };
+
+
+const char* Avida::Util::MemoryStats::SubsystemName(int s)
+{
+  static const char* names[NUM_SUBSYSTEMS] = { "organisms", "genotypes", "genomes", "phenotypes", "data_packages" };
+  return names[s];
+}
+
+
+bool Avida::Util::MemoryStats::AllocatorProperty(const char* name, double& value)
+{
+#if defined(__ELF__)
+  if (!MallocExtension_GetNumericProperty) return false;
+  size_t prop_value = 0;
+  if (!MallocExtension_GetNumericProperty(name, &prop_value)) return false;
+  value = (double)prop_value;
+  return true;
+#else
+  (void)name;
+  (void)value;
+  return false;
+#endif
+}
@@ -0,0 +1,184 @@
+/*
+ *  util/WorldTemplate.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/util/WorldTemplate.h"
+
+#include "apto/core/FileSystem.h"
+#include "apto/core/Mutex.h"
+#include "apto/core/Thread.h"
+
+#include "avida/core/World.h"
+
+#include "cAvidaConfig.h"
+#include "cFileCache.h"
+#include "cHardwareManager.h"
+#include "cString.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+
+#include <ctime>
+
+
+// Templates are built one at a time, as the file cache records for a single setup
+static Apto::Mutex s_template_build_mutex;
+
+
+// Takes replicates off a shared counter until all of them have been built
+class Avida::Util::WorldTemplate::InstantiateThread : public Apto::Thread
+{
+private:
+  const WorldTemplate& m_template;
+  int m_first;
+  int m_num;
+  volatile int& m_next;
+  Apto::Array<cWorld*>& m_worlds;
+  Apto::Array<cUserFeedback, Apto::Smart>& m_feedback;
+
+  void Run()
+  {
+    for (int i = __sync_fetch_and_add(&m_next, 1); i < m_num; i = __sync_fetch_and_add(&m_next, 1)) {
+      m_worlds[i] = m_template.Instantiate(m_first + i, &m_feedback[i]);
+    }
+  }
+
+public:
+  InstantiateThread(const WorldTemplate& world_template, int first, int num, volatile int& next,
+                    Apto::Array<cWorld*>& worlds, Apto::Array<cUserFeedback, Apto::Smart>& feedback)
+    : m_template(world_template), m_first(first), m_num(num), m_next(next), m_worlds(worlds), m_feedback(feedback) { ; }
+};
+
+
+Avida::Util::WorldTemplate::WorldTemplate(const Apto::String& working_dir, const Apto::String& config_file,
+                                          const Apto::Map<Apto::String, Apto::String>& sets,
+                                          const Apto::Map<Apto::String, Apto::String>& defs, cUserFeedback* feedback)
+  : m_working_dir(working_dir), m_config_file(config_file), m_sets(sets), m_defs(defs), m_base_seed(0), m_valid(false)
+{
+  Apto::MutexAutoLock lock(s_template_build_mutex);
+
+  // Every world of the process uses the same instruction libraries, build them before any world needs them
+  cHardwareManager::SetupInstLibs();
+
+  cFileCache::StartRecording();
+
+  cAvidaConfig* cfg = loadConfig(feedback);
+  cWorld* prototype = NULL;
+  if (cfg) {
+    // Time based seeds would be drawn in the same second by many replicates, so pick the base seed once here
+    if (cfg->RANDOM_SEED.Get() <= 0) cfg->RANDOM_SEED.Set((int)time(NULL));
+    m_base_seed = cfg->RANDOM_SEED.Get();
+    m_base_data_dir = (const char*)cfg->DATA_DIR.Get();
+
+    // The prototype is replicate 0, so that anything it sets up on disk is where that replicate expects it
+    setupReplicate(cfg, 0);
+    prototype = cWorld::Initialize(cfg, cString((const char*)m_working_dir), new World, feedback, &m_defs);
+  }
+
+  Apto::Array<Apto::String> read_files;
+  cFileCache::StopRecording(read_files);
+
+  m_valid = (prototype != NULL);
+  delete prototype;
+  if (!m_valid) return;
+
+  for (int i = 0; i < read_files.GetSize(); i++) {
+    if (cFileCache::Share(read_files[i])) m_shared_files.Push(read_files[i]);
+  }
+}
+
+
+Avida::Util::WorldTemplate::~WorldTemplate()
+{
+  for (int i = 0; i < m_shared_files.GetSize(); i++) cFileCache::Unshare(m_shared_files[i]);
+}
+
+
+bool Avida::Util::WorldTemplate::ShareFile(const Apto::String& filename)
+{
+  const Apto::String path = Apto::FileSystem::GetAbsolutePath(filename, m_working_dir);
+  for (int i = 0; i < m_shared_files.GetSize(); i++) if (m_shared_files[i] == path) return true;
+
+  if (!cFileCache::Share(path)) return false;
+  m_shared_files.Push(path);
+  return true;
+}
+
+
+cWorld* Avida::Util::WorldTemplate::Instantiate(int replicate, cUserFeedback* feedback) const
+{
+  if (!m_valid) return NULL;
+
+  cAvidaConfig* cfg = loadConfig(feedback);
+  if (!cfg) return NULL;
+
+  cfg->RANDOM_SEED.Set(m_base_seed);
+  cfg->DATA_DIR.Set(cString((const char*)m_base_data_dir));
+  setupReplicate(cfg, replicate);
+
+  // cWorld owns the configuration and the new world from here on, and releases both should it fail
+  return cWorld::Initialize(cfg, cString((const char*)m_working_dir), new World, feedback, &m_defs);
+}
+
+
+void Avida::Util::WorldTemplate::InstantiateAll(int first, int num, int num_threads, Apto::Array<cWorld*>& worlds,
+                                                Apto::Array<cUserFeedback, Apto::Smart>& feedback) const
+{
+  worlds.Resize(num);
+  worlds.SetAll(NULL);
+  feedback.Resize(num);
+  if (num_threads > num) num_threads = num;
+
+  if (num_threads <= 1) {
+    for (int i = 0; i < num; i++) worlds[i] = Instantiate(first + i, &feedback[i]);
+    return;
+  }
+
+  volatile int next = 0;
+  Apto::Array<InstantiateThread*> threads(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    threads[i] = new InstantiateThread(*this, first, num, next, worlds, feedback);
+    threads[i]->Start();
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+}
+
+
+cAvidaConfig* Avida::Util::WorldTemplate::loadConfig(cUserFeedback* feedback) const
+{
+  cAvidaConfig* cfg = new cAvidaConfig();
+  if (!cfg->Load(cString((const char*)m_config_file), cString((const char*)m_working_dir), feedback, &m_defs, false)) {
+    delete cfg;
+    return NULL;
+  }
+
+  Apto::Map<Apto::String, Apto::String> sets(m_sets);
+  cfg->Set(sets);
+  return cfg;
+}
+
+
+void Avida::Util::WorldTemplate::setupReplicate(cAvidaConfig* cfg, int replicate) const
+{
+  cfg->RANDOM_SEED.Set(cfg->RANDOM_SEED.Get() + replicate);
+  cfg->DATA_DIR.Set(cString((const char*)Apto::FormatStr("%s_%d", (const char*)cfg->DATA_DIR.Get(), replicate)));
+}
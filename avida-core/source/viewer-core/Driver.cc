@@ -166,13 +166,7 @@ void Avida::CoreView::Driver::Run()
     
     
     // Do Point Mutations
-    if (point_mut_prob > 0 ) {
-      for (int i = 0; i < population.GetSize(); i++) {
-        if (population.GetCell(i).IsOccupied()) {
-          population.GetCell(i).GetOrganism()->GetHardware().PointMutate(ctx);
-        }
-      }
-    }
+    if (point_mut_prob > 0 ) population.ProcessPointMutations(ctx);
     
     // Exit conditons...
     m_mutex.Lock();
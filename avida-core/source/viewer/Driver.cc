@@ -338,10 +338,7 @@ void Avida::Viewer::Driver::Run()
     const double point_mut_prob = m_world->GetConfig().POINT_MUT_PROB.Get();
     
     void (cPopulation::*ActiveProcessStep)(cAvidaContext& ctx, double step_size, int cell_id) = &cPopulation::ProcessStep;
-    if (m_world->GetConfig().SPECULATIVE.Get() &&
-        m_world->GetConfig().THREAD_SLICING_METHOD.Get() != 1 && !m_world->GetConfig().IMPLICIT_REPRO_END.Get()) {
-      ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
-    }
+    if (m_world->GetConfig().SPECULATIVE.Get()) ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
     
     cAvidaContext ctx(this, m_world->GetRandom());
     Avida::Context new_ctx(this, &m_world->GetRandom());
@@ -23,14 +23,21 @@
 
 #include "avida/viewer/Freezer.h"
 
+#include "avida/core/BinaryArchive.h"
 #include "avida/core/Genome.h"
 
+#include "apto/core/Thread.h"
+
 #include "cAvidaConfig.h"
 #include "cEnvironment.h"
 #include "cFile.h"
 #include "cPopulation.h"
 #include "cWorld.h"
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 
 namespace Avida {
   namespace Viewer {
@@ -2991,16 +2998,20 @@ namespace Avida {
       }
       
       
+      // World entries keep their configuration, clade groups and population checkpoint together in one compressed
+      // bundle, "world.avb": a BinaryArchive whose "files" sub-object holds the text of each file below, by name, and
+      // whose "checkpoint" sub-object is the population checkpoint (loaded straight from the bundle by LoadCheckpoint)
+      const char* const BUNDLE_NAME = "world.avb";
+      const char* const BUNDLE_FILES[] = { "avida.cfg", "instset.cfg", "events.cfg", "environment.cfg", "clade.ssg" };
+      const int NUM_BUNDLE_FILES = sizeof(BUNDLE_FILES) / sizeof(BUNDLE_FILES[0]);
+      
+      
       bool SavePopulation(cWorld* world, const Apto::String& path)
       {
         Apto::String file_path;
         cFile file;
         std::fstream* fs;
         
-        // Save Population
-        file_path = Apto::FileSystem::PathAppend(path, "detail.spop");
-        if (!world->GetPopulation().SavePopulation((const char*)file_path, true)) return false;
-
         // Save Population
         file_path = Apto::FileSystem::PathAppend(path, "clade.ssg");
         if (!world->GetPopulation().SaveStructuredSystematicsGroup("clade", (const char*)file_path)) return false;
@@ -3009,18 +3020,84 @@ namespace Avida {
         file_path = Apto::FileSystem::PathAppend(path, "events.cfg");
         file.Open((const char*)file_path, std::ios::out);
         fs = file.GetFileStream();
-        *fs << "u begin LoadPopulation detail.spop" << std::endl;
+        *fs << "u begin LoadCheckpoint " << BUNDLE_NAME << std::endl;
         *fs << "u begin LoadStructuredSystematicsGroup  role=clade:filename=clade.ssg" << std::endl;
         file.Close();
         
         return true;
       }
       
+      
+      // Moves the bundled files saved in path into a new bundle, beside a checkpoint of the population
+      BinaryArchivePtr PackWorld(cWorld* world, const Apto::String& path)
+      {
+        BinaryArchivePtr bundle(new BinaryArchive);
+        bundle->SetObjectType("avida.freezer.world");
+        bundle->SetVersion(1);
+        
+        BinaryArchivePtr files_ar = bundle->DefineSubArchive("files");
+        for (int i = 0; i < NUM_BUNDLE_FILES; i++) {
+          Apto::String file_path = Apto::FileSystem::PathAppend(path, BUNDLE_FILES[i]);
+          std::ifstream in((const char*)file_path, std::ios::in | std::ios::binary);
+          if (!in.good()) return BinaryArchivePtr(NULL);
+          std::ostringstream contents;
+          contents << in.rdbuf();
+          in.close();
+          
+          files_ar->AttachValue(BUNDLE_FILES[i], Apto::String(contents.str().c_str()));
+          remove((const char*)file_path);
+        }
+        
+        world->GetPopulation().BuildCheckpoint(bundle->DefineSubArchive("checkpoint"), world->GetDefaultContext());
+        return bundle;
+      }
+      
+      
+      // Writes the bundled files of the world bundle in path back out beside it
+      bool UnpackWorld(const Apto::String& path)
+      {
+        BinaryArchivePtr bundle = BinaryArchive::Read(Apto::FileSystem::PathAppend(path, BUNDLE_NAME));
+        if (!bundle || bundle->ObjectType() != "avida.freezer.world") return false;
+        ConstArchivePtr files_ar = bundle->SubObject("files");
+        if (!files_ar) return false;
+        
+        for (int i = 0; i < NUM_BUNDLE_FILES; i++) {
+          if (!files_ar->Properties().Has(BUNDLE_FILES[i])) continue;
+          const Apto::String contents = files_ar->Properties().Get(BUNDLE_FILES[i]).StringValue();
+          
+          Apto::String file_path = Apto::FileSystem::PathAppend(path, BUNDLE_FILES[i]);
+          std::ofstream out((const char*)file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+          out.write((const char*)contents, contents.GetSize());
+          out.close();
+          if (out.fail()) return false;
+        }
+        
+        return true;
+      }
+      
     }
   }
 }
 
 
+// Compresses and writes a world bundle off the calling thread; the bundle is renamed into place once complete
+class Avida::Viewer::Freezer::BundleWriter : public Apto::Thread
+{
+private:
+  BinaryArchivePtr m_bundle;
+  Apto::String m_path;
+  
+  void Run()
+  {
+    m_bundle->Write(m_path);
+    m_bundle = BinaryArchivePtr(NULL);
+  }
+  
+public:
+  BundleWriter(BinaryArchivePtr bundle, const Apto::String& path) : m_bundle(bundle), m_path(path) { ; }
+};
+
+
 Avida::Viewer::FreezerPtr Avida::Viewer::Freezer::LoadWithPath(const Apto::String& dir)
 {
   // Check for existing freezer dir
@@ -3093,6 +3170,7 @@ Avida::Viewer::Freezer::Freezer(const Apto::String& dir) : m_dir(dir), m_opened(
 
 Avida::Viewer::Freezer::~Freezer()
 {
+  waitForWrites();
   if (!m_opened) return;
   
   // Search for inactive entries and remove them from the freezer
@@ -3200,6 +3278,17 @@ Avida::Viewer::FreezerID Avida::Viewer::Freezer::SaveWorld(cWorld* world, const
     Apto::FileSystem::RmDir(full_path, true);
     return FreezerID(CONFIG, -1);    
   }
+  
+  // Gather everything into the bundle now, while the world is still in the saved state, but leave compressing and
+  // writing it to a thread of its own
+  BinaryArchivePtr bundle = Private::PackWorld(world, full_path);
+  if (!bundle) {
+    Apto::FileSystem::RmDir(full_path, true);
+    return FreezerID(WORLD, -1);
+  }
+  BundleWriter* writer = new BundleWriter(bundle, Apto::FileSystem::PathAppend(full_path, Private::BUNDLE_NAME));
+  m_pending_writes.Push(writer);
+  writer->Start();
     
   // On success, save name file
   Apto::String name_path = Apto::FileSystem::PathAppend(full_path, "entryname.txt");
@@ -3230,9 +3319,15 @@ bool Avida::Viewer::Freezer::InstantiateWorkingDir(FreezerID entry_id, const Apt
   if (entry_id.identifier >= m_entries[entry_id.type].GetSize()) return false;
 
   // Copy contained files to the destination directory
+  waitForWrites();
   Apto::String src_path = Apto::FileSystem::PathAppend(m_dir, m_entries[entry_id.type][entry_id.identifier].path);
   Apto::FileSystem::CpDir(src_path, working_directory);
   
+  // Bundled worlds unpack their configuration; the population is loaded from the bundle itself
+  if (Apto::FileSystem::IsFile(Apto::FileSystem::PathAppend(working_directory, Private::BUNDLE_NAME))) {
+    return Private::UnpackWorld(working_directory);
+  }
+  
   return true;
 }
 
@@ -3362,6 +3457,7 @@ Apto::String Avida::Viewer::Freezer::NewUniqueNameForType(FreezerObjectType type
 void Avida::Viewer::Freezer::DuplicateFreezerAt(Apto::String destination)
 {
   // Copy the workspace
+  waitForWrites();
   Apto::FileSystem::CpDir(m_dir, destination);
   
   // Delete any inactive items from new duplicate
@@ -3377,6 +3473,8 @@ void Avida::Viewer::Freezer::DuplicateFreezerAt(Apto::String destination)
 
 void Avida::Viewer::Freezer::ExportItem(FreezerID entry_id, Apto::String destination)
 {
+  // World bundles are copied whole, as the single file they were written as
+  waitForWrites();
   Apto::FileSystem::CpDir(Apto::FileSystem::PathAppend(m_dir, m_entries[entry_id.type][entry_id.identifier].path), destination);
   
   // Write out entry type file
@@ -3442,3 +3540,13 @@ Avida::Viewer::FreezerID Avida::Viewer::Freezer::ImportItem(Apto::String src)
   
   return FreezerID(WORLD, -1);
 }
+
+
+void Avida::Viewer::Freezer::waitForWrites() const
+{
+  for (int i = 0; i < m_pending_writes.GetSize(); i++) {
+    m_pending_writes[i]->Join();
+    delete m_pending_writes[i];
+  }
+  m_pending_writes.Resize(0);
+}
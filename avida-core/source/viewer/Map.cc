@@ -43,6 +43,9 @@ Avida::Viewer::DiscreteScale::~DiscreteScale() { ; }
 
 class DoublePropMapMode : public Avida::Viewer::MapMode, public Avida::Viewer::DiscreteScale
 {
+public:
+  typedef double (*PropAccessor)(cOrganism* org);
+  
 private:
   static const int SCALE_MAX = 201;
   static const int SCALE_LABELS = 4;
@@ -51,11 +54,13 @@ private:
   static const double MAX_RESCALE_FACTOR;
 private:
   const Apto::String m_prop_id;
+  const PropAccessor m_accessor;   // reads the same value as the property, without the property map lookup
   Apto::String m_prop_desc;
   Apto::String m_prop_desc_rescale;
   
   Apto::Array<int> m_color_grid;
   Apto::Array<int> m_color_count;
+  Apto::Array<double> m_cell_values;   // value read for each occupied cell this update
   Apto::Array<DiscreteScale::Entry> m_scale_labels;
   
   double m_cur_min;
@@ -65,8 +70,8 @@ private:
   double m_rescale_rate_max;
   
 public:
-  DoublePropMapMode(cWorld* world, const Apto::String& prop_id, const Apto::String& prop_desc)
-  : m_prop_id(prop_id), m_prop_desc(prop_desc), m_color_count(SCALE_MAX + Avida::Viewer::MAP_RESERVED_COLORS), m_scale_labels(SCALE_LABELS)
+  DoublePropMapMode(cWorld* world, const Apto::String& prop_id, PropAccessor accessor, const Apto::String& prop_desc)
+  : m_prop_id(prop_id), m_accessor(accessor), m_prop_desc(prop_desc), m_color_count(SCALE_MAX + Avida::Viewer::MAP_RESERVED_COLORS), m_scale_labels(SCALE_LABELS)
   , m_cur_min(0.0), m_cur_max(0.0), m_target_max(0.0), m_rescale_rate_min(0.0), m_rescale_rate_max(0.0)
   {
     m_color_grid.Resize(world->GetPopulation().GetSize());
@@ -104,21 +109,27 @@ public:
 const double DoublePropMapMode::RESCALE_TOLERANCE = 0.1;
 const double DoublePropMapMode::MAX_RESCALE_FACTOR = 0.03;
 
+static double GetLastFitness(cOrganism* org) { return org->GetPhenotype().GetFitness(); }
+static double GetLastGestationTime(cOrganism* org) { return org->GetPhenotype().GetGestationTime(); }
+static double GetLastMetabolicRate(cOrganism* org) { return org->GetPhenotype().GetLastMerit(); }
+
 void DoublePropMapMode::Update(cPopulation& pop)
 {
   m_color_grid.Resize(pop.GetSize());
+  m_cell_values.Resize(pop.GetSize());
   
   // Keep track of how many times each color was assigned.
   m_color_count.SetAll(0);
   
-  // Determine the max and min in the population.
+  // Determine the max and min in the population, reading each organism's value once for both passes.
   double max_fit = 0.0;
   double min_fit = 0.0;
   
   for (int i = 0; i < pop.GetSize(); i++) {
     cOrganism* org = pop.GetCell(i).GetOrganism();
     if (org == NULL) continue;
-    double fit = org->Properties().Get(m_prop_id);
+    double fit = (*m_accessor)(org);
+    m_cell_values[i] = fit;
     if (fit == 0.0) continue;
     if (fit > max_fit) max_fit = fit;
     if (fit < min_fit) min_fit = fit;
@@ -167,14 +178,13 @@ void DoublePropMapMode::Update(cPopulation& pop)
   
   // Now fill out the color grid.
   for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
+    if (pop.GetCell(i).GetOrganism() == NULL) {
       m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
       m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_BLACK]++;
       continue;
     }
     
-    double fit = org->Properties().Get(m_prop_id);
+    double fit = m_cell_values[i];
     if (fit == 0.0) {
       m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
       m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY]++;
@@ -285,7 +295,7 @@ void ClassificationMapMode::Update(cPopulation& pop)
         if (mapcolor) {
           m_color_grid[i] = mapcolor->color;
           m_color_count[mapcolor->color + 4]++;
-          m_scale_labels[mapcolor->color + 4].label = bg->Properties().Get("name").StringValue();
+          m_scale_labels[mapcolor->color + 4].label = bg->StringProperty(Systematics::GROUP_PROP_NAME);
           continue;
         }
       }
@@ -458,8 +468,9 @@ void EnvActionMapMode::updateTagStates()
 
 
 Avida::Viewer::Map::Map(cWorld* world)
-  : m_width(world->GetPopulation().GetWorldX())
-  , m_height(world->GetPopulation().GetWorldY())
+  : m_front(0)
+  , m_back(1)
+  , m_middle(2)
   , m_num_viewer_colors(-1)
   , m_color_mode(0)
   , m_symbol_mode(-1)
@@ -468,9 +479,9 @@ Avida::Viewer::Map::Map(cWorld* world)
   // Setup the available view modes...
   m_view_modes.Resize(5);
 //  m_view_modes[0] = new cGenotypeMapMode(world);
-  m_view_modes[0] = new DoublePropMapMode(world, "last_fitness", "Fitness");
-  m_view_modes[1] = new DoublePropMapMode(world, "last_gestation_time", "Gestation Time");
-  m_view_modes[2] = new DoublePropMapMode(world, "last_metabolic_rate", "Metabolic Rate");
+  m_view_modes[0] = new DoublePropMapMode(world, "last_fitness", &GetLastFitness, "Fitness");
+  m_view_modes[1] = new DoublePropMapMode(world, "last_gestation_time", &GetLastGestationTime, "Gestation Time");
+  m_view_modes[2] = new DoublePropMapMode(world, "last_metabolic_rate", &GetLastMetabolicRate, "Metabolic Rate");
   m_view_modes[3] = new ClassificationMapMode(world, "clade", "Ancestor Organism");
   m_view_modes[4] = new EnvActionMapMode(world);
 
@@ -490,6 +501,9 @@ Avida::Viewer::Map::Map(cWorld* world)
 //    mode_name.Insert("Task/");
 //    AddViewMode(mode_name, &cViewer_Map::TagCells_Task, VIEW_TAGS, i);
 //  }
+  
+  // Until the first update is published, the viewer sees the modes as constructed
+  for (int i = 0; i < 3; i++) takeSnapshot(m_snapshots[i], world->GetPopulation());
 }
 
 Avida::Viewer::Map::~Map()
@@ -499,22 +513,61 @@ Avida::Viewer::Map::~Map()
 
 bool Avida::Viewer::Map::SetModeProperty(int idx, const Apto::String& property, const Apto::String& value)
 {
-  m_rw_lock.WriteLock();
-  bool rval = m_view_modes[idx]->SetProperty(property, value);
-  m_rw_lock.WriteUnlock();
-  return rval;
+  Apto::MutexAutoLock lock(m_mode_mutex);
+  return m_view_modes[idx]->SetProperty(property, value);
 }
 
-void Avida::Viewer::Map::UpdateMaps(cPopulation& pop)
+Apto::String Avida::Viewer::Map::GetModeProperty(int idx, const Apto::String& property) const
 {
-  m_rw_lock.WriteLock();
-  
-  m_width = pop.GetWorldX();
-  m_height = pop.GetWorldY();
+  Apto::MutexAutoLock lock(m_mode_mutex);
+  return m_view_modes[idx]->GetProperty(property);
+}
+
+void Avida::Viewer::Map::Retain()
+{
+  if (!(m_middle & SNAPSHOT_FRESH)) return;
   
-  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop);
+  // The exchange is a full barrier, so the snapshot contents are visible once its index is
+  m_front = __sync_lock_test_and_set(&m_middle, m_front) & SNAPSHOT_INDEX;
+}
+
+void Avida::Viewer::Map::UpdateMaps(cPopulation& pop)
+{
+  {
+    Apto::MutexAutoLock lock(m_mode_mutex);
+    for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop);
+    takeSnapshot(m_snapshots[m_back], pop);
+  }
   
-  m_rw_lock.WriteUnlock();
+  // Publish, taking back whichever buffer the viewer is not holding
+  __sync_synchronize();
+  m_back = __sync_lock_test_and_set(&m_middle, m_back | SNAPSHOT_FRESH) & SNAPSHOT_INDEX;
+}
+
+void Avida::Viewer::Map::takeSnapshot(Snapshot& snapshot, cPopulation& pop)
+{
+  snapshot.width = pop.GetWorldX();
+  snapshot.height = pop.GetWorldY();
+  snapshot.modes.Resize(m_view_modes.GetSize());
+  
+  // Strings are copied by value so that no buffer is shared with the modes the simulation keeps updating
+  for (int i = 0; i < m_view_modes.GetSize(); i++) {
+    const MapMode& src = *m_view_modes[i];
+    ModeSnapshot& dest = snapshot.modes[i];
+    dest.values = src.GetGridValues();
+    dest.counts = src.GetValueCounts();
+    
+    const DiscreteScale& scale = src.GetScale();
+    dest.scale.range = scale.GetScaleRange();
+    dest.scale.categorical = scale.IsCategorical();
+    dest.scale.entries.Resize(scale.GetNumLabeledEntries());
+    for (int e = 0; e < dest.scale.entries.GetSize(); e++) {
+      DiscreteScale::Entry entry = scale.GetEntry(e);
+      dest.scale.entries[e].index = entry.index;
+      dest.scale.entries[e].label = Apto::String((const char*)entry.label);
+    }
+    dest.scale_label = Apto::String((const char*)src.GetScaleLabel());
+  }
 }
 
 
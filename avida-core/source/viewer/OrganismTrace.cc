@@ -28,6 +28,7 @@
 #include "avida/core/WorldDriver.h"
 #include "avida/viewer/GraphicsContext.h"
 
+#include "apto/core/Thread.h"
 #include "apto/rng.h"
 
 #include "cEnvironment.h"
@@ -52,6 +53,8 @@ namespace Avida {
     namespace Private {
       
       class SnapshotTracer;
+      class TraceThread;
+      class TraceCache;
       class InstructionColorChart;
       
       typedef Apto::SmartPtr<InstructionColorChart> InstructionColorChartPtr;
@@ -145,6 +148,8 @@ private:
 
   Apto::Array<HardwareSnapshot*>* m_snapshots;
   int m_snapshot_count;
+  Apto::Mutex* m_mutex;           // guards *m_snapshots against readers of a trace still in progress
+  volatile int* m_available;
   
   int m_genome_length;
   Instruction m_first_inst;
@@ -155,9 +160,10 @@ private:
   
 
 public:
-  LIB_LOCAL inline SnapshotTracer(cWorld* world) : m_world(world), m_snapshots(NULL) { ; }
+  LIB_LOCAL inline SnapshotTracer(cWorld* world) : m_world(world), m_snapshots(NULL), m_mutex(NULL), m_available(NULL) { ; }
   
-  LIB_LOCAL void TraceGenome(GenomePtr genome, Apto::Array<HardwareSnapshot*>& snapshots, double mut_rate, int seed);
+  LIB_LOCAL void TraceGenome(GenomePtr genome, Apto::Array<HardwareSnapshot*>& snapshots, Apto::Mutex& mutex,
+                             volatile int& available, double mut_rate, int seed);
   
   LIB_LOCAL GenomePtr OffspringGenome() { return m_offspring_genome; }
   
@@ -183,11 +189,17 @@ public:
 // Private::SnapshotTracer Implementation
 // --------------------------------------------------------------------------------------------------------------  
 
-void Private::SnapshotTracer::TraceGenome(GenomePtr genome, Apto::Array<HardwareSnapshot*>& snapshots, double mut_rate, int seed)
+void Private::SnapshotTracer::TraceGenome(GenomePtr genome, Apto::Array<HardwareSnapshot*>& snapshots, Apto::Mutex& mutex,
+                                           volatile int& available, double mut_rate, int seed)
 {
   // Create internal reference to the snapshot array so that the tracing methods can create snapshots
   m_snapshots = &snapshots;
-  m_snapshots->Resize(300);
+  m_mutex = &mutex;
+  m_available = &available;
+  {
+    Apto::MutexAutoLock lock(mutex);
+    m_snapshots->Resize(300);
+  }
   
   // Set up tracking objects and variables
   m_snapshot_count = 0;
@@ -224,6 +236,8 @@ void Private::SnapshotTracer::TraceGenome(GenomePtr genome, Apto::Array<Hardware
   
   // Clear internal reference to the snapshot array
   m_snapshots = NULL;
+  m_mutex = NULL;
+  m_available = NULL;
   
   m_genome = GenomePtr();
 }
@@ -240,12 +254,15 @@ void Private::SnapshotTracer::TraceHardware(cAvidaContext& ctx, cHardwareBase& h
   // Create snapshot based on current hardware state
   m_snapshot_count++;
   
-  // Make sure snapshot array is big enough (just in case bonus cycles or threads are in use)
-  if (m_snapshots->GetSize() < m_snapshot_count) m_snapshots->Resize(m_snapshots->GetSize() * 2);
-  
   HardwareSnapshot* prev_snapshot = (m_snapshot_count > 1) ? (*m_snapshots)[m_snapshot_count - 2] : NULL;
   HardwareSnapshot* snapshot = new HardwareSnapshot(hw.GetNumRegisters(), prev_snapshot);
-  (*m_snapshots)[m_snapshot_count - 1] = snapshot;
+  {
+    Apto::MutexAutoLock lock(*m_mutex);
+    
+    // Make sure snapshot array is big enough (just in case bonus cycles or threads are in use)
+    if (m_snapshots->GetSize() < m_snapshot_count) m_snapshots->Resize(m_snapshots->GetSize() * 2);
+    (*m_snapshots)[m_snapshot_count - 1] = snapshot;
+  }
   
   snapshot->SetInstSet(hw.GetInstSet());
   
@@ -344,6 +361,10 @@ void Private::SnapshotTracer::TraceHardware(cAvidaContext& ctx, cHardwareBase& h
   
   // Store next instruction that will be executed
   snapshot->SetNextInst(hw.IP().GetInst());
+  
+  // Snapshot is complete, make it available
+  Apto::MutexAutoLock lock(*m_mutex);
+  *m_available = m_snapshot_count;
 }
 
 
@@ -360,14 +381,17 @@ void Private::SnapshotTracer::TraceTestCPU(int time_used, int time_allocated, co
     // Create snapshot based on current hardware state
     m_snapshot_count++;
     
-    // Make sure snapshot array is big enough (just in case bonus cycles or threads are in use)
-    if (m_snapshots->GetSize() < m_snapshot_count) m_snapshots->Resize(m_snapshots->GetSize() * 2);
-    
     cHardwareBase& hw = const_cast<cHardwareBase&>(organism.GetHardware());
     
     HardwareSnapshot* prev_snapshot = (m_snapshot_count > 1) ? (*m_snapshots)[m_snapshot_count - 2] : NULL;
     HardwareSnapshot* snapshot = new HardwareSnapshot(hw.GetNumRegisters(), prev_snapshot);
-    (*m_snapshots)[m_snapshot_count - 1] = snapshot;
+    {
+      Apto::MutexAutoLock lock(*m_mutex);
+      
+      // Make sure snapshot array is big enough (just in case bonus cycles or threads are in use)
+      if (m_snapshots->GetSize() < m_snapshot_count) m_snapshots->Resize(m_snapshots->GetSize() * 2);
+      (*m_snapshots)[m_snapshot_count - 1] = snapshot;
+    }
     
     snapshot->SetInstSet(organism.GetHardware().GetInstSet());
     snapshot->SetPostDivide();
@@ -438,11 +462,145 @@ void Private::SnapshotTracer::TraceTestCPU(int time_used, int time_allocated, co
   }
   
   // Resize the snapshot array to the actual number of snapshots
+  Apto::MutexAutoLock lock(*m_mutex);
   m_snapshots->Resize(m_snapshot_count);
+  *m_available = m_snapshot_count;
+}
+
+
+
+
+// Private::TraceThread
+// --------------------------------------------------------------------------------------------------------------  
+
+class Private::TraceThread : public Apto::Thread
+{
+private:
+  cWorld* m_world;
+  OrganismTrace* m_trace;
+  double m_mut_rate;
+  int m_seed;
+  
+  Apto::Mutex m_join_mutex;
+  bool m_joined;
+  
+  LIB_LOCAL inline TraceThread(cWorld* world, OrganismTrace* trace, double mut_rate, int seed)
+    : m_world(world), m_trace(trace), m_mut_rate(mut_rate), m_seed(seed), m_joined(false) { ; }
+  
+  LIB_LOCAL void Run();
+  
+public:
+  LIB_LOCAL static OrganismTracePtr Start(cWorld* world, GenomePtr genome, double mut_rate, int seed);
+  
+  // Block until the trace has finished, safe to call any number of times
+  LIB_LOCAL void Wait();
+};
+
+
+OrganismTracePtr Private::TraceThread::Start(cWorld* world, GenomePtr genome, double mut_rate, int seed)
+{
+  // Trace a private copy, so that the caller is free to modify or release the genome while the trace runs
+  OrganismTrace* trace = new OrganismTrace(GenomePtr(new Genome(*genome)));
+  trace->m_thread = new TraceThread(world, trace, mut_rate, seed);
+  trace->m_thread->Start();
+  
+  return OrganismTracePtr(trace);
+}
+
+
+void Private::TraceThread::Run()
+{
+  SnapshotTracer tracer(m_world);
+  tracer.TraceGenome(m_trace->m_genome, m_trace->m_snapshots, m_trace->m_mutex, m_trace->m_available, m_mut_rate, m_seed);
+  
+  Apto::MutexAutoLock lock(m_trace->m_mutex);
+  m_trace->m_offspring_genome = tracer.OffspringGenome();
+  m_trace->m_complete = true;
+}
+
+
+void Private::TraceThread::Wait()
+{
+  Apto::MutexAutoLock lock(m_join_mutex);
+  if (!m_joined) {
+    Join();
+    m_joined = true;
+  }
 }
 
 
 
+// Private::TraceCache
+// --------------------------------------------------------------------------------------------------------------  
+
+// Most recently requested deterministic traces, most recent first
+
+class Private::TraceCache
+{
+private:
+  static const int CAPACITY = 16;
+  
+  struct Entry
+  {
+    cWorld* world;
+    Apto::String genome;
+    double mut_rate;
+    int seed;
+    OrganismTracePtr trace;
+  };
+  
+  Apto::Mutex m_mutex;
+  Apto::Array<Entry, Apto::Smart> m_entries;
+  
+public:
+  LIB_LOCAL static TraceCache& Instance();
+  
+  LIB_LOCAL OrganismTracePtr Find(cWorld* world, const Genome& genome, double mut_rate, int seed);
+  LIB_LOCAL void Insert(cWorld* world, double mut_rate, int seed, OrganismTracePtr trace);
+};
+
+
+Private::TraceCache& Private::TraceCache::Instance()
+{
+  static TraceCache cache;
+  return cache;
+}
+
+
+OrganismTracePtr Private::TraceCache::Find(cWorld* world, const Genome& genome, double mut_rate, int seed)
+{
+  const Apto::String genome_str = genome.AsString();
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  for (int i = 0; i < m_entries.GetSize(); i++) {
+    if (m_entries[i].world != world || m_entries[i].seed != seed || m_entries[i].mut_rate != mut_rate ||
+        m_entries[i].genome != genome_str) continue;
+    
+    // Move the hit to the front
+    Entry hit = m_entries[i];
+    for (int j = i; j > 0; j--) m_entries[j] = m_entries[j - 1];
+    m_entries[0] = hit;
+    return hit.trace;
+  }
+  return OrganismTracePtr();
+}
+
+
+void Private::TraceCache::Insert(cWorld* world, double mut_rate, int seed, OrganismTracePtr trace)
+{
+  Entry entry;
+  entry.world = world;
+  entry.genome = trace->OrganismGenome()->AsString();
+  entry.mut_rate = mut_rate;
+  entry.seed = seed;
+  entry.trace = trace;
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_entries.GetSize() < CAPACITY) m_entries.Resize(m_entries.GetSize() + 1);
+  for (int j = m_entries.GetSize() - 1; j > 0; j--) m_entries[j] = m_entries[j - 1];
+  m_entries[0] = entry;
+}
+
 
 // HardwareSnapshot Implementation
 // --------------------------------------------------------------------------------------------------------------  
@@ -698,16 +856,63 @@ const Apto::Array<bool>& Avida::Viewer::HardwareSnapshot::MutatedStateOfMemSpace
 // OrganismTrace Implementation
 // --------------------------------------------------------------------------------------------------------------  
 
+OrganismTrace::OrganismTrace(GenomePtr genome)
+  : m_genome(genome), m_available(0), m_complete(false), m_thread(NULL)
+{
+}
+
+
 OrganismTrace::OrganismTrace(cWorld* world, GenomePtr genome, double mut_rate, int seed)
-  : m_genome(genome)
+  : m_genome(genome), m_available(0), m_complete(false), m_thread(NULL)
 {
   Private::SnapshotTracer tracer(world);
-  tracer.TraceGenome(genome, m_snapshots, mut_rate, seed);
+  tracer.TraceGenome(genome, m_snapshots, m_mutex, m_available, mut_rate, seed);
   m_offspring_genome = tracer.OffspringGenome();
+  m_complete = true;
 }
 
 
 OrganismTrace::~OrganismTrace()
 {
+  // A running trace writes into this object, it cannot be abandoned part way through
+  if (m_thread) {
+    m_thread->Wait();
+    delete m_thread;
+  }
   for (int i = 0; i < m_snapshots.GetSize(); i++) delete m_snapshots[i];
 }
+
+
+OrganismTracePtr OrganismTrace::TraceInBackground(cWorld* world, GenomePtr genome, double mut_rate, int seed)
+{
+  // Random seeds give a different trace every time, there is nothing to reuse
+  if (seed < 0) return Private::TraceThread::Start(world, genome, mut_rate, seed);
+  
+  OrganismTracePtr trace = Private::TraceCache::Instance().Find(world, *genome, mut_rate, seed);
+  if (!trace) {
+    trace = Private::TraceThread::Start(world, genome, mut_rate, seed);
+    Private::TraceCache::Instance().Insert(world, mut_rate, seed, trace);
+  }
+  return trace;
+}
+
+
+ConstGenomePtr OrganismTrace::OffspringGenome() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_offspring_genome;
+}
+
+
+void OrganismTrace::WaitForCompletion() const
+{
+  if (m_thread) m_thread->Wait();
+}
+
+
+const HardwareSnapshot& OrganismTrace::Snapshot(int idx) const
+{
+  // Snapshots themselves are left untouched once available, only the array holding them may move
+  Apto::MutexAutoLock lock(m_mutex);
+  return *m_snapshots[idx];
+}
@@ -58,6 +58,7 @@ EXPECTDIR = "expected"
 PERFDIR = "perf~"  # subversion, by default, ignores files/dirs with ~ at the end
 TEST_LIST = "test_list"
 PERF_BASE = "baseline"
+TIMING_PREFIX = "timing:"  # run summary line printed by avida with PRINT_RUN_TIMINGS set
 EXPECTED_IGNORE = (".gitignore",)
 
 
@@ -92,6 +93,12 @@ Usage: %(_testrunner_name)s [options] [testname ...]
     --builddir=dir [%(builddir)s]
       Set the path to the build directory.
 
+    -b | --benchmark
+      Run the performance tests marked as benchmarks (long tests included),
+      passing each its 'benchmarkargs' and reporting peak memory use,
+      throughput, and per phase timings.  Peak memory is compared against the
+      baseline in addition to user and wall time.
+
     -f | --force-perf
       Force active tests to be treated as peformance tests, regardless of
       individual test configuration.
@@ -199,6 +206,8 @@ long = no                ; Is this test a long test?
 [performance]
 enabled = no             ; Is this test a performance test?
 long = no                ; Is this test a long test?
+benchmark = no           ; Is this test part of the benchmark suite (-b)?
+benchmarkargs =          ; Extra arguments passed to the application in benchmark runs
 
 ; The following variables can be used in constructing setting values by calling
 ; them with %(variable_name)s.  For example see 'app' above.
@@ -438,6 +447,10 @@ class cTest:
             self.performance_enabled = True
         else:
             self.performance_enabled = False
+        if self.getConfig("performance", "benchmark", "no") in TRUE_STRINGS and RESAVAIL:
+            self.benchmark_enabled = True
+        else:
+            self.benchmark_enabled = False
 
         self.success = True
         self.result = "passed"
@@ -473,6 +486,10 @@ class cTest:
     def isPerformanceTest(self): return self.performance_enabled
     # } // End of isPerformanceTest()
 
+    # bool cTest::isBenchmark() {
+    def isBenchmark(self): return self.benchmark_enabled
+    # } // End of isBenchmark()
+
     # bool cTest::wasPerformanceSkipped() {
     def wasPerformanceSkipped(self): return self.pdisabled
     # } // End of wasPerformanceSkipped()
@@ -643,14 +660,16 @@ class cTest:
 
     # void cTest::runPerformanceTest() {
     def runPerformanceTest(self, dolongtest, saveresults):
-        global settings, tmpdir, CONFIGDIR, PERFDIR, TRUE_STRINGS, PERF_BASE
+        global settings, tmpdir, CONFIGDIR, PERFDIR, TRUE_STRINGS, PERF_BASE, TIMING_PREFIX
+
+        benchmark = settings.has_key("_benchmark")
 
         if self.has_perf_base and self.skip:
             self.presult = "skipped"
             self.pdisabled = True
             return
 
-        if self.getConfig("performance", "long", "no") in TRUE_STRINGS and not dolongtest:
+        if self.getConfig("performance", "long", "no") in TRUE_STRINGS and not dolongtest and not benchmark:
             self.presult = "skipped (long)"
             self.pdisabled = True
             return
@@ -669,20 +688,45 @@ class cTest:
 
         self.scm.deleteMetadata(rundir)
 
+        args = self.args
+        if benchmark:
+            args = "%s %s" % (args, self.getConfig("performance", "benchmarkargs", ""))
+
         # Run test X times, take min value
         nz = self.getConfig("main", "nonzeroexit", "disallow")
         r_times = []
         t_times = []
+        rss_peaks = []
+        timings = []
         for i in range(settings["perf_repeat"]):
             t_start = time.time()
             res_start = resource.getrusage(resource.RUSAGE_CHILDREN)
 
             # Run test app, capturing output and exitcode
-            p = subprocess.Popen("cd %s; %s %s" % (rundir, self.app, self.args), shell=True,
+            p = subprocess.Popen("cd %s; %s %s" % (rundir, self.app, args), shell=True,
                                  stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, close_fds=True)
+            timing = {}
             for line in p.stdout:
-                pass
-            exitcode = p.wait()
+                if line.startswith(TIMING_PREFIX):
+                    for field in line[len(TIMING_PREFIX):].split():
+                        (key, sep, val) = field.partition("=")
+                        try:
+                            timing[key] = float(val)
+                        except ValueError:
+                            pass
+
+            # wait4 reports the peak memory of this run alone, RUSAGE_CHILDREN only the largest of all runs so far
+            if hasattr(os, "wait4"):
+                (pid, status, res_run) = os.wait4(p.pid, 0)
+                p.returncode = status
+                if os.WIFEXITED(status):
+                    exitcode = os.WEXITSTATUS(status)
+                else:
+                    exitcode = -1
+                rss_peaks.append(res_run.ru_maxrss)
+            else:
+                exitcode = p.wait()
+                rss_peaks.append(resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss)
 
             res_end = resource.getrusage(resource.RUSAGE_CHILDREN)
             t_end = time.time()
@@ -699,10 +743,12 @@ class cTest:
 
             r_times.append(res_end.ru_utime - res_start.ru_utime)
             t_times.append(t_end - t_start)
+            timings.append(timing)
 
-        # Load baseline results
+        # Load baseline results, peak memory is only present in baselines recorded since it was added
         r_base = 0.0
         t_base = 0.0
+        rss_base = 0.0
         basepath = os.path.join(perfdir, PERF_BASE)
         if self.has_perf_base:
             try:
@@ -711,6 +757,8 @@ class cTest:
                 vals = line.split(',')
                 r_base = float(vals[0].strip())
                 t_base = float(vals[4].strip())
+                if len(vals) > 8:
+                    rss_base = float(vals[8].strip())
                 fp.close()
             except (IOError):
                 self.has_perf_base = False
@@ -723,6 +771,8 @@ class cTest:
         t_max = max(t_times)
         t_ave = sum(t_times) / len(t_times)
         t_med = med(t_times)
+        rss_min = min(rss_peaks)
+        t_timing = timings[t_times.index(t_min)]
 
         # If no baseline results exist, write out results
         if not self.has_perf_base:
@@ -741,8 +791,8 @@ class cTest:
                         return
 
                     fp = open(basepath, "w")
-                    fp.write("%f,%f,%f,%f,%f,%f,%f,%f\n" % (
-                        r_min, r_max, r_ave, r_med, t_min, t_max, t_ave, t_med))
+                    fp.write("%f,%f,%f,%f,%f,%f,%f,%f,%f\n" % (
+                        r_min, r_max, r_ave, r_med, t_min, t_max, t_ave, t_med, rss_min))
                     fp.flush()
                     fp.close()
                 except (IOError):
@@ -758,6 +808,8 @@ class cTest:
             else:
                 self.presult = "*unsaved* baseline - wall time: %3.4f user time: %3.4f" % (
                     t_min, r_min)
+            if benchmark:
+                self.presult += self.describeBenchmark(rss_min, t_timing)
 
             try:
                 shutil.rmtree(rundir, True)  # Clean up test directory
@@ -776,7 +828,13 @@ class cTest:
         t_lmargin = t_base - t_margin
         t_ratio = t_min / t_base
 
-        if r_min > r_umargin or t_min > t_umargin:
+        # Peak memory only counts against benchmarks, other performance tests keep their historic pass criteria
+        rss_failed = False
+        if benchmark and rss_base > 0:
+            rss_ratio = rss_min / rss_base
+            rss_failed = rss_min > rss_base + settings["perf_rss_margin"] * rss_base
+
+        if r_min > r_umargin or t_min > t_umargin or rss_failed:
             self.psuccess = False
             self.presult = "failed"
         elif r_min < r_lmargin or t_min < t_lmargin:
@@ -790,8 +848,8 @@ class cTest:
                     shutil.move(basepath, os.path.join(perfdir, oname))
 
                     fp = open(basepath, "w")
-                    fp.write("%f,%f,%f,%f,%f,%f,%f,%f\n" % (
-                        r_min, r_max, r_ave, r_med, t_min, t_max, t_ave, t_med))
+                    fp.write("%f,%f,%f,%f,%f,%f,%f,%f,%f\n" % (
+                        r_min, r_max, r_ave, r_med, t_min, t_max, t_ave, t_med, rss_min))
                     fp.flush()
                     fp.close()
                 except (IOError, OSError, shutil.Error):
@@ -803,6 +861,10 @@ class cTest:
             t_ratio, t_base, t_min)
         self.presult += "\n - user: %2.2f  base = %3.4f  test = %3.4f" % (
             r_ratio, r_base, r_min)
+        if benchmark:
+            if rss_base > 0:
+                self.presult += "\n - rss:  %2.2f  base = %d  test = %d" % (rss_ratio, rss_base, rss_min)
+            self.presult += self.describeBenchmark(rss_min, t_timing)
 
         # Clean up test directory
         try:
@@ -811,6 +873,20 @@ class cTest:
             pass
     # } // End of cTest::runPerformanceTest()
 
+    # string cTest::describeBenchmark(int rss, {string:float} timing) {
+    def describeBenchmark(self, rss, timing):
+        desc = "\n - peak rss: %d" % rss
+        if timing.has_key("wall") and timing["wall"] > 0:
+            desc += "\n - updates/s: %3.2f  insts/s: %3.0f" % (
+                timing.get("updates", 0) / timing["wall"], timing.get("insts", 0) / timing["wall"])
+            # Every other field is a phase of the update loop, most expensive first
+            phases = [(t, phase) for (phase, t) in timing.items() if phase not in ("updates", "insts", "wall")]
+            phases.sort(reverse=True)
+            phases = ["%s = %3.4f" % (phase, t) for (t, phase) in phases]
+            desc += "\n - phases: " + "  ".join(phases)
+        return desc
+    # } // End of cTest::describeBenchmark()
+
     # bool cTest::handleNewExpected() {
     def handleNewExpected(self):
         global settings, EXPECTDIR
@@ -985,7 +1061,11 @@ def runPerformanceTests(alltests, dolongtests, force, saveresults):
     global settings, tmpdir
 
     tests = []
-    if force:
+    if settings.has_key("_benchmark"):
+        for test in alltests:
+            if test.isBenchmark():
+                tests.append(test)
+    elif force:
         tests = alltests
     else:
         for test in alltests:
@@ -1078,6 +1158,8 @@ def main(argv):
     settings["perf_wall_margin"] = float(
         getConfig("performance", "wallmargin", .05))
     settings["perf_repeat"] = int(getConfig("performance", "repeat", 5))
+    settings["perf_rss_margin"] = float(
+        getConfig("performance", "rssmargin", .10))
 
     settings["cpus"] = 1
 
@@ -1085,8 +1167,8 @@ def main(argv):
 
     # Process Command Line Arguments
     try:
-        opts, args = getopt.getopt(argv[1:], "fhj:lm:pg:s:v",
-                                   ["diff-max-threshold=", "builddir=", "force-perf", "help", "help-test-cfg", "ignore-consistency", "list-tests", "long-tests",
+        opts, args = getopt.getopt(argv[1:], "bfhj:lm:pg:s:v",
+                                   ["benchmark", "diff-max-threshold=", "builddir=", "force-perf", "help", "help-test-cfg", "ignore-consistency", "list-tests", "long-tests",
                                     "mode=", "scm=", "reset-expected", "reset-perf-base", "run-perf-tests", "show-diff", "skip-tests", "git=", "svnmetadir=", "svn=", "svnversion=",
                                     "testdir=", "verbose", "version", "xml-report=", "-testrunner-name="])
     except getopt.GetoptError:
@@ -1120,6 +1202,9 @@ def main(argv):
             settings["cpus"] = cpus
         elif opt == "--scm":
             settings["scm"] = arg
+        elif opt in ("-b", "--benchmark"):
+            settings["_benchmark"] = ""
+            opt_runperf = True
         elif opt in ("-f", "--force-perf"):
             opt_forceperf = True
         elif opt == "--ignore-consistency":